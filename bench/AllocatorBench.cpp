@@ -0,0 +1,237 @@
+/**
+ * @file        AllocatorBench.cpp
+ * @author      Robert Koch
+ * @version     1.0
+ *
+ * Benchmarks of the engine allocators against malloc and new for typical per-frame patterns:
+ * many small arrays of mixed sizes dropped at the end of the frame, draw lists grown by
+ * push_back, temporary arrays of a function call, and node based containers with churn.
+ */
+#include "Benchmark.h"
+#include "../include/BlockPool.h"
+#include "../include/LinearArena.h"
+#include "../include/util/StlAllocator.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <map>
+#include <random>
+#include <vector>
+
+
+namespace {
+
+    using namespace Piko;
+    using namespace Piko::bench;
+
+    /**
+     * Function to report the timing of a frame pattern.
+     *
+     * @param context Benchmark context.
+     * @param pattern Name of the allocation pattern.
+     * @param allocator Name of the allocator.
+     * @param seconds Time of one frame.
+     * @param allocations Number of allocations per frame.
+     */
+    void report(Context& context, const char* pattern, const char* allocator, double seconds,
+                std::size_t allocations) {
+
+        context.report(pattern)
+            .param("allocator", allocator)
+            .param("allocations", (double)allocations)
+            .throughput(seconds, (double)allocations);
+    }
+
+    /**
+     * Function to time a frame of small arrays: every allocation is touched and all of them are
+     * released together at the end of the frame.
+     *
+     * @param context Benchmark context.
+     * @param sizes Sizes of the allocations in bytes.
+     */
+    void runFrameArrays(Context& context, const std::vector<std::size_t>& sizes) {
+
+        const std::size_t count = sizes.size();
+        std::vector<char*> ptrs(count);
+
+        double seconds = context.measure([&]() {
+            for(std::size_t i = 0; i < count; ++i) {
+                ptrs[i] = static_cast<char*>(std::malloc(sizes[i]));
+                ptrs[i][0] = (char)i;
+            }
+            keep(&ptrs[0]);
+            for(std::size_t i = 0; i < count; ++i) std::free(ptrs[i]);
+        });
+        report(context, "frame_arrays", "malloc", seconds, count);
+
+        seconds = context.measure([&]() {
+            for(std::size_t i = 0; i < count; ++i) {
+                ptrs[i] = new char[sizes[i]];
+                ptrs[i][0] = (char)i;
+            }
+            keep(&ptrs[0]);
+            for(std::size_t i = 0; i < count; ++i) delete[] ptrs[i];
+        });
+        report(context, "frame_arrays", "new", seconds, count);
+
+        LinearArena arena;
+        seconds = context.measure([&]() {
+            for(std::size_t i = 0; i < count; ++i) {
+                ptrs[i] = arena.allocateArray<char>(sizes[i]);
+                ptrs[i][0] = (char)i;
+            }
+            keep(&ptrs[0]);
+            arena.reset();
+        });
+        report(context, "frame_arrays", "LinearArena", seconds, count);
+    }
+
+    /**
+     * Function to time draw lists growing by push_back, dropped at the end of the frame.
+     *
+     * @param context Benchmark context.
+     * @param lists Number of lists per frame.
+     * @param length Number of elements per list.
+     */
+    void runDrawLists(Context& context, std::size_t lists, std::size_t length) {
+
+        double seconds = context.measure([&]() {
+            for(std::size_t l = 0; l < lists; ++l) {
+                std::vector<int> list;
+                for(std::size_t i = 0; i < length; ++i) list.push_back((int)i);
+                keep(&list[0]);
+            }
+        });
+        report(context, "draw_lists", "std::allocator", seconds, lists);
+
+        LinearArena arena;
+        seconds = context.measure([&]() {
+            for(std::size_t l = 0; l < lists; ++l) {
+                std::vector<int, ArenaAllocator<int>> list((ArenaAllocator<int>(arena)));
+                for(std::size_t i = 0; i < length; ++i) list.push_back((int)i);
+                keep(&list[0]);
+            }
+            arena.reset();
+        });
+        report(context, "draw_lists", "ArenaAllocator", seconds, lists);
+    }
+
+    /**
+     * Function to time temporary arrays of a function call.
+     *
+     * @param context Benchmark context.
+     * @param calls Number of calls per frame.
+     * @param length Number of floats per temporary array.
+     */
+    void runScratch(Context& context, std::size_t calls, std::size_t length) {
+
+        double seconds = context.measure([&]() {
+            for(std::size_t c = 0; c < calls; ++c) {
+                float* tmp = new float[length];
+                tmp[0] = (float)c;
+                keep(tmp);
+                delete[] tmp;
+            }
+        });
+        report(context, "scratch", "new", seconds, calls);
+
+        seconds = context.measure([&]() {
+            for(std::size_t c = 0; c < calls; ++c) {
+                ScratchScope scope;
+                float* tmp = scope.allocateArray<float>(length);
+                tmp[0] = (float)c;
+                keep(tmp);
+            }
+        });
+        report(context, "scratch", "ScratchScope", seconds, calls);
+    }
+
+    /**
+     * Function to time fixed-size blocks allocated and released in random order.
+     *
+     * @param context Benchmark context.
+     * @param count Number of live blocks.
+     */
+    void runBlocks(Context& context, std::size_t count) {
+
+        // Each round releases and allocates a random half of the blocks.
+        std::mt19937 rng(42);
+        std::vector<std::size_t> order(count);
+        for(std::size_t i = 0; i < count; ++i) order[i] = i;
+        std::shuffle(order.begin(), order.end(), rng);
+        order.resize(count / 2);
+
+        std::vector<void*> blocks(count);
+
+        for(std::size_t i = 0; i < count; ++i) blocks[i] = std::malloc(64);
+        double seconds = context.measure([&]() {
+            for(std::size_t i = 0; i < order.size(); ++i) std::free(blocks[order[i]]);
+            for(std::size_t i = 0; i < order.size(); ++i) blocks[order[i]] = std::malloc(64);
+            keep(&blocks[0]);
+        });
+        for(std::size_t i = 0; i < count; ++i) std::free(blocks[i]);
+        report(context, "blocks", "malloc", seconds, order.size());
+
+        BlockPool pool(64, 16);
+        for(std::size_t i = 0; i < count; ++i) blocks[i] = pool.allocate();
+        seconds = context.measure([&]() {
+            for(std::size_t i = 0; i < order.size(); ++i) pool.deallocate(blocks[order[i]]);
+            for(std::size_t i = 0; i < order.size(); ++i) blocks[order[i]] = pool.allocate();
+            keep(&blocks[0]);
+        });
+        report(context, "blocks", "BlockPool", seconds, order.size());
+    }
+
+    /**
+     * Function to time a map with churn: entries are inserted and erased every frame.
+     *
+     * @param context Benchmark context.
+     * @param count Number of entries inserted and erased per frame.
+     */
+    void runNodes(Context& context, std::size_t count) {
+
+        std::vector<int> keys(count);
+        std::mt19937 rng(42);
+        for(std::size_t i = 0; i < count; ++i) keys[i] = (int)(rng() % (count * 4));
+
+        std::map<int, int> map;
+        double seconds = context.measure([&]() {
+            for(std::size_t i = 0; i < count; ++i) map[keys[i]] = (int)i;
+            for(std::size_t i = 0; i < count; ++i) map.erase(keys[i]);
+        });
+        report(context, "map_churn", "std::allocator", seconds, count);
+
+        typedef std::pair<const int, int> Entry;
+        BlockPool pool(64, 16);
+        const PoolAllocator<Entry> allocator(pool);
+        std::map<int, int, std::less<int>, PoolAllocator<Entry>> pooled(std::less<int>(),
+                                                                        allocator);
+        seconds = context.measure([&]() {
+            for(std::size_t i = 0; i < count; ++i) pooled[keys[i]] = (int)i;
+            for(std::size_t i = 0; i < count; ++i) pooled.erase(keys[i]);
+        });
+        report(context, "map_churn", "PoolAllocator", seconds, count);
+    }
+
+} /* Anonymous namespace */
+
+
+
+PIKO_BENCHMARK(allocators) {
+
+    const bool isQuick = context.options().quick;
+
+    // Mostly small allocations with a few larger ones, as event and visibility lists are.
+    std::vector<std::size_t> sizes(isQuick ? 1000 : 10000);
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<int> small(16, 256);
+    for(std::size_t i = 0; i < sizes.size(); ++i) {
+        sizes[i] = i % 16 == 0 ? 4096 : (std::size_t)small(rng);
+    }
+
+    runFrameArrays(context, sizes);
+    runDrawLists(context, isQuick ? 16 : 256, 1000);
+    runScratch(context, isQuick ? 1000 : 10000, 1024);
+    runBlocks(context, isQuick ? 1000 : 100000);
+    runNodes(context, isQuick ? 1000 : 10000);
+}
\ No newline at end of file
@@ -0,0 +1,149 @@
+/**
+ * @file        BVHBench.cpp
+ * @author      Robert Koch
+ * @version     1.0
+ *
+ * Benchmarks of the BVH from 10^4 to 10^7 primitives: the serial and the parallel build, the
+ * refit after all primitives moved, and box, sphere and closest-hit ray queries. The primitives
+ * are small boxes spread over a cube, so every query touches only a few of them and the time
+ * shows the cost of the traversal.
+ */
+#include "Benchmark.h"
+#include "../include/JobSystem.h"
+#include "../include/util/BVH.h"
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+
+namespace {
+
+    using namespace Piko;
+    using namespace Piko::bench;
+
+    /** Number of queries of each kind per timing. */
+    const std::size_t QUERY_COUNT = 1024;
+
+    /**
+     * Function to time the build, the refit and the queries for one primitive count.
+     *
+     * @param context Benchmark context.
+     * @param count Number of primitives.
+     */
+    void runSize(Context& context, std::size_t count) {
+
+        // The cube grows with the count, so the density of the primitives stays the same.
+        const float side = 4.0f * std::cbrt((float)count);
+
+        std::mt19937 rng(42);
+        std::uniform_real_distribution<float> coordinate(0.0f, side);
+        std::uniform_real_distribution<float> size(0.1f, 2.0f);
+        std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+
+        std::vector<AABB<float>> boxes(count);
+        for(std::size_t i = 0; i < count; ++i) {
+            const Vector3D<float> min(coordinate(rng), coordinate(rng), coordinate(rng));
+            boxes[i] = AABB<float>(min, min + Vector3D<float>(size(rng), size(rng), size(rng)));
+        }
+
+        BVH<float> bvh;
+
+        double seconds = context.measure([&]() { bvh.build(&boxes[0], count); });
+        context.report("BVH::build")
+            .param("workers", 1.0)
+            .param("primitives", (double)count)
+            .throughput(seconds, (double)count)
+            .metric("sah_cost", bvh.getCost());
+
+        if(context.options().workers > 1) {
+            JobSystem jobs(context.options().workers - 1);
+            seconds = context.measure([&]() { bvh.build(&boxes[0], count, &jobs); });
+            context.report("BVH::build")
+                .param("workers", (double)context.options().workers)
+                .param("primitives", (double)count)
+                .throughput(seconds, (double)count)
+                .metric("sah_cost", bvh.getCost());
+        }
+
+        const float cost = bvh.getCost();
+
+        // Every primitive moves a little, as in a frame of a dynamic scene.
+        std::vector<AABB<float>> moved(count);
+        for(std::size_t i = 0; i < count; ++i) {
+            const Vector3D<float> move(unit(rng), unit(rng), unit(rng));
+            moved[i] = AABB<float>(boxes[i].getMin() + move, boxes[i].getMax() + move);
+        }
+
+        seconds = context.measure([&]() { bvh.refit(&moved[0]); });
+        context.report("BVH::refit")
+            .param("primitives", (double)count)
+            .throughput(seconds, (double)count)
+            .metric("cost_increase", bvh.getCost() / cost);
+
+        bvh.build(&boxes[0], count);
+
+        std::vector<AABB<float>> queryBoxes(QUERY_COUNT);
+        std::vector<Vector3D<float>> origins(QUERY_COUNT);
+        std::vector<Vector3D<float>> directions(QUERY_COUNT);
+        for(std::size_t q = 0; q < QUERY_COUNT; ++q) {
+            const Vector3D<float> min(coordinate(rng), coordinate(rng), coordinate(rng));
+            queryBoxes[q] = AABB<float>(min, min + Vector3D<float>(8.0f, 8.0f, 8.0f));
+            origins[q] = Vector3D<float>(coordinate(rng), coordinate(rng), coordinate(rng));
+            directions[q] = Vector3D<float>(unit(rng), unit(rng), unit(rng));
+        }
+
+        std::size_t hits = 0;
+        seconds = context.measure([&]() {
+            hits = 0;
+            for(std::size_t q = 0; q < QUERY_COUNT; ++q) {
+                bvh.queryBox(queryBoxes[q], [&hits](std::size_t) { ++hits; });
+            }
+            keep(&hits);
+        });
+        context.report("BVH::queryBox")
+            .param("primitives", (double)count)
+            .throughput(seconds, (double)QUERY_COUNT)
+            .metric("hits_per_query", (double)hits / QUERY_COUNT);
+
+        seconds = context.measure([&]() {
+            hits = 0;
+            for(std::size_t q = 0; q < QUERY_COUNT; ++q) {
+                bvh.querySphere(origins[q], 4.0f, [&hits](std::size_t) { ++hits; });
+            }
+            keep(&hits);
+        });
+        context.report("BVH::querySphere")
+            .param("primitives", (double)count)
+            .throughput(seconds, (double)QUERY_COUNT)
+            .metric("hits_per_query", (double)hits / QUERY_COUNT);
+
+        seconds = context.measure([&]() {
+            hits = 0;
+            std::size_t primitive;
+            float t;
+            for(std::size_t q = 0; q < QUERY_COUNT; ++q) {
+                if(bvh.raycast(origins[q], directions[q], side, primitive, t)) ++hits;
+            }
+            keep(&hits);
+        });
+        context.report("BVH::raycast")
+            .param("primitives", (double)count)
+            .throughput(seconds, (double)QUERY_COUNT)
+            .metric("hit_rate", (double)hits / QUERY_COUNT);
+    }
+
+} /* Anonymous namespace */
+
+
+
+PIKO_BENCHMARK(bvh) {
+
+    // 10^4 primitives fit the caches, 10^7 take about two gigabytes during the build.
+    runSize(context, 10000);
+    if(context.options().quick) return;
+
+    runSize(context, 100000);
+    runSize(context, 1000000);
+    runSize(context, 10000000);
+}
\ No newline at end of file
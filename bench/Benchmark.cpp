@@ -0,0 +1,261 @@
+/**
+ * @file        Benchmark.cpp
+ * @author      Robert Koch
+ * @version     1.0
+ *
+ * Implementation of the benchmark framework.
+ */
+#include "Benchmark.h"
+
+#include <cmath>
+#include <cstring>
+#include <sstream>
+
+
+namespace Piko {
+
+    namespace bench {
+
+        namespace {
+
+            /**
+             * Function to get the list of registered benchmarks. A function local instance is
+             * used, registrations run during static initialization of other files.
+             *
+             * @return List of benchmarks.
+             */
+            std::vector<Benchmark>& getRegistry() {
+                static std::vector<Benchmark> registry;
+                return registry;
+            }
+
+            /**
+             * Function to quote a string for JSON.
+             *
+             * @param text String to quote.
+             * @return Quoted string.
+             */
+            std::string quote(const std::string& text) {
+
+                std::string quoted("\"");
+                for(std::size_t i = 0; i < text.size(); ++i) {
+                    const char c = text[i];
+                    if(c == '"' || c == '\\') quoted += '\\';
+                    if((unsigned char)c < 0x20) quoted += ' ';
+                    else quoted += c;
+                }
+                return quoted + "\"";
+            }
+
+            /**
+             * Function to format a number for JSON.
+             *
+             * @param value Number to format.
+             * @return Formatted number, null if it is not finite.
+             */
+            std::string number(double value) {
+
+                if(!std::isfinite(value)) return "null";
+
+                // Counts and sizes are written exactly, measurements with 6 significant digits.
+                std::ostringstream stream;
+                if(value == std::floor(value) && std::fabs(value) < 1e15) {
+                    stream << (long long)value;
+                    return stream.str();
+                }
+
+                stream.precision(6);
+                stream << value;
+                return stream.str();
+            }
+
+            /**
+             * Function to write entries as a JSON object.
+             *
+             * @param stream Stream to write to.
+             * @param entries Keys and JSON values.
+             */
+            void writeEntries(std::ostream& stream,
+                              const std::vector<std::pair<std::string, std::string> >& entries) {
+
+                stream << "{";
+                for(std::size_t i = 0; i < entries.size(); ++i) {
+                    stream << (i ? ", " : "") << quote(entries[i].first) << ": "
+                           << entries[i].second;
+                }
+                stream << "}";
+            }
+
+        } /* Anonymous namespace */
+
+
+
+        /*===================================================================*
+         * PUBLIC MEMBERS                                                    *
+         *===================================================================*/
+
+        Result::Result(const std::string& name)
+          :
+          m_name(name) {
+
+        }
+
+        //-----------------------------------------------------------------------------------------
+        //-----------------------------------------------------------------------------------------
+
+        Result& Result::param(const std::string& key, const std::string& value) {
+
+            m_params.push_back(std::make_pair(key, quote(value)));
+            return *this;
+        }
+
+        //-----------------------------------------------------------------------------------------
+        //-----------------------------------------------------------------------------------------
+
+        Result& Result::param(const std::string& key, double value) {
+
+            m_params.push_back(std::make_pair(key, number(value)));
+            return *this;
+        }
+
+        //-----------------------------------------------------------------------------------------
+        //-----------------------------------------------------------------------------------------
+
+        Result& Result::metric(const std::string& key, double value) {
+
+            m_metrics.push_back(std::make_pair(key, number(value)));
+            return *this;
+        }
+
+        //-----------------------------------------------------------------------------------------
+        //-----------------------------------------------------------------------------------------
+
+        Result& Result::throughput(double seconds, double items) {
+
+            metric("ns_per_call", seconds * 1e9);
+            metric("ns_per_item", seconds * 1e9 / items);
+            return metric("items_per_second", items / seconds);
+        }
+
+        //-----------------------------------------------------------------------------------------
+        //-----------------------------------------------------------------------------------------
+
+        void Result::write(std::ostream& stream) const {
+
+            stream << "{\"name\": " << quote(m_name) << ", \"params\": ";
+            writeEntries(stream, m_params);
+            stream << ", \"metrics\": ";
+            writeEntries(stream, m_metrics);
+            stream << "}";
+        }
+
+        //-----------------------------------------------------------------------------------------
+        //-----------------------------------------------------------------------------------------
+
+        void Result::print(std::ostream& stream) const {
+
+            stream << m_name;
+            for(std::size_t i = 0; i < m_params.size(); ++i) {
+                stream << " " << m_params[i].first << "=" << m_params[i].second;
+            }
+            stream << ":";
+            for(std::size_t i = 0; i < m_metrics.size(); ++i) {
+                stream << " " << m_metrics[i].first << "=" << m_metrics[i].second;
+            }
+            stream << "\n";
+        }
+
+        //-----------------------------------------------------------------------------------------
+        //-----------------------------------------------------------------------------------------
+
+        Context::Context(const Options& options)
+          :
+          m_options(options) {
+
+        }
+
+        //-----------------------------------------------------------------------------------------
+        //-----------------------------------------------------------------------------------------
+
+        const Options& Context::options() const {
+
+            return m_options;
+        }
+
+        //-----------------------------------------------------------------------------------------
+        //-----------------------------------------------------------------------------------------
+
+        Result& Context::report(const std::string& name) {
+
+            m_results.push_back(Result(name));
+            return m_results.back();
+        }
+
+        //-----------------------------------------------------------------------------------------
+        //-----------------------------------------------------------------------------------------
+
+        const std::vector<Result>& Context::results() const {
+
+            return m_results;
+        }
+
+        //-----------------------------------------------------------------------------------------
+        //-----------------------------------------------------------------------------------------
+
+        Registration::Registration(const char* name, BenchmarkFunction function) {
+
+            Benchmark benchmark = { name, function };
+            getRegistry().push_back(benchmark);
+        }
+
+        //-----------------------------------------------------------------------------------------
+        //-----------------------------------------------------------------------------------------
+
+        std::vector<Benchmark> getBenchmarks() {
+
+            std::vector<Benchmark> benchmarks(getRegistry());
+            std::sort(benchmarks.begin(), benchmarks.end(),
+                      [](const Benchmark& a, const Benchmark& b) {
+                          return std::strcmp(a.name, b.name) < 0;
+                      });
+            return benchmarks;
+        }
+
+        //-----------------------------------------------------------------------------------------
+        //-----------------------------------------------------------------------------------------
+
+        std::vector<std::size_t> getSizes(const Options& options) {
+
+            // 1K vectors stay in L1, 16K in L2, 256K in a typical L3 and 4M only in memory.
+            std::vector<std::size_t> sizes;
+            sizes.push_back(1 << 10);
+            sizes.push_back(1 << 14);
+            if(!options.quick) {
+                sizes.push_back(1 << 18);
+                sizes.push_back(1 << 22);
+            }
+            return sizes;
+        }
+
+
+
+        /*===================================================================*
+         * PRIVATE MEMBERS                                                   *
+         *===================================================================*/
+
+        double Context::getBatchTime() const {
+
+            return m_options.quick ? 0.002 : 0.05;
+        }
+
+        //-----------------------------------------------------------------------------------------
+        //-----------------------------------------------------------------------------------------
+
+        int Context::getRepetitions() const {
+
+            return m_options.quick ? 2 : 5;
+        }
+
+    } /* Namespace bench */
+
+} /* Namespace Piko */
\ No newline at end of file
@@ -0,0 +1,298 @@
+/**
+ * @file        Benchmark.h
+ * @author      Robert Koch
+ * @version     1.0
+ *
+ * Declaration of the small framework behind the piko_bench target. Benchmarks register
+ * themselves with PIKO_BENCHMARK, time their kernels with Context::measure() and report named
+ * results with parameters and metrics, which are written as JSON at the end of the run.
+ */
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+
+/**
+ * Macro to define and register a benchmark function.
+ *
+ * @param name Identifier of the benchmark, also used to select it on the command line.
+ */
+#define PIKO_BENCHMARK(name) \
+    static void name(Piko::bench::Context& context); \
+    static Piko::bench::Registration name##Registration(#name, name); \
+    static void name(Piko::bench::Context& context)
+
+
+namespace Piko {
+
+    namespace bench {
+
+        /**
+         * Options of a benchmark run, taken from the command line.
+         */
+        struct Options {
+            std::string filter;         /**< Only benchmarks containing this string are run. */
+            std::string output;         /**< Path of the JSON file, empty for stdout. */
+            std::size_t workers;        /**< Maximum number of worker threads. */
+            bool quick;                 /**< Short timings and small sizes, e.g. for smoke tests. */
+        };
+
+        /**
+         * Single result of a benchmark. Parameters describe the configuration, e.g. type and
+         * size, metrics the measured values.
+         */
+        class Result final {
+
+            public:
+
+                /**
+                 * Constructor.
+                 *
+                 * @param name Name of the measured operation.
+                 */
+                explicit Result(const std::string& name);
+
+                /**
+                 * Functions to add a parameter.
+                 *
+                 * @param key Name of the parameter.
+                 * @param value Value of the parameter.
+                 * @return Reference to the calling instance.
+                 */
+                Result& param(const std::string& key, const std::string& value);
+                Result& param(const std::string& key, double value);
+
+                /**
+                 * Function to add a metric.
+                 *
+                 * @param key Name of the metric, including its unit, e.g. "ns_per_item".
+                 * @param value Measured value.
+                 * @return Reference to the calling instance.
+                 */
+                Result& metric(const std::string& key, double value);
+
+                /**
+                 * Function to add the common throughput metrics of a timing.
+                 *
+                 * @param seconds Time of one call of the kernel.
+                 * @param items Number of items processed by one call.
+                 * @return Reference to the calling instance.
+                 */
+                Result& throughput(double seconds, double items);
+
+                /**
+                 * Function to write the result as a JSON object.
+                 *
+                 * @param stream Stream to write to.
+                 */
+                void write(std::ostream& stream) const;
+
+                /**
+                 * Function to write the result as a single line of text.
+                 *
+                 * @param stream Stream to write to.
+                 */
+                void print(std::ostream& stream) const;
+
+
+            private:
+
+                typedef std::vector<std::pair<std::string, std::string> > Entries;
+
+                std::string m_name;     /**< Name of the measured operation. */
+                Entries m_params;       /**< Parameters as JSON values. */
+                Entries m_metrics;      /**< Metrics as JSON values. */
+
+        }; /* Class Result */
+
+
+
+        /**
+         * State handed to a running benchmark.
+         */
+        class Context final {
+
+            public:
+
+                /**
+                 * Constructor.
+                 *
+                 * @param options Options of the run.
+                 */
+                explicit Context(const Options& options);
+
+                /**
+                 * Function to get the options of the run.
+                 *
+                 * @return Options.
+                 */
+                const Options& options() const;
+
+                /**
+                 * Function to time a kernel. The kernel is called in batches of growing size
+                 * until a batch runs long enough to time reliably, the fastest of several such
+                 * batches is taken.
+                 *
+                 * @param kernel Function object called without arguments.
+                 * @return Time of one call in seconds.
+                 */
+                template<typename F>
+                double measure(F kernel);
+
+                /**
+                 * Function to add a result.
+                 *
+                 * @param name Name of the measured operation.
+                 * @return New result to add parameters and metrics to.
+                 */
+                Result& report(const std::string& name);
+
+                /**
+                 * Function to get the results reported so far.
+                 *
+                 * @return Results in the order they were reported.
+                 */
+                const std::vector<Result>& results() const;
+
+
+            private:
+
+                Options m_options;              /**< Options of the run. */
+                std::vector<Result> m_results;  /**< Reported results. */
+
+                /**
+                 * Function to get the time a timed batch should at least take.
+                 *
+                 * @return Time in seconds.
+                 */
+                double getBatchTime() const;
+
+                /**
+                 * Function to get the number of timed batches.
+                 *
+                 * @return Number of batches.
+                 */
+                int getRepetitions() const;
+
+                /**
+                 * Copy constructor is forbidden.
+                 */
+                Context(const Context& context);
+
+                /**
+                 * Assignment operator is forbidden.
+                 */
+                Context& operator=(const Context& context);
+
+        }; /* Class Context */
+
+
+
+        /**
+         * Function running a benchmark.
+         */
+        typedef void (*BenchmarkFunction)(Context& context);
+
+        /**
+         * Registered benchmark.
+         */
+        struct Benchmark {
+            const char* name;               /**< Name of the benchmark. */
+            BenchmarkFunction function;     /**< Function running it. */
+        };
+
+        /**
+         * Helper registering a benchmark on construction. Use PIKO_BENCHMARK instead.
+         */
+        struct Registration {
+            Registration(const char* name, BenchmarkFunction function);
+        };
+
+        /**
+         * Function to get all registered benchmarks.
+         *
+         * @return Benchmarks sorted by name.
+         */
+        std::vector<Benchmark> getBenchmarks();
+
+        /**
+         * Function to keep the compiler from optimizing away the computation of a value.
+         *
+         * @param ptr Pointer to the value, which is assumed to be read and written.
+         */
+        inline void keep(const void* ptr) {
+#if defined(__GNUC__)
+            __asm__ __volatile__("" : : "g"(ptr) : "memory");
+#else
+            static const void* volatile sink;
+            sink = ptr;
+#endif
+        }
+
+        /**
+         * Function to get the name of a coordinate type.
+         *
+         * @return Name of the type.
+         */
+        template<typename T> const char* typeName();
+        template<> inline const char* typeName<float>() { return "float"; }
+        template<> inline const char* typeName<double>() { return "double"; }
+        template<> inline const char* typeName<int>() { return "int"; }
+
+        /**
+         * Function to get the array sizes used by batch benchmarks. They range from arrays
+         * fitting the L1 cache to arrays only fitting main memory, the quick mode stops at L2.
+         *
+         * @param options Options of the run.
+         * @return Number of elements.
+         */
+        std::vector<std::size_t> getSizes(const Options& options);
+
+
+
+        /*==========================================
+         * INLINE IMPLEMENTATION
+         *=========================================*/
+
+        template<typename F>
+        inline double Context::measure(F kernel) {
+
+            typedef std::chrono::steady_clock Clock;
+
+            // Warm up caches and find a batch size which runs long enough.
+            std::size_t calls = 1;
+            for(;;) {
+                Clock::time_point start = Clock::now();
+                for(std::size_t i = 0; i < calls; ++i) kernel();
+                double elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+
+                if(elapsed >= getBatchTime()) break;
+                calls *= elapsed > 0.0 ? std::min<std::size_t>(
+                    (std::size_t)(getBatchTime() / elapsed) + 1, 16) : 16;
+            }
+
+            double best = 0.0;
+            for(int r = 0; r < getRepetitions(); ++r) {
+                Clock::time_point start = Clock::now();
+                for(std::size_t i = 0; i < calls; ++i) kernel();
+                double elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+
+                if(r == 0 || elapsed < best) best = elapsed;
+            }
+
+            return best / calls;
+        }
+
+    } /* Namespace bench */
+
+} /* Namespace Piko */
+
+
+#endif // End of BENCHMARK_H
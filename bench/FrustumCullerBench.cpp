@@ -0,0 +1,144 @@
+/**
+ * @file        FrustumCullerBench.cpp
+ * @author      Robert Koch
+ * @version     1.0
+ *
+ * Throughput benchmarks of the FrustumCuller in culled volumes per second. The scalar loop over
+ * Frustum::isVisible(), which is what the draw loop did per object before, is the baseline of
+ * the SIMD pass on one thread, the parallel pass is timed with 1 to --workers threads.
+ */
+#include "Benchmark.h"
+#include "../include/FrustumCuller.h"
+#include "../include/JobSystem.h"
+#include "../include/util/Matrix4x4.h"
+
+#include <random>
+#include <vector>
+
+
+namespace {
+
+    using namespace Piko;
+    using namespace Piko::bench;
+
+    /**
+     * Function to report the timing of a culling pass.
+     *
+     * @param context Benchmark context.
+     * @param name Name of the pass.
+     * @param volume Kind of the volumes, "sphere" or "box".
+     * @param workers Number of threads running the pass.
+     * @param count Number of volumes.
+     * @param visible Number of visible volumes.
+     * @param seconds Time of one pass.
+     */
+    void report(Context& context, const char* name, const char* volume, std::size_t workers,
+                std::size_t count, std::size_t visible, double seconds) {
+
+        context.report(name)
+            .param("volume", volume)
+            .param("workers", (double)workers)
+            .param("size", (double)count)
+            .throughput(seconds, (double)count)
+            .metric("visible_fraction", (double)visible / count);
+    }
+
+    /**
+     * Function to time all passes over one kind of volume.
+     *
+     * @param context Benchmark context.
+     * @param volume Kind of the volumes, "sphere" or "box".
+     * @param count Number of volumes.
+     * @param scalar Callable running the scalar baseline, returning the visible count.
+     * @param serial Callable running the serial pass, returning the visible count.
+     * @param parallel Callable taking a job system and running the parallel pass.
+     */
+    template<typename S, typename F, typename P>
+    void runVolume(Context& context, const char* volume, std::size_t count, S scalar, F serial,
+                   P parallel) {
+
+        std::size_t visible = 0;
+
+        double seconds = context.measure([&]() { visible = scalar(); });
+        report(context, "Frustum::isVisible", volume, 1, count, visible, seconds);
+
+        seconds = context.measure([&]() { visible = serial(); });
+        report(context, "FrustumCuller::cull", volume, 1, count, visible, seconds);
+
+        for(std::size_t threads = 1; threads <= context.options().workers; ++threads) {
+            JobSystem jobs(threads - 1);
+            seconds = context.measure([&]() { visible = parallel(jobs); });
+            report(context, "FrustumCuller::cull(jobs)", volume, threads, count, visible,
+                   seconds);
+        }
+    }
+
+} /* Anonymous namespace */
+
+
+
+PIKO_BENCHMARK(frustum_culling) {
+
+    // About a seventh of the volumes is visible, as for a camera at the edge of a large scene.
+    const Matrix4x4<float> viewProjection =
+        Matrix4x4<float>::perspective(1.2f, 16.0f / 9.0f, 0.5f, 500.0f) *
+        Matrix4x4<float>::lookAt(Vector3D<float>(0.0f, 0.0f, -500.0f),
+                                 Vector3D<float>(0.0f, 0.0f, 0.0f),
+                                 Vector3D<float>(0.0f, 1.0f, 0.0f));
+    const Frustum<float> frustum(viewProjection);
+
+    const std::vector<std::size_t> sizes = getSizes(context.options());
+
+    for(std::size_t s = 0; s < sizes.size(); ++s) {
+        const std::size_t count = sizes[s];
+
+        std::mt19937 rng(42);
+        std::uniform_real_distribution<float> coordinate(-500.0f, 500.0f);
+        std::uniform_real_distribution<float> size(0.5f, 5.0f);
+
+        FrustumCuller culler;
+        std::vector<Vector3D<float>> centers(count);
+        std::vector<float> radii(count);
+        std::vector<AABB<float>> boxes(count);
+
+        for(std::size_t i = 0; i < count; ++i) {
+            centers[i] = Vector3D<float>(coordinate(rng), coordinate(rng), coordinate(rng));
+            radii[i] = size(rng);
+            culler.addSphere(centers[i], radii[i]);
+
+            const Vector3D<float> min(coordinate(rng), coordinate(rng), coordinate(rng));
+            boxes[i] = AABB<float>(min, min + Vector3D<float>(size(rng), size(rng), size(rng)));
+            culler.addBox(boxes[i]);
+        }
+
+        // The scalar loop writes a list of its own, since the passes of the culler resize it.
+        std::vector<std::uint32_t> indices(count);
+        std::vector<std::uint32_t> visible;
+
+        runVolume(context, "sphere", count, [&]() {
+            std::size_t n = 0;
+            for(std::size_t i = 0; i < count; ++i) {
+                if(frustum.isVisible(centers[i], radii[i])) indices[n++] = (std::uint32_t)i;
+            }
+            keep(&indices[0]);
+            return n;
+        }, [&]() {
+            return culler.cullSpheres(frustum, visible);
+        }, [&](JobSystem& jobs) {
+            return culler.cullSpheres(jobs, frustum, visible);
+        });
+
+        runVolume(context, "box", count, [&]() {
+            std::size_t n = 0;
+            for(std::size_t i = 0; i < count; ++i) {
+                if(frustum.isVisible(boxes[i])) indices[n++] = (std::uint32_t)i;
+            }
+            keep(&indices[0]);
+            return n;
+        }, [&]() {
+            return culler.cullBoxes(frustum, visible);
+        }, [&](JobSystem& jobs) {
+            return culler.cullBoxes(jobs, frustum, visible);
+        });
+    }
+}
\ No newline at end of file
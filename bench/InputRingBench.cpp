@@ -0,0 +1,146 @@
+/**
+ * @file        InputRingBench.cpp
+ * @author      Robert Koch
+ * @version     1.0
+ *
+ * Benchmarks of the input path: the SPSCRing on its own, with a producer and a consumer on the
+ * same thread and on two threads, and a WindowBase recording a synthetic high-rate event stream
+ * which the simulation drains in batches, as it would once per tick.
+ */
+#include "Benchmark.h"
+#include "../include/HeadlessWindowBackend.h"
+#include "../include/InputEvent.h"
+#include "../include/WindowBase.h"
+#include "../include/util/SPSCRing.h"
+
+#include <memory>
+#include <thread>
+#include <vector>
+
+
+namespace {
+
+    using namespace Piko;
+    using namespace Piko::bench;
+
+    /**
+     * Function to get a synthetic key event.
+     *
+     * @param index Index of the event.
+     * @return Event.
+     */
+    InputEvent getEvent(std::size_t index) {
+
+        InputEvent event;
+        event.timestamp = index;
+        event.type = InputEventType::KEY_DOWN;
+        event.key.code = (std::int32_t)(index & 0xFF);
+        event.key.repeat = 0;
+        return event;
+    }
+
+    /**
+     * Function to time a producer and a consumer thread passing events through a ring.
+     *
+     * @param context Benchmark context.
+     * @param count Number of events.
+     * @param batch Maximum number of events taken per pop.
+     */
+    void runThreads(Context& context, std::size_t count, std::size_t batch) {
+
+        SPSCRing<InputEvent> ring(WindowBase::INPUT_CAPACITY);
+        std::vector<InputEvent> events(batch);
+
+        const double seconds = context.measure([&]() {
+            std::thread producer([&ring, count]() {
+                for(std::size_t i = 0; i < count; ) {
+                    if(ring.push(getEvent(i))) ++i;
+                    else std::this_thread::yield();
+                }
+            });
+
+            for(std::size_t taken = 0; taken < count; ) {
+                const std::size_t n = ring.pop(&events[0], batch);
+                if(n == 0) std::this_thread::yield();
+                taken += n;
+            }
+
+            producer.join();
+            keep(&events[0]);
+        });
+
+        context.report("SPSCRing<InputEvent>")
+            .param("mode", "threads")
+            .param("batch", (double)batch)
+            .param("events", (double)count)
+            .throughput(seconds, (double)count);
+    }
+
+} /* Anonymous namespace */
+
+
+
+PIKO_BENCHMARK(input_ring) {
+
+    const std::size_t count = context.options().quick ? 1 << 14 : 1 << 20;
+    const std::size_t batches[] = { 1, 64, 1024 };
+
+    // Producer and consumer on one thread: the cost of the ring without any contention.
+    for(std::size_t b = 0; b < sizeof(batches) / sizeof(batches[0]); ++b) {
+        const std::size_t batch = batches[b];
+        SPSCRing<InputEvent> ring(WindowBase::INPUT_CAPACITY);
+        std::vector<InputEvent> events(batch);
+
+        const double seconds = context.measure([&]() {
+            for(std::size_t i = 0; i < count; i += batch) {
+                for(std::size_t k = 0; k < batch; ++k) ring.push(getEvent(i + k));
+                ring.pop(&events[0], batch);
+            }
+            keep(&events[0]);
+        });
+
+        context.report("SPSCRing<InputEvent>")
+            .param("mode", "single")
+            .param("batch", (double)batch)
+            .param("events", (double)count)
+            .throughput(seconds, (double)count);
+    }
+
+    // Producer and consumer on two threads, the indices move between the cores. The start of
+    // the producer is part of the time, which is small against the full event count.
+    for(std::size_t b = 0; b < sizeof(batches) / sizeof(batches[0]); ++b) {
+        runThreads(context, count, batches[b]);
+    }
+
+    // The whole input path: messages are recorded by the handler and drained once per tick.
+    HeadlessWindowBackend* backend = new HeadlessWindowBackend();
+    WindowBase window(std::unique_ptr<WindowBackend>(backend), "Benchmark", 320, 240);
+
+    const std::size_t perTick = 1024;
+    std::vector<InputEvent> events(perTick);
+    std::size_t next = 0;
+
+    backend->setEventSource([&](HeadlessMessage& msg) {
+        if(next == perTick) return false;
+        msg.msg = next % 2 ? WM_MOUSEMOVE : WM_KEYDOWN;
+        msg.wParam = 'A' + next % 26;
+        msg.lParam = (LPARAM)next++;
+        return true;
+    });
+
+    const double seconds = context.measure([&]() {
+        for(std::size_t i = 0; i < count; i += perTick) {
+            next = 0;
+            backend->processMessages();
+            window.pollInput(&events[0], perTick);
+        }
+        keep(&events[0]);
+    });
+
+    context.report("WindowBase::pollInput")
+        .param("mode", "window")
+        .param("batch", (double)perTick)
+        .param("events", (double)count)
+        .throughput(seconds, (double)count)
+        .metric("dropped", (double)window.getDroppedInputCount());
+}
\ No newline at end of file
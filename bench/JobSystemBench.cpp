@@ -0,0 +1,92 @@
+/**
+ * @file        JobSystemBench.cpp
+ * @author      Robert Koch
+ * @version     1.0
+ *
+ * Scaling benchmarks of the JobSystem. The same work is timed with 1 to --workers threads, the
+ * owner thread counted, so the speedup over a single thread shows how well the scheduling
+ * scales with the cores. A compute-bound parallelFor() and a memory-bound batch kernel are
+ * measured, since the second stops scaling once the memory bandwidth is used up.
+ */
+#include "Benchmark.h"
+#include "../include/JobSystem.h"
+#include "../include/ParallelBatch.h"
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+
+namespace {
+
+    using namespace Piko;
+    using namespace Piko::bench;
+
+    /**
+     * Function to time a kernel for all thread counts.
+     *
+     * @param context Benchmark context.
+     * @param name Name of the kernel.
+     * @param items Number of items processed by one call.
+     * @param kernel Function called with the job system which runs the kernel once.
+     */
+    template<typename F>
+    void runScaling(Context& context, const char* name, std::size_t items, F kernel) {
+
+        double single = 0.0;
+
+        for(std::size_t threads = 1; threads <= context.options().workers; ++threads) {
+            JobSystem jobs(threads - 1);
+
+            const double seconds = context.measure([&]() { kernel(jobs); });
+            if(threads == 1) single = seconds;
+
+            context.report(name)
+                .param("workers", (double)threads)
+                .param("size", (double)items)
+                .throughput(seconds, (double)items)
+                .metric("speedup", single / seconds)
+                .metric("efficiency", single / seconds / threads);
+        }
+    }
+
+} /* Anonymous namespace */
+
+
+
+PIKO_BENCHMARK(job_scaling) {
+
+    const bool isQuick = context.options().quick;
+
+    // Compute-bound: every index costs a square root, nothing is read from memory. The count
+    // is a power of two, so the halves are split into aligned pieces of exactly 1024 indices.
+    const std::size_t count = isQuick ? 1 << 16 : 1 << 22;
+    std::vector<double> sums(count / 1024 + 1);
+
+    runScaling(context, "parallelFor", count, [&](JobSystem& jobs) {
+        jobs.parallelFor(0, count, 1024, [&](std::size_t begin, std::size_t end) {
+            double sum = 0.0;
+            for(std::size_t i = begin; i < end; ++i) sum += std::sqrt((double)i + sum);
+            sums[begin / 1024] = sum;
+        });
+        keep(&sums[0]);
+    });
+
+    // Memory-bound: the arrays exceed the caches in the full run.
+    const std::size_t size = isQuick ? 1 << 14 : 1 << 22;
+    Vector3DArray<float> a(size), out(size);
+
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<float> coordinate(-1.0f, 1.0f);
+    for(std::size_t i = 0; i < size; ++i) {
+        const float x = coordinate(rng);
+        const float y = coordinate(rng);
+        const float z = coordinate(rng);
+        a.set(i, Vector3D<float>(x, y, z));
+    }
+
+    runScaling(context, "parallelBatchNormalize", size, [&](JobSystem& jobs) {
+        parallelBatchNormalize(jobs, a, out);
+        keep(out.x());
+    });
+}
\ No newline at end of file
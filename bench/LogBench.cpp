@@ -0,0 +1,108 @@
+/**
+ * @file        LogBench.cpp
+ * @author      Robert Koch
+ * @version     1.0
+ *
+ * Benchmarks of the Log: the cost a logging thread pays to capture a message, which is all that
+ * is on the caller's path, the cost including formatting and writing on the background thread,
+ * and the cost of a message filtered by the run time threshold. The output goes to a stream
+ * without buffer, so no terminal or file is timed.
+ */
+#include "Benchmark.h"
+#include "../include/Log.h"
+
+#include <chrono>
+#include <iostream>
+#include <ostream>
+#include <string>
+
+
+namespace {
+
+    using namespace Piko;
+    using namespace Piko::bench;
+
+    /**
+     * Function to time logging a kind of message.
+     *
+     * @param context Benchmark context.
+     * @param mode Kind of arguments.
+     * @param write Function object logging one message, called with its index.
+     */
+    template<typename F>
+    void runWrite(Context& context, const char* mode, F write) {
+
+        typedef std::chrono::steady_clock Clock;
+
+        // Bursts fit into the buffer of the thread, so none of them is dropped.
+        const std::size_t burst = Log::BUFFER_CAPACITY / 2;
+        const std::size_t rounds = context.options().quick ? 64 : 1024;
+        const std::size_t dropped = Log::getDroppedCount();
+
+        // Capture only: the buffer is drained between the bursts, outside of the timing.
+        double seconds = 0.0;
+        for(std::size_t r = 0; r < rounds; ++r) {
+            const Clock::time_point start = Clock::now();
+            for(std::size_t i = 0; i < burst; ++i) write(i);
+            seconds += std::chrono::duration<double>(Clock::now() - start).count();
+            Log::flush();
+        }
+
+        context.report("Log::write")
+            .param("mode", mode)
+            .param("burst", (double)burst)
+            .throughput(seconds / rounds, (double)burst)
+            .metric("dropped", (double)(Log::getDroppedCount() - dropped));
+
+        // Capture, formatting and writing, flush() waits for the background thread.
+        seconds = context.measure([&]() {
+            for(std::size_t i = 0; i < burst; ++i) write(i);
+            Log::flush();
+        });
+
+        context.report("Log::write+flush")
+            .param("mode", mode)
+            .param("burst", (double)burst)
+            .throughput(seconds, (double)burst);
+    }
+
+} /* Anonymous namespace */
+
+
+
+PIKO_BENCHMARK(log) {
+
+    std::ostream discard(NULL);
+    const LogLevel level = Log::getLevel();
+
+    Log::setOutput(discard);
+    Log::setLevel(LogLevel::INFO);
+
+    const std::string name("Benchmark::entity");
+
+    runWrite(context, "literal", [](std::size_t) {
+        Log::write(LogLevel::INFO, "Frame finished.");
+    });
+    runWrite(context, "integers", [](std::size_t i) {
+        Log::write(LogLevel::INFO, "Frame {} took {} of {} us.", i, (int)i * 3, -1);
+    });
+    runWrite(context, "strings", [&name](std::size_t i) {
+        Log::write(LogLevel::INFO, "Entity {} at {} named {}.", i, i * 0.5, name);
+    });
+
+    // A message below the run time threshold costs the level check only.
+    Log::setLevel(LogLevel::WARNING);
+
+    const std::size_t count = 1024;
+    const double seconds = context.measure([&]() {
+        for(std::size_t i = 0; i < count; ++i) PIKO_LOG(LogLevel::INFO, "Frame {}.", i);
+    });
+
+    context.report("Log::write")
+        .param("mode", "disabled")
+        .param("burst", (double)count)
+        .throughput(seconds, (double)count);
+
+    Log::setLevel(level);
+    Log::setOutput(std::cout);
+}
\ No newline at end of file
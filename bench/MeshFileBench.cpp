@@ -0,0 +1,170 @@
+/**
+ * @file        MeshFileBench.cpp
+ * @author      Robert Koch
+ * @version     1.0
+ *
+ * Load time of a mesh as OBJ text against the memory-mapped binary format. The OBJ path reads
+ * the file and runs the parser of the MeshConverter tool, which is what loading did before.
+ * The mapped path opens the MeshFile and either touches every page of the streams or copies
+ * them as glBufferData() would, since the benchmarks run without a context. Both files stay in
+ * the page cache, so the timing excludes the disk.
+ */
+#include "Benchmark.h"
+#include "../include/MeshFile.h"
+#include "../tools/ObjParser.h"
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+
+namespace {
+
+    using namespace Piko;
+    using namespace Piko::bench;
+
+    /** Files written by the benchmark, in the working directory. */
+    const char* const OBJ_PATH = "MeshFileBench.obj";
+    const char* const MESH_PATH = "MeshFileBench.pkm";
+
+    /** Page size assumed when touching the mapping. */
+    const std::size_t PAGE_SIZE = 4096;
+
+    /**
+     * Function to write a grid of quads with all attributes as OBJ text.
+     *
+     * @param path Path of the file.
+     * @param side Number of vertices along each axis, at least 2.
+     * @return Size of the file in bytes.
+     */
+    std::size_t writeObj(const char* path, std::size_t side) {
+
+        std::string text;
+        char line[128];
+
+        for(std::size_t z = 0; z < side; ++z) {
+            for(std::size_t x = 0; x < side; ++x) {
+                const float u = (float)x / (side - 1);
+                const float v = (float)z / (side - 1);
+                std::snprintf(line, sizeof(line), "v %g %g %g\nvn %g %g %g\nvt %g %g\n",
+                              u * 100.0f, u * v, v * 100.0f, 0.0f, 1.0f, u, u, v);
+                text += line;
+            }
+        }
+
+        for(std::size_t z = 0; z + 1 < side; ++z) {
+            for(std::size_t x = 0; x + 1 < side; ++x) {
+                const unsigned long i = (unsigned long)(z * side + x + 1);
+                const unsigned long j = i + (unsigned long)side;
+                std::snprintf(line, sizeof(line), "f %lu/%lu/%lu %lu/%lu/%lu %lu/%lu/%lu "
+                              "%lu/%lu/%lu\n", i, i, i, j, j, j, j + 1, j + 1, j + 1,
+                              i + 1, i + 1, i + 1);
+                text += line;
+            }
+        }
+
+        std::ofstream file(path, std::ios::out | std::ios::binary | std::ios::trunc);
+        file.write(text.data(), (std::streamsize)text.size());
+        return text.size();
+    }
+
+    /**
+     * Function to read a whole file.
+     *
+     * @param path Path of the file.
+     * @return Contents of the file.
+     */
+    std::string readFile(const char* path) {
+
+        std::ifstream file(path, std::ios::in | std::ios::binary);
+        return std::string((std::istreambuf_iterator<char>(file)),
+                           std::istreambuf_iterator<char>());
+    }
+
+    /**
+     * Function to report the timing of a load.
+     *
+     * @param context Benchmark context.
+     * @param name Name of the load path.
+     * @param vertices Number of vertices.
+     * @param bytes Size of the loaded file.
+     * @param seconds Time of one load.
+     * @param baseline Time of one load from OBJ text.
+     */
+    void report(Context& context, const char* name, std::size_t vertices, std::size_t bytes,
+                double seconds, double baseline) {
+
+        context.report(name)
+            .param("vertices", (double)vertices)
+            .throughput(seconds, (double)vertices)
+            .metric("file_mb", (double)bytes / (1024.0 * 1024.0))
+            .metric("load_ms", seconds * 1000.0)
+            .metric("speedup", baseline / seconds);
+    }
+
+} /* Anonymous namespace */
+
+
+
+PIKO_BENCHMARK(mesh_loading) {
+
+    // Vertices per side, the largest grid has about a million vertices and a 150 MB OBJ file.
+    std::vector<std::size_t> sides;
+    sides.push_back(32);
+    if(!context.options().quick) {
+        sides.push_back(128);
+        sides.push_back(512);
+        sides.push_back(1024);
+    }
+
+    for(std::size_t s = 0; s < sides.size(); ++s) {
+        const std::size_t objBytes = writeObj(OBJ_PATH, sides[s]);
+
+        MeshData mesh;
+        parseObj(readFile(OBJ_PATH).c_str(), mesh);
+        MeshFile::write(MESH_PATH, mesh);
+
+        const std::size_t vertices = mesh.positions.size();
+        const std::size_t meshBytes = readFile(MESH_PATH).size();
+
+        MeshFile written(MESH_PATH);
+        std::vector<char> vertexCopy(vertices * written.getVertexStride());
+        std::vector<char> indexCopy(written.getIndexCount() * written.getIndexSize());
+        written.close();
+
+        const double baseline = context.measure([&]() {
+            MeshData loaded;
+            parseObj(readFile(OBJ_PATH).c_str(), loaded);
+            keep(&loaded.indices[0]);
+        });
+        report(context, "parseObj", vertices, objBytes, baseline, baseline);
+
+        // Reading one byte per page faults the whole streams into the mapping.
+        double seconds = context.measure([&]() {
+            MeshFile file(MESH_PATH);
+            const char* v = static_cast<const char*>(file.getVertexData());
+            const char* i = static_cast<const char*>(file.getIndexData());
+
+            unsigned int sum = 0;
+            for(std::size_t k = 0; k < vertexCopy.size(); k += PAGE_SIZE) sum += v[k];
+            for(std::size_t k = 0; k < indexCopy.size(); k += PAGE_SIZE) sum += i[k];
+            keep(&sum);
+        });
+        report(context, "MeshFile::open", vertices, meshBytes, seconds, baseline);
+
+        seconds = context.measure([&]() {
+            MeshFile file(MESH_PATH);
+            std::memcpy(&vertexCopy[0], file.getVertexData(), vertexCopy.size());
+            std::memcpy(&indexCopy[0], file.getIndexData(), indexCopy.size());
+            keep(&vertexCopy[0]);
+            keep(&indexCopy[0]);
+        });
+        report(context, "MeshFile::open+copy", vertices, meshBytes, seconds, baseline);
+    }
+
+    std::remove(OBJ_PATH);
+    std::remove(MESH_PATH);
+}
\ No newline at end of file
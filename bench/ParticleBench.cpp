@@ -0,0 +1,131 @@
+/**
+ * @file        ParticleBench.cpp
+ * @author      Robert Koch
+ * @version     1.0
+ *
+ * Headless benchmarks of the ParticleSystem in particles updated per millisecond: an array of
+ * structures with Vector3D members as the baseline, the serial SIMD update, the parallel update
+ * with 1 to --workers threads, and the writing of the vertices which stream() maps the buffer
+ * for. The lifetimes outlast the timing, so the count stays constant.
+ */
+#include "Benchmark.h"
+#include "../include/JobSystem.h"
+#include "../include/ParticleSystem.h"
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+
+namespace {
+
+    using namespace Piko;
+    using namespace Piko::bench;
+
+    /** Time step of one update. */
+    const float TIME_STEP = 1.0f / 60.0f;
+
+    /**
+     * Particle as the game code stored them before.
+     */
+    struct Particle {
+        Vector3D<float> position;   /**< Position. */
+        Vector3D<float> velocity;   /**< Velocity. */
+        float lifetime;             /**< Remaining lifetime. */
+    };
+
+    /**
+     * Function to report the timing of an update.
+     *
+     * @param context Benchmark context.
+     * @param name Name of the measured operation.
+     * @param workers Number of threads.
+     * @param count Number of particles.
+     * @param seconds Time of one update.
+     */
+    void report(Context& context, const char* name, std::size_t workers, std::size_t count,
+                double seconds) {
+
+        context.report(name)
+            .param("workers", (double)workers)
+            .param("particles", (double)count)
+            .throughput(seconds, (double)count)
+            .metric("particles_per_ms", (double)count / seconds / 1000.0);
+    }
+
+} /* Anonymous namespace */
+
+
+
+PIKO_BENCHMARK(particles) {
+
+    const std::vector<std::size_t> sizes = getSizes(context.options());
+
+    // Small runs repeat the update often, the wind keeps the drag from decaying velocities
+    // into denormals, which would dominate the time.
+    const Vector3D<float> gravity(1.0f, -9.81f, 0.5f);
+    const float drag = 0.2f;
+
+    for(std::size_t s = 0; s < sizes.size(); ++s) {
+        const std::size_t count = sizes[s];
+
+        std::mt19937 rng(42);
+        std::uniform_real_distribution<float> coordinate(-10.0f, 10.0f);
+
+        ParticleSystem system(count);
+        system.setGravity(gravity);
+        system.setDrag(drag);
+
+        std::vector<Particle> particles(count);
+        for(std::size_t i = 0; i < count; ++i) {
+            const Vector3D<float> p(coordinate(rng), coordinate(rng), coordinate(rng));
+            const Vector3D<float> v(coordinate(rng), coordinate(rng), coordinate(rng));
+            system.emit(p, v, 1e9f);
+            particles[i].position = p;
+            particles[i].velocity = v;
+            particles[i].lifetime = 1e9f;
+        }
+
+        // The baseline integrates the same formulas and compacts the same way.
+        double seconds = context.measure([&]() {
+            const float damping = std::exp(-drag * TIME_STEP);
+            const Vector3D<float> g = gravity * TIME_STEP;
+            std::size_t n = particles.size();
+
+            for(std::size_t i = 0; i < n; ) {
+                Particle& p = particles[i];
+                p.velocity = (p.velocity + g) * damping;
+                p.position += p.velocity * TIME_STEP;
+                p.lifetime -= TIME_STEP;
+
+                if(p.lifetime > 0.0f) ++i;
+                else p = particles[--n];
+            }
+            particles.resize(n);
+            keep(&particles[0]);
+        });
+        report(context, "std::vector<Particle>", 1, count, seconds);
+
+        seconds = context.measure([&]() {
+            system.update(TIME_STEP);
+            keep(system.getPositions().x());
+        });
+        report(context, "ParticleSystem::update", 1, count, seconds);
+
+        for(std::size_t threads = 1; threads <= context.options().workers; ++threads) {
+            JobSystem jobs(threads - 1);
+            seconds = context.measure([&]() {
+                system.update(jobs, TIME_STEP);
+                keep(system.getPositions().x());
+            });
+            report(context, "ParticleSystem::update(jobs)", threads, count, seconds);
+        }
+
+        std::vector<ParticleVertex> vertices(count);
+        seconds = context.measure([&]() {
+            system.writeVertices(&vertices[0]);
+            keep(&vertices[0]);
+        });
+        report(context, "ParticleSystem::writeVertices", 1, count, seconds);
+    }
+}
\ No newline at end of file
@@ -0,0 +1,163 @@
+/**
+ * @file        PrecisionBench.cpp
+ * @author      Robert Koch
+ * @version     1.0
+ *
+ * Benchmarks of the precision policies. Every policy normalizes the same random vectors with
+ * Vector3D::normalize() and with batchNormalize(); besides the time, the maximum and mean
+ * relative error against a long double reference are reported, so speed and accuracy of
+ * ExactPrecision, FastPrecision and EstimatePrecision can be weighed against each other.
+ */
+#include "Benchmark.h"
+#include "../include/util/Vector3D.h"
+#include "../include/util/Vector3DArray.h"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+
+namespace {
+
+    using namespace Piko;
+    using namespace Piko::bench;
+
+    /**
+     * Accumulated relative errors of a set of normalized vectors.
+     */
+    struct Error {
+        long double max;        /**< Maximum relative error. */
+        long double sum;        /**< Sum of the relative errors. */
+        std::size_t count;      /**< Number of vectors. */
+    };
+
+    /**
+     * Function to add the error of one normalized vector. As the exact result has length one,
+     * the length of the difference is the relative error.
+     *
+     * @param error Accumulated errors.
+     * @param v Vector before normalization.
+     * @param x X coordinate of the normalized vector.
+     * @param y Y coordinate of the normalized vector.
+     * @param z Z coordinate of the normalized vector.
+     */
+    template<typename T>
+    void addError(Error& error, const Vector3D<T>& v, T x, T y, T z) {
+
+        const long double vx = v.x();
+        const long double vy = v.y();
+        const long double vz = v.z();
+        const long double length = std::sqrt(vx * vx + vy * vy + vz * vz);
+
+        const long double dx = (long double)x - vx / length;
+        const long double dy = (long double)y - vy / length;
+        const long double dz = (long double)z - vz / length;
+        const long double e = std::sqrt(dx * dx + dy * dy + dz * dz);
+
+        error.max = std::max(error.max, e);
+        error.sum += e;
+        ++error.count;
+    }
+
+    /**
+     * Function to add the error metrics to a result.
+     *
+     * @param result Result to add to.
+     * @param error Accumulated errors.
+     */
+    void reportError(Result& result, const Error& error) {
+
+        result.metric("max_rel_error", (double)error.max)
+              .metric("mean_rel_error", (double)(error.sum / error.count));
+    }
+
+    /**
+     * Function to time a precision policy and measure its error over arrays of all sizes.
+     *
+     * @param context Benchmark context.
+     * @param policy Name of the policy.
+     */
+    template<typename T, typename P>
+    void runPolicy(Context& context, const char* policy) {
+
+        const std::vector<std::size_t> sizes = getSizes(context.options());
+
+        for(std::size_t k = 0; k < sizes.size(); ++k) {
+            const std::size_t n = sizes[k];
+
+            // Magnitudes span several orders, the estimates are relative to the magnitude.
+            std::mt19937 rng(42);
+            std::uniform_real_distribution<double> coordinate(-1.0, 1.0);
+            std::uniform_real_distribution<double> exponent(-3.0, 3.0);
+
+            std::vector<Vector3D<T>> a(n), out(n);
+            Vector3DArray<T> array(n), arrayOut(n);
+            for(std::size_t i = 0; i < n; ++i) {
+                const double scale = std::pow(10.0, exponent(rng));
+                const T x = T(coordinate(rng) * scale);
+                const T y = T(coordinate(rng) * scale);
+                const T z = T(coordinate(rng) * scale);
+                a[i] = Vector3D<T>(x, y, z);
+                array.set(i, a[i]);
+            }
+
+            const double single = context.measure([&]() {
+                for(std::size_t i = 0; i < n; ++i) {
+                    Vector3D<T> t(a[i]);
+                    t.template normalize<P>();
+                    out[i] = t;
+                }
+                keep(&out[0]);
+            });
+
+            const double batch = context.measure([&]() {
+                batchNormalize<P>(array, arrayOut);
+                keep(arrayOut.x());
+            });
+
+            Error singleError = { 0.0L, 0.0L, 0 };
+            Error batchError = { 0.0L, 0.0L, 0 };
+            for(std::size_t i = 0; i < n; ++i) {
+                addError(singleError, a[i], out[i].x(), out[i].y(), out[i].z());
+                addError(batchError, a[i], arrayOut.x()[i], arrayOut.y()[i], arrayOut.z()[i]);
+            }
+
+            Result& singleResult = context.report(std::string("normalize<") + policy + ">")
+                .param("type", typeName<T>())
+                .param("mode", "single")
+                .param("size", (double)n)
+                .throughput(single, (double)n);
+            reportError(singleResult, singleError);
+
+            Result& batchResult = context.report(std::string("batchNormalize<") + policy + ">")
+                .param("type", typeName<T>())
+                .param("mode", "batch")
+                .param("size", (double)n)
+                .throughput(batch, (double)n);
+            reportError(batchResult, batchError);
+        }
+    }
+
+    /**
+     * Function to run all policies for a coordinate type.
+     *
+     * @param context Benchmark context.
+     */
+    template<typename T>
+    void runPolicies(Context& context) {
+
+        runPolicy<T, ExactPrecision>(context, "ExactPrecision");
+        runPolicy<T, FastPrecision>(context, "FastPrecision");
+        runPolicy<T, EstimatePrecision>(context, "EstimatePrecision");
+    }
+
+} /* Anonymous namespace */
+
+
+
+PIKO_BENCHMARK(precision) {
+
+    runPolicies<float>(context);
+    runPolicies<double>(context);
+}
\ No newline at end of file
@@ -0,0 +1,91 @@
+/**
+ * @file        ProfilerBench.cpp
+ * @author      Robert Koch
+ * @version     1.0
+ *
+ * Benchmarks of the Profiler: the cost of a zone while no capture is running, which an enabled
+ * profiler adds to every marked scope, the cost while capturing, and the export of a captured
+ * trace. Zones are created as ProfileZone directly, the macros are compiled out in release
+ * builds.
+ */
+#include "Benchmark.h"
+#include "../include/Profiler.h"
+
+#include <ostream>
+#include <streambuf>
+
+
+namespace {
+
+    using namespace Piko;
+    using namespace Piko::bench;
+
+    /**
+     * Stream buffer dropping everything written to it.
+     */
+    class NullBuffer final : public std::streambuf {
+
+        protected:
+
+            int_type overflow(int_type c) {
+                return traits_type::not_eof(c);
+            }
+
+            std::streamsize xsputn(const char*, std::streamsize count) {
+                return count;
+            }
+    };
+
+    /**
+     * Function to record a number of zones, each nesting another one.
+     *
+     * @param count Number of outer zones.
+     */
+    void recordZones(std::size_t count) {
+
+        for(std::size_t i = 0; i < count; ++i) {
+            ProfileZone outer("outer");
+            ProfileZone inner("inner");
+        }
+    }
+
+} /* Anonymous namespace */
+
+
+
+PIKO_BENCHMARK(profiler) {
+
+    // Two zones per iteration, all of them fit into the events of one capture.
+    const std::size_t count = context.options().quick ? 1 << 12 : Profiler::MAX_THREAD_EVENTS / 2;
+    const std::size_t zones = 2 * count;
+
+    double seconds = context.measure([count]() { recordZones(count); });
+
+    context.report("ProfileZone")
+        .param("mode", "idle")
+        .param("zones", (double)zones)
+        .throughput(seconds, (double)zones);
+
+    // Each call starts a new capture, which resets the buffer of the thread on its first zone.
+    seconds = context.measure([count]() {
+        Profiler::startCapture();
+        recordZones(count);
+        Profiler::stopCapture();
+    });
+
+    context.report("ProfileZone")
+        .param("mode", "capturing")
+        .param("zones", (double)zones)
+        .throughput(seconds, (double)zones)
+        .metric("dropped", (double)Profiler::getDroppedCount());
+
+    // Export of the last capture to a stream dropping its output, only the formatting is timed.
+    NullBuffer buffer;
+    std::ostream discard(&buffer);
+
+    seconds = context.measure([&discard]() { Profiler::writeChromeTrace(discard); });
+
+    context.report("Profiler::writeChromeTrace")
+        .param("zones", (double)zones)
+        .throughput(seconds, (double)zones);
+}
\ No newline at end of file
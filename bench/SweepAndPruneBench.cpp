@@ -0,0 +1,223 @@
+/**
+ * @file        SweepAndPruneBench.cpp
+ * @author      Robert Koch
+ * @version     1.0
+ *
+ * Benchmarks of the SweepAndPrune broadphase at varying motion coherence. Every timed frame
+ * moves all bodies and finds the overlapping pairs. Bodies moving a small fraction of their size
+ * per frame keep the insertion sort short, bodies teleported to random positions make every
+ * frame a full sort. The brute-force test of all pairs is the baseline for small scenes.
+ */
+#include "Benchmark.h"
+#include "../include/util/SweepAndPrune.h"
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+
+namespace {
+
+    using namespace Piko;
+    using namespace Piko::bench;
+
+    /** Number of precomputed frames of the random motion. */
+    const std::size_t RANDOM_FRAMES = 8;
+
+    /**
+     * Scene of moving bodies bouncing in a cube.
+     */
+    struct Scene {
+        std::vector<Vector3D<float>> positions;     /**< Minimum corner of each body. */
+        std::vector<Vector3D<float>> velocities;    /**< Movement of each body per frame. */
+        std::vector<Vector3D<float>> sizes;         /**< Size of each body. */
+        float side;                                 /**< Side length of the cube. */
+    };
+
+    /**
+     * Function to create a scene of constant density.
+     *
+     * @param count Number of bodies.
+     * @param speed Maximum movement per frame along each axis.
+     * @return Scene.
+     */
+    Scene createScene(std::size_t count, float speed) {
+
+        Scene scene;
+        scene.side = 4.0f * std::cbrt((float)count);
+
+        std::mt19937 rng(42);
+        std::uniform_real_distribution<float> coordinate(0.0f, scene.side);
+        std::uniform_real_distribution<float> velocity(-speed, speed);
+        std::uniform_real_distribution<float> size(0.5f, 2.0f);
+
+        for(std::size_t i = 0; i < count; ++i) {
+            scene.positions.push_back(Vector3D<float>(coordinate(rng), coordinate(rng),
+                                                      coordinate(rng)));
+            scene.velocities.push_back(Vector3D<float>(velocity(rng), velocity(rng),
+                                                       velocity(rng)));
+            scene.sizes.push_back(Vector3D<float>(size(rng), size(rng), size(rng)));
+        }
+
+        return scene;
+    }
+
+    /**
+     * Function to move a coordinate and reflect it at the walls of the cube.
+     *
+     * @param p Coordinate.
+     * @param v Velocity, negated at a wall.
+     * @param side Side length of the cube.
+     * @return Moved coordinate.
+     */
+    float bounce(float p, float& v, float side) {
+
+        p += v;
+        if(p < 0.0f || p > side) {
+            v = -v;
+            p += 2.0f * v;
+        }
+        return p;
+    }
+
+    /**
+     * Function to move a body and reflect it at the walls of the cube.
+     *
+     * @param p Minimum corner of the body.
+     * @param v Velocity, negated per axis at a wall.
+     * @param side Side length of the cube.
+     */
+    void bounce(Vector3D<float>& p, Vector3D<float>& v, float side) {
+
+        float vx = v.x();
+        float vy = v.y();
+        float vz = v.z();
+
+        p.setPosition(bounce(p.x(), vx, side), bounce(p.y(), vy, side),
+                      bounce(p.z(), vz, side));
+        v.setPosition(vx, vy, vz);
+    }
+
+    /**
+     * Function to report the timing of a frame.
+     *
+     * @param context Benchmark context.
+     * @param name Name of the broadphase.
+     * @param motion Name of the motion.
+     * @param count Number of bodies.
+     * @param pairs Number of pairs found in the last frame.
+     * @param moves Number of insertion sort moves in the last frame.
+     * @param seconds Time of one frame.
+     */
+    void report(Context& context, const char* name, const char* motion, std::size_t count,
+                std::size_t pairs, std::size_t moves, double seconds) {
+
+        context.report(name)
+            .param("motion", motion)
+            .param("bodies", (double)count)
+            .throughput(seconds, (double)count)
+            .metric("pairs_per_body", (double)pairs / count)
+            .metric("moves_per_body", (double)moves / count);
+    }
+
+    /**
+     * Function to time frames of bodies moving a fraction of their size.
+     *
+     * @param context Benchmark context.
+     * @param motion Name of the motion.
+     * @param count Number of bodies.
+     * @param speed Maximum movement per frame along each axis.
+     */
+    void runCoherent(Context& context, const char* motion, std::size_t count, float speed) {
+
+        Scene scene = createScene(count, speed);
+        SweepAndPrune<float> sap;
+        for(std::size_t i = 0; i < count; ++i) {
+            sap.add(AABB<float>(scene.positions[i], scene.positions[i] + scene.sizes[i]));
+        }
+
+        std::vector<SweepAndPrune<float>::Pair> pairs;
+        sap.findPairs(pairs);
+
+        const double seconds = context.measure([&]() {
+            for(std::size_t i = 0; i < count; ++i) {
+                Vector3D<float>& p = scene.positions[i];
+                bounce(p, scene.velocities[i], scene.side);
+                sap.update((std::uint32_t)i, AABB<float>(p, p + scene.sizes[i]));
+            }
+            sap.findPairs(pairs);
+            keep(&pairs);
+        });
+
+        report(context, "SweepAndPrune", motion, count, pairs.size(), sap.getMoveCount(),
+               seconds);
+    }
+
+} /* Anonymous namespace */
+
+
+
+PIKO_BENCHMARK(sweep_and_prune) {
+
+    const bool isQuick = context.options().quick;
+
+    std::vector<std::size_t> counts;
+    counts.push_back(1000);
+    if(!isQuick) {
+        counts.push_back(10000);
+        counts.push_back(50000);
+    }
+
+    for(std::size_t c = 0; c < counts.size(); ++c) {
+        const std::size_t count = counts[c];
+
+        // The bodies are 0.5 to 2 units large, so the speeds are about 1% and 10% of a body.
+        runCoherent(context, "coherent", count, 0.02f);
+        runCoherent(context, "fast", count, 0.2f);
+
+        // Random motion, from frames precomputed so the timing excludes the generator.
+        Scene scene = createScene(count, 0.0f);
+        std::mt19937 rng(7);
+        std::uniform_real_distribution<float> coordinate(0.0f, scene.side);
+
+        std::vector<AABB<float>> frames(RANDOM_FRAMES * count);
+        for(std::size_t i = 0; i < frames.size(); ++i) {
+            const Vector3D<float> p(coordinate(rng), coordinate(rng), coordinate(rng));
+            frames[i] = AABB<float>(p, p + scene.sizes[i % count]);
+        }
+
+        SweepAndPrune<float> sap;
+        for(std::size_t i = 0; i < count; ++i) sap.add(frames[i]);
+
+        std::vector<SweepAndPrune<float>::Pair> pairs;
+        std::size_t frame = 0;
+
+        double seconds = context.measure([&]() {
+            frame = (frame + 1) % RANDOM_FRAMES;
+            const AABB<float>* boxes = &frames[frame * count];
+            for(std::size_t i = 0; i < count; ++i) sap.update((std::uint32_t)i, boxes[i]);
+            sap.findPairs(pairs);
+            keep(&pairs);
+        });
+
+        report(context, "SweepAndPrune", "random", count, pairs.size(), sap.getMoveCount(),
+               seconds);
+
+        // The quadratic baseline is only run where it finishes in reasonable time.
+        if(count > 10000) continue;
+
+        std::size_t found = 0;
+        seconds = context.measure([&]() {
+            const AABB<float>* boxes = &frames[0];
+            found = 0;
+            for(std::size_t i = 0; i < count; ++i) {
+                for(std::size_t j = i + 1; j < count; ++j) {
+                    if(boxes[i].intersects(boxes[j])) ++found;
+                }
+            }
+            keep(&found);
+        });
+
+        report(context, "brute_force", "random", count, found, 0, seconds);
+    }
+}
\ No newline at end of file
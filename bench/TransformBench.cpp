@@ -0,0 +1,140 @@
+/**
+ * @file        TransformBench.cpp
+ * @author      Robert Koch
+ * @version     1.0
+ *
+ * Benchmarks of the Matrix4x4 and Quaternion transforms for float and double. Points are
+ * transformed one at a time with transformPoint(), as a batch in array-of-structures layout and
+ * as a Vector3DArray; rotations are applied with Quaternion::rotate() and interpolated with
+ * slerp() and nlerp().
+ */
+#include "Benchmark.h"
+#include "../include/util/Matrix4x4.h"
+#include "../include/util/Quaternion.h"
+#include "../include/util/Vector3DArray.h"
+
+#include <random>
+#include <vector>
+
+
+namespace {
+
+    using namespace Piko;
+    using namespace Piko::bench;
+
+    /**
+     * Function to report the timing of a transform.
+     *
+     * @param context Benchmark context.
+     * @param name Name of the measured operation.
+     * @param mode Layout or calling mode.
+     * @param n Number of transformed items.
+     * @param bytes Size of the input.
+     * @param seconds Time of one pass over all items.
+     */
+    template<typename T>
+    void report(Context& context, const char* name, const char* mode, std::size_t n,
+                std::size_t bytes, double seconds) {
+
+        context.report(name)
+            .param("type", typeName<T>())
+            .param("mode", mode)
+            .param("size", (double)n)
+            .param("bytes", (double)bytes)
+            .throughput(seconds, (double)n);
+    }
+
+    /**
+     * Function to time all transforms for a coordinate type.
+     *
+     * @param context Benchmark context.
+     */
+    template<typename T>
+    void runTransforms(Context& context) {
+
+        const std::vector<std::size_t> sizes = getSizes(context.options());
+
+        const Matrix4x4<T> m = Matrix4x4<T>::translation(Vector3D<T>(1, 2, 3)) *
+                               Matrix4x4<T>::rotation(Vector3D<T>(1, 1, 0), (T)0.5) *
+                               Matrix4x4<T>::scaling(Vector3D<T>(2, 2, 2));
+        const Quaternion<T> q = Quaternion<T>::fromAxisAngle(Vector3D<T>(1, 1, 0), (T)0.5);
+
+        for(std::size_t k = 0; k < sizes.size(); ++k) {
+            const std::size_t n = sizes[k];
+            std::mt19937 rng(42);
+            std::uniform_real_distribution<double> coordinate(-1.0, 1.0);
+
+            std::vector<Vector3D<T>> points(n), out(n);
+            std::vector<Quaternion<T>> rotations(n), interpolated(n);
+            for(std::size_t i = 0; i < n; ++i) {
+                const T x = (T)coordinate(rng);
+                const T y = (T)coordinate(rng);
+                const T z = (T)coordinate(rng);
+                points[i] = Vector3D<T>(x, y, z);
+                rotations[i] = Quaternion<T>::fromAxisAngle(points[i], (T)coordinate(rng));
+            }
+
+            const Vector3DArray<T> soa(points);
+            Vector3DArray<T> soaOut(n);
+            const std::size_t aosBytes = n * sizeof(Vector3D<T>);
+
+            double seconds = context.measure([&]() {
+                for(std::size_t i = 0; i < n; ++i) out[i] = m.transformPoint(points[i]);
+                keep(&out[0]);
+            });
+            report<T>(context, "Matrix4x4::transformPoint", "single", n, aosBytes, seconds);
+
+            seconds = context.measure([&]() {
+                transformPoints(m, &points[0], &out[0], n);
+                keep(&out[0]);
+            });
+            report<T>(context, "transformPoints", "aos", n, aosBytes, seconds);
+
+            seconds = context.measure([&]() {
+                transformPoints(m, soa, soaOut);
+                keep(soaOut.x());
+            });
+            report<T>(context, "transformPoints", "soa", n, n * 3 * sizeof(T), seconds);
+
+            seconds = context.measure([&]() {
+                transformDirections(m, soa, soaOut);
+                keep(soaOut.x());
+            });
+            report<T>(context, "transformDirections", "soa", n, n * 3 * sizeof(T), seconds);
+
+            seconds = context.measure([&]() {
+                for(std::size_t i = 0; i < n; ++i) out[i] = q.rotate(points[i]);
+                keep(&out[0]);
+            });
+            report<T>(context, "Quaternion::rotate", "single", n, aosBytes, seconds);
+
+            const std::size_t quaternionBytes = n * sizeof(Quaternion<T>);
+            seconds = context.measure([&]() {
+                for(std::size_t i = 0; i < n; ++i) {
+                    interpolated[i] = Quaternion<T>::slerp(rotations[i], rotations[(i + 1) % n],
+                                                           (T)0.3);
+                }
+                keep(&interpolated[0]);
+            });
+            report<T>(context, "Quaternion::slerp", "single", n, quaternionBytes, seconds);
+
+            seconds = context.measure([&]() {
+                for(std::size_t i = 0; i < n; ++i) {
+                    interpolated[i] = Quaternion<T>::nlerp(rotations[i], rotations[(i + 1) % n],
+                                                           (T)0.3);
+                }
+                keep(&interpolated[0]);
+            });
+            report<T>(context, "Quaternion::nlerp", "single", n, quaternionBytes, seconds);
+        }
+    }
+
+} /* Anonymous namespace */
+
+
+
+PIKO_BENCHMARK(transform) {
+
+    runTransforms<float>(context);
+    runTransforms<double>(context);
+}
\ No newline at end of file
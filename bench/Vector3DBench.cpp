@@ -0,0 +1,269 @@
+/**
+ * @file        Vector3DBench.cpp
+ * @author      Robert Koch
+ * @version     1.0
+ *
+ * Benchmarks of every Vector3D operation for float, double and int. The single mode calls the
+ * operators of Vector3D one vector at a time over an array, the batch mode runs the Vector3DArray
+ * kernels. Both are measured at sizes from L1-resident to memory-resident arrays.
+ */
+#include "Benchmark.h"
+#include "../include/util/Vector3D.h"
+#include "../include/util/Vector3DArray.h"
+
+#include <random>
+#include <vector>
+
+
+namespace {
+
+    using namespace Piko;
+    using namespace Piko::bench;
+
+    /**
+     * Function to get a random coordinate. Integers stay small enough for products not to
+     * overflow.
+     *
+     * @param rng Random number generator.
+     * @return Coordinate.
+     */
+    template<typename T>
+    T randomValue(std::mt19937& rng) {
+        return T(std::uniform_real_distribution<double>(-1.0, 1.0)(rng));
+    }
+
+    template<>
+    int randomValue<int>(std::mt19937& rng) {
+        return std::uniform_int_distribution<int>(-1000, 1000)(rng);
+    }
+
+    /**
+     * Function to get a random vector.
+     *
+     * @param rng Random number generator.
+     * @return Vector.
+     */
+    template<typename T>
+    Vector3D<T> randomVector(std::mt19937& rng) {
+        const T x = randomValue<T>(rng);
+        const T y = randomValue<T>(rng);
+        const T z = randomValue<T>(rng);
+        return Vector3D<T>(x, y, z);
+    }
+
+    /**
+     * Function to get the scalar used by the scaling operations. It is read through a volatile
+     * so the compiler cannot fold it into the kernels.
+     *
+     * @return Scalar.
+     */
+    template<typename T>
+    T getScalar() {
+        static volatile double scalar = 1.5;
+        return T(scalar) != T(0) ? T(scalar) : T(1);
+    }
+
+    /**
+     * Function to time an operation applied to each vector of arrays of all sizes.
+     *
+     * @param context Benchmark context.
+     * @param name Name of the operation.
+     * @param kernel Function called with (a, b, out, scalars, s, n) which applies the operation
+     *               to the first n vectors.
+     */
+    template<typename T, typename F>
+    void runSingle(Context& context, const char* name, F kernel) {
+
+        const std::vector<std::size_t> sizes = getSizes(context.options());
+
+        for(std::size_t k = 0; k < sizes.size(); ++k) {
+            const std::size_t n = sizes[k];
+            std::mt19937 rng(42);
+
+            std::vector<Vector3D<T>> a(n), b(n), out(n);
+            std::vector<T> scalars(n);
+            for(std::size_t i = 0; i < n; ++i) {
+                a[i] = randomVector<T>(rng);
+                b[i] = randomVector<T>(rng);
+            }
+
+            const T s = getScalar<T>();
+            const double seconds = context.measure([&]() {
+                kernel(&a[0], &b[0], &out[0], &scalars[0], s, n);
+                keep(&out[0]);
+                keep(&scalars[0]);
+            });
+
+            context.report(std::string("Vector3D::") + name)
+                .param("type", typeName<T>())
+                .param("mode", "single")
+                .param("size", (double)n)
+                .param("bytes", (double)(n * sizeof(Vector3D<T>)))
+                .throughput(seconds, (double)n);
+        }
+    }
+
+    /**
+     * Function to time a batch kernel over arrays of all sizes.
+     *
+     * @param context Benchmark context.
+     * @param name Name of the kernel.
+     * @param kernel Function called with (a, b, out, scalars, s) which runs the kernel.
+     */
+    template<typename T, typename F>
+    void runBatch(Context& context, const char* name, F kernel) {
+
+        const std::vector<std::size_t> sizes = getSizes(context.options());
+
+        for(std::size_t k = 0; k < sizes.size(); ++k) {
+            const std::size_t n = sizes[k];
+            std::mt19937 rng(42);
+
+            Vector3DArray<T> a(n), b(n), out(n);
+            std::vector<T> scalars(n);
+            for(std::size_t i = 0; i < n; ++i) {
+                a.set(i, randomVector<T>(rng));
+                b.set(i, randomVector<T>(rng));
+            }
+
+            const T s = getScalar<T>();
+            const double seconds = context.measure([&]() {
+                kernel(a, b, out, &scalars[0], s);
+                keep(out.x());
+                keep(&scalars[0]);
+            });
+
+            context.report(name)
+                .param("type", typeName<T>())
+                .param("mode", "batch")
+                .param("size", (double)n)
+                .param("bytes", (double)(n * 3 * sizeof(T)))
+                .throughput(seconds, (double)n);
+        }
+    }
+
+    /**
+     * Function to time all single vector operations for a coordinate type.
+     *
+     * @param context Benchmark context.
+     */
+    template<typename T>
+    void runSingleOperations(Context& context) {
+
+        typedef Vector3D<T> V;
+
+        runSingle<T>(context, "operator+",
+                     [](const V* a, const V* b, V* out, T*, T, std::size_t n) {
+            for(std::size_t i = 0; i < n; ++i) out[i] = a[i] + b[i];
+        });
+        runSingle<T>(context, "operator-",
+                     [](const V* a, const V* b, V* out, T*, T, std::size_t n) {
+            for(std::size_t i = 0; i < n; ++i) out[i] = a[i] - b[i];
+        });
+        runSingle<T>(context, "operator*(Vector3D)",
+                     [](const V* a, const V* b, V*, T* r, T, std::size_t n) {
+            for(std::size_t i = 0; i < n; ++i) r[i] = a[i] * b[i];
+        });
+        runSingle<T>(context, "operator*(T)",
+                     [](const V* a, const V*, V* out, T*, T s, std::size_t n) {
+            for(std::size_t i = 0; i < n; ++i) out[i] = a[i] * s;
+        });
+        runSingle<T>(context, "operator/",
+                     [](const V* a, const V*, V* out, T*, T s, std::size_t n) {
+            for(std::size_t i = 0; i < n; ++i) out[i] = a[i] / s;
+        });
+        runSingle<T>(context, "operator^",
+                     [](const V* a, const V* b, V* out, T*, T, std::size_t n) {
+            for(std::size_t i = 0; i < n; ++i) out[i] = a[i] ^ b[i];
+        });
+
+        // Compound assignments work on a copy, repeated runs must not drift towards overflow.
+        runSingle<T>(context, "operator+=",
+                     [](const V* a, const V* b, V* out, T*, T, std::size_t n) {
+            for(std::size_t i = 0; i < n; ++i) { V t(b[i]); t += a[i]; out[i] = t; }
+        });
+        runSingle<T>(context, "operator-=",
+                     [](const V* a, const V* b, V* out, T*, T, std::size_t n) {
+            for(std::size_t i = 0; i < n; ++i) { V t(b[i]); t -= a[i]; out[i] = t; }
+        });
+        runSingle<T>(context, "operator*=",
+                     [](const V* a, const V*, V* out, T*, T s, std::size_t n) {
+            for(std::size_t i = 0; i < n; ++i) { V t(a[i]); t *= s; out[i] = t; }
+        });
+        runSingle<T>(context, "operator/=",
+                     [](const V* a, const V*, V* out, T*, T s, std::size_t n) {
+            for(std::size_t i = 0; i < n; ++i) { V t(a[i]); t /= s; out[i] = t; }
+        });
+        runSingle<T>(context, "operator^=",
+                     [](const V* a, const V* b, V* out, T*, T, std::size_t n) {
+            for(std::size_t i = 0; i < n; ++i) { V t(a[i]); t ^= b[i]; out[i] = t; }
+        });
+        runSingle<T>(context, "setPosition",
+                     [](const V* a, const V*, V* out, T*, T, std::size_t n) {
+            for(std::size_t i = 0; i < n; ++i) out[i].setPosition(a[i].z(), a[i].x(), a[i].y());
+        });
+        runSingle<T>(context, "normalize", [](const V* a, const V*, V* out, T*, T, std::size_t n) {
+            for(std::size_t i = 0; i < n; ++i) { V t(a[i]); t.normalize(); out[i] = t; }
+        });
+        runSingle<T>(context, "getNormalization",
+                     [](const V* a, const V*, V* out, T*, T, std::size_t n) {
+            for(std::size_t i = 0; i < n; ++i) out[i] = a[i].getNormalization();
+        });
+        runSingle<T>(context, "getMagnitude", [](const V* a, const V*, V*, T* r, T, std::size_t n) {
+            for(std::size_t i = 0; i < n; ++i) r[i] = a[i].getMagnitude();
+        });
+    }
+
+    /**
+     * Function to time all batch kernels for a coordinate type.
+     *
+     * @param context Benchmark context.
+     */
+    template<typename T>
+    void runBatchOperations(Context& context) {
+
+        typedef Vector3DArray<T> A;
+
+        runBatch<T>(context, "batchAdd", [](const A& a, const A& b, A& out, T*, T) {
+            batchAdd(a, b, out);
+        });
+        runBatch<T>(context, "batchSub", [](const A& a, const A& b, A& out, T*, T) {
+            batchSub(a, b, out);
+        });
+        runBatch<T>(context, "batchScale", [](const A& a, const A&, A& out, T*, T s) {
+            batchScale(a, s, out);
+        });
+        runBatch<T>(context, "batchDot", [](const A& a, const A& b, A&, T* r, T) {
+            batchDot(a, b, r);
+        });
+        runBatch<T>(context, "batchCross", [](const A& a, const A& b, A& out, T*, T) {
+            batchCross(a, b, out);
+        });
+        runBatch<T>(context, "batchMagnitude", [](const A& a, const A&, A&, T* r, T) {
+            batchMagnitude(a, r);
+        });
+        runBatch<T>(context, "batchNormalize", [](const A& a, const A&, A& out, T*, T) {
+            batchNormalize<ExactPrecision>(a, out);
+        });
+    }
+
+} /* Anonymous namespace */
+
+
+
+PIKO_BENCHMARK(vector3d_single) {
+
+    runSingleOperations<float>(context);
+    runSingleOperations<double>(context);
+    runSingleOperations<int>(context);
+}
+
+//-------------------------------------------------------------------------------------------------
+//-------------------------------------------------------------------------------------------------
+
+PIKO_BENCHMARK(vector3d_batch) {
+
+    runBatchOperations<float>(context);
+    runBatchOperations<double>(context);
+    runBatchOperations<int>(context);
+}
\ No newline at end of file
@@ -0,0 +1,219 @@
+/**
+ * @file        WindowBench.cpp
+ * @author      Robert Koch
+ * @version     1.0
+ *
+ * Throughput benchmarks of a WindowBase on the HeadlessWindowBackend: the dispatch of scripted
+ * messages through the message handler, the key handling and the fullscreen state machine. Run
+ * on any platform, since the headless backend needs no native window.
+ *
+ * The dispatch benchmark floods windows of the default backend with messages, on Windows through
+ * SendMessageA() and the window procedure. Every thread owns a window of its own, so the total
+ * rate over the threads shows if the instance lookup scales.
+ */
+#include "Benchmark.h"
+#include "../include/HeadlessWindowBackend.h"
+#include "../include/WindowBase.h"
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <vector>
+
+
+namespace {
+
+    using namespace Piko;
+    using namespace Piko::bench;
+
+    /** Number of input events taken per pollInput() call. */
+    const std::size_t INPUT_BATCH = 1024;
+
+    /**
+     * Function to create a window on a headless backend.
+     *
+     * @param backend Receives the backend owned by the window.
+     * @return Window.
+     */
+    std::unique_ptr<WindowBase> createWindow(HeadlessWindowBackend*& backend) {
+
+        backend = new HeadlessWindowBackend(1920, 1080);
+        return std::unique_ptr<WindowBase>(
+            new WindowBase(std::unique_ptr<WindowBackend>(backend), "Benchmark", 960, 540));
+    }
+
+    /**
+     * Function to time the dispatch of a sequence of messages by the event source.
+     *
+     * @param context Benchmark context.
+     * @param name Name of the measured operation.
+     * @param messages Messages dispatched by one call of processMessages().
+     */
+    void runDispatch(Context& context, const char* name,
+                     const std::vector<HeadlessMessage>& messages) {
+
+        HeadlessWindowBackend* backend;
+        std::unique_ptr<WindowBase> window = createWindow(backend);
+
+        // The recorded input is drained while dispatching, as the simulation would.
+        std::vector<InputEvent> events(INPUT_BATCH);
+        std::size_t next = 0;
+        backend->setEventSource([&](HeadlessMessage& msg) {
+            if(next == messages.size()) return false;
+            if(next % INPUT_BATCH == 0) window->pollInput(&events[0], INPUT_BATCH);
+            msg = messages[next++];
+            return true;
+        });
+
+        const double seconds = context.measure([&]() {
+            next = 0;
+            backend->processMessages();
+        });
+
+        context.report(name)
+            .param("backend", "headless")
+            .param("messages", (double)messages.size())
+            .throughput(seconds, (double)messages.size());
+    }
+
+    /**
+     * Function to create a window on the default backend of the platform and flood it with mouse
+     * messages. The window is created and warmed up first, the flood starts with the start flag.
+     *
+     * @param count Number of messages per round.
+     * @param rounds Number of rounds.
+     * @param ready Incremented once the window is ready.
+     * @param start Flag set to start the flood.
+     */
+    void floodWindow(std::size_t count, int rounds, std::atomic<std::size_t>& ready,
+                     const std::atomic<bool>& start) {
+
+        std::vector<InputEvent> events(INPUT_BATCH);
+
+#if defined(_WIN32)
+        WindowBase window("Benchmark", 320, 240);
+        const HWND hwnd = window.getHandle();
+
+        auto dispatchRound = [&]() {
+            for(std::size_t i = 0; i < count; ++i) {
+                if(i % INPUT_BATCH == 0) window.pollInput(&events[0], INPUT_BATCH);
+                SendMessageA(hwnd, WM_MOUSEMOVE, 0, (LPARAM)(i & 0xFF));
+            }
+        };
+#else
+        HeadlessWindowBackend* backend = new HeadlessWindowBackend();
+        WindowBase window(std::unique_ptr<WindowBackend>(backend), "Benchmark", 320, 240);
+
+        std::size_t next = 0;
+        backend->setEventSource([&](HeadlessMessage& msg) {
+            if(next == count) return false;
+            if(next % INPUT_BATCH == 0) window.pollInput(&events[0], INPUT_BATCH);
+            msg.msg = WM_MOUSEMOVE;
+            msg.wParam = 0;
+            msg.lParam = (LPARAM)(next++ & 0xFF);
+            return true;
+        });
+
+        auto dispatchRound = [&]() {
+            next = 0;
+            backend->processMessages();
+        };
+#endif
+
+        dispatchRound();
+        ready.fetch_add(1);
+        while(!start.load()) std::this_thread::yield();
+
+        for(int r = 0; r < rounds; ++r) dispatchRound();
+    }
+
+} /* Anonymous namespace */
+
+
+
+PIKO_BENCHMARK(window_headless) {
+
+    const std::size_t count = context.options().quick ? 4096 : 65536;
+
+    // Mixed traffic which is recorded as input but not consumed by the window.
+    std::vector<HeadlessMessage> mixed(count);
+    const UINT codes[] = { WM_MOUSEMOVE, WM_KEYDOWN, WM_KEYUP, WM_MOUSEMOVE, WM_LBUTTONDOWN,
+                           WM_MOUSEMOVE, WM_LBUTTONUP, WM_MOUSEWHEEL, WM_SIZE, WM_SETFOCUS };
+    const std::size_t codeCount = sizeof(codes) / sizeof(codes[0]);
+
+    for(std::size_t i = 0; i < count; ++i) {
+        const LPARAM position = (LPARAM)(((i * 7) % 1080) << 16 | ((i * 13) % 1920));
+        HeadlessMessage msg = { codes[i % codeCount], (WPARAM)('A' + i % 26), position };
+        mixed[i] = msg;
+    }
+
+    runDispatch(context, "WindowBase::messageHandler", mixed);
+
+    // Every message is F1, so each one runs the key handling and toggles fullscreen.
+    std::vector<HeadlessMessage> toggles(count);
+    for(std::size_t i = 0; i < count; ++i) {
+        HeadlessMessage msg = { WM_KEYDOWN, VK_F1, 0 };
+        toggles[i] = msg;
+    }
+
+    runDispatch(context, "WindowBase::onKeyDown(F1)", toggles);
+
+    // The state machine on its own, without the dispatch.
+    HeadlessWindowBackend* backend;
+    std::unique_ptr<WindowBase> window = createWindow(backend);
+
+    const double seconds = context.measure([&]() {
+        for(std::size_t i = 0; i < count; ++i) window->setFullscreen(i % 2 == 0);
+    });
+
+    context.report("WindowBase::setFullscreen")
+        .param("backend", "headless")
+        .param("messages", (double)count)
+        .throughput(seconds, (double)count);
+}
+//-------------------------------------------------------------------------------------------------
+//-------------------------------------------------------------------------------------------------
+
+PIKO_BENCHMARK(window_dispatch) {
+
+    const std::size_t count = context.options().quick ? 4096 : 65536;
+    const int rounds = context.options().quick ? 4 : 64;
+
+#if defined(_WIN32)
+    const char* backendName = "win32";
+#else
+    const char* backendName = "headless";
+#endif
+
+    // The rate is taken over the wall time of all threads, single threads are not timed on
+    // their own, since threads sharing a core would each count the whole core.
+    for(std::size_t threads = 1; threads <= context.options().workers; ++threads) {
+        std::vector<std::thread> pool;
+        std::atomic<std::size_t> ready(0);
+        std::atomic<bool> start(false);
+
+        for(std::size_t t = 0; t < threads; ++t) {
+            pool.push_back(std::thread(floodWindow, count, rounds, std::ref(ready),
+                                       std::cref(start)));
+        }
+
+        while(ready.load() < threads) std::this_thread::yield();
+
+        const std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+        start.store(true);
+        for(std::size_t t = 0; t < threads; ++t) pool[t].join();
+        const double seconds = std::chrono::duration<double>(
+            std::chrono::steady_clock::now() - begin).count();
+
+        const double messages = (double)(count * rounds * threads);
+
+        context.report("WindowBackend::dispatch")
+            .param("backend", backendName)
+            .param("workers", (double)threads)
+            .param("messages", messages)
+            .throughput(seconds, messages)
+            .metric("messages_per_second", messages / seconds);
+    }
+}
\ No newline at end of file
@@ -0,0 +1,178 @@
+/**
+ * @file        main.cpp
+ * @author      Robert Koch
+ * @version     1.0
+ *
+ * Entry point of piko_bench. Runs the registered benchmarks and writes their results as JSON,
+ * progress is printed to stderr.
+ *
+ * Usage: piko_bench [--list] [--quick] [--filter text] [--workers n] [--out file.json]
+ */
+#include "Benchmark.h"
+#include "../include/util/SIMD.h"
+
+#include <cstdlib>
+#include <ctime>
+#include <exception>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <thread>
+
+
+namespace {
+
+    using namespace Piko::bench;
+
+    /**
+     * Function to get the instruction set the math kernels were compiled for.
+     *
+     * @return Name of the instruction set.
+     */
+    const char* getInstructionSet() {
+#if defined(PIKO_SIMD_AVX)
+        return "avx";
+#elif defined(PIKO_SIMD_SSE)
+        return "sse";
+#else
+        return "scalar";
+#endif
+    }
+
+    /**
+     * Function to get the compiler the benchmarks were built with.
+     *
+     * @return Compiler name and version.
+     */
+    std::string getCompiler() {
+#if defined(__clang__)
+        return std::string("clang ") + __clang_version__;
+#elif defined(__GNUC__)
+        return std::string("gcc ") + __VERSION__;
+#elif defined(_MSC_VER)
+        return "msvc " + std::to_string(_MSC_VER);
+#else
+        return "unknown";
+#endif
+    }
+
+    /**
+     * Function to write the JSON document of a run.
+     *
+     * @param stream Stream to write to.
+     * @param context Context holding the results.
+     */
+    void writeJson(std::ostream& stream, const Context& context) {
+
+        char date[32] = "";
+        const std::time_t now = std::time(NULL);
+        std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%SZ", std::gmtime(&now));
+
+        stream << "{\n"
+               << "  \"suite\": \"piko_bench\",\n"
+               << "  \"version\": 1,\n"
+               << "  \"date\": \"" << date << "\",\n"
+               << "  \"compiler\": \"" << getCompiler() << "\",\n"
+#if defined(NDEBUG)
+               << "  \"build\": \"release\",\n"
+#else
+               << "  \"build\": \"debug\",\n"
+#endif
+               << "  \"simd\": \"" << getInstructionSet() << "\",\n"
+               << "  \"hardware_threads\": " << std::thread::hardware_concurrency() << ",\n"
+               << "  \"workers\": " << context.options().workers << ",\n"
+               << "  \"quick\": " << (context.options().quick ? "true" : "false") << ",\n"
+               << "  \"results\": [";
+
+        const std::vector<Result>& results = context.results();
+        for(std::size_t i = 0; i < results.size(); ++i) {
+            stream << (i ? ",\n    " : "\n    ");
+            results[i].write(stream);
+        }
+
+        stream << "\n  ]\n}\n";
+    }
+
+    /**
+     * Function to print the usage.
+     *
+     * @param program Name of the program.
+     */
+    void printUsage(const char* program) {
+        std::cerr << "Usage: " << program
+                  << " [--list] [--quick] [--filter text] [--workers n] [--out file.json]\n";
+    }
+
+} /* Anonymous namespace */
+
+
+
+int main(int argc, char** argv) {
+
+    Options options;
+    options.workers = std::thread::hardware_concurrency();
+    options.quick = false;
+    if(options.workers == 0) options.workers = 1;
+
+    bool list = false;
+
+    for(int i = 1; i < argc; ++i) {
+        const std::string arg(argv[i]);
+        const bool hasValue = i + 1 < argc;
+
+        if(arg == "--list") list = true;
+        else if(arg == "--quick") options.quick = true;
+        else if(arg == "--filter" && hasValue) options.filter = argv[++i];
+        else if(arg == "--out" && hasValue) options.output = argv[++i];
+        else if(arg == "--workers" && hasValue && std::atoi(argv[i + 1]) > 0) {
+            options.workers = (std::size_t)std::atoi(argv[++i]);
+        }
+        else {
+            printUsage(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    const std::vector<Benchmark> benchmarks = getBenchmarks();
+
+    if(list) {
+        for(std::size_t i = 0; i < benchmarks.size(); ++i) std::cout << benchmarks[i].name << "\n";
+        return EXIT_SUCCESS;
+    }
+
+    Context context(options);
+
+    try {
+        for(std::size_t i = 0; i < benchmarks.size(); ++i) {
+            if(std::string(benchmarks[i].name).find(options.filter) == std::string::npos) continue;
+
+            std::cerr << "[" << benchmarks[i].name << "]\n";
+
+            const std::size_t first = context.results().size();
+            benchmarks[i].function(context);
+
+            for(std::size_t r = first; r < context.results().size(); ++r) {
+                std::cerr << "  ";
+                context.results()[r].print(std::cerr);
+            }
+        }
+    }
+    catch(const std::exception& e) {
+        std::cerr << "Benchmark failed: " << e.what() << "\n";
+        return EXIT_FAILURE;
+    }
+
+    if(options.output.empty()) {
+        writeJson(std::cout, context);
+    }
+    else {
+        std::ofstream file(options.output.c_str());
+        writeJson(file, context);
+        if(!file) {
+            std::cerr << "Could not write " << options.output << "\n";
+            return EXIT_FAILURE;
+        }
+    }
+
+    return EXIT_SUCCESS;
+}
\ No newline at end of file
@@ -0,0 +1,180 @@
+/**
+ * @file        ApplicationLoop.h
+ * @author      Robert Koch
+ * @version     1.0
+ *
+ * Declaration of the main loop driving a window. Each frame drains all pending window messages
+ * without blocking, advances the simulation in fixed timesteps and renders once with the
+ * interpolation factor between the last two simulation states.
+ */
+#ifndef APPLICATIONLOOP_H
+#define APPLICATIONLOOP_H
+
+#include <chrono>
+#include <cstddef>
+#include <vector>
+
+#include "LinearArena.h"
+#include "WindowBase.h"
+
+
+namespace Piko {
+
+    /**
+     * CPU timings of the recent frames in milliseconds.
+     */
+    struct FrameStats {
+        std::size_t frameCount;     /**< Number of frames the timings are based on. */
+        double minMs;               /**< Shortest frame. */
+        double avgMs;               /**< Average frame. */
+        double p99Ms;               /**< 99th percentile frame. */
+        double maxMs;               /**< Longest frame. */
+        double lastMs;              /**< Most recent frame. */
+    };
+
+    /**
+     * Main loop with fixed timestep simulation and variable rate rendering. Override onUpdate()
+     * and onRender() for a custom behaviour.
+     */
+    class ApplicationLoop {
+
+        public:
+
+            /** Default simulation timestep in seconds. */
+            static const double DEFAULT_TIMESTEP;
+
+            /** Number of recent frames considered by getFrameStats(). */
+            static const std::size_t STATS_FRAMES = 1024;
+
+            /**
+             * Constructor to create a loop for the specified window.
+             *
+             * @param window Window whose messages are processed each frame.
+             * @param timestep Simulation timestep in seconds.
+             */
+            ApplicationLoop(WindowBase& window, double timestep = DEFAULT_TIMESTEP);
+
+            /**
+             * Destructor.
+             */
+            virtual ~ApplicationLoop();
+
+            /**
+             * Function to run frames until the window is closed or stop() is called.
+             */
+            void run();
+
+            /**
+             * Function to run a single frame.
+             *
+             * @return False if the loop should end, otherwise true.
+             */
+            bool step();
+
+            /**
+             * Function to end the loop after the current frame.
+             */
+            void stop();
+
+            /**
+             * Function to set the simulation timestep.
+             *
+             * @param timestep Timestep in seconds, must be positive.
+             */
+            void setTimestep(double timestep);
+
+            /**
+             * Function to get the simulation timestep.
+             *
+             * @return Timestep in seconds.
+             */
+            double getTimestep() const;
+
+            /**
+             * Function to limit the simulation steps per frame. If a frame takes longer, the
+             * remaining time is dropped so the simulation cannot fall further and further behind.
+             *
+             * @param count Maximum number of onUpdate() calls per frame.
+             */
+            void setMaxUpdatesPerFrame(int count);
+
+            /**
+             * Function to get the simulated time.
+             *
+             * @return Sum of all simulated timesteps in seconds.
+             */
+            double getSimulationTime() const;
+
+            /**
+             * Function to get the CPU timings of the recent frames.
+             *
+             * @return Timings of the last STATS_FRAMES frames at most, all zero before the first.
+             */
+            FrameStats getFrameStats() const;
+
+            /**
+             * Function to discard the recorded frame timings.
+             */
+            void resetFrameStats();
+
+            /**
+             * Function to get the arena for memory which is only needed during the current frame.
+             * The arena is reset at the end of each step().
+             *
+             * @return Frame arena.
+             */
+            LinearArena& getFrameArena();
+
+
+        protected:
+
+            /**
+             * Function to advance the simulation by one timestep.
+             *
+             * @param timestep Timestep in seconds.
+             */
+            virtual void onUpdate(double timestep);
+
+            /**
+             * Function to render a frame.
+             *
+             * @param alpha Interpolation factor in [0, 1) between the previous and the current
+             *              simulation state.
+             */
+            virtual void onRender(double alpha);
+
+
+        private:
+
+            typedef std::chrono::steady_clock Clock;
+
+            WindowBase& m_window;               /**< Window driven by the loop. */
+            double m_timestep;                  /**< Simulation timestep in seconds. */
+            int m_maxUpdates;                   /**< Maximum simulation steps per frame. */
+            double m_accumulator;               /**< Time not yet simulated. */
+            double m_simulationTime;            /**< Simulated time. */
+            bool m_isRunning;                   /**< Flag if the loop should continue. */
+            bool m_isStarted;                   /**< Flag if a frame was already run. */
+            Clock::time_point m_previous;       /**< Start of the previous frame. */
+
+            std::vector<double> m_frameTimes;   /**< Ring of recent frame times in ms. */
+            std::size_t m_frameIndex;           /**< Next position in the ring. */
+            std::size_t m_frameCount;           /**< Number of valid entries in the ring. */
+            LinearArena m_frameArena;           /**< Memory released at the end of a frame. */
+
+            /**
+             * Copy constructor is forbidden.
+             */
+            ApplicationLoop(const ApplicationLoop& loop);
+
+            /**
+             * Assignment operator is forbidden.
+             */
+            ApplicationLoop& operator=(const ApplicationLoop& loop);
+
+    }; /* Class ApplicationLoop */
+
+} /* Namespace Piko */
+
+
+#endif // End of APPLICATIONLOOP_H
@@ -0,0 +1,158 @@
+/**
+ * @file        BlockPool.h
+ * @author      Robert Koch
+ * @version     1.0
+ *
+ * Declaration of a pool allocator for blocks of a fixed size.
+ */
+#ifndef BLOCKPOOL_H
+#define BLOCKPOOL_H
+
+#include <cstddef>
+#include <vector>
+
+
+namespace Piko {
+
+    /**
+     * Allocator for blocks of one size, e.g. for nodes of lists, maps or scene graphs. Blocks are
+     * carved from chunks allocated in one piece and free blocks are linked through their own
+     * memory, so allocate() and deallocate() pop and push a free list without touching the heap.
+     * Chunks are only released when the pool is destroyed. Not thread safe.
+     */
+    class BlockPool final {
+
+        public:
+
+            /** Number of blocks per chunk if none is specified. */
+            static const std::size_t DEFAULT_CHUNK_BLOCKS = 256;
+
+            /**
+             * Constructor to create an empty pool. The first chunk is allocated on first use.
+             *
+             * @param blockSize Size of the blocks in bytes, at least the size of a pointer.
+             * @param alignment Alignment of the blocks, must be a power of two.
+             * @param chunkBlocks Number of blocks allocated at once.
+             *
+             * @throws std::invalid_argument If the alignment is not a power of two or
+             *                               chunkBlocks is zero.
+             */
+            explicit BlockPool(std::size_t blockSize, std::size_t alignment = sizeof(void*),
+                               std::size_t chunkBlocks = DEFAULT_CHUNK_BLOCKS);
+
+            /**
+             * Destructor to release all chunks. Blocks still allocated become invalid.
+             */
+            ~BlockPool();
+
+            /**
+             * Function to allocate a block.
+             *
+             * @return Uninitialized block of getBlockSize() bytes.
+             *
+             * @throws std::bad_alloc If a new chunk could not be allocated.
+             */
+            void* allocate();
+
+            /**
+             * Function to return a block to the pool.
+             *
+             * @param block Block allocated from this pool, NULL is ignored.
+             */
+            void deallocate(void* block);
+
+            /**
+             * Function to get the size of the blocks, rounded up to the alignment.
+             *
+             * @return Block size in bytes.
+             */
+            std::size_t getBlockSize() const;
+
+            /**
+             * Function to get the alignment of the blocks.
+             *
+             * @return Alignment in bytes.
+             */
+            std::size_t getAlignment() const;
+
+            /**
+             * Function to get the number of allocated blocks.
+             *
+             * @return Blocks not returned to the pool.
+             */
+            std::size_t getAllocatedCount() const;
+
+            /**
+             * Function to get the number of blocks in all chunks.
+             *
+             * @return Total number of blocks.
+             */
+            std::size_t getCapacity() const;
+
+
+        private:
+
+            /**
+             * Free block, linking to the next free block.
+             */
+            struct FreeBlock {
+                FreeBlock* next;            /**< Next free block, NULL at the end. */
+            };
+
+            std::size_t m_blockSize;        /**< Block size in bytes. */
+            std::size_t m_alignment;        /**< Block alignment in bytes. */
+            std::size_t m_chunkBlocks;      /**< Blocks per chunk. */
+            std::size_t m_allocated;        /**< Number of allocated blocks. */
+            FreeBlock* m_free;              /**< Head of the free list. */
+            std::vector<void*> m_chunks;    /**< Allocated chunks. */
+
+            /**
+             * Function to allocate a chunk and put its blocks on the free list.
+             */
+            void grow();
+
+            /**
+             * Forbid copy constructor.
+             */
+            BlockPool(const BlockPool& pool);
+
+            /**
+             * Forbid assignment operator.
+             */
+            BlockPool& operator=(const BlockPool& pool);
+
+    }; /* Class BlockPool */
+
+
+
+    /*==========================================
+     * INLINE IMPLEMENTATION
+     *=========================================*/
+
+    inline void* BlockPool::allocate() {
+
+        if(!m_free) grow();
+
+        FreeBlock* block = m_free;
+        m_free = block->next;
+        ++m_allocated;
+        return block;
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    inline void BlockPool::deallocate(void* block) {
+
+        if(!block) return;
+
+        FreeBlock* free = static_cast<FreeBlock*>(block);
+        free->next = m_free;
+        m_free = free;
+        --m_allocated;
+    }
+
+} /* Namespace Piko */
+
+
+#endif // End of BLOCKPOOL_H
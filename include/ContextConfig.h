@@ -0,0 +1,97 @@
+/**
+ * @file        ContextConfig.h
+ * @author      Robert Koch
+ * @version     1.0
+ *
+ * Declaration of the configuration requested from and granted by a GLContext.
+ */
+#ifndef CONTEXTCONFIG_H
+#define CONTEXTCONFIG_H
+
+#include "FramebufferFormat.h"
+
+
+namespace Piko {
+
+    /**
+     * OpenGL profile of a context.
+     */
+    enum class ContextProfile {
+        COMPATIBILITY,          /**< All functions including the deprecated ones. */
+        CORE                    /**< Deprecated functions removed, requires version 3.2+. */
+    };
+
+    /**
+     * Version, profile, flags, swap interval and framebuffer format of a rendering context. The
+     * default values request a legacy context like GLContext did before it was configurable, which
+     * the platforms create without any extension.
+     */
+    struct ContextConfig {
+
+        /** Swap interval synchronizing to the vertical blank only if the frame is on time. */
+        static const int ADAPTIVE_VSYNC = -1;
+
+        int majorVersion;           /**< Minimum major version, 1 for a legacy context. */
+        int minorVersion;           /**< Minimum minor version. */
+        ContextProfile profile;     /**< Requested profile. */
+        bool forwardCompatible;     /**< Flag to remove deprecated functionality. */
+        bool debug;                 /**< Flag to request a debug context. */
+        bool noError;               /**< Flag to request a context without error checking. */
+        int swapInterval;           /**< Vertical blanks per swap, ADAPTIVE_VSYNC or 0 for off. */
+        FramebufferFormat format;   /**< Framebuffer format. */
+
+        /**
+         * Constructor to set up a legacy context with the specified framebuffer format. Converts
+         * implicitly, so a format can be passed wherever a configuration is expected.
+         *
+         * @param format Framebuffer format.
+         */
+        ContextConfig(const FramebufferFormat& format = FramebufferFormat())
+          :
+          majorVersion(1),
+          minorVersion(0),
+          profile(ContextProfile::COMPATIBILITY),
+          forwardCompatible(false),
+          debug(false),
+          noError(false),
+          swapInterval(1),
+          format(format) {
+
+        }
+
+        /**
+         * Function to create a configuration for a core profile context.
+         *
+         * @param majorVersion Minimum major version.
+         * @param minorVersion Minimum minor version.
+         *
+         * @return Configuration with the default framebuffer format.
+         */
+        static ContextConfig core(int majorVersion, int minorVersion) {
+
+            ContextConfig config;
+            config.majorVersion = majorVersion;
+            config.minorVersion = minorVersion;
+            config.profile = ContextProfile::CORE;
+            return config;
+        }
+
+        /**
+         * Function to check if the configuration can be created without the context creation
+         * extensions.
+         *
+         * @return True for a compatibility context without version, flags or special formats.
+         */
+        bool isLegacy() const {
+
+            return majorVersion <= 1 && profile == ContextProfile::COMPATIBILITY
+                   && !forwardCompatible && !debug && !noError
+                   && format.samples == 0 && !format.sRGB;
+        }
+
+    }; /* Struct ContextConfig */
+
+} /* Namespace Piko */
+
+
+#endif // End of CONTEXTCONFIG_H
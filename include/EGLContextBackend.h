@@ -0,0 +1,123 @@
+/**
+ * @file        EGLContextBackend.h
+ * @author      Robert Koch
+ * @version     1.0
+ *
+ * Declaration of the rendering context backend built on top of EGL. It renders into pbuffers
+ * without any window system, e.g. with Mesa llvmpipe on servers without a GPU. Versioned, core
+ * profile, debug and no-error contexts require EGL_KHR_create_context or EGL 1.5.
+ */
+#ifndef EGLCONTEXTBACKEND_H
+#define EGLCONTEXTBACKEND_H
+
+#if !defined(_WIN32)
+
+#include <EGL/egl.h>
+#include <vector>
+
+#include "GLContextBackend.h"
+
+
+namespace Piko {
+
+    /**
+     * Rendering context backend creating desktop OpenGL contexts with EGL pbuffer surfaces. The
+     * display is taken from the Mesa surfaceless platform if available, so neither X11 nor
+     * Wayland is required.
+     */
+    class EGLContextBackend final : public GLContextBackend {
+
+        public:
+
+            /**
+             * Constructor.
+             */
+            EGLContextBackend();
+
+            /**
+             * Destructor to dispose the context. Same effect as dispose().
+             */
+            ~EGLContextBackend();
+
+            Result<> tryInit(HWND hWnd, const ContextConfig& config);
+            Result<> tryInitOffscreen(int width, int height, const ContextConfig& config);
+            std::unique_ptr<GLContextBackend> createShared() const;
+            void makeCurrent();
+            void doneCurrent();
+            void* getProcAddress(const char* name) const;
+            void dispose();
+            void setSwapInterval(int interval);
+            int getSwapInterval() const;
+            void swapBuffers();
+            const FramebufferFormat& getFramebufferFormat() const;
+            HDC getDeviceContext() const;
+
+
+        private:
+
+            EGLDisplay m_display;                   /**< Display connection. */
+            EGLSurface m_surface;                   /**< Pbuffer surface. */
+            EGLContext m_context;                   /**< Rendering context. */
+            EGLConfig m_config;                     /**< Config of surface and context. */
+            std::vector<EGLint> m_contextAttribs;   /**< Attributes of the context. */
+            int m_swapInterval;                     /**< Granted swap interval. */
+            FramebufferFormat m_format;             /**< Granted framebuffer format. */
+
+            /**
+             * Function to open and initialize the display connection.
+             *
+             * @return Error if no display is available.
+             */
+            Result<> initDisplay();
+
+            /**
+             * Function to release everything created by a failed initialization.
+             *
+             * @param error Reason of the failure.
+             *
+             * @return Failed result holding the error.
+             */
+            Result<> fail(const ErrorMessage& error);
+
+            /**
+             * Function to translate the version, profile and flags into context attributes.
+             *
+             * @param config Requested configuration.
+             */
+            void initContextAttribs(const ContextConfig& config);
+
+            /**
+             * Function to check if the display supports an extension.
+             *
+             * @param name Name of the extension.
+             *
+             * @return True if supported, otherwise false.
+             */
+            bool hasExtension(const char* name) const;
+
+            /**
+             * Function to choose the config best matching the requested format.
+             *
+             * @param format Requested framebuffer format.
+             *
+             * @return Chosen config or error if no config matches.
+             */
+            Result<EGLConfig> chooseConfig(const FramebufferFormat& format) const;
+
+            /**
+             * Forbid copy constructor.
+             */
+            EGLContextBackend(const EGLContextBackend& backend);
+
+            /**
+             * Forbid assignment operator.
+             */
+            EGLContextBackend& operator=(const EGLContextBackend& backend);
+
+    }; /* Class EGLContextBackend */
+
+} /* Namespace Piko */
+
+#endif // End of !_WIN32
+
+#endif // End of EGLCONTEXTBACKEND_H
@@ -2,40 +2,86 @@
  * @file        ErrorMessage.h
  * @author      Robert Koch
  * @version     1.0
- * 
- * Simple helper class to create a nice string of error messages with specified error codes. 
+ *
+ * Simple helper class to create a nice string of error messages with specified error codes.
  */
 #ifndef ERRORMESSAGE_H
 #define ERRORMESSAGE_H
 
-#include <windows.h>
-#include <iostream>
-#include <sstream>
+#include <cstdint>
+#include <iosfwd>
+#include <string>
 
 
 namespace Piko {
 
     /**
-     * Class to build a error message from a string and an error code as integer.
+     * Origin of the code of an error message.
+     */
+    enum class ErrorCategory : std::uint8_t {
+        USER,           /**< Engine defined code, 0 if there is none. */
+        SYSTEM,         /**< Return value of GetLastError(), errno on other platforms. */
+        GRAPHICS        /**< Error code of EGL or OpenGL. */
+    };
+
+    /**
+     * Class to describe an error by a static text, an error code and the origin of the code. The
+     * error is only captured on construction, which neither allocates nor formats anything, so
+     * it is cheap to create even if the error is handled silently. The text is built on demand.
      */
     class ErrorMessage final {
 
         public:
 
+            /**
+             * Constructor to create an empty error message.
+             */
+            ErrorMessage();
+
+            /**
+             * Constructor to create an error message from a specified error description and the
+             * return value of GetLastError() (errno on other platforms).
+             *
+             * @param msg Message to describe the error, has to be a string literal or to outlive
+             *            the error message otherwise.
+             */
+            explicit ErrorMessage(const char* msg);
+
             /**
              * Constructor to create an error message from a specified error description and an
-             * optional error code. If no error code was specified the return value of 
-             * GetLastError() will be used instead (symbolized by the code -987654321).
-             * 
-             * @param msg Message to describe the error.
-             * @param code User defined error code or return value of GetLastError() if no code was
-             *             specified.
+             * error code.
+             *
+             * @param msg Message to describe the error, has to be a string literal or to outlive
+             *            the error message otherwise.
+             * @param code Error code.
+             * @param category Origin of the error code, user defined by default.
+             */
+            ErrorMessage(const char* msg, int code, ErrorCategory category = ErrorCategory::USER);
+
+            /**
+             * Function to get the description of the error.
+             *
+             * @return Message passed on construction.
+             */
+            const char* getMessage() const;
+
+            /**
+             * Function to get the error code.
+             *
+             * @return Error code.
+             */
+            int getCode() const;
+
+            /**
+             * Function to get the origin of the error code.
+             *
+             * @return Error category.
              */
-            ErrorMessage(std::string msg, int code = -987654321);
+            ErrorCategory getCategory() const;
 
             /**
              * Function to get the build error message as a string.
-             * 
+             *
              * @return Error message and error code as a string.
              */
             std::string str() const;
@@ -43,15 +89,13 @@ namespace Piko {
             /**
              * Function to have nice output, if appended to a stream.
              */
-            friend std::ostream& operator<<(std::ostream& stream, const ErrorMessage& em) {
-                return stream << em.m_oss.str();
-            }
+            friend std::ostream& operator<<(std::ostream& stream, const ErrorMessage& em);
 
         private:
 
-            std::ostringstream m_oss;   /**< Stream used to build the error message. */
-            std::string m_msg;          /**< Text to describe the error. */
+            const char* m_msg;          /**< Text to describe the error. */
             int m_code;                 /**< Error code to print in conjunction with the text. */
+            ErrorCategory m_category;   /**< Origin of the error code. */
 
 
     }; /* Class ErrorMessage */
@@ -0,0 +1,63 @@
+/**
+ * @file        FramebufferFormat.h
+ * @author      Robert Koch
+ * @version     1.0
+ *
+ * Declaration of the framebuffer format requested from and granted by a GLContext.
+ */
+#ifndef FRAMEBUFFERFORMAT_H
+#define FRAMEBUFFERFORMAT_H
+
+
+namespace Piko {
+
+    /**
+     * Bit depths and buffer layout of a framebuffer. The default values match the format used by
+     * GLContext before formats were configurable: 24 bit colour, 16 bit depth, double buffered.
+     * When requesting a format, each value is a minimum the granted format may exceed.
+     */
+    struct FramebufferFormat {
+
+        int redBits;            /**< Bits of the red channel. */
+        int greenBits;          /**< Bits of the green channel. */
+        int blueBits;           /**< Bits of the blue channel. */
+        int alphaBits;          /**< Bits of the alpha channel. */
+        int depthBits;          /**< Bits of the depth buffer. */
+        int stencilBits;        /**< Bits of the stencil buffer. */
+        int samples;            /**< Samples per pixel, 0 disables multisampling. */
+        bool doubleBuffer;      /**< Flag if a back buffer is used. */
+        bool sRGB;              /**< Flag if writes are converted to sRGB. */
+
+        /**
+         * Constructor to set up the default format.
+         */
+        FramebufferFormat()
+          :
+          redBits(8),
+          greenBits(8),
+          blueBits(8),
+          alphaBits(0),
+          depthBits(16),
+          stencilBits(0),
+          samples(0),
+          doubleBuffer(true),
+          sRGB(false) {
+
+        }
+
+        /**
+         * Function to get the number of colour bits without alpha.
+         *
+         * @return Sum of the red, green and blue bits.
+         */
+        int getColorBits() const {
+
+            return redBits + greenBits + blueBits;
+        }
+
+    }; /* Struct FramebufferFormat */
+
+} /* Namespace Piko */
+
+
+#endif // End of FRAMEBUFFERFORMAT_H
@@ -0,0 +1,174 @@
+/**
+ * @file        FrustumCuller.h
+ * @author      Robert Koch
+ * @version     1.0
+ *
+ * Declaration of a store of bounding volumes which are culled against a view frustum in batches.
+ */
+#ifndef FRUSTUMCULLER_H
+#define FRUSTUMCULLER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "JobSystem.h"
+#include "Vector3DLayout.h"
+#include "util/AABB.h"
+#include "util/Frustum.h"
+#include "util/Vector3DArray.h"
+
+
+namespace Piko {
+
+    /**
+     * Bounding spheres and boxes of the objects of a scene, stored as structure of arrays so a
+     * culling pass tests a whole SIMD pack of volumes against each frustum plane at once. A pass
+     * writes the indices of the visible volumes in ascending order into a compact list, which is
+     * what the draw loop iterates. Spheres and boxes are numbered independently in the order they
+     * were added.
+     */
+    class FrustumCuller final {
+
+        public:
+
+            /** Number of volumes tested by one job of a parallel pass. */
+            static const std::size_t CHUNK_SIZE = 4096;
+
+            /**
+             * Standard constructor to create an empty culler.
+             */
+            FrustumCuller();
+
+            /**
+             * Function to add a bounding sphere.
+             *
+             * @param center Center of the sphere.
+             * @param radius Radius of the sphere.
+             * @return Index of the sphere.
+             */
+            std::size_t addSphere(const Vector3D<float>& center, float radius);
+
+            /**
+             * Function to move a bounding sphere.
+             *
+             * @param index Index of the sphere, must be smaller than getSphereCount().
+             * @param center New center of the sphere.
+             * @param radius New radius of the sphere.
+             */
+            void setSphere(std::size_t index, const Vector3D<float>& center, float radius);
+
+            /**
+             * Function to add a bounding box.
+             *
+             * @param box Box to add.
+             * @return Index of the box.
+             */
+            std::size_t addBox(const AABB<float>& box);
+
+            /**
+             * Function to move a bounding box.
+             *
+             * @param index Index of the box, must be smaller than getBoxCount().
+             * @param box New box.
+             */
+            void setBox(std::size_t index, const AABB<float>& box);
+
+            /**
+             * Function to remove all volumes.
+             */
+            void clear();
+
+            /**
+             * Functions to get the number of stored volumes.
+             *
+             * @return Number of spheres or boxes.
+             */
+            std::size_t getSphereCount() const;
+            std::size_t getBoxCount() const;
+
+            /**
+             * Function to cull all spheres on the calling thread.
+             *
+             * @param frustum Frustum to test against.
+             * @param visible Receives the indices of the visible spheres in ascending order.
+             * @return Number of visible spheres.
+             */
+            std::size_t cullSpheres(const Frustum<float>& frustum,
+                                    std::vector<std::uint32_t>& visible) const;
+
+            /**
+             * Function to cull all spheres in parallel. The result equals the one of the serial
+             * pass.
+             *
+             * @param jobs System running the jobs.
+             * @param frustum Frustum to test against.
+             * @param visible Receives the indices of the visible spheres in ascending order.
+             * @return Number of visible spheres.
+             */
+            std::size_t cullSpheres(JobSystem& jobs, const Frustum<float>& frustum,
+                                    std::vector<std::uint32_t>& visible) const;
+
+            /**
+             * Function to cull all boxes on the calling thread.
+             *
+             * @param frustum Frustum to test against.
+             * @param visible Receives the indices of the visible boxes in ascending order.
+             * @return Number of visible boxes.
+             */
+            std::size_t cullBoxes(const Frustum<float>& frustum,
+                                  std::vector<std::uint32_t>& visible) const;
+
+            /**
+             * Function to cull all boxes in parallel. The result equals the one of the serial
+             * pass.
+             *
+             * @param jobs System running the jobs.
+             * @param frustum Frustum to test against.
+             * @param visible Receives the indices of the visible boxes in ascending order.
+             * @return Number of visible boxes.
+             */
+            std::size_t cullBoxes(JobSystem& jobs, const Frustum<float>& frustum,
+                                  std::vector<std::uint32_t>& visible) const;
+
+        private:
+
+            Vector3DArray<float> m_sphereCenters;   /**< Centers of the spheres. */
+            std::vector<float> m_sphereRadii;       /**< Radii of the spheres. */
+            Vector3DArray<float> m_boxCenters;      /**< Centers of the boxes. */
+            Vector3DArray<float> m_boxExtents;      /**< Half extents of the boxes. */
+
+            /**
+             * Copy constructor is forbidden.
+             */
+            FrustumCuller(const FrustumCuller& culler);
+
+            /**
+             * Assignment operator is forbidden.
+             */
+            FrustumCuller& operator=(const FrustumCuller& culler);
+
+    }; /* Class FrustumCuller */
+
+
+
+    /*==========================================
+     * INLINE IMPLEMENTATION
+     *=========================================*/
+
+    inline std::size_t FrustumCuller::getSphereCount() const {
+
+        return m_sphereRadii.size();
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    inline std::size_t FrustumCuller::getBoxCount() const {
+
+        return m_boxCenters.size();
+    }
+
+} /* Namespace Piko */
+
+#endif // End of FRUSTUMCULLER_H
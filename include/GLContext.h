@@ -5,30 +5,59 @@
  *
  * Specification for for the wrapper class to create and maintain a device and rendering context 
  * for application using OpenGL. After creating an instance use init(HWND) to enable and dispose() 
- * to disable OpenGL for a specified window.
+ * to disable OpenGL for a specified window. Use initOffscreen() instead to render without any
+ * window, e.g. for batch rendering of images on servers.
  */
 #ifndef GLCONTEXT_H
 #define GLCONTEXT_H
 
-#include <windows.h>
-#include <gl/GL.h>
-#include <gl/GLU.h>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "ContextConfig.h"
+#include "GLContextBackend.h"
+#include "GLExtensions.h"
+#include "GPUTimer.h"
+#include "WindowTypes.h"
+#include "util/Result.h"
+
+#if defined(_WIN32)
+    #include <gl/GL.h>
+    #include <gl/GLU.h>
+#else
+    #include <GL/gl.h>
+    #include <GL/glu.h>
+#endif
 
 
 namespace Piko {
 
     /**
      * Wrapper class to create and maintain a device and rendering context for application using 
-     * OpenGL.
+     * OpenGL. The platform specific work is delegated to a GLContextBackend, by default WGL on
+     * Windows and EGL elsewhere.
      */
     class GLContext final {
     
         public:
+
+            /**
+             * Function called once per frame by renderFrames() with the frame index.
+             */
+            typedef std::function<void(int)> FrameCallback;
             
             /**
-             * Constructor to set up the contexts used.
+             * Constructor to set up the contexts used with the default backend of the platform.
              */
             GLContext();
+
+            /**
+             * Constructor to set up the contexts used with the specified backend.
+             *
+             * @param backend Platform backend creating the rendering context.
+             */
+            explicit GLContext(std::unique_ptr<GLContextBackend> backend);
     
             /**
              * Destructor to dispose the the contexts. Same effect as dispose().
@@ -39,27 +68,187 @@ namespace Piko {
              * Function to initialize the contexts in order to use OpenGL.
              * 
              * @param hWnd Handle to the window in which the rendering should be done.
+             * @param config Requested configuration, a framebuffer format converts implicitly.
              */
-            void init(HWND hWnd);
+            void init(HWND hWnd, const ContextConfig& config = ContextConfig());
 
             /**
-             * Function to dispose the contexts used by OpenGL.
+             * Function to initialize the contexts in order to use OpenGL without a window. The
+             * rendering is done into an offscreen drawable of the specified size.
+             *
+             * @param width Drawable width in pixels.
+             * @param height Drawable height in pixels.
+             * @param config Requested configuration, a framebuffer format converts implicitly.
+             */
+            void initOffscreen(int width, 
+                               int height, 
+                               const ContextConfig& config = ContextConfig());
+
+            /**
+             * Function to initialize the contexts for a window without throwing. On failure the
+             * context stays uninitialized, so another configuration can be tried right away.
+             *
+             * @param hWnd Handle to the window in which the rendering should be done.
+             * @param config Requested configuration, a framebuffer format converts implicitly.
+             *
+             * @return Error if the contexts could not be created.
+             */
+            Result<> tryInit(HWND hWnd, const ContextConfig& config = ContextConfig());
+
+            /**
+             * Function to initialize the contexts without a window and without throwing. On
+             * failure the context stays uninitialized, so another configuration can be tried
+             * right away.
+             *
+             * @param width Drawable width in pixels.
+             * @param height Drawable height in pixels.
+             * @param config Requested configuration, a framebuffer format converts implicitly.
+             *
+             * @return Error if the size is invalid or the contexts could not be created.
+             */
+            Result<> tryInitOffscreen(int width,
+                                      int height,
+                                      const ContextConfig& config = ContextConfig());
+
+            /**
+             * Function to dispose the contexts used by OpenGL. Shared contexts created from this
+             * context have to be disposed before.
              */
             void dispose();
 
+            /**
+             * Function to create a context sharing textures, buffers and other objects with this
+             * context, e.g. to upload resources on a background thread. The new context is not
+             * current on any thread.
+             *
+             * @return Shared context.
+             */
+            std::unique_ptr<GLContext> createSharedContext() const;
+
+            /**
+             * Function to make the context current on the calling thread.
+             */
+            void makeCurrent();
+
+            /**
+             * Function to release the context from the calling thread.
+             */
+            void doneCurrent();
+
+            /**
+             * Function to set the swap interval. Unsupported values are replaced by the closest
+             * supported one, see getGrantedConfig().
+             *
+             * @param interval Vertical blanks per swap, ContextConfig::ADAPTIVE_VSYNC or 0 for
+             *                 off.
+             */
+            void setSwapInterval(int interval);
+
+            /**
+             * Function to finish the current frame and present the back buffer. Starts a new
+             * frame of the GPU timer.
+             */
+            void swapBuffers();
+
+            /**
+             * Function to render frames back-to-back. For each frame the callback is invoked and
+             * the buffers are swapped afterwards. Read back results with readPixels() from within
+             * the callback.
+             *
+             * @param count Number of frames to render.
+             * @param frame Callback issuing the draw calls of a frame.
+             */
+            void renderFrames(int count, const FrameCallback& frame);
+
+            /**
+             * Function to read the content of the current draw buffer as tightly packed RGBA
+             * bytes, bottom row first.
+             *
+             * @param pixels Buffer resized to getWidth() * getHeight() * 4 bytes.
+             */
+            void readPixels(std::vector<unsigned char>& pixels) const;
+
+            /**
+             * Function to get the configuration granted by the platform. Version, profile and
+             * flags are queried from the context itself, so they may exceed the request.
+             *
+             * @return Granted configuration, only valid after initialization.
+             */
+            ContextConfig getGrantedConfig() const;
+
+            /**
+             * Function to get the framebuffer format granted by the platform.
+             *
+             * @return Granted format, only valid after initialization.
+             */
+            const FramebufferFormat& getFramebufferFormat() const;
+
+            /**
+             * Function to get the functions beyond OpenGL 1.1 provided by the context.
+             *
+             * @return Function table, only valid after initialization.
+             */
+            const GLExtensions& getExtensions() const;
+
+            /**
+             * Function to get the timer measuring the GPU time of render passes. Each call of
+             * swapBuffers() starts a new frame of the timer.
+             *
+             * @return GPU timer, unsupported if the context has no timer queries.
+             */
+            GPUTimer& getGPUTimer();
+
+            /**
+             * Function to get the width of the drawable.
+             *
+             * @return Width in pixels.
+             */
+            int getWidth() const;
+
+            /**
+             * Function to get the height of the drawable.
+             *
+             * @return Height in pixels.
+             */
+            int getHeight() const;
+
+            /**
+             * Function to check if the context renders without a window.
+             *
+             * @return True if initialized with initOffscreen(), otherwise false.
+             */
+            bool isOffscreen() const;
+
             /**
              * Function to get the device context used for rendering.
              * 
              * @return Device context.
              */
             HDC getDeviceContext() const;
+
+            /**
+             * Function to get the platform backend of the context.
+             *
+             * @return Backend creating the rendering context.
+             */
+            GLContextBackend& getBackend() const;
         
 
         private:
             
-            HWND m_hWnd;    /**< Window on which the rendering should occure. */
-            HDC m_hDC;      /**< Device context. */
-            HGLRC m_hRC;    /**< Rendering context. */
+            std::unique_ptr<GLContextBackend> m_backend;    /**< Platform backend. */
+            GLExtensions m_extensions;                      /**< Loaded functions. */
+            GPUTimer m_gpuTimer;                            /**< Timer of the render passes. */
+            ContextConfig m_granted;                        /**< Granted configuration. */
+            int m_width;                                    /**< Drawable width. */
+            int m_height;                                   /**< Drawable height. */
+            bool m_isOffscreen;                             /**< Flag if no window is used. */
+
+            /**
+             * Function to load the functions and query the granted configuration after the
+             * backend created the context.
+             */
+            void initCommon();
 
             /**
              * Forbid copy constructor.
@@ -0,0 +1,162 @@
+/**
+ * @file        GLContextBackend.h
+ * @author      Robert Koch
+ * @version     1.0
+ *
+ * Declaration of the platform interface a GLContext delegates the creation of rendering contexts
+ * and their drawables to.
+ */
+#ifndef GLCONTEXTBACKEND_H
+#define GLCONTEXTBACKEND_H
+
+#include <memory>
+
+#include "ContextConfig.h"
+#include "WindowTypes.h"
+#include "util/Result.h"
+
+
+namespace Piko {
+
+    /**
+     * Interface of a platform backend creating and maintaining the rendering context of a
+     * GLContext, either for a window or for an offscreen drawable.
+     */
+    class GLContextBackend {
+
+        public:
+
+            /**
+             * Function to create the backend used if no backend was specified: WGL on Windows,
+             * otherwise EGL.
+             *
+             * @return Default backend.
+             */
+            static std::unique_ptr<GLContextBackend> createDefault();
+
+            /**
+             * Destructor.
+             */
+            virtual ~GLContextBackend();
+
+            /**
+             * Function to create a rendering context for a window and make it current.
+             *
+             * @param hWnd Handle to the window in which the rendering should be done.
+             * @param config Requested configuration.
+             *
+             * @throws std::runtime_error If the context could not be created.
+             */
+            void init(HWND hWnd, const ContextConfig& config);
+
+            /**
+             * Function to create a rendering context with an offscreen drawable and make it
+             * current. No window is involved.
+             *
+             * @param width Drawable width in pixels.
+             * @param height Drawable height in pixels.
+             * @param config Requested configuration.
+             *
+             * @throws std::runtime_error If the context could not be created.
+             */
+            void initOffscreen(int width, int height, const ContextConfig& config);
+
+            /**
+             * Function to create a rendering context for a window and make it current without
+             * throwing. On failure everything created so far is released again, so the call can
+             * be repeated with another configuration.
+             *
+             * @param hWnd Handle to the window in which the rendering should be done.
+             * @param config Requested configuration.
+             *
+             * @return Error if the context could not be created.
+             */
+            virtual Result<> tryInit(HWND hWnd, const ContextConfig& config) = 0;
+
+            /**
+             * Function to create a rendering context with an offscreen drawable and make it
+             * current without throwing. On failure everything created so far is released again.
+             *
+             * @param width Drawable width in pixels.
+             * @param height Drawable height in pixels.
+             * @param config Requested configuration.
+             *
+             * @return Error if the context could not be created.
+             */
+            virtual Result<> tryInitOffscreen(int width, int height,
+                                              const ContextConfig& config) = 0;
+
+            /**
+             * Function to create a context sharing textures, buffers and other objects with the
+             * context of this backend. The new context is not current on any thread, use
+             * makeCurrent() on the thread which should use it.
+             *
+             * @return Backend holding the shared context.
+             */
+            virtual std::unique_ptr<GLContextBackend> createShared() const = 0;
+
+            /**
+             * Function to make the context current on the calling thread.
+             */
+            virtual void makeCurrent() = 0;
+
+            /**
+             * Function to release the context from the calling thread.
+             */
+            virtual void doneCurrent() = 0;
+
+            /**
+             * Function to get the address of a GL function.
+             *
+             * @param name Name of the function.
+             *
+             * @return Function address, NULL if not supported.
+             */
+            virtual void* getProcAddress(const char* name) const = 0;
+
+            /**
+             * Function to release the current context and destroy it together with its drawable.
+             * Does nothing if no context exists.
+             */
+            virtual void dispose() = 0;
+
+            /**
+             * Function to set the swap interval of the current context.
+             *
+             * @param interval Vertical blanks per swap, ContextConfig::ADAPTIVE_VSYNC or 0 for
+             *                 off. Unsupported values are replaced by the closest supported one.
+             */
+            virtual void setSwapInterval(int interval) = 0;
+
+            /**
+             * Function to get the swap interval actually set.
+             *
+             * @return Granted swap interval.
+             */
+            virtual int getSwapInterval() const = 0;
+
+            /**
+             * Function to present the back buffer of the drawable.
+             */
+            virtual void swapBuffers() = 0;
+
+            /**
+             * Function to get the framebuffer format actually granted by the platform.
+             *
+             * @return Granted format, only valid after initialization.
+             */
+            virtual const FramebufferFormat& getFramebufferFormat() const = 0;
+
+            /**
+             * Function to get the device context used for rendering.
+             *
+             * @return Device context, NULL if the backend does not use one.
+             */
+            virtual HDC getDeviceContext() const = 0;
+
+    }; /* Class GLContextBackend */
+
+} /* Namespace Piko */
+
+
+#endif // End of GLCONTEXTBACKEND_H
@@ -0,0 +1,157 @@
+/**
+ * @file        GLExtensions.h
+ * @author      Robert Koch
+ * @version     1.0
+ *
+ * Declaration of the OpenGL functions beyond version 1.1 used by the engine. They are not
+ * exported by the system libraries on every platform and have to be loaded from the context.
+ */
+#ifndef GLEXTENSIONS_H
+#define GLEXTENSIONS_H
+
+#include <cstddef>
+#include <cstdint>
+
+#if defined(_WIN32)
+    #include <windows.h>
+    #include <gl/GL.h>
+#else
+    #include <GL/gl.h>
+#endif
+
+#ifndef APIENTRY
+    #define APIENTRY
+#endif
+
+// Types and constants missing in headers limited to OpenGL 1.1:
+
+#ifndef GL_VERSION_1_5
+    typedef std::ptrdiff_t GLsizeiptr;
+    typedef std::ptrdiff_t GLintptr;
+
+    #define GL_ARRAY_BUFFER                 0x8892
+    #define GL_ELEMENT_ARRAY_BUFFER         0x8893
+    #define GL_STREAM_DRAW                  0x88E0
+    #define GL_STATIC_DRAW                  0x88E4
+    #define GL_DYNAMIC_DRAW                 0x88E8
+    #define GL_QUERY_RESULT                 0x8866
+    #define GL_QUERY_RESULT_AVAILABLE       0x8867
+#endif
+
+#ifndef GL_VERSION_3_0
+    #define GL_NUM_EXTENSIONS               0x821D
+    #define GL_CONTEXT_FLAGS                0x821E
+    #define GL_CONTEXT_FLAG_FORWARD_COMPATIBLE_BIT 0x0001
+    #define GL_FRAMEBUFFER_SRGB             0x8DB9
+    #define GL_MAP_WRITE_BIT                0x0002
+    #define GL_MAP_INVALIDATE_BUFFER_BIT    0x0008
+    #define GL_MAP_UNSYNCHRONIZED_BIT       0x0020
+    #define GL_MAJOR_VERSION                0x821B
+    #define GL_MINOR_VERSION                0x821C
+#endif
+
+#ifndef GL_VERSION_3_2
+    typedef struct __GLsync* GLsync;
+    typedef std::uint64_t GLuint64;
+    typedef std::int64_t GLint64;
+
+    #define GL_CONTEXT_PROFILE_MASK         0x9126
+    #define GL_CONTEXT_CORE_PROFILE_BIT     0x00000001
+    #define GL_SYNC_GPU_COMMANDS_COMPLETE   0x9117
+    #define GL_SYNC_FLUSH_COMMANDS_BIT      0x00000001
+    #define GL_ALREADY_SIGNALED             0x911A
+    #define GL_TIMEOUT_EXPIRED              0x911B
+    #define GL_CONDITION_SATISFIED          0x911C
+    #define GL_WAIT_FAILED                  0x911D
+    #define GL_TIMEOUT_IGNORED              0xFFFFFFFFFFFFFFFFull
+#endif
+
+#ifndef GL_VERSION_3_3
+    #define GL_TIMESTAMP                    0x8E28
+#endif
+
+#ifndef GL_CONTEXT_FLAG_DEBUG_BIT
+    #define GL_CONTEXT_FLAG_DEBUG_BIT       0x00000002
+#endif
+
+#ifndef GL_CONTEXT_FLAG_NO_ERROR_BIT
+    #define GL_CONTEXT_FLAG_NO_ERROR_BIT    0x00000008
+#endif
+
+
+namespace Piko {
+
+    class GLContextBackend;
+
+    /**
+     * Table of the loaded functions. A function pointer is NULL if the context does not provide
+     * it, the flags summarize which feature sets are complete.
+     */
+    struct GLExtensions {
+
+        int majorVersion;           /**< Major version of the context. */
+        int minorVersion;           /**< Minor version of the context. */
+
+        bool hasBufferObjects;      /**< Flag if all buffer object functions are available. */
+        bool hasMapBufferRange;     /**< Flag if buffers can be mapped (GL 3.0). */
+        bool hasSync;               /**< Flag if fence syncs are available (GL 3.2, ARB_sync). */
+        bool hasTimerQuery;         /**< Flag if timestamps can be queried (GL 3.3). */
+
+        // Indexed strings (GL 3.0):
+        const GLubyte* (APIENTRY *glGetStringi)(GLenum name, GLuint index);
+
+        // Buffer objects (GL 1.5):
+        void (APIENTRY *glGenBuffers)(GLsizei n, GLuint* buffers);
+        void (APIENTRY *glDeleteBuffers)(GLsizei n, const GLuint* buffers);
+        void (APIENTRY *glBindBuffer)(GLenum target, GLuint buffer);
+        void (APIENTRY *glBufferData)(GLenum target, GLsizeiptr size, const void* data,
+                                      GLenum usage);
+        void (APIENTRY *glBufferSubData)(GLenum target, GLintptr offset, GLsizeiptr size,
+                                         const void* data);
+
+        // Buffer mapping (GL 3.0):
+        void* (APIENTRY *glMapBufferRange)(GLenum target, GLintptr offset, GLsizeiptr length,
+                                           GLbitfield access);
+        GLboolean (APIENTRY *glUnmapBuffer)(GLenum target);
+
+        // Fence syncs (GL 3.2, ARB_sync):
+        GLsync (APIENTRY *glFenceSync)(GLenum condition, GLbitfield flags);
+        void (APIENTRY *glDeleteSync)(GLsync sync);
+        GLenum (APIENTRY *glClientWaitSync)(GLsync sync, GLbitfield flags, GLuint64 timeout);
+        void (APIENTRY *glWaitSync)(GLsync sync, GLbitfield flags, GLuint64 timeout);
+
+        // Query objects (GL 1.5) and timer queries (GL 3.3, ARB_timer_query):
+        void (APIENTRY *glGenQueries)(GLsizei n, GLuint* ids);
+        void (APIENTRY *glDeleteQueries)(GLsizei n, const GLuint* ids);
+        void (APIENTRY *glGetQueryObjectiv)(GLuint id, GLenum pname, GLint* params);
+        void (APIENTRY *glQueryCounter)(GLuint id, GLenum target);
+        void (APIENTRY *glGetQueryObjectui64v)(GLuint id, GLenum pname, GLuint64* params);
+
+        /**
+         * Constructor to set up an empty table.
+         */
+        GLExtensions();
+
+        /**
+         * Function to load the functions. The context of the backend has to be current.
+         *
+         * @param backend Backend of the current context.
+         */
+        void load(const GLContextBackend& backend);
+
+        /**
+         * Function to check if the current context supports an extension. Works for core
+         * profile contexts, where the extension string is not available.
+         *
+         * @param name Name of the extension, e.g. "GL_ARB_timer_query".
+         *
+         * @return True if supported, otherwise false.
+         */
+        bool hasExtension(const char* name) const;
+
+    }; /* Struct GLExtensions */
+
+} /* Namespace Piko */
+
+
+#endif // End of GLEXTENSIONS_H
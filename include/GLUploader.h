@@ -0,0 +1,169 @@
+/**
+ * @file        GLUploader.h
+ * @author      Robert Koch
+ * @version     1.0
+ *
+ * Declaration of a pool of worker threads uploading buffers and textures through contexts shared
+ * with the rendering context, so loading resources does not stall rendering.
+ */
+#ifndef GLUPLOADER_H
+#define GLUPLOADER_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "GLContext.h"
+
+
+namespace Piko {
+
+    /**
+     * Asynchronous resource uploader. Each worker thread owns a context shared with the rendering
+     * context. After an upload the worker inserts a fence; poll() hands an object to the rendering
+     * thread once its fence is signaled, which never blocks. Without fence syncs the workers
+     * finish each upload with glFinish() instead.
+     */
+    class GLUploader final {
+
+        public:
+
+            /**
+             * Function creating and filling a GL object on a worker thread.
+             *
+             * @return Name of the created object, 0 on failure.
+             */
+            typedef std::function<GLuint(const GLExtensions&)> UploadJob;
+
+            /**
+             * Function receiving the name of an uploaded object on the rendering thread. The name
+             * is 0 if the upload failed.
+             */
+            typedef std::function<void(GLuint)> ReadyCallback;
+
+            /**
+             * Constructor to create the workers and their shared contexts.
+             *
+             * @param context Rendering context, initialized.
+             * @param workerCount Number of worker threads.
+             */
+            GLUploader(GLContext& context, std::size_t workerCount = 1);
+
+            /**
+             * Destructor which finishes all queued uploads and ends the workers. Uploads not yet
+             * passed to poll() are discarded, the objects remain valid.
+             */
+            ~GLUploader();
+
+            /**
+             * Function to queue a custom upload.
+             *
+             * @param job Function creating the object.
+             * @param onReady Function receiving the object.
+             */
+            void upload(const UploadJob& job, const ReadyCallback& onReady);
+
+            /**
+             * Function to queue the upload of a buffer object.
+             *
+             * @param target Binding target, e.g. GL_ARRAY_BUFFER.
+             * @param data Buffer content.
+             * @param usage Usage hint, e.g. GL_STATIC_DRAW.
+             * @param onReady Function receiving the buffer.
+             */
+            void uploadBuffer(GLenum target, 
+                              std::vector<unsigned char> data, 
+                              GLenum usage,
+                              const ReadyCallback& onReady);
+
+            /**
+             * Function to queue the upload of a 2D texture without mipmaps.
+             *
+             * @param internalFormat Internal format, e.g. GL_RGBA8.
+             * @param width Texture width.
+             * @param height Texture height.
+             * @param format Pixel format of the data, e.g. GL_RGBA.
+             * @param type Component type of the data, e.g. GL_UNSIGNED_BYTE.
+             * @param pixels Tightly packed pixel rows, bottom row first.
+             * @param onReady Function receiving the texture.
+             */
+            void uploadTexture2D(GLint internalFormat,
+                                 GLsizei width,
+                                 GLsizei height,
+                                 GLenum format,
+                                 GLenum type,
+                                 std::vector<unsigned char> pixels,
+                                 const ReadyCallback& onReady);
+
+            /**
+             * Function to pass finished uploads to their callbacks. Call it regularly on the
+             * thread the rendering context is current on. Never blocks.
+             *
+             * @return Number of callbacks invoked.
+             */
+            std::size_t poll();
+
+            /**
+             * Function to get the number of uploads not yet passed to their callbacks.
+             *
+             * @return Number of pending uploads.
+             */
+            std::size_t getPendingCount() const;
+
+
+        private:
+
+            /** Queued upload. */
+            struct Job {
+                UploadJob upload;           /**< Creates the object. */
+                ReadyCallback onReady;      /**< Receives the object. */
+            };
+
+            /** Upload executed by a worker. */
+            struct Result {
+                GLuint name;                /**< Created object. */
+                GLsync fence;               /**< Fence behind the upload, NULL if finished. */
+                ReadyCallback onReady;      /**< Receives the object. */
+            };
+
+            GLContext& m_context;                           /**< Rendering context. */
+            std::vector<std::unique_ptr<GLContext>> m_workerContexts;   /**< Shared contexts. */
+            std::vector<std::thread> m_workers;             /**< Worker threads. */
+
+            mutable std::mutex m_mutex;                     /**< Guards the queues. */
+            std::condition_variable m_condition;            /**< Signals queued jobs. */
+            std::deque<Job> m_jobs;                         /**< Uploads not yet started. */
+            std::vector<Result> m_results;                  /**< Uploads done by workers. */
+            std::size_t m_pendingCount;                     /**< Uploads not yet passed on. */
+            bool m_isStopping;                              /**< Flag if the workers should end. */
+
+            std::vector<Result> m_waiting;                  /**< Uploads waiting for fences. */
+
+            /**
+             * Function running on a worker thread.
+             *
+             * @param context Shared context of the worker.
+             */
+            void work(GLContext* context);
+
+            /**
+             * Copy constructor is forbidden.
+             */
+            GLUploader(const GLUploader& uploader);
+
+            /**
+             * Assignment operator is forbidden.
+             */
+            GLUploader& operator=(const GLUploader& uploader);
+
+    }; /* Class GLUploader */
+
+} /* Namespace Piko */
+
+
+#endif // End of GLUPLOADER_H
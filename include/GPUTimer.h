@@ -0,0 +1,228 @@
+/**
+ * @file        GPUTimer.h
+ * @author      Robert Koch
+ * @version     1.0
+ *
+ * Declaration of a class to measure the GPU time of named render passes with timer queries.
+ */
+#ifndef GPUTIMER_H
+#define GPUTIMER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "GLExtensions.h"
+
+
+namespace Piko {
+
+    /**
+     * GPU time of a render pass.
+     */
+    struct GPUPassTiming {
+        const char* name;           /**< Name passed to beginPass(). */
+        int depth;                  /**< Number of enclosing passes. */
+        double ms;                  /**< GPU time in milliseconds. */
+    };
+
+    /**
+     * Timer recording a GPU timestamp at the beginning and the end of each pass. The queries of
+     * the last FRAME_LATENCY frames are kept in a ring and only read once the GPU reports them as
+     * available, so the results arrive a few frames late but never stall the pipeline. If the
+     * context has no timer queries (GL 3.3 or GL_ARB_timer_query) all functions do nothing and
+     * no results are reported.
+     */
+    class GPUTimer final {
+
+        public:
+
+            /** Number of frames whose queries may be in flight. */
+            static const std::size_t FRAME_LATENCY = 4;
+
+            /** Maximum number of passes per frame, further passes are ignored. */
+            static const std::size_t MAX_PASSES = 64;
+
+            /**
+             * Constructor to create an uninitialized timer.
+             */
+            GPUTimer();
+
+            /**
+             * Destructor. The queries have to be released with release() before, while the
+             * context is still current.
+             */
+            ~GPUTimer();
+
+            /**
+             * Function to create the query objects. The context has to be current.
+             *
+             * @param gl Functions of the current context.
+             */
+            void init(const GLExtensions& gl);
+
+            /**
+             * Function to delete the query objects. The context has to be current.
+             */
+            void release();
+
+            /**
+             * Function to check if the context supports timer queries.
+             *
+             * @return True if passes are measured, otherwise false.
+             */
+            bool isSupported() const;
+
+            /**
+             * Function to begin a pass. Passes may be nested.
+             *
+             * @param name Name of the pass, has to be a string literal.
+             */
+            void beginPass(const char* name);
+
+            /**
+             * Function to end the innermost open pass.
+             */
+            void endPass();
+
+            /**
+             * Function to finish the current frame and collect the results which became
+             * available. Called by GLContext::swapBuffers().
+             */
+            void nextFrame();
+
+            /**
+             * Function to get the pass timings of the most recent frame whose results are
+             * available, in the order the passes were begun.
+             *
+             * @return Pass timings, empty if no frame completed yet.
+             */
+            const std::vector<GPUPassTiming>& getResults() const;
+
+            /**
+             * Function to get the number of the frame the results belong to.
+             *
+             * @return Frame number as counted by getFrameNumber().
+             */
+            std::uint64_t getResultFrameNumber() const;
+
+            /**
+             * Function to get the number of the current frame.
+             *
+             * @return Number of nextFrame() calls since init().
+             */
+            std::uint64_t getFrameNumber() const;
+
+            /**
+             * Function to get the number of frames whose results were discarded because the GPU
+             * was more than FRAME_LATENCY frames behind.
+             *
+             * @return Number of discarded frames.
+             */
+            std::size_t getDroppedFrameCount() const;
+
+
+        private:
+
+            /**
+             * Pass recorded in a frame.
+             */
+            struct Pass {
+                const char* name;           /**< Name of the pass. */
+                int depth;                  /**< Number of enclosing passes. */
+                std::size_t begin;          /**< Index of the begin query. */
+                std::size_t end;            /**< Index of the end query, NO_QUERY if open. */
+            };
+
+            /**
+             * Queries and passes of one frame.
+             */
+            struct Frame {
+                std::vector<GLuint> queries;    /**< Query objects, two per pass. */
+                std::vector<Pass> passes;       /**< Recorded passes. */
+                std::size_t queryCount;         /**< Number of issued queries. */
+                std::uint64_t number;           /**< Frame number. */
+                bool isPending;                 /**< Flag if results are outstanding. */
+            };
+
+            /** Query index of a pass which was not ended. */
+            static const std::size_t NO_QUERY = ~(std::size_t)0;
+
+            const GLExtensions* m_gl;                   /**< Functions, NULL if unsupported. */
+            Frame m_frames[FRAME_LATENCY];              /**< Ring of recorded frames. */
+            std::size_t m_current;                      /**< Index of the recorded frame. */
+            std::vector<std::size_t> m_open;            /**< Open passes, NO_QUERY if ignored. */
+            std::vector<GPUPassTiming> m_results;       /**< Most recent results. */
+            std::uint64_t m_resultFrame;                /**< Frame of the results. */
+            std::uint64_t m_frameNumber;                /**< Number of the recorded frame. */
+            std::size_t m_droppedFrames;                /**< Frames discarded unread. */
+
+            /**
+             * Function to read the results of a frame if available.
+             *
+             * @param frame Pending frame.
+             *
+             * @return True if the results were read, otherwise false.
+             */
+            bool collect(Frame& frame);
+
+            /**
+             * Forbid copy constructor.
+             */
+            GPUTimer(const GPUTimer& timer);
+
+            /**
+             * Forbid assignment operator.
+             */
+            GPUTimer& operator=(const GPUTimer& timer);
+
+    }; /* Class GPUTimer */
+
+    /**
+     * Scope guard measuring a pass from its construction to its destruction.
+     */
+    class GPUPassScope final {
+
+        public:
+
+            /**
+             * Constructor to begin the pass.
+             *
+             * @param timer Timer measuring the pass.
+             * @param name Name of the pass, has to be a string literal.
+             */
+            GPUPassScope(GPUTimer& timer, const char* name)
+              :
+              m_timer(timer) {
+
+                m_timer.beginPass(name);
+            }
+
+            /**
+             * Destructor to end the pass.
+             */
+            ~GPUPassScope() {
+
+                m_timer.endPass();
+            }
+
+        private:
+
+            GPUTimer& m_timer;      /**< Timer measuring the pass. */
+
+            /**
+             * Forbid copy constructor.
+             */
+            GPUPassScope(const GPUPassScope& scope);
+
+            /**
+             * Forbid assignment operator.
+             */
+            GPUPassScope& operator=(const GPUPassScope& scope);
+
+    }; /* Class GPUPassScope */
+
+} /* Namespace Piko */
+
+
+#endif // End of GPUTIMER_H
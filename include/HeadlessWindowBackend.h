@@ -0,0 +1,127 @@
+/**
+ * @file        HeadlessWindowBackend.h
+ * @author      Robert Koch
+ * @version     1.0
+ *
+ * Declaration of an in-process window backend without any native window. Messages come from a
+ * scripted event source instead of the operating system, which allows to run the message
+ * dispatch, the key handling and the fullscreen state machine of a WindowBase in automated tests
+ * on any platform.
+ */
+#ifndef HEADLESSWINDOWBACKEND_H
+#define HEADLESSWINDOWBACKEND_H
+
+#include <deque>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "WindowBackend.h"
+
+
+namespace Piko {
+
+    /**
+     * Message as delivered by the headless backend.
+     */
+    struct HeadlessMessage {
+        UINT msg;           /**< Message code. */
+        WPARAM wParam;      /**< First message parameter. */
+        LPARAM lParam;      /**< Second message parameter. */
+    };
+
+    /**
+     * Window backend simulating a window on a virtual display.
+     */
+    class HeadlessWindowBackend final : public WindowBackend {
+
+        public:
+
+            /**
+             * Function producing scripted messages. Returns false if no message is available.
+             */
+            typedef std::function<bool(HeadlessMessage&)> EventSource;
+
+            /**
+             * Constructor to create a backend for a virtual display of the specified size.
+             *
+             * @param displayWidth Width of the virtual display.
+             * @param displayHeight Height of the virtual display.
+             */
+            HeadlessWindowBackend(int displayWidth = 1920, int displayHeight = 1080);
+
+            void create(WindowBase* window, const std::string& title, int width, int height);
+            void destroy();
+            void show();
+            void setTitle(const std::string& title);
+            void setFullscreen(bool flag, int width, int height);
+            int processMessages();
+            int getDisplayWidth() const;
+            int getDisplayHeight() const;
+            HWND getHandle() const;
+
+            /**
+             * Function to queue a message which will be dispatched by the next call of
+             * processMessages().
+             *
+             * @param msg Message code.
+             * @param wParam
+             * @param lParam
+             */
+            void postMessage(UINT msg, WPARAM wParam = 0, LPARAM lParam = 0);
+
+            /**
+             * Function to queue a sequence of messages.
+             *
+             * @param messages Messages to queue in order.
+             */
+            void postMessages(const std::vector<HeadlessMessage>& messages);
+
+            /**
+             * Function to set a source of scripted messages. processMessages() polls the source
+             * after the queued messages until it returns false.
+             *
+             * @param source Event source, or an empty function to remove the current one.
+             */
+            void setEventSource(EventSource source);
+
+            /**
+             * Function to get the number of queued messages.
+             *
+             * @return Number of messages waiting for dispatch.
+             */
+            std::size_t getPendingCount() const;
+
+            /**
+             * Functions to inspect the simulated window state.
+             */
+            const std::string& getTitle() const;
+            int getWindowWidth() const;
+            int getWindowHeight() const;
+            bool isVisible() const;
+            bool isFullscreen() const;
+            bool isDestroyed() const;
+
+
+        private:
+
+            WindowBase* m_window;               /**< Window receiving the messages. */
+            std::deque<HeadlessMessage> m_queue;/**< Messages waiting for dispatch. */
+            EventSource m_source;               /**< Optional source of scripted messages. */
+
+            std::string m_title;                /**< Window title. */
+            int m_displayWidth;                 /**< Width of the virtual display. */
+            int m_displayHeight;                /**< Height of the virtual display. */
+            int m_width;                        /**< Current window width. */
+            int m_height;                       /**< Current window height. */
+            bool m_isVisible;                   /**< Flag if show() was called. */
+            bool m_isFullscreen;                /**< Flag if the window is in fullscreen mode. */
+            bool m_isDestroyed;                 /**< Flag if the window was destroyed. */
+
+
+    }; /* Class HeadlessWindowBackend */
+
+} /* Namespace Piko */
+
+
+#endif // End of HEADLESSWINDOWBACKEND_H
@@ -0,0 +1,92 @@
+/**
+ * @file        InputEvent.h
+ * @author      Robert Koch
+ * @version     1.0
+ *
+ * Declaration of the compact input events a WindowBase records from its window messages.
+ */
+#ifndef INPUTEVENT_H
+#define INPUTEVENT_H
+
+#include <chrono>
+#include <cstdint>
+
+
+namespace Piko {
+
+    /**
+     * Kind of an input event.
+     */
+    enum class InputEventType : std::uint8_t {
+        KEY_DOWN,               /**< Key pressed, uses key. */
+        KEY_UP,                 /**< Key released, uses key. */
+        MOUSE_MOVE,             /**< Cursor moved, uses mouse.x and mouse.y. */
+        MOUSE_BUTTON_DOWN,      /**< Mouse button pressed, uses mouse. */
+        MOUSE_BUTTON_UP,        /**< Mouse button released, uses mouse. */
+        MOUSE_WHEEL,            /**< Wheel rotated, uses mouse.wheel. */
+        RESIZE,                 /**< Client area resized, uses resize. */
+        FOCUS_GAINED,           /**< Window received the keyboard focus. */
+        FOCUS_LOST              /**< Window lost the keyboard focus. */
+    };
+
+    /**
+     * Mouse buttons reported by button events.
+     */
+    enum class MouseButton : std::uint8_t {
+        NONE,
+        LEFT,
+        RIGHT,
+        MIDDLE
+    };
+
+    /**
+     * Input event with the time it was received. The payload depends on the type.
+     */
+    struct InputEvent {
+
+        /** Payload of key events. */
+        struct KeyData {
+            std::int32_t code;          /**< Virtual key code. */
+            std::int32_t repeat;        /**< 1 if generated by holding the key down. */
+        };
+
+        /** Payload of mouse events. */
+        struct MouseData {
+            std::int32_t x;             /**< Cursor x-coordinate in client area pixels. */
+            std::int32_t y;             /**< Cursor y-coordinate in client area pixels. */
+            std::int16_t wheel;         /**< Wheel rotation, 120 per notch. */
+            MouseButton button;         /**< Button of button events. */
+        };
+
+        /** Payload of resize events. */
+        struct ResizeData {
+            std::int32_t width;         /**< New client area width. */
+            std::int32_t height;        /**< New client area height. */
+        };
+
+        std::uint64_t timestamp;        /**< Receive time in ns, see now(). */
+        InputEventType type;            /**< Kind of event. */
+
+        union {
+            KeyData key;
+            MouseData mouse;
+            ResizeData resize;
+        };
+
+        /**
+         * Function to get the current time on the clock used for the timestamps.
+         *
+         * @return Nanoseconds of the steady clock.
+         */
+        static std::uint64_t now() {
+
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count();
+        }
+
+    }; /* Struct InputEvent */
+
+} /* Namespace Piko */
+
+
+#endif // End of INPUTEVENT_H
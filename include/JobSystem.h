@@ -0,0 +1,450 @@
+/**
+ * @file        JobSystem.h
+ * @author      Robert Koch
+ * @version     1.0
+ *
+ * Declaration of a work-stealing job system. Jobs are small functions over an index range which
+ * are spread over a pool of worker threads, completion is tracked with counters.
+ */
+#ifndef JOBSYSTEM_H
+#define JOBSYSTEM_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+namespace Piko {
+
+    /**
+     * Function executed by a job.
+     *
+     * @param data User data passed to JobSystem::run().
+     * @param begin First index of the range.
+     * @param end Index behind the range.
+     */
+    typedef void (*JobFunction)(void* data, std::size_t begin, std::size_t end);
+
+    /**
+     * Counter of unfinished jobs. Each job scheduled with the counter increments it and
+     * decrements it when done, so JobSystem::wait() on a counter waits for a whole group of jobs,
+     * and a job can depend on a counter to start only after a group finished. The first
+     * exception thrown by a job of the group is kept by the counter until it is waited for.
+     */
+    class JobCounter final {
+
+        public:
+
+            /**
+             * Constructor to create a counter without pending jobs.
+             */
+            JobCounter() : m_pending(0), m_hasError(false) { }
+
+            /**
+             * Function to check if all jobs of the counter finished.
+             *
+             * @return True if no job is pending, otherwise false.
+             */
+            bool isDone() const {
+
+                return m_pending.load(std::memory_order_acquire) == 0;
+            }
+
+            /**
+             * Function to get the number of unfinished jobs.
+             *
+             * @return Pending jobs.
+             */
+            std::size_t getPending() const {
+
+                return m_pending.load(std::memory_order_acquire);
+            }
+
+        private:
+
+            friend class JobSystem;
+
+            std::atomic<std::size_t> m_pending;     /**< Number of unfinished jobs. */
+
+            // Taken by JobSystem::wait(), which only gets a const reference to the counter.
+            mutable std::atomic<bool> m_hasError;   /**< Flag if a job stored m_error. */
+            mutable std::exception_ptr m_error;     /**< First exception of a job. */
+
+            /**
+             * Forbid copy constructor.
+             */
+            JobCounter(const JobCounter& counter);
+
+            /**
+             * Forbid assignment operator.
+             */
+            JobCounter& operator=(const JobCounter& counter);
+
+    }; /* Class JobCounter */
+
+    /**
+     * Pool of worker threads executing jobs. Every worker, and the thread which created the
+     * system, owns a WorkStealingDeque: jobs it schedules are pushed to its own deque and popped
+     * newest first, idle workers steal the oldest jobs of the others. Jobs scheduled by other
+     * threads go through a shared queue. The creating thread takes part in the work while it
+     * waits in wait(), so a system without workers runs everything on that thread.
+     *
+     * Jobs must not call GL functions, since they may run on any thread. GL work goes through
+     * runPinned() instead, which is only executed by the pinned thread, by default the creating
+     * one, when it calls wait() or executePinned(). Call pinThread() from the thread owning the
+     * GLContext if that is another one.
+     */
+    class JobSystem final {
+
+        public:
+
+            /** Maximum number of jobs queued per thread, further jobs are run inline. */
+            static const std::size_t MAX_QUEUED_JOBS = 4096;
+
+            /**
+             * Constructor to start the worker threads. The calling thread becomes the owner of
+             * the system and the pinned thread.
+             *
+             * @param workerCount Number of worker threads, may be zero.
+             */
+            explicit JobSystem(std::size_t workerCount = getDefaultWorkerCount());
+
+            /**
+             * Destructor to stop the worker threads. All jobs have to be waited for before.
+             */
+            ~JobSystem();
+
+            /**
+             * Function to schedule a job.
+             *
+             * @param function Function to execute.
+             * @param data User data passed to the function.
+             * @param begin First index passed to the function.
+             * @param end Index behind the range passed to the function.
+             * @param counter Counter incremented until the job finished.
+             * @param dependency Counter which has to be done before the job starts, or NULL.
+             */
+            void run(JobFunction function, void* data, std::size_t begin, std::size_t end,
+                     JobCounter& counter, const JobCounter* dependency = NULL);
+
+            /**
+             * Function to schedule a callable as a job. The callable is referenced, not copied,
+             * so it has to live until the counter is done.
+             *
+             * @param function Callable without arguments.
+             * @param counter Counter incremented until the job finished.
+             * @param dependency Counter which has to be done before the job starts, or NULL.
+             */
+            template<typename F>
+            void run(const F& function, JobCounter& counter,
+                     const JobCounter* dependency = NULL);
+
+            /**
+             * Function to schedule a job which only runs on the pinned thread, e.g. one calling
+             * GL functions.
+             *
+             * @param function Function to execute.
+             * @param data User data passed to the function.
+             * @param counter Counter incremented until the job finished.
+             */
+            void runPinned(JobFunction function, void* data, JobCounter& counter);
+
+            /**
+             * Function to schedule a callable which only runs on the pinned thread. The callable
+             * is referenced, not copied, so it has to live until the counter is done.
+             *
+             * @param function Callable without arguments.
+             * @param counter Counter incremented until the job finished.
+             */
+            template<typename F>
+            void runPinned(const F& function, JobCounter& counter);
+
+            /**
+             * Function to make the calling thread the one executing pinned jobs, e.g. the
+             * thread the GLContext is current on.
+             */
+            void pinThread();
+
+            /**
+             * Function to check if the calling thread is the pinned thread.
+             *
+             * @return True if the thread executes pinned jobs, otherwise false.
+             */
+            bool isPinnedThread() const;
+
+            /**
+             * Function to execute all queued pinned jobs. Pinned thread only.
+             *
+             * @return Number of executed jobs.
+             *
+             * @throws std::logic_error If called from another thread.
+             */
+            std::size_t executePinned();
+
+            /**
+             * Function to wait until all jobs of a counter finished. The calling thread executes
+             * jobs meanwhile, the pinned thread also pinned jobs.
+             *
+             * @param counter Counter to wait for.
+             *
+             * @throws Exception thrown by a job of the counter since the last wait() on it.
+             */
+            void wait(const JobCounter& counter);
+
+            /**
+             * Function to process an index range in parallel and wait for it. The range is split
+             * in halves until pieces are no larger than the grain size, the halves are scheduled
+             * as jobs so idle workers steal the largest pieces first.
+             *
+             * @param begin First index.
+             * @param end Index behind the range.
+             * @param grain Maximum number of indices per call of the body.
+             * @param body Callable taking a begin and an end index.
+             *
+             * @throws Exception thrown by the body.
+             */
+            template<typename F>
+            void parallelFor(std::size_t begin, std::size_t end, std::size_t grain,
+                             const F& body);
+
+            /**
+             * Function to run two callables and wait for both. The second one is scheduled as a
+             * job, the first one runs on the calling thread. Header-only code such as
+             * BVH::build() splits its work this way without depending on the library.
+             *
+             * @param first Callable without arguments, run on the calling thread.
+             * @param second Callable without arguments, run as a job.
+             *
+             * @throws Exception thrown by one of the callables.
+             */
+            template<typename A, typename B>
+            void fork(const A& first, const B& second);
+
+            /**
+             * Function to get the number of worker threads.
+             *
+             * @return Number of workers, not counting the owner thread.
+             */
+            std::size_t getWorkerCount() const;
+
+            /**
+             * Function to get the number of workers which keeps every core busy together with
+             * the owner thread.
+             *
+             * @return Number of hardware threads minus one.
+             */
+            static std::size_t getDefaultWorkerCount();
+
+
+        private:
+
+            /**
+             * Scheduled job.
+             */
+            struct Job {
+                JobFunction function;           /**< Function to execute. */
+                void* data;                     /**< User data. */
+                std::size_t begin;              /**< First index. */
+                std::size_t end;                /**< Index behind the range. */
+                JobCounter* counter;            /**< Counter finished by the job. */
+                const JobCounter* dependency;   /**< Counter to wait for, or NULL. */
+            };
+
+            struct Worker;
+
+            std::vector<std::unique_ptr<Worker>> m_workers; /**< Owner first, then workers. */
+            std::atomic<std::ptrdiff_t> m_queued;           /**< Jobs waiting to be taken. */
+            std::atomic<std::size_t> m_sleeping;            /**< Number of sleeping workers. */
+            std::atomic<bool> m_isStopping;                 /**< Flag if workers should end. */
+            std::mutex m_sleepMutex;                        /**< Guards sleeping workers. */
+            std::condition_variable m_wakeCondition;        /**< Wakes sleeping workers. */
+
+            std::mutex m_sharedMutex;                       /**< Guards m_shared. */
+            std::deque<Job> m_shared;                       /**< Jobs of foreign threads. */
+            std::atomic<std::size_t> m_sharedCount;         /**< Size of m_shared. */
+
+            std::mutex m_pinnedMutex;                       /**< Guards m_pinned. */
+            std::vector<Job> m_pinned;                      /**< Jobs for the pinned thread. */
+            std::atomic<std::size_t> m_pinnedCount;         /**< Size of m_pinned. */
+            std::atomic<std::thread::id> m_pinnedThread;    /**< Thread executing m_pinned. */
+
+            /**
+             * Function running on a worker thread.
+             *
+             * @param index Index of the worker.
+             */
+            void work(std::size_t index);
+
+            /**
+             * Function to take a job from the deque of the calling thread, the shared queue or
+             * another deque.
+             *
+             * @param job Receives the job.
+             *
+             * @return False if no job was found, otherwise true.
+             */
+            bool findJob(Job& job);
+
+            /**
+             * Function to execute jobs until a counter is done.
+             *
+             * @param counter Counter to wait for.
+             */
+            void helpUntil(const JobCounter& counter);
+
+            /**
+             * Function to execute a job and finish it on its counter.
+             *
+             * @param job Job to execute.
+             */
+            void execute(const Job& job);
+
+            /**
+             * Function to get the worker of the calling thread.
+             *
+             * @return Worker, NULL if the thread does not belong to the system.
+             */
+            Worker* getThreadWorker() const;
+
+            /**
+             * Function to wake a sleeping worker after a job was queued.
+             */
+            void wakeWorker();
+
+            /**
+             * Function to call a callable referenced by a job.
+             */
+            template<typename F>
+            static void invoke(void* data, std::size_t begin, std::size_t end);
+
+            /**
+             * Forbid copy constructor.
+             */
+            JobSystem(const JobSystem& system);
+
+            /**
+             * Forbid assignment operator.
+             */
+            JobSystem& operator=(const JobSystem& system);
+
+    }; /* Class JobSystem */
+
+
+
+    /*==========================================
+     * INLINE IMPLEMENTATION
+     *=========================================*/
+
+    namespace detail {
+
+        /**
+         * Shared state of a parallelFor() call.
+         */
+        template<typename F>
+        struct ParallelFor {
+
+            JobSystem* system;          /**< System running the jobs. */
+            const F* body;              /**< Body of the loop. */
+            std::size_t grain;          /**< Maximum indices per call of the body. */
+            JobCounter* counter;        /**< Counter of the split jobs. */
+
+            /**
+             * Function to split off halves of the range as jobs and process the rest.
+             */
+            static void execute(void* data, std::size_t begin, std::size_t end) {
+
+                ParallelFor<F>& loop = *static_cast<ParallelFor<F>*>(data);
+
+                while(end - begin > loop.grain) {
+                    const std::size_t middle = begin + (end - begin) / 2;
+                    loop.system->run(&execute, data, middle, end, *loop.counter);
+                    end = middle;
+                }
+
+                (*loop.body)(begin, end);
+            }
+        };
+
+    } /* Namespace detail */
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    template<typename F>
+    inline void JobSystem::run(const F& function, JobCounter& counter,
+                               const JobCounter* dependency) {
+
+        run(&invoke<F>, const_cast<F*>(&function), 0, 0, counter, dependency);
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    template<typename F>
+    inline void JobSystem::runPinned(const F& function, JobCounter& counter) {
+
+        runPinned(&invoke<F>, const_cast<F*>(&function), counter);
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    template<typename F>
+    inline void JobSystem::parallelFor(std::size_t begin, std::size_t end, std::size_t grain,
+                                       const F& body) {
+
+        if(begin >= end) return;
+
+        JobCounter counter;
+        detail::ParallelFor<F> loop = { this, &body, grain > 0 ? grain : 1, &counter };
+
+        // The whole range is a job as well, so an exception of the body is caught like any
+        // other and the jobs referencing the loop are always waited for.
+        run(&detail::ParallelFor<F>::execute, &loop, begin, end, counter);
+        wait(counter);
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    template<typename A, typename B>
+    inline void JobSystem::fork(const A& first, const B& second) {
+
+        JobCounter counter;
+        run(second, counter);
+
+        try {
+            first();
+        }
+        catch(...) {
+            // The job references the callable, so it has to finish before the stack unwinds.
+            try {
+                wait(counter);
+            }
+            catch(...) {
+            }
+            throw;
+        }
+
+        wait(counter);
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    template<typename F>
+    inline void JobSystem::invoke(void* data, std::size_t, std::size_t) {
+
+        (*static_cast<const F*>(data))();
+    }
+
+} /* Namespace Piko */
+
+
+#endif // End of JOBSYSTEM_H
@@ -0,0 +1,315 @@
+/**
+ * @file        LinearArena.h
+ * @author      Robert Koch
+ * @version     1.0
+ *
+ * Declaration of a bump allocator for memory which is released all at once, e.g. at the end of
+ * a frame, and of the thread local scratch arenas built on top of it.
+ */
+#ifndef LINEARARENA_H
+#define LINEARARENA_H
+
+#include <cstddef>
+#include <new>
+#include <utility>
+#include <vector>
+
+
+namespace Piko {
+
+    /**
+     * Allocator handing out memory by advancing an offset into a block. Single allocations are
+     * never released, reset() or rewind() release everything allocated after a point at once.
+     * If a block is exhausted a larger one is chained, and the next reset() merges all blocks
+     * into a single one, so in steady state every allocation is a pointer increment. Not thread
+     * safe.
+     */
+    class LinearArena final {
+
+        public:
+
+            /** Alignment of allocations if none is specified. */
+            static const std::size_t DEFAULT_ALIGNMENT = alignof(std::max_align_t);
+
+            /** Capacity of the first block if none is specified. */
+            static const std::size_t DEFAULT_CAPACITY = 1 << 20;
+
+            /**
+             * Position in the arena to rewind to.
+             */
+            struct Marker {
+                std::size_t block;          /**< Index of the current block. */
+                std::size_t offset;         /**< Offset into the current block. */
+                std::size_t used;           /**< Bytes used in total. */
+            };
+
+            /**
+             * Constructor to create an arena. The first block is allocated on first use.
+             *
+             * @param capacity Size of the first block in bytes.
+             */
+            explicit LinearArena(std::size_t capacity = DEFAULT_CAPACITY);
+
+            /**
+             * Destructor to release all blocks. Destructors of created objects are not called.
+             */
+            ~LinearArena();
+
+            /**
+             * Function to allocate uninitialized memory.
+             *
+             * @param bytes Number of bytes.
+             * @param alignment Alignment in bytes, must be a power of two.
+             *
+             * @return Pointer to the memory, valid until the arena is reset or rewound past it.
+             *
+             * @throws std::bad_alloc If a new block could not be allocated.
+             */
+            void* allocate(std::size_t bytes, std::size_t alignment = DEFAULT_ALIGNMENT);
+
+            /**
+             * Function to allocate an uninitialized array.
+             *
+             * @param count Number of elements.
+             *
+             * @return Pointer to the first element.
+             *
+             * @throws std::bad_alloc If the size overflows or a new block could not be allocated.
+             */
+            template<typename T>
+            T* allocateArray(std::size_t count);
+
+            /**
+             * Function to construct an object in the arena. The destructor is never called, so
+             * use it for trivially destructible types only.
+             *
+             * @param args Constructor arguments.
+             *
+             * @return Pointer to the object.
+             */
+            template<typename T, typename... Args>
+            T* create(Args&&... args);
+
+            /**
+             * Function to get the current position, to release later allocations with rewind().
+             *
+             * @return Current position.
+             */
+            Marker getMarker() const;
+
+            /**
+             * Function to release all memory allocated after a position.
+             *
+             * @param marker Position taken with getMarker() since the last reset().
+             */
+            void rewind(const Marker& marker);
+
+            /**
+             * Function to release all memory. Chained blocks are merged into a single block.
+             */
+            void reset();
+
+            /**
+             * Function to get the number of bytes allocated since the last reset, including
+             * alignment padding.
+             *
+             * @return Used bytes.
+             */
+            std::size_t getUsed() const;
+
+            /**
+             * Function to get the highest number of bytes used since the arena was created.
+             *
+             * @return Peak used bytes.
+             */
+            std::size_t getPeakUsed() const;
+
+            /**
+             * Function to get the size of all blocks.
+             *
+             * @return Reserved bytes.
+             */
+            std::size_t getCapacity() const;
+
+            /**
+             * Function to get the scratch arena of the calling thread. Use ScratchScope to
+             * release scratch memory again.
+             *
+             * @return Scratch arena of the thread.
+             */
+            static LinearArena& getThreadScratch();
+
+
+        private:
+
+            /**
+             * Memory block of the arena.
+             */
+            struct Block {
+                char* data;                 /**< Start of the block. */
+                std::size_t size;           /**< Size in bytes. */
+            };
+
+            std::vector<Block> m_blocks;    /**< Allocated blocks. */
+            std::size_t m_block;            /**< Index of the current block. */
+            std::size_t m_offset;           /**< Offset into the current block. */
+            std::size_t m_used;             /**< Bytes used since the last reset. */
+            std::size_t m_peak;             /**< Peak of m_used. */
+            std::size_t m_capacity;         /**< Size of the first block. */
+
+            /**
+             * Function to continue in the next block, which is allocated if necessary.
+             *
+             * @param bytes Minimum free bytes required in the block.
+             */
+            void nextBlock(std::size_t bytes);
+
+            /**
+             * Function to release all blocks.
+             */
+            void releaseBlocks();
+
+            /**
+             * Forbid copy constructor.
+             */
+            LinearArena(const LinearArena& arena);
+
+            /**
+             * Forbid assignment operator.
+             */
+            LinearArena& operator=(const LinearArena& arena);
+
+    }; /* Class LinearArena */
+
+    /**
+     * Scope guard handing out memory of the thread local scratch arena. Everything allocated
+     * through the scope is released when the scope ends. Scopes may be nested.
+     */
+    class ScratchScope final {
+
+        public:
+
+            /**
+             * Constructor to open a scope on the scratch arena of the calling thread.
+             */
+            ScratchScope();
+
+            /**
+             * Destructor to release the memory allocated in the scope.
+             */
+            ~ScratchScope();
+
+            /**
+             * Function to allocate uninitialized memory.
+             *
+             * @param bytes Number of bytes.
+             * @param alignment Alignment in bytes, must be a power of two.
+             *
+             * @return Pointer to the memory, valid until the scope ends.
+             */
+            void* allocate(std::size_t bytes,
+                           std::size_t alignment = LinearArena::DEFAULT_ALIGNMENT);
+
+            /**
+             * Function to allocate an uninitialized array.
+             *
+             * @param count Number of elements.
+             *
+             * @return Pointer to the first element.
+             *
+             * @throws std::bad_alloc If the size overflows or a new block could not be allocated.
+             */
+            template<typename T>
+            T* allocateArray(std::size_t count);
+
+            /**
+             * Function to get the arena of the scope, e.g. for an ArenaAllocator.
+             *
+             * @return Scratch arena of the thread.
+             */
+            LinearArena& getArena() const;
+
+        private:
+
+            LinearArena& m_arena;               /**< Scratch arena of the thread. */
+            LinearArena::Marker m_marker;       /**< Position at the start of the scope. */
+
+            /**
+             * Forbid copy constructor.
+             */
+            ScratchScope(const ScratchScope& scope);
+
+            /**
+             * Forbid assignment operator.
+             */
+            ScratchScope& operator=(const ScratchScope& scope);
+
+    }; /* Class ScratchScope */
+
+
+
+    /*==========================================
+     * INLINE IMPLEMENTATION
+     *=========================================*/
+
+    inline void* LinearArena::allocate(std::size_t bytes, std::size_t alignment) {
+
+        if(!m_blocks.empty()) {
+            const Block& block = m_blocks[m_block];
+            const std::size_t address = (std::size_t)(block.data + m_offset);
+            const std::size_t padding = (0 - address) & (alignment - 1);
+
+            if(m_offset + padding <= block.size && bytes <= block.size - m_offset - padding) {
+                m_offset += padding + bytes;
+                m_used += padding + bytes;
+                if(m_used > m_peak) m_peak = m_used;
+                return block.data + m_offset - bytes;
+            }
+        }
+
+        // Slow path, the next block always has enough room.
+        if(bytes > (std::size_t)-1 - alignment) throw std::bad_alloc();
+        nextBlock(bytes + alignment);
+        return allocate(bytes, alignment);
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    template<typename T>
+    inline T* LinearArena::allocateArray(std::size_t count) {
+
+        if(count > (std::size_t)-1 / sizeof(T)) throw std::bad_alloc();
+        return static_cast<T*>(allocate(count * sizeof(T), alignof(T)));
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    template<typename T, typename... Args>
+    inline T* LinearArena::create(Args&&... args) {
+
+        return new(allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    inline void* ScratchScope::allocate(std::size_t bytes, std::size_t alignment) {
+
+        return m_arena.allocate(bytes, alignment);
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    template<typename T>
+    inline T* ScratchScope::allocateArray(std::size_t count) {
+
+        return m_arena.allocateArray<T>(count);
+    }
+
+} /* Namespace Piko */
+
+
+#endif // End of LINEARARENA_H
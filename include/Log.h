@@ -0,0 +1,349 @@
+/**
+ * @file        Log.h
+ * @author      Robert Koch
+ * @version     1.0
+ *
+ * Declaration of the asynchronous logging subsystem. Logging threads only copy the format string
+ * pointer and the raw arguments into a lock-free buffer of their own, formatting and writing is
+ * done by a background thread. Use the PIKO_LOG_* macros, levels below PIKO_LOG_LEVEL are removed
+ * at compile time.
+ */
+#ifndef LOG_H
+#define LOG_H
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <type_traits>
+
+
+/**
+ * Lowest level compiled in: 0 trace, 1 debug, 2 info, 3 warning, 4 severe, 5 off. Defaults to
+ * debug in debug builds and to info in release builds.
+ */
+#ifndef PIKO_LOG_LEVEL
+    #ifdef NDEBUG
+        #define PIKO_LOG_LEVEL 2
+    #else
+        #define PIKO_LOG_LEVEL 1
+    #endif
+#endif
+
+/**
+ * Macro to log a message if the level passes the compile time and the run time threshold. The
+ * message is a string literal with a {} placeholder for each argument.
+ */
+#define PIKO_LOG(level, ...)                                                                    \
+    do {                                                                                        \
+        if(Piko::Log::isEnabled(level)) Piko::Log::write(level, __VA_ARGS__);                   \
+    } while(0)
+
+#if PIKO_LOG_LEVEL <= 0
+    #define PIKO_LOG_TRACE(...)     PIKO_LOG(Piko::LogLevel::TRACE, __VA_ARGS__)
+#else
+    #define PIKO_LOG_TRACE(...)     ((void)0)
+#endif
+
+#if PIKO_LOG_LEVEL <= 1
+    #define PIKO_LOG_DEBUG(...)     PIKO_LOG(Piko::LogLevel::DEBUG, __VA_ARGS__)
+#else
+    #define PIKO_LOG_DEBUG(...)     ((void)0)
+#endif
+
+#if PIKO_LOG_LEVEL <= 2
+    #define PIKO_LOG_INFO(...)      PIKO_LOG(Piko::LogLevel::INFO, __VA_ARGS__)
+#else
+    #define PIKO_LOG_INFO(...)      ((void)0)
+#endif
+
+#if PIKO_LOG_LEVEL <= 3
+    #define PIKO_LOG_WARNING(...)   PIKO_LOG(Piko::LogLevel::WARNING, __VA_ARGS__)
+#else
+    #define PIKO_LOG_WARNING(...)   ((void)0)
+#endif
+
+#if PIKO_LOG_LEVEL <= 4
+    #define PIKO_LOG_SEVERE(...)    PIKO_LOG(Piko::LogLevel::SEVERE, __VA_ARGS__)
+#else
+    #define PIKO_LOG_SEVERE(...)    ((void)0)
+#endif
+
+
+namespace Piko {
+
+    /**
+     * Severity of a log message. ERROR is avoided as name since windows.h defines it as macro.
+     */
+    enum class LogLevel : std::uint8_t {
+        TRACE,
+        DEBUG,
+        INFO,
+        WARNING,
+        SEVERE,
+        OFF
+    };
+
+    /**
+     * Log message as captured by the logging thread. Strings are copied into the record, all
+     * other arguments are stored by value.
+     */
+    struct LogRecord {
+
+        /** Maximum number of arguments of a message. */
+        static const std::size_t MAX_ARGUMENTS = 8;
+
+        /** Bytes available for copied string arguments, longer strings are truncated. */
+        static const std::size_t TEXT_CAPACITY = 96;
+
+        /** Type of a captured argument. */
+        enum Type : std::uint8_t {
+            SIGNED,
+            UNSIGNED,
+            FLOATING,
+            BOOLEAN,
+            CHARACTER,
+            POINTER,
+            STRING
+        };
+
+        /** Value of a captured argument. */
+        union Value {
+            std::int64_t i;
+            std::uint64_t u;
+            double d;
+            const void* p;
+            struct {
+                std::uint16_t offset;
+                std::uint16_t length;
+            } s;
+        };
+
+        std::uint64_t timestamp;            /**< Capture time in ns of the steady clock. */
+        const char* format;                 /**< Format string, must be a literal. */
+        std::uint32_t thread;               /**< Index of the logging thread. */
+        LogLevel level;                     /**< Severity. */
+        std::uint8_t count;                 /**< Number of arguments. */
+        std::uint8_t textSize;              /**< Used bytes of text. */
+        Type types[MAX_ARGUMENTS];          /**< Argument types. */
+        Value values[MAX_ARGUMENTS];        /**< Argument values. */
+        char text[TEXT_CAPACITY];           /**< Copied string arguments. */
+
+    }; /* Struct LogRecord */
+
+    /**
+     * Static interface of the logging subsystem. Each logging thread owns a lock-free buffer of
+     * BUFFER_CAPACITY records. If it is full the message is dropped and counted, a
+     * logging thread never blocks, allocates after its first message or flushes.
+     */
+    class Log final {
+
+        public:
+
+            /** Number of records buffered per thread. */
+            static const std::size_t BUFFER_CAPACITY = 1024;
+
+            /**
+             * Function to capture a message. Use the PIKO_LOG_* macros instead.
+             *
+             * @param level Severity.
+             * @param format String literal with a {} placeholder for each argument.
+             * @param args Arguments: integers, floating point values, bools, chars, pointers,
+             *             C strings, std::strings and enums.
+             */
+            template<typename... Args>
+            static void write(LogLevel level, const char* format, const Args&... args);
+
+            /**
+             * Function to set the run time threshold.
+             *
+             * @param level Lowest level written.
+             */
+            static void setLevel(LogLevel level);
+
+            /**
+             * Function to get the run time threshold.
+             *
+             * @return Lowest level written.
+             */
+            static LogLevel getLevel();
+
+            /**
+             * Function to check if messages of a level are written.
+             *
+             * @param level Severity.
+             *
+             * @return True if the level passes the compile time and the run time threshold.
+             */
+            static bool isEnabled(LogLevel level);
+
+            /**
+             * Function to set the stream written to, std::cout by default. Pending messages are
+             * written to the previous stream first.
+             *
+             * @param stream Output stream, has to stay valid until replaced.
+             */
+            static void setOutput(std::ostream& stream);
+
+            /**
+             * Function to wait until all messages captured before the call are written and the
+             * output stream is flushed.
+             */
+            static void flush();
+
+            /**
+             * Function to get the number of messages dropped because a buffer was full.
+             *
+             * @return Number of dropped messages.
+             */
+            static std::size_t getDroppedCount();
+
+
+        private:
+
+            /**
+             * Function to hand a captured record to the buffer of the calling thread.
+             *
+             * @param record Captured message.
+             */
+            static void submit(LogRecord& record);
+
+            /**
+             * Function to get the current time of the capture clock.
+             *
+             * @return Nanoseconds of the steady clock.
+             */
+            static std::uint64_t now();
+
+            /**
+             * Forbid constructor, the class is static.
+             */
+            Log();
+
+    }; /* Class Log */
+
+
+
+    namespace detail {
+
+        inline void captureString(LogRecord& record, std::size_t i, const char* value,
+                                  std::size_t length) {
+
+            const std::size_t available = LogRecord::TEXT_CAPACITY - record.textSize;
+            if(length > available) length = available;
+
+            for(std::size_t k = 0; k < length; ++k) record.text[record.textSize + k] = value[k];
+
+            record.types[i] = LogRecord::STRING;
+            record.values[i].s.offset = record.textSize;
+            record.values[i].s.length = (std::uint16_t)length;
+            record.textSize = (std::uint8_t)(record.textSize + length);
+        }
+
+        inline void captureArgument(LogRecord& record, std::size_t i, const char* value) {
+
+            if(!value) value = "(null)";
+
+            std::size_t length = 0;
+            while(value[length] && length < LogRecord::TEXT_CAPACITY) ++length;
+            captureString(record, i, value, length);
+        }
+
+        inline void captureArgument(LogRecord& record, std::size_t i, const std::string& value) {
+
+            captureString(record, i, value.data(), value.size());
+        }
+
+        inline void captureArgument(LogRecord& record, std::size_t i, bool value) {
+
+            record.types[i] = LogRecord::BOOLEAN;
+            record.values[i].u = value;
+        }
+
+        inline void captureArgument(LogRecord& record, std::size_t i, char value) {
+
+            record.types[i] = LogRecord::CHARACTER;
+            record.values[i].u = (unsigned char)value;
+        }
+
+        template<typename T>
+        inline typename std::enable_if<std::is_integral<T>::value &&
+                                       std::is_signed<T>::value>::type
+        captureArgument(LogRecord& record, std::size_t i, T value) {
+
+            record.types[i] = LogRecord::SIGNED;
+            record.values[i].i = value;
+        }
+
+        template<typename T>
+        inline typename std::enable_if<std::is_integral<T>::value &&
+                                       std::is_unsigned<T>::value>::type
+        captureArgument(LogRecord& record, std::size_t i, T value) {
+
+            record.types[i] = LogRecord::UNSIGNED;
+            record.values[i].u = value;
+        }
+
+        template<typename T>
+        inline typename std::enable_if<std::is_floating_point<T>::value>::type
+        captureArgument(LogRecord& record, std::size_t i, T value) {
+
+            record.types[i] = LogRecord::FLOATING;
+            record.values[i].d = value;
+        }
+
+        template<typename T>
+        inline typename std::enable_if<std::is_enum<T>::value>::type
+        captureArgument(LogRecord& record, std::size_t i, T value) {
+
+            record.types[i] = LogRecord::SIGNED;
+            record.values[i].i = (std::int64_t)value;
+        }
+
+        template<typename T>
+        inline void captureArgument(LogRecord& record, std::size_t i, const T* value) {
+
+            record.types[i] = LogRecord::POINTER;
+            record.values[i].p = value;
+        }
+
+        inline void captureArguments(LogRecord&, std::size_t) {
+
+        }
+
+        template<typename T, typename... Args>
+        inline void captureArguments(LogRecord& record, std::size_t i, const T& value,
+                                     const Args&... args) {
+
+            captureArgument(record, i, value);
+            captureArguments(record, i + 1, args...);
+        }
+
+    } /* Namespace detail */
+
+
+
+    /*==========================================
+     * INLINE IMPLEMENTATION
+     *=========================================*/
+
+    template<typename... Args>
+    inline void Log::write(LogLevel level, const char* format, const Args&... args) {
+
+        static_assert(sizeof...(Args) <= LogRecord::MAX_ARGUMENTS, "Too many log arguments.");
+
+        LogRecord record;
+        record.timestamp = now();
+        record.format = format;
+        record.level = level;
+        record.count = (std::uint8_t)sizeof...(Args);
+        record.textSize = 0;
+
+        detail::captureArguments(record, 0, args...);
+        submit(record);
+    }
+
+} /* Namespace Piko */
+
+
+#endif // End of LOG_H
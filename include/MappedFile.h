@@ -0,0 +1,102 @@
+/**
+ * @file        MappedFile.h
+ * @author      Robert Koch
+ * @version     1.0
+ *
+ * Declaration of a read-only memory mapping of a file.
+ */
+#ifndef MAPPEDFILE_H
+#define MAPPEDFILE_H
+
+#include <cstddef>
+#include <string>
+
+
+namespace Piko {
+
+    /**
+     * File mapped read-only into the address space. Pages are only read from disk when they are
+     * first touched and are shared with the page cache, so opening a file costs no copy and no
+     * allocation. The mapping starts at a page boundary.
+     */
+    class MappedFile final {
+
+        public:
+
+            /**
+             * Standard constructor to create a closed file.
+             */
+            MappedFile();
+
+            /**
+             * Constructor to map a file.
+             *
+             * @param path Path of the file.
+             *
+             * @throws std::runtime_error If the file could not be opened or mapped.
+             */
+            explicit MappedFile(const std::string& path);
+
+            /**
+             * Destructor which unmaps the file.
+             */
+            ~MappedFile();
+
+            /**
+             * Function to map a file. A previously mapped file is unmapped.
+             *
+             * @param path Path of the file.
+             *
+             * @throws std::runtime_error If the file could not be opened or mapped.
+             */
+            void open(const std::string& path);
+
+            /**
+             * Function to unmap the file. Pointers returned by data() become invalid.
+             */
+            void close();
+
+            /**
+             * Function to check if a file is mapped.
+             *
+             * @return True if open() succeeded and close() was not called since.
+             */
+            bool isOpen() const;
+
+            /**
+             * Function to get the contents.
+             *
+             * @return Pointer to the first byte, NULL if the file is closed or empty.
+             */
+            const unsigned char* data() const;
+
+            /**
+             * Function to get the size of the file.
+             *
+             * @return Size in bytes.
+             */
+            std::size_t size() const;
+
+
+        private:
+
+            const unsigned char* m_data;    /**< Start of the mapping. */
+            std::size_t m_size;             /**< Size of the file. */
+            bool m_isOpen;                  /**< Flag if a file is mapped. */
+
+            /**
+             * Copy constructor is forbidden.
+             */
+            MappedFile(const MappedFile& file);
+
+            /**
+             * Assignment operator is forbidden.
+             */
+            MappedFile& operator=(const MappedFile& file);
+
+    }; /* Class MappedFile */
+
+} /* Namespace Piko */
+
+
+#endif // End of MAPPEDFILE_H
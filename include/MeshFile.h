@@ -0,0 +1,235 @@
+/**
+ * @file        MeshFile.h
+ * @author      Robert Koch
+ * @version     1.0
+ *
+ * Declaration of the binary mesh container, which is memory-mapped on load and uploaded to GL
+ * buffers straight from the mapping.
+ */
+#ifndef MESHFILE_H
+#define MESHFILE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "GLExtensions.h"
+#include "MappedFile.h"
+#include "Vector3DLayout.h"
+#include "util/AABB.h"
+
+
+namespace Piko {
+
+    /** Magic bytes at the start of every mesh file. */
+    const char MESH_FILE_MAGIC[4] = { 'P', 'K', 'M', 'S' };
+
+    /** Version written by MeshFile::write(), files of other versions are rejected. */
+    const std::uint32_t MESH_FILE_VERSION = 1;
+
+    /** Alignment of the streams relative to the start of the file. */
+    const std::size_t MESH_FILE_ALIGNMENT = 64;
+
+    /**
+     * Vertex attributes, in the order they are interleaved. Positions and normals take three
+     * floats, texture coordinates two.
+     */
+    enum MeshAttribute {
+        MESH_POSITION = 1,
+        MESH_NORMAL = 2,
+        MESH_TEXCOORD = 4
+    };
+
+    /**
+     * Header at the start of a mesh file. All values are little-endian on the platforms the
+     * engine runs on, byteOrder detects files written with another byte order.
+     */
+    struct MeshFileHeader {
+        char magic[4];              /**< MESH_FILE_MAGIC. */
+        std::uint32_t version;      /**< MESH_FILE_VERSION. */
+        std::uint32_t byteOrder;    /**< 0x01020304 in the byte order of the writer. */
+        std::uint32_t attributes;   /**< Combination of MeshAttribute flags. */
+        std::uint32_t vertexStride; /**< Size of an interleaved vertex in bytes. */
+        std::uint32_t vertexCount;  /**< Number of vertices. */
+        std::uint32_t indexCount;   /**< Number of indices. */
+        std::uint32_t indexSize;    /**< Size of an index, 2 or 4 bytes. */
+        std::uint64_t vertexOffset; /**< Offset of the vertex stream, aligned. */
+        std::uint64_t indexOffset;  /**< Offset of the index stream, aligned. */
+        float boundsMin[3];         /**< Minimum corner of the positions. */
+        float boundsMax[3];         /**< Maximum corner of the positions. */
+    };
+
+    static_assert(sizeof(MeshFileHeader) == 72, "Mesh file header must not contain padding.");
+
+    /**
+     * Mesh in memory, input of MeshFile::write(). Normals and texture coordinates are optional,
+     * if present there is one per position.
+     */
+    struct MeshData {
+        std::vector<Vector3D<float> > positions;    /**< Vertex positions. */
+        std::vector<Vector3D<float> > normals;      /**< Vertex normals, or empty. */
+        std::vector<float> texcoords;               /**< Two floats per vertex, or empty. */
+        std::vector<std::uint32_t> indices;         /**< Triangle list. */
+    };
+
+    /**
+     * Mesh file opened by mapping it into memory. Opening only validates the header, the
+     * vertices and indices are read from the mapping in the layout GL consumes, so loading costs
+     * no parsing and no copy before the driver's own. Files are produced offline by write(),
+     * e.g. through the MeshConverter tool.
+     */
+    class MeshFile final {
+
+        public:
+
+            /**
+             * Standard constructor to create a closed mesh file.
+             */
+            MeshFile();
+
+            /**
+             * Constructor to open a mesh file.
+             *
+             * @param path Path of the file.
+             *
+             * @throws std::runtime_error If the file could not be mapped or is no valid mesh
+             *                            file of this version.
+             */
+            explicit MeshFile(const std::string& path);
+
+            /**
+             * Function to open a mesh file. A previously opened file is closed.
+             *
+             * @param path Path of the file.
+             *
+             * @throws std::runtime_error If the file could not be mapped or is no valid mesh
+             *                            file of this version.
+             */
+            void open(const std::string& path);
+
+            /**
+             * Function to close the file. Pointers to the streams become invalid.
+             */
+            void close();
+
+            /**
+             * Function to check if a file is open.
+             *
+             * @return True if a file is open.
+             */
+            bool isOpen() const;
+
+            /**
+             * Function to get the header.
+             *
+             * @return Header of the open file.
+             */
+            const MeshFileHeader& getHeader() const;
+
+            /**
+             * Function to check if the vertices have an attribute.
+             *
+             * @param attribute Attribute to check.
+             * @return True if the attribute is stored.
+             */
+            bool hasAttribute(MeshAttribute attribute) const;
+
+            /**
+             * Function to get the offset of an attribute inside a vertex, e.g. for
+             * glVertexAttribPointer().
+             *
+             * @param attribute Stored attribute.
+             * @return Offset in bytes.
+             */
+            std::size_t getAttributeOffset(MeshAttribute attribute) const;
+
+            /**
+             * Functions to get the vertex stream.
+             *
+             * @return Interleaved vertices, number of vertices or size of a vertex in bytes.
+             */
+            const void* getVertexData() const;
+            std::size_t getVertexCount() const;
+            std::size_t getVertexStride() const;
+
+            /**
+             * Functions to get the index stream.
+             *
+             * @return Indices, number of indices or size of an index in bytes.
+             */
+            const void* getIndexData() const;
+            std::size_t getIndexCount() const;
+            std::size_t getIndexSize() const;
+
+            /**
+             * Function to get the GL type of the indices, e.g. for glDrawElements().
+             *
+             * @return GL_UNSIGNED_SHORT or GL_UNSIGNED_INT.
+             */
+            GLenum getIndexType() const;
+
+            /**
+             * Function to get the bounds of the positions.
+             *
+             * @return Bounding box, empty if there are no vertices.
+             */
+            AABB<float> getBounds() const;
+
+            /**
+             * Function to create a vertex and an index buffer from the mapped streams. The
+             * context has to be current. Buffers of empty streams are not created and set to 0.
+             *
+             * @param gl Functions of the current context.
+             * @param vertexBuffer Receives the vertex buffer, to bind to GL_ARRAY_BUFFER.
+             * @param indexBuffer Receives the index buffer, to bind to GL_ELEMENT_ARRAY_BUFFER.
+             * @param usage Usage hint of the buffers.
+             *
+             * @throws std::runtime_error If the context has no buffer objects.
+             */
+            void upload(const GLExtensions& gl, GLuint& vertexBuffer, GLuint& indexBuffer,
+                        GLenum usage = GL_STATIC_DRAW) const;
+
+            /**
+             * Function to write a mesh file. Indices are stored with 16 bits if all vertices can
+             * be addressed with them.
+             *
+             * @param path Path of the file.
+             * @param mesh Mesh to write.
+             *
+             * @throws std::invalid_argument If the optional streams do not match the number of
+             *                               positions or an index is out of range.
+             * @throws std::runtime_error If the file could not be written.
+             */
+            static void write(const std::string& path, const MeshData& mesh);
+
+
+        private:
+
+            MappedFile m_file;                  /**< Mapped file. */
+            MeshFileHeader m_header;            /**< Validated copy of the header. */
+
+            /**
+             * Function to get the size of an interleaved vertex.
+             *
+             * @param attributes Combination of MeshAttribute flags.
+             * @return Size in bytes.
+             */
+            static std::size_t getStride(std::uint32_t attributes);
+
+            /**
+             * Copy constructor is forbidden.
+             */
+            MeshFile(const MeshFile& file);
+
+            /**
+             * Assignment operator is forbidden.
+             */
+            MeshFile& operator=(const MeshFile& file);
+
+    }; /* Class MeshFile */
+
+} /* Namespace Piko */
+
+
+#endif // End of MESHFILE_H
@@ -0,0 +1,289 @@
+/**
+ * @file        ParallelBatch.h
+ * @author      Robert Koch
+ * @version     1.0
+ *
+ * Variants of the Vector3DArray batch kernels which split the arrays into ranges processed in
+ * parallel by a JobSystem.
+ */
+#ifndef PARALLELBATCH_H
+#define PARALLELBATCH_H
+
+#include <cstddef>
+#include <stdexcept>
+
+#include "JobSystem.h"
+#include "Profiler.h"
+#include "util/Vector3DArray.h"
+
+
+namespace Piko {
+
+    /** Default number of vectors per job, large enough to hide the scheduling cost. */
+    const std::size_t PARALLEL_BATCH_GRAIN = 8192;
+
+    /**
+     * Function to add two arrays element-wise in parallel, see batchAdd().
+     *
+     * @param jobs System running the jobs.
+     * @param a First summand.
+     * @param b Second summand, must have the same size as a.
+     * @param out Sum of the vectors, resized to the size of a.
+     * @param grain Maximum number of vectors per job.
+     */
+    template<typename T>
+    void parallelBatchAdd(JobSystem& jobs, const Vector3DArray<T>& a, const Vector3DArray<T>& b,
+                          Vector3DArray<T>& out, std::size_t grain = PARALLEL_BATCH_GRAIN);
+
+    /**
+     * Function to subtract two arrays element-wise in parallel, see batchSub().
+     *
+     * @param jobs System running the jobs.
+     * @param a Minuend.
+     * @param b Subtrahend, must have the same size as a.
+     * @param out Difference of the vectors, resized to the size of a.
+     * @param grain Maximum number of vectors per job.
+     */
+    template<typename T>
+    void parallelBatchSub(JobSystem& jobs, const Vector3DArray<T>& a, const Vector3DArray<T>& b,
+                          Vector3DArray<T>& out, std::size_t grain = PARALLEL_BATCH_GRAIN);
+
+    /**
+     * Function to multiply all vectors of an array with a scalar in parallel, see batchScale().
+     *
+     * @param jobs System running the jobs.
+     * @param a Vectors to scale.
+     * @param s Scalar to multiply with.
+     * @param out Scaled vectors, resized to the size of a.
+     * @param grain Maximum number of vectors per job.
+     */
+    template<typename T>
+    void parallelBatchScale(JobSystem& jobs, const Vector3DArray<T>& a, const T& s,
+                            Vector3DArray<T>& out, std::size_t grain = PARALLEL_BATCH_GRAIN);
+
+    /**
+     * Function to compute the scalar products of two arrays element-wise in parallel, see
+     * batchDot().
+     *
+     * @param jobs System running the jobs.
+     * @param a First factors.
+     * @param b Second factors, must have the same size as a.
+     * @param out Destination which must provide space for a.size() scalars.
+     * @param grain Maximum number of vectors per job.
+     */
+    template<typename T>
+    void parallelBatchDot(JobSystem& jobs, const Vector3DArray<T>& a, const Vector3DArray<T>& b,
+                          T* out, std::size_t grain = PARALLEL_BATCH_GRAIN);
+
+    /**
+     * Function to compute the vector products of two arrays element-wise in parallel, see
+     * batchCross().
+     *
+     * @param jobs System running the jobs.
+     * @param a First factors.
+     * @param b Second factors, must have the same size as a.
+     * @param out Vector products, resized to the size of a.
+     * @param grain Maximum number of vectors per job.
+     */
+    template<typename T>
+    void parallelBatchCross(JobSystem& jobs, const Vector3DArray<T>& a,
+                            const Vector3DArray<T>& b, Vector3DArray<T>& out,
+                            std::size_t grain = PARALLEL_BATCH_GRAIN);
+
+    /**
+     * Function to compute the magnitudes of all vectors of an array in parallel, see
+     * batchMagnitude().
+     *
+     * @param jobs System running the jobs.
+     * @param a Vectors to measure.
+     * @param out Destination which must provide space for a.size() scalars.
+     * @param grain Maximum number of vectors per job.
+     */
+    template<typename T>
+    void parallelBatchMagnitude(JobSystem& jobs, const Vector3DArray<T>& a, T* out,
+                                std::size_t grain = PARALLEL_BATCH_GRAIN);
+
+    /**
+     * Function to normalize all vectors of an array in parallel, see batchNormalize().
+     *
+     * @tparam P Precision policy, see Precision.h.
+     * @param jobs System running the jobs.
+     * @param a Vectors to normalize.
+     * @param out Normalized vectors, resized to the size of a.
+     * @param grain Maximum number of vectors per job.
+     */
+    template<typename P = ExactPrecision, typename T>
+    void parallelBatchNormalize(JobSystem& jobs, const Vector3DArray<T>& a,
+                                Vector3DArray<T>& out, std::size_t grain = PARALLEL_BATCH_GRAIN);
+
+
+
+    /*==========================================
+     * INLINE IMPLEMENTATION
+     *=========================================*/
+
+    namespace detail {
+
+        /** Number of vectors the ranges are aligned to, one AVX register of floats. */
+        const std::size_t PARALLEL_BATCH_BLOCK = 8;
+
+        /**
+         * Function to split a stream of vectors into ranges starting at multiples of
+         * PARALLEL_BATCH_BLOCK, so every range starts at an aligned SIMD pack.
+         *
+         * @param jobs System running the jobs.
+         * @param count Number of vectors.
+         * @param grain Maximum number of vectors per job.
+         * @param kernel Callable taking the offset and the number of vectors of a range.
+         */
+        template<typename F>
+        inline void parallelStreams(JobSystem& jobs, std::size_t count, std::size_t grain,
+                                    const F& kernel) {
+
+            const std::size_t blocks = (count + PARALLEL_BATCH_BLOCK - 1) / PARALLEL_BATCH_BLOCK;
+            const std::size_t blockGrain = std::max<std::size_t>(grain / PARALLEL_BATCH_BLOCK, 1);
+
+            jobs.parallelFor(0, blocks, blockGrain, [&](std::size_t begin, std::size_t end) {
+                const std::size_t first = begin * PARALLEL_BATCH_BLOCK;
+                const std::size_t last = std::min(end * PARALLEL_BATCH_BLOCK, count);
+                kernel(first, last - first);
+            });
+        }
+
+    } /* Namespace detail */
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    template<typename T>
+    inline void parallelBatchAdd(JobSystem& jobs, const Vector3DArray<T>& a,
+                                 const Vector3DArray<T>& b, Vector3DArray<T>& out,
+                                 std::size_t grain) {
+
+        PIKO_PROFILE_ZONE("parallelBatchAdd");
+
+        if(a.size() != b.size()) {
+            throw std::invalid_argument("parallelBatchAdd: Array sizes differ.");
+        }
+
+        out.resize(a.size());
+        detail::parallelStreams(jobs, a.size(), grain, [&](std::size_t i, std::size_t n) {
+            detail::addStreams(a.x() + i, b.x() + i, out.x() + i, n);
+            detail::addStreams(a.y() + i, b.y() + i, out.y() + i, n);
+            detail::addStreams(a.z() + i, b.z() + i, out.z() + i, n);
+        });
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    template<typename T>
+    inline void parallelBatchSub(JobSystem& jobs, const Vector3DArray<T>& a,
+                                 const Vector3DArray<T>& b, Vector3DArray<T>& out,
+                                 std::size_t grain) {
+
+        PIKO_PROFILE_ZONE("parallelBatchSub");
+
+        if(a.size() != b.size()) {
+            throw std::invalid_argument("parallelBatchSub: Array sizes differ.");
+        }
+
+        out.resize(a.size());
+        detail::parallelStreams(jobs, a.size(), grain, [&](std::size_t i, std::size_t n) {
+            detail::subStreams(a.x() + i, b.x() + i, out.x() + i, n);
+            detail::subStreams(a.y() + i, b.y() + i, out.y() + i, n);
+            detail::subStreams(a.z() + i, b.z() + i, out.z() + i, n);
+        });
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    template<typename T>
+    inline void parallelBatchScale(JobSystem& jobs, const Vector3DArray<T>& a, const T& s,
+                                   Vector3DArray<T>& out, std::size_t grain) {
+
+        PIKO_PROFILE_ZONE("parallelBatchScale");
+
+        out.resize(a.size());
+        detail::parallelStreams(jobs, a.size(), grain, [&](std::size_t i, std::size_t n) {
+            detail::scaleStream(a.x() + i, s, out.x() + i, n);
+            detail::scaleStream(a.y() + i, s, out.y() + i, n);
+            detail::scaleStream(a.z() + i, s, out.z() + i, n);
+        });
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    template<typename T>
+    inline void parallelBatchDot(JobSystem& jobs, const Vector3DArray<T>& a,
+                                 const Vector3DArray<T>& b, T* out, std::size_t grain) {
+
+        PIKO_PROFILE_ZONE("parallelBatchDot");
+
+        if(a.size() != b.size()) {
+            throw std::invalid_argument("parallelBatchDot: Array sizes differ.");
+        }
+
+        detail::parallelStreams(jobs, a.size(), grain, [&](std::size_t i, std::size_t n) {
+            detail::dotStreams(a.x() + i, a.y() + i, a.z() + i, b.x() + i, b.y() + i, b.z() + i,
+                               out + i, n);
+        });
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    template<typename T>
+    inline void parallelBatchCross(JobSystem& jobs, const Vector3DArray<T>& a,
+                                   const Vector3DArray<T>& b, Vector3DArray<T>& out,
+                                   std::size_t grain) {
+
+        PIKO_PROFILE_ZONE("parallelBatchCross");
+
+        if(a.size() != b.size()) {
+            throw std::invalid_argument("parallelBatchCross: Array sizes differ.");
+        }
+
+        out.resize(a.size());
+        detail::parallelStreams(jobs, a.size(), grain, [&](std::size_t i, std::size_t n) {
+            detail::crossStreams(a.x() + i, a.y() + i, a.z() + i, b.x() + i, b.y() + i,
+                                 b.z() + i, out.x() + i, out.y() + i, out.z() + i, n);
+        });
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    template<typename T>
+    inline void parallelBatchMagnitude(JobSystem& jobs, const Vector3DArray<T>& a, T* out,
+                                       std::size_t grain) {
+
+        PIKO_PROFILE_ZONE("parallelBatchMagnitude");
+
+        detail::parallelStreams(jobs, a.size(), grain, [&](std::size_t i, std::size_t n) {
+            detail::magnitudeStreams(a.x() + i, a.y() + i, a.z() + i, out + i, n);
+        });
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    template<typename P, typename T>
+    inline void parallelBatchNormalize(JobSystem& jobs, const Vector3DArray<T>& a,
+                                       Vector3DArray<T>& out, std::size_t grain) {
+
+        PIKO_PROFILE_ZONE("parallelBatchNormalize");
+
+        out.resize(a.size());
+        detail::parallelStreams(jobs, a.size(), grain, [&](std::size_t i, std::size_t n) {
+            detail::normalizeStreams<P>(a.x() + i, a.y() + i, a.z() + i,
+                                        out.x() + i, out.y() + i, out.z() + i, n);
+        });
+    }
+
+} /* Namespace Piko */
+
+
+#endif // End of PARALLELBATCH_H
@@ -0,0 +1,245 @@
+/**
+ * @file        ParticleSystem.h
+ * @author      Robert Koch
+ * @version     1.0
+ *
+ * Declaration of a particle system storing its particles as structure of arrays, integrated in
+ * SIMD packs and streamed into a vertex buffer.
+ */
+#ifndef PARTICLESYSTEM_H
+#define PARTICLESYSTEM_H
+
+#include <cstddef>
+#include <vector>
+
+#include "GLExtensions.h"
+#include "JobSystem.h"
+#include "ParallelBatch.h"
+#include "Vector3DLayout.h"
+#include "util/Vector3DArray.h"
+
+
+namespace Piko {
+
+    /**
+     * Vertex written to the buffer for each particle.
+     */
+    struct ParticleVertex {
+        float x;                    /**< X coordinate of the position. */
+        float y;                    /**< Y coordinate of the position. */
+        float z;                    /**< Z coordinate of the position. */
+        float lifetime;             /**< Remaining lifetime in seconds. */
+    };
+
+    /**
+     * Particles with a position, a velocity and a remaining lifetime. Every stream is a separate
+     * array, so update() loads a whole SIMD pack of particles per instruction and integrates
+     * gravity, drag and the lifetime in one pass over memory. Dead particles are replaced by the
+     * last particle, which keeps the streams dense but does not keep the order of the particles.
+     * The capacity is fixed, emitting never allocates.
+     *
+     * The vertex buffer is optional: after initBuffer() each stream() orphans the buffer and
+     * writes the vertices directly into its mapping. The buffer functions have to be called
+     * while the context is current.
+     */
+    class ParticleSystem final {
+
+        public:
+
+            /**
+             * Constructor to create an empty system.
+             *
+             * @param capacity Maximum number of living particles.
+             */
+            explicit ParticleSystem(std::size_t capacity);
+
+            /**
+             * Destructor. The buffer has to be released with releaseBuffer() before, while the
+             * context is still current.
+             */
+            ~ParticleSystem();
+
+            /**
+             * Function to add a particle.
+             *
+             * @param position Start position.
+             * @param velocity Start velocity in units per second.
+             * @param lifetime Lifetime in seconds.
+             * @return False if the system is full and the particle was dropped, otherwise true.
+             */
+            bool emit(const Vector3D<float>& position, const Vector3D<float>& velocity,
+                      float lifetime);
+
+            /**
+             * Function to advance all particles on the calling thread. Velocities are
+             * accelerated by gravity and damped by drag before the positions move, particles
+             * whose lifetime ran out are removed.
+             *
+             * @param dt Time step in seconds.
+             */
+            void update(float dt);
+
+            /**
+             * Function to advance all particles in parallel, see update(float). The removal of
+             * dead particles runs on the calling thread.
+             *
+             * @param jobs System running the jobs.
+             * @param dt Time step in seconds.
+             * @param grain Maximum number of particles per job.
+             */
+            void update(JobSystem& jobs, float dt, std::size_t grain = PARALLEL_BATCH_GRAIN);
+
+            /**
+             * Function to remove all particles.
+             */
+            void clear();
+
+            /**
+             * Functions to set the forces.
+             *
+             * @param gravity Acceleration applied to all particles.
+             * @param drag Drag coefficient, velocities decay with exp(-drag * t). 0 for none.
+             */
+            void setGravity(const Vector3D<float>& gravity);
+            void setDrag(float drag);
+
+            /**
+             * Functions to get the forces.
+             *
+             * @return Acceleration or drag.
+             */
+            const Vector3D<float>& getGravity() const;
+            float getDrag() const;
+
+            /**
+             * Functions to get the number of particles.
+             *
+             * @return Number of living particles or maximum number.
+             */
+            std::size_t getCount() const;
+            std::size_t getCapacity() const;
+
+            /**
+             * Functions to get the streams. Only the first getCount() elements are particles.
+             *
+             * @return Positions, velocities or remaining lifetimes.
+             */
+            const Vector3DArray<float>& getPositions() const;
+            const Vector3DArray<float>& getVelocities() const;
+            const float* getLifetimes() const;
+
+            /**
+             * Function to write a vertex for every particle.
+             *
+             * @param out Destination which must provide space for getCount() vertices.
+             */
+            void writeVertices(ParticleVertex* out) const;
+
+            /**
+             * Function to create the vertex buffer, sized for the capacity.
+             *
+             * @param gl Functions of the current context.
+             *
+             * @throws std::runtime_error If the context has no buffer objects.
+             */
+            void initBuffer(const GLExtensions& gl);
+
+            /**
+             * Function to delete the vertex buffer.
+             */
+            void releaseBuffer();
+
+            /**
+             * Function to write the vertices of all particles into the vertex buffer. The
+             * previous contents are orphaned, so the driver never waits for draws still reading
+             * them.
+             *
+             * @return Number of vertices written.
+             */
+            std::size_t stream();
+
+            /**
+             * Function to get the vertex buffer holding the output of the last stream().
+             *
+             * @return Buffer name, 0 before initBuffer().
+             */
+            GLuint getBuffer() const;
+
+        private:
+
+            Vector3DArray<float> m_positions;       /**< Positions. */
+            Vector3DArray<float> m_velocities;      /**< Velocities. */
+            std::vector<float> m_lifetimes;         /**< Remaining lifetimes. */
+            std::size_t m_count;                    /**< Number of living particles. */
+
+            Vector3D<float> m_gravity;              /**< Acceleration. */
+            float m_drag;                           /**< Drag coefficient. */
+
+            const GLExtensions* m_gl;               /**< Functions, NULL without buffer. */
+            GLuint m_buffer;                        /**< Vertex buffer. */
+            std::vector<ParticleVertex> m_staging;  /**< Vertices if mapping is unavailable. */
+
+            /**
+             * Function to integrate a range of particles.
+             *
+             * @param begin First particle.
+             * @param count Number of particles.
+             * @param dt Time step in seconds.
+             * @param damping Factor the velocities are multiplied with in this step.
+             */
+            void integrate(std::size_t begin, std::size_t count, float dt, float damping);
+
+            /**
+             * Function to remove the particles whose lifetime ran out.
+             */
+            void removeDead();
+
+            /**
+             * Copy constructor is forbidden.
+             */
+            ParticleSystem(const ParticleSystem& system);
+
+            /**
+             * Assignment operator is forbidden.
+             */
+            ParticleSystem& operator=(const ParticleSystem& system);
+
+    }; /* Class ParticleSystem */
+
+
+
+    /*==========================================
+     * INLINE IMPLEMENTATION
+     *=========================================*/
+
+    inline bool ParticleSystem::emit(const Vector3D<float>& position,
+                                     const Vector3D<float>& velocity, float lifetime) {
+
+        if(m_count == m_lifetimes.size()) return false;
+
+        m_positions.set(m_count, position);
+        m_velocities.set(m_count, velocity);
+        m_lifetimes[m_count] = lifetime;
+        ++m_count;
+        return true;
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    inline std::size_t ParticleSystem::getCount() const {
+
+        return m_count;
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    inline std::size_t ParticleSystem::getCapacity() const {
+
+        return m_lifetimes.size();
+    }
+
+} /* Namespace Piko */
+
+#endif // End of PARTICLESYSTEM_H
@@ -0,0 +1,212 @@
+/**
+ * @file        Profiler.h
+ * @author      Robert Koch
+ * @version     1.0
+ *
+ * Declaration of the CPU profiler. Scopes marked with the PIKO_PROFILE_* macros are recorded
+ * into buffers owned by the executing thread while a capture is running and can be exported as
+ * Chrome trace JSON, which chrome://tracing and Perfetto load directly.
+ */
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+
+
+/**
+ * Set to 0 to remove all profiling macros, to 1 to keep them. Enabled by default unless NDEBUG
+ * is defined. An enabled profiler which is not capturing costs one atomic load per zone.
+ */
+#ifndef PIKO_ENABLE_PROFILER
+    #ifdef NDEBUG
+        #define PIKO_ENABLE_PROFILER 0
+    #else
+        #define PIKO_ENABLE_PROFILER 1
+    #endif
+#endif
+
+#define PIKO_PROFILE_CONCAT_IMPL(a, b) a##b
+#define PIKO_PROFILE_CONCAT(a, b) PIKO_PROFILE_CONCAT_IMPL(a, b)
+
+#if PIKO_ENABLE_PROFILER
+    /** Macro to record the enclosing scope under a name, which has to be a string literal. */
+    #define PIKO_PROFILE_ZONE(name) \
+        Piko::ProfileZone PIKO_PROFILE_CONCAT(pikoProfileZone, __LINE__)(name)
+
+    /** Macro to record the enclosing function. */
+    #define PIKO_PROFILE_FUNCTION() PIKO_PROFILE_ZONE(__func__)
+
+    /** Macro to mark the beginning of a new frame. */
+    #define PIKO_PROFILE_FRAME() Piko::Profiler::markFrame()
+
+    /** Macro to name the calling thread in the trace, the name has to be a string literal. */
+    #define PIKO_PROFILE_THREAD(name) Piko::Profiler::setThreadName(name)
+#else
+    #define PIKO_PROFILE_ZONE(name) ((void)0)
+    #define PIKO_PROFILE_FUNCTION() ((void)0)
+    #define PIKO_PROFILE_FRAME() ((void)0)
+    #define PIKO_PROFILE_THREAD(name) ((void)0)
+#endif
+
+
+namespace Piko {
+
+    /**
+     * Recorded zone or marker.
+     */
+    struct ProfileEvent {
+        const char* name;           /**< Name, must be a string literal. */
+        std::uint64_t start;        /**< Start in ns of the steady clock. */
+        std::uint64_t duration;     /**< Duration in ns, FRAME_MARKER for frame markers. */
+    };
+
+    /**
+     * Static interface of the profiler. Each thread records into a chain of fixed-size blocks of
+     * its own, so recording takes no lock and never moves recorded events. Export only while no
+     * capture is running.
+     */
+    class Profiler final {
+
+        public:
+
+            /** Number of events per buffer block. */
+            static const std::size_t BLOCK_EVENTS = 4096;
+
+            /** Maximum number of events recorded per thread and capture. */
+            static const std::size_t MAX_THREAD_EVENTS = 64 * BLOCK_EVENTS;
+
+            /** Duration value identifying frame markers. */
+            static const std::uint64_t FRAME_MARKER = ~(std::uint64_t)0;
+
+            /**
+             * Function to start a capture. Events of the previous capture are discarded by each
+             * thread when it records its first event of the new capture.
+             */
+            static void startCapture();
+
+            /**
+             * Function to stop the capture. Zones still open keep recording until they end.
+             */
+            static void stopCapture();
+
+            /**
+             * Function to check if a capture is running.
+             *
+             * @return True if events are recorded, otherwise false.
+             */
+            static bool isCapturing();
+
+            /**
+             * Function to mark the beginning of a new frame.
+             */
+            static void markFrame();
+
+            /**
+             * Function to name the calling thread in the trace.
+             *
+             * @param name Thread name, must be a string literal.
+             */
+            static void setThreadName(const char* name);
+
+            /**
+             * Function to write the events of the last capture as Chrome trace JSON.
+             *
+             * @param stream Output stream.
+             */
+            static void writeChromeTrace(std::ostream& stream);
+
+            /**
+             * Function to save the events of the last capture as Chrome trace JSON.
+             *
+             * @param path Output file.
+             *
+             * @throws std::runtime_error If the file cannot be written.
+             */
+            static void saveChromeTrace(const std::string& path);
+
+            /**
+             * Function to get the number of events dropped because a thread reached
+             * MAX_THREAD_EVENTS in the last capture.
+             *
+             * @return Number of dropped events.
+             */
+            static std::size_t getDroppedCount();
+
+            /**
+             * Function to record an event of the calling thread.
+             *
+             * @param event Event to record.
+             */
+            static void record(const ProfileEvent& event);
+
+            /**
+             * Function to get the current time of the profiler clock.
+             *
+             * @return Nanoseconds of the steady clock.
+             */
+            static std::uint64_t now();
+
+
+        private:
+
+            /**
+             * Forbid constructor, the class is static.
+             */
+            Profiler();
+
+    }; /* Class Profiler */
+
+    /**
+     * Scope guard recording the lifetime of a zone. Use PIKO_PROFILE_ZONE() instead.
+     */
+    class ProfileZone final {
+
+        public:
+
+            /**
+             * Constructor to open a zone, if a capture is running.
+             *
+             * @param name Zone name, must be a string literal.
+             */
+            explicit ProfileZone(const char* name)
+              :
+              m_name(name),
+              m_start(Profiler::isCapturing() ? Profiler::now() : 0) {
+
+            }
+
+            /**
+             * Destructor to close and record the zone.
+             */
+            ~ProfileZone() {
+
+                if(m_start) {
+                    ProfileEvent event = { m_name, m_start, Profiler::now() - m_start };
+                    Profiler::record(event);
+                }
+            }
+
+        private:
+
+            const char* m_name;         /**< Zone name. */
+            std::uint64_t m_start;      /**< Start time, 0 if not recorded. */
+
+            /**
+             * Forbid copy constructor.
+             */
+            ProfileZone(const ProfileZone& zone);
+
+            /**
+             * Forbid assignment operator.
+             */
+            ProfileZone& operator=(const ProfileZone& zone);
+
+    }; /* Class ProfileZone */
+
+} /* Namespace Piko */
+
+
+#endif // End of PROFILER_H
@@ -0,0 +1,151 @@
+/**
+ * @file        RenderCommandList.h
+ * @author      Robert Koch
+ * @version     1.0
+ *
+ * Declaration of a list of recorded rendering commands which is executed later, usually on the
+ * render thread.
+ */
+#ifndef RENDERCOMMANDLIST_H
+#define RENDERCOMMANDLIST_H
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+
+namespace Piko {
+
+    /**
+     * List of callables recorded on one thread and executed on another. The callables are stored
+     * in memory blocks owned by the list, which are kept when the list is cleared, so recording
+     * the same amount of work every frame does not allocate after the first frames.
+     */
+    class RenderCommandList final {
+
+        public:
+
+            /** Size of the memory blocks the callables are stored in. */
+            static const std::size_t BLOCK_SIZE = 64 * 1024;
+
+            /**
+             * Constructor to create an empty list.
+             */
+            RenderCommandList();
+
+            /**
+             * Destructor destroying all recorded commands and releasing the memory blocks.
+             */
+            ~RenderCommandList();
+
+            /**
+             * Function to append a command.
+             *
+             * @param command Callable without parameters, e.g. a lambda issuing GL calls.
+             */
+            template<typename F>
+            void record(F&& command);
+
+            /**
+             * Function to invoke all commands in the order they were recorded.
+             */
+            void execute();
+
+            /**
+             * Function to destroy all commands. The memory blocks are kept for reuse.
+             */
+            void clear();
+
+            /**
+             * Function to get the number of recorded commands.
+             *
+             * @return Number of commands.
+             */
+            std::size_t size() const;
+
+            /**
+             * Function to check if the list is empty.
+             *
+             * @return True if no command is recorded, otherwise false.
+             */
+            bool empty() const;
+
+
+        private:
+
+            /** Type erased recorded command. */
+            struct Command {
+                void (*invoke)(void*);      /**< Calls the callable. */
+                void (*destroy)(void*);     /**< Destroys the callable. */
+                void* object;               /**< Callable inside a memory block. */
+            };
+
+            /** Memory block holding callables. */
+            struct Block {
+                unsigned char* data;        /**< Block memory. */
+                std::size_t size;           /**< Block size in bytes. */
+            };
+
+            std::vector<Command> m_commands;    /**< Recorded commands. */
+            std::vector<Block> m_blocks;        /**< Memory blocks. */
+            std::size_t m_block;                /**< Block currently filled. */
+            std::size_t m_offset;               /**< Used bytes of the current block. */
+
+            /**
+             * Function to reserve memory for a callable.
+             *
+             * @param size Size of the callable in bytes.
+             *
+             * @return Memory aligned for any fundamental type.
+             */
+            void* allocate(std::size_t size);
+
+            template<typename F>
+            static void invoke(void* object) {
+                (*static_cast<F *>(object))();
+            }
+
+            template<typename F>
+            static void destroy(void* object) {
+                static_cast<F *>(object)->~F();
+            }
+
+            /**
+             * Copy constructor is forbidden.
+             */
+            RenderCommandList(const RenderCommandList& list);
+
+            /**
+             * Assignment operator is forbidden.
+             */
+            RenderCommandList& operator=(const RenderCommandList& list);
+
+    }; /* Class RenderCommandList */
+
+
+
+    /*==========================================
+     * INLINE IMPLEMENTATION
+     *=========================================*/
+
+    template<typename F>
+    inline void RenderCommandList::record(F&& command) {
+
+        typedef typename std::decay<F>::type Callable;
+
+        static_assert(alignof(Callable) <= alignof(std::max_align_t),
+                      "Over-aligned commands are not supported.");
+
+        void* object = allocate(sizeof(Callable));
+        new (object) Callable(std::forward<F>(command));
+
+        Command entry = { &invoke<Callable>, &destroy<Callable>, object };
+        m_commands.push_back(entry);
+    }
+
+} /* Namespace Piko */
+
+
+#endif // End of RENDERCOMMANDLIST_H
@@ -0,0 +1,179 @@
+/**
+ * @file        RenderThread.h
+ * @author      Robert Koch
+ * @version     1.0
+ *
+ * Declaration of a dedicated thread owning a GLContext. Other threads record their rendering
+ * work into double-buffered command lists, so the simulation of the next frame overlaps with the
+ * submission of the current one.
+ */
+#ifndef RENDERTHREAD_H
+#define RENDERTHREAD_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#include "GLContext.h"
+#include "RenderCommandList.h"
+
+
+namespace Piko {
+
+    /**
+     * Accumulated wait and execution times of a RenderThread in milliseconds.
+     */
+    struct RenderThreadStats {
+        std::size_t frameCount;     /**< Number of executed frames. */
+        double submitWaitMs;        /**< Time submit() waited for the render thread. */
+        double renderWaitMs;        /**< Time the render thread waited for a submission. */
+        double executeMs;           /**< Time spent executing command lists and swapping. */
+    };
+
+    /**
+     * Thread owning a GLContext and executing submitted command lists on it. A frame is recorded
+     * into getCommandList() and handed over with submit(). While the render thread executes it,
+     * the next frame is recorded into the second list.
+     */
+    class RenderThread final {
+
+        public:
+
+            /**
+             * Function initializing the context on the render thread, e.g. by calling init() or
+             * initOffscreen().
+             */
+            typedef std::function<void(GLContext&)> InitCallback;
+
+            /**
+             * Constructor to create a stopped render thread with the default context backend.
+             */
+            RenderThread();
+
+            /**
+             * Constructor to create a stopped render thread with the specified context backend.
+             *
+             * @param backend Platform backend of the owned context.
+             */
+            explicit RenderThread(std::unique_ptr<GLContextBackend> backend);
+
+            /**
+             * Destructor. Same effect as stop().
+             */
+            ~RenderThread();
+
+            /**
+             * Function to start the thread and initialize the context on it. Returns after the
+             * initialization finished.
+             *
+             * @param init Callback initializing the context.
+             *
+             * @throws Exception thrown by the callback.
+             */
+            void start(const InitCallback& init);
+
+            /**
+             * Function to execute all submitted frames, dispose the context and end the thread.
+             */
+            void stop();
+
+            /**
+             * Function to get the list recording the next frame. Only valid until submit().
+             *
+             * @return Command list of the calling thread.
+             */
+            RenderCommandList& getCommandList();
+
+            /**
+             * Function to hand the recorded frame to the render thread. Waits until the render
+             * thread finished the previous frame, so the second list is free for recording.
+             *
+             * @throws Exception thrown by a command of an earlier frame.
+             */
+            void submit();
+
+            /**
+             * Function to wait until all submitted frames are executed.
+             *
+             * @throws Exception thrown by a command of an earlier frame.
+             */
+            void flush();
+
+            /**
+             * Function to check if the thread is running.
+             *
+             * @return True between start() and stop(), otherwise false.
+             */
+            bool isRunning() const;
+
+            /**
+             * Function to get the context owned by the thread. GL calls using it are only allowed
+             * inside commands.
+             *
+             * @return Owned context.
+             */
+            GLContext& getContext();
+
+            /**
+             * Function to get the accumulated timings.
+             *
+             * @return Timings since start() or the last resetStats().
+             */
+            RenderThreadStats getStats() const;
+
+            /**
+             * Function to reset the accumulated timings.
+             */
+            void resetStats();
+
+
+        private:
+
+            GLContext m_context;                    /**< Context owned by the thread. */
+            RenderCommandList m_lists[2];           /**< Double-buffered command lists. */
+            std::size_t m_recordIndex;              /**< List recording the next frame. */
+
+            std::thread m_thread;                   /**< Render thread. */
+            mutable std::mutex m_mutex;             /**< Guards the hand-over state. */
+            std::condition_variable m_condition;    /**< Signals hand-over state changes. */
+            RenderCommandList* m_pending;           /**< Submitted list not yet picked up. */
+            RenderCommandList* m_executing;         /**< List currently executed. */
+            bool m_isRunning;                       /**< Flag if the thread is running. */
+            bool m_isStopping;                      /**< Flag if the thread should end. */
+            std::exception_ptr m_error;             /**< Error of the render thread. */
+            RenderThreadStats m_stats;              /**< Accumulated timings. */
+
+            /**
+             * Function running on the render thread.
+             *
+             * @param init Callback initializing the context.
+             */
+            void run(InitCallback init);
+
+            /**
+             * Function to wait until no frame is pending or executed. Needs a locked mutex.
+             *
+             * @param lock Lock of m_mutex.
+             */
+            void waitIdle(std::unique_lock<std::mutex>& lock);
+
+            /**
+             * Copy constructor is forbidden.
+             */
+            RenderThread(const RenderThread& thread);
+
+            /**
+             * Assignment operator is forbidden.
+             */
+            RenderThread& operator=(const RenderThread& thread);
+
+    }; /* Class RenderThread */
+
+} /* Namespace Piko */
+
+
+#endif // End of RENDERTHREAD_H
@@ -0,0 +1,61 @@
+/**
+ * @file        Vector3DLayout.h
+ * @author      Robert Koch
+ * @version     1.0
+ *
+ * Check that a program uses the layout of Vector3D<float> the engine library was built with.
+ * PIKO_SIMD_VECTOR3D changes the size of Vector3D<float> from 12 to 16 bytes and the library
+ * passes vectors and boxes through its interface, so a program compiled with another setting
+ * would exchange corrupted data without any error. Headers of that interface include this file,
+ * which makes every translation unit reference a marker of its layout. The library only defines
+ * the marker of its own layout, so a mismatch fails to link.
+ */
+#ifndef VECTOR3DLAYOUT_H
+#define VECTOR3DLAYOUT_H
+
+#include "util/SIMD.h"
+#include "util/Vector3D.h"
+
+#if defined(PIKO_SIMD_VECTOR3D) && defined(PIKO_SIMD_SSE)
+    #define PIKO_VECTOR3D_LAYOUT_SIMD 1
+#endif
+
+
+namespace Piko {
+
+    namespace detail {
+
+        /** Marker of the layout, defined by the library only for the one it was built with. */
+#if defined(PIKO_VECTOR3D_LAYOUT_SIMD)
+        extern const int vector3DLayoutSIMD;
+#else
+        extern const int vector3DLayoutScalar;
+#endif
+
+    } /* Namespace detail */
+
+} /* Namespace Piko */
+
+
+#if defined(_MSC_VER)
+    #if defined(PIKO_VECTOR3D_LAYOUT_SIMD)
+        #pragma detect_mismatch("PIKO_VECTOR3D_LAYOUT", "SIMD")
+    #else
+        #pragma detect_mismatch("PIKO_VECTOR3D_LAYOUT", "scalar")
+    #endif
+#else
+namespace {
+
+    // Kept by the compiler although unused, so the reference to the marker reaches the linker.
+#if defined(PIKO_VECTOR3D_LAYOUT_SIMD)
+    __attribute__((used)) const int* const pikoVector3DLayout = &Piko::detail::vector3DLayoutSIMD;
+#else
+    __attribute__((used)) const int* const pikoVector3DLayout =
+        &Piko::detail::vector3DLayoutScalar;
+#endif
+
+} /* Anonymous namespace */
+#endif
+
+
+#endif // End of VECTOR3DLAYOUT_H
@@ -0,0 +1,144 @@
+/**
+ * @file        WGLContextBackend.h
+ * @author      Robert Koch
+ * @version     1.0
+ *
+ * Declaration of the rendering context backend built on top of WGL.
+ */
+#ifndef WGLCONTEXTBACKEND_H
+#define WGLCONTEXTBACKEND_H
+
+#if defined(_WIN32)
+
+#include <vector>
+#include <windows.h>
+
+#include "GLContextBackend.h"
+
+
+namespace Piko {
+
+    /**
+     * Rendering context backend creating WGL contexts for native windows.
+     */
+    class WGLContextBackend final : public GLContextBackend {
+
+        public:
+
+            /**
+             * Constructor.
+             */
+            WGLContextBackend();
+
+            /**
+             * Destructor to dispose the context. Same effect as dispose().
+             */
+            ~WGLContextBackend();
+
+            Result<> tryInit(HWND hWnd, const ContextConfig& config);
+            Result<> tryInitOffscreen(int width, int height, const ContextConfig& config);
+            std::unique_ptr<GLContextBackend> createShared() const;
+            void makeCurrent();
+            void doneCurrent();
+            void* getProcAddress(const char* name) const;
+            void dispose();
+            void setSwapInterval(int interval);
+            int getSwapInterval() const;
+            void swapBuffers();
+            const FramebufferFormat& getFramebufferFormat() const;
+            HDC getDeviceContext() const;
+
+
+        private:
+
+            typedef HGLRC (WINAPI *CreateContextAttribsProc)(HDC, HGLRC, const int*);
+            typedef BOOL (WINAPI *ChoosePixelFormatProc)(HDC, const int*, const FLOAT*, UINT,
+                                                         int*, UINT*);
+            typedef BOOL (WINAPI *GetPixelFormatAttribivProc)(HDC, int, int, UINT, const int*,
+                                                              int*);
+            typedef const char* (WINAPI *GetExtensionsStringProc)(HDC);
+            typedef BOOL (WINAPI *SwapIntervalProc)(int);
+            typedef int (WINAPI *GetSwapIntervalProc)();
+
+            /** Context creation functions beyond wglCreateContext(). */
+            struct WGLFunctions {
+                CreateContextAttribsProc createContextAttribs;
+                ChoosePixelFormatProc choosePixelFormat;
+                GetPixelFormatAttribivProc getPixelFormatAttribiv;
+                bool hasProfiles;
+                bool hasNoError;
+
+                WGLFunctions()
+                  :
+                  createContextAttribs(NULL),
+                  choosePixelFormat(NULL),
+                  getPixelFormatAttribiv(NULL),
+                  hasProfiles(false),
+                  hasNoError(false) {
+                }
+            };
+
+            HWND m_hWnd;                /**< Window on which the rendering should occure. NULL for
+                                             shared contexts, which do not own the DC. */
+            HDC m_hDC;                  /**< Device context. */
+            HGLRC m_hRC;                /**< Rendering context. */
+            FramebufferFormat m_format; /**< Granted framebuffer format. */
+            int m_swapInterval;         /**< Granted swap interval. */
+
+            /** Function creating versioned contexts, NULL for legacy contexts. */
+            CreateContextAttribsProc m_createContextAttribs;
+
+            /** Attributes the context was created with. */
+            std::vector<int> m_contextAttribs;
+
+            /**
+             * Function to load the context creation functions using a temporary window.
+             *
+             * @param wgl Receives the functions, which stay NULL if not supported.
+             */
+            static void loadFunctions(WGLFunctions& wgl);
+
+            /**
+             * Function to release everything created by a failed initialization.
+             *
+             * @param error Reason of the failure.
+             *
+             * @return Failed result holding the error.
+             */
+            Result<> fail(const ErrorMessage& error);
+
+            /**
+             * Function to translate the version, profile and flags into context attributes.
+             *
+             * @param config Requested configuration.
+             * @param wgl Supported context creation functions.
+             */
+            void initContextAttribs(const ContextConfig& config, const WGLFunctions& wgl);
+
+            /**
+             * Function to check if an extension string contains an extension.
+             *
+             * @param extensions Space separated extension names, may be NULL.
+             * @param name Name of the extension.
+             *
+             * @return True if contained, otherwise false.
+             */
+            static bool hasExtension(const char* extensions, const char* name);
+
+            /**
+             * Forbid copy constructor.
+             */
+            WGLContextBackend(const WGLContextBackend& backend);
+
+            /**
+             * Forbid assignment operator.
+             */
+            WGLContextBackend& operator=(const WGLContextBackend& backend);
+
+    }; /* Class WGLContextBackend */
+
+} /* Namespace Piko */
+
+#endif // End of _WIN32
+
+#endif // End of WGLCONTEXTBACKEND_H
@@ -0,0 +1,101 @@
+/**
+ * @file        Win32WindowBackend.h
+ * @author      Robert Koch
+ * @version     1.0
+ *
+ * Declaration of the window backend built on top of the winapi.
+ */
+#ifndef WIN32WINDOWBACKEND_H
+#define WIN32WINDOWBACKEND_H
+
+#if defined(_WIN32)
+
+#include <string>
+#include <windows.h>
+
+#include "WindowBackend.h"
+
+
+namespace Piko {
+
+    /**
+     * Window backend creating native windows with the winapi.
+     */
+    class Win32WindowBackend final : public WindowBackend {
+
+        public:
+
+            /**
+             * Constructor.
+             */
+            Win32WindowBackend();
+
+            /**
+             * Destructor which destroys a window still alive and unregisters the window class.
+             */
+            ~Win32WindowBackend();
+
+            void create(WindowBase* window, const std::string& title, int width, int height);
+            void destroy();
+            void show();
+            void setTitle(const std::string& title);
+            void setFullscreen(bool flag, int width, int height);
+            int processMessages();
+            int getDisplayWidth() const;
+            int getDisplayHeight() const;
+            HWND getHandle() const;
+
+
+        private:
+
+            /**
+             * Window base class name. Each window appends its memory adress to this name for a
+             * unique class name.
+             **/
+            static const std::string CLASS_NAME_BASE;
+
+            WindowBase* m_window;       /**< Window receiving the messages. */
+            HINSTANCE m_hInstance;      /**< Handle for the application instance. */
+            HWND m_hWnd;                /**< Handle to the window. */
+            WNDCLASSEXA m_wc;           /**< Window class structure. */
+            std::string m_className;    /**< Name of the window class. */
+
+
+            /**
+             * Function to dispatch sent messages to the right window instance. The instance is
+             * stored in the user data of the window at WM_NCCREATE, so the lookup takes constant
+             * time and needs no shared state between threads.
+             *
+             * @param hwnd Handle to the window which reveives the message.
+             * @param msg Message sent.
+             * @param wParam
+             * @param lParam
+             */
+            static LRESULT CALLBACK staticWndProc(HWND hwnd,
+                                                  UINT msg,
+                                                  WPARAM wParam,
+                                                  LPARAM lParam);
+
+            /**
+             * Function to initialize the window class structure.
+             */
+            void initWindowClass();
+
+            /**
+             * Copy constructor is forbidden.
+             */
+            Win32WindowBackend(const Win32WindowBackend& backend);
+
+            /**
+             * Assignment operator is forbidden.
+             */
+            Win32WindowBackend& operator=(const Win32WindowBackend& backend);
+
+
+    }; /* Class Win32WindowBackend */
+
+} /* Namespace Piko */
+
+#endif // End of _WIN32
+
+#endif // End of WIN32WINDOWBACKEND_H
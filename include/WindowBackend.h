@@ -0,0 +1,128 @@
+/**
+ * @file        WindowBackend.h
+ * @author      Robert Koch
+ * @version     1.0
+ *
+ * Declaration of the platform interface a WindowBase delegates all system specific work to.
+ */
+#ifndef WINDOWBACKEND_H
+#define WINDOWBACKEND_H
+
+#include <memory>
+#include <string>
+
+#include "WindowTypes.h"
+
+
+namespace Piko {
+
+    class WindowBase;
+
+    /**
+     * Interface of a platform backend creating and maintaining the native window of a WindowBase.
+     * Messages received by the backend are forwarded to the window with dispatch().
+     */
+    class WindowBackend {
+
+        public:
+
+            /**
+             * Function to create the backend used if no backend was specified: the Win32 backend
+             * on Windows, otherwise a headless backend with a virtual 1920x1080 display.
+             *
+             * @return Default backend.
+             */
+            static std::unique_ptr<WindowBackend> createDefault();
+
+            /**
+             * Destructor.
+             */
+            virtual ~WindowBackend();
+
+            /**
+             * Function to create the native window.
+             *
+             * @param window Window instance receiving the messages.
+             * @param title Window title.
+             * @param width Window width.
+             * @param height Window height.
+             */
+            virtual void create(WindowBase* window, const std::string& title, int width,
+                                int height) = 0;
+
+            /**
+             * Function to destroy the native window. Sends WM_DESTROY to the window.
+             */
+            virtual void destroy() = 0;
+
+            /**
+             * Function to show the window on the screen.
+             */
+            virtual void show() = 0;
+
+            /**
+             * Function to set the window title.
+             *
+             * @param title New window title.
+             */
+            virtual void setTitle(const std::string& title) = 0;
+
+            /**
+             * Function to switch the window between fullscreen and window mode.
+             *
+             * @param flag True to switch to fullscreen mode, false to switch to window mode.
+             * @param width Width of the window in the new mode.
+             * @param height Height of the window in the new mode.
+             */
+            virtual void setFullscreen(bool flag, int width, int height) = 0;
+
+            /**
+             * Function to dispatch all pending messages to the window without blocking.
+             *
+             * @return Number of messages dispatched.
+             */
+            virtual int processMessages() = 0;
+
+            /**
+             * Function to get the width of the display.
+             *
+             * @return Display width in pixels.
+             */
+            virtual int getDisplayWidth() const = 0;
+
+            /**
+             * Function to get the height of the display.
+             *
+             * @return Display height in pixels.
+             */
+            virtual int getDisplayHeight() const = 0;
+
+            /**
+             * Function to get the native window handle.
+             *
+             * @return Window handle.
+             */
+            virtual HWND getHandle() const = 0;
+
+
+        protected:
+
+            /**
+             * Function to forward a message to the message handler of a window.
+             *
+             * @param window Window receiving the message.
+             * @param msg Message code.
+             * @param wParam
+             * @param lParam
+             *
+             * @return True if the message was consumed, otherwise false.
+             */
+            static bool dispatch(WindowBase* window, UINT msg, WPARAM wParam, LPARAM lParam);
+
+
+    }; /* Class WindowBackend */
+
+} /* Namespace Piko */
+
+
+#endif // End of WINDOWBACKEND_H
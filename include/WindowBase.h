@@ -3,38 +3,66 @@
  * @author      Robert Koch
  * @version     1.0
  * 
- * Declaration of a class to simplify the window creation process using the winapi.
+ * Declaration of a class to simplify the window creation process. All platform specific work is
+ * delegated to a WindowBackend, by default the winapi on Windows.
  */
 #ifndef WINDOWBASE_H
 #define WINDOWBASE_H
 
-#include <iostream>
-#include <map>
-#include <windows.h>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <string>
+
+#include "InputEvent.h"
+#include "WindowBackend.h"
+#include "WindowTypes.h"
+#include "util/SPSCRing.h"
 
 
 namespace Piko {
 
     /**
-     * Wrapper class to create windows build on top of the winapi.
+     * Wrapper class to create windows build on top of a platform backend.
      */
     class WindowBase {
 
         public:
 
+            /** Size value to use half of the display width or height. */
+            static const int DEFAULT_SIZE = -1;
+
+            /** Number of input events buffered between two calls of pollInput(). */
+            static const std::size_t INPUT_CAPACITY = 4096;
+
             /**
-             * Constructor to create a window the the specified title and optional size.
+             * Constructor to create a window the the specified title and optional size using the
+             * default backend of the platform.
              * 
              * @param title Window title showing up on the upper border.
-             * @param width Window width.
-             * @param height Window height.
+             * @param width Window width, half of the display width by default.
+             * @param height Window height, half of the display height by default.
              */
             WindowBase(std::string title, 
-                       int width = GetSystemMetrics(SM_CXSCREEN)/2, 
-                       int height = GetSystemMetrics(SM_CYSCREEN)/2);
+                       int width = DEFAULT_SIZE, 
+                       int height = DEFAULT_SIZE);
 
             /**
-             * Destructor which removes the window from registry and resets the window handle.
+             * Constructor to create a window the the specified title and optional size using the
+             * specified backend.
+             * 
+             * @param backend Platform backend creating the native window.
+             * @param title Window title showing up on the upper border.
+             * @param width Window width, half of the display width by default.
+             * @param height Window height, half of the display height by default.
+             */
+            WindowBase(std::unique_ptr<WindowBackend> backend,
+                       std::string title, 
+                       int width = DEFAULT_SIZE, 
+                       int height = DEFAULT_SIZE);
+
+            /**
+             * Destructor which releases the backend together with the native window.
              */
             virtual ~WindowBase();
 
@@ -61,6 +89,20 @@ namespace Piko {
              * @return Window handle.
              */
             HWND getHandle() const;
+
+            /**
+             * Function to get the platform backend of the window.
+             * 
+             * @return Window backend.
+             */
+            WindowBackend& getBackend() const;
+
+            /**
+             * Function to check if the window is in fullscreen mode.
+             *
+             * @return True if the window is in fullscreen mode, otherwise false.
+             */
+            bool isFullscreen() const;
             
             /**
              * Function to set the window title.
@@ -77,6 +119,26 @@ namespace Piko {
              */
             virtual void setFullscreen(bool flag) final;
 
+            /**
+             * Function to take the oldest recorded input events. The message handler records
+             * key, mouse, resize and focus events into a lock-free ring, so this function may be
+             * called from another thread than the one processing the messages, as long as it is
+             * always the same one.
+             *
+             * @param events Receives the events in the order they were received.
+             * @param count Maximum number of events to take.
+             *
+             * @return Number of events taken.
+             */
+            std::size_t pollInput(InputEvent* events, std::size_t count);
+
+            /**
+             * Function to get the number of input events dropped because the ring was full.
+             *
+             * @return Number of dropped events.
+             */
+            std::size_t getDroppedInputCount() const;
+
 
         protected:            
 
@@ -90,8 +152,9 @@ namespace Piko {
             virtual bool messageHandler(UINT msg, WPARAM wParam, LPARAM lParam);
 
             /**
-             * Function to handle the event when a key was pressed. It is recommended to override
-             * this function for a custom behaviour.
+             * Function to handle the event when a key was pressed. Called synchronously on the
+             * thread processing the messages, so keep overrides to window management and read
+             * game input with pollInput() instead.
              * 
              * @param keycode Key code to identify the pressed key.
              * 
@@ -103,21 +166,12 @@ namespace Piko {
 
         private:
 
-            /** 
-             * Window base class name. Each window appends its memory adress to this name for a 
-             * unique class name. 
-             **/
-            static const std::string CLASS_NAME_BASE;
+            /** Backends forward the messages to messageHandler(). */
+            friend class WindowBackend;
 
-            /** Mapping of window handles to actual window instances. */
-            static std::map<HWND, WindowBase *> mWindowRegistry;
-
-            HINSTANCE m_hInstance;      /**< Handle for the application instance. */
-            HWND m_hWnd;                /**< Handle to the window. */
-            WNDCLASSEXA m_wc;           /**< Window class structure. */
+            std::unique_ptr<WindowBackend> m_backend;   /**< Platform backend. */
 
             std::string m_title;        /**< Window title. */
-            std::string m_className;    /**< Name of the window class. */
 
             int m_width;                /**< Window width. */
             int m_height;               /**< Window height. */
@@ -127,29 +181,23 @@ namespace Piko {
             bool m_isClosed;            /**< Flag to indicate if the window is closed. */
             bool m_isFullscreen;        /**< Flag to indicate if window is in fullscreen mode. */
 
+            SPSCRing<InputEvent> m_input;               /**< Recorded input events. */
+            std::atomic<std::size_t> m_droppedInput;    /**< Events lost to a full ring. */
 
-            /**
-             * Function to dispatch sent messages to the right window instance.
-             * 
-             * @param hwnd Handle to the window which reveives the message.
-             * @param msg Message sent.
-             * @param wParam 
-             * @param lParam
-             */
-            static LRESULT CALLBACK staticWndProc(HWND hwnd, 
-                                                  UINT msg, 
-                                                  WPARAM wParam, 
-                                                  LPARAM lParam);
 
             /**
-             * Function to initialize the window class structure.
+             * Function to create the window using the backend.
              */
-            void initWindowClass();
+            void createWindow();
 
             /**
-             * Function to create the window setting the window handle.
+             * Function to record the input event of a message, if any.
+             *
+             * @param msg Code of incoming message.
+             * @param wParam
+             * @param lParam
              */
-            void createWindow();
+            void recordInput(UINT msg, WPARAM wParam, LPARAM lParam);
 
             /**
              * Copy constructor is forbidden.
@@ -0,0 +1,50 @@
+/**
+ * @file        WindowTypes.h
+ * @author      Robert Koch
+ * @version     1.0
+ *
+ * Platform independent access to the window types and message codes used in the public interface
+ * of the engine. On Windows this is simply windows.h. On other platforms the few types and
+ * constants the engine relies on are declared with the same names and values, so the window
+ * classes and their message handlers compile unchanged against the headless backend.
+ */
+#ifndef WINDOWTYPES_H
+#define WINDOWTYPES_H
+
+#if defined(_WIN32)
+
+#include <windows.h>
+
+#else
+
+#include <cstdint>
+
+typedef void* HWND;                 /**< Opaque window handle. */
+typedef void* HDC;                  /**< Opaque device context handle. */
+typedef unsigned int UINT;          /**< Message code. */
+typedef std::uintptr_t WPARAM;      /**< First message parameter. */
+typedef std::intptr_t LPARAM;       /**< Second message parameter. */
+typedef std::intptr_t LRESULT;      /**< Result of a window procedure. */
+
+#define WM_DESTROY          0x0002
+#define WM_SIZE             0x0005
+#define WM_SETFOCUS         0x0007
+#define WM_KILLFOCUS        0x0008
+#define WM_CLOSE            0x0010
+#define WM_KEYDOWN          0x0100
+#define WM_KEYUP            0x0101
+#define WM_MOUSEMOVE        0x0200
+#define WM_LBUTTONDOWN      0x0201
+#define WM_LBUTTONUP        0x0202
+#define WM_RBUTTONDOWN      0x0204
+#define WM_RBUTTONUP        0x0205
+#define WM_MBUTTONDOWN      0x0207
+#define WM_MBUTTONUP        0x0208
+#define WM_MOUSEWHEEL       0x020A
+
+#define VK_ESCAPE           0x1B
+#define VK_F1               0x70
+
+#endif
+
+#endif // End of WINDOWTYPES_H
@@ -0,0 +1,364 @@
+/**
+ * @file        AABB.h
+ * @author      Robert Koch
+ * @version     1.0
+ *
+ * This file contains the class declaration for an axis-aligned bounding box of 3-dimensional
+ * vectors and its intersection tests.
+ */
+#ifndef AABB_H
+#define AABB_H
+
+#include <algorithm>
+#include <limits>
+
+#include "Vector3D.h"
+
+
+namespace Piko {
+
+    /**
+     * Class declaring an axis-aligned bounding box given by its minimum and maximum corner. A
+     * default constructed box is empty: its minimum is larger than its maximum, so expanding it
+     * by a point yields a box containing exactly that point.
+     */
+    template<typename T>
+    class AABB final {
+
+        public:
+
+            /**
+             * Standard constructor to create an empty box.
+             */
+            AABB();
+
+            /**
+             * Constructor to create a box from its corners.
+             *
+             * @param min Minimum corner.
+             * @param max Maximum corner.
+             */
+            AABB(const Vector3D<T>& min, const Vector3D<T>& max);
+
+            /**
+             * Function to create the box enclosing a sphere.
+             *
+             * @param center Center of the sphere.
+             * @param radius Radius of the sphere.
+             * @return Enclosing box.
+             */
+            static AABB<T> fromSphere(const Vector3D<T>& center, const T& radius);
+
+            /**
+             * Functions to get the corners.
+             *
+             * @return Minimum or maximum corner.
+             */
+            const Vector3D<T>& getMin() const;
+            const Vector3D<T>& getMax() const;
+
+            /**
+             * Function to check if the box is empty.
+             *
+             * @return True if the minimum is larger than the maximum on any axis.
+             */
+            bool isEmpty() const;
+
+            /**
+             * Function to get the center of the box.
+             *
+             * @return Center point.
+             */
+            Vector3D<T> getCenter() const;
+
+            /**
+             * Function to get the size of the box along each axis.
+             *
+             * @return Difference of maximum and minimum.
+             */
+            Vector3D<T> getExtent() const;
+
+            /**
+             * Function to get the surface area, the cost measure of the surface area heuristic.
+             *
+             * @return Surface area, 0 for an empty box.
+             */
+            T getSurfaceArea() const;
+
+            /**
+             * Function to grow the box so it contains a point.
+             *
+             * @param p Point to include.
+             */
+            void expand(const Vector3D<T>& p);
+
+            /**
+             * Function to grow the box so it contains another box.
+             *
+             * @param box Box to include.
+             */
+            void expand(const AABB<T>& box);
+
+            /**
+             * Function to check if the box contains a point. Points on the surface are inside.
+             *
+             * @param p Point to check.
+             * @return True if the point is inside.
+             */
+            bool contains(const Vector3D<T>& p) const;
+
+            /**
+             * Function to check if the box overlaps another box. Touching boxes overlap.
+             *
+             * @param box Box to check.
+             * @return True if the boxes overlap.
+             */
+            bool intersects(const AABB<T>& box) const;
+
+            /**
+             * Function to check if the box overlaps a sphere.
+             *
+             * @param center Center of the sphere.
+             * @param radius Radius of the sphere.
+             * @return True if the box and the sphere overlap.
+             */
+            bool intersects(const Vector3D<T>& center, const T& radius) const;
+
+            /**
+             * Function to intersect the box with a ray using the slab test.
+             *
+             * @param origin Origin of the ray.
+             * @param invDirection Reciprocal of each coordinate of the ray direction.
+             * @param tMax Maximum ray parameter to consider.
+             * @param tEnter Receives the ray parameter where the ray enters the box, 0 if the
+             *               origin is inside.
+             * @return True if the ray hits the box between 0 and tMax.
+             */
+            bool intersectRay(const Vector3D<T>& origin, const Vector3D<T>& invDirection,
+                              const T& tMax, T& tEnter) const;
+
+            /**
+             * Function to get the squared distance of a point to the box.
+             *
+             * @param p Point to measure.
+             * @return Squared distance, 0 if the point is inside.
+             */
+            T getSquaredDistance(const Vector3D<T>& p) const;
+
+        private:
+
+            Vector3D<T> m_min;      /**< Minimum corner. */
+            Vector3D<T> m_max;      /**< Maximum corner. */
+
+    }; /* Class AABB */
+
+    /**
+     * Function to get the union of two boxes.
+     *
+     * @param a First box.
+     * @param b Second box.
+     * @return Smallest box containing both boxes.
+     */
+    template<typename T>
+    AABB<T> merge(const AABB<T>& a, const AABB<T>& b);
+
+
+
+    /*==========================================
+     * INLINE IMPLEMENTATION
+     *=========================================*/
+
+    template<typename T>
+    inline AABB<T>::AABB()
+      :
+      m_min(std::numeric_limits<T>::max(), std::numeric_limits<T>::max(),
+            std::numeric_limits<T>::max()),
+      m_max(std::numeric_limits<T>::lowest(), std::numeric_limits<T>::lowest(),
+            std::numeric_limits<T>::lowest()) {
+
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    template<typename T>
+    inline AABB<T>::AABB(const Vector3D<T>& min, const Vector3D<T>& max)
+      :
+      m_min(min),
+      m_max(max) {
+
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    template<typename T>
+    inline AABB<T> AABB<T>::fromSphere(const Vector3D<T>& center, const T& radius) {
+
+        return AABB<T>(Vector3D<T>(center.x() - radius, center.y() - radius, center.z() - radius),
+                       Vector3D<T>(center.x() + radius, center.y() + radius, center.z() + radius));
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    template<typename T>
+    inline const Vector3D<T>& AABB<T>::getMin() const {
+
+        return m_min;
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    template<typename T>
+    inline const Vector3D<T>& AABB<T>::getMax() const {
+
+        return m_max;
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    template<typename T>
+    inline bool AABB<T>::isEmpty() const {
+
+        return m_min.x() > m_max.x() || m_min.y() > m_max.y() || m_min.z() > m_max.z();
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    template<typename T>
+    inline Vector3D<T> AABB<T>::getCenter() const {
+
+        return Vector3D<T>((m_min.x() + m_max.x()) * T(0.5), (m_min.y() + m_max.y()) * T(0.5),
+                           (m_min.z() + m_max.z()) * T(0.5));
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    template<typename T>
+    inline Vector3D<T> AABB<T>::getExtent() const {
+
+        return Vector3D<T>(m_max.x() - m_min.x(), m_max.y() - m_min.y(), m_max.z() - m_min.z());
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    template<typename T>
+    inline T AABB<T>::getSurfaceArea() const {
+
+        if(isEmpty()) return T(0);
+
+        const Vector3D<T> e = getExtent();
+        return T(2) * (e.x() * e.y() + e.y() * e.z() + e.z() * e.x());
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    template<typename T>
+    inline void AABB<T>::expand(const Vector3D<T>& p) {
+
+        m_min.setPosition(std::min(m_min.x(), p.x()), std::min(m_min.y(), p.y()),
+                          std::min(m_min.z(), p.z()));
+        m_max.setPosition(std::max(m_max.x(), p.x()), std::max(m_max.y(), p.y()),
+                          std::max(m_max.z(), p.z()));
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    template<typename T>
+    inline void AABB<T>::expand(const AABB<T>& box) {
+
+        m_min.setPosition(std::min(m_min.x(), box.m_min.x()), std::min(m_min.y(), box.m_min.y()),
+                          std::min(m_min.z(), box.m_min.z()));
+        m_max.setPosition(std::max(m_max.x(), box.m_max.x()), std::max(m_max.y(), box.m_max.y()),
+                          std::max(m_max.z(), box.m_max.z()));
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    template<typename T>
+    inline bool AABB<T>::contains(const Vector3D<T>& p) const {
+
+        return p.x() >= m_min.x() && p.x() <= m_max.x() &&
+               p.y() >= m_min.y() && p.y() <= m_max.y() &&
+               p.z() >= m_min.z() && p.z() <= m_max.z();
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    template<typename T>
+    inline bool AABB<T>::intersects(const AABB<T>& box) const {
+
+        return m_min.x() <= box.m_max.x() && m_max.x() >= box.m_min.x() &&
+               m_min.y() <= box.m_max.y() && m_max.y() >= box.m_min.y() &&
+               m_min.z() <= box.m_max.z() && m_max.z() >= box.m_min.z();
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    template<typename T>
+    inline bool AABB<T>::intersects(const Vector3D<T>& center, const T& radius) const {
+
+        return getSquaredDistance(center) <= radius * radius;
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    template<typename T>
+    inline bool AABB<T>::intersectRay(const Vector3D<T>& origin, const Vector3D<T>& invDirection,
+                                      const T& tMax, T& tEnter) const {
+
+        const T x0 = (m_min.x() - origin.x()) * invDirection.x();
+        const T x1 = (m_max.x() - origin.x()) * invDirection.x();
+        const T y0 = (m_min.y() - origin.y()) * invDirection.y();
+        const T y1 = (m_max.y() - origin.y()) * invDirection.y();
+        const T z0 = (m_min.z() - origin.z()) * invDirection.z();
+        const T z1 = (m_max.z() - origin.z()) * invDirection.z();
+
+        const T tNear = std::max(std::max(std::min(x0, x1), std::min(y0, y1)),
+                                 std::max(std::min(z0, z1), T(0)));
+        const T tFar = std::min(std::min(std::max(x0, x1), std::max(y0, y1)),
+                                std::min(std::max(z0, z1), tMax));
+
+        tEnter = tNear;
+        return tNear <= tFar;
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    template<typename T>
+    inline T AABB<T>::getSquaredDistance(const Vector3D<T>& p) const {
+
+        const T dx = std::max(std::max(m_min.x() - p.x(), p.x() - m_max.x()), T(0));
+        const T dy = std::max(std::max(m_min.y() - p.y(), p.y() - m_max.y()), T(0));
+        const T dz = std::max(std::max(m_min.z() - p.z(), p.z() - m_max.z()), T(0));
+
+        return dx * dx + dy * dy + dz * dz;
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    template<typename T>
+    inline AABB<T> merge(const AABB<T>& a, const AABB<T>& b) {
+
+        AABB<T> box(a);
+        box.expand(b);
+        return box;
+    }
+
+} /* Namespace Piko */
+
+#endif // End of AABB_H
@@ -0,0 +1,812 @@
+/**
+ * @file        BVH.h
+ * @author      Robert Koch
+ * @version     1.0
+ *
+ * This file contains a bounding volume hierarchy over axis-aligned boxes, answering box, sphere
+ * and ray queries over large sets of primitives.
+ */
+#ifndef BVH_H
+#define BVH_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "AABB.h"
+#include "Vector3D.h"
+
+
+namespace Piko {
+
+    /**
+     * Bounding volume hierarchy over the boxes of a set of primitives. Primitives are identified
+     * by their index in the array passed to build(). The tree is built top-down with the binned
+     * surface area heuristic and stored flattened in depth-first order: the left child of an
+     * inner node directly follows it and only the distance to the right child is stored, so a
+     * node takes 32 bytes for float and traversal mostly walks forward through memory.
+     *
+     * Moving primitives are handled by refit(), which recomputes all bounds bottom-up in linear
+     * time but keeps the topology. The tree quality degrades with large movements, rebuild once
+     * getCost() grew noticeably compared to the value after the last build().
+     */
+    template<typename T>
+    class BVH final {
+
+        public:
+
+            /** Maximum number of primitives in a leaf, unless the depth limit is reached. */
+            static const std::size_t MAX_LEAF_SIZE = 4;
+
+            /** Maximum depth of the tree, which bounds the traversal stacks. */
+            static const std::size_t MAX_DEPTH = 64;
+
+            /** Number of bins evaluated per split by the surface area heuristic. */
+            static const std::size_t SAH_BINS = 16;
+
+            /** Number of primitives from which subtrees are built as parallel jobs. */
+            static const std::size_t PARALLEL_THRESHOLD = 8192;
+
+            /**
+             * Node of the flattened tree.
+             */
+            struct Node {
+                AABB<T> bounds;             /**< Bounds of all primitives below the node. */
+                std::uint32_t offset;       /**< Leaf: first entry in getIndices(), inner node:
+                                                 distance to the right child. */
+                std::uint32_t count;        /**< Number of primitives of a leaf, 0 if inner. */
+            };
+
+            /**
+             * Standard constructor to create an empty hierarchy.
+             */
+            BVH();
+
+            /**
+             * Function to build the hierarchy over a set of primitives.
+             *
+             * @param boxes Bounding boxes of the primitives, copied into the hierarchy.
+             * @param count Number of primitives.
+             * @throws std::invalid_argument If count does not fit into 32 bits.
+             */
+            void build(const AABB<T>* boxes, std::size_t count);
+
+            /**
+             * Function to build the hierarchy over a set of primitives, large subtrees in
+             * parallel.
+             *
+             * @param boxes Bounding boxes of the primitives, copied into the hierarchy.
+             * @param count Number of primitives.
+             * @param jobs Job system, or NULL to build serially. Any type with a member
+             *             fork(first, second) which runs both callables and returns after both
+             *             finished, e.g. JobSystem.
+             * @throws std::invalid_argument If count does not fit into 32 bits.
+             */
+            template<typename Jobs>
+            void build(const AABB<T>* boxes, std::size_t count, Jobs* jobs);
+
+            /**
+             * Function to replace the boxes of all primitives and refit the hierarchy.
+             *
+             * @param boxes New bounding boxes in the order passed to build().
+             */
+            void refit(const AABB<T>* boxes);
+
+            /**
+             * Function to replace the box of a single primitive. The hierarchy is only correct
+             * again after the next refit().
+             *
+             * @param primitive Index of the primitive.
+             * @param box New bounding box.
+             */
+            void setBox(std::size_t primitive, const AABB<T>& box);
+
+            /**
+             * Function to recompute the bounds of all nodes bottom-up from the primitive boxes.
+             */
+            void refit();
+
+            /**
+             * Function to remove all primitives.
+             */
+            void clear();
+
+            /**
+             * Function to call a callback for each primitive whose box overlaps a box.
+             *
+             * @param box Box to query.
+             * @param callback Callable taking the index of a primitive.
+             */
+            template<typename F>
+            void queryBox(const AABB<T>& box, F callback) const;
+
+            /**
+             * Function to call a callback for each primitive whose box overlaps a sphere.
+             *
+             * @param center Center of the sphere.
+             * @param radius Radius of the sphere.
+             * @param callback Callable taking the index of a primitive.
+             */
+            template<typename F>
+            void querySphere(const Vector3D<T>& center, const T& radius, F callback) const;
+
+            /**
+             * Function to call a callback for each primitive whose box is hit by a ray. Nodes are
+             * visited near to far, and nodes behind the distance returned by the callback are
+             * skipped, so a callback intersecting the actual geometry finds the closest hit
+             * without visiting all candidates.
+             *
+             * @param origin Origin of the ray.
+             * @param direction Direction of the ray, does not need to be normalized.
+             * @param tMax Maximum ray parameter.
+             * @param callback Callable taking the index of a primitive and the ray parameter
+             *                 where the ray enters its box, returning the new maximum parameter.
+             */
+            template<typename F>
+            void queryRay(const Vector3D<T>& origin, const Vector3D<T>& direction, T tMax,
+                          F callback) const;
+
+            /**
+             * Function to find the primitive box hit first by a ray.
+             *
+             * @param origin Origin of the ray.
+             * @param direction Direction of the ray, does not need to be normalized.
+             * @param tMax Maximum ray parameter.
+             * @param primitive Receives the index of the primitive hit first.
+             * @param t Receives the ray parameter of the hit.
+             * @return True if a box was hit.
+             */
+            bool raycast(const Vector3D<T>& origin, const Vector3D<T>& direction, const T& tMax,
+                         std::size_t& primitive, T& t) const;
+
+            /**
+             * Function to get the number of primitives.
+             *
+             * @return Number of primitives.
+             */
+            std::size_t size() const;
+
+            /**
+             * Function to get the bounds of all primitives.
+             *
+             * @return Bounds of the root, empty if there are no primitives.
+             */
+            AABB<T> getBounds() const;
+
+            /**
+             * Function to get the flattened nodes, the root first.
+             *
+             * @return Nodes in depth-first order.
+             */
+            const std::vector<Node>& getNodes() const;
+
+            /**
+             * Function to get the primitive indices referenced by the leaves.
+             *
+             * @return Primitive indices grouped by leaf.
+             */
+            const std::vector<std::uint32_t>& getIndices() const;
+
+            /**
+             * Function to estimate the cost of a query with the surface area heuristic, counting
+             * one unit per visited node and per tested primitive.
+             *
+             * @return Expected cost of a random query hitting the root.
+             */
+            T getCost() const;
+
+        private:
+
+            /**
+             * Bin of the surface area heuristic.
+             */
+            struct Bin {
+                AABB<T> bounds;             /**< Bounds of the primitives in the bin. */
+                AABB<T> centroidBounds;     /**< Bounds of their centroids. */
+                std::size_t count;          /**< Number of primitives in the bin. */
+            };
+
+            /**
+             * Job system of the serial build, running both parts on the calling thread.
+             */
+            struct SerialJobs {
+                template<typename A, typename B>
+                void fork(const A& first, const B& second) const {
+                    first();
+                    second();
+                }
+            };
+
+            /**
+             * Primitive sorted during the build, the data is moved with the index so the passes
+             * over a range read memory sequentially.
+             */
+            struct Primitive {
+                AABB<T> box;                /**< Box of the primitive. */
+                Vector3D<T> centroid;       /**< Center of the box. */
+                std::uint32_t index;        /**< Index of the primitive. */
+            };
+
+            /**
+             * Range of primitives covered by a subtree.
+             */
+            struct Range {
+                std::size_t begin;          /**< First entry of the range. */
+                std::size_t end;            /**< Entry behind the range. */
+                AABB<T> bounds;             /**< Bounds of the primitives. */
+                AABB<T> centroidBounds;     /**< Bounds of their centroids. */
+            };
+
+            std::vector<Node> m_nodes;              /**< Flattened tree. */
+            std::vector<std::uint32_t> m_indices;   /**< Primitive indices grouped by leaf. */
+            std::vector<std::uint32_t> m_slots;     /**< Entry of each primitive in m_indices. */
+            std::vector<AABB<T>> m_boxes;           /**< Primitive boxes in m_indices order. */
+
+            /**
+             * Function to build the subtree over a range of m_indices.
+             *
+             * @param nodes Receives the nodes of the subtree.
+             * @param primitives Primitives in build order.
+             * @param range Range of the subtree.
+             * @param depth Depth of the subtree root.
+             * @param jobs Job system building large subtrees in parallel, or NULL.
+             */
+            template<typename Jobs>
+            void buildRange(std::vector<Node>& nodes, Primitive* primitives,
+                            const Range& range, std::size_t depth, Jobs* jobs);
+
+            /**
+             * Function to split a range with the surface area heuristic. The children receive
+             * their bounds from the bins, so no extra pass over the primitives is needed.
+             *
+             * @param primitives Primitives in build order.
+             * @param range Range to split.
+             * @param children Receives the left and the right part.
+             * @return Cost of the split relative to testing all primitives, negative if the
+             *         centroids coincide and the range was not partitioned.
+             */
+            T split(Primitive* primitives, const Range& range, Range* children) const;
+
+            /**
+             * Function to compute the bounds of a range.
+             *
+             * @param primitives Primitives in build order.
+             * @param range Range whose bounds are computed.
+             */
+            void computeBounds(const Primitive* primitives, Range& range) const;
+
+            /**
+             * Function to get the bin of a centroid.
+             */
+            static std::size_t getBin(const Vector3D<T>& centroid, int axis, const T& min,
+                                      const T& scale);
+
+            /**
+             * Function to get a coordinate by axis index.
+             */
+            static T getAxis(const Vector3D<T>& v, int axis);
+
+    }; /* Class BVH */
+
+
+
+    /*==========================================
+     * INLINE IMPLEMENTATION
+     *=========================================*/
+
+    template<typename T>
+    const std::size_t BVH<T>::MAX_LEAF_SIZE;
+
+    template<typename T>
+    const std::size_t BVH<T>::MAX_DEPTH;
+
+    template<typename T>
+    const std::size_t BVH<T>::SAH_BINS;
+
+    template<typename T>
+    const std::size_t BVH<T>::PARALLEL_THRESHOLD;
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    template<typename T>
+    inline BVH<T>::BVH() {
+
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    template<typename T>
+    inline void BVH<T>::build(const AABB<T>* boxes, std::size_t count) {
+
+        build(boxes, count, (SerialJobs*)NULL);
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    template<typename T>
+    template<typename Jobs>
+    inline void BVH<T>::build(const AABB<T>* boxes, std::size_t count, Jobs* jobs) {
+
+        if(count > std::numeric_limits<std::uint32_t>::max()) {
+            throw std::invalid_argument("BVH::build: Too many primitives.");
+        }
+
+        m_nodes.clear();
+        m_indices.resize(count);
+        m_slots.resize(count);
+        m_boxes.resize(count);
+        if(count == 0) return;
+
+        std::vector<Primitive> primitives(count);
+        for(std::size_t i = 0; i < count; ++i) {
+            primitives[i].box = boxes[i];
+            primitives[i].centroid = boxes[i].getCenter();
+            primitives[i].index = (std::uint32_t)i;
+        }
+
+        Range range;
+        range.begin = 0;
+        range.end = count;
+        computeBounds(&primitives[0], range);
+
+        m_nodes.reserve(2 * count);
+        buildRange(m_nodes, &primitives[0], range, 0, jobs);
+
+        // Leaves test their boxes in sequence, so the boxes are stored in leaf order.
+        for(std::size_t i = 0; i < count; ++i) {
+            m_indices[i] = primitives[i].index;
+            m_slots[primitives[i].index] = (std::uint32_t)i;
+            m_boxes[i] = primitives[i].box;
+        }
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    template<typename T>
+    inline void BVH<T>::refit(const AABB<T>* boxes) {
+
+        for(std::size_t i = 0; i < m_boxes.size(); ++i) m_boxes[i] = boxes[m_indices[i]];
+        refit();
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    template<typename T>
+    inline void BVH<T>::setBox(std::size_t primitive, const AABB<T>& box) {
+
+        m_boxes[m_slots[primitive]] = box;
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    template<typename T>
+    inline void BVH<T>::refit() {
+
+        // Children always follow their parent, so a backward sweep visits them first.
+        for(std::size_t i = m_nodes.size(); i-- > 0;) {
+            Node& node = m_nodes[i];
+            AABB<T> bounds;
+
+            if(node.count) {
+                for(std::size_t j = node.offset; j < node.offset + node.count; ++j) {
+                    bounds.expand(m_boxes[j]);
+                }
+            }
+            else {
+                bounds = merge(m_nodes[i + 1].bounds, m_nodes[i + node.offset].bounds);
+            }
+
+            node.bounds = bounds;
+        }
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    template<typename T>
+    inline void BVH<T>::clear() {
+
+        m_nodes.clear();
+        m_indices.clear();
+        m_slots.clear();
+        m_boxes.clear();
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    template<typename T>
+    template<typename F>
+    inline void BVH<T>::queryBox(const AABB<T>& box, F callback) const {
+
+        if(m_nodes.empty()) return;
+
+        std::uint32_t stack[MAX_DEPTH];
+        std::size_t top = 0;
+        std::uint32_t i = 0;
+
+        for(;;) {
+            const Node& node = m_nodes[i];
+
+            if(node.bounds.intersects(box)) {
+                if(!node.count) {
+                    stack[top++] = i + node.offset;
+                    ++i;
+                    continue;
+                }
+
+                for(std::size_t j = node.offset; j < node.offset + node.count; ++j) {
+                    if(m_boxes[j].intersects(box)) callback((std::size_t)m_indices[j]);
+                }
+            }
+
+            if(top == 0) break;
+            i = stack[--top];
+        }
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    template<typename T>
+    template<typename F>
+    inline void BVH<T>::querySphere(const Vector3D<T>& center, const T& radius,
+                                    F callback) const {
+
+        if(m_nodes.empty()) return;
+
+        std::uint32_t stack[MAX_DEPTH];
+        std::size_t top = 0;
+        std::uint32_t i = 0;
+
+        for(;;) {
+            const Node& node = m_nodes[i];
+
+            if(node.bounds.intersects(center, radius)) {
+                if(!node.count) {
+                    stack[top++] = i + node.offset;
+                    ++i;
+                    continue;
+                }
+
+                for(std::size_t j = node.offset; j < node.offset + node.count; ++j) {
+                    if(m_boxes[j].intersects(center, radius)) {
+                        callback((std::size_t)m_indices[j]);
+                    }
+                }
+            }
+
+            if(top == 0) break;
+            i = stack[--top];
+        }
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    template<typename T>
+    template<typename F>
+    inline void BVH<T>::queryRay(const Vector3D<T>& origin, const Vector3D<T>& direction, T tMax,
+                                 F callback) const {
+
+        if(m_nodes.empty()) return;
+
+        const Vector3D<T> inv(T(1) / direction.x(), T(1) / direction.y(), T(1) / direction.z());
+
+        T t;
+        if(!m_nodes[0].bounds.intersectRay(origin, inv, tMax, t)) return;
+
+        // Each entry keeps the distance to its box, so entries behind a closer hit are skipped.
+        std::pair<std::uint32_t, T> stack[MAX_DEPTH];
+        std::size_t top = 0;
+        std::uint32_t i = 0;
+
+        for(;;) {
+            const Node& node = m_nodes[i];
+
+            if(node.count) {
+                for(std::size_t j = node.offset; j < node.offset + node.count; ++j) {
+                    if(m_boxes[j].intersectRay(origin, inv, tMax, t)) {
+                        tMax = callback((std::size_t)m_indices[j], t);
+                    }
+                }
+            }
+            else {
+                std::uint32_t nearChild = i + 1;
+                std::uint32_t farChild = i + node.offset;
+                T tNear;
+                T tFar;
+                const bool isNearHit =
+                    m_nodes[nearChild].bounds.intersectRay(origin, inv, tMax, tNear);
+                const bool isFarHit =
+                    m_nodes[farChild].bounds.intersectRay(origin, inv, tMax, tFar);
+
+                if(isNearHit && isFarHit) {
+                    if(tFar < tNear) {
+                        std::swap(nearChild, farChild);
+                        std::swap(tNear, tFar);
+                    }
+
+                    stack[top++] = std::make_pair(farChild, tFar);
+                    i = nearChild;
+                    continue;
+                }
+
+                if(isNearHit || isFarHit) {
+                    i = isNearHit ? nearChild : farChild;
+                    continue;
+                }
+            }
+
+            while(top > 0 && stack[top - 1].second > tMax) --top;
+            if(top == 0) break;
+            i = stack[--top].first;
+        }
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    template<typename T>
+    inline bool BVH<T>::raycast(const Vector3D<T>& origin, const Vector3D<T>& direction,
+                                const T& tMax, std::size_t& primitive, T& t) const {
+
+        bool isHit = false;
+
+        queryRay(origin, direction, tMax, [&](std::size_t candidate, const T& tEnter) {
+            isHit = true;
+            primitive = candidate;
+            t = tEnter;
+            return tEnter;
+        });
+
+        return isHit;
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    template<typename T>
+    inline std::size_t BVH<T>::size() const {
+
+        return m_boxes.size();
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    template<typename T>
+    inline AABB<T> BVH<T>::getBounds() const {
+
+        return m_nodes.empty() ? AABB<T>() : m_nodes[0].bounds;
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    template<typename T>
+    inline const std::vector<typename BVH<T>::Node>& BVH<T>::getNodes() const {
+
+        return m_nodes;
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    template<typename T>
+    inline const std::vector<std::uint32_t>& BVH<T>::getIndices() const {
+
+        return m_indices;
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    template<typename T>
+    inline T BVH<T>::getCost() const {
+
+        if(m_nodes.empty()) return T(0);
+
+        const T rootArea = m_nodes[0].bounds.getSurfaceArea();
+        if(rootArea <= T(0)) return T(m_nodes.size() + m_boxes.size());
+
+        T cost = T(0);
+        for(std::size_t i = 0; i < m_nodes.size(); ++i) {
+            const Node& node = m_nodes[i];
+            cost += node.bounds.getSurfaceArea() * T(1 + node.count);
+        }
+
+        return cost / rootArea;
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    template<typename T>
+    template<typename Jobs>
+    inline void BVH<T>::buildRange(std::vector<Node>& nodes, Primitive* primitives,
+                                   const Range& range, std::size_t depth, Jobs* jobs) {
+
+        const std::size_t count = range.end - range.begin;
+        const std::size_t index = nodes.size();
+
+        Node leaf = { range.bounds, (std::uint32_t)range.begin, (std::uint32_t)count };
+        if(count == 1 || depth + 1 >= MAX_DEPTH) {
+            nodes.push_back(leaf);
+            return;
+        }
+
+        Range children[2];
+        const T cost = split(primitives, range, children);
+
+        // Leaf cost is one unit per primitive, a split costs one unit plus its children.
+        if(count <= MAX_LEAF_SIZE && (cost < T(0) || cost >= T(count))) {
+            nodes.push_back(leaf);
+            return;
+        }
+
+        if(cost < T(0) || children[0].begin == children[0].end ||
+           children[1].begin == children[1].end) {
+            children[0].begin = range.begin;
+            children[0].end = range.begin + count / 2;
+            children[1].begin = children[0].end;
+            children[1].end = range.end;
+            computeBounds(primitives, children[0]);
+            computeBounds(primitives, children[1]);
+        }
+
+        Node inner = { range.bounds, 0, 0 };
+        nodes.push_back(inner);
+
+        if(jobs && count >= PARALLEL_THRESHOLD) {
+            std::vector<Node> right;
+
+            auto buildLeft = [&]() {
+                buildRange(nodes, primitives, children[0], depth + 1, jobs);
+            };
+            auto buildRight = [&]() {
+                right.reserve(2 * (children[1].end - children[1].begin));
+                buildRange(right, primitives, children[1], depth + 1, jobs);
+            };
+
+            jobs->fork(buildLeft, buildRight);
+
+            // Offsets are relative, so the right subtree is position independent.
+            nodes[index].offset = (std::uint32_t)(nodes.size() - index);
+            nodes.insert(nodes.end(), right.begin(), right.end());
+        }
+        else {
+            buildRange(nodes, primitives, children[0], depth + 1, jobs);
+            nodes[index].offset = (std::uint32_t)(nodes.size() - index);
+            buildRange(nodes, primitives, children[1], depth + 1, jobs);
+        }
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    template<typename T>
+    inline T BVH<T>::split(Primitive* primitives, const Range& range,
+                           Range* children) const {
+
+        const Vector3D<T> extent = range.centroidBounds.getExtent();
+        int axis = 0;
+        if(extent.y() > getAxis(extent, axis)) axis = 1;
+        if(extent.z() > getAxis(extent, axis)) axis = 2;
+
+        if(!(getAxis(extent, axis) > T(0))) return T(-1);
+
+        Bin bins[SAH_BINS];
+        for(std::size_t b = 0; b < SAH_BINS; ++b) bins[b].count = 0;
+
+        const T min = getAxis(range.centroidBounds.getMin(), axis);
+        const T scale = T(SAH_BINS) / getAxis(extent, axis);
+
+        for(std::size_t i = range.begin; i < range.end; ++i) {
+            const Primitive& primitive = primitives[i];
+            Bin& bin = bins[getBin(primitive.centroid, axis, min, scale)];
+            bin.bounds.expand(primitive.box);
+            bin.centroidBounds.expand(primitive.centroid);
+            ++bin.count;
+        }
+
+        // Sweep from the right to collect the cost of all right sides, then from the left.
+        T rightCost[SAH_BINS];
+        AABB<T> rightBounds;
+        std::size_t rightCount = 0;
+
+        for(std::size_t b = SAH_BINS - 1; b > 0; --b) {
+            rightBounds.expand(bins[b].bounds);
+            rightCount += bins[b].count;
+            rightCost[b] = rightBounds.getSurfaceArea() * T(rightCount);
+        }
+
+        AABB<T> leftBounds;
+        std::size_t leftCount = 0;
+        T bestCost = std::numeric_limits<T>::max();
+        std::size_t best = 0;
+
+        for(std::size_t b = 0; b + 1 < SAH_BINS; ++b) {
+            leftBounds.expand(bins[b].bounds);
+            leftCount += bins[b].count;
+
+            const T cost = leftBounds.getSurfaceArea() * T(leftCount) + rightCost[b + 1];
+            if(cost < bestCost) {
+                bestCost = cost;
+                best = b;
+            }
+        }
+
+        const std::size_t count = range.end - range.begin;
+        const T area = range.bounds.getSurfaceArea();
+        const T cost = area > T(0) ? T(1) + bestCost / area : T(1) + T(count);
+
+        // A range small enough for a leaf is only partitioned if splitting pays off.
+        if(count <= MAX_LEAF_SIZE && cost >= T(count)) return cost;
+
+        for(std::size_t b = 0; b < SAH_BINS; ++b) {
+            Range& child = children[b <= best ? 0 : 1];
+            child.bounds.expand(bins[b].bounds);
+            child.centroidBounds.expand(bins[b].centroidBounds);
+        }
+
+        Primitive* first = primitives + range.begin;
+        Primitive* middle = std::partition(first, first + count, [&](const Primitive& p) {
+            return getBin(p.centroid, axis, min, scale) <= best;
+        });
+
+        children[0].begin = range.begin;
+        children[0].end = range.begin + (middle - first);
+        children[1].begin = children[0].end;
+        children[1].end = range.end;
+        return cost;
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    template<typename T>
+    inline void BVH<T>::computeBounds(const Primitive* primitives, Range& range) const {
+
+        range.bounds = AABB<T>();
+        range.centroidBounds = AABB<T>();
+
+        for(std::size_t i = range.begin; i < range.end; ++i) {
+            range.bounds.expand(primitives[i].box);
+            range.centroidBounds.expand(primitives[i].centroid);
+        }
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    template<typename T>
+    inline std::size_t BVH<T>::getBin(const Vector3D<T>& centroid, int axis, const T& min,
+                                      const T& scale) {
+
+        const T bin = (getAxis(centroid, axis) - min) * scale;
+        return bin > T(0) ? std::min((std::size_t)bin, SAH_BINS - 1) : 0;
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    template<typename T>
+    inline T BVH<T>::getAxis(const Vector3D<T>& v, int axis) {
+
+        return axis == 0 ? v.x() : (axis == 1 ? v.y() : v.z());
+    }
+
+} /* Namespace Piko */
+
+#endif // End of BVH_H
@@ -0,0 +1,418 @@
+/**
+ * @file        Frustum.h
+ * @author      Robert Koch
+ * @version     1.0
+ *
+ * This file contains the class declaration for a view frustum given by six planes together with
+ * the stream kernels testing structure-of-arrays bounding volumes against it.
+ */
+#ifndef FRUSTUM_H
+#define FRUSTUM_H
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+#include "AABB.h"
+#include "Matrix4x4.h"
+#include "SIMD.h"
+#include "Vector3D.h"
+
+
+namespace Piko {
+
+    /**
+     * Class declaring a view frustum as six planes with normals pointing inwards. A point p is
+     * inside a plane if n * p + d >= 0. The planes are stored as structure of arrays, so the
+     * kernels broadcast each coefficient once and test whole packs of volumes against it.
+     */
+    template<typename T>
+    class Frustum final {
+
+        public:
+
+            /** Indices of the planes. */
+            enum Plane {
+                PLANE_LEFT,
+                PLANE_RIGHT,
+                PLANE_BOTTOM,
+                PLANE_TOP,
+                PLANE_NEAR,
+                PLANE_FAR,
+                PLANE_COUNT
+            };
+
+            /**
+             * Standard constructor to create a frustum containing all of space.
+             */
+            Frustum();
+
+            /**
+             * Constructor to extract the planes of a combined view and projection matrix using
+             * the method of Gribb and Hartmann. The planes are normalized, so the plane
+             * distances are euclidean and spheres can be tested by their radius.
+             *
+             * @param viewProjection Projection matrix multiplied with the view matrix, mapping to
+             *                       OpenGL clip space.
+             */
+            explicit Frustum(const Matrix4x4<T>& viewProjection);
+
+            /**
+             * Function to set a plane.
+             *
+             * @param plane Index of the plane.
+             * @param normal Normal pointing into the frustum, should be normalized.
+             * @param distance Plane coefficient d.
+             */
+            void setPlane(Plane plane, const Vector3D<T>& normal, const T& distance);
+
+            /**
+             * Functions to get the coefficients of a plane.
+             *
+             * @param plane Index of the plane.
+             * @return Normal pointing into the frustum or plane coefficient d.
+             */
+            Vector3D<T> getNormal(Plane plane) const;
+            const T& getDistance(Plane plane) const;
+
+            /**
+             * Function to check if a sphere is at least partially inside. The test is
+             * conservative: spheres near the corners may pass although they are outside.
+             *
+             * @param center Center of the sphere.
+             * @param radius Radius of the sphere.
+             * @return False if the sphere is completely outside one of the planes.
+             */
+            bool isVisible(const Vector3D<T>& center, const T& radius) const;
+
+            /**
+             * Function to check if a box given by its center and half extent is at least
+             * partially inside. The test is conservative like the one for spheres.
+             *
+             * @param center Center of the box.
+             * @param halfExtent Half of the size of the box along each axis.
+             * @return False if the box is completely outside one of the planes.
+             */
+            bool isVisible(const Vector3D<T>& center, const Vector3D<T>& halfExtent) const;
+
+            /**
+             * Function to check if a box is at least partially inside.
+             *
+             * @param box Box to check.
+             * @return False if the box is completely outside one of the planes.
+             */
+            bool isVisible(const AABB<T>& box) const;
+
+        private:
+
+            T m_a[PLANE_COUNT];     /**< X coordinates of the normals. */
+            T m_b[PLANE_COUNT];     /**< Y coordinates of the normals. */
+            T m_c[PLANE_COUNT];     /**< Z coordinates of the normals. */
+            T m_d[PLANE_COUNT];     /**< Plane coefficients d. */
+
+    }; /* Class Frustum */
+
+
+
+    /*==========================================
+     * INLINE IMPLEMENTATION
+     *=========================================*/
+
+    template<typename T>
+    inline Frustum<T>::Frustum() {
+
+        for(int i = 0; i < PLANE_COUNT; ++i) {
+            m_a[i] = m_b[i] = m_c[i] = T(0);
+            m_d[i] = T(1);
+        }
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    template<typename T>
+    inline Frustum<T>::Frustum(const Matrix4x4<T>& viewProjection) {
+
+        using std::sqrt;
+
+        const Matrix4x4<T>& m = viewProjection;
+
+        // Clip space keeps -w <= x, y, z <= w, so each plane is the last row plus or minus one of
+        // the others.
+        for(int i = 0; i < PLANE_COUNT; ++i) {
+            const int row = i / 2;
+            const T sign = (i % 2 == 0) ? T(1) : T(-1);
+
+            const T a = m(3, 0) + sign * m(row, 0);
+            const T b = m(3, 1) + sign * m(row, 1);
+            const T c = m(3, 2) + sign * m(row, 2);
+            const T d = m(3, 3) + sign * m(row, 3);
+            const T length = static_cast<T>(sqrt(a * a + b * b + c * c));
+            const T inv = length > T(0) ? T(1) / length : T(0);
+
+            m_a[i] = a * inv;
+            m_b[i] = b * inv;
+            m_c[i] = c * inv;
+            m_d[i] = d * inv;
+        }
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    template<typename T>
+    inline void Frustum<T>::setPlane(Plane plane, const Vector3D<T>& normal, const T& distance) {
+
+        m_a[plane] = normal.x();
+        m_b[plane] = normal.y();
+        m_c[plane] = normal.z();
+        m_d[plane] = distance;
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    template<typename T>
+    inline Vector3D<T> Frustum<T>::getNormal(Plane plane) const {
+
+        return Vector3D<T>(m_a[plane], m_b[plane], m_c[plane]);
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    template<typename T>
+    inline const T& Frustum<T>::getDistance(Plane plane) const {
+
+        return m_d[plane];
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    template<typename T>
+    inline bool Frustum<T>::isVisible(const Vector3D<T>& center, const T& radius) const {
+
+        for(int i = 0; i < PLANE_COUNT; ++i) {
+            const T dist = m_a[i] * center.x() + m_b[i] * center.y() + m_c[i] * center.z() +
+                           m_d[i];
+            if(dist < -radius) return false;
+        }
+        return true;
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    template<typename T>
+    inline bool Frustum<T>::isVisible(const Vector3D<T>& center,
+                                      const Vector3D<T>& halfExtent) const {
+
+        using std::abs;
+
+        // Projected radius of the box onto the plane normal.
+        for(int i = 0; i < PLANE_COUNT; ++i) {
+            const T dist = m_a[i] * center.x() + m_b[i] * center.y() + m_c[i] * center.z() +
+                           m_d[i];
+            const T radius = abs(m_a[i]) * halfExtent.x() + abs(m_b[i]) * halfExtent.y() +
+                             abs(m_c[i]) * halfExtent.z();
+            if(dist < -radius) return false;
+        }
+        return true;
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    template<typename T>
+    inline bool Frustum<T>::isVisible(const AABB<T>& box) const {
+
+        const Vector3D<T> e = box.getExtent();
+        return isVisible(box.getCenter(), Vector3D<T>(e.x() * T(0.5), e.y() * T(0.5),
+                                                      e.z() * T(0.5)));
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    namespace detail {
+
+        /**
+         * Function to test spheres given as streams against a frustum and write the indices of
+         * the visible ones. out must provide space for n indices, the number actually written is
+         * returned.
+         *
+         * @param frustum Frustum to test against.
+         * @param x, y, z Coordinate streams of the centers.
+         * @param r Radius stream.
+         * @param first Index written for the first sphere of the streams.
+         * @param out Destination of the visible indices.
+         * @param n Number of spheres.
+         * @return Number of visible spheres.
+         */
+        template<typename T>
+        inline std::size_t cullSphereStreams(const Frustum<T>& frustum,
+                                             const T* x, const T* y, const T* z, const T* r,
+                                             std::uint32_t first, std::uint32_t* out,
+                                             std::size_t n) {
+
+            std::size_t count = 0;
+            for(std::size_t i = 0; i < n; ++i) {
+                out[count] = first + (std::uint32_t)i;
+                count += frustum.isVisible(Vector3D<T>(x[i], y[i], z[i]), r[i]) ? 1 : 0;
+            }
+            return count;
+        }
+
+        /**
+         * Function to test boxes given as center and half extent streams against a frustum and
+         * write the indices of the visible ones. out must provide space for n indices.
+         *
+         * @param frustum Frustum to test against.
+         * @param cx, cy, cz Coordinate streams of the centers.
+         * @param ex, ey, ez Coordinate streams of the half extents.
+         * @param first Index written for the first box of the streams.
+         * @param out Destination of the visible indices.
+         * @param n Number of boxes.
+         * @return Number of visible boxes.
+         */
+        template<typename T>
+        inline std::size_t cullBoxStreams(const Frustum<T>& frustum,
+                                          const T* cx, const T* cy, const T* cz,
+                                          const T* ex, const T* ey, const T* ez,
+                                          std::uint32_t first, std::uint32_t* out,
+                                          std::size_t n) {
+
+            std::size_t count = 0;
+            for(std::size_t i = 0; i < n; ++i) {
+                const Vector3D<T> c(cx[i], cy[i], cz[i]);
+                const Vector3D<T> e(ex[i], ey[i], ez[i]);
+                out[count] = first + (std::uint32_t)i;
+                count += frustum.isVisible(c, e) ? 1 : 0;
+            }
+            return count;
+        }
+
+#if defined(PIKO_SIMD_AVX) || defined(PIKO_SIMD_SSE)
+
+        /**
+         * Function to append the indices of the set bits of a pack mask without branching. Up
+         * to PACK_SIZE indices are written, the count only advances for the visible ones.
+         */
+        inline std::size_t compactMask(int visible, std::uint32_t index, std::uint32_t* out,
+                                       std::size_t count) {
+
+            for(std::size_t k = 0; k < simd::PACK_SIZE; ++k) {
+                out[count] = index + (std::uint32_t)k;
+                count += (std::size_t)((visible >> k) & 1);
+            }
+            return count;
+        }
+
+        inline std::size_t cullSphereStreams(const Frustum<float>& frustum,
+                                             const float* x, const float* y, const float* z,
+                                             const float* r, std::uint32_t first,
+                                             std::uint32_t* out, std::size_t n) {
+
+            typedef Frustum<float> F;
+
+            simd::Pack a[F::PLANE_COUNT], b[F::PLANE_COUNT], c[F::PLANE_COUNT];
+            simd::Pack d[F::PLANE_COUNT];
+            for(int p = 0; p < F::PLANE_COUNT; ++p) {
+                const Vector3D<float> normal = frustum.getNormal((F::Plane)p);
+                a[p] = simd::set1(normal.x());
+                b[p] = simd::set1(normal.y());
+                c[p] = simd::set1(normal.z());
+                d[p] = simd::set1(frustum.getDistance((F::Plane)p));
+            }
+
+            const simd::Pack zero = simd::zero();
+            const int all = (1 << simd::PACK_SIZE) - 1;
+            const std::size_t packed = n - (n % simd::PACK_SIZE);
+            std::size_t count = 0;
+
+            for(std::size_t i = 0; i < packed; i += simd::PACK_SIZE) {
+                const simd::Pack px = simd::load(x + i);
+                const simd::Pack py = simd::load(y + i);
+                const simd::Pack pz = simd::load(z + i);
+                const simd::Pack minusR = simd::sub(zero, simd::load(r + i));
+
+                simd::Pack outside = simd::cmplt(zero, zero);
+                for(int p = 0; p < F::PLANE_COUNT; ++p) {
+                    simd::Pack dist = simd::add(simd::mul(a[p], px), simd::mul(b[p], py));
+                    dist = simd::add(simd::add(dist, simd::mul(c[p], pz)), d[p]);
+                    outside = simd::orp(outside, simd::cmplt(dist, minusR));
+                }
+
+                count = compactMask(~simd::mask(outside) & all, first + (std::uint32_t)i, out,
+                                    count);
+            }
+
+            return count + cullSphereStreams<float>(frustum, x + packed, y + packed, z + packed,
+                                                    r + packed, first + (std::uint32_t)packed,
+                                                    out + count, n - packed);
+        }
+
+        inline std::size_t cullBoxStreams(const Frustum<float>& frustum,
+                                          const float* cx, const float* cy, const float* cz,
+                                          const float* ex, const float* ey, const float* ez,
+                                          std::uint32_t first, std::uint32_t* out,
+                                          std::size_t n) {
+
+            typedef Frustum<float> F;
+
+            simd::Pack a[F::PLANE_COUNT], b[F::PLANE_COUNT], c[F::PLANE_COUNT];
+            simd::Pack absA[F::PLANE_COUNT], absB[F::PLANE_COUNT], absC[F::PLANE_COUNT];
+            simd::Pack d[F::PLANE_COUNT];
+            for(int p = 0; p < F::PLANE_COUNT; ++p) {
+                const Vector3D<float> normal = frustum.getNormal((F::Plane)p);
+                a[p] = simd::set1(normal.x());
+                b[p] = simd::set1(normal.y());
+                c[p] = simd::set1(normal.z());
+                absA[p] = simd::set1(std::fabs(normal.x()));
+                absB[p] = simd::set1(std::fabs(normal.y()));
+                absC[p] = simd::set1(std::fabs(normal.z()));
+                d[p] = simd::set1(frustum.getDistance((F::Plane)p));
+            }
+
+            const simd::Pack zero = simd::zero();
+            const int all = (1 << simd::PACK_SIZE) - 1;
+            const std::size_t packed = n - (n % simd::PACK_SIZE);
+            std::size_t count = 0;
+
+            for(std::size_t i = 0; i < packed; i += simd::PACK_SIZE) {
+                const simd::Pack px = simd::load(cx + i);
+                const simd::Pack py = simd::load(cy + i);
+                const simd::Pack pz = simd::load(cz + i);
+                const simd::Pack qx = simd::load(ex + i);
+                const simd::Pack qy = simd::load(ey + i);
+                const simd::Pack qz = simd::load(ez + i);
+
+                simd::Pack outside = simd::cmplt(zero, zero);
+                for(int p = 0; p < F::PLANE_COUNT; ++p) {
+                    simd::Pack dist = simd::add(simd::mul(a[p], px), simd::mul(b[p], py));
+                    dist = simd::add(simd::add(dist, simd::mul(c[p], pz)), d[p]);
+
+                    simd::Pack radius = simd::add(simd::mul(absA[p], qx), simd::mul(absB[p], qy));
+                    radius = simd::add(radius, simd::mul(absC[p], qz));
+
+                    outside = simd::orp(outside, simd::cmplt(dist, simd::sub(zero, radius)));
+                }
+
+                count = compactMask(~simd::mask(outside) & all, first + (std::uint32_t)i, out,
+                                    count);
+            }
+
+            return count + cullBoxStreams<float>(frustum, cx + packed, cy + packed, cz + packed,
+                                                 ex + packed, ey + packed, ez + packed,
+                                                 first + (std::uint32_t)packed, out + count,
+                                                 n - packed);
+        }
+
+#endif
+
+    } /* Namespace detail */
+
+} /* Namespace Piko */
+
+#endif // End of FRUSTUM_H
@@ -0,0 +1,661 @@
+/**
+ * @file        Matrix4x4.h
+ * @author      Robert Koch
+ * @version     1.0
+ *
+ * This file contains the class declaration for a 4x4 matrix used for homogeneous transformations
+ * of 3-dimensional vectors, together with batched kernels transforming whole vector arrays.
+ */
+#ifndef MATRIX4X4_H
+#define MATRIX4X4_H
+
+#include <cmath>
+#include <iostream>
+#include <stdexcept>
+
+#include "SIMD.h"
+#include "Vector3D.h"
+#include "Vector3DArray.h"
+
+
+namespace Piko {
+
+    /**
+     * Class declaring a 4x4 matrix. Elements are stored in column-major order like OpenGL
+     * expects them, so data() can be passed to glLoadMatrix or glUniformMatrix4fv directly.
+     * Vectors are treated as column vectors, so A * B applies B first.
+     */
+    template<typename T>
+    class Matrix4x4 final {
+
+        public:
+
+            /**
+             * Standard constructor to create an identity matrix.
+             */
+            Matrix4x4();
+
+            /**
+             * Constructor to create a matrix from 16 values in column-major order.
+             *
+             * @param values First of the 16 values.
+             */
+            explicit Matrix4x4(const T* values);
+
+            /**
+             * Function to create a matrix translating by the specified vector.
+             *
+             * @param t Translation.
+             * @return Translation matrix.
+             */
+            static Matrix4x4<T> translation(const Vector3D<T>& t);
+
+            /**
+             * Function to create a matrix scaling each axis by the specified factor.
+             *
+             * @param s Scaling factor per axis.
+             * @return Scaling matrix.
+             */
+            static Matrix4x4<T> scaling(const Vector3D<T>& s);
+
+            /**
+             * Function to create a matrix rotating around the specified axis.
+             *
+             * @param axis Rotation axis, does not need to be normalized.
+             * @param angle Rotation angle in radians.
+             * @return Rotation matrix.
+             */
+            static Matrix4x4<T> rotation(const Vector3D<T>& axis, const T& angle);
+
+            /**
+             * Function to create a perspective projection matrix like gluPerspective.
+             *
+             * @param fovy Vertical field of view in radians.
+             * @param aspect Ratio of width to height.
+             * @param zNear Distance to the near clipping plane.
+             * @param zFar Distance to the far clipping plane.
+             * @return Projection matrix.
+             */
+            static Matrix4x4<T> perspective(const T& fovy, const T& aspect,
+                                            const T& zNear, const T& zFar);
+
+            /**
+             * Function to create a view matrix like gluLookAt.
+             *
+             * @param eye Position of the viewer.
+             * @param center Point the viewer looks at.
+             * @param up Up direction.
+             * @return View matrix.
+             */
+            static Matrix4x4<T> lookAt(const Vector3D<T>& eye, const Vector3D<T>& center,
+                                       const Vector3D<T>& up);
+
+            /**
+             * Functions to access an element.
+             *
+             * @param row Row index from 0 to 3.
+             * @param col Column index from 0 to 3.
+             * @return Element at the position.
+             */
+            T& operator()(int row, int col);
+            const T& operator()(int row, int col) const;
+
+            /**
+             * Function to get the elements in column-major order.
+             *
+             * @return First of the 16 elements.
+             */
+            const T* data() const;
+
+            /**
+             * Function to multiply two matrices.
+             *
+             * @param m Matrix to multiply with from the right.
+             * @return Product of the matrices.
+             */
+            Matrix4x4<T> operator*(const Matrix4x4<T>& m) const;
+
+            /**
+             * Function to multiply the calling instance with a matrix from the right.
+             *
+             * @param m Matrix to multiply with.
+             * @return Product of the matrices.
+             */
+            const Matrix4x4<T>& operator*=(const Matrix4x4<T>& m);
+
+            /**
+             * Function to transform a point. The point is extended with w = 1 and only the affine
+             * part of the matrix is applied.
+             *
+             * @param p Point to transform.
+             * @return Transformed point.
+             */
+            Vector3D<T> transformPoint(const Vector3D<T>& p) const;
+
+            /**
+             * Function to transform a direction. The direction is extended with w = 0, so the
+             * translation does not apply.
+             *
+             * @param d Direction to transform.
+             * @return Transformed direction.
+             */
+            Vector3D<T> transformDirection(const Vector3D<T>& d) const;
+
+            /**
+             * Function to get the transposed matrix.
+             *
+             * @return Transposed matrix.
+             */
+            Matrix4x4<T> getTranspose() const;
+
+            /**
+             * Function to get the inverse matrix.
+             *
+             * @return Inverse matrix.
+             * @throws std::domain_error If the matrix is singular.
+             */
+            Matrix4x4<T> getInverse() const;
+
+
+            /**
+             * Function to have nice output, if appended to a stream.
+             */
+            friend std::ostream& operator<<(std::ostream& stream, const Matrix4x4<T>& m) {
+                for(int row = 0; row < 4; ++row) {
+                    stream << (row ? "\n[" : "[") << m(row, 0) << "," << m(row, 1) << ","
+                           << m(row, 2) << "," << m(row, 3) << "]";
+                }
+                return stream;
+            }
+
+
+        private:
+
+            alignas(16) T m_m[16];  /**< Elements in column-major order. */
+
+
+    }; /* Class Matrix4x4 */
+
+
+
+    /*==========================================
+     * BATCH KERNELS
+     *=========================================*/
+
+    /**
+     * Function to transform all points of an array, see Matrix4x4::transformPoint(). The output
+     * may alias the input.
+     *
+     * @param m Transformation matrix.
+     * @param in Points to transform.
+     * @param out Transformed points, resized to the size of in.
+     */
+    template<typename T>
+    void transformPoints(const Matrix4x4<T>& m, const Vector3DArray<T>& in, Vector3DArray<T>& out);
+
+    /**
+     * Function to transform all directions of an array, see Matrix4x4::transformDirection(). The
+     * output may alias the input.
+     *
+     * @param m Transformation matrix.
+     * @param in Directions to transform.
+     * @param out Transformed directions, resized to the size of in.
+     */
+    template<typename T>
+    void transformDirections(const Matrix4x4<T>& m, const Vector3DArray<T>& in,
+                             Vector3DArray<T>& out);
+
+    /**
+     * Function to transform an array of points in array-of-structures layout. The output may
+     * alias the input. Prefer the Vector3DArray overload for large buffers.
+     *
+     * @param m Transformation matrix.
+     * @param in First point to transform.
+     * @param out Destination which must provide space for count points.
+     * @param count Number of points.
+     */
+    template<typename T>
+    void transformPoints(const Matrix4x4<T>& m, const Vector3D<T>* in, Vector3D<T>* out,
+                         std::size_t count);
+
+    /**
+     * Function to transform an array of directions in array-of-structures layout. The output may
+     * alias the input.
+     *
+     * @param m Transformation matrix.
+     * @param in First direction to transform.
+     * @param out Destination which must provide space for count directions.
+     * @param count Number of directions.
+     */
+    template<typename T>
+    void transformDirections(const Matrix4x4<T>& m, const Vector3D<T>* in, Vector3D<T>* out,
+                             std::size_t count);
+
+
+
+    namespace detail {
+
+        /**
+         * Generic kernel applying the upper 3x4 part of a column-major matrix to coordinate
+         * streams. The translation column is added with weight w (1 for points, 0 for
+         * directions).
+         */
+        template<typename T>
+        inline void transformStreams(const T* m, const T& w,
+                                     const T* ix, const T* iy, const T* iz,
+                                     T* ox, T* oy, T* oz, std::size_t n) {
+
+            const T tx = m[12] * w, ty = m[13] * w, tz = m[14] * w;
+
+            for(std::size_t i = 0; i < n; ++i) {
+                T x = ix[i], y = iy[i], z = iz[i];
+                ox[i] = m[0] * x + m[4] * y + m[8] * z + tx;
+                oy[i] = m[1] * x + m[5] * y + m[9] * z + ty;
+                oz[i] = m[2] * x + m[6] * y + m[10] * z + tz;
+            }
+        }
+
+#if defined(PIKO_SIMD_AVX) || defined(PIKO_SIMD_SSE)
+
+        inline void transformStreams(const float* m, const float& w,
+                                     const float* ix, const float* iy, const float* iz,
+                                     float* ox, float* oy, float* oz, std::size_t n) {
+
+            const simd::Pack m0 = simd::set1(m[0]), m4 = simd::set1(m[4]), m8 = simd::set1(m[8]);
+            const simd::Pack m1 = simd::set1(m[1]), m5 = simd::set1(m[5]), m9 = simd::set1(m[9]);
+            const simd::Pack m2 = simd::set1(m[2]), m6 = simd::set1(m[6]), m10 = simd::set1(m[10]);
+            const simd::Pack tx = simd::set1(m[12] * w);
+            const simd::Pack ty = simd::set1(m[13] * w);
+            const simd::Pack tz = simd::set1(m[14] * w);
+
+            const std::size_t packed = n - (n % simd::PACK_SIZE);
+            for(std::size_t i = 0; i < packed; i += simd::PACK_SIZE) {
+                simd::Pack x = simd::load(ix + i), y = simd::load(iy + i), z = simd::load(iz + i);
+
+                simd::Pack rx = simd::add(simd::add(simd::mul(m0, x), simd::mul(m4, y)),
+                                          simd::add(simd::mul(m8, z), tx));
+                simd::Pack ry = simd::add(simd::add(simd::mul(m1, x), simd::mul(m5, y)),
+                                          simd::add(simd::mul(m9, z), ty));
+                simd::Pack rz = simd::add(simd::add(simd::mul(m2, x), simd::mul(m6, y)),
+                                          simd::add(simd::mul(m10, z), tz));
+
+                simd::store(ox + i, rx);
+                simd::store(oy + i, ry);
+                simd::store(oz + i, rz);
+            }
+            transformStreams<float>(m, w, ix + packed, iy + packed, iz + packed,
+                                    ox + packed, oy + packed, oz + packed, n - packed);
+        }
+
+#endif
+
+        /**
+         * Generic kernel transforming vectors in array-of-structures layout.
+         */
+        template<typename T>
+        inline void transformVectors(const T* m, const T& w, const Vector3D<T>* in,
+                                     Vector3D<T>* out, std::size_t n) {
+
+            const T tx = m[12] * w, ty = m[13] * w, tz = m[14] * w;
+
+            for(std::size_t i = 0; i < n; ++i) {
+                T x = in[i].x(), y = in[i].y(), z = in[i].z();
+                out[i].setPosition(m[0] * x + m[4] * y + m[8] * z + tx,
+                                   m[1] * x + m[5] * y + m[9] * z + ty,
+                                   m[2] * x + m[6] * y + m[10] * z + tz);
+            }
+        }
+
+#if defined(PIKO_SIMD_SSE)
+
+        inline void transformVectors(const float* m, const float& w, const Vector3D<float>* in,
+                                     Vector3D<float>* out, std::size_t n) {
+
+            std::size_t i = 0;
+
+            // Densely packed vectors are transposed four at a time and go through the SoA path.
+            if(sizeof(Vector3D<float>) == 3 * sizeof(float)) {
+
+                const __m128 m0 = _mm_set1_ps(m[0]), m4 = _mm_set1_ps(m[4]), m8 = _mm_set1_ps(m[8]);
+                const __m128 m1 = _mm_set1_ps(m[1]), m5 = _mm_set1_ps(m[5]), m9 = _mm_set1_ps(m[9]);
+                const __m128 m2 = _mm_set1_ps(m[2]), m6 = _mm_set1_ps(m[6]), m10 = _mm_set1_ps(m[10]);
+                const __m128 tx = _mm_set1_ps(m[12] * w);
+                const __m128 ty = _mm_set1_ps(m[13] * w);
+                const __m128 tz = _mm_set1_ps(m[14] * w);
+
+                const float* src = reinterpret_cast<const float*>(in);
+                float* dst = reinterpret_cast<float*>(out);
+
+                for(; i + 4 <= n; i += 4, src += 12, dst += 12) {
+                    __m128 x, y, z;
+                    loadTransposed(src, x, y, z);
+
+                    __m128 rx = _mm_add_ps(_mm_add_ps(_mm_mul_ps(m0, x), _mm_mul_ps(m4, y)),
+                                           _mm_add_ps(_mm_mul_ps(m8, z), tx));
+                    __m128 ry = _mm_add_ps(_mm_add_ps(_mm_mul_ps(m1, x), _mm_mul_ps(m5, y)),
+                                           _mm_add_ps(_mm_mul_ps(m9, z), ty));
+                    __m128 rz = _mm_add_ps(_mm_add_ps(_mm_mul_ps(m2, x), _mm_mul_ps(m6, y)),
+                                           _mm_add_ps(_mm_mul_ps(m10, z), tz));
+
+                    storeTransposed(dst, rx, ry, rz);
+                }
+            }
+
+            transformVectors<float>(m, w, in + i, out + i, n - i);
+        }
+
+#endif
+
+    } /* Namespace detail */
+
+
+
+    /*==========================================
+     * INLINE IMPLEMENTATION
+     *=========================================*/
+
+    template<typename T>
+    inline Matrix4x4<T>::Matrix4x4() {
+
+        for(int i = 0; i < 16; ++i) {
+            m_m[i] = (i % 5 == 0) ? T(1) : T(0);
+        }
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    template<typename T>
+    inline Matrix4x4<T>::Matrix4x4(const T* values) {
+
+        for(int i = 0; i < 16; ++i) {
+            m_m[i] = values[i];
+        }
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    template<typename T>
+    inline Matrix4x4<T> Matrix4x4<T>::translation(const Vector3D<T>& t) {
+
+        Matrix4x4<T> m;
+        m(0, 3) = t.x();
+        m(1, 3) = t.y();
+        m(2, 3) = t.z();
+        return m;
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    template<typename T>
+    inline Matrix4x4<T> Matrix4x4<T>::scaling(const Vector3D<T>& s) {
+
+        Matrix4x4<T> m;
+        m(0, 0) = s.x();
+        m(1, 1) = s.y();
+        m(2, 2) = s.z();
+        return m;
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    template<typename T>
+    inline Matrix4x4<T> Matrix4x4<T>::rotation(const Vector3D<T>& axis, const T& angle) {
+
+        using std::cos;
+        using std::sin;
+
+        Vector3D<T> a = axis.getNormalization();
+        const T c = cos(angle);
+        const T s = sin(angle);
+        const T t = T(1) - c;
+
+        Matrix4x4<T> m;
+        m(0, 0) = t * a.x() * a.x() + c;
+        m(0, 1) = t * a.x() * a.y() - s * a.z();
+        m(0, 2) = t * a.x() * a.z() + s * a.y();
+        m(1, 0) = t * a.x() * a.y() + s * a.z();
+        m(1, 1) = t * a.y() * a.y() + c;
+        m(1, 2) = t * a.y() * a.z() - s * a.x();
+        m(2, 0) = t * a.x() * a.z() - s * a.y();
+        m(2, 1) = t * a.y() * a.z() + s * a.x();
+        m(2, 2) = t * a.z() * a.z() + c;
+        return m;
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    template<typename T>
+    inline Matrix4x4<T> Matrix4x4<T>::perspective(const T& fovy, const T& aspect,
+                                                  const T& zNear, const T& zFar) {
+
+        using std::tan;
+
+        const T f = T(1) / tan(fovy / T(2));
+
+        Matrix4x4<T> m;
+        m(0, 0) = f / aspect;
+        m(1, 1) = f;
+        m(2, 2) = (zFar + zNear) / (zNear - zFar);
+        m(2, 3) = (T(2) * zFar * zNear) / (zNear - zFar);
+        m(3, 2) = T(-1);
+        m(3, 3) = T(0);
+        return m;
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    template<typename T>
+    inline Matrix4x4<T> Matrix4x4<T>::lookAt(const Vector3D<T>& eye, const Vector3D<T>& center,
+                                             const Vector3D<T>& up) {
+
+        Vector3D<T> f = center - eye;
+        f.normalize();
+        Vector3D<T> s = f ^ up;
+        s.normalize();
+        Vector3D<T> u = s ^ f;
+
+        Matrix4x4<T> m;
+        m(0, 0) = s.x();  m(0, 1) = s.y();  m(0, 2) = s.z();
+        m(1, 0) = u.x();  m(1, 1) = u.y();  m(1, 2) = u.z();
+        m(2, 0) = -f.x(); m(2, 1) = -f.y(); m(2, 2) = -f.z();
+        m(0, 3) = -(s * eye);
+        m(1, 3) = -(u * eye);
+        m(2, 3) = f * eye;
+        return m;
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    template<typename T>
+    inline T& Matrix4x4<T>::operator()(int row, int col) {
+        return m_m[col * 4 + row];
+    }
+
+    template<typename T>
+    inline const T& Matrix4x4<T>::operator()(int row, int col) const {
+        return m_m[col * 4 + row];
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    template<typename T>
+    inline const T* Matrix4x4<T>::data() const {
+        return m_m;
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    template<typename T>
+    inline Matrix4x4<T> Matrix4x4<T>::operator*(const Matrix4x4<T>& m) const {
+
+        Matrix4x4<T> r;
+        for(int col = 0; col < 4; ++col) {
+            for(int row = 0; row < 4; ++row) {
+                r(row, col) = (*this)(row, 0) * m(0, col) + (*this)(row, 1) * m(1, col)
+                            + (*this)(row, 2) * m(2, col) + (*this)(row, 3) * m(3, col);
+            }
+        }
+        return r;
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    template<typename T>
+    inline const Matrix4x4<T>& Matrix4x4<T>::operator*=(const Matrix4x4<T>& m) {
+        *this = *this * m;
+        return *this;
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    template<typename T>
+    inline Vector3D<T> Matrix4x4<T>::transformPoint(const Vector3D<T>& p) const {
+
+        return Vector3D<T>(m_m[0] * p.x() + m_m[4] * p.y() + m_m[8] * p.z() + m_m[12],
+                           m_m[1] * p.x() + m_m[5] * p.y() + m_m[9] * p.z() + m_m[13],
+                           m_m[2] * p.x() + m_m[6] * p.y() + m_m[10] * p.z() + m_m[14]);
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    template<typename T>
+    inline Vector3D<T> Matrix4x4<T>::transformDirection(const Vector3D<T>& d) const {
+
+        return Vector3D<T>(m_m[0] * d.x() + m_m[4] * d.y() + m_m[8] * d.z(),
+                           m_m[1] * d.x() + m_m[5] * d.y() + m_m[9] * d.z(),
+                           m_m[2] * d.x() + m_m[6] * d.y() + m_m[10] * d.z());
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    template<typename T>
+    inline Matrix4x4<T> Matrix4x4<T>::getTranspose() const {
+
+        Matrix4x4<T> r;
+        for(int row = 0; row < 4; ++row) {
+            for(int col = 0; col < 4; ++col) {
+                r(col, row) = (*this)(row, col);
+            }
+        }
+        return r;
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    template<typename T>
+    inline Matrix4x4<T> Matrix4x4<T>::getInverse() const {
+
+        const T* m = m_m;
+        T inv[16];
+
+        // Cofactor expansion, see e.g. the MESA implementation of gluInvertMatrix.
+        inv[0]  =  m[5] * m[10] * m[15] - m[5] * m[11] * m[14] - m[9] * m[6] * m[15]
+                 + m[9] * m[7] * m[14] + m[13] * m[6] * m[11] - m[13] * m[7] * m[10];
+        inv[4]  = -m[4] * m[10] * m[15] + m[4] * m[11] * m[14] + m[8] * m[6] * m[15]
+                 - m[8] * m[7] * m[14] - m[12] * m[6] * m[11] + m[12] * m[7] * m[10];
+        inv[8]  =  m[4] * m[9] * m[15] - m[4] * m[11] * m[13] - m[8] * m[5] * m[15]
+                 + m[8] * m[7] * m[13] + m[12] * m[5] * m[11] - m[12] * m[7] * m[9];
+        inv[12] = -m[4] * m[9] * m[14] + m[4] * m[10] * m[13] + m[8] * m[5] * m[14]
+                 - m[8] * m[6] * m[13] - m[12] * m[5] * m[10] + m[12] * m[6] * m[9];
+        inv[1]  = -m[1] * m[10] * m[15] + m[1] * m[11] * m[14] + m[9] * m[2] * m[15]
+                 - m[9] * m[3] * m[14] - m[13] * m[2] * m[11] + m[13] * m[3] * m[10];
+        inv[5]  =  m[0] * m[10] * m[15] - m[0] * m[11] * m[14] - m[8] * m[2] * m[15]
+                 + m[8] * m[3] * m[14] + m[12] * m[2] * m[11] - m[12] * m[3] * m[10];
+        inv[9]  = -m[0] * m[9] * m[15] + m[0] * m[11] * m[13] + m[8] * m[1] * m[15]
+                 - m[8] * m[3] * m[13] - m[12] * m[1] * m[11] + m[12] * m[3] * m[9];
+        inv[13] =  m[0] * m[9] * m[14] - m[0] * m[10] * m[13] - m[8] * m[1] * m[14]
+                 + m[8] * m[2] * m[13] + m[12] * m[1] * m[10] - m[12] * m[2] * m[9];
+        inv[2]  =  m[1] * m[6] * m[15] - m[1] * m[7] * m[14] - m[5] * m[2] * m[15]
+                 + m[5] * m[3] * m[14] + m[13] * m[2] * m[7] - m[13] * m[3] * m[6];
+        inv[6]  = -m[0] * m[6] * m[15] + m[0] * m[7] * m[14] + m[4] * m[2] * m[15]
+                 - m[4] * m[3] * m[14] - m[12] * m[2] * m[7] + m[12] * m[3] * m[6];
+        inv[10] =  m[0] * m[5] * m[15] - m[0] * m[7] * m[13] - m[4] * m[1] * m[15]
+                 + m[4] * m[3] * m[13] + m[12] * m[1] * m[7] - m[12] * m[3] * m[5];
+        inv[14] = -m[0] * m[5] * m[14] + m[0] * m[6] * m[13] + m[4] * m[1] * m[14]
+                 - m[4] * m[2] * m[13] - m[12] * m[1] * m[6] + m[12] * m[2] * m[5];
+        inv[3]  = -m[1] * m[6] * m[11] + m[1] * m[7] * m[10] + m[5] * m[2] * m[11]
+                 - m[5] * m[3] * m[10] - m[9] * m[2] * m[7] + m[9] * m[3] * m[6];
+        inv[7]  =  m[0] * m[6] * m[11] - m[0] * m[7] * m[10] - m[4] * m[2] * m[11]
+                 + m[4] * m[3] * m[10] + m[8] * m[2] * m[7] - m[8] * m[3] * m[6];
+        inv[11] = -m[0] * m[5] * m[11] + m[0] * m[7] * m[9] + m[4] * m[1] * m[11]
+                 - m[4] * m[3] * m[9] - m[8] * m[1] * m[7] + m[8] * m[3] * m[5];
+        inv[15] =  m[0] * m[5] * m[10] - m[0] * m[6] * m[9] - m[4] * m[1] * m[10]
+                 + m[4] * m[2] * m[9] + m[8] * m[1] * m[6] - m[8] * m[2] * m[5];
+
+        T det = m[0] * inv[0] + m[1] * inv[4] + m[2] * inv[8] + m[3] * inv[12];
+        if(det == T(0)) {
+            throw std::domain_error("Matrix4x4: Matrix is singular.");
+        }
+
+        for(int i = 0; i < 16; ++i) {
+            inv[i] = inv[i] / det;
+        }
+
+        return Matrix4x4<T>(inv);
+    }
+
+
+
+    /*==========================================
+     * BATCH KERNEL IMPLEMENTATION
+     *=========================================*/
+
+    template<typename T>
+    inline void transformPoints(const Matrix4x4<T>& m, const Vector3DArray<T>& in,
+                                Vector3DArray<T>& out) {
+
+        out.resize(in.size());
+        detail::transformStreams(m.data(), T(1), in.x(), in.y(), in.z(),
+                                 out.x(), out.y(), out.z(), in.size());
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    template<typename T>
+    inline void transformDirections(const Matrix4x4<T>& m, const Vector3DArray<T>& in,
+                                    Vector3DArray<T>& out) {
+
+        out.resize(in.size());
+        detail::transformStreams(m.data(), T(0), in.x(), in.y(), in.z(),
+                                 out.x(), out.y(), out.z(), in.size());
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    template<typename T>
+    inline void transformPoints(const Matrix4x4<T>& m, const Vector3D<T>* in, Vector3D<T>* out,
+                                std::size_t count) {
+
+        detail::transformVectors(m.data(), T(1), in, out, count);
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    template<typename T>
+    inline void transformDirections(const Matrix4x4<T>& m, const Vector3D<T>* in, Vector3D<T>* out,
+                                    std::size_t count) {
+
+        detail::transformVectors(m.data(), T(0), in, out, count);
+    }
+
+
+} /* Namespace Piko */
+
+#endif // End of MATRIX4X4_H
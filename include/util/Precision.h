@@ -0,0 +1,221 @@
+/**
+ * @file        Precision.h
+ * @author      Robert Koch
+ * @version     1.0
+ *
+ * This file contains the precision policies used to normalize vectors. A policy decides how the
+ * reciprocal square root of the squared magnitude is computed:
+ *
+ *  - ExactPrecision divides by the exact square root. Results are identical to a plain division.
+ *  - FastPrecision uses the hardware reciprocal square root estimate refined by one Newton-Raphson
+ *    step. Maximum relative error for floats: 5e-7 with SSE, 5e-6 without SSE (bit-level
+ *    estimate refined by two steps).
+ *  - EstimatePrecision uses the raw hardware estimate. Maximum relative error for floats:
+ *    3.7e-4 (1.5 * 2^-12) with SSE, 1.8e-3 without SSE (bit-level estimate refined by one step).
+ *
+ * For double coordinates the fast and estimate policies multiply by an exact reciprocal square
+ * root, which saves two of the three divisions. They are not meant for integral coordinates.
+ *
+ * All policies treat vectors whose squared magnitude is not above threshold() as zero-length and
+ * normalize them to (0,0,0) instead of producing NaNs. For the approximate policies the threshold
+ * is the smallest normalized value, since the hardware estimate flushes denormals to zero.
+ */
+#ifndef PRECISION_H
+#define PRECISION_H
+
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+
+#include "SIMD.h"
+
+
+namespace Piko {
+
+    namespace detail {
+
+        /**
+         * Function to compute a reciprocal square root estimate of a float without SSE. Uses the
+         * well known bit-level approximation followed by the specified number of Newton-Raphson
+         * steps.
+         *
+         * @param x Value to compute the reciprocal square root of.
+         * @param steps Number of Newton-Raphson steps.
+         * @return Approximation of 1/sqrt(x).
+         */
+        inline float bitRsqrt(float x, int steps) {
+
+            unsigned int bits;
+            std::memcpy(&bits, &x, sizeof(bits));
+            bits = 0x5f375a86u - (bits >> 1);
+
+            float y;
+            std::memcpy(&y, &bits, sizeof(y));
+
+            const float halfX = 0.5f * x;
+            for(int i = 0; i < steps; ++i) {
+                y = y * (1.5f - halfX * y * y);
+            }
+
+            return y;
+        }
+
+#if defined(PIKO_SIMD_SSE)
+        /**
+         * Function to refine a reciprocal square root estimate by one Newton-Raphson step.
+         *
+         * @param x Values the estimate was computed for.
+         * @param y Estimate of 1/sqrt(x).
+         * @return Refined estimate.
+         */
+        inline __m128 newtonRsqrt(__m128 x, __m128 y) {
+            const __m128 half = _mm_set1_ps(0.5f);
+            const __m128 threeHalves = _mm_set1_ps(1.5f);
+            __m128 yy = _mm_mul_ps(y, y);
+            return _mm_mul_ps(y, _mm_sub_ps(threeHalves, _mm_mul_ps(_mm_mul_ps(half, x), yy)));
+        }
+#endif
+
+#if defined(PIKO_SIMD_AVX)
+        inline __m256 newtonRsqrt(__m256 x, __m256 y) {
+            const __m256 half = _mm256_set1_ps(0.5f);
+            const __m256 threeHalves = _mm256_set1_ps(1.5f);
+            __m256 yy = _mm256_mul_ps(y, y);
+            return _mm256_mul_ps(y, _mm256_sub_ps(threeHalves, _mm256_mul_ps(_mm256_mul_ps(half, x), yy)));
+        }
+#endif
+
+    } /* Namespace detail */
+
+
+
+    /**
+     * Policy to normalize with full precision. A component c of a vector with squared magnitude
+     * sq is normalized as apply(c, factor(sq)) = c / sqrt(sq).
+     */
+    struct ExactPrecision final {
+
+        template<typename T>
+        static T threshold() {
+            return T(0);
+        }
+
+        template<typename T>
+        static T factor(const T& squared) {
+            using std::sqrt;
+            return static_cast<T>(sqrt(squared));
+        }
+
+        template<typename T>
+        static T apply(const T& component, const T& factor) {
+            return component / factor;
+        }
+
+#if defined(PIKO_SIMD_SSE)
+        static __m128 factor(__m128 squared)                { return _mm_sqrt_ps(squared); }
+        static __m128 apply(__m128 component, __m128 f)     { return _mm_div_ps(component, f); }
+#endif
+#if defined(PIKO_SIMD_AVX)
+        static __m256 factor(__m256 squared)                { return _mm256_sqrt_ps(squared); }
+        static __m256 apply(__m256 component, __m256 f)     { return _mm256_div_ps(component, f); }
+#endif
+
+    }; /* Struct ExactPrecision */
+
+
+
+    /**
+     * Policy to normalize using a reciprocal square root estimate refined by one Newton-Raphson
+     * step: apply(c, factor(sq)) = c * rsqrt(sq).
+     */
+    struct FastPrecision final {
+
+        template<typename T>
+        static T threshold() {
+            static_assert(!std::numeric_limits<T>::is_integer, "Use ExactPrecision for integers.");
+            return std::numeric_limits<T>::min();
+        }
+
+        template<typename T>
+        static T factor(const T& squared) {
+            using std::sqrt;
+            return T(1) / static_cast<T>(sqrt(squared));
+        }
+
+        static float factor(const float& squared) {
+#if defined(PIKO_SIMD_SSE)
+            __m128 x = _mm_set_ss(squared);
+            return _mm_cvtss_f32(detail::newtonRsqrt(x, _mm_rsqrt_ss(x)));
+#else
+            return detail::bitRsqrt(squared, 2);
+#endif
+        }
+
+        template<typename T>
+        static T apply(const T& component, const T& factor) {
+            return component * factor;
+        }
+
+#if defined(PIKO_SIMD_SSE)
+        static __m128 factor(__m128 squared) {
+            return detail::newtonRsqrt(squared, _mm_rsqrt_ps(squared));
+        }
+        static __m128 apply(__m128 component, __m128 f)     { return _mm_mul_ps(component, f); }
+#endif
+#if defined(PIKO_SIMD_AVX)
+        static __m256 factor(__m256 squared) {
+            return detail::newtonRsqrt(squared, _mm256_rsqrt_ps(squared));
+        }
+        static __m256 apply(__m256 component, __m256 f)     { return _mm256_mul_ps(component, f); }
+#endif
+
+    }; /* Struct FastPrecision */
+
+
+
+    /**
+     * Policy to normalize using the raw reciprocal square root estimate of the hardware:
+     * apply(c, factor(sq)) = c * rsqrtEstimate(sq).
+     */
+    struct EstimatePrecision final {
+
+        template<typename T>
+        static T threshold() {
+            static_assert(!std::numeric_limits<T>::is_integer, "Use ExactPrecision for integers.");
+            return std::numeric_limits<T>::min();
+        }
+
+        template<typename T>
+        static T factor(const T& squared) {
+            using std::sqrt;
+            return T(1) / static_cast<T>(sqrt(squared));
+        }
+
+        static float factor(const float& squared) {
+#if defined(PIKO_SIMD_SSE)
+            return _mm_cvtss_f32(_mm_rsqrt_ss(_mm_set_ss(squared)));
+#else
+            return detail::bitRsqrt(squared, 1);
+#endif
+        }
+
+        template<typename T>
+        static T apply(const T& component, const T& factor) {
+            return component * factor;
+        }
+
+#if defined(PIKO_SIMD_SSE)
+        static __m128 factor(__m128 squared)                { return _mm_rsqrt_ps(squared); }
+        static __m128 apply(__m128 component, __m128 f)     { return _mm_mul_ps(component, f); }
+#endif
+#if defined(PIKO_SIMD_AVX)
+        static __m256 factor(__m256 squared)                { return _mm256_rsqrt_ps(squared); }
+        static __m256 apply(__m256 component, __m256 f)     { return _mm256_mul_ps(component, f); }
+#endif
+
+    }; /* Struct EstimatePrecision */
+
+} /* Namespace Piko */
+
+#endif // End of PRECISION_H
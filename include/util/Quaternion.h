@@ -0,0 +1,390 @@
+/**
+ * @file        Quaternion.h
+ * @author      Robert Koch
+ * @version     1.0
+ *
+ * This file contains the class declaration for a quaternion used to represent rotations of
+ * 3-dimensional vectors.
+ */
+#ifndef QUATERNION_H
+#define QUATERNION_H
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+#include "Matrix4x4.h"
+#include "Vector3D.h"
+
+
+namespace Piko {
+
+    /**
+     * Class declaring a quaternion w + xi + yj + zk. Rotations are represented by unit
+     * quaternions, and q1 * q2 describes the rotation q2 followed by q1.
+     */
+    template<typename T>
+    class Quaternion final {
+
+        public:
+
+            /**
+             * Standard constructor to create the identity rotation (1,0,0,0).
+             */
+            Quaternion();
+
+            /**
+             * Constructor to create a quaternion with the specified components.
+             *
+             * @param w Real part.
+             * @param x i-component.
+             * @param y j-component.
+             * @param z k-component.
+             */
+            Quaternion(const T& w, const T& x, const T& y, const T& z);
+
+            /**
+             * Function to create a rotation around the specified axis.
+             *
+             * @param axis Rotation axis, does not need to be normalized.
+             * @param angle Rotation angle in radians.
+             * @return Unit quaternion describing the rotation.
+             */
+            static Quaternion<T> fromAxisAngle(const Vector3D<T>& axis, const T& angle);
+
+            /**
+             * Function to interpolate spherically between two rotations. Always takes the
+             * shorter arc and falls back to normalized linear interpolation for nearly parallel
+             * rotations. The selection is done with conditional moves instead of branches, so
+             * the function runs at the same speed for all inputs.
+             *
+             * @param a Rotation at t = 0.
+             * @param b Rotation at t = 1.
+             * @param t Interpolation parameter from 0 to 1.
+             * @return Interpolated unit quaternion.
+             */
+            static Quaternion<T> slerp(const Quaternion<T>& a, const Quaternion<T>& b, const T& t);
+
+            /**
+             * Function to interpolate linearly between two rotations and normalize the result.
+             * Cheaper than slerp() but does not have constant angular velocity.
+             *
+             * @param a Rotation at t = 0.
+             * @param b Rotation at t = 1.
+             * @param t Interpolation parameter from 0 to 1.
+             * @return Interpolated unit quaternion.
+             */
+            static Quaternion<T> nlerp(const Quaternion<T>& a, const Quaternion<T>& b, const T& t);
+
+            /**
+             * Functions to get the components.
+             *
+             * @return Component.
+             */
+            const T& w() const;
+            const T& x() const;
+            const T& y() const;
+            const T& z() const;
+
+            /**
+             * Function to compose two rotations.
+             *
+             * @param q Rotation applied first.
+             * @return Hamilton product of the quaternions.
+             */
+            Quaternion<T> operator*(const Quaternion<T>& q) const;
+
+            /**
+             * Function to compose the calling instance with a rotation applied first.
+             *
+             * @param q Rotation applied first.
+             * @return Hamilton product of the quaternions.
+             */
+            const Quaternion<T>& operator*=(const Quaternion<T>& q);
+
+            /**
+             * Function to get the dot product of two quaternions.
+             *
+             * @param q Quaternion to multiply with.
+             * @return Dot product.
+             */
+            T dot(const Quaternion<T>& q) const;
+
+            /**
+             * Function to get the conjugate, which is the inverse rotation for unit quaternions.
+             *
+             * @return Conjugate quaternion.
+             */
+            Quaternion<T> getConjugate() const;
+
+            /**
+             * Function to get the magnitude.
+             *
+             * @return Magnitude.
+             */
+            T getMagnitude() const;
+
+            /**
+             * Function to normalize the quaternion. A quaternion of zero length becomes the
+             * identity.
+             */
+            void normalize();
+
+            /**
+             * Function to rotate a vector.
+             *
+             * @param v Vector to rotate.
+             * @return Rotated vector.
+             */
+            Vector3D<T> rotate(const Vector3D<T>& v) const;
+
+            /**
+             * Function to convert the rotation to a matrix. The quaternion has to be normalized.
+             *
+             * @return Rotation matrix.
+             */
+            Matrix4x4<T> toMatrix() const;
+
+
+            /**
+             * Function to have nice output, if appended to a stream.
+             */
+            friend std::ostream& operator<<(std::ostream& stream, const Quaternion<T>& q) {
+                return stream << "(" << q.m_w << "," << q.m_x << "," << q.m_y << "," << q.m_z << ")";
+            }
+
+
+        private:
+
+            T m_w;      /**< Real part. */
+            T m_x;      /**< i-component. */
+            T m_y;      /**< j-component. */
+            T m_z;      /**< k-component. */
+
+
+    }; /* Class Quaternion */
+
+
+
+    /*==========================================
+     * INLINE IMPLEMENTATION
+     *=========================================*/
+
+    template<typename T>
+    inline Quaternion<T>::Quaternion()
+      :
+      m_w(1),
+      m_x(0),
+      m_y(0),
+      m_z(0) {
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    template<typename T>
+    inline Quaternion<T>::Quaternion(const T& w, const T& x, const T& y, const T& z)
+      :
+      m_w(w),
+      m_x(x),
+      m_y(y),
+      m_z(z) {
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    template<typename T>
+    inline Quaternion<T> Quaternion<T>::fromAxisAngle(const Vector3D<T>& axis, const T& angle) {
+
+        using std::cos;
+        using std::sin;
+
+        Vector3D<T> a = axis.getNormalization();
+        const T s = sin(angle / T(2));
+
+        return Quaternion<T>(cos(angle / T(2)), a.x() * s, a.y() * s, a.z() * s);
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    template<typename T>
+    inline Quaternion<T> Quaternion<T>::slerp(const Quaternion<T>& a, const Quaternion<T>& b,
+                                              const T& t) {
+
+        using std::acos;
+        using std::sin;
+
+        // Take the shorter arc by flipping b if the rotations point into opposite directions.
+        T cosTheta = a.dot(b);
+        const T sign = (cosTheta < T(0)) ? T(-1) : T(1);
+        cosTheta = std::min(cosTheta * sign, T(1));
+
+        // Nearly parallel rotations would divide by a vanishing sine, use linear weights.
+        const bool linear = cosTheta > T(0.9995);
+
+        const T theta = acos(cosTheta);
+        const T invSin = linear ? T(0) : T(1) / sin(theta);
+        const T wa = linear ? T(1) - t : sin((T(1) - t) * theta) * invSin;
+        const T wb = (linear ? t : sin(t * theta) * invSin) * sign;
+
+        Quaternion<T> q(wa * a.m_w + wb * b.m_w,
+                        wa * a.m_x + wb * b.m_x,
+                        wa * a.m_y + wb * b.m_y,
+                        wa * a.m_z + wb * b.m_z);
+        q.normalize();
+
+        return q;
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    template<typename T>
+    inline Quaternion<T> Quaternion<T>::nlerp(const Quaternion<T>& a, const Quaternion<T>& b,
+                                              const T& t) {
+
+        const T wa = T(1) - t;
+        const T wb = (a.dot(b) < T(0)) ? -t : t;
+
+        Quaternion<T> q(wa * a.m_w + wb * b.m_w,
+                        wa * a.m_x + wb * b.m_x,
+                        wa * a.m_y + wb * b.m_y,
+                        wa * a.m_z + wb * b.m_z);
+        q.normalize();
+
+        return q;
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    template<typename T>
+    inline const T& Quaternion<T>::w() const {
+        return m_w;
+    }
+
+    template<typename T>
+    inline const T& Quaternion<T>::x() const {
+        return m_x;
+    }
+
+    template<typename T>
+    inline const T& Quaternion<T>::y() const {
+        return m_y;
+    }
+
+    template<typename T>
+    inline const T& Quaternion<T>::z() const {
+        return m_z;
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    template<typename T>
+    inline Quaternion<T> Quaternion<T>::operator*(const Quaternion<T>& q) const {
+
+        return Quaternion<T>(m_w * q.m_w - m_x * q.m_x - m_y * q.m_y - m_z * q.m_z,
+                             m_w * q.m_x + m_x * q.m_w + m_y * q.m_z - m_z * q.m_y,
+                             m_w * q.m_y - m_x * q.m_z + m_y * q.m_w + m_z * q.m_x,
+                             m_w * q.m_z + m_x * q.m_y - m_y * q.m_x + m_z * q.m_w);
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    template<typename T>
+    inline const Quaternion<T>& Quaternion<T>::operator*=(const Quaternion<T>& q) {
+        *this = *this * q;
+        return *this;
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    template<typename T>
+    inline T Quaternion<T>::dot(const Quaternion<T>& q) const {
+        return m_w * q.m_w + m_x * q.m_x + m_y * q.m_y + m_z * q.m_z;
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    template<typename T>
+    inline Quaternion<T> Quaternion<T>::getConjugate() const {
+        return Quaternion<T>(m_w, -m_x, -m_y, -m_z);
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    template<typename T>
+    inline T Quaternion<T>::getMagnitude() const {
+        using std::sqrt;
+        return static_cast<T>(sqrt(dot(*this)));
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    template<typename T>
+    inline void Quaternion<T>::normalize() {
+
+        T mag = getMagnitude();
+
+        if(!(mag > T(0))) {
+            *this = Quaternion<T>();
+            return;
+        }
+
+        m_w /= mag;
+        m_x /= mag;
+        m_y /= mag;
+        m_z /= mag;
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    template<typename T>
+    inline Vector3D<T> Quaternion<T>::rotate(const Vector3D<T>& v) const {
+
+        // v' = v + 2w(q x v) + 2q x (q x v) with q being the vector part.
+        const T tx = T(2) * (m_y * v.z() - m_z * v.y());
+        const T ty = T(2) * (m_z * v.x() - m_x * v.z());
+        const T tz = T(2) * (m_x * v.y() - m_y * v.x());
+
+        return Vector3D<T>(v.x() + m_w * tx + (m_y * tz - m_z * ty),
+                           v.y() + m_w * ty + (m_z * tx - m_x * tz),
+                           v.z() + m_w * tz + (m_x * ty - m_y * tx));
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    template<typename T>
+    inline Matrix4x4<T> Quaternion<T>::toMatrix() const {
+
+        const T xx = m_x * m_x, yy = m_y * m_y, zz = m_z * m_z;
+        const T xy = m_x * m_y, xz = m_x * m_z, yz = m_y * m_z;
+        const T wx = m_w * m_x, wy = m_w * m_y, wz = m_w * m_z;
+
+        Matrix4x4<T> m;
+        m(0, 0) = T(1) - T(2) * (yy + zz);
+        m(0, 1) = T(2) * (xy - wz);
+        m(0, 2) = T(2) * (xz + wy);
+        m(1, 0) = T(2) * (xy + wz);
+        m(1, 1) = T(1) - T(2) * (xx + zz);
+        m(1, 2) = T(2) * (yz - wx);
+        m(2, 0) = T(2) * (xz - wy);
+        m(2, 1) = T(2) * (yz + wx);
+        m(2, 2) = T(1) - T(2) * (xx + yy);
+        return m;
+    }
+
+
+} /* Namespace Piko */
+
+#endif // End of QUATERNION_H
@@ -0,0 +1,207 @@
+/**
+ * @file        Result.h
+ * @author      Robert Koch
+ * @version     1.0
+ *
+ * This file contains a result type for functions reporting failures without throwing.
+ */
+#ifndef RESULT_H
+#define RESULT_H
+
+#include <stdexcept>
+#include <utility>
+
+#include "../ErrorMessage.h"
+
+
+namespace Piko {
+
+    /**
+     * Either the value computed by a function or the error which prevented it. Returning a
+     * failed result costs no more than returning the value, so callers probing alternatives can
+     * afford to try one after another. Use Result<> for functions without a value.
+     *
+     * @tparam T Value type, has to be default constructible.
+     */
+    template<typename T = void>
+    class Result final {
+
+        public:
+
+            /**
+             * Constructor to create a successful result.
+             *
+             * @param value Computed value.
+             */
+            Result(const T& value)
+              :
+              m_value(value),
+              m_isOk(true) {
+
+            }
+
+            /**
+             * Constructor to create a successful result.
+             *
+             * @param value Computed value.
+             */
+            Result(T&& value)
+              :
+              m_value(std::move(value)),
+              m_isOk(true) {
+
+            }
+
+            /**
+             * Constructor to create a failed result.
+             *
+             * @param error Reason of the failure.
+             */
+            Result(const ErrorMessage& error)
+              :
+              m_value(),
+              m_error(error),
+              m_isOk(false) {
+
+            }
+
+            /**
+             * Function to check if the result holds a value.
+             *
+             * @return True on success, otherwise false.
+             */
+            bool isOk() const {
+                return m_isOk;
+            }
+
+            /**
+             * Same as isOk().
+             */
+            explicit operator bool() const {
+                return m_isOk;
+            }
+
+            /**
+             * Function to get the value.
+             *
+             * @return Computed value.
+             *
+             * @throws std::runtime_error If the result is a failure.
+             */
+            T& value() {
+                check();
+                return m_value;
+            }
+
+            /**
+             * Function to get the value.
+             *
+             * @return Computed value.
+             *
+             * @throws std::runtime_error If the result is a failure.
+             */
+            const T& value() const {
+                check();
+                return m_value;
+            }
+
+            /**
+             * Function to get the error of a failed result.
+             *
+             * @return Reason of the failure, an empty error message on success.
+             */
+            const ErrorMessage& error() const {
+                return m_error;
+            }
+
+            /**
+             * Function to turn a failure into an exception.
+             *
+             * @throws std::runtime_error If the result is a failure.
+             */
+            void check() const {
+                if(!m_isOk) throw std::runtime_error(m_error.str());
+            }
+
+        private:
+
+            T m_value;                  /**< Computed value, default constructed on failure. */
+            ErrorMessage m_error;       /**< Reason of the failure. */
+            bool m_isOk;                /**< Flag to indicate success. */
+
+    }; /* Class Result */
+
+    /**
+     * Result of a function without a value.
+     */
+    template<>
+    class Result<void> final {
+
+        public:
+
+            /**
+             * Constructor to create a successful result.
+             */
+            Result()
+              :
+              m_isOk(true) {
+
+            }
+
+            /**
+             * Constructor to create a failed result.
+             *
+             * @param error Reason of the failure.
+             */
+            Result(const ErrorMessage& error)
+              :
+              m_error(error),
+              m_isOk(false) {
+
+            }
+
+            /**
+             * Function to check if the function succeeded.
+             *
+             * @return True on success, otherwise false.
+             */
+            bool isOk() const {
+                return m_isOk;
+            }
+
+            /**
+             * Same as isOk().
+             */
+            explicit operator bool() const {
+                return m_isOk;
+            }
+
+            /**
+             * Function to get the error of a failed result.
+             *
+             * @return Reason of the failure, an empty error message on success.
+             */
+            const ErrorMessage& error() const {
+                return m_error;
+            }
+
+            /**
+             * Function to turn a failure into an exception.
+             *
+             * @throws std::runtime_error If the result is a failure.
+             */
+            void check() const {
+                if(!m_isOk) throw std::runtime_error(m_error.str());
+            }
+
+        private:
+
+            ErrorMessage m_error;       /**< Reason of the failure. */
+            bool m_isOk;                /**< Flag to indicate success. */
+
+    }; /* Class Result<void> */
+
+} /* Namespace Piko */
+
+
+#endif // End of RESULT_H
\ No newline at end of file
@@ -0,0 +1,153 @@
+/**
+ * @file        SIMD.h
+ * @author      Robert Koch
+ * @version     1.0
+ *
+ * Compile time detection of the available SIMD instruction sets together with a thin wrapper
+ * around the float intrinsics and helpers for aligned memory. The batched math routines are
+ * written against the Pack functions declared here, so they use AVX, SSE or plain scalar code
+ * depending on the target the engine is compiled for. Define PIKO_NO_SIMD to force scalar code.
+ */
+#ifndef SIMD_H
+#define SIMD_H
+
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+#if !defined(PIKO_NO_SIMD)
+    #if defined(__AVX__)
+        #define PIKO_SIMD_AVX 1
+    #endif
+    #if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+        #define PIKO_SIMD_SSE 1
+    #endif
+#endif
+
+#if defined(PIKO_SIMD_AVX)
+    #include <immintrin.h>
+#elif defined(PIKO_SIMD_SSE)
+    #include <emmintrin.h>
+#endif
+
+#if defined(_MSC_VER)
+    #include <malloc.h>
+#endif
+
+
+namespace Piko {
+
+    /** Alignment in bytes used for all SIMD streams (wide enough for AVX registers). */
+    const std::size_t SIMD_ALIGNMENT = 32;
+
+    /**
+     * Function to allocate memory with the specified alignment. Memory has to be released with
+     * alignedFree().
+     *
+     * @param bytes Number of bytes to allocate.
+     * @param alignment Alignment in bytes, must be a power of two.
+     * @return Pointer to the allocated memory.
+     * @throws std::bad_alloc If the memory could not be allocated.
+     */
+    inline void* alignedAlloc(std::size_t bytes, std::size_t alignment = SIMD_ALIGNMENT) {
+
+        if(bytes == 0) bytes = alignment;
+
+#if defined(_MSC_VER)
+        void* ptr = _aligned_malloc(bytes, alignment);
+#else
+        void* ptr = NULL;
+        if(posix_memalign(&ptr, alignment, bytes) != 0) ptr = NULL;
+#endif
+
+        if(!ptr) throw std::bad_alloc();
+        return ptr;
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    /**
+     * Function to release memory allocated with alignedAlloc().
+     *
+     * @param ptr Pointer to the memory to release. May be NULL.
+     */
+    inline void alignedFree(void* ptr) {
+
+#if defined(_MSC_VER)
+        _aligned_free(ptr);
+#else
+        free(ptr);
+#endif
+    }
+
+
+
+    /*==========================================
+     * FLOAT PACKS
+     *=========================================*/
+
+    namespace simd {
+
+#if defined(PIKO_SIMD_AVX)
+
+        typedef __m256 Pack;                        /**< Register holding PACK_SIZE floats. */
+        const std::size_t PACK_SIZE = 8;            /**< Number of floats in a pack. */
+
+        inline Pack load(const float* p)            { return _mm256_loadu_ps(p); }
+        inline void store(float* p, Pack a)         { _mm256_storeu_ps(p, a); }
+        inline Pack set1(float s)                   { return _mm256_set1_ps(s); }
+        inline Pack zero()                          { return _mm256_setzero_ps(); }
+        inline Pack add(Pack a, Pack b)             { return _mm256_add_ps(a, b); }
+        inline Pack sub(Pack a, Pack b)             { return _mm256_sub_ps(a, b); }
+        inline Pack mul(Pack a, Pack b)             { return _mm256_mul_ps(a, b); }
+        inline Pack div(Pack a, Pack b)             { return _mm256_div_ps(a, b); }
+        inline Pack sqrt(Pack a)                    { return _mm256_sqrt_ps(a); }
+        inline Pack rsqrt(Pack a)                   { return _mm256_rsqrt_ps(a); }
+        inline Pack min(Pack a, Pack b)             { return _mm256_min_ps(a, b); }
+        inline Pack max(Pack a, Pack b)             { return _mm256_max_ps(a, b); }
+        inline Pack cmpgt(Pack a, Pack b)           { return _mm256_cmp_ps(a, b, _CMP_GT_OQ); }
+        inline Pack cmplt(Pack a, Pack b)           { return _mm256_cmp_ps(a, b, _CMP_LT_OQ); }
+        inline Pack andp(Pack a, Pack b)            { return _mm256_and_ps(a, b); }
+        inline Pack orp(Pack a, Pack b)             { return _mm256_or_ps(a, b); }
+        inline Pack select(Pack m, Pack a, Pack b)  { return _mm256_blendv_ps(b, a, m); }
+        inline int mask(Pack m)                     { return _mm256_movemask_ps(m); }
+
+#elif defined(PIKO_SIMD_SSE)
+
+        typedef __m128 Pack;                        /**< Register holding PACK_SIZE floats. */
+        const std::size_t PACK_SIZE = 4;            /**< Number of floats in a pack. */
+
+        inline Pack load(const float* p)            { return _mm_loadu_ps(p); }
+        inline void store(float* p, Pack a)         { _mm_storeu_ps(p, a); }
+        inline Pack set1(float s)                   { return _mm_set1_ps(s); }
+        inline Pack zero()                          { return _mm_setzero_ps(); }
+        inline Pack add(Pack a, Pack b)             { return _mm_add_ps(a, b); }
+        inline Pack sub(Pack a, Pack b)             { return _mm_sub_ps(a, b); }
+        inline Pack mul(Pack a, Pack b)             { return _mm_mul_ps(a, b); }
+        inline Pack div(Pack a, Pack b)             { return _mm_div_ps(a, b); }
+        inline Pack sqrt(Pack a)                    { return _mm_sqrt_ps(a); }
+        inline Pack rsqrt(Pack a)                   { return _mm_rsqrt_ps(a); }
+        inline Pack min(Pack a, Pack b)             { return _mm_min_ps(a, b); }
+        inline Pack max(Pack a, Pack b)             { return _mm_max_ps(a, b); }
+        inline Pack cmpgt(Pack a, Pack b)           { return _mm_cmpgt_ps(a, b); }
+        inline Pack cmplt(Pack a, Pack b)           { return _mm_cmplt_ps(a, b); }
+        inline Pack andp(Pack a, Pack b)            { return _mm_and_ps(a, b); }
+        inline Pack orp(Pack a, Pack b)             { return _mm_or_ps(a, b); }
+        inline int mask(Pack m)                     { return _mm_movemask_ps(m); }
+
+        inline Pack select(Pack m, Pack a, Pack b) {
+            return _mm_or_ps(_mm_and_ps(m, a), _mm_andnot_ps(m, b));
+        }
+
+#else
+
+        const std::size_t PACK_SIZE = 1;            /**< No SIMD available, scalar fallback. */
+
+#endif
+
+    } /* Namespace simd */
+
+} /* Namespace Piko */
+
+#endif // End of SIMD_H
@@ -0,0 +1,223 @@
+/**
+ * @file        SPSCRing.h
+ * @author      Robert Koch
+ * @version     1.0
+ *
+ * This file contains a bounded lock-free ring buffer for exactly one producer thread and exactly
+ * one consumer thread.
+ */
+#ifndef SPSCRING_H
+#define SPSCRING_H
+
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+
+namespace Piko {
+
+    /** Assumed size of a cache line, used to keep producer and consumer state apart. */
+    const std::size_t CACHE_LINE_SIZE = 64;
+
+    /**
+     * Bounded single-producer/single-consumer queue. push() may only be called by one thread and
+     * pop() only by one other thread; neither ever blocks or allocates. The producer and the
+     * consumer each keep a cached copy of the other side's index, so the shared indices are only
+     * read when the cached copy says the ring looks full or empty.
+     */
+    template<typename T>
+    class SPSCRing final {
+
+        public:
+
+            /**
+             * Constructor to create a ring holding at least the specified number of elements.
+             *
+             * @param capacity Minimum capacity, rounded up to the next power of two.
+             */
+            explicit SPSCRing(std::size_t capacity);
+
+            /**
+             * Function to append an element. Producer only.
+             *
+             * @param value Element to append.
+             *
+             * @return False if the ring is full and the element was not appended, otherwise true.
+             */
+            bool push(const T& value);
+
+            /**
+             * Function to remove the oldest element. Consumer only.
+             *
+             * @param value Receives the removed element.
+             *
+             * @return False if the ring is empty, otherwise true.
+             */
+            bool pop(T& value);
+
+            /**
+             * Function to remove up to the specified number of the oldest elements at once.
+             * Consumer only.
+             *
+             * @param values Receives the removed elements in order.
+             * @param count Maximum number of elements to remove.
+             *
+             * @return Number of elements removed.
+             */
+            std::size_t pop(T* values, std::size_t count);
+
+            /**
+             * Function to get the number of stored elements. Only a snapshot if called while the
+             * other side is active.
+             *
+             * @return Number of elements.
+             */
+            std::size_t size() const;
+
+            /**
+             * Function to check if the ring is empty. Only a snapshot if called while the other
+             * side is active.
+             *
+             * @return True if no element is stored, otherwise false.
+             */
+            bool empty() const;
+
+            /**
+             * Function to get the maximum number of elements.
+             *
+             * @return Capacity.
+             */
+            std::size_t capacity() const;
+
+
+        private:
+
+            std::vector<T> m_buffer;                        /**< Element storage. */
+            std::size_t m_mask;                             /**< Capacity - 1. */
+
+            char m_pad0[CACHE_LINE_SIZE];
+            std::atomic<std::size_t> m_head;                /**< Next element to pop. */
+            std::size_t m_cachedTail;                       /**< Consumer copy of m_tail. */
+
+            char m_pad1[CACHE_LINE_SIZE];
+            std::atomic<std::size_t> m_tail;                /**< Next free slot. */
+            std::size_t m_cachedHead;                       /**< Producer copy of m_head. */
+
+            char m_pad2[CACHE_LINE_SIZE];
+
+            /**
+             * Copy constructor is forbidden.
+             */
+            SPSCRing(const SPSCRing<T>& ring);
+
+            /**
+             * Assignment operator is forbidden.
+             */
+            SPSCRing<T>& operator=(const SPSCRing<T>& ring);
+
+    }; /* Class SPSCRing */
+
+
+
+    /*==========================================
+     * INLINE IMPLEMENTATION
+     *=========================================*/
+
+    template<typename T>
+    inline SPSCRing<T>::SPSCRing(std::size_t capacity)
+      :
+      m_mask(0),
+      m_head(0),
+      m_cachedTail(0),
+      m_tail(0),
+      m_cachedHead(0) {
+
+        std::size_t size = 1;
+        while(size < capacity) size <<= 1;
+
+        m_buffer.resize(size);
+        m_mask = size - 1;
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    template<typename T>
+    inline bool SPSCRing<T>::push(const T& value) {
+
+        const std::size_t tail = m_tail.load(std::memory_order_relaxed);
+
+        if(tail - m_cachedHead > m_mask) {
+            m_cachedHead = m_head.load(std::memory_order_acquire);
+            if(tail - m_cachedHead > m_mask) return false;
+        }
+
+        m_buffer[tail & m_mask] = value;
+        m_tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    template<typename T>
+    inline bool SPSCRing<T>::pop(T& value) {
+
+        return pop(&value, 1) == 1;
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    template<typename T>
+    inline std::size_t SPSCRing<T>::pop(T* values, std::size_t count) {
+
+        const std::size_t head = m_head.load(std::memory_order_relaxed);
+
+        if(m_cachedTail - head < count) {
+            m_cachedTail = m_tail.load(std::memory_order_acquire);
+        }
+
+        const std::size_t available = m_cachedTail - head;
+        if(count > available) count = available;
+
+        for(std::size_t i = 0; i < count; ++i) {
+            values[i] = m_buffer[(head + i) & m_mask];
+        }
+
+        m_head.store(head + count, std::memory_order_release);
+        return count;
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    template<typename T>
+    inline std::size_t SPSCRing<T>::size() const {
+
+        const std::size_t head = m_head.load(std::memory_order_acquire);
+        return m_tail.load(std::memory_order_acquire) - head;
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    template<typename T>
+    inline bool SPSCRing<T>::empty() const {
+
+        return size() == 0;
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    template<typename T>
+    inline std::size_t SPSCRing<T>::capacity() const {
+
+        return m_buffer.size();
+    }
+
+
+} /* Namespace Piko */
+
+#endif // End of SPSCRING_H
@@ -0,0 +1,207 @@
+/**
+ * @file        StlAllocator.h
+ * @author      Robert Koch
+ * @version     1.0
+ *
+ * Adapters to use a LinearArena or a BlockPool as allocator of standard containers.
+ */
+#ifndef STLALLOCATOR_H
+#define STLALLOCATOR_H
+
+#include <cstddef>
+#include <new>
+
+#include "../BlockPool.h"
+#include "../LinearArena.h"
+
+
+namespace Piko {
+
+    /**
+     * Standard allocator taking memory from a LinearArena. Deallocation does nothing, the memory
+     * is released when the arena is reset, so a container using it must not outlive the reset.
+     * Well suited for temporary vectors built and dropped within a frame or a ScratchScope.
+     */
+    template<typename T>
+    class ArenaAllocator {
+
+        public:
+
+            typedef T value_type;
+
+            /**
+             * Constructor to create an allocator for an arena.
+             *
+             * @param arena Arena providing the memory.
+             */
+            explicit ArenaAllocator(LinearArena& arena) : m_arena(&arena) { }
+
+            /**
+             * Constructor to convert an allocator of another type.
+             *
+             * @param other Allocator to convert.
+             */
+            template<typename U>
+            ArenaAllocator(const ArenaAllocator<U>& other) : m_arena(&other.getArena()) { }
+
+            /**
+             * Function to allocate an uninitialized array.
+             *
+             * @param count Number of elements.
+             *
+             * @return Pointer to the first element.
+             */
+            T* allocate(std::size_t count) {
+
+                return m_arena->allocateArray<T>(count);
+            }
+
+            /**
+             * Function to release an array, which does nothing.
+             */
+            void deallocate(T*, std::size_t) { }
+
+            /**
+             * Function to get the arena of the allocator.
+             *
+             * @return Arena providing the memory.
+             */
+            LinearArena& getArena() const {
+
+                return *m_arena;
+            }
+
+        private:
+
+            LinearArena* m_arena;       /**< Arena providing the memory. */
+
+    }; /* Class ArenaAllocator */
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    template<typename T, typename U>
+    inline bool operator==(const ArenaAllocator<T>& a, const ArenaAllocator<U>& b) {
+
+        return &a.getArena() == &b.getArena();
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    template<typename T, typename U>
+    inline bool operator!=(const ArenaAllocator<T>& a, const ArenaAllocator<U>& b) {
+
+        return !(a == b);
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    /**
+     * Standard allocator taking single elements from a BlockPool, for node based containers like
+     * std::list, std::set or std::map. Requests the pool cannot serve, i.e. arrays or elements
+     * larger or more aligned than its blocks, fall back to the global operator new. As the node
+     * type of a container is not known in advance, size the pool with the node size in mind,
+     * e.g. sizeof(T) plus three pointers for std::map.
+     */
+    template<typename T>
+    class PoolAllocator {
+
+        public:
+
+            typedef T value_type;
+
+            /**
+             * Constructor to create an allocator for a pool.
+             *
+             * @param pool Pool providing the memory.
+             */
+            explicit PoolAllocator(BlockPool& pool) : m_pool(&pool) { }
+
+            /**
+             * Constructor to convert an allocator of another type.
+             *
+             * @param other Allocator to convert.
+             */
+            template<typename U>
+            PoolAllocator(const PoolAllocator<U>& other) : m_pool(&other.getPool()) { }
+
+            /**
+             * Function to allocate an uninitialized array.
+             *
+             * @param count Number of elements.
+             *
+             * @return Pointer to the first element.
+             *
+             * @throws std::bad_alloc If the memory could not be allocated.
+             */
+            T* allocate(std::size_t count) {
+
+                if(isPooled(count)) return static_cast<T*>(m_pool->allocate());
+                return static_cast<T*>(::operator new(count * sizeof(T)));
+            }
+
+            /**
+             * Function to release an array.
+             *
+             * @param ptr Pointer returned by allocate().
+             * @param count Number of elements passed to allocate().
+             */
+            void deallocate(T* ptr, std::size_t count) {
+
+                if(isPooled(count)) m_pool->deallocate(ptr);
+                else ::operator delete(ptr);
+            }
+
+            /**
+             * Function to get the pool of the allocator.
+             *
+             * @return Pool providing the memory.
+             */
+            BlockPool& getPool() const {
+
+                return *m_pool;
+            }
+
+        private:
+
+            BlockPool* m_pool;          /**< Pool providing the memory. */
+
+            /**
+             * Function to check if a request is served by the pool.
+             *
+             * @param count Number of elements.
+             *
+             * @return True if the pool is used, otherwise false.
+             */
+            bool isPooled(std::size_t count) const {
+
+                return count == 1 && sizeof(T) <= m_pool->getBlockSize() &&
+                       alignof(T) <= m_pool->getAlignment();
+            }
+
+    }; /* Class PoolAllocator */
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    template<typename T, typename U>
+    inline bool operator==(const PoolAllocator<T>& a, const PoolAllocator<U>& b) {
+
+        return &a.getPool() == &b.getPool();
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    template<typename T, typename U>
+    inline bool operator!=(const PoolAllocator<T>& a, const PoolAllocator<U>& b) {
+
+        return !(a == b);
+    }
+
+} /* Namespace Piko */
+
+
+#endif // End of STLALLOCATOR_H
@@ -0,0 +1,449 @@
+/**
+ * @file        SweepAndPrune.h
+ * @author      Robert Koch
+ * @version     1.0
+ *
+ * This file contains a sweep-and-prune broadphase finding the overlapping pairs among a set of
+ * moving axis-aligned boxes.
+ */
+#ifndef SWEEPANDPRUNE_H
+#define SWEEPANDPRUNE_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "AABB.h"
+#include "Vector3D.h"
+
+
+namespace Piko {
+
+    /**
+     * Broadphase keeping the boxes of all bodies sorted by their minimum along one axis. Between
+     * frames bodies move only a little, so the order is restored by an insertion sort in close to
+     * linear time. The sweep then only compares each box with the boxes starting before its end
+     * on the sort axis. If the order changed too much, e.g. after adding many bodies or
+     * teleporting them, the insertion sort gives up and the array is sorted from scratch.
+     *
+     * The sort axis follows the spread of the bodies: if another axis has clearly more variance
+     * of the box centers, the next findPairs() switches to it, which keeps the number of
+     * candidates per box low for scenes spread along one direction.
+     */
+    template<typename T>
+    class SweepAndPrune final {
+
+        public:
+
+            /** Pair of overlapping bodies, the smaller id first. */
+            typedef std::pair<std::uint32_t, std::uint32_t> Pair;
+
+            /** Number of moves per body after which the insertion sort falls back to a sort. */
+            static const std::size_t MAX_MOVES_PER_BODY = 8;
+
+            /**
+             * Standard constructor to create an empty broadphase sorting along the x axis.
+             */
+            SweepAndPrune();
+
+            /**
+             * Function to add a body. The ids of removed bodies are reused.
+             *
+             * @param box Bounding box of the body.
+             * @return Id of the body.
+             */
+            std::uint32_t add(const AABB<T>& box);
+
+            /**
+             * Function to remove a body. The body is not reported in any pair from now on, its id
+             * becomes free during the next findPairs().
+             *
+             * @param body Id of a body which was not removed yet.
+             */
+            void remove(std::uint32_t body);
+
+            /**
+             * Function to move a body.
+             *
+             * @param body Id of the body.
+             * @param box New bounding box.
+             */
+            void update(std::uint32_t body, const AABB<T>& box);
+
+            /**
+             * Function to get the box of a body.
+             *
+             * @param body Id of the body.
+             * @return Bounding box.
+             */
+            const AABB<T>& getBox(std::uint32_t body) const;
+
+            /**
+             * Function to remove all bodies.
+             */
+            void clear();
+
+            /**
+             * Function to restore the order and find all pairs of bodies whose boxes overlap.
+             * Touching boxes overlap.
+             *
+             * @param pairs Receives the pairs, in no particular order.
+             */
+            void findPairs(std::vector<Pair>& pairs);
+
+            /**
+             * Function to get the number of bodies.
+             *
+             * @return Number of bodies not removed.
+             */
+            std::size_t size() const;
+
+            /**
+             * Function to get the axis the boxes are sorted along.
+             *
+             * @return 0, 1 or 2 for the x, y or z axis.
+             */
+            int getSortAxis() const;
+
+            /**
+             * Function to get the number of moves the insertion sort of the last findPairs()
+             * needed, a measure of the motion coherence.
+             *
+             * @return Number of moved entries, or the number of bodies if the array was sorted
+             *         from scratch.
+             */
+            std::size_t getMoveCount() const;
+
+        private:
+
+            /**
+             * Body in the sorted array.
+             */
+            struct Entry {
+                T min;                      /**< Minimum on the sort axis. */
+                T max;                      /**< Maximum on the sort axis. */
+                T min1;                     /**< Minimum on the next axis. */
+                T max1;                     /**< Maximum on the next axis. */
+                T min2;                     /**< Minimum on the last axis. */
+                T max2;                     /**< Maximum on the last axis. */
+                std::uint32_t body;         /**< Id of the body. */
+            };
+
+            std::vector<Entry> m_entries;           /**< Bodies sorted by their minimum. */
+            std::vector<AABB<T> > m_boxes;          /**< Box of each body. */
+            std::vector<std::uint32_t> m_slots;     /**< Index of each body in m_entries. */
+            std::vector<char> m_isRemoved;          /**< Flag per id if the body was removed. */
+            std::vector<std::uint32_t> m_free;      /**< Ids free for reuse. */
+            std::size_t m_removed;                  /**< Removed entries still in m_entries. */
+            std::size_t m_moves;                    /**< Moves of the last sort. */
+            int m_axis;                             /**< Sort axis. */
+
+            /**
+             * Function to restore the order with an insertion sort.
+             *
+             * @return False if the move budget was exhausted before the array was sorted.
+             */
+            bool insertionSort();
+
+            /**
+             * Function to sort the array from scratch.
+             */
+            void sortAll();
+
+            /**
+             * Function to set the intervals of an entry from the box of its body.
+             */
+            void setIntervals(Entry& entry) const;
+
+            /**
+             * Function to get a coordinate by axis index.
+             */
+            static T getAxis(const Vector3D<T>& v, int axis);
+
+    }; /* Class SweepAndPrune */
+
+
+
+    /*==========================================
+     * INLINE IMPLEMENTATION
+     *=========================================*/
+
+    template<typename T>
+    const std::size_t SweepAndPrune<T>::MAX_MOVES_PER_BODY;
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    template<typename T>
+    inline SweepAndPrune<T>::SweepAndPrune()
+      :
+      m_removed(0),
+      m_moves(0),
+      m_axis(0) {
+
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    template<typename T>
+    inline std::uint32_t SweepAndPrune<T>::add(const AABB<T>& box) {
+
+        std::uint32_t body;
+
+        if(!m_free.empty()) {
+            body = m_free.back();
+            m_free.pop_back();
+            m_isRemoved[body] = 0;
+        }
+        else {
+            body = (std::uint32_t)m_slots.size();
+            m_slots.push_back(0);
+            m_isRemoved.push_back(0);
+            m_boxes.push_back(box);
+        }
+
+        // Appended unsorted, the next findPairs() moves it into place.
+        Entry entry;
+        entry.body = body;
+        m_boxes[body] = box;
+        setIntervals(entry);
+
+        m_slots[body] = (std::uint32_t)m_entries.size();
+        m_entries.push_back(entry);
+        return body;
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    template<typename T>
+    inline void SweepAndPrune<T>::remove(std::uint32_t body) {
+
+        // An empty box overlaps nothing and sorts behind every other box, where the next
+        // findPairs() cuts it off.
+        m_boxes[body] = AABB<T>();
+        setIntervals(m_entries[m_slots[body]]);
+
+        m_isRemoved[body] = 1;
+        ++m_removed;
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    template<typename T>
+    inline void SweepAndPrune<T>::update(std::uint32_t body, const AABB<T>& box) {
+
+        m_boxes[body] = box;
+        setIntervals(m_entries[m_slots[body]]);
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    template<typename T>
+    inline const AABB<T>& SweepAndPrune<T>::getBox(std::uint32_t body) const {
+
+        return m_boxes[body];
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    template<typename T>
+    inline void SweepAndPrune<T>::clear() {
+
+        m_entries.clear();
+        m_slots.clear();
+        m_boxes.clear();
+        m_isRemoved.clear();
+        m_free.clear();
+        m_removed = 0;
+        m_moves = 0;
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    template<typename T>
+    inline void SweepAndPrune<T>::findPairs(std::vector<Pair>& pairs) {
+
+        pairs.clear();
+
+        if(!insertionSort()) sortAll();
+
+        // Removed bodies sorted to the end.
+        while(m_removed > 0 && m_isRemoved[m_entries.back().body]) {
+            m_free.push_back(m_entries.back().body);
+            m_entries.pop_back();
+            --m_removed;
+        }
+
+        double sum[3] = { 0.0, 0.0, 0.0 };
+        double sumSquared[3] = { 0.0, 0.0, 0.0 };
+
+        const std::size_t count = m_entries.size();
+        const Entry* entries = count > 0 ? &m_entries[0] : NULL;
+
+        for(std::size_t i = 0; i < count; ++i) {
+            const Entry& a = entries[i];
+
+            // Copies, so pushing pairs does not force the compiler to reload them.
+            const T max = a.max;
+            const T min1 = a.min1;
+            const T max1 = a.max1;
+            const T min2 = a.min2;
+            const T max2 = a.max2;
+
+            for(std::size_t j = i + 1; j < count && entries[j].min <= max; ++j) {
+                const Entry& b = entries[j];
+
+                // Most candidates fail on a random one of the tests, a single branch on the
+                // combined result predicts much better than four.
+                const bool isSeparated = (b.min1 > max1) | (b.max1 < min1) |
+                                         (b.min2 > max2) | (b.max2 < min2);
+                if(isSeparated) continue;
+
+                pairs.push_back(a.body < b.body ? Pair(a.body, b.body) : Pair(b.body, a.body));
+            }
+
+            const double c[3] = { ((double)a.min + a.max) * 0.5, ((double)a.min1 + a.max1) * 0.5,
+                                  ((double)a.min2 + a.max2) * 0.5 };
+            for(int k = 0; k < 3; ++k) {
+                const int axis = (m_axis + k) % 3;
+                sum[axis] += c[k];
+                sumSquared[axis] += c[k] * c[k];
+            }
+        }
+
+        if(count < 2) return;
+
+        // Switching costs a full sort, so only switch for a clearly better axis.
+        double variance[3];
+        for(int axis = 0; axis < 3; ++axis) {
+            const double mean = sum[axis] / (double)count;
+            variance[axis] = sumSquared[axis] / (double)count - mean * mean;
+        }
+
+        int best = m_axis;
+        for(int axis = 0; axis < 3; ++axis) {
+            if(variance[axis] > 2.0 * variance[best]) best = axis;
+        }
+
+        if(best != m_axis) {
+            m_axis = best;
+            for(std::size_t i = 0; i < count; ++i) setIntervals(m_entries[i]);
+            sortAll();
+        }
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    template<typename T>
+    inline std::size_t SweepAndPrune<T>::size() const {
+
+        return m_entries.size() - m_removed;
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    template<typename T>
+    inline int SweepAndPrune<T>::getSortAxis() const {
+
+        return m_axis;
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    template<typename T>
+    inline std::size_t SweepAndPrune<T>::getMoveCount() const {
+
+        return m_moves;
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    template<typename T>
+    inline bool SweepAndPrune<T>::insertionSort() {
+
+        const std::size_t count = m_entries.size();
+        const std::size_t budget = MAX_MOVES_PER_BODY * count;
+
+        m_moves = 0;
+
+        for(std::size_t i = 1; i < count; ++i) {
+            if(!(m_entries[i].min < m_entries[i - 1].min)) continue;
+
+            const Entry entry = m_entries[i];
+            std::size_t j = i;
+
+            do {
+                m_entries[j] = m_entries[j - 1];
+                m_slots[m_entries[j].body] = (std::uint32_t)j;
+                --j;
+            } while(j > 0 && entry.min < m_entries[j - 1].min);
+
+            m_entries[j] = entry;
+            m_slots[entry.body] = (std::uint32_t)j;
+
+            m_moves += i - j;
+            if(m_moves > budget) return false;
+        }
+
+        return true;
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    template<typename T>
+    inline void SweepAndPrune<T>::sortAll() {
+
+        std::sort(m_entries.begin(), m_entries.end(), [](const Entry& a, const Entry& b) {
+            return a.min < b.min;
+        });
+
+        for(std::size_t i = 0; i < m_entries.size(); ++i) {
+            m_slots[m_entries[i].body] = (std::uint32_t)i;
+        }
+
+        m_moves = m_entries.size();
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    template<typename T>
+    inline void SweepAndPrune<T>::setIntervals(Entry& entry) const {
+
+        const AABB<T>& box = m_boxes[entry.body];
+        const int axis1 = (m_axis + 1) % 3;
+        const int axis2 = (m_axis + 2) % 3;
+
+        entry.min = getAxis(box.getMin(), m_axis);
+        entry.max = getAxis(box.getMax(), m_axis);
+        entry.min1 = getAxis(box.getMin(), axis1);
+        entry.max1 = getAxis(box.getMax(), axis1);
+        entry.min2 = getAxis(box.getMin(), axis2);
+        entry.max2 = getAxis(box.getMax(), axis2);
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    template<typename T>
+    inline T SweepAndPrune<T>::getAxis(const Vector3D<T>& v, int axis) {
+
+        return axis == 0 ? v.x() : (axis == 1 ? v.y() : v.z());
+    }
+
+} /* Namespace Piko */
+
+#endif // End of SWEEPANDPRUNE_H
@@ -8,22 +8,27 @@
 #ifndef VECTOR3D_H
 #define VECTOR3D_H
 
+#include <cmath>
 #include <iostream>
 
-#include "../ErrorMessage.h"
+#include "Precision.h"
+#include "Vector3DExpr.h"
 
 
 namespace Piko {
 
     /**
      * Class declaring a 3-dimensional, mathematical vector. Several arithmetic operations can be
-     * used on instances of this class.
+     * used on instances of this class. If PIKO_VECTOR3D_EXPRESSION_TEMPLATES is defined, the
+     * binary operators are replaced by the lazy ones declared in Vector3DExpr.h.
      */
     template<typename T>
-    class Vector3D final {
+    class Vector3D final : public Vector3DExpr<Vector3D<T>> {
     
         public:
 
+            typedef T value_type;   /**< Type of the coordinates. */
+
             /**
              * Standard constructor to create a vector with the coordinates (0,0,0).
              */
@@ -38,6 +43,24 @@ namespace Piko {
              */
             Vector3D(const T& x, const T& y, const T& z);
 
+            /**
+             * Constructor to evaluate a vector expression.
+             * 
+             * @param e Expression to evaluate.
+             */
+            template<typename E>
+            Vector3D(const Vector3DExpr<E>& e);
+
+            /**
+             * Function to assign the result of a vector expression. The expression may refer to
+             * the calling instance.
+             * 
+             * @param e Expression to evaluate.
+             * @return Reference to the calling instance.
+             */
+            template<typename E>
+            const Vector3D<T>& operator=(const Vector3DExpr<E>& e);
+
             /**
              * Function to get the x-coordinate.
              * 
@@ -59,13 +82,15 @@ namespace Piko {
              */
             const T& z() const;
 
+#if !defined(PIKO_VECTOR3D_EXPRESSION_TEMPLATES)
+
             /**
              * Function add two vectors.
              * 
              * @param v Vector to add.
              * @return Sum of the vectors.
              */
-            const Vector3D<T> operator+(const Vector3D<T>& v) const;
+            Vector3D<T> operator+(const Vector3D<T>& v) const;
 
             /**
              * Function to subtract two vectors.
@@ -73,7 +98,7 @@ namespace Piko {
              * @param v Vector to subtract.
              * @return Difference of the vectors.
              */
-            const Vector3D<T> operator-(const Vector3D<T>& v) const;
+            Vector3D<T> operator-(const Vector3D<T>& v) const;
 
             /**
              * Function to scalar mutliply two vectors.
@@ -81,7 +106,7 @@ namespace Piko {
              * @param v Vector to scalar multiply with.
              * @return Scalar product of the vectors.
              */
-            const T operator*(const Vector3D<T>& v) const;            
+            T operator*(const Vector3D<T>& v) const;
 
             /**
              * Function to mutliply the vector with a scalar.
@@ -89,7 +114,7 @@ namespace Piko {
              * @param v Scalar to multiply with.
              * @return Product of vector and scalar.
              */
-            const Vector3D<T> operator*(const T& s) const;
+            Vector3D<T> operator*(const T& s) const;
 
             /**
              * Function to divide the vector through a scalar.
@@ -97,7 +122,7 @@ namespace Piko {
              * @param v Scalar to divide through.
              * @return Quotient of vector and scalar.
              */
-            const Vector3D<T> operator/(const T& s) const;
+            Vector3D<T> operator/(const T& s) const;
             
             /**
              * Function to get the vector product of the two vectors.
@@ -105,7 +130,9 @@ namespace Piko {
              * @param v Vector to multiply with.
              * @return Vector product of the vectors.
              */
-            const Vector3D<T> operator^(const Vector3D<T>& v) const;
+            Vector3D<T> operator^(const Vector3D<T>& v) const;
+
+#endif
 
             /**
              * Function to add a vector to the calling instance.
@@ -123,6 +150,24 @@ namespace Piko {
              */
             const Vector3D<T>& operator-=(const Vector3D<T>& v);
 
+            /**
+             * Function to add the result of a vector expression to the calling instance.
+             * 
+             * @param e Expression to add.
+             * @return Sum of the vectors.
+             */
+            template<typename E>
+            const Vector3D<T>& operator+=(const Vector3DExpr<E>& e);
+
+            /**
+             * Function to subtract the result of a vector expression from the calling instance.
+             * 
+             * @param e Expression to subtract.
+             * @return Difference of the vectors.
+             */
+            template<typename E>
+            const Vector3D<T>& operator-=(const Vector3DExpr<E>& e);
+
             /**
              * Function to multiply the calling instance with a scalar.
              * 
@@ -157,24 +202,29 @@ namespace Piko {
             void setPosition(const T& x, const T& y, const T& z);
 
             /**
-             * Function to normalize the vector.
+             * Function to normalize the vector. A vector of zero length becomes (0,0,0).
+             * 
+             * @tparam P Precision policy, see Precision.h.
              */
+            template<typename P = ExactPrecision>
             void normalize();
 
             /**
              * Function to get the normalization of the vector. This will not change the vector
-             * itself.
+             * itself. A vector of zero length yields (0,0,0).
              * 
+             * @tparam P Precision policy, see Precision.h.
              * @return Vector normalization.
              */
-            const Vector3D<T> getNormalization() const;
+            template<typename P = ExactPrecision>
+            Vector3D<T> getNormalization() const;
 
             /**
              * Function to get the magnitude of the vector.
              * 
              * @return Magnitude.
              */
-            const T getMagnitude() const;
+            T getMagnitude() const;
             
 
             /**
@@ -222,6 +272,37 @@ namespace Piko {
     //---------------------------------------------------------------------------------------------
     //---------------------------------------------------------------------------------------------
 
+    template<typename T>
+    template<typename E>
+    inline Vector3D<T>::Vector3D(const Vector3DExpr<E>& e)
+      :
+      m_x(e.self().x()),
+      m_y(e.self().y()),
+      m_z(e.self().z()) {
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    template<typename T>
+    template<typename E>
+    inline const Vector3D<T>& Vector3D<T>::operator=(const Vector3DExpr<E>& e) {
+
+        // Evaluate completely before writing, the expression may refer to this vector.
+        T tmpX = e.self().x();
+        T tmpY = e.self().y();
+        T tmpZ = e.self().z();
+
+        m_x = tmpX;
+        m_y = tmpY;
+        m_z = tmpZ;
+
+        return *this;
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
     template<typename T>
     inline const T& Vector3D<T>::x() const {
         return m_x;
@@ -246,8 +327,10 @@ namespace Piko {
     //---------------------------------------------------------------------------------------------
     //---------------------------------------------------------------------------------------------
 
+#if !defined(PIKO_VECTOR3D_EXPRESSION_TEMPLATES)
+
     template<typename T>
-    inline const Vector3D<T> Vector3D<T>::operator+(const Vector3D<T>& v) const {
+    inline Vector3D<T> Vector3D<T>::operator+(const Vector3D<T>& v) const {
         return Vector3D<T>(m_x + v.m_x, m_y + v.m_y, m_z + v.m_z);
     }
 
@@ -255,7 +338,7 @@ namespace Piko {
     //---------------------------------------------------------------------------------------------
 
     template<typename T>
-    inline const Vector3D<T> Vector3D<T>::operator-(const Vector3D<T>& v) const {
+    inline Vector3D<T> Vector3D<T>::operator-(const Vector3D<T>& v) const {
         return Vector3D<T>(m_x - v.m_x, m_y - v.m_y, m_z - v.m_z);
     }
 
@@ -263,7 +346,7 @@ namespace Piko {
     //---------------------------------------------------------------------------------------------
 
     template<typename T>
-    inline const T Vector3D<T>::operator*(const Vector3D<T>& v) const {
+    inline T Vector3D<T>::operator*(const Vector3D<T>& v) const {
         return (m_x * v.m_x) + (m_y * v.m_y) + (m_z * v.m_z);
     }
 
@@ -271,7 +354,7 @@ namespace Piko {
     //---------------------------------------------------------------------------------------------
 
     template<typename T>
-    inline const Vector3D<T> Vector3D<T>::operator*(const T& s) const {
+    inline Vector3D<T> Vector3D<T>::operator*(const T& s) const {
         return Vector3D<T>(m_x * s, m_y * s, m_z * s);
     }
 
@@ -279,7 +362,7 @@ namespace Piko {
     //---------------------------------------------------------------------------------------------
 
     template<typename T>
-    inline const Vector3D<T> Vector3D<T>::operator/(const T& s) const {
+    inline Vector3D<T> Vector3D<T>::operator/(const T& s) const {
         return Vector3D<T>(m_x / s, m_y / s, m_z / s);
     }
 
@@ -287,7 +370,7 @@ namespace Piko {
     //---------------------------------------------------------------------------------------------
 
     template<typename T>
-    inline const Vector3D<T> Vector3D<T>::operator^(const Vector3D<T>& v) const {
+    inline Vector3D<T> Vector3D<T>::operator^(const Vector3D<T>& v) const {
         
         T tmpX = (m_y * v.m_z) - (m_z * v.m_y);
         T tmpY = (m_z * v.m_x) - (m_x * v.m_z);
@@ -296,6 +379,8 @@ namespace Piko {
         return Vector3D<T>(tmpX, tmpY, tmpZ);
     }
 
+#endif
+
     //---------------------------------------------------------------------------------------------
     //---------------------------------------------------------------------------------------------
     
@@ -321,6 +406,42 @@ namespace Piko {
     //---------------------------------------------------------------------------------------------
     //---------------------------------------------------------------------------------------------
 
+    template<typename T>
+    template<typename E>
+    inline const Vector3D<T>& Vector3D<T>::operator+=(const Vector3DExpr<E>& e) {
+
+        T tmpX = e.self().x();
+        T tmpY = e.self().y();
+        T tmpZ = e.self().z();
+
+        m_x += tmpX;
+        m_y += tmpY;
+        m_z += tmpZ;
+
+        return *this;
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    template<typename T>
+    template<typename E>
+    inline const Vector3D<T>& Vector3D<T>::operator-=(const Vector3DExpr<E>& e) {
+
+        T tmpX = e.self().x();
+        T tmpY = e.self().y();
+        T tmpZ = e.self().z();
+
+        m_x -= tmpX;
+        m_y -= tmpY;
+        m_z -= tmpZ;
+
+        return *this;
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
     template<typename T>
     inline const Vector3D<T>& Vector3D<T>::operator*=(const T& s) {
         m_x *= s;
@@ -372,39 +493,51 @@ namespace Piko {
     //---------------------------------------------------------------------------------------------
     
     template<typename T>
+    template<typename P>
     inline void Vector3D<T>::normalize() {
 
-        T mag = getMagnitude();
+        T sq = m_x * m_x + m_y * m_y + m_z * m_z;
+
+        if(!(sq > P::template threshold<T>())) {
+            m_x = m_y = m_z = T(0);
+            return;
+        }
+
+        T f = P::factor(sq);
 
-        m_x /= mag;
-        m_y /= mag;
-        m_z /= mag;
+        m_x = P::apply(m_x, f);
+        m_y = P::apply(m_y, f);
+        m_z = P::apply(m_z, f);
     }
 
     //---------------------------------------------------------------------------------------------
     //---------------------------------------------------------------------------------------------
     
     template<typename T>
-    inline const Vector3D<T> Vector3D<T>::getNormalization() const {
+    template<typename P>
+    inline Vector3D<T> Vector3D<T>::getNormalization() const {
         
-        T mag = getMagnitude();
+        Vector3D<T> tmp(m_x, m_y, m_z);
+        tmp.template normalize<P>();
 
-        T tmpX = m_x / mag;
-        T tmpY = m_y / mag;
-        T tmpZ = m_z / mag;
-
-        return Vector3D<T>(tmpX, tmpY, tmpZ);
+        return tmp;
     }
 
     //---------------------------------------------------------------------------------------------
     //---------------------------------------------------------------------------------------------
 
     template<typename T>
-    inline const T Vector3D<T>::getMagnitude() const {
+    inline T Vector3D<T>::getMagnitude() const {
+        using std::sqrt;
         return sqrt(m_x * m_x + m_y * m_y + m_z * m_z);
     }
 
 
 } /* Namespace Piko */
 
+
+#if defined(PIKO_SIMD_VECTOR3D)
+    #include "Vector3DSIMD.h"
+#endif
+
 #endif // End of VECTOR3D_H
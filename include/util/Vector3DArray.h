@@ -0,0 +1,988 @@
+/**
+ * @file        Vector3DArray.h
+ * @author      Robert Koch
+ * @version     1.0
+ *
+ * This file contains a structure-of-arrays container for 3-dimensional vectors and the batched
+ * kernels operating on it. The x-, y- and z-coordinates are kept in separate, aligned streams so
+ * the kernels can process several vectors per instruction.
+ */
+#ifndef VECTOR3DARRAY_H
+#define VECTOR3DARRAY_H
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+#include "SIMD.h"
+#include "Vector3D.h"
+
+
+namespace Piko {
+
+    /**
+     * Container storing a sequence of 3-dimensional vectors as three separate coordinate streams.
+     * Each stream is aligned to SIMD_ALIGNMENT and padded to a multiple of the widest SIMD
+     * register, so the batch kernels never have to deal with misaligned stream starts.
+     */
+    template<typename T>
+    class Vector3DArray final {
+
+        public:
+
+            /**
+             * Standard constructor to create an empty array.
+             */
+            Vector3DArray();
+
+            /**
+             * Constructor to create an array holding the specified number of (0,0,0) vectors.
+             *
+             * @param size Number of vectors.
+             */
+            explicit Vector3DArray(std::size_t size);
+
+            /**
+             * Constructor to convert an array of vectors into the structure-of-arrays layout.
+             *
+             * @param vectors First vector to convert.
+             * @param count Number of vectors to convert.
+             */
+            Vector3DArray(const Vector3D<T>* vectors, std::size_t count);
+
+            /**
+             * Constructor to convert a vector of vectors into the structure-of-arrays layout.
+             *
+             * @param vectors Vectors to convert.
+             */
+            explicit Vector3DArray(const std::vector<Vector3D<T>>& vectors);
+
+            /**
+             * Copy constructor.
+             *
+             * @param other Array to copy.
+             */
+            Vector3DArray(const Vector3DArray<T>& other);
+
+            /**
+             * Move constructor. The moved from array is left empty.
+             *
+             * @param other Array to move.
+             */
+            Vector3DArray(Vector3DArray<T>&& other);
+
+            /**
+             * Destructor releasing the coordinate streams.
+             */
+            ~Vector3DArray();
+
+            /**
+             * Assignment operator for copy and move assignment.
+             *
+             * @param other Array to assign.
+             * @return Reference to the calling instance.
+             */
+            Vector3DArray<T>& operator=(Vector3DArray<T> other);
+
+            /**
+             * Function to get the number of vectors stored.
+             *
+             * @return Number of vectors.
+             */
+            std::size_t size() const;
+
+            /**
+             * Function to get the number of vectors which can be stored without reallocation.
+             *
+             * @return Capacity.
+             */
+            std::size_t capacity() const;
+
+            /**
+             * Function to check if the array is empty.
+             *
+             * @return True if no vectors are stored, otherwise false.
+             */
+            bool empty() const;
+
+            /**
+             * Function to change the number of vectors stored. New vectors are set to (0,0,0).
+             *
+             * @param size New number of vectors.
+             */
+            void resize(std::size_t size);
+
+            /**
+             * Function to reserve memory for at least the specified number of vectors.
+             *
+             * @param capacity Number of vectors to reserve memory for.
+             */
+            void reserve(std::size_t capacity);
+
+            /**
+             * Function to remove all vectors. The memory is kept.
+             */
+            void clear();
+
+            /**
+             * Function to append a vector at the end of the array.
+             *
+             * @param v Vector to append.
+             */
+            void push_back(const Vector3D<T>& v);
+
+            /**
+             * Function to get the vector at the specified position.
+             *
+             * @param i Index of the vector.
+             * @return Vector at the position.
+             */
+            Vector3D<T> get(std::size_t i) const;
+
+            /**
+             * Function to set the vector at the specified position.
+             *
+             * @param i Index of the vector.
+             * @param v New vector.
+             */
+            void set(std::size_t i, const Vector3D<T>& v);
+
+            /**
+             * Function to replace the content of the array with the specified vectors.
+             *
+             * @param vectors First vector to convert.
+             * @param count Number of vectors to convert.
+             */
+            void load(const Vector3D<T>* vectors, std::size_t count);
+
+            /**
+             * Function to write the stored vectors back into an array of vectors.
+             *
+             * @param vectors Destination which must provide space for size() vectors.
+             */
+            void store(Vector3D<T>* vectors) const;
+
+            /**
+             * Function to convert the array back into a vector of vectors.
+             *
+             * @return Vectors stored in this array.
+             */
+            std::vector<Vector3D<T>> toVector() const;
+
+            /**
+             * Function to exchange the content of two arrays.
+             *
+             * @param other Array to swap with.
+             */
+            void swap(Vector3DArray<T>& other);
+
+            /**
+             * Functions to access the aligned x-coordinate stream.
+             *
+             * @return First x-coordinate.
+             */
+            T* x();
+            const T* x() const;
+
+            /**
+             * Functions to access the aligned y-coordinate stream.
+             *
+             * @return First y-coordinate.
+             */
+            T* y();
+            const T* y() const;
+
+            /**
+             * Functions to access the aligned z-coordinate stream.
+             *
+             * @return First z-coordinate.
+             */
+            T* z();
+            const T* z() const;
+
+
+        private:
+
+            /** Number of elements each stream is padded to (one AVX register of floats). */
+            static const std::size_t PADDING = 8;
+
+            T* m_data;              /**< Memory block holding the three streams one after another. */
+            std::size_t m_size;     /**< Number of vectors stored. */
+            std::size_t m_capacity; /**< Number of elements reserved per stream. */
+
+            /**
+             * Function to move the streams into a new memory block of the specified capacity.
+             *
+             * @param capacity New capacity, already padded.
+             */
+            void reallocate(std::size_t capacity);
+
+            /**
+             * Function to round the specified number of elements up to the stream padding.
+             *
+             * @param count Number of elements.
+             * @return Padded number of elements.
+             */
+            static std::size_t padded(std::size_t count);
+
+
+    }; /* Class Vector3DArray */
+
+
+
+    /*==========================================
+     * BATCH KERNELS
+     *=========================================*/
+
+    /**
+     * Function to add two arrays element-wise. The output may alias one of the inputs.
+     *
+     * @param a First summand.
+     * @param b Second summand, must have the same size as a.
+     * @param out Sum of the vectors, resized to the size of a.
+     */
+    template<typename T>
+    void batchAdd(const Vector3DArray<T>& a, const Vector3DArray<T>& b, Vector3DArray<T>& out);
+
+    /**
+     * Function to subtract two arrays element-wise. The output may alias one of the inputs.
+     *
+     * @param a Minuend.
+     * @param b Subtrahend, must have the same size as a.
+     * @param out Difference of the vectors, resized to the size of a.
+     */
+    template<typename T>
+    void batchSub(const Vector3DArray<T>& a, const Vector3DArray<T>& b, Vector3DArray<T>& out);
+
+    /**
+     * Function to multiply all vectors of an array with a scalar. The output may alias the input.
+     *
+     * @param a Vectors to scale.
+     * @param s Scalar to multiply with.
+     * @param out Scaled vectors, resized to the size of a.
+     */
+    template<typename T>
+    void batchScale(const Vector3DArray<T>& a, const T& s, Vector3DArray<T>& out);
+
+    /**
+     * Function to compute the scalar products of two arrays element-wise.
+     *
+     * @param a First factors.
+     * @param b Second factors, must have the same size as a.
+     * @param out Destination which must provide space for a.size() scalars.
+     */
+    template<typename T>
+    void batchDot(const Vector3DArray<T>& a, const Vector3DArray<T>& b, T* out);
+
+    /**
+     * Function to compute the vector products of two arrays element-wise. The output may alias
+     * one of the inputs.
+     *
+     * @param a First factors.
+     * @param b Second factors, must have the same size as a.
+     * @param out Vector products, resized to the size of a.
+     */
+    template<typename T>
+    void batchCross(const Vector3DArray<T>& a, const Vector3DArray<T>& b, Vector3DArray<T>& out);
+
+    /**
+     * Function to compute the magnitudes of all vectors of an array.
+     *
+     * @param a Vectors to measure.
+     * @param out Destination which must provide space for a.size() scalars.
+     */
+    template<typename T>
+    void batchMagnitude(const Vector3DArray<T>& a, T* out);
+
+    /**
+     * Function to normalize all vectors of an array. The output may alias the input. Vectors of
+     * zero length are normalized to (0,0,0).
+     *
+     * @tparam P Precision policy, see Precision.h.
+     * @param a Vectors to normalize.
+     * @param out Normalized vectors, resized to the size of a.
+     */
+    template<typename P = ExactPrecision, typename T>
+    void batchNormalize(const Vector3DArray<T>& a, Vector3DArray<T>& out);
+
+
+
+    /*==========================================
+     * STREAM KERNELS
+     *=========================================*/
+
+    namespace detail {
+
+#if defined(PIKO_SIMD_SSE)
+        /**
+         * Function to load four densely packed float vectors and transpose them: the registers
+         * x0 y0 z0 x1 | y1 z1 x2 y2 | z2 x3 y3 z3 are shuffled into x0..x3, y0..y3 and z0..z3.
+         *
+         * @param src First of twelve floats.
+         * @param x Register receiving the x-coordinates.
+         * @param y Register receiving the y-coordinates.
+         * @param z Register receiving the z-coordinates.
+         */
+        inline void loadTransposed(const float* src, __m128& x, __m128& y, __m128& z) {
+
+            __m128 a = _mm_loadu_ps(src);
+            __m128 b = _mm_loadu_ps(src + 4);
+            __m128 c = _mm_loadu_ps(src + 8);
+
+            __m128 x23 = _mm_shuffle_ps(b, c, _MM_SHUFFLE(1, 1, 2, 2));     // x2 x2 x3 x3
+            __m128 y01 = _mm_shuffle_ps(a, b, _MM_SHUFFLE(0, 0, 1, 1));     // y0 y0 y1 y1
+            __m128 y23 = _mm_shuffle_ps(b, c, _MM_SHUFFLE(2, 2, 3, 3));     // y2 y2 y3 y3
+            __m128 z01 = _mm_shuffle_ps(a, b, _MM_SHUFFLE(1, 1, 2, 2));     // z0 z0 z1 z1
+            __m128 z23 = _mm_shuffle_ps(c, c, _MM_SHUFFLE(3, 3, 0, 0));     // z2 z2 z3 z3
+
+            x = _mm_shuffle_ps(a, x23, _MM_SHUFFLE(2, 0, 3, 0));
+            y = _mm_shuffle_ps(y01, y23, _MM_SHUFFLE(2, 0, 2, 0));
+            z = _mm_shuffle_ps(z01, z23, _MM_SHUFFLE(2, 0, 2, 0));
+        }
+
+        /**
+         * Function to transpose four vectors back into the densely packed layout. Inverse of
+         * loadTransposed().
+         *
+         * @param dst First of twelve floats.
+         * @param x Register holding the x-coordinates.
+         * @param y Register holding the y-coordinates.
+         * @param z Register holding the z-coordinates.
+         */
+        inline void storeTransposed(float* dst, __m128 x, __m128 y, __m128 z) {
+
+            __m128 xy01 = _mm_unpacklo_ps(x, y);                            // x0 y0 x1 y1
+            __m128 zx01 = _mm_shuffle_ps(z, x, _MM_SHUFFLE(1, 1, 0, 0));     // z0 z0 x1 x1
+            __m128 yz11 = _mm_shuffle_ps(y, z, _MM_SHUFFLE(1, 1, 1, 1));     // y1 y1 z1 z1
+            __m128 xy22 = _mm_shuffle_ps(x, y, _MM_SHUFFLE(2, 2, 2, 2));     // x2 x2 y2 y2
+            __m128 zx23 = _mm_shuffle_ps(z, x, _MM_SHUFFLE(3, 3, 2, 2));     // z2 z2 x3 x3
+            __m128 yz33 = _mm_shuffle_ps(y, z, _MM_SHUFFLE(3, 3, 3, 3));     // y3 y3 z3 z3
+
+            _mm_storeu_ps(dst, _mm_shuffle_ps(xy01, zx01, _MM_SHUFFLE(2, 0, 1, 0)));
+            _mm_storeu_ps(dst + 4, _mm_shuffle_ps(yz11, xy22, _MM_SHUFFLE(2, 0, 2, 0)));
+            _mm_storeu_ps(dst + 8, _mm_shuffle_ps(zx23, yz33, _MM_SHUFFLE(2, 0, 2, 0)));
+        }
+#endif
+
+        /**
+         * Generic stream kernels working on single coordinate streams of n elements. The float
+         * overloads below replace them with SIMD code if available.
+         */
+        template<typename T>
+        inline void addStreams(const T* a, const T* b, T* out, std::size_t n) {
+            for(std::size_t i = 0; i < n; ++i) out[i] = a[i] + b[i];
+        }
+
+        template<typename T>
+        inline void subStreams(const T* a, const T* b, T* out, std::size_t n) {
+            for(std::size_t i = 0; i < n; ++i) out[i] = a[i] - b[i];
+        }
+
+        template<typename T>
+        inline void scaleStream(const T* a, const T& s, T* out, std::size_t n) {
+            for(std::size_t i = 0; i < n; ++i) out[i] = a[i] * s;
+        }
+
+        template<typename T>
+        inline void dotStreams(const T* ax, const T* ay, const T* az,
+                               const T* bx, const T* by, const T* bz,
+                               T* out, std::size_t n) {
+
+            for(std::size_t i = 0; i < n; ++i) {
+                out[i] = (ax[i] * bx[i]) + (ay[i] * by[i]) + (az[i] * bz[i]);
+            }
+        }
+
+        template<typename T>
+        inline void crossStreams(const T* ax, const T* ay, const T* az,
+                                 const T* bx, const T* by, const T* bz,
+                                 T* ox, T* oy, T* oz, std::size_t n) {
+
+            for(std::size_t i = 0; i < n; ++i) {
+                T tmpX = (ay[i] * bz[i]) - (az[i] * by[i]);
+                T tmpY = (az[i] * bx[i]) - (ax[i] * bz[i]);
+                T tmpZ = (ax[i] * by[i]) - (ay[i] * bx[i]);
+                ox[i] = tmpX;
+                oy[i] = tmpY;
+                oz[i] = tmpZ;
+            }
+        }
+
+        template<typename T>
+        inline void magnitudeStreams(const T* ax, const T* ay, const T* az,
+                                     T* out, std::size_t n) {
+
+            using std::sqrt;
+            for(std::size_t i = 0; i < n; ++i) {
+                out[i] = static_cast<T>(sqrt((ax[i] * ax[i]) + (ay[i] * ay[i]) + (az[i] * az[i])));
+            }
+        }
+
+        template<typename P, typename T>
+        inline void normalizeStreams(const T* ax, const T* ay, const T* az,
+                                     T* ox, T* oy, T* oz, std::size_t n) {
+
+            const T threshold = P::template threshold<T>();
+            for(std::size_t i = 0; i < n; ++i) {
+                T sq = (ax[i] * ax[i]) + (ay[i] * ay[i]) + (az[i] * az[i]);
+                if(sq > threshold) {
+                    T f = P::factor(sq);
+                    ox[i] = P::apply(ax[i], f);
+                    oy[i] = P::apply(ay[i], f);
+                    oz[i] = P::apply(az[i], f);
+                }
+                else {
+                    ox[i] = oy[i] = oz[i] = T(0);
+                }
+            }
+        }
+
+#if defined(PIKO_SIMD_AVX) || defined(PIKO_SIMD_SSE)
+
+        inline void addStreams(const float* a, const float* b, float* out, std::size_t n) {
+
+            const std::size_t packed = n - (n % simd::PACK_SIZE);
+            for(std::size_t i = 0; i < packed; i += simd::PACK_SIZE) {
+                simd::store(out + i, simd::add(simd::load(a + i), simd::load(b + i)));
+            }
+            addStreams<float>(a + packed, b + packed, out + packed, n - packed);
+        }
+
+        inline void subStreams(const float* a, const float* b, float* out, std::size_t n) {
+
+            const std::size_t packed = n - (n % simd::PACK_SIZE);
+            for(std::size_t i = 0; i < packed; i += simd::PACK_SIZE) {
+                simd::store(out + i, simd::sub(simd::load(a + i), simd::load(b + i)));
+            }
+            subStreams<float>(a + packed, b + packed, out + packed, n - packed);
+        }
+
+        inline void scaleStream(const float* a, const float& s, float* out, std::size_t n) {
+
+            const std::size_t packed = n - (n % simd::PACK_SIZE);
+            const simd::Pack factor = simd::set1(s);
+            for(std::size_t i = 0; i < packed; i += simd::PACK_SIZE) {
+                simd::store(out + i, simd::mul(simd::load(a + i), factor));
+            }
+            scaleStream<float>(a + packed, s, out + packed, n - packed);
+        }
+
+        inline void dotStreams(const float* ax, const float* ay, const float* az,
+                               const float* bx, const float* by, const float* bz,
+                               float* out, std::size_t n) {
+
+            const std::size_t packed = n - (n % simd::PACK_SIZE);
+            for(std::size_t i = 0; i < packed; i += simd::PACK_SIZE) {
+                simd::Pack dot = simd::mul(simd::load(ax + i), simd::load(bx + i));
+                dot = simd::add(dot, simd::mul(simd::load(ay + i), simd::load(by + i)));
+                dot = simd::add(dot, simd::mul(simd::load(az + i), simd::load(bz + i)));
+                simd::store(out + i, dot);
+            }
+            dotStreams<float>(ax + packed, ay + packed, az + packed,
+                              bx + packed, by + packed, bz + packed,
+                              out + packed, n - packed);
+        }
+
+        inline void crossStreams(const float* ax, const float* ay, const float* az,
+                                 const float* bx, const float* by, const float* bz,
+                                 float* ox, float* oy, float* oz, std::size_t n) {
+
+            const std::size_t packed = n - (n % simd::PACK_SIZE);
+            for(std::size_t i = 0; i < packed; i += simd::PACK_SIZE) {
+                simd::Pack x1 = simd::load(ax + i), y1 = simd::load(ay + i), z1 = simd::load(az + i);
+                simd::Pack x2 = simd::load(bx + i), y2 = simd::load(by + i), z2 = simd::load(bz + i);
+                simd::store(ox + i, simd::sub(simd::mul(y1, z2), simd::mul(z1, y2)));
+                simd::store(oy + i, simd::sub(simd::mul(z1, x2), simd::mul(x1, z2)));
+                simd::store(oz + i, simd::sub(simd::mul(x1, y2), simd::mul(y1, x2)));
+            }
+            crossStreams<float>(ax + packed, ay + packed, az + packed,
+                                bx + packed, by + packed, bz + packed,
+                                ox + packed, oy + packed, oz + packed, n - packed);
+        }
+
+        inline void magnitudeStreams(const float* ax, const float* ay, const float* az,
+                                     float* out, std::size_t n) {
+
+            const std::size_t packed = n - (n % simd::PACK_SIZE);
+            for(std::size_t i = 0; i < packed; i += simd::PACK_SIZE) {
+                simd::Pack x = simd::load(ax + i), y = simd::load(ay + i), z = simd::load(az + i);
+                simd::Pack sq = simd::add(simd::add(simd::mul(x, x), simd::mul(y, y)), simd::mul(z, z));
+                simd::store(out + i, simd::sqrt(sq));
+            }
+            magnitudeStreams<float>(ax + packed, ay + packed, az + packed, out + packed, n - packed);
+        }
+
+        template<typename P>
+        inline void normalizeStreams(const float* ax, const float* ay, const float* az,
+                                     float* ox, float* oy, float* oz, std::size_t n) {
+
+            const std::size_t packed = n - (n % simd::PACK_SIZE);
+            const simd::Pack threshold = simd::set1(P::template threshold<float>());
+
+            for(std::size_t i = 0; i < packed; i += simd::PACK_SIZE) {
+                simd::Pack x = simd::load(ax + i), y = simd::load(ay + i), z = simd::load(az + i);
+                simd::Pack sq = simd::add(simd::add(simd::mul(x, x), simd::mul(y, y)), simd::mul(z, z));
+                simd::Pack valid = simd::cmpgt(sq, threshold);
+                simd::Pack f = P::factor(sq);
+                simd::store(ox + i, simd::andp(P::apply(x, f), valid));
+                simd::store(oy + i, simd::andp(P::apply(y, f), valid));
+                simd::store(oz + i, simd::andp(P::apply(z, f), valid));
+            }
+            normalizeStreams<P, float>(ax + packed, ay + packed, az + packed,
+                                       ox + packed, oy + packed, oz + packed, n - packed);
+        }
+
+#endif
+
+    } /* Namespace detail */
+
+
+
+    /*==========================================
+     * INLINE IMPLEMENTATION
+     *=========================================*/
+
+    template<typename T>
+    inline Vector3DArray<T>::Vector3DArray()
+      :
+      m_data(NULL),
+      m_size(0),
+      m_capacity(0) {
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    template<typename T>
+    inline Vector3DArray<T>::Vector3DArray(std::size_t size)
+      :
+      m_data(NULL),
+      m_size(0),
+      m_capacity(0) {
+
+        resize(size);
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    template<typename T>
+    inline Vector3DArray<T>::Vector3DArray(const Vector3D<T>* vectors, std::size_t count)
+      :
+      m_data(NULL),
+      m_size(0),
+      m_capacity(0) {
+
+        load(vectors, count);
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    template<typename T>
+    inline Vector3DArray<T>::Vector3DArray(const std::vector<Vector3D<T>>& vectors)
+      :
+      m_data(NULL),
+      m_size(0),
+      m_capacity(0) {
+
+        load(vectors.empty() ? NULL : &vectors[0], vectors.size());
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    template<typename T>
+    inline Vector3DArray<T>::Vector3DArray(const Vector3DArray<T>& other)
+      :
+      m_data(NULL),
+      m_size(0),
+      m_capacity(0) {
+
+        reallocate(padded(other.m_size));
+        std::copy(other.x(), other.x() + other.m_size, x());
+        std::copy(other.y(), other.y() + other.m_size, y());
+        std::copy(other.z(), other.z() + other.m_size, z());
+        m_size = other.m_size;
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    template<typename T>
+    inline Vector3DArray<T>::Vector3DArray(Vector3DArray<T>&& other)
+      :
+      m_data(other.m_data),
+      m_size(other.m_size),
+      m_capacity(other.m_capacity) {
+
+        other.m_data = NULL;
+        other.m_size = 0;
+        other.m_capacity = 0;
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    template<typename T>
+    inline Vector3DArray<T>::~Vector3DArray() {
+
+        alignedFree(m_data);
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    template<typename T>
+    inline Vector3DArray<T>& Vector3DArray<T>::operator=(Vector3DArray<T> other) {
+
+        swap(other);
+        return *this;
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    template<typename T>
+    inline std::size_t Vector3DArray<T>::size() const {
+        return m_size;
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    template<typename T>
+    inline std::size_t Vector3DArray<T>::capacity() const {
+        return m_capacity;
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    template<typename T>
+    inline bool Vector3DArray<T>::empty() const {
+        return m_size == 0;
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    template<typename T>
+    inline void Vector3DArray<T>::resize(std::size_t size) {
+
+        reserve(size);
+
+        if(size > m_size) {
+            std::fill(x() + m_size, x() + size, T(0));
+            std::fill(y() + m_size, y() + size, T(0));
+            std::fill(z() + m_size, z() + size, T(0));
+        }
+
+        m_size = size;
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    template<typename T>
+    inline void Vector3DArray<T>::reserve(std::size_t capacity) {
+
+        if(capacity > m_capacity) {
+            reallocate(padded(capacity));
+        }
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    template<typename T>
+    inline void Vector3DArray<T>::clear() {
+        m_size = 0;
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    template<typename T>
+    inline void Vector3DArray<T>::push_back(const Vector3D<T>& v) {
+
+        if(m_size == m_capacity) {
+            reallocate(padded(std::max<std::size_t>(2 * m_capacity, PADDING)));
+        }
+
+        x()[m_size] = v.x();
+        y()[m_size] = v.y();
+        z()[m_size] = v.z();
+        ++m_size;
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    template<typename T>
+    inline Vector3D<T> Vector3DArray<T>::get(std::size_t i) const {
+        return Vector3D<T>(x()[i], y()[i], z()[i]);
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    template<typename T>
+    inline void Vector3DArray<T>::set(std::size_t i, const Vector3D<T>& v) {
+        x()[i] = v.x();
+        y()[i] = v.y();
+        z()[i] = v.z();
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    template<typename T>
+    inline void Vector3DArray<T>::load(const Vector3D<T>* vectors, std::size_t count) {
+
+        reserve(count);
+        m_size = count;
+
+        T* px = x();
+        T* py = y();
+        T* pz = z();
+        std::size_t i = 0;
+
+#if defined(PIKO_SIMD_SSE)
+        if(std::is_same<T, float>::value && sizeof(Vector3D<T>) == 3 * sizeof(float)) {
+
+            const float* src = reinterpret_cast<const float*>(vectors);
+            float* fx = reinterpret_cast<float*>(px);
+            float* fy = reinterpret_cast<float*>(py);
+            float* fz = reinterpret_cast<float*>(pz);
+
+            for(; i + 4 <= count; i += 4, src += 12) {
+                __m128 vx, vy, vz;
+                detail::loadTransposed(src, vx, vy, vz);
+                _mm_storeu_ps(fx + i, vx);
+                _mm_storeu_ps(fy + i, vy);
+                _mm_storeu_ps(fz + i, vz);
+            }
+        }
+#endif
+
+        for(; i < count; ++i) {
+            px[i] = vectors[i].x();
+            py[i] = vectors[i].y();
+            pz[i] = vectors[i].z();
+        }
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    template<typename T>
+    inline void Vector3DArray<T>::store(Vector3D<T>* vectors) const {
+
+        const T* px = x();
+        const T* py = y();
+        const T* pz = z();
+        std::size_t i = 0;
+
+#if defined(PIKO_SIMD_SSE)
+        if(std::is_same<T, float>::value && sizeof(Vector3D<T>) == 3 * sizeof(float)) {
+
+            float* dst = reinterpret_cast<float*>(vectors);
+            const float* fx = reinterpret_cast<const float*>(px);
+            const float* fy = reinterpret_cast<const float*>(py);
+            const float* fz = reinterpret_cast<const float*>(pz);
+
+            for(; i + 4 <= m_size; i += 4, dst += 12) {
+                detail::storeTransposed(dst, _mm_loadu_ps(fx + i), _mm_loadu_ps(fy + i),
+                                        _mm_loadu_ps(fz + i));
+            }
+        }
+#endif
+
+        for(; i < m_size; ++i) {
+            vectors[i].setPosition(px[i], py[i], pz[i]);
+        }
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    template<typename T>
+    inline std::vector<Vector3D<T>> Vector3DArray<T>::toVector() const {
+
+        std::vector<Vector3D<T>> vectors(m_size);
+        if(m_size) store(&vectors[0]);
+        return vectors;
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    template<typename T>
+    inline void Vector3DArray<T>::swap(Vector3DArray<T>& other) {
+        std::swap(m_data, other.m_data);
+        std::swap(m_size, other.m_size);
+        std::swap(m_capacity, other.m_capacity);
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    template<typename T>
+    inline T* Vector3DArray<T>::x() {
+        return m_data;
+    }
+
+    template<typename T>
+    inline const T* Vector3DArray<T>::x() const {
+        return m_data;
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    template<typename T>
+    inline T* Vector3DArray<T>::y() {
+        return m_data + m_capacity;
+    }
+
+    template<typename T>
+    inline const T* Vector3DArray<T>::y() const {
+        return m_data + m_capacity;
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    template<typename T>
+    inline T* Vector3DArray<T>::z() {
+        return m_data + 2 * m_capacity;
+    }
+
+    template<typename T>
+    inline const T* Vector3DArray<T>::z() const {
+        return m_data + 2 * m_capacity;
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    template<typename T>
+    inline void Vector3DArray<T>::reallocate(std::size_t capacity) {
+
+        T* data = static_cast<T*>(alignedAlloc(3 * capacity * sizeof(T)));
+
+        // Padding is zeroed so SIMD loads running over the end never see garbage.
+        std::fill(data, data + 3 * capacity, T(0));
+
+        if(m_data) {
+            std::copy(x(), x() + m_size, data);
+            std::copy(y(), y() + m_size, data + capacity);
+            std::copy(z(), z() + m_size, data + 2 * capacity);
+            alignedFree(m_data);
+        }
+
+        m_data = data;
+        m_capacity = capacity;
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    template<typename T>
+    inline std::size_t Vector3DArray<T>::padded(std::size_t count) {
+        return (count + PADDING - 1) / PADDING * PADDING;
+    }
+
+
+
+    /*==========================================
+     * BATCH KERNEL IMPLEMENTATION
+     *=========================================*/
+
+    template<typename T>
+    inline void batchAdd(const Vector3DArray<T>& a, const Vector3DArray<T>& b, Vector3DArray<T>& out) {
+
+        if(a.size() != b.size()) throw std::invalid_argument("batchAdd: Array sizes differ.");
+
+        out.resize(a.size());
+        detail::addStreams(a.x(), b.x(), out.x(), a.size());
+        detail::addStreams(a.y(), b.y(), out.y(), a.size());
+        detail::addStreams(a.z(), b.z(), out.z(), a.size());
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    template<typename T>
+    inline void batchSub(const Vector3DArray<T>& a, const Vector3DArray<T>& b, Vector3DArray<T>& out) {
+
+        if(a.size() != b.size()) throw std::invalid_argument("batchSub: Array sizes differ.");
+
+        out.resize(a.size());
+        detail::subStreams(a.x(), b.x(), out.x(), a.size());
+        detail::subStreams(a.y(), b.y(), out.y(), a.size());
+        detail::subStreams(a.z(), b.z(), out.z(), a.size());
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    template<typename T>
+    inline void batchScale(const Vector3DArray<T>& a, const T& s, Vector3DArray<T>& out) {
+
+        out.resize(a.size());
+        detail::scaleStream(a.x(), s, out.x(), a.size());
+        detail::scaleStream(a.y(), s, out.y(), a.size());
+        detail::scaleStream(a.z(), s, out.z(), a.size());
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    template<typename T>
+    inline void batchDot(const Vector3DArray<T>& a, const Vector3DArray<T>& b, T* out) {
+
+        if(a.size() != b.size()) throw std::invalid_argument("batchDot: Array sizes differ.");
+
+        detail::dotStreams(a.x(), a.y(), a.z(), b.x(), b.y(), b.z(), out, a.size());
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    template<typename T>
+    inline void batchCross(const Vector3DArray<T>& a, const Vector3DArray<T>& b, Vector3DArray<T>& out) {
+
+        if(a.size() != b.size()) throw std::invalid_argument("batchCross: Array sizes differ.");
+
+        out.resize(a.size());
+        detail::crossStreams(a.x(), a.y(), a.z(), b.x(), b.y(), b.z(),
+                             out.x(), out.y(), out.z(), a.size());
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    template<typename T>
+    inline void batchMagnitude(const Vector3DArray<T>& a, T* out) {
+
+        detail::magnitudeStreams(a.x(), a.y(), a.z(), out, a.size());
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    template<typename P, typename T>
+    inline void batchNormalize(const Vector3DArray<T>& a, Vector3DArray<T>& out) {
+
+        out.resize(a.size());
+        detail::normalizeStreams<P>(a.x(), a.y(), a.z(), out.x(), out.y(), out.z(), a.size());
+    }
+
+
+} /* Namespace Piko */
+
+#endif // End of VECTOR3DARRAY_H
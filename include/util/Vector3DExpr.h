@@ -0,0 +1,262 @@
+/**
+ * @file        Vector3DExpr.h
+ * @author      Robert Koch
+ * @version     1.0
+ *
+ * This file contains an expression template layer for Vector3D. Arithmetic on vectors builds a
+ * light-weight expression tree instead of temporary vectors, and the whole tree is evaluated
+ * component by component in a single pass when it is assigned to a Vector3D. The layer is opt-in:
+ * define PIKO_VECTOR3D_EXPRESSION_TEMPLATES for all translation units of a program before
+ * including Vector3D.h. The operator syntax stays the same, e.g.
+ *
+ *     Vector3D<double> r = a + b * s - (c ^ d);
+ *
+ * evaluates into r without creating a single intermediate Vector3D. Expressions keep references
+ * to the vectors they are built from, so do not store them beyond the full expression (for
+ * example with auto) if one of those vectors is a temporary.
+ */
+#ifndef VECTOR3DEXPR_H
+#define VECTOR3DEXPR_H
+
+
+namespace Piko {
+
+    template<typename T>
+    class Vector3D;
+
+    /**
+     * Base class of all vector expressions using the curiously recurring template pattern. Every
+     * expression provides value_type and the functions x(), y() and z() to evaluate a single
+     * component.
+     */
+    template<typename E>
+    class Vector3DExpr {
+
+        public:
+
+            /**
+             * Function to get the actual expression.
+             *
+             * @return Expression derived from this class.
+             */
+            const E& self() const {
+                return static_cast<const E&>(*this);
+            }
+
+
+        protected:
+
+            /**
+             * Only derived expressions may be created.
+             */
+            Vector3DExpr() {}
+
+
+    }; /* Class Vector3DExpr */
+
+
+
+    /**
+     * Trait to choose how an expression stores its operands. Vectors are referenced, nested
+     * expressions are small and get copied.
+     */
+    template<typename E>
+    struct Vector3DOperand {
+        typedef const E type;
+    };
+
+    template<typename T>
+    struct Vector3DOperand<Vector3D<T>> {
+        typedef const Vector3D<T>& type;
+    };
+
+
+
+    /**
+     * Expression for the sum of two vector expressions.
+     */
+    template<typename L, typename R>
+    class Vector3DSum final : public Vector3DExpr<Vector3DSum<L, R>> {
+
+        public:
+
+            typedef typename L::value_type value_type;
+
+            Vector3DSum(const L& l, const R& r) : m_l(l), m_r(r) {}
+
+            value_type x() const { return m_l.x() + m_r.x(); }
+            value_type y() const { return m_l.y() + m_r.y(); }
+            value_type z() const { return m_l.z() + m_r.z(); }
+
+        private:
+
+            typename Vector3DOperand<L>::type m_l;  /**< Left operand. */
+            typename Vector3DOperand<R>::type m_r;  /**< Right operand. */
+
+    }; /* Class Vector3DSum */
+
+
+
+    /**
+     * Expression for the difference of two vector expressions.
+     */
+    template<typename L, typename R>
+    class Vector3DDifference final : public Vector3DExpr<Vector3DDifference<L, R>> {
+
+        public:
+
+            typedef typename L::value_type value_type;
+
+            Vector3DDifference(const L& l, const R& r) : m_l(l), m_r(r) {}
+
+            value_type x() const { return m_l.x() - m_r.x(); }
+            value_type y() const { return m_l.y() - m_r.y(); }
+            value_type z() const { return m_l.z() - m_r.z(); }
+
+        private:
+
+            typename Vector3DOperand<L>::type m_l;  /**< Left operand. */
+            typename Vector3DOperand<R>::type m_r;  /**< Right operand. */
+
+    }; /* Class Vector3DDifference */
+
+
+
+    /**
+     * Expression for the product of a vector expression and a scalar.
+     */
+    template<typename E>
+    class Vector3DScaled final : public Vector3DExpr<Vector3DScaled<E>> {
+
+        public:
+
+            typedef typename E::value_type value_type;
+
+            Vector3DScaled(const E& e, const value_type& s) : m_e(e), m_s(s) {}
+
+            value_type x() const { return m_e.x() * m_s; }
+            value_type y() const { return m_e.y() * m_s; }
+            value_type z() const { return m_e.z() * m_s; }
+
+        private:
+
+            typename Vector3DOperand<E>::type m_e;  /**< Vector operand. */
+            value_type m_s;                         /**< Scalar factor. */
+
+    }; /* Class Vector3DScaled */
+
+
+
+    /**
+     * Expression for the quotient of a vector expression and a scalar.
+     */
+    template<typename E>
+    class Vector3DQuotient final : public Vector3DExpr<Vector3DQuotient<E>> {
+
+        public:
+
+            typedef typename E::value_type value_type;
+
+            Vector3DQuotient(const E& e, const value_type& s) : m_e(e), m_s(s) {}
+
+            value_type x() const { return m_e.x() / m_s; }
+            value_type y() const { return m_e.y() / m_s; }
+            value_type z() const { return m_e.z() / m_s; }
+
+        private:
+
+            typename Vector3DOperand<E>::type m_e;  /**< Vector operand. */
+            value_type m_s;                         /**< Scalar divisor. */
+
+    }; /* Class Vector3DQuotient */
+
+
+
+    /**
+     * Expression for the vector product of two vector expressions. Each component reads two
+     * components of both operands, so nested operands are evaluated twice per component. For
+     * deep operands it can pay off to evaluate them into a Vector3D first.
+     */
+    template<typename L, typename R>
+    class Vector3DCross final : public Vector3DExpr<Vector3DCross<L, R>> {
+
+        public:
+
+            typedef typename L::value_type value_type;
+
+            Vector3DCross(const L& l, const R& r) : m_l(l), m_r(r) {}
+
+            value_type x() const { return (m_l.y() * m_r.z()) - (m_l.z() * m_r.y()); }
+            value_type y() const { return (m_l.z() * m_r.x()) - (m_l.x() * m_r.z()); }
+            value_type z() const { return (m_l.x() * m_r.y()) - (m_l.y() * m_r.x()); }
+
+        private:
+
+            typename Vector3DOperand<L>::type m_l;  /**< Left operand. */
+            typename Vector3DOperand<R>::type m_r;  /**< Right operand. */
+
+    }; /* Class Vector3DCross */
+
+
+
+#if defined(PIKO_VECTOR3D_EXPRESSION_TEMPLATES)
+
+    /*==========================================
+     * OPERATORS
+     *=========================================*/
+
+    template<typename L, typename R>
+    inline Vector3DSum<L, R> operator+(const Vector3DExpr<L>& l, const Vector3DExpr<R>& r) {
+        return Vector3DSum<L, R>(l.self(), r.self());
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    template<typename L, typename R>
+    inline Vector3DDifference<L, R> operator-(const Vector3DExpr<L>& l, const Vector3DExpr<R>& r) {
+        return Vector3DDifference<L, R>(l.self(), r.self());
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    template<typename E>
+    inline Vector3DScaled<E> operator*(const Vector3DExpr<E>& e, const typename E::value_type& s) {
+        return Vector3DScaled<E>(e.self(), s);
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    template<typename E>
+    inline Vector3DQuotient<E> operator/(const Vector3DExpr<E>& e, const typename E::value_type& s) {
+        return Vector3DQuotient<E>(e.self(), s);
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    template<typename L, typename R>
+    inline Vector3DCross<L, R> operator^(const Vector3DExpr<L>& l, const Vector3DExpr<R>& r) {
+        return Vector3DCross<L, R>(l.self(), r.self());
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    /**
+     * The scalar product yields a scalar, so it is evaluated immediately.
+     */
+    template<typename L, typename R>
+    inline typename L::value_type operator*(const Vector3DExpr<L>& l, const Vector3DExpr<R>& r) {
+        const L& a = l.self();
+        const R& b = r.self();
+        return (a.x() * b.x()) + (a.y() * b.y()) + (a.z() * b.z());
+    }
+
+#endif // End of PIKO_VECTOR3D_EXPRESSION_TEMPLATES
+
+} /* Namespace Piko */
+
+#endif // End of VECTOR3DEXPR_H
@@ -0,0 +1,595 @@
+/**
+ * @file        Vector3DSIMD.h
+ * @author      Robert Koch
+ * @version     1.0
+ *
+ * This file contains a specialization of Vector3D for floats which keeps the coordinates in a
+ * padded, 16 byte aligned 4-lane register. It has the same public interface as the generic
+ * template, so existing code only has to be recompiled. The specialization is opt-in: define
+ * PIKO_SIMD_VECTOR3D for all translation units of a program before including Vector3D.h. Without
+ * SSE support the generic template is used instead. Together with
+ * PIKO_VECTOR3D_EXPRESSION_TEMPLATES the binary operators are the lazy ones of Vector3DExpr.h, as
+ * for the generic template, and only the compound assignments and the normalization use SSE.
+ */
+#ifndef VECTOR3DSIMD_H
+#define VECTOR3DSIMD_H
+
+#include "SIMD.h"
+#include "Vector3D.h"
+
+#if defined(PIKO_SIMD_SSE)
+
+
+namespace Piko {
+
+    /**
+     * Specialization of a 3-dimensional vector of floats using SSE instructions. The fourth lane
+     * is padding and always kept at zero, so it never contributes to dot products or magnitudes.
+     */
+    template<>
+    class Vector3D<float> final : public Vector3DExpr<Vector3D<float>> {
+
+        public:
+
+            typedef float value_type;   /**< Type of the coordinates. */
+
+            /**
+             * Standard constructor to create a vector with the coordinates (0,0,0).
+             */
+            Vector3D();
+
+            /**
+             * Constructor to create a vector with the specified coordinates.
+             *
+             * @param x x-coordinate
+             * @param y y-coordinate
+             * @param z z-coordinate
+             */
+            Vector3D(const float& x, const float& y, const float& z);
+
+            /**
+             * Constructor to evaluate a vector expression.
+             *
+             * @param e Expression to evaluate.
+             */
+            template<typename E>
+            Vector3D(const Vector3DExpr<E>& e);
+
+            /**
+             * Function to assign the result of a vector expression. The expression may refer to
+             * the calling instance.
+             *
+             * @param e Expression to evaluate.
+             * @return Reference to the calling instance.
+             */
+            template<typename E>
+            const Vector3D<float>& operator=(const Vector3DExpr<E>& e);
+
+            /**
+             * Function to get the x-coordinate.
+             *
+             * @return x-coordinate.
+             */
+            const float& x() const;
+
+            /**
+             * Function to get the y-coordinate.
+             *
+             * @return y-coordinate.
+             */
+            const float& y() const;
+
+            /**
+             * Function to get the z-coordinate.
+             *
+             * @return z-coordinate.
+             */
+            const float& z() const;
+
+#if !defined(PIKO_VECTOR3D_EXPRESSION_TEMPLATES)
+
+            /**
+             * Function add two vectors.
+             *
+             * @param v Vector to add.
+             * @return Sum of the vectors.
+             */
+            Vector3D<float> operator+(const Vector3D<float>& v) const;
+
+            /**
+             * Function to subtract two vectors.
+             *
+             * @param v Vector to subtract.
+             * @return Difference of the vectors.
+             */
+            Vector3D<float> operator-(const Vector3D<float>& v) const;
+
+            /**
+             * Function to scalar mutliply two vectors.
+             *
+             * @param v Vector to scalar multiply with.
+             * @return Scalar product of the vectors.
+             */
+            float operator*(const Vector3D<float>& v) const;
+
+            /**
+             * Function to mutliply the vector with a scalar.
+             *
+             * @param s Scalar to multiply with.
+             * @return Product of vector and scalar.
+             */
+            Vector3D<float> operator*(const float& s) const;
+
+            /**
+             * Function to divide the vector through a scalar.
+             *
+             * @param s Scalar to divide through.
+             * @return Quotient of vector and scalar.
+             */
+            Vector3D<float> operator/(const float& s) const;
+
+            /**
+             * Function to get the vector product of the two vectors.
+             *
+             * @param v Vector to multiply with.
+             * @return Vector product of the vectors.
+             */
+            Vector3D<float> operator^(const Vector3D<float>& v) const;
+
+#endif
+
+            /**
+             * Function to add a vector to the calling instance.
+             *
+             * @param v Vector to add.
+             * @return Sum of the vectors.
+             */
+            const Vector3D<float>& operator+=(const Vector3D<float>& v);
+
+            /**
+             * Function to subtract a vector to the calling instance.
+             *
+             * @param v Vector to subtract.
+             * @return Difference of the vectors.
+             */
+            const Vector3D<float>& operator-=(const Vector3D<float>& v);
+
+            /**
+             * Function to add the result of a vector expression to the calling instance.
+             *
+             * @param e Expression to add.
+             * @return Sum of the vectors.
+             */
+            template<typename E>
+            const Vector3D<float>& operator+=(const Vector3DExpr<E>& e);
+
+            /**
+             * Function to subtract the result of a vector expression from the calling instance.
+             *
+             * @param e Expression to subtract.
+             * @return Difference of the vectors.
+             */
+            template<typename E>
+            const Vector3D<float>& operator-=(const Vector3DExpr<E>& e);
+
+            /**
+             * Function to multiply the calling instance with a scalar.
+             *
+             * @param s Scalar to multiplay with.
+             * @return Product of the vector and scalar.
+             */
+            const Vector3D<float>& operator*=(const float& s);
+
+            /**
+             * Function to divide the calling instance through a scalar.
+             *
+             * @param s Scalar to divide through.
+             * @return Quotient of the vector and scalar.
+             */
+            const Vector3D<float>& operator/=(const float& s);
+
+            /**
+             * Function to multiply the calling vector with the specified one.
+             *
+             * @param v Vector to multiply with.
+             * @return Vector product of the vectors.
+             */
+            const Vector3D<float>& operator^=(const Vector3D<float>& v);
+
+            /**
+             * Function to change the position of the vector.
+             *
+             * @param x New x-Coordinate.
+             * @param y New y-Coordinate.
+             * @param z New z-Coordinate.
+             */
+            void setPosition(const float& x, const float& y, const float& z);
+
+            /**
+             * Function to normalize the vector. A vector of zero length becomes (0,0,0).
+             *
+             * @tparam P Precision policy, see Precision.h.
+             */
+            template<typename P = ExactPrecision>
+            void normalize();
+
+            /**
+             * Function to get the normalization of the vector. This will not change the vector
+             * itself. A vector of zero length yields (0,0,0).
+             *
+             * @tparam P Precision policy, see Precision.h.
+             * @return Vector normalization.
+             */
+            template<typename P = ExactPrecision>
+            Vector3D<float> getNormalization() const;
+
+            /**
+             * Function to get the magnitude of the vector.
+             *
+             * @return Magnitude.
+             */
+            float getMagnitude() const;
+
+
+            /**
+             * Function to have nice output, if appended to a stream.
+             */
+            friend std::ostream& operator<<(std::ostream& stream, const Vector3D<float>& v) {
+                return stream << "(" << v.m_v[0] << "," << v.m_v[1] << "," << v.m_v[2] << ")";
+            }
+
+
+        private:
+
+            alignas(16) float m_v[4];   /**< Coordinates x, y, z and a zero padding lane. */
+
+            /**
+             * Constructor to create a vector directly from a register.
+             *
+             * @param r Register holding the coordinates, the fourth lane has to be zero.
+             */
+            explicit Vector3D(__m128 r);
+
+            /**
+             * Function to load the coordinates into a register.
+             *
+             * @return Register holding the coordinates.
+             */
+            __m128 load() const;
+
+            /**
+             * Function to compute the scalar product of two registers over the first three lanes.
+             *
+             * @param a First register.
+             * @param b Second register.
+             * @return Register holding the scalar product in its first lane.
+             */
+            static __m128 dot(__m128 a, __m128 b);
+
+            /**
+             * Function to compute the vector product of two registers.
+             *
+             * @param a First register.
+             * @param b Second register.
+             * @return Vector product, fourth lane zero.
+             */
+            static __m128 cross(__m128 a, __m128 b);
+
+            /**
+             * Function to multiply a register with a scalar keeping the padding lane at zero.
+             *
+             * @param a Register to multiply.
+             * @param s Scalar to multiply with.
+             * @return Product, fourth lane zero.
+             */
+            static __m128 scale(__m128 a, __m128 s);
+
+            /**
+             * Function to divide a register through a scalar keeping the padding lane at zero.
+             *
+             * @param a Register to divide.
+             * @param s Scalar to divide through.
+             * @return Quotient, fourth lane zero.
+             */
+            static __m128 divide(__m128 a, __m128 s);
+
+            /**
+             * Function to get the mask selecting the coordinate lanes.
+             *
+             * @return Register with all bits of the first three lanes set.
+             */
+            static __m128 coordinateMask();
+
+
+    }; /* Class Vector3D<float> */
+
+
+
+    /*==========================================
+     * INLINE IMPLEMENTATION
+     *=========================================*/
+
+    inline Vector3D<float>::Vector3D() {
+        _mm_store_ps(m_v, _mm_setzero_ps());
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    inline Vector3D<float>::Vector3D(const float& x, const float& y, const float& z) {
+        _mm_store_ps(m_v, _mm_set_ps(0.0f, z, y, x));
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    template<typename E>
+    inline Vector3D<float>::Vector3D(const Vector3DExpr<E>& e) {
+        _mm_store_ps(m_v, _mm_set_ps(0.0f, e.self().z(), e.self().y(), e.self().x()));
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    inline Vector3D<float>::Vector3D(__m128 r) {
+        _mm_store_ps(m_v, r);
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    template<typename E>
+    inline const Vector3D<float>& Vector3D<float>::operator=(const Vector3DExpr<E>& e) {
+
+        // Evaluate completely before writing, the expression may refer to this vector.
+        float tmpX = e.self().x();
+        float tmpY = e.self().y();
+        float tmpZ = e.self().z();
+
+        _mm_store_ps(m_v, _mm_set_ps(0.0f, tmpZ, tmpY, tmpX));
+        return *this;
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    inline const float& Vector3D<float>::x() const {
+        return m_v[0];
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    inline const float& Vector3D<float>::y() const {
+        return m_v[1];
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    inline const float& Vector3D<float>::z() const {
+        return m_v[2];
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+#if !defined(PIKO_VECTOR3D_EXPRESSION_TEMPLATES)
+
+    inline Vector3D<float> Vector3D<float>::operator+(const Vector3D<float>& v) const {
+        return Vector3D<float>(_mm_add_ps(load(), v.load()));
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    inline Vector3D<float> Vector3D<float>::operator-(const Vector3D<float>& v) const {
+        return Vector3D<float>(_mm_sub_ps(load(), v.load()));
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    inline float Vector3D<float>::operator*(const Vector3D<float>& v) const {
+        return _mm_cvtss_f32(dot(load(), v.load()));
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    inline Vector3D<float> Vector3D<float>::operator*(const float& s) const {
+        return Vector3D<float>(scale(load(), _mm_set1_ps(s)));
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    inline Vector3D<float> Vector3D<float>::operator/(const float& s) const {
+        return Vector3D<float>(divide(load(), _mm_set1_ps(s)));
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    inline Vector3D<float> Vector3D<float>::operator^(const Vector3D<float>& v) const {
+        return Vector3D<float>(cross(load(), v.load()));
+    }
+
+#endif
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    inline const Vector3D<float>& Vector3D<float>::operator+=(const Vector3D<float>& v) {
+        _mm_store_ps(m_v, _mm_add_ps(load(), v.load()));
+        return *this;
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    inline const Vector3D<float>& Vector3D<float>::operator-=(const Vector3D<float>& v) {
+        _mm_store_ps(m_v, _mm_sub_ps(load(), v.load()));
+        return *this;
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    template<typename E>
+    inline const Vector3D<float>& Vector3D<float>::operator+=(const Vector3DExpr<E>& e) {
+
+        float tmpX = e.self().x();
+        float tmpY = e.self().y();
+        float tmpZ = e.self().z();
+
+        _mm_store_ps(m_v, _mm_add_ps(load(), _mm_set_ps(0.0f, tmpZ, tmpY, tmpX)));
+        return *this;
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    template<typename E>
+    inline const Vector3D<float>& Vector3D<float>::operator-=(const Vector3DExpr<E>& e) {
+
+        float tmpX = e.self().x();
+        float tmpY = e.self().y();
+        float tmpZ = e.self().z();
+
+        _mm_store_ps(m_v, _mm_sub_ps(load(), _mm_set_ps(0.0f, tmpZ, tmpY, tmpX)));
+        return *this;
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    inline const Vector3D<float>& Vector3D<float>::operator*=(const float& s) {
+        _mm_store_ps(m_v, scale(load(), _mm_set1_ps(s)));
+        return *this;
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    inline const Vector3D<float>& Vector3D<float>::operator/=(const float& s) {
+        _mm_store_ps(m_v, divide(load(), _mm_set1_ps(s)));
+        return *this;
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    inline const Vector3D<float>& Vector3D<float>::operator^=(const Vector3D<float>& v) {
+        _mm_store_ps(m_v, cross(load(), v.load()));
+        return *this;
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    inline void Vector3D<float>::setPosition(const float& x, const float& y, const float& z) {
+        _mm_store_ps(m_v, _mm_set_ps(0.0f, z, y, x));
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    template<typename P>
+    inline void Vector3D<float>::normalize() {
+
+        __m128 r = load();
+        __m128 sq = dot(r, r);
+        sq = _mm_shuffle_ps(sq, sq, _MM_SHUFFLE(0, 0, 0, 0));
+
+        // Zero-length vectors and the padding lane are masked to zero.
+        const __m128 threshold = _mm_set1_ps(P::template threshold<float>());
+        __m128 valid = _mm_and_ps(_mm_cmpgt_ps(sq, threshold), coordinateMask());
+
+        _mm_store_ps(m_v, _mm_and_ps(P::apply(r, P::factor(sq)), valid));
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    template<typename P>
+    inline Vector3D<float> Vector3D<float>::getNormalization() const {
+
+        Vector3D<float> tmp(load());
+        tmp.normalize<P>();
+
+        return tmp;
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    inline float Vector3D<float>::getMagnitude() const {
+
+        __m128 r = load();
+        return _mm_cvtss_f32(_mm_sqrt_ss(dot(r, r)));
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    inline __m128 Vector3D<float>::load() const {
+        return _mm_load_ps(m_v);
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    inline __m128 Vector3D<float>::dot(__m128 a, __m128 b) {
+
+        // Sum up the lanes in the same order as the generic template: (x + y) + z.
+        __m128 m = _mm_mul_ps(a, b);
+        __m128 sum = _mm_add_ss(m, _mm_shuffle_ps(m, m, _MM_SHUFFLE(1, 1, 1, 1)));
+        return _mm_add_ss(sum, _mm_movehl_ps(m, m));
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    inline __m128 Vector3D<float>::cross(__m128 a, __m128 b) {
+
+        // (a.y*b.z - a.z*b.y, a.z*b.x - a.x*b.z, a.x*b.y - a.y*b.x) via yzx and zxy permutations.
+        __m128 aYZX = _mm_shuffle_ps(a, a, _MM_SHUFFLE(3, 0, 2, 1));
+        __m128 aZXY = _mm_shuffle_ps(a, a, _MM_SHUFFLE(3, 1, 0, 2));
+        __m128 bYZX = _mm_shuffle_ps(b, b, _MM_SHUFFLE(3, 0, 2, 1));
+        __m128 bZXY = _mm_shuffle_ps(b, b, _MM_SHUFFLE(3, 1, 0, 2));
+
+        return _mm_sub_ps(_mm_mul_ps(aYZX, bZXY), _mm_mul_ps(aZXY, bYZX));
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    inline __m128 Vector3D<float>::scale(__m128 a, __m128 s) {
+
+        // Clear the padding lane, it would become NaN for an infinite or NaN scalar.
+        return _mm_and_ps(_mm_mul_ps(a, s), coordinateMask());
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    inline __m128 Vector3D<float>::divide(__m128 a, __m128 s) {
+
+        // Clear the padding lane, it would become NaN for a division through zero.
+        return _mm_and_ps(_mm_div_ps(a, s), coordinateMask());
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    inline __m128 Vector3D<float>::coordinateMask() {
+        return _mm_castsi128_ps(_mm_set_epi32(0, -1, -1, -1));
+    }
+
+
+} /* Namespace Piko */
+
+#endif // End of PIKO_SIMD_SSE
+
+#endif // End of VECTOR3DSIMD_H
@@ -0,0 +1,211 @@
+/**
+ * @file        WorkStealingDeque.h
+ * @author      Robert Koch
+ * @version     1.0
+ *
+ * This file contains a bounded lock-free deque whose owner thread works at one end while any
+ * other thread may steal from the other end.
+ */
+#ifndef WORKSTEALINGDEQUE_H
+#define WORKSTEALINGDEQUE_H
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+
+#include "SPSCRing.h"
+
+
+namespace Piko {
+
+    /**
+     * Bounded Chase-Lev deque. push() and pop() may only be called by the owner thread and work
+     * last in, first out, so the owner keeps working on the data it just touched. steal() may be
+     * called by any thread and takes the oldest element, which for recursively split work is the
+     * largest piece. Only the last element is contended, everything else costs no atomic
+     * read-modify-write. T has to be trivially copyable, typically a pointer.
+     */
+    template<typename T>
+    class WorkStealingDeque final {
+
+        public:
+
+            /**
+             * Constructor to create a deque holding at least the specified number of elements.
+             *
+             * @param capacity Minimum capacity, rounded up to the next power of two.
+             */
+            explicit WorkStealingDeque(std::size_t capacity);
+
+            /**
+             * Function to add an element at the bottom. Owner only.
+             *
+             * @param value Element to add.
+             *
+             * @return False if the deque is full and the element was not added, otherwise true.
+             */
+            bool push(const T& value);
+
+            /**
+             * Function to remove the newest element from the bottom. Owner only.
+             *
+             * @param value Receives the removed element.
+             *
+             * @return False if the deque is empty, otherwise true.
+             */
+            bool pop(T& value);
+
+            /**
+             * Function to remove the oldest element from the top. Any thread.
+             *
+             * @param value Receives the removed element.
+             *
+             * @return False if the deque is empty or another thread took the element, otherwise
+             *         true.
+             */
+            bool steal(T& value);
+
+            /**
+             * Function to get the number of stored elements. Only a snapshot.
+             *
+             * @return Number of elements.
+             */
+            std::size_t size() const;
+
+            /**
+             * Function to get the maximum number of elements.
+             *
+             * @return Capacity.
+             */
+            std::size_t capacity() const;
+
+
+        private:
+
+            std::unique_ptr<std::atomic<T>[]> m_buffer;     /**< Element storage. */
+            std::ptrdiff_t m_mask;                          /**< Capacity - 1. */
+
+            char m_pad0[CACHE_LINE_SIZE];
+            std::atomic<std::ptrdiff_t> m_top;              /**< Oldest element, stolen next. */
+
+            char m_pad1[CACHE_LINE_SIZE];
+            std::atomic<std::ptrdiff_t> m_bottom;           /**< Next free slot of the owner. */
+
+            char m_pad2[CACHE_LINE_SIZE];
+
+            /**
+             * Copy constructor is forbidden.
+             */
+            WorkStealingDeque(const WorkStealingDeque<T>& deque);
+
+            /**
+             * Assignment operator is forbidden.
+             */
+            WorkStealingDeque<T>& operator=(const WorkStealingDeque<T>& deque);
+
+    }; /* Class WorkStealingDeque */
+
+
+
+    /*==========================================
+     * INLINE IMPLEMENTATION
+     *=========================================*/
+
+    template<typename T>
+    inline WorkStealingDeque<T>::WorkStealingDeque(std::size_t capacity)
+      :
+      m_mask(0),
+      m_top(0),
+      m_bottom(0) {
+
+        std::size_t size = 1;
+        while(size < capacity) size <<= 1;
+
+        m_buffer.reset(new std::atomic<T>[size]);
+        m_mask = (std::ptrdiff_t)size - 1;
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    template<typename T>
+    inline bool WorkStealingDeque<T>::push(const T& value) {
+
+        const std::ptrdiff_t bottom = m_bottom.load(std::memory_order_relaxed);
+        const std::ptrdiff_t top = m_top.load(std::memory_order_acquire);
+
+        if(bottom - top > m_mask) return false;
+
+        m_buffer[bottom & m_mask].store(value, std::memory_order_relaxed);
+        m_bottom.store(bottom + 1, std::memory_order_release);
+        return true;
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    template<typename T>
+    inline bool WorkStealingDeque<T>::pop(T& value) {
+
+        // Reserve the bottom element before looking at the top, thieves see the reservation.
+        const std::ptrdiff_t bottom = m_bottom.load(std::memory_order_relaxed) - 1;
+        m_bottom.store(bottom, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        std::ptrdiff_t top = m_top.load(std::memory_order_relaxed);
+
+        if(top > bottom) {
+            m_bottom.store(bottom + 1, std::memory_order_release);
+            return false;
+        }
+
+        value = m_buffer[bottom & m_mask].load(std::memory_order_relaxed);
+        if(top < bottom) return true;
+
+        // Last element, race the thieves for it.
+        const bool isWon = m_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst,
+                                                         std::memory_order_relaxed);
+        m_bottom.store(bottom + 1, std::memory_order_release);
+        return isWon;
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    template<typename T>
+    inline bool WorkStealingDeque<T>::steal(T& value) {
+
+        std::ptrdiff_t top = m_top.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        const std::ptrdiff_t bottom = m_bottom.load(std::memory_order_acquire);
+
+        if(top >= bottom) return false;
+
+        value = m_buffer[top & m_mask].load(std::memory_order_relaxed);
+        return m_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst,
+                                             std::memory_order_relaxed);
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    template<typename T>
+    inline std::size_t WorkStealingDeque<T>::size() const {
+
+        const std::ptrdiff_t top = m_top.load(std::memory_order_acquire);
+        const std::ptrdiff_t bottom = m_bottom.load(std::memory_order_acquire);
+        return bottom > top ? (std::size_t)(bottom - top) : 0;
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    template<typename T>
+    inline std::size_t WorkStealingDeque<T>::capacity() const {
+
+        return (std::size_t)m_mask + 1;
+    }
+
+
+} /* Namespace Piko */
+
+#endif // End of WORKSTEALINGDEQUE_H
@@ -0,0 +1,224 @@
+/**
+ * @file        ApplicationLoop.cpp
+ * @author      Robert Koch
+ * @version     1.0
+ *
+ * Implementation of the ApplicationLoop class.
+ */
+#include "../include/ApplicationLoop.h"
+#include "../include/ErrorMessage.h"
+#include "../include/Profiler.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+
+namespace Piko {
+
+    /*===================================================================*
+     * STATIC MEMBERS                                                    *
+     *===================================================================*/
+
+    const double ApplicationLoop::DEFAULT_TIMESTEP = 1.0 / 60.0;
+
+
+
+    /*===================================================================*
+     * PUBLIC MEMBERS                                                    *
+     *===================================================================*/
+
+    ApplicationLoop::ApplicationLoop(WindowBase& window, double timestep)
+      :
+      m_window(window),
+      m_timestep(DEFAULT_TIMESTEP),
+      m_maxUpdates(8),
+      m_accumulator(0.0),
+      m_simulationTime(0.0),
+      m_isRunning(true),
+      m_isStarted(false),
+      m_frameTimes(STATS_FRAMES, 0.0),
+      m_frameIndex(0),
+      m_frameCount(0) {
+
+        setTimestep(timestep);
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    ApplicationLoop::~ApplicationLoop() {
+
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    void ApplicationLoop::run() {
+
+        m_isRunning = true;
+        while(step());
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    bool ApplicationLoop::step() {
+
+        PIKO_PROFILE_FRAME();
+        PIKO_PROFILE_ZONE("ApplicationLoop::step");
+
+        Clock::time_point start = Clock::now();
+
+        if(!m_isStarted) {
+            m_previous = start;
+            m_isStarted = true;
+        }
+
+        m_accumulator += std::chrono::duration<double>(start - m_previous).count();
+        m_previous = start;
+
+        // Drain all pending messages, never waits for new ones.
+        m_window.getBackend().processMessages();
+        if(m_window.isClosed()) m_isRunning = false;
+        if(!m_isRunning) return false;
+
+        int updates = 0;
+        while(m_accumulator >= m_timestep && updates < m_maxUpdates) {
+            PIKO_PROFILE_ZONE("ApplicationLoop::onUpdate");
+            onUpdate(m_timestep);
+            m_simulationTime += m_timestep;
+            m_accumulator -= m_timestep;
+            ++updates;
+        }
+
+        // Too far behind, drop the time which could not be simulated.
+        if(m_accumulator >= m_timestep) {
+            m_accumulator = std::fmod(m_accumulator, m_timestep);
+        }
+
+        {
+            PIKO_PROFILE_ZONE("ApplicationLoop::onRender");
+            onRender(m_accumulator / m_timestep);
+        }
+
+        m_frameTimes[m_frameIndex] =
+            std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+        m_frameIndex = (m_frameIndex + 1) % STATS_FRAMES;
+        if(m_frameCount < STATS_FRAMES) ++m_frameCount;
+
+        m_frameArena.reset();
+
+        return m_isRunning;
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    void ApplicationLoop::stop() {
+
+        m_isRunning = false;
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    void ApplicationLoop::setTimestep(double timestep) {
+
+        if(!(timestep > 0.0)) {
+            throw std::invalid_argument(
+                ErrorMessage("Timestep must be positive.", 0).str());
+        }
+
+        m_timestep = timestep;
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    double ApplicationLoop::getTimestep() const {
+
+        return m_timestep;
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    void ApplicationLoop::setMaxUpdatesPerFrame(int count) {
+
+        m_maxUpdates = std::max(count, 1);
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    double ApplicationLoop::getSimulationTime() const {
+
+        return m_simulationTime;
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    FrameStats ApplicationLoop::getFrameStats() const {
+
+        FrameStats stats = { m_frameCount, 0.0, 0.0, 0.0, 0.0, 0.0 };
+        if(m_frameCount == 0) return stats;
+
+        std::vector<double> times(m_frameTimes.begin(), m_frameTimes.begin() + m_frameCount);
+
+        double sum = 0.0;
+        stats.minMs = times[0];
+        stats.maxMs = times[0];
+        for(std::size_t i = 0; i < times.size(); ++i) {
+            sum += times[i];
+            stats.minMs = std::min(stats.minMs, times[i]);
+            stats.maxMs = std::max(stats.maxMs, times[i]);
+        }
+
+        stats.avgMs = sum / times.size();
+        stats.lastMs = m_frameTimes[(m_frameIndex + STATS_FRAMES - 1) % STATS_FRAMES];
+
+        // Nearest rank percentile.
+        std::size_t rank = (times.size() * 99 + 99) / 100 - 1;
+        std::nth_element(times.begin(), times.begin() + rank, times.end());
+        stats.p99Ms = times[rank];
+
+        return stats;
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    void ApplicationLoop::resetFrameStats() {
+
+        m_frameIndex = 0;
+        m_frameCount = 0;
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    LinearArena& ApplicationLoop::getFrameArena() {
+
+        return m_frameArena;
+    }
+
+
+
+    /*===================================================================*
+     * PROTECTED MEMBERS                                                 *
+     *===================================================================*/
+
+    void ApplicationLoop::onUpdate(double /*timestep*/) {
+
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    void ApplicationLoop::onRender(double /*alpha*/) {
+
+    }
+
+} /* Namespace Piko */
\ No newline at end of file
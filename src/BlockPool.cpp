@@ -0,0 +1,113 @@
+/**
+ * @file        BlockPool.cpp
+ * @author      Robert Koch
+ * @version     1.0
+ *
+ * Implementation of the BlockPool class.
+ */
+#include "../include/BlockPool.h"
+#include "../include/ErrorMessage.h"
+#include "../include/util/SIMD.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+
+namespace Piko {
+
+    /*===================================================================*
+     * STATIC MEMBERS                                                    *
+     *===================================================================*/
+
+    const std::size_t BlockPool::DEFAULT_CHUNK_BLOCKS;
+
+
+
+    /*===================================================================*
+     * PUBLIC MEMBERS                                                    *
+     *===================================================================*/
+
+    BlockPool::BlockPool(std::size_t blockSize, std::size_t alignment, std::size_t chunkBlocks)
+      :
+      m_blockSize(0),
+      m_alignment(std::max(alignment, sizeof(void*))),
+      m_chunkBlocks(chunkBlocks),
+      m_allocated(0),
+      m_free(NULL) {
+
+        if(alignment == 0 || (alignment & (alignment - 1)) != 0) {
+            throw std::invalid_argument(
+                ErrorMessage("Pool alignment must be a power of two.", 0).str());
+        }
+
+        if(chunkBlocks == 0) {
+            throw std::invalid_argument(
+                ErrorMessage("Pool chunks must hold at least one block.", 0).str());
+        }
+
+        // Each block has to hold the free list link and keep its successor aligned.
+        m_blockSize = std::max(blockSize, sizeof(FreeBlock));
+        m_blockSize = (m_blockSize + m_alignment - 1) & ~(m_alignment - 1);
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    BlockPool::~BlockPool() {
+
+        for(std::size_t i = 0; i < m_chunks.size(); ++i) alignedFree(m_chunks[i]);
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    std::size_t BlockPool::getBlockSize() const {
+
+        return m_blockSize;
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    std::size_t BlockPool::getAlignment() const {
+
+        return m_alignment;
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    std::size_t BlockPool::getAllocatedCount() const {
+
+        return m_allocated;
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    std::size_t BlockPool::getCapacity() const {
+
+        return m_chunks.size() * m_chunkBlocks;
+    }
+
+
+
+    /*===================================================================*
+     * PRIVATE MEMBERS                                                   *
+     *===================================================================*/
+
+    void BlockPool::grow() {
+
+        char* chunk = static_cast<char*>(alignedAlloc(m_blockSize * m_chunkBlocks,
+                                                      std::max(m_alignment, SIMD_ALIGNMENT)));
+        m_chunks.push_back(chunk);
+
+        // Link back to front, so blocks are handed out in address order.
+        for(std::size_t i = m_chunkBlocks; i > 0; --i) {
+            FreeBlock* block = reinterpret_cast<FreeBlock*>(chunk + (i - 1) * m_blockSize);
+            block->next = m_free;
+            m_free = block;
+        }
+    }
+
+} /* Namespace Piko */
\ No newline at end of file
@@ -0,0 +1,484 @@
+/**
+ * @file        EGLContextBackend.cpp
+ * @author      Robert Koch
+ * @version     1.0
+ *
+ * Implementation of the EGLContextBackend class.
+ */
+#if !defined(_WIN32)
+
+#include "../include/EGLContextBackend.h"
+#include "../include/ErrorMessage.h"
+
+#include <EGL/eglext.h>
+#include <algorithm>
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <stdexcept>
+
+
+namespace Piko {
+
+    namespace {
+
+        /**
+         * Function to get the lock of the display references.
+         */
+        std::mutex& getDisplayMutex() {
+
+            static std::mutex mutex;
+            return mutex;
+        }
+
+        /**
+         * Function to get the number of backends using each initialized display. EGL returns
+         * the same handle to every caller in the process, so a display may only be terminated
+         * when its last user is disposed.
+         */
+        std::map<EGLDisplay, int>& getDisplayReferences() {
+
+            static std::map<EGLDisplay, int> references;
+            return references;
+        }
+
+        /**
+         * Function to add a user of a display, initializing it for the first one.
+         *
+         * @param display Display to use.
+         * @return True if the display is initialized.
+         */
+        bool acquireDisplay(EGLDisplay display) {
+
+            std::lock_guard<std::mutex> lock(getDisplayMutex());
+
+            int& count = getDisplayReferences()[display];
+            if(count == 0 && !eglInitialize(display, NULL, NULL)) {
+                getDisplayReferences().erase(display);
+                return false;
+            }
+
+            ++count;
+            return true;
+        }
+
+        /**
+         * Function to remove a user of a display, terminating it after the last one.
+         *
+         * @param display Display acquired by acquireDisplay().
+         */
+        void releaseDisplay(EGLDisplay display) {
+
+            std::lock_guard<std::mutex> lock(getDisplayMutex());
+
+            std::map<EGLDisplay, int>::iterator it = getDisplayReferences().find(display);
+            if(it != getDisplayReferences().end() && --it->second == 0) {
+                getDisplayReferences().erase(it);
+                eglTerminate(display);
+            }
+        }
+
+    } /* Anonymous namespace */
+
+
+
+    /*===============================================*
+     *  PUBLIC MEMBERS                               *
+     *===============================================*/
+
+    EGLContextBackend::EGLContextBackend()
+      :
+      m_display(EGL_NO_DISPLAY),
+      m_surface(EGL_NO_SURFACE),
+      m_context(EGL_NO_CONTEXT),
+      m_config(NULL),
+      m_swapInterval(0) {
+
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    EGLContextBackend::~EGLContextBackend() {
+
+        dispose();
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    Result<> EGLContextBackend::tryInit(HWND /*hWnd*/, const ContextConfig& /*config*/) {
+
+        return ErrorMessage("Window contexts are not supported by the EGL backend.", 0);
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    Result<> EGLContextBackend::tryInitOffscreen(int width, int height,
+                                                 const ContextConfig& config) {
+
+        Result<> display = initDisplay();
+        if(!display) return display;
+
+        if(!eglBindAPI(EGL_OPENGL_API)) {
+            return fail(ErrorMessage("Could not bind the OpenGL API.", eglGetError(),
+                                     ErrorCategory::GRAPHICS));
+        }
+
+        Result<EGLConfig> chosen = chooseConfig(config.format);
+        if(!chosen) return fail(chosen.error());
+        m_config = chosen.value();
+
+        // Setup surface
+        bool sRGB = config.format.sRGB && hasExtension("EGL_KHR_gl_colorspace");
+        EGLint surfaceAttribs[] = {
+            EGL_WIDTH, width,
+            EGL_HEIGHT, height,
+            sRGB ? EGL_GL_COLORSPACE_KHR : EGL_NONE, EGL_GL_COLORSPACE_SRGB_KHR,
+            EGL_NONE
+        };
+
+        m_surface = eglCreatePbufferSurface(m_display, m_config, surfaceAttribs);
+
+        // Not every config supports sRGB pbuffers, fall back to a linear one.
+        if(m_surface == EGL_NO_SURFACE && sRGB) {
+            sRGB = false;
+            surfaceAttribs[4] = EGL_NONE;
+            m_surface = eglCreatePbufferSurface(m_display, m_config, surfaceAttribs);
+        }
+
+        if(m_surface == EGL_NO_SURFACE) {
+            return fail(ErrorMessage("Could not create pbuffer surface.", eglGetError(),
+                                     ErrorCategory::GRAPHICS));
+        }
+
+        // Setup context
+        initContextAttribs(config);
+
+        if((m_context = eglCreateContext(m_display, m_config, EGL_NO_CONTEXT, 
+                                         &m_contextAttribs[0])) == EGL_NO_CONTEXT) {
+            return fail(ErrorMessage("Could not create rendering context.", eglGetError(),
+                                     ErrorCategory::GRAPHICS));
+        }
+
+        if(!eglMakeCurrent(m_display, m_surface, m_surface, m_context)) {
+            return fail(ErrorMessage("Could not activate rendering context.", eglGetError(),
+                                     ErrorCategory::GRAPHICS));
+        }
+
+        // Read back what the implementation actually granted. Pbuffers have no front buffer.
+        EGLint value;
+        eglGetConfigAttrib(m_display, m_config, EGL_RED_SIZE, &value);
+        m_format.redBits = value;
+        eglGetConfigAttrib(m_display, m_config, EGL_GREEN_SIZE, &value);
+        m_format.greenBits = value;
+        eglGetConfigAttrib(m_display, m_config, EGL_BLUE_SIZE, &value);
+        m_format.blueBits = value;
+        eglGetConfigAttrib(m_display, m_config, EGL_ALPHA_SIZE, &value);
+        m_format.alphaBits = value;
+        eglGetConfigAttrib(m_display, m_config, EGL_DEPTH_SIZE, &value);
+        m_format.depthBits = value;
+        eglGetConfigAttrib(m_display, m_config, EGL_STENCIL_SIZE, &value);
+        m_format.stencilBits = value;
+        eglGetConfigAttrib(m_display, m_config, EGL_SAMPLES, &value);
+        m_format.samples = value;
+        m_format.doubleBuffer = false;
+        m_format.sRGB = sRGB 
+            && eglQuerySurface(m_display, m_surface, EGL_GL_COLORSPACE_KHR, &value)
+            && value == EGL_GL_COLORSPACE_SRGB_KHR;
+
+        setSwapInterval(config.swapInterval);
+        return Result<>();
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    std::unique_ptr<GLContextBackend> EGLContextBackend::createShared() const {
+
+        std::unique_ptr<EGLContextBackend> shared(new EGLContextBackend());
+
+        // The shared context holds a reference of its own, it may outlive this one.
+        if(!acquireDisplay(m_display)) {
+            throw std::runtime_error(ErrorMessage("Could not initialize EGL display.",
+                                                  eglGetError(), ErrorCategory::GRAPHICS).str());
+        }
+
+        shared->m_display = m_display;
+        shared->m_config = m_config;
+        shared->m_format = m_format;
+        shared->m_contextAttribs = m_contextAttribs;
+
+        eglBindAPI(EGL_OPENGL_API);
+
+        // Every context needs a drawable to become current, a minimal pbuffer is sufficient.
+        const EGLint surfaceAttribs[] = {
+            EGL_WIDTH, 1,
+            EGL_HEIGHT, 1,
+            EGL_NONE
+        };
+
+        if((shared->m_surface = eglCreatePbufferSurface(m_display, m_config, surfaceAttribs))
+                == EGL_NO_SURFACE) {
+            throw std::runtime_error(ErrorMessage("Could not create pbuffer surface.",
+                                                  eglGetError(), ErrorCategory::GRAPHICS).str());
+        }
+
+        // Shared contexts have to be created with the same version, profile and flags.
+        if((shared->m_context = eglCreateContext(m_display, m_config, m_context,
+                                                 &m_contextAttribs[0])) == EGL_NO_CONTEXT) {
+            throw std::runtime_error(ErrorMessage("Could not create shared rendering context.",
+                                                  eglGetError(), ErrorCategory::GRAPHICS).str());
+        }
+
+        return std::unique_ptr<GLContextBackend>(std::move(shared));
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    void EGLContextBackend::makeCurrent() {
+
+        // The bound API is a per-thread state.
+        eglBindAPI(EGL_OPENGL_API);
+
+        if(!eglMakeCurrent(m_display, m_surface, m_surface, m_context)) {
+            throw std::runtime_error(ErrorMessage("Could not activate rendering context.",
+                                                  eglGetError(), ErrorCategory::GRAPHICS).str());
+        }
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    void EGLContextBackend::doneCurrent() {
+
+        eglBindAPI(EGL_OPENGL_API);
+        eglMakeCurrent(m_display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    void* EGLContextBackend::getProcAddress(const char* name) const {
+
+        return (void *)eglGetProcAddress(name);
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    void EGLContextBackend::dispose() {
+
+        if(m_display == EGL_NO_DISPLAY) return;
+
+        // Only release the context if it belongs to the calling thread.
+        if(m_context != EGL_NO_CONTEXT && eglGetCurrentContext() == m_context) {
+            eglMakeCurrent(m_display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+        }
+
+        if(m_context != EGL_NO_CONTEXT) {
+            eglDestroyContext(m_display, m_context);
+        }
+
+        if(m_surface != EGL_NO_SURFACE) {
+            eglDestroySurface(m_display, m_surface);
+        }
+
+        // Other contexts of the process may still use the display.
+        releaseDisplay(m_display);
+
+        m_display = EGL_NO_DISPLAY;
+        m_surface = EGL_NO_SURFACE;
+        m_context = EGL_NO_CONTEXT;
+        m_swapInterval = 0;
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    void EGLContextBackend::setSwapInterval(int interval) {
+
+        // EGL has no adaptive vsync, use the closest regular interval.
+        if(interval < 0) interval = 1;
+
+        // The implementation clamps the interval to the range of the config.
+        EGLint minInterval = 0;
+        EGLint maxInterval = 0;
+        eglGetConfigAttrib(m_display, m_config, EGL_MIN_SWAP_INTERVAL, &minInterval);
+        eglGetConfigAttrib(m_display, m_config, EGL_MAX_SWAP_INTERVAL, &maxInterval);
+
+        if(eglSwapInterval(m_display, interval)) {
+            m_swapInterval = std::min(std::max(interval, (int)minInterval), (int)maxInterval);
+        }
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    int EGLContextBackend::getSwapInterval() const {
+
+        return m_swapInterval;
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    void EGLContextBackend::swapBuffers() {
+
+        // Without a back buffer this only flushes the pending commands of the frame.
+        eglSwapBuffers(m_display, m_surface);
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    const FramebufferFormat& EGLContextBackend::getFramebufferFormat() const {
+
+        return m_format;
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    HDC EGLContextBackend::getDeviceContext() const {
+
+        return NULL;
+    }
+
+
+
+    /*===============================================*
+     *  PRIVATE MEMBERS                              *
+     *===============================================*/
+
+    Result<> EGLContextBackend::initDisplay() {
+
+        // Prefer the surfaceless platform which needs no window system at all.
+        const char* extensions = eglQueryString(EGL_NO_DISPLAY, EGL_EXTENSIONS);
+        PFNEGLGETPLATFORMDISPLAYEXTPROC getPlatformDisplay =
+            (PFNEGLGETPLATFORMDISPLAYEXTPROC)eglGetProcAddress("eglGetPlatformDisplayEXT");
+
+        if(getPlatformDisplay && extensions
+                && std::strstr(extensions, "EGL_MESA_platform_surfaceless")) {
+            m_display = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY,
+                                           NULL);
+        }
+
+        if(m_display == EGL_NO_DISPLAY) {
+            m_display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+        }
+
+        if(m_display == EGL_NO_DISPLAY) {
+            return ErrorMessage("Could not open EGL display.", eglGetError(),
+                                ErrorCategory::GRAPHICS);
+        }
+
+        if(!acquireDisplay(m_display)) {
+            m_display = EGL_NO_DISPLAY;
+            return ErrorMessage("Could not initialize EGL display.", eglGetError(),
+                                ErrorCategory::GRAPHICS);
+        }
+
+        return Result<>();
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    Result<> EGLContextBackend::fail(const ErrorMessage& error) {
+
+        dispose();
+        return error;
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    void EGLContextBackend::initContextAttribs(const ContextConfig& config) {
+
+        m_contextAttribs.clear();
+
+        // Legacy contexts are created without any attribute.
+        if(config.majorVersion > 1) {
+            m_contextAttribs.push_back(EGL_CONTEXT_MAJOR_VERSION_KHR);
+            m_contextAttribs.push_back(config.majorVersion);
+            m_contextAttribs.push_back(EGL_CONTEXT_MINOR_VERSION_KHR);
+            m_contextAttribs.push_back(config.minorVersion);
+        }
+
+        if(config.profile == ContextProfile::CORE) {
+            m_contextAttribs.push_back(EGL_CONTEXT_OPENGL_PROFILE_MASK_KHR);
+            m_contextAttribs.push_back(EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT_KHR);
+        }
+
+        EGLint flags = 0;
+        if(config.debug) flags |= EGL_CONTEXT_OPENGL_DEBUG_BIT_KHR;
+        if(config.forwardCompatible) flags |= EGL_CONTEXT_OPENGL_FORWARD_COMPATIBLE_BIT_KHR;
+
+        if(flags) {
+            m_contextAttribs.push_back(EGL_CONTEXT_FLAGS_KHR);
+            m_contextAttribs.push_back(flags);
+        }
+
+        // A context cannot be a debug and a no-error context at once, debugging wins.
+        if(config.noError && !config.debug && hasExtension("EGL_KHR_create_context_no_error")) {
+            m_contextAttribs.push_back(EGL_CONTEXT_OPENGL_NO_ERROR_KHR);
+            m_contextAttribs.push_back(EGL_TRUE);
+        }
+
+        m_contextAttribs.push_back(EGL_NONE);
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    bool EGLContextBackend::hasExtension(const char* name) const {
+
+        const char* extensions = eglQueryString(m_display, EGL_EXTENSIONS);
+        if(!extensions) return false;
+
+        const std::size_t length = std::strlen(name);
+        for(const char* p = std::strstr(extensions, name); p; p = std::strstr(p + 1, name)) {
+            if((p == extensions || p[-1] == ' ') && (p[length] == ' ' || p[length] == '\0')) {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    Result<EGLConfig> EGLContextBackend::chooseConfig(const FramebufferFormat& format) const {
+
+        const EGLint configAttribs[] = {
+            EGL_SURFACE_TYPE, EGL_PBUFFER_BIT,
+            EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+            EGL_RED_SIZE, format.redBits,
+            EGL_GREEN_SIZE, format.greenBits,
+            EGL_BLUE_SIZE, format.blueBits,
+            EGL_ALPHA_SIZE, format.alphaBits,
+            EGL_DEPTH_SIZE, format.depthBits,
+            EGL_STENCIL_SIZE, format.stencilBits,
+            EGL_SAMPLE_BUFFERS, format.samples > 0 ? 1 : 0,
+            EGL_SAMPLES, format.samples,
+            EGL_NONE
+        };
+
+        EGLConfig config;
+        EGLint count = 0;
+        if(!eglChooseConfig(m_display, configAttribs, &config, 1, &count) || count < 1) {
+            return ErrorMessage("Could not choose framebuffer config.", eglGetError(),
+                                ErrorCategory::GRAPHICS);
+        }
+
+        return config;
+    }
+
+
+} /* Namespace Piko */
+
+#endif // End of !_WIN32
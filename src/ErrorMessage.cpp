@@ -2,28 +2,116 @@
  * @file        ErrorMessage.cpp
  * @author      Robert Koch
  * @version     1.0
- * 
+ *
  * Implementation of the ErrorMessage class.
  *
  * @see ErrorMessage.h
  */
 #include "../include/ErrorMessage.h"
 
+#include <cstdio>
+#include <ostream>
+
+#if defined(_WIN32)
+    #include <windows.h>
+#else
+    #include <cerrno>
+#endif
+
 
 namespace Piko {
 
     /*===================================================================*
      * PUBLIC MEMBERS                                                    *
      *===================================================================*/
-    ErrorMessage::ErrorMessage(std::string msg, int code)
+
+    ErrorMessage::ErrorMessage()
+      :
+      m_msg("No error."),
+      m_code(0),
+      m_category(ErrorCategory::USER) {
+
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    ErrorMessage::ErrorMessage(const char* msg)
       :
       m_msg(msg),
-      m_code(code) {
+#if defined(_WIN32)
+      m_code((int)GetLastError()),
+#else
+      m_code(errno),
+#endif
+      m_category(ErrorCategory::SYSTEM) {
+
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    ErrorMessage::ErrorMessage(const char* msg, int code, ErrorCategory category)
+      :
+      m_msg(msg),
+      m_code(code),
+      m_category(category) {
+
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    const char* ErrorMessage::getMessage() const {
+
+        return m_msg;
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    int ErrorMessage::getCode() const {
+
+        return m_code;
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    ErrorCategory ErrorMessage::getCategory() const {
+
+        return m_category;
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    std::string ErrorMessage::str() const {
+
+        char code[48];
+
+        switch(m_category) {
+            case ErrorCategory::SYSTEM:
+                std::snprintf(code, sizeof(code), " System error code: %d", m_code);
+                break;
+            case ErrorCategory::GRAPHICS:
+                // EGL and OpenGL document their codes as hexadecimal enums.
+                std::snprintf(code, sizeof(code), " Graphics error code: 0x%04X", m_code);
+                break;
+            default:
+                std::snprintf(code, sizeof(code), " User error code: %d", m_code);
+                break;
+        }
+
+        return std::string(m_msg) + code;
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    std::ostream& operator<<(std::ostream& stream, const ErrorMessage& em) {
 
-          m_oss << m_msg;
-          
-          if(code == -987654321) m_oss << " System error code: " << GetLastError();
-          else m_oss << " User error code: " << code; 
-    } 
+        return stream << em.str();
+    }
 
 } /* Namespace Piko */
\ No newline at end of file
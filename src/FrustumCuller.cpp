@@ -0,0 +1,203 @@
+/**
+ * @file        FrustumCuller.cpp
+ * @author      Robert Koch
+ * @version     1.0
+ *
+ * Implementation of the FrustumCuller class.
+ */
+#include "../include/FrustumCuller.h"
+#include "../include/Profiler.h"
+
+#include <algorithm>
+#include <cstring>
+
+
+namespace Piko {
+
+    namespace {
+
+        /**
+         * Function to run a culling kernel over chunks of CHUNK_SIZE volumes in parallel. Every
+         * chunk writes its visible indices to the start of its own range of the output, the
+         * ranges are moved together afterwards, which keeps the indices sorted.
+         *
+         * @param jobs System running the jobs.
+         * @param count Number of volumes.
+         * @param kernel Callable taking the first volume, the number of volumes and the
+         *               destination, returning the number of visible volumes.
+         * @param visible Receives the indices of the visible volumes.
+         * @return Number of visible volumes.
+         */
+        template<typename F>
+        std::size_t cullChunks(JobSystem& jobs, std::size_t count, const F& kernel,
+                               std::vector<std::uint32_t>& visible) {
+
+            const std::size_t chunkSize = FrustumCuller::CHUNK_SIZE;
+            const std::size_t chunks = (count + chunkSize - 1) / chunkSize;
+            std::vector<std::size_t> counts(chunks);
+
+            visible.resize(count);
+            std::uint32_t* out = visible.data();
+
+            jobs.parallelFor(0, chunks, 1, [&](std::size_t begin, std::size_t end) {
+                for(std::size_t c = begin; c < end; ++c) {
+                    const std::size_t first = c * chunkSize;
+                    const std::size_t n = std::min(chunkSize, count - first);
+                    counts[c] = kernel(first, n, out + first);
+                }
+            });
+
+            std::size_t total = chunks > 0 ? counts[0] : 0;
+            for(std::size_t c = 1; c < chunks; ++c) {
+                std::memmove(out + total, out + c * chunkSize, counts[c] * sizeof(std::uint32_t));
+                total += counts[c];
+            }
+
+            visible.resize(total);
+            return total;
+        }
+
+    } /* Anonymous namespace */
+
+
+
+    /*===================================================================*
+     * STATIC MEMBERS                                                    *
+     *===================================================================*/
+
+    const std::size_t FrustumCuller::CHUNK_SIZE;
+
+
+
+    /*===================================================================*
+     * PUBLIC MEMBERS                                                    *
+     *===================================================================*/
+
+    FrustumCuller::FrustumCuller() {
+
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    std::size_t FrustumCuller::addSphere(const Vector3D<float>& center, float radius) {
+
+        m_sphereCenters.push_back(center);
+        m_sphereRadii.push_back(radius);
+        return m_sphereRadii.size() - 1;
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    void FrustumCuller::setSphere(std::size_t index, const Vector3D<float>& center,
+                                  float radius) {
+
+        m_sphereCenters.set(index, center);
+        m_sphereRadii[index] = radius;
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    std::size_t FrustumCuller::addBox(const AABB<float>& box) {
+
+        const Vector3D<float> e = box.getExtent();
+
+        m_boxCenters.push_back(box.getCenter());
+        m_boxExtents.push_back(Vector3D<float>(e.x() * 0.5f, e.y() * 0.5f, e.z() * 0.5f));
+        return m_boxCenters.size() - 1;
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    void FrustumCuller::setBox(std::size_t index, const AABB<float>& box) {
+
+        const Vector3D<float> e = box.getExtent();
+
+        m_boxCenters.set(index, box.getCenter());
+        m_boxExtents.set(index, Vector3D<float>(e.x() * 0.5f, e.y() * 0.5f, e.z() * 0.5f));
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    void FrustumCuller::clear() {
+
+        m_sphereCenters.clear();
+        m_sphereRadii.clear();
+        m_boxCenters.clear();
+        m_boxExtents.clear();
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    std::size_t FrustumCuller::cullSpheres(const Frustum<float>& frustum,
+                                           std::vector<std::uint32_t>& visible) const {
+
+        PIKO_PROFILE_ZONE("FrustumCuller::cullSpheres");
+
+        const Vector3DArray<float>& c = m_sphereCenters;
+
+        visible.resize(c.size());
+        visible.resize(detail::cullSphereStreams(frustum, c.x(), c.y(), c.z(),
+                                                 m_sphereRadii.data(), 0, visible.data(),
+                                                 c.size()));
+        return visible.size();
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    std::size_t FrustumCuller::cullSpheres(JobSystem& jobs, const Frustum<float>& frustum,
+                                           std::vector<std::uint32_t>& visible) const {
+
+        PIKO_PROFILE_ZONE("FrustumCuller::cullSpheres");
+
+        const Vector3DArray<float>& c = m_sphereCenters;
+        const float* r = m_sphereRadii.data();
+
+        return cullChunks(jobs, c.size(), [&](std::size_t i, std::size_t n, std::uint32_t* out) {
+            return detail::cullSphereStreams(frustum, c.x() + i, c.y() + i, c.z() + i, r + i,
+                                             (std::uint32_t)i, out, n);
+        }, visible);
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    std::size_t FrustumCuller::cullBoxes(const Frustum<float>& frustum,
+                                         std::vector<std::uint32_t>& visible) const {
+
+        PIKO_PROFILE_ZONE("FrustumCuller::cullBoxes");
+
+        const Vector3DArray<float>& c = m_boxCenters;
+        const Vector3DArray<float>& e = m_boxExtents;
+
+        visible.resize(c.size());
+        visible.resize(detail::cullBoxStreams(frustum, c.x(), c.y(), c.z(), e.x(), e.y(), e.z(),
+                                              0, visible.data(), c.size()));
+        return visible.size();
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    std::size_t FrustumCuller::cullBoxes(JobSystem& jobs, const Frustum<float>& frustum,
+                                         std::vector<std::uint32_t>& visible) const {
+
+        PIKO_PROFILE_ZONE("FrustumCuller::cullBoxes");
+
+        const Vector3DArray<float>& c = m_boxCenters;
+        const Vector3DArray<float>& e = m_boxExtents;
+
+        return cullChunks(jobs, c.size(), [&](std::size_t i, std::size_t n, std::uint32_t* out) {
+            return detail::cullBoxStreams(frustum, c.x() + i, c.y() + i, c.z() + i,
+                                          e.x() + i, e.y() + i, e.z() + i,
+                                          (std::uint32_t)i, out, n);
+        }, visible);
+    }
+
+} /* Namespace Piko */
\ No newline at end of file
@@ -7,6 +7,10 @@
  */
 #include "../include/GLContext.h"
 #include "../include/ErrorMessage.h"
+#include "../include/Log.h"
+#include "../include/Profiler.h"
+
+#include <stdexcept>
 
 
 namespace Piko {
@@ -17,10 +21,24 @@ namespace Piko {
 
     GLContext::GLContext() 
       :
-      m_hWnd(NULL),
-      m_hDC(NULL),
-      m_hRC(NULL) {
+      GLContext(GLContextBackend::createDefault()) {
+
+    }
 
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    GLContext::GLContext(std::unique_ptr<GLContextBackend> backend) 
+      :
+      m_backend(std::move(backend)),
+      m_width(0),
+      m_height(0),
+      m_isOffscreen(false) {
+
+        if(!m_backend) {
+            throw std::invalid_argument(
+                ErrorMessage("No context backend specified.", 0).str());
+        }
     }
 
     //---------------------------------------------------------------------------------------------
@@ -34,51 +52,68 @@ namespace Piko {
     //---------------------------------------------------------------------------------------------
     //---------------------------------------------------------------------------------------------
 
-    void GLContext::init(HWND hWnd) {
+    void GLContext::init(HWND hWnd, const ContextConfig& config) {
 
-        std::cout << "[GLContext] Initialize OpenGL context." << std::endl;
+        tryInit(hWnd, config).check();
+    }
 
-        m_hWnd = hWnd;
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
 
-        // Try to get device context
-        if(!(m_hDC = GetDC(m_hWnd))) {
-            throw std::runtime_error(
-                ErrorMessage("Could not retrieve device context.").str());
-        }
+    void GLContext::initOffscreen(int width, int height, const ContextConfig& config) {
 
-        // Setup of pixel format descriptor
-        PIXELFORMATDESCRIPTOR pfd;
-        ZeroMemory(&pfd, sizeof(PIXELFORMATDESCRIPTOR));
-        
-        pfd.nSize = sizeof(PIXELFORMATDESCRIPTOR);
-        pfd.nVersion = 1;
-        pfd.dwFlags = PFD_DRAW_TO_WINDOW |PFD_SUPPORT_OPENGL | PFD_DOUBLEBUFFER;
-        pfd.iPixelType = PFD_TYPE_RGBA;
-        pfd.cColorBits = 24;
-        pfd.cDepthBits = 16;
-        pfd.iLayerType = PFD_MAIN_PLANE;
-
-        int pixelFormat;
-        if(!(pixelFormat = ChoosePixelFormat(m_hDC, &pfd))) {
-            throw std::runtime_error(
-                ErrorMessage("Could not choose pixel format.").str());
+        if(width <= 0 || height <= 0) {
+            throw std::invalid_argument(
+                ErrorMessage("Invalid offscreen drawable size.", 0).str());
         }
 
-        if(!SetPixelFormat(m_hDC, pixelFormat, &pfd)) {
-            throw std::runtime_error(
-                ErrorMessage("Could not set pixel format.").str());
-        }
+        tryInitOffscreen(width, height, config).check();
+    }
 
-        // Setup contexts
-        if(!(m_hRC = wglCreateContext(m_hDC))) {
-            throw std::runtime_error(
-                ErrorMessage("Could not create rendering context.").str());
-        }
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    Result<> GLContext::tryInit(HWND hWnd, const ContextConfig& config) {
+
+        PIKO_PROFILE_ZONE("GLContext::init");
+        PIKO_LOG_DEBUG("[GLContext] Initialize OpenGL context.");
+
+        Result<> result = m_backend->tryInit(hWnd, config);
+        if(!result) return result;
+
+        m_isOffscreen = false;
+
+        // The initial viewport covers the whole client area of the window.
+        GLint viewport[4];
+        glGetIntegerv(GL_VIEWPORT, viewport);
+        m_width = viewport[2];
+        m_height = viewport[3];
+
+        initCommon();
+        return result;
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    Result<> GLContext::tryInitOffscreen(int width, int height, const ContextConfig& config) {
 
-        if(!wglMakeCurrent(m_hDC, m_hRC)) {
-            throw std::runtime_error(
-                ErrorMessage("Could not activate rendering context.").str());
+        PIKO_PROFILE_ZONE("GLContext::initOffscreen");
+        PIKO_LOG_DEBUG("[GLContext] Initialize offscreen OpenGL context {}x{}.", width, height);
+
+        if(width <= 0 || height <= 0) {
+            return ErrorMessage("Invalid offscreen drawable size.", 0);
         }
+
+        Result<> result = m_backend->tryInitOffscreen(width, height, config);
+        if(!result) return result;
+
+        m_isOffscreen = true;
+        m_width = width;
+        m_height = height;
+
+        initCommon();
+        return result;
     }
 
     //---------------------------------------------------------------------------------------------
@@ -86,20 +121,144 @@ namespace Piko {
 
     void GLContext::dispose() {
 
-        std::cout << "[GLContext] Dispose OpenGl context." << std::endl;
+        PIKO_PROFILE_ZONE("GLContext::dispose");
+        PIKO_LOG_DEBUG("[GLContext] Dispose OpenGL context.");
 
-        if(m_hRC) {
-            wglMakeCurrent(NULL, NULL);
-            wglDeleteContext(m_hRC);
-        }
+        // The queries belong to the context, so they go first.
+        m_gpuTimer.release();
+        m_backend->dispose();
+        m_extensions = GLExtensions();
+        m_granted = ContextConfig();
+        m_width = 0;
+        m_height = 0;
+        m_isOffscreen = false;
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    std::unique_ptr<GLContext> GLContext::createSharedContext() const {
+
+        std::unique_ptr<GLContext> shared(new GLContext(m_backend->createShared()));
+
+        // Both contexts come from the same implementation and framebuffer format.
+        shared->m_extensions = m_extensions;
+        shared->m_granted = m_granted;
+        shared->m_isOffscreen = true;
+        return shared;
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    void GLContext::makeCurrent() {
+
+        m_backend->makeCurrent();
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    void GLContext::doneCurrent() {
+
+        m_backend->doneCurrent();
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    void GLContext::setSwapInterval(int interval) {
+
+        m_backend->setSwapInterval(interval);
+        m_granted.swapInterval = m_backend->getSwapInterval();
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    void GLContext::swapBuffers() {
+
+        m_backend->swapBuffers();
+        m_gpuTimer.nextFrame();
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    void GLContext::renderFrames(int count, const FrameCallback& frame) {
 
-        if(m_hWnd && m_hDC) {
-            ReleaseDC(m_hWnd, m_hDC);
+        for(int i = 0; i < count; ++i) {
+            frame(i);
+            swapBuffers();
         }
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    void GLContext::readPixels(std::vector<unsigned char>& pixels) const {
+
+        pixels.resize((std::size_t)m_width * m_height * 4);
+        if(pixels.empty()) return;
+
+        // Rows of RGBA bytes are always 4 byte aligned, so the pack alignment does not matter.
+        glReadPixels(0, 0, m_width, m_height, GL_RGBA, GL_UNSIGNED_BYTE, &pixels[0]);
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    ContextConfig GLContext::getGrantedConfig() const {
+
+        return m_granted;
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    const FramebufferFormat& GLContext::getFramebufferFormat() const {
+
+        return m_backend->getFramebufferFormat();
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    const GLExtensions& GLContext::getExtensions() const {
+
+        return m_extensions;
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    GPUTimer& GLContext::getGPUTimer() {
+
+        return m_gpuTimer;
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
 
-        m_hWnd = NULL;
-        m_hDC = NULL;
-        m_hRC = NULL;
+    int GLContext::getWidth() const {
+
+        return m_width;
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    int GLContext::getHeight() const {
+
+        return m_height;
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    bool GLContext::isOffscreen() const {
+
+        return m_isOffscreen;
     }
 
     //---------------------------------------------------------------------------------------------
@@ -107,7 +266,55 @@ namespace Piko {
 
     HDC GLContext::getDeviceContext() const {
         
-        return m_hDC;
+        return m_backend->getDeviceContext();
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    GLContextBackend& GLContext::getBackend() const {
+
+        return *m_backend;
+    }
+
+
+
+    /*===============================================*
+     *  PRIVATE MEMBERS                              *
+     *===============================================*/
+
+    void GLContext::initCommon() {
+
+        m_extensions.load(*m_backend);
+        m_gpuTimer.init(m_extensions);
+
+        m_granted = ContextConfig(m_backend->getFramebufferFormat());
+        m_granted.majorVersion = m_extensions.majorVersion;
+        m_granted.minorVersion = m_extensions.minorVersion;
+        m_granted.swapInterval = m_backend->getSwapInterval();
+
+        // Profiles exist since 3.2, context flags since 3.0 with the no-error bit since 4.6.
+        if(m_extensions.majorVersion >= 3) {
+            GLint flags = 0;
+            glGetIntegerv(GL_CONTEXT_FLAGS, &flags);
+            m_granted.forwardCompatible = (flags & GL_CONTEXT_FLAG_FORWARD_COMPATIBLE_BIT) != 0;
+            m_granted.debug = (flags & GL_CONTEXT_FLAG_DEBUG_BIT) != 0;
+            m_granted.noError = (flags & GL_CONTEXT_FLAG_NO_ERROR_BIT) != 0;
+        }
+
+        if(m_extensions.majorVersion > 3 
+                || (m_extensions.majorVersion == 3 && m_extensions.minorVersion >= 2)) {
+            GLint mask = 0;
+            glGetIntegerv(GL_CONTEXT_PROFILE_MASK, &mask);
+            if(mask & GL_CONTEXT_CORE_PROFILE_BIT) m_granted.profile = ContextProfile::CORE;
+        }
+
+        // The default framebuffer only converts to sRGB if enabled.
+        if(m_granted.format.sRGB) {
+            glEnable(GL_FRAMEBUFFER_SRGB);
+        }
+
+        glGetError();
     }
 
 } /* Namespace Piko */
\ No newline at end of file
@@ -0,0 +1,52 @@
+/**
+ * @file        GLContextBackend.cpp
+ * @author      Robert Koch
+ * @version     1.0
+ *
+ * Implementation of the GLContextBackend interface.
+ */
+#include "../include/GLContextBackend.h"
+#include "../include/EGLContextBackend.h"
+#include "../include/WGLContextBackend.h"
+
+
+namespace Piko {
+
+    /*===================================================================*
+     * PUBLIC MEMBERS                                                    *
+     *===================================================================*/
+
+    std::unique_ptr<GLContextBackend> GLContextBackend::createDefault() {
+
+#if defined(_WIN32)
+        return std::unique_ptr<GLContextBackend>(new WGLContextBackend());
+#else
+        return std::unique_ptr<GLContextBackend>(new EGLContextBackend());
+#endif
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    GLContextBackend::~GLContextBackend() {
+
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    void GLContextBackend::init(HWND hWnd, const ContextConfig& config) {
+
+        tryInit(hWnd, config).check();
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    void GLContextBackend::initOffscreen(int width, int height, const ContextConfig& config) {
+
+        tryInitOffscreen(width, height, config).check();
+    }
+
+
+} /* Namespace Piko */
@@ -0,0 +1,137 @@
+/**
+ * @file        GLExtensions.cpp
+ * @author      Robert Koch
+ * @version     1.0
+ *
+ * Implementation of the GLExtensions loader.
+ */
+#include "../include/GLExtensions.h"
+#include "../include/GLContextBackend.h"
+
+#include <cstdio>
+#include <cstring>
+
+
+namespace Piko {
+
+    namespace {
+
+        /**
+         * Function to load a function into a pointer of the matching type.
+         */
+        template<typename F>
+        bool loadFunction(const GLContextBackend& backend, const char* name, F& function) {
+
+            function = reinterpret_cast<F>(backend.getProcAddress(name));
+            return function != NULL;
+        }
+
+    } /* Anonymous namespace */
+
+
+
+    /*===================================================================*
+     * PUBLIC MEMBERS                                                    *
+     *===================================================================*/
+
+    GLExtensions::GLExtensions()
+      :
+      majorVersion(0),
+      minorVersion(0),
+      hasBufferObjects(false),
+      hasMapBufferRange(false),
+      hasSync(false),
+      hasTimerQuery(false),
+      glGetStringi(NULL),
+      glGenBuffers(NULL),
+      glDeleteBuffers(NULL),
+      glBindBuffer(NULL),
+      glBufferData(NULL),
+      glBufferSubData(NULL),
+      glMapBufferRange(NULL),
+      glUnmapBuffer(NULL),
+      glFenceSync(NULL),
+      glDeleteSync(NULL),
+      glClientWaitSync(NULL),
+      glWaitSync(NULL),
+      glGenQueries(NULL),
+      glDeleteQueries(NULL),
+      glGetQueryObjectiv(NULL),
+      glQueryCounter(NULL),
+      glGetQueryObjectui64v(NULL) {
+
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    void GLExtensions::load(const GLContextBackend& backend) {
+
+        *this = GLExtensions();
+
+        // GL_MAJOR_VERSION is not known before 3.0, so parse the version string.
+        const char* version = (const char *)glGetString(GL_VERSION);
+        if(version) std::sscanf(version, "%d.%d", &majorVersion, &minorVersion);
+
+        const bool atLeast30 = majorVersion >= 3;
+        const bool atLeast32 = majorVersion > 3 || (majorVersion == 3 && minorVersion >= 2);
+        const bool atLeast33 = majorVersion > 3 || (majorVersion == 3 && minorVersion >= 3);
+
+        if(atLeast30) loadFunction(backend, "glGetStringi", glGetStringi);
+
+        hasBufferObjects = loadFunction(backend, "glGenBuffers", glGenBuffers);
+        hasBufferObjects &= loadFunction(backend, "glDeleteBuffers", glDeleteBuffers);
+        hasBufferObjects &= loadFunction(backend, "glBindBuffer", glBindBuffer);
+        hasBufferObjects &= loadFunction(backend, "glBufferData", glBufferData);
+        hasBufferObjects &= loadFunction(backend, "glBufferSubData", glBufferSubData);
+
+        hasMapBufferRange = loadFunction(backend, "glMapBufferRange", glMapBufferRange);
+        hasMapBufferRange &= loadFunction(backend, "glUnmapBuffer", glUnmapBuffer);
+        hasMapBufferRange &= atLeast30 || hasExtension("GL_ARB_map_buffer_range");
+
+        hasSync = loadFunction(backend, "glFenceSync", glFenceSync);
+        hasSync &= loadFunction(backend, "glDeleteSync", glDeleteSync);
+        hasSync &= loadFunction(backend, "glClientWaitSync", glClientWaitSync);
+        hasSync &= loadFunction(backend, "glWaitSync", glWaitSync);
+        hasSync &= atLeast32 || hasExtension("GL_ARB_sync");
+
+        hasTimerQuery = loadFunction(backend, "glGenQueries", glGenQueries);
+        hasTimerQuery &= loadFunction(backend, "glDeleteQueries", glDeleteQueries);
+        hasTimerQuery &= loadFunction(backend, "glGetQueryObjectiv", glGetQueryObjectiv);
+        hasTimerQuery &= loadFunction(backend, "glQueryCounter", glQueryCounter);
+        hasTimerQuery &= loadFunction(backend, "glGetQueryObjectui64v", glGetQueryObjectui64v);
+        hasTimerQuery &= atLeast33 || hasExtension("GL_ARB_timer_query");
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    bool GLExtensions::hasExtension(const char* name) const {
+
+        // Core profiles only offer the extensions one by one.
+        if(glGetStringi) {
+            GLint count = 0;
+            glGetIntegerv(GL_NUM_EXTENSIONS, &count);
+
+            for(GLint i = 0; i < count; ++i) {
+                const char* extension = (const char *)glGetStringi(GL_EXTENSIONS, i);
+                if(extension && std::strcmp(extension, name) == 0) return true;
+            }
+
+            return false;
+        }
+
+        const char* extensions = (const char *)glGetString(GL_EXTENSIONS);
+        if(!extensions) return false;
+
+        const std::size_t length = std::strlen(name);
+        for(const char* p = std::strstr(extensions, name); p; p = std::strstr(p + 1, name)) {
+            if((p == extensions || p[-1] == ' ') && (p[length] == ' ' || p[length] == '\0')) {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+} /* Namespace Piko */
\ No newline at end of file
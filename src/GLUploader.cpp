@@ -0,0 +1,274 @@
+/**
+ * @file        GLUploader.cpp
+ * @author      Robert Koch
+ * @version     1.0
+ *
+ * Implementation of the GLUploader class.
+ */
+#include "../include/GLUploader.h"
+#include "../include/ErrorMessage.h"
+#include "../include/Profiler.h"
+
+#include <stdexcept>
+
+
+namespace Piko {
+
+    namespace {
+
+        /**
+         * Upload of a buffer object, holding the data until the worker consumed it.
+         */
+        struct BufferUpload {
+
+            GLenum target;
+            std::vector<unsigned char> data;
+            GLenum usage;
+
+            GLuint operator()(const GLExtensions& gl) const {
+
+                if(!gl.hasBufferObjects) return 0;
+
+                GLuint name = 0;
+                gl.glGenBuffers(1, &name);
+                gl.glBindBuffer(target, name);
+                gl.glBufferData(target, (GLsizeiptr)data.size(), 
+                                data.empty() ? NULL : &data[0], usage);
+                gl.glBindBuffer(target, 0);
+                return name;
+            }
+        };
+
+        /**
+         * Upload of a 2D texture, holding the pixels until the worker consumed them.
+         */
+        struct TextureUpload {
+
+            GLint internalFormat;
+            GLsizei width;
+            GLsizei height;
+            GLenum format;
+            GLenum type;
+            std::vector<unsigned char> pixels;
+
+            GLuint operator()(const GLExtensions&) const {
+
+                GLuint name = 0;
+                glGenTextures(1, &name);
+                glBindTexture(GL_TEXTURE_2D, name);
+
+                // No mipmaps are uploaded, so the default filter would leave it incomplete.
+                glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+                glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+                glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+                glTexImage2D(GL_TEXTURE_2D, 0, internalFormat, width, height, 0, format, type,
+                             pixels.empty() ? NULL : &pixels[0]);
+                glBindTexture(GL_TEXTURE_2D, 0);
+                return name;
+            }
+        };
+
+    } /* Anonymous namespace */
+
+
+
+    /*===================================================================*
+     * PUBLIC MEMBERS                                                    *
+     *===================================================================*/
+
+    GLUploader::GLUploader(GLContext& context, std::size_t workerCount)
+      :
+      m_context(context),
+      m_pendingCount(0),
+      m_isStopping(false) {
+
+        if(workerCount == 0) {
+            throw std::invalid_argument(
+                ErrorMessage("At least one upload worker is required.", 0).str());
+        }
+
+        // All contexts are created up front, so a failure leaves no thread behind.
+        for(std::size_t i = 0; i < workerCount; ++i) {
+            m_workerContexts.push_back(m_context.createSharedContext());
+        }
+
+        for(std::size_t i = 0; i < workerCount; ++i) {
+            m_workers.push_back(std::thread(&GLUploader::work, this, m_workerContexts[i].get()));
+        }
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    GLUploader::~GLUploader() {
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_isStopping = true;
+        }
+
+        m_condition.notify_all();
+        for(std::size_t i = 0; i < m_workers.size(); ++i) {
+            m_workers[i].join();
+        }
+
+        // Fences belong to the shared object space, they can be deleted from the main context.
+        const GLExtensions& gl = m_context.getExtensions();
+        m_waiting.insert(m_waiting.end(), m_results.begin(), m_results.end());
+        for(std::size_t i = 0; i < m_waiting.size(); ++i) {
+            if(m_waiting[i].fence) gl.glDeleteSync(m_waiting[i].fence);
+        }
+
+        m_workerContexts.clear();
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    void GLUploader::upload(const UploadJob& job, const ReadyCallback& onReady) {
+
+        Job entry = { job, onReady };
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_jobs.push_back(entry);
+            ++m_pendingCount;
+        }
+
+        m_condition.notify_one();
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    void GLUploader::uploadBuffer(GLenum target, std::vector<unsigned char> data, GLenum usage,
+                                  const ReadyCallback& onReady) {
+
+        BufferUpload job;
+        job.target = target;
+        job.data.swap(data);
+        job.usage = usage;
+
+        upload(std::move(job), onReady);
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    void GLUploader::uploadTexture2D(GLint internalFormat, GLsizei width, GLsizei height,
+                                     GLenum format, GLenum type, std::vector<unsigned char> pixels,
+                                     const ReadyCallback& onReady) {
+
+        TextureUpload job;
+        job.internalFormat = internalFormat;
+        job.width = width;
+        job.height = height;
+        job.format = format;
+        job.type = type;
+        job.pixels.swap(pixels);
+
+        upload(std::move(job), onReady);
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    std::size_t GLUploader::poll() {
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_waiting.insert(m_waiting.end(), m_results.begin(), m_results.end());
+            m_results.clear();
+        }
+
+        const GLExtensions& gl = m_context.getExtensions();
+        std::size_t ready = 0;
+        std::size_t kept = 0;
+
+        for(std::size_t i = 0; i < m_waiting.size(); ++i) {
+            Result& result = m_waiting[i];
+
+            // A zero timeout only queries the fence state.
+            if(result.fence) {
+                GLenum state = gl.glClientWaitSync(result.fence, 0, 0);
+                if(state == GL_TIMEOUT_EXPIRED) {
+                    if(kept != i) m_waiting[kept] = result;
+                    ++kept;
+                    continue;
+                }
+                gl.glDeleteSync(result.fence);
+            }
+
+            result.onReady(result.name);
+            ++ready;
+        }
+
+        m_waiting.resize(kept);
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_pendingCount -= ready;
+        return ready;
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    std::size_t GLUploader::getPendingCount() const {
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_pendingCount;
+    }
+
+
+
+    /*===================================================================*
+     * PRIVATE MEMBERS                                                   *
+     *===================================================================*/
+
+    void GLUploader::work(GLContext* context) {
+
+        PIKO_PROFILE_THREAD("Upload worker");
+
+        context->makeCurrent();
+        const GLExtensions& gl = context->getExtensions();
+
+        std::unique_lock<std::mutex> lock(m_mutex);
+
+        for(;;) {
+            m_condition.wait(lock, [this] { return !m_jobs.empty() || m_isStopping; });
+
+            // Queued jobs are still executed after the destructor was called.
+            if(m_jobs.empty()) break;
+
+            Job job = m_jobs.front();
+            m_jobs.pop_front();
+            lock.unlock();
+
+            Result result = { 0, NULL, job.onReady };
+
+            try {
+                PIKO_PROFILE_ZONE("GLUploader::upload");
+                result.name = job.upload(gl);
+            }
+            catch(...) {
+                result.name = 0;
+            }
+
+            // The flush makes the fence visible to the other contexts.
+            if(gl.hasSync) {
+                result.fence = gl.glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+                glFlush();
+            }
+            else {
+                glFinish();
+            }
+
+            lock.lock();
+            m_results.push_back(result);
+        }
+
+        lock.unlock();
+        context->doneCurrent();
+    }
+
+} /* Namespace Piko */
\ No newline at end of file
@@ -0,0 +1,244 @@
+/**
+ * @file        GPUTimer.cpp
+ * @author      Robert Koch
+ * @version     1.0
+ *
+ * Implementation of the GPUTimer class.
+ */
+#include "../include/GPUTimer.h"
+
+
+namespace Piko {
+
+    /*===================================================================*
+     * STATIC MEMBERS                                                    *
+     *===================================================================*/
+
+    const std::size_t GPUTimer::NO_QUERY;
+
+
+
+    /*===================================================================*
+     * PUBLIC MEMBERS                                                    *
+     *===================================================================*/
+
+    GPUTimer::GPUTimer()
+      :
+      m_gl(NULL),
+      m_current(0),
+      m_resultFrame(0),
+      m_frameNumber(0),
+      m_droppedFrames(0) {
+
+        for(std::size_t i = 0; i < FRAME_LATENCY; ++i) {
+            m_frames[i].queryCount = 0;
+            m_frames[i].number = 0;
+            m_frames[i].isPending = false;
+        }
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    GPUTimer::~GPUTimer() {
+
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    void GPUTimer::init(const GLExtensions& gl) {
+
+        release();
+
+        if(!gl.hasTimerQuery) return;
+
+        m_gl = &gl;
+
+        for(std::size_t i = 0; i < FRAME_LATENCY; ++i) {
+            Frame& frame = m_frames[i];
+            frame.queries.resize(2 * MAX_PASSES);
+            frame.passes.reserve(MAX_PASSES);
+            m_gl->glGenQueries((GLsizei)frame.queries.size(), &frame.queries[0]);
+        }
+
+        m_open.reserve(MAX_PASSES);
+        m_results.reserve(MAX_PASSES);
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    void GPUTimer::release() {
+
+        for(std::size_t i = 0; i < FRAME_LATENCY; ++i) {
+            Frame& frame = m_frames[i];
+
+            if(m_gl && !frame.queries.empty()) {
+                m_gl->glDeleteQueries((GLsizei)frame.queries.size(), &frame.queries[0]);
+            }
+
+            frame.queries.clear();
+            frame.passes.clear();
+            frame.queryCount = 0;
+            frame.number = 0;
+            frame.isPending = false;
+        }
+
+        m_gl = NULL;
+        m_current = 0;
+        m_open.clear();
+        m_results.clear();
+        m_resultFrame = 0;
+        m_frameNumber = 0;
+        m_droppedFrames = 0;
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    bool GPUTimer::isSupported() const {
+
+        return m_gl != NULL;
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    void GPUTimer::beginPass(const char* name) {
+
+        if(!m_gl) return;
+
+        Frame& frame = m_frames[m_current];
+
+        if(frame.passes.size() == MAX_PASSES) {
+            m_open.push_back(NO_QUERY);
+            return;
+        }
+
+        Pass pass = { name, (int)m_open.size(), frame.queryCount++, NO_QUERY };
+        m_gl->glQueryCounter(frame.queries[pass.begin], GL_TIMESTAMP);
+
+        m_open.push_back(frame.passes.size());
+        frame.passes.push_back(pass);
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    void GPUTimer::endPass() {
+
+        if(!m_gl || m_open.empty()) return;
+
+        const std::size_t index = m_open.back();
+        m_open.pop_back();
+        if(index == NO_QUERY) return;
+
+        Frame& frame = m_frames[m_current];
+        Pass& pass = frame.passes[index];
+        pass.end = frame.queryCount++;
+        m_gl->glQueryCounter(frame.queries[pass.end], GL_TIMESTAMP);
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    void GPUTimer::nextFrame() {
+
+        if(!m_gl) return;
+
+        // Passes left open end with the frame.
+        while(!m_open.empty()) endPass();
+
+        Frame& finished = m_frames[m_current];
+        finished.number = m_frameNumber++;
+        finished.isPending = finished.queryCount > 0;
+
+        m_current = (m_current + 1) % FRAME_LATENCY;
+
+        // The frame after the finished one is the oldest. Timestamps complete in order, so
+        // stop at the first frame which is not available yet.
+        for(std::size_t i = 0; i < FRAME_LATENCY; ++i) {
+            Frame& frame = m_frames[(m_current + i) % FRAME_LATENCY];
+            if(frame.isPending && !collect(frame)) break;
+        }
+
+        // Waiting for the oldest frame would stall, its queries are reused unread instead.
+        Frame& next = m_frames[m_current];
+
+        if(next.isPending) {
+            next.isPending = false;
+            ++m_droppedFrames;
+        }
+
+        next.passes.clear();
+        next.queryCount = 0;
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    const std::vector<GPUPassTiming>& GPUTimer::getResults() const {
+
+        return m_results;
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    std::uint64_t GPUTimer::getResultFrameNumber() const {
+
+        return m_resultFrame;
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    std::uint64_t GPUTimer::getFrameNumber() const {
+
+        return m_frameNumber;
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    std::size_t GPUTimer::getDroppedFrameCount() const {
+
+        return m_droppedFrames;
+    }
+
+
+
+    /*===================================================================*
+     * PRIVATE MEMBERS                                                   *
+     *===================================================================*/
+
+    bool GPUTimer::collect(Frame& frame) {
+
+        GLint isAvailable = 0;
+        m_gl->glGetQueryObjectiv(frame.queries[frame.queryCount - 1], GL_QUERY_RESULT_AVAILABLE,
+                                 &isAvailable);
+        if(!isAvailable) return false;
+
+        m_results.clear();
+
+        for(std::size_t i = 0; i < frame.passes.size(); ++i) {
+            const Pass& pass = frame.passes[i];
+
+            GLuint64 begin = 0;
+            GLuint64 end = 0;
+            m_gl->glGetQueryObjectui64v(frame.queries[pass.begin], GL_QUERY_RESULT, &begin);
+            m_gl->glGetQueryObjectui64v(frame.queries[pass.end], GL_QUERY_RESULT, &end);
+
+            const double ms = end > begin ? (end - begin) * 1e-6 : 0.0;
+            GPUPassTiming timing = { pass.name, pass.depth, ms };
+            m_results.push_back(timing);
+        }
+
+        m_resultFrame = frame.number;
+        frame.isPending = false;
+        return true;
+    }
+
+
+} /* Namespace Piko */
\ No newline at end of file
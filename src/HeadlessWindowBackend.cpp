@@ -0,0 +1,214 @@
+/**
+ * @file        HeadlessWindowBackend.cpp
+ * @author      Robert Koch
+ * @version     1.0
+ *
+ * Implementation of the HeadlessWindowBackend class.
+ */
+#include "../include/HeadlessWindowBackend.h"
+
+
+namespace Piko {
+
+    /*===================================================================*
+     * PUBLIC MEMBERS                                                    *
+     *===================================================================*/
+
+    HeadlessWindowBackend::HeadlessWindowBackend(int displayWidth, int displayHeight)
+      :
+      m_window(NULL),
+      m_displayWidth(displayWidth),
+      m_displayHeight(displayHeight),
+      m_width(0),
+      m_height(0),
+      m_isVisible(false),
+      m_isFullscreen(false),
+      m_isDestroyed(false) {
+
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    void HeadlessWindowBackend::create(WindowBase* window, const std::string& title, int width,
+                                       int height) {
+
+        m_window = window;
+        m_title = title;
+        m_width = width;
+        m_height = height;
+        m_isDestroyed = false;
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    void HeadlessWindowBackend::destroy() {
+
+        if(m_isDestroyed) return;
+
+        // Like DestroyWindow() the message is sent synchronously.
+        m_isDestroyed = true;
+        m_isVisible = false;
+        m_queue.clear();
+        dispatch(m_window, WM_DESTROY, 0, 0);
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    void HeadlessWindowBackend::show() {
+
+        m_isVisible = true;
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    void HeadlessWindowBackend::setTitle(const std::string& title) {
+
+        m_title = title;
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    void HeadlessWindowBackend::setFullscreen(bool flag, int width, int height) {
+
+        m_isFullscreen = flag;
+        m_isVisible = true;
+        m_width = width;
+        m_height = height;
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    int HeadlessWindowBackend::processMessages() {
+
+        int count = 0;
+
+        while(!m_isDestroyed && !m_queue.empty()) {
+            HeadlessMessage msg = m_queue.front();
+            m_queue.pop_front();
+            dispatch(m_window, msg.msg, msg.wParam, msg.lParam);
+            ++count;
+        }
+
+        HeadlessMessage msg;
+        while(!m_isDestroyed && m_source && m_source(msg)) {
+            dispatch(m_window, msg.msg, msg.wParam, msg.lParam);
+            ++count;
+        }
+
+        return count;
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    int HeadlessWindowBackend::getDisplayWidth() const {
+
+        return m_displayWidth;
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    int HeadlessWindowBackend::getDisplayHeight() const {
+
+        return m_displayHeight;
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    HWND HeadlessWindowBackend::getHandle() const {
+
+        // There is no native window, the backend itself serves as a unique handle.
+        return m_isDestroyed ? NULL : (HWND)this;
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    void HeadlessWindowBackend::postMessage(UINT msg, WPARAM wParam, LPARAM lParam) {
+
+        HeadlessMessage message = { msg, wParam, lParam };
+        m_queue.push_back(message);
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    void HeadlessWindowBackend::postMessages(const std::vector<HeadlessMessage>& messages) {
+
+        m_queue.insert(m_queue.end(), messages.begin(), messages.end());
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    void HeadlessWindowBackend::setEventSource(EventSource source) {
+
+        m_source = source;
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    std::size_t HeadlessWindowBackend::getPendingCount() const {
+
+        return m_queue.size();
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    const std::string& HeadlessWindowBackend::getTitle() const {
+
+        return m_title;
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    int HeadlessWindowBackend::getWindowWidth() const {
+
+        return m_width;
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    int HeadlessWindowBackend::getWindowHeight() const {
+
+        return m_height;
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    bool HeadlessWindowBackend::isVisible() const {
+
+        return m_isVisible;
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    bool HeadlessWindowBackend::isFullscreen() const {
+
+        return m_isFullscreen;
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    bool HeadlessWindowBackend::isDestroyed() const {
+
+        return m_isDestroyed;
+    }
+
+
+} /* Namespace Piko */
@@ -0,0 +1,386 @@
+/**
+ * @file        JobSystem.cpp
+ * @author      Robert Koch
+ * @version     1.0
+ *
+ * Implementation of the JobSystem class.
+ */
+#include "../include/JobSystem.h"
+#include "../include/ErrorMessage.h"
+#include "../include/Profiler.h"
+#include "../include/util/WorkStealingDeque.h"
+
+#include <stdexcept>
+
+
+namespace Piko {
+
+    namespace {
+
+        /** Number of failed searches for a job before a worker goes to sleep. */
+        const unsigned int SPIN_COUNT = 64;
+
+        /**
+         * Membership of a thread in a job system.
+         */
+        struct ThreadState {
+            const JobSystem* system;    /**< System the thread belongs to, or NULL. */
+            std::size_t worker;         /**< Index of the worker of the thread. */
+            std::size_t victim;         /**< Next worker to steal from. */
+        };
+
+        thread_local ThreadState t_state = { NULL, 0, 0 };
+
+    } /* Anonymous namespace */
+
+    /**
+     * Deque and job storage of a thread. Jobs are stored in a ring of slots next to the deque,
+     * so scheduling never allocates. A slot is free again as soon as its job was taken.
+     */
+    struct JobSystem::Worker {
+
+        /**
+         * Storage of a queued job.
+         */
+        struct Slot {
+            Job job;                            /**< Queued job. */
+            std::atomic<bool> isQueued;         /**< Flag if the job was not taken yet. */
+        };
+
+        WorkStealingDeque<Slot*> deque;         /**< Queued jobs of the thread. */
+        std::unique_ptr<Slot[]> slots;          /**< Ring of job storage. */
+        std::size_t nextSlot;                   /**< Next slot to use. */
+        std::thread thread;                     /**< Worker thread, empty for the owner. */
+
+        Worker()
+          :
+          deque(MAX_QUEUED_JOBS),
+          slots(new Slot[MAX_QUEUED_JOBS]),
+          nextSlot(0) {
+
+            for(std::size_t i = 0; i < MAX_QUEUED_JOBS; ++i) slots[i].isQueued = false;
+        }
+    };
+
+
+
+    /*===================================================================*
+     * STATIC MEMBERS                                                    *
+     *===================================================================*/
+
+    const std::size_t JobSystem::MAX_QUEUED_JOBS;
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    std::size_t JobSystem::getDefaultWorkerCount() {
+
+        const unsigned int threads = std::thread::hardware_concurrency();
+        return threads > 1 ? threads - 1 : 0;
+    }
+
+
+
+    /*===================================================================*
+     * PUBLIC MEMBERS                                                    *
+     *===================================================================*/
+
+    JobSystem::JobSystem(std::size_t workerCount)
+      :
+      m_queued(0),
+      m_sleeping(0),
+      m_isStopping(false),
+      m_sharedCount(0),
+      m_pinnedCount(0),
+      m_pinnedThread(std::this_thread::get_id()) {
+
+        // All deques exist before the first thread starts stealing from them.
+        for(std::size_t i = 0; i <= workerCount; ++i) {
+            m_workers.push_back(std::unique_ptr<Worker>(new Worker()));
+        }
+
+        t_state.system = this;
+        t_state.worker = 0;
+        t_state.victim = 0;
+
+        for(std::size_t i = 1; i <= workerCount; ++i) {
+            m_workers[i]->thread = std::thread(&JobSystem::work, this, i);
+        }
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    JobSystem::~JobSystem() {
+
+        {
+            std::lock_guard<std::mutex> lock(m_sleepMutex);
+            m_isStopping.store(true);
+        }
+        m_wakeCondition.notify_all();
+
+        for(std::size_t i = 1; i < m_workers.size(); ++i) m_workers[i]->thread.join();
+
+        if(t_state.system == this) t_state.system = NULL;
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    void JobSystem::run(JobFunction function, void* data, std::size_t begin, std::size_t end,
+                        JobCounter& counter, const JobCounter* dependency) {
+
+        Job job = { function, data, begin, end, &counter, dependency };
+        counter.m_pending.fetch_add(1, std::memory_order_relaxed);
+
+        Worker* worker = getThreadWorker();
+
+        if(!worker) {
+            std::lock_guard<std::mutex> lock(m_sharedMutex);
+            m_shared.push_back(job);
+            m_sharedCount.fetch_add(1);
+        }
+        else {
+            Worker::Slot& slot = worker->slots[worker->nextSlot % MAX_QUEUED_JOBS];
+
+            // All slots taken, the deque is full as well. Running the job right away is the
+            // only way to make progress without waiting.
+            if(slot.isQueued.load(std::memory_order_acquire)) {
+                execute(job);
+                return;
+            }
+
+            slot.job = job;
+            slot.isQueued.store(true, std::memory_order_relaxed);
+
+            if(!worker->deque.push(&slot)) {
+                slot.isQueued.store(false, std::memory_order_relaxed);
+                execute(job);
+                return;
+            }
+
+            ++worker->nextSlot;
+        }
+
+        m_queued.fetch_add(1);
+        wakeWorker();
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    void JobSystem::runPinned(JobFunction function, void* data, JobCounter& counter) {
+
+        Job job = { function, data, 0, 0, &counter, NULL };
+        counter.m_pending.fetch_add(1, std::memory_order_relaxed);
+
+        std::lock_guard<std::mutex> lock(m_pinnedMutex);
+        m_pinned.push_back(job);
+        m_pinnedCount.fetch_add(1);
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    void JobSystem::pinThread() {
+
+        m_pinnedThread.store(std::this_thread::get_id());
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    bool JobSystem::isPinnedThread() const {
+
+        return m_pinnedThread.load() == std::this_thread::get_id();
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    std::size_t JobSystem::executePinned() {
+
+        if(!isPinnedThread()) {
+            throw std::logic_error(
+                ErrorMessage("Pinned jobs can only be executed by the pinned thread.", 0).str());
+        }
+
+        if(m_pinnedCount.load() == 0) return 0;
+
+        // Pinned jobs may wait themselves and re-enter, so each call works on its own batch.
+        std::vector<Job> batch;
+        {
+            std::lock_guard<std::mutex> lock(m_pinnedMutex);
+            batch.swap(m_pinned);
+            m_pinnedCount.store(0);
+        }
+
+        for(std::size_t i = 0; i < batch.size(); ++i) execute(batch[i]);
+        return batch.size();
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    void JobSystem::wait(const JobCounter& counter) {
+
+        PIKO_PROFILE_ZONE("JobSystem::wait");
+
+        helpUntil(counter);
+
+        // Only the error of this counter is rethrown, errors of other groups wait for theirs.
+        if(!counter.m_hasError.exchange(false, std::memory_order_acquire)) return;
+
+        std::exception_ptr error;
+        error.swap(counter.m_error);
+        std::rethrow_exception(error);
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    std::size_t JobSystem::getWorkerCount() const {
+
+        return m_workers.size() - 1;
+    }
+
+
+
+    /*===================================================================*
+     * PRIVATE MEMBERS                                                   *
+     *===================================================================*/
+
+    void JobSystem::work(std::size_t index) {
+
+        PIKO_PROFILE_THREAD("Job worker");
+
+        t_state.system = this;
+        t_state.worker = index;
+        t_state.victim = index;
+
+        Job job;
+        unsigned int idle = 0;
+
+        while(!m_isStopping.load(std::memory_order_acquire)) {
+            if(findJob(job)) {
+                execute(job);
+                idle = 0;
+                continue;
+            }
+
+            if(++idle < SPIN_COUNT) {
+                std::this_thread::yield();
+                continue;
+            }
+
+            // Announce the sleep before checking for jobs, run() checks for sleepers after
+            // queueing, so one of both always notices the other.
+            std::unique_lock<std::mutex> lock(m_sleepMutex);
+            m_sleeping.fetch_add(1);
+            m_wakeCondition.wait(lock, [this]() {
+                return m_queued.load() > 0 || m_isStopping.load();
+            });
+            m_sleeping.fetch_sub(1);
+            idle = 0;
+        }
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    bool JobSystem::findJob(Job& job) {
+
+        Worker* self = getThreadWorker();
+        Worker::Slot* slot = NULL;
+
+        if(!self || !self->deque.pop(slot)) {
+            slot = NULL;
+            if(m_queued.load(std::memory_order_relaxed) <= 0) return false;
+
+            if(m_sharedCount.load(std::memory_order_relaxed) > 0) {
+                std::lock_guard<std::mutex> lock(m_sharedMutex);
+
+                if(!m_shared.empty()) {
+                    job = m_shared.front();
+                    m_shared.pop_front();
+                    m_sharedCount.fetch_sub(1);
+                    m_queued.fetch_sub(1);
+                    return true;
+                }
+            }
+
+            // Start at a different victim each time, so thieves spread over the deques.
+            const std::size_t count = m_workers.size();
+            const std::size_t start = ++t_state.victim;
+
+            for(std::size_t i = 0; i < count && !slot; ++i) {
+                Worker* victim = m_workers[(start + i) % count].get();
+                if(victim != self && !victim->deque.steal(slot)) slot = NULL;
+            }
+
+            if(!slot) return false;
+        }
+
+        job = slot->job;
+        slot->isQueued.store(false, std::memory_order_release);
+        m_queued.fetch_sub(1);
+        return true;
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    void JobSystem::helpUntil(const JobCounter& counter) {
+
+        const bool isPinned = isPinnedThread();
+
+        while(!counter.isDone()) {
+            if(isPinned && executePinned() > 0) continue;
+
+            Job job;
+            if(findJob(job)) execute(job);
+            else std::this_thread::yield();
+        }
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    void JobSystem::execute(const Job& job) {
+
+        if(job.dependency) helpUntil(*job.dependency);
+
+        try {
+            job.function(job.data, job.begin, job.end);
+        }
+        catch(...) {
+            // The first failing job of the counter stores its error, the decrement below
+            // publishes it to wait().
+            if(!job.counter->m_hasError.exchange(true, std::memory_order_relaxed)) {
+                job.counter->m_error = std::current_exception();
+            }
+        }
+
+        job.counter->m_pending.fetch_sub(1, std::memory_order_acq_rel);
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    JobSystem::Worker* JobSystem::getThreadWorker() const {
+
+        return t_state.system == this ? m_workers[t_state.worker].get() : NULL;
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    void JobSystem::wakeWorker() {
+
+        if(m_sleeping.load() == 0) return;
+
+        std::lock_guard<std::mutex> lock(m_sleepMutex);
+        m_wakeCondition.notify_one();
+    }
+
+} /* Namespace Piko */
\ No newline at end of file
@@ -0,0 +1,205 @@
+/**
+ * @file        LinearArena.cpp
+ * @author      Robert Koch
+ * @version     1.0
+ *
+ * Implementation of the LinearArena and ScratchScope classes.
+ */
+#include "../include/LinearArena.h"
+#include "../include/util/SIMD.h"
+
+#include <algorithm>
+
+
+namespace Piko {
+
+    namespace {
+
+        /** Capacity of the first block of a thread scratch arena. */
+        const std::size_t SCRATCH_CAPACITY = 256 * 1024;
+
+    } /* Anonymous namespace */
+
+
+
+    /*===================================================================*
+     * STATIC MEMBERS                                                    *
+     *===================================================================*/
+
+    const std::size_t LinearArena::DEFAULT_ALIGNMENT;
+    const std::size_t LinearArena::DEFAULT_CAPACITY;
+
+
+
+    /*===================================================================*
+     * PUBLIC MEMBERS                                                    *
+     *===================================================================*/
+
+    LinearArena::LinearArena(std::size_t capacity)
+      :
+      m_block(0),
+      m_offset(0),
+      m_used(0),
+      m_peak(0),
+      m_capacity(std::max(capacity, (std::size_t)SIMD_ALIGNMENT)) {
+
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    LinearArena::~LinearArena() {
+
+        releaseBlocks();
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    LinearArena::Marker LinearArena::getMarker() const {
+
+        Marker marker = { m_block, m_offset, m_used };
+        return marker;
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    void LinearArena::rewind(const Marker& marker) {
+
+        // Blocks after the marker stay allocated for the following allocations.
+        m_block = marker.block;
+        m_offset = marker.offset;
+        m_used = marker.used;
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    void LinearArena::reset() {
+
+        // A single block large enough for the peak avoids chaining in the next frames.
+        if(m_blocks.size() > 1) {
+            const std::size_t capacity = getCapacity();
+            releaseBlocks();
+
+            Block block = { static_cast<char*>(alignedAlloc(capacity)), capacity };
+            m_blocks.push_back(block);
+        }
+
+        m_block = 0;
+        m_offset = 0;
+        m_used = 0;
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    std::size_t LinearArena::getUsed() const {
+
+        return m_used;
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    std::size_t LinearArena::getPeakUsed() const {
+
+        return m_peak;
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    std::size_t LinearArena::getCapacity() const {
+
+        std::size_t capacity = 0;
+        for(std::size_t i = 0; i < m_blocks.size(); ++i) capacity += m_blocks[i].size;
+        return capacity;
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    LinearArena& LinearArena::getThreadScratch() {
+
+        static thread_local LinearArena scratch(SCRATCH_CAPACITY);
+        return scratch;
+    }
+
+
+
+    /*===================================================================*
+     * PRIVATE MEMBERS                                                   *
+     *===================================================================*/
+
+    void LinearArena::nextBlock(std::size_t bytes) {
+
+        if(m_blocks.empty()) {
+            const std::size_t size = std::max(m_capacity, bytes);
+            Block block = { static_cast<char*>(alignedAlloc(size)), size };
+            m_blocks.push_back(block);
+            m_block = 0;
+            m_offset = 0;
+            return;
+        }
+
+        // The rest of the current block is lost, count it as used so rewinding stays exact.
+        m_used += m_blocks[m_block].size - m_offset;
+
+        // Reuse blocks left behind by rewind() if they are large enough, skipped ones are lost
+        // as a whole.
+        while(m_block + 1 < m_blocks.size()) {
+            ++m_block;
+            m_offset = 0;
+            if(m_blocks[m_block].size >= bytes) return;
+            m_used += m_blocks[m_block].size;
+        }
+
+        const std::size_t size = std::max(2 * m_blocks.back().size, bytes);
+        Block block = { static_cast<char*>(alignedAlloc(size)), size };
+        m_blocks.push_back(block);
+        m_block = m_blocks.size() - 1;
+        m_offset = 0;
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    void LinearArena::releaseBlocks() {
+
+        for(std::size_t i = 0; i < m_blocks.size(); ++i) alignedFree(m_blocks[i].data);
+        m_blocks.clear();
+    }
+
+
+
+    /*===================================================================*
+     * SCRATCH SCOPE                                                     *
+     *===================================================================*/
+
+    ScratchScope::ScratchScope()
+      :
+      m_arena(LinearArena::getThreadScratch()),
+      m_marker(m_arena.getMarker()) {
+
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    ScratchScope::~ScratchScope() {
+
+        m_arena.rewind(m_marker);
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    LinearArena& ScratchScope::getArena() const {
+
+        return m_arena;
+    }
+
+
+} /* Namespace Piko */
\ No newline at end of file
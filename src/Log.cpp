@@ -0,0 +1,411 @@
+/**
+ * @file        Log.cpp
+ * @author      Robert Koch
+ * @version     1.0
+ *
+ * Implementation of the Log class.
+ */
+#include "../include/Log.h"
+#include "../include/util/SPSCRing.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+namespace Piko {
+
+    namespace {
+
+        typedef std::chrono::steady_clock Clock;
+
+        /** Interval in which the writer drains the buffers when nobody asks for a flush. */
+        const std::chrono::milliseconds WRITE_INTERVAL(2);
+
+        /** Run time threshold, same as the compile time threshold by default. */
+        std::atomic<std::uint8_t> s_level(PIKO_LOG_LEVEL);
+
+        /** Set once the writer is shut down, later messages are dropped. */
+        std::atomic<bool> s_isShutDown(false);
+
+        const char* levelName(LogLevel level) {
+
+            switch(level) {
+                case LogLevel::TRACE:   return "TRACE  ";
+                case LogLevel::DEBUG:   return "DEBUG  ";
+                case LogLevel::INFO:    return "INFO   ";
+                case LogLevel::WARNING: return "WARNING";
+                case LogLevel::SEVERE:  return "SEVERE ";
+                default:                return "       ";
+            }
+        }
+
+        /**
+         * Record buffer of one logging thread. The logging thread is the only producer, the writer
+         * the only consumer. The buffer outlives its thread until the writer has drained it.
+         */
+        struct ThreadBuffer {
+
+            explicit ThreadBuffer(std::uint32_t index)
+              :
+              ring(Log::BUFFER_CAPACITY),
+              index(index),
+              isOrphaned(false) {
+
+            }
+
+            SPSCRing<LogRecord> ring;
+            std::uint32_t index;
+            std::atomic<bool> isOrphaned;
+        };
+
+        /**
+         * Thread local owner of the buffer, marks the buffer as orphaned when the thread exits.
+         */
+        struct ThreadHandle {
+
+            ~ThreadHandle() {
+                if(buffer) buffer->isOrphaned.store(true, std::memory_order_release);
+            }
+
+            std::shared_ptr<ThreadBuffer> buffer;
+        };
+
+        /**
+         * Background writer draining the buffers of all logging threads.
+         */
+        class Writer final {
+
+            public:
+
+                static Writer& instance() {
+                    static Writer writer;
+                    return writer;
+                }
+
+                ~Writer() {
+
+                    {
+                        std::lock_guard<std::mutex> lock(m_mutex);
+                        m_isStopping = true;
+                    }
+
+                    m_condition.notify_all();
+                    m_thread.join();
+                    s_isShutDown.store(true, std::memory_order_release);
+                }
+
+                std::shared_ptr<ThreadBuffer> registerThread() {
+
+                    std::lock_guard<std::mutex> lock(m_mutex);
+
+                    std::shared_ptr<ThreadBuffer> buffer(new ThreadBuffer(m_nextThread++));
+                    m_buffers.push_back(buffer);
+                    return buffer;
+                }
+
+                void countDropped() {
+
+                    m_dropped.fetch_add(1, std::memory_order_relaxed);
+                }
+
+                std::size_t getDroppedCount() const {
+
+                    return m_dropped.load(std::memory_order_relaxed);
+                }
+
+                void setOutput(std::ostream& stream) {
+
+                    flush();
+
+                    std::lock_guard<std::mutex> lock(m_mutex);
+                    m_output = &stream;
+                }
+
+                void flush() {
+
+                    std::unique_lock<std::mutex> lock(m_mutex);
+
+                    const std::uint64_t ticket = ++m_flushRequested;
+                    m_condition.notify_all();
+                    m_flushed.wait(lock, [this, ticket] { return m_flushCompleted >= ticket; });
+                }
+
+
+            private:
+
+                std::mutex m_mutex;
+                std::condition_variable m_condition;        /**< Wakes the writer. */
+                std::condition_variable m_flushed;          /**< Wakes flushing threads. */
+
+                std::vector<std::shared_ptr<ThreadBuffer>> m_buffers;
+                std::uint32_t m_nextThread;
+
+                std::ostream* m_output;
+                std::uint64_t m_start;                      /**< Timestamp of time zero. */
+
+                std::uint64_t m_flushRequested;
+                std::uint64_t m_flushCompleted;
+                bool m_isStopping;
+
+                std::atomic<std::size_t> m_dropped;
+                std::size_t m_reportedDropped;
+
+                std::thread m_thread;
+
+
+                Writer()
+                  :
+                  m_nextThread(0),
+                  m_output(&std::cout),
+                  m_start(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                      Clock::now().time_since_epoch()).count()),
+                  m_flushRequested(0),
+                  m_flushCompleted(0),
+                  m_isStopping(false),
+                  m_dropped(0),
+                  m_reportedDropped(0) {
+
+                    m_thread = std::thread(&Writer::run, this);
+                }
+
+                void run() {
+
+                    std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+                    std::vector<LogRecord> records;
+                    std::string line;
+
+                    records.resize(Log::BUFFER_CAPACITY);
+
+                    std::unique_lock<std::mutex> lock(m_mutex);
+
+                    for(;;) {
+                        m_condition.wait_for(lock, WRITE_INTERVAL, [this] {
+                            return m_isStopping || m_flushRequested != m_flushCompleted;
+                        });
+
+                        // Everything pushed before these values were read gets drained below.
+                        const std::uint64_t ticket = m_flushRequested;
+                        const bool isStopping = m_isStopping;
+                        std::ostream& output = *m_output;
+                        buffers = m_buffers;
+
+                        lock.unlock();
+
+                        std::vector<bool> released(buffers.size(), false);
+                        std::size_t count = 0;
+
+                        for(std::size_t i = 0; i < buffers.size(); ++i) {
+                            ThreadBuffer& buffer = *buffers[i];
+                            const bool isOrphaned =
+                                buffer.isOrphaned.load(std::memory_order_acquire);
+
+                            for(;;) {
+                                if(records.size() - count < Log::BUFFER_CAPACITY) {
+                                    records.resize(records.size() * 2);
+                                }
+
+                                const std::size_t taken =
+                                    buffer.ring.pop(&records[count], Log::BUFFER_CAPACITY);
+                                count += taken;
+                                if(taken < Log::BUFFER_CAPACITY) break;
+                            }
+
+                            released[i] = isOrphaned;
+                        }
+
+                        // Each buffer is in order already, interleave the threads by time.
+                        std::stable_sort(records.begin(), records.begin() + count,
+                            [](const LogRecord& a, const LogRecord& b) {
+                                return a.timestamp < b.timestamp;
+                            });
+
+                        for(std::size_t i = 0; i < count; ++i) {
+                            format(records[i], line);
+                            output.write(line.data(), line.size());
+                        }
+
+                        const std::size_t dropped = m_dropped.load(std::memory_order_relaxed);
+                        if(dropped != m_reportedDropped) {
+                            output << "[Log] " << dropped - m_reportedDropped
+                                   << " messages dropped, buffer full.\n";
+                            m_reportedDropped = dropped;
+                        }
+
+                        if(count || ticket != m_flushCompleted) output.flush();
+
+                        lock.lock();
+
+                        // Buffers of exited threads are released once they are empty.
+                        for(std::size_t i = 0; i < buffers.size(); ++i) {
+                            if(!released[i]) continue;
+                            m_buffers.erase(std::find(m_buffers.begin(), m_buffers.end(),
+                                                      buffers[i]));
+                        }
+                        buffers.clear();
+
+                        if(ticket != m_flushCompleted) {
+                            m_flushCompleted = ticket;
+                            m_flushed.notify_all();
+                        }
+
+                        if(isStopping) break;
+                    }
+                }
+
+                void format(const LogRecord& record, std::string& line) const {
+
+                    char number[32];
+
+                    const double seconds = record.timestamp > m_start ?
+                        (record.timestamp - m_start) * 1e-9 : 0.0;
+
+                    std::snprintf(number, sizeof(number), "[%10.4f] ", seconds);
+                    line.assign(number);
+                    line.append(levelName(record.level));
+                    std::snprintf(number, sizeof(number), " T%u: ", (unsigned)record.thread);
+                    line.append(number);
+
+                    std::size_t argument = 0;
+
+                    for(const char* c = record.format; *c; ++c) {
+                        if(c[0] != '{' || c[1] != '}' || argument >= record.count) {
+                            line.push_back(*c);
+                            continue;
+                        }
+
+                        const LogRecord::Value& value = record.values[argument];
+
+                        switch(record.types[argument]) {
+                            case LogRecord::SIGNED:
+                                std::snprintf(number, sizeof(number), "%lld", (long long)value.i);
+                                line.append(number);
+                                break;
+                            case LogRecord::UNSIGNED:
+                                std::snprintf(number, sizeof(number), "%llu",
+                                              (unsigned long long)value.u);
+                                line.append(number);
+                                break;
+                            case LogRecord::FLOATING:
+                                std::snprintf(number, sizeof(number), "%g", value.d);
+                                line.append(number);
+                                break;
+                            case LogRecord::BOOLEAN:
+                                line.append(value.u ? "true" : "false");
+                                break;
+                            case LogRecord::CHARACTER:
+                                line.push_back((char)value.u);
+                                break;
+                            case LogRecord::POINTER:
+                                std::snprintf(number, sizeof(number), "%p", value.p);
+                                line.append(number);
+                                break;
+                            case LogRecord::STRING:
+                                line.append(record.text + value.s.offset, value.s.length);
+                                break;
+                        }
+
+                        ++argument;
+                        ++c;
+                    }
+
+                    line.push_back('\n');
+                }
+
+                Writer(const Writer& writer);
+
+                Writer& operator=(const Writer& writer);
+        };
+
+    } /* Anonymous namespace */
+
+
+
+    /*===================================================================*
+     * PUBLIC MEMBERS                                                    *
+     *===================================================================*/
+
+    void Log::setLevel(LogLevel level) {
+
+        s_level.store((std::uint8_t)level, std::memory_order_relaxed);
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    LogLevel Log::getLevel() {
+
+        return (LogLevel)s_level.load(std::memory_order_relaxed);
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    bool Log::isEnabled(LogLevel level) {
+
+        return (std::uint8_t)level >= PIKO_LOG_LEVEL && level != LogLevel::OFF &&
+               (std::uint8_t)level >= s_level.load(std::memory_order_relaxed);
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    void Log::setOutput(std::ostream& stream) {
+
+        Writer::instance().setOutput(stream);
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    void Log::flush() {
+
+        if(s_isShutDown.load(std::memory_order_acquire)) return;
+        Writer::instance().flush();
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    std::size_t Log::getDroppedCount() {
+
+        return Writer::instance().getDroppedCount();
+    }
+
+
+
+    /*===================================================================*
+     * PRIVATE MEMBERS                                                   *
+     *===================================================================*/
+
+    void Log::submit(LogRecord& record) {
+
+        if(s_isShutDown.load(std::memory_order_acquire)) return;
+
+        static thread_local ThreadHandle handle;
+
+        Writer& writer = Writer::instance();
+        if(!handle.buffer) handle.buffer = writer.registerThread();
+
+        record.thread = handle.buffer->index;
+        if(!handle.buffer->ring.push(record)) writer.countDropped();
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    std::uint64_t Log::now() {
+
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            Clock::now().time_since_epoch()).count();
+    }
+
+
+} /* Namespace Piko */
\ No newline at end of file
@@ -0,0 +1,180 @@
+/**
+ * @file        MappedFile.cpp
+ * @author      Robert Koch
+ * @version     1.0
+ *
+ * Implementation of the MappedFile class.
+ */
+#include "../include/MappedFile.h"
+#include "../include/ErrorMessage.h"
+
+#include <stdexcept>
+
+#if defined(_WIN32)
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+
+namespace Piko {
+
+    /*===================================================================*
+     * PUBLIC MEMBERS                                                    *
+     *===================================================================*/
+
+    MappedFile::MappedFile()
+      :
+      m_data(NULL),
+      m_size(0),
+      m_isOpen(false) {
+
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    MappedFile::MappedFile(const std::string& path)
+      :
+      m_data(NULL),
+      m_size(0),
+      m_isOpen(false) {
+
+        open(path);
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    MappedFile::~MappedFile() {
+
+        close();
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    void MappedFile::open(const std::string& path) {
+
+        close();
+
+#if defined(_WIN32)
+        HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL,
+                                  OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+        if(file == INVALID_HANDLE_VALUE) {
+            throw std::runtime_error(ErrorMessage("Could not open file for mapping.").str());
+        }
+
+        LARGE_INTEGER size;
+        if(!GetFileSizeEx(file, &size)) {
+            ErrorMessage error("Could not get file size.");
+            CloseHandle(file);
+            throw std::runtime_error(error.str());
+        }
+
+        const unsigned char* data = NULL;
+
+        // Empty files cannot be mapped, they are open without data.
+        if(size.QuadPart > 0) {
+            HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+            if(mapping) {
+                data = static_cast<const unsigned char*>(
+                    MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+            }
+
+            // The view keeps the mapping and the file alive.
+            ErrorMessage error("Could not map file.");
+            if(mapping) CloseHandle(mapping);
+            CloseHandle(file);
+            if(!data) throw std::runtime_error(error.str());
+        }
+        else {
+            CloseHandle(file);
+        }
+
+        m_size = (std::size_t)size.QuadPart;
+#else
+        const int file = ::open(path.c_str(), O_RDONLY);
+        if(file < 0) {
+            throw std::runtime_error(ErrorMessage("Could not open file for mapping.").str());
+        }
+
+        struct stat info;
+        if(fstat(file, &info) != 0) {
+            ErrorMessage error("Could not get file size.");
+            ::close(file);
+            throw std::runtime_error(error.str());
+        }
+
+        const unsigned char* data = NULL;
+
+        // Empty files cannot be mapped, they are open without data.
+        if(info.st_size > 0) {
+            void* view = mmap(NULL, (std::size_t)info.st_size, PROT_READ, MAP_PRIVATE, file, 0);
+
+            // The mapping keeps the file alive.
+            ErrorMessage error("Could not map file.");
+            ::close(file);
+            if(view == MAP_FAILED) throw std::runtime_error(error.str());
+
+            // Files are usually read completely, e.g. for an upload.
+            madvise(view, (std::size_t)info.st_size, MADV_WILLNEED);
+            data = static_cast<const unsigned char*>(view);
+        }
+        else {
+            ::close(file);
+        }
+
+        m_size = (std::size_t)info.st_size;
+#endif
+
+        m_data = data;
+        m_isOpen = true;
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    void MappedFile::close() {
+
+        if(m_data) {
+#if defined(_WIN32)
+            UnmapViewOfFile(m_data);
+#else
+            munmap(const_cast<unsigned char*>(m_data), m_size);
+#endif
+        }
+
+        m_data = NULL;
+        m_size = 0;
+        m_isOpen = false;
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    bool MappedFile::isOpen() const {
+
+        return m_isOpen;
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    const unsigned char* MappedFile::data() const {
+
+        return m_data;
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    std::size_t MappedFile::size() const {
+
+        return m_size;
+    }
+
+} /* Namespace Piko */
\ No newline at end of file
@@ -0,0 +1,397 @@
+/**
+ * @file        MeshFile.cpp
+ * @author      Robert Koch
+ * @version     1.0
+ *
+ * Implementation of the MeshFile class.
+ */
+#include "../include/MeshFile.h"
+#include "../include/ErrorMessage.h"
+#include "../include/Profiler.h"
+
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+
+namespace Piko {
+
+    namespace {
+
+        /** Value of MeshFileHeader::byteOrder, reads differently with another byte order. */
+        const std::uint32_t BYTE_ORDER_MARK = 0x01020304;
+
+        /** All flags of MeshAttribute. */
+        const std::uint32_t ALL_ATTRIBUTES = MESH_POSITION | MESH_NORMAL | MESH_TEXCOORD;
+
+        /**
+         * Function to check if a stream lies inside the file.
+         *
+         * @param offset Offset of the stream.
+         * @param bytes Size of the stream.
+         * @param fileSize Size of the file.
+         * @return True if the stream is aligned and inside the file.
+         */
+        bool isInside(std::uint64_t offset, std::uint64_t bytes, std::uint64_t fileSize) {
+
+            return offset % MESH_FILE_ALIGNMENT == 0 && offset >= sizeof(MeshFileHeader) &&
+                   offset <= fileSize && bytes <= fileSize - offset;
+        }
+
+        /**
+         * Function to round an offset up to the stream alignment.
+         */
+        std::uint64_t align(std::uint64_t offset) {
+
+            return (offset + MESH_FILE_ALIGNMENT - 1) / MESH_FILE_ALIGNMENT * MESH_FILE_ALIGNMENT;
+        }
+
+        /**
+         * Function to write zero bytes up to an offset.
+         */
+        void pad(std::ofstream& file, std::uint64_t& position, std::uint64_t offset) {
+
+            static const char zeros[MESH_FILE_ALIGNMENT] = {};
+
+            file.write(zeros, (std::streamsize)(offset - position));
+            position = offset;
+        }
+
+    } /* Anonymous namespace */
+
+
+
+    /*===================================================================*
+     * STATIC MEMBERS                                                    *
+     *===================================================================*/
+
+    void MeshFile::write(const std::string& path, const MeshData& mesh) {
+
+        const std::size_t count = mesh.positions.size();
+
+        if(!mesh.normals.empty() && mesh.normals.size() != count) {
+            throw std::invalid_argument(
+                ErrorMessage("Mesh needs one normal per position.", 0).str());
+        }
+        if(!mesh.texcoords.empty() && mesh.texcoords.size() != 2 * count) {
+            throw std::invalid_argument(
+                ErrorMessage("Mesh needs one texture coordinate per position.", 0).str());
+        }
+        if(count > 0xFFFFFFFFu || mesh.indices.size() > 0xFFFFFFFFu) {
+            throw std::invalid_argument(ErrorMessage("Mesh is too large.", 0).str());
+        }
+        for(std::size_t i = 0; i < mesh.indices.size(); ++i) {
+            if(mesh.indices[i] >= count) {
+                throw std::invalid_argument(ErrorMessage("Mesh index out of range.", 0).str());
+            }
+        }
+
+        MeshFileHeader header;
+        std::memset(&header, 0, sizeof(header));
+        std::memcpy(header.magic, MESH_FILE_MAGIC, sizeof(header.magic));
+        header.version = MESH_FILE_VERSION;
+        header.byteOrder = BYTE_ORDER_MARK;
+        header.attributes = MESH_POSITION;
+        if(!mesh.normals.empty()) header.attributes |= MESH_NORMAL;
+        if(!mesh.texcoords.empty()) header.attributes |= MESH_TEXCOORD;
+        header.vertexStride = (std::uint32_t)getStride(header.attributes);
+        header.vertexCount = (std::uint32_t)count;
+        header.indexCount = (std::uint32_t)mesh.indices.size();
+        header.indexSize = count <= 0x10000 ? 2 : 4;
+        header.vertexOffset = align(sizeof(MeshFileHeader));
+        header.indexOffset = align(header.vertexOffset +
+                                   (std::uint64_t)count * header.vertexStride);
+
+        AABB<float> bounds;
+        for(std::size_t i = 0; i < count; ++i) bounds.expand(mesh.positions[i]);
+        if(count > 0) {
+            const Vector3D<float>& min = bounds.getMin();
+            const Vector3D<float>& max = bounds.getMax();
+            header.boundsMin[0] = min.x(); header.boundsMin[1] = min.y();
+            header.boundsMin[2] = min.z();
+            header.boundsMax[0] = max.x(); header.boundsMax[1] = max.y();
+            header.boundsMax[2] = max.z();
+        }
+
+        std::vector<float> vertices;
+        vertices.reserve(count * header.vertexStride / sizeof(float));
+        for(std::size_t i = 0; i < count; ++i) {
+            const Vector3D<float>& p = mesh.positions[i];
+            vertices.push_back(p.x());
+            vertices.push_back(p.y());
+            vertices.push_back(p.z());
+
+            if(header.attributes & MESH_NORMAL) {
+                const Vector3D<float>& n = mesh.normals[i];
+                vertices.push_back(n.x());
+                vertices.push_back(n.y());
+                vertices.push_back(n.z());
+            }
+
+            if(header.attributes & MESH_TEXCOORD) {
+                vertices.push_back(mesh.texcoords[2 * i]);
+                vertices.push_back(mesh.texcoords[2 * i + 1]);
+            }
+        }
+
+        std::ofstream file(path.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+        std::uint64_t position = sizeof(MeshFileHeader);
+
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        pad(file, position, header.vertexOffset);
+
+        if(!vertices.empty()) {
+            file.write(reinterpret_cast<const char*>(&vertices[0]),
+                       (std::streamsize)(vertices.size() * sizeof(float)));
+        }
+        position += (std::uint64_t)vertices.size() * sizeof(float);
+        pad(file, position, header.indexOffset);
+
+        if(header.indexSize == 2) {
+            std::vector<std::uint16_t> indices(mesh.indices.begin(), mesh.indices.end());
+            if(!indices.empty()) {
+                file.write(reinterpret_cast<const char*>(&indices[0]),
+                           (std::streamsize)(indices.size() * sizeof(std::uint16_t)));
+            }
+        }
+        else if(!mesh.indices.empty()) {
+            file.write(reinterpret_cast<const char*>(&mesh.indices[0]),
+                       (std::streamsize)(mesh.indices.size() * sizeof(std::uint32_t)));
+        }
+
+        if(!file.flush()) {
+            throw std::runtime_error(ErrorMessage("Could not write mesh file.").str());
+        }
+    }
+
+
+
+    /*===================================================================*
+     * PUBLIC MEMBERS                                                    *
+     *===================================================================*/
+
+    MeshFile::MeshFile() {
+
+        std::memset(&m_header, 0, sizeof(m_header));
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    MeshFile::MeshFile(const std::string& path) {
+
+        std::memset(&m_header, 0, sizeof(m_header));
+        open(path);
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    void MeshFile::open(const std::string& path) {
+
+        PIKO_PROFILE_ZONE("MeshFile::open");
+
+        close();
+        m_file.open(path);
+
+        const std::uint64_t size = m_file.size();
+        const char* error = NULL;
+
+        if(size < sizeof(MeshFileHeader)) {
+            error = "Mesh file is truncated.";
+        }
+        else {
+            // Copied, the mapping is page aligned but the header is read field by field.
+            std::memcpy(&m_header, m_file.data(), sizeof(MeshFileHeader));
+            const MeshFileHeader& h = m_header;
+
+            if(std::memcmp(h.magic, MESH_FILE_MAGIC, sizeof(h.magic)) != 0) {
+                error = "File is no mesh file.";
+            }
+            else if(h.byteOrder != BYTE_ORDER_MARK) {
+                error = "Mesh file was written with another byte order.";
+            }
+            else if(h.version != MESH_FILE_VERSION) {
+                error = "Mesh file version is not supported.";
+            }
+            else if((h.attributes & ~ALL_ATTRIBUTES) != 0 || !(h.attributes & MESH_POSITION) ||
+                    h.vertexStride != getStride(h.attributes) ||
+                    (h.indexSize != 2 && h.indexSize != 4)) {
+                error = "Mesh file has an invalid vertex or index format.";
+            }
+            else if(!isInside(h.vertexOffset, (std::uint64_t)h.vertexCount * h.vertexStride,
+                              size) ||
+                    !isInside(h.indexOffset, (std::uint64_t)h.indexCount * h.indexSize, size)) {
+                error = "Mesh file is truncated.";
+            }
+        }
+
+        if(error) {
+            close();
+            throw std::runtime_error(ErrorMessage(error, 0).str());
+        }
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    void MeshFile::close() {
+
+        m_file.close();
+        std::memset(&m_header, 0, sizeof(m_header));
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    bool MeshFile::isOpen() const {
+
+        return m_file.isOpen();
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    const MeshFileHeader& MeshFile::getHeader() const {
+
+        return m_header;
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    bool MeshFile::hasAttribute(MeshAttribute attribute) const {
+
+        return (m_header.attributes & attribute) != 0;
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    std::size_t MeshFile::getAttributeOffset(MeshAttribute attribute) const {
+
+        // Attributes are interleaved in the order of their flags.
+        return getStride(m_header.attributes & ((std::uint32_t)attribute - 1));
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    const void* MeshFile::getVertexData() const {
+
+        return m_file.data() ? m_file.data() + m_header.vertexOffset : NULL;
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    std::size_t MeshFile::getVertexCount() const {
+
+        return m_header.vertexCount;
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    std::size_t MeshFile::getVertexStride() const {
+
+        return m_header.vertexStride;
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    const void* MeshFile::getIndexData() const {
+
+        return m_file.data() ? m_file.data() + m_header.indexOffset : NULL;
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    std::size_t MeshFile::getIndexCount() const {
+
+        return m_header.indexCount;
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    std::size_t MeshFile::getIndexSize() const {
+
+        return m_header.indexSize;
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    GLenum MeshFile::getIndexType() const {
+
+        return m_header.indexSize == 2 ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    AABB<float> MeshFile::getBounds() const {
+
+        if(m_header.vertexCount == 0) return AABB<float>();
+
+        const float* min = m_header.boundsMin;
+        const float* max = m_header.boundsMax;
+        return AABB<float>(Vector3D<float>(min[0], min[1], min[2]),
+                           Vector3D<float>(max[0], max[1], max[2]));
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    void MeshFile::upload(const GLExtensions& gl, GLuint& vertexBuffer, GLuint& indexBuffer,
+                          GLenum usage) const {
+
+        PIKO_PROFILE_ZONE("MeshFile::upload");
+
+        if(!gl.hasBufferObjects) {
+            throw std::runtime_error(
+                ErrorMessage("Mesh upload requires buffer objects.", 0).str());
+        }
+
+        vertexBuffer = 0;
+        indexBuffer = 0;
+
+        // The driver reads straight from the mapping, pages are faulted in as it copies.
+        if(m_header.vertexCount > 0) {
+            gl.glGenBuffers(1, &vertexBuffer);
+            gl.glBindBuffer(GL_ARRAY_BUFFER, vertexBuffer);
+            gl.glBufferData(GL_ARRAY_BUFFER,
+                            (GLsizeiptr)m_header.vertexCount * m_header.vertexStride,
+                            getVertexData(), usage);
+            gl.glBindBuffer(GL_ARRAY_BUFFER, 0);
+        }
+
+        if(m_header.indexCount > 0) {
+            gl.glGenBuffers(1, &indexBuffer);
+            gl.glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, indexBuffer);
+            gl.glBufferData(GL_ELEMENT_ARRAY_BUFFER,
+                            (GLsizeiptr)m_header.indexCount * m_header.indexSize,
+                            getIndexData(), usage);
+            gl.glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+        }
+    }
+
+
+
+    /*===================================================================*
+     * PRIVATE MEMBERS                                                   *
+     *===================================================================*/
+
+    std::size_t MeshFile::getStride(std::uint32_t attributes) {
+
+        std::size_t stride = 0;
+        if(attributes & MESH_POSITION) stride += 3 * sizeof(float);
+        if(attributes & MESH_NORMAL) stride += 3 * sizeof(float);
+        if(attributes & MESH_TEXCOORD) stride += 2 * sizeof(float);
+        return stride;
+    }
+
+} /* Namespace Piko */
\ No newline at end of file
@@ -0,0 +1,349 @@
+/**
+ * @file        ParticleSystem.cpp
+ * @author      Robert Koch
+ * @version     1.0
+ *
+ * Implementation of the ParticleSystem class.
+ */
+#include "../include/ParticleSystem.h"
+#include "../include/ErrorMessage.h"
+#include "../include/Profiler.h"
+
+#include <cmath>
+#include <stdexcept>
+
+
+namespace Piko {
+
+    namespace {
+
+        /**
+         * Function to integrate streams of particles with semi-implicit Euler steps.
+         *
+         * @param px, py, pz Position streams.
+         * @param vx, vy, vz Velocity streams.
+         * @param life Lifetime stream.
+         * @param n Number of particles.
+         * @param dt Time step.
+         * @param g Gravity.
+         * @param damping Factor the velocities are multiplied with.
+         */
+        template<typename T>
+        inline void integrateStreams(T* px, T* py, T* pz, T* vx, T* vy, T* vz, T* life,
+                                     std::size_t n, T dt, const Vector3D<T>& g, T damping) {
+
+            const T gx = g.x() * dt;
+            const T gy = g.y() * dt;
+            const T gz = g.z() * dt;
+
+            for(std::size_t i = 0; i < n; ++i) {
+                vx[i] = (vx[i] + gx) * damping;
+                vy[i] = (vy[i] + gy) * damping;
+                vz[i] = (vz[i] + gz) * damping;
+                px[i] += vx[i] * dt;
+                py[i] += vy[i] * dt;
+                pz[i] += vz[i] * dt;
+                life[i] -= dt;
+            }
+        }
+
+#if defined(PIKO_SIMD_AVX) || defined(PIKO_SIMD_SSE)
+
+        inline void integrateStreams(float* px, float* py, float* pz,
+                                     float* vx, float* vy, float* vz, float* life,
+                                     std::size_t n, float dt, const Vector3D<float>& g,
+                                     float damping) {
+
+            const simd::Pack step = simd::set1(dt);
+            const simd::Pack gx = simd::set1(g.x() * dt);
+            const simd::Pack gy = simd::set1(g.y() * dt);
+            const simd::Pack gz = simd::set1(g.z() * dt);
+            const simd::Pack d = simd::set1(damping);
+
+            const std::size_t packed = n - (n % simd::PACK_SIZE);
+            for(std::size_t i = 0; i < packed; i += simd::PACK_SIZE) {
+                const simd::Pack x = simd::mul(simd::add(simd::load(vx + i), gx), d);
+                const simd::Pack y = simd::mul(simd::add(simd::load(vy + i), gy), d);
+                const simd::Pack z = simd::mul(simd::add(simd::load(vz + i), gz), d);
+                simd::store(vx + i, x);
+                simd::store(vy + i, y);
+                simd::store(vz + i, z);
+                simd::store(px + i, simd::add(simd::load(px + i), simd::mul(x, step)));
+                simd::store(py + i, simd::add(simd::load(py + i), simd::mul(y, step)));
+                simd::store(pz + i, simd::add(simd::load(pz + i), simd::mul(z, step)));
+                simd::store(life + i, simd::sub(simd::load(life + i), step));
+            }
+            integrateStreams<float>(px + packed, py + packed, pz + packed, vx + packed,
+                                    vy + packed, vz + packed, life + packed, n - packed, dt, g,
+                                    damping);
+        }
+
+#endif
+
+    } /* Anonymous namespace */
+
+
+
+    /*===================================================================*
+     * PUBLIC MEMBERS                                                    *
+     *===================================================================*/
+
+    ParticleSystem::ParticleSystem(std::size_t capacity)
+      :
+      m_lifetimes(capacity),
+      m_count(0),
+      m_gravity(0.0f, 0.0f, 0.0f),
+      m_drag(0.0f),
+      m_gl(NULL),
+      m_buffer(0) {
+
+        m_positions.resize(capacity);
+        m_velocities.resize(capacity);
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    ParticleSystem::~ParticleSystem() {
+
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    void ParticleSystem::update(float dt) {
+
+        PIKO_PROFILE_ZONE("ParticleSystem::update");
+
+        integrate(0, m_count, dt, std::exp(-m_drag * dt));
+        removeDead();
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    void ParticleSystem::update(JobSystem& jobs, float dt, std::size_t grain) {
+
+        PIKO_PROFILE_ZONE("ParticleSystem::update");
+
+        const float damping = std::exp(-m_drag * dt);
+
+        detail::parallelStreams(jobs, m_count, grain, [&](std::size_t i, std::size_t n) {
+            integrate(i, n, dt, damping);
+        });
+        removeDead();
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    void ParticleSystem::clear() {
+
+        m_count = 0;
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    void ParticleSystem::setGravity(const Vector3D<float>& gravity) {
+
+        m_gravity = gravity;
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    void ParticleSystem::setDrag(float drag) {
+
+        m_drag = drag;
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    const Vector3D<float>& ParticleSystem::getGravity() const {
+
+        return m_gravity;
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    float ParticleSystem::getDrag() const {
+
+        return m_drag;
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    const Vector3DArray<float>& ParticleSystem::getPositions() const {
+
+        return m_positions;
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    const Vector3DArray<float>& ParticleSystem::getVelocities() const {
+
+        return m_velocities;
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    const float* ParticleSystem::getLifetimes() const {
+
+        return m_lifetimes.data();
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    void ParticleSystem::writeVertices(ParticleVertex* out) const {
+
+        const float* x = m_positions.x();
+        const float* y = m_positions.y();
+        const float* z = m_positions.z();
+        const float* life = m_lifetimes.data();
+
+        for(std::size_t i = 0; i < m_count; ++i) {
+            out[i].x = x[i];
+            out[i].y = y[i];
+            out[i].z = z[i];
+            out[i].lifetime = life[i];
+        }
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    void ParticleSystem::initBuffer(const GLExtensions& gl) {
+
+        releaseBuffer();
+
+        if(!gl.hasBufferObjects) {
+            throw std::runtime_error(
+                ErrorMessage("Particle buffers require buffer objects.", 0).str());
+        }
+
+        m_gl = &gl;
+        m_gl->glGenBuffers(1, &m_buffer);
+        m_gl->glBindBuffer(GL_ARRAY_BUFFER, m_buffer);
+        m_gl->glBufferData(GL_ARRAY_BUFFER,
+                           (GLsizeiptr)(getCapacity() * sizeof(ParticleVertex)), NULL,
+                           GL_STREAM_DRAW);
+        m_gl->glBindBuffer(GL_ARRAY_BUFFER, 0);
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    void ParticleSystem::releaseBuffer() {
+
+        if(m_gl && m_buffer) m_gl->glDeleteBuffers(1, &m_buffer);
+
+        m_gl = NULL;
+        m_buffer = 0;
+        std::vector<ParticleVertex>().swap(m_staging);
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    std::size_t ParticleSystem::stream() {
+
+        PIKO_PROFILE_ZONE("ParticleSystem::stream");
+
+        if(!m_gl) return 0;
+
+        const GLsizeiptr bytes = (GLsizeiptr)(m_count * sizeof(ParticleVertex));
+
+        // Respecifying the storage detaches it from draws still in flight.
+        m_gl->glBindBuffer(GL_ARRAY_BUFFER, m_buffer);
+        m_gl->glBufferData(GL_ARRAY_BUFFER,
+                           (GLsizeiptr)(getCapacity() * sizeof(ParticleVertex)), NULL,
+                           GL_STREAM_DRAW);
+
+        bool isWritten = m_count == 0;
+
+        if(!isWritten && m_gl->hasMapBufferRange) {
+            void* mapped = m_gl->glMapBufferRange(GL_ARRAY_BUFFER, 0, bytes,
+                                                  GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+            if(mapped) {
+                writeVertices(static_cast<ParticleVertex*>(mapped));
+
+                // The contents are undefined if the mapping was lost, e.g. on a mode switch.
+                isWritten = m_gl->glUnmapBuffer(GL_ARRAY_BUFFER) == GL_TRUE;
+            }
+        }
+
+        if(!isWritten) {
+            m_staging.resize(m_count);
+            writeVertices(m_staging.data());
+            m_gl->glBufferSubData(GL_ARRAY_BUFFER, 0, bytes, m_staging.data());
+        }
+
+        m_gl->glBindBuffer(GL_ARRAY_BUFFER, 0);
+        return m_count;
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    GLuint ParticleSystem::getBuffer() const {
+
+        return m_buffer;
+    }
+
+
+
+    /*===================================================================*
+     * PRIVATE MEMBERS                                                   *
+     *===================================================================*/
+
+    void ParticleSystem::integrate(std::size_t begin, std::size_t count, float dt,
+                                   float damping) {
+
+        integrateStreams(m_positions.x() + begin, m_positions.y() + begin,
+                         m_positions.z() + begin, m_velocities.x() + begin,
+                         m_velocities.y() + begin, m_velocities.z() + begin,
+                         m_lifetimes.data() + begin, count, dt, m_gravity, damping);
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    void ParticleSystem::removeDead() {
+
+        PIKO_PROFILE_ZONE("ParticleSystem::removeDead");
+
+        float* px = m_positions.x();
+        float* py = m_positions.y();
+        float* pz = m_positions.z();
+        float* vx = m_velocities.x();
+        float* vy = m_velocities.y();
+        float* vz = m_velocities.z();
+        float* life = m_lifetimes.data();
+
+        // The last particle may be dead as well, so the slot is checked again after the move.
+        std::size_t i = 0;
+        while(i < m_count) {
+            if(life[i] > 0.0f) {
+                ++i;
+                continue;
+            }
+
+            const std::size_t last = --m_count;
+            px[i] = px[last];
+            py[i] = py[last];
+            pz[i] = pz[last];
+            vx[i] = vx[last];
+            vy[i] = vy[last];
+            vz[i] = vz[last];
+            life[i] = life[last];
+        }
+    }
+
+} /* Namespace Piko */
\ No newline at end of file
@@ -0,0 +1,350 @@
+/**
+ * @file        Profiler.cpp
+ * @author      Robert Koch
+ * @version     1.0
+ *
+ * Implementation of the Profiler class.
+ */
+#include "../include/Profiler.h"
+#include "../include/ErrorMessage.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+
+
+namespace Piko {
+
+    namespace {
+
+        typedef std::chrono::steady_clock Clock;
+
+        std::atomic<bool> s_isCapturing(false);         /**< Flag checked by every zone. */
+        std::atomic<std::uint32_t> s_capture(0);        /**< Number of the current capture. */
+        std::atomic<std::uint64_t> s_captureStart(0);   /**< Start of the current capture. */
+        std::atomic<std::size_t> s_dropped(0);          /**< Events beyond the thread limit. */
+
+        /**
+         * Fixed-size part of a thread buffer. Only the owning thread writes, the exporter reads
+         * the events published by count.
+         */
+        struct Block {
+
+            Block()
+              :
+              count(0),
+              next(NULL) {
+
+            }
+
+            ~Block() {
+                delete next.load(std::memory_order_relaxed);
+            }
+
+            ProfileEvent events[Profiler::BLOCK_EVENTS];
+            std::atomic<std::size_t> count;
+            std::atomic<Block*> next;
+        };
+
+        /**
+         * Events of one thread. Blocks are kept for the following captures once allocated.
+         */
+        struct ThreadBuffer {
+
+            explicit ThreadBuffer(std::uint32_t index)
+              :
+              tail(&head),
+              total(0),
+              index(index),
+              capture(~(std::uint32_t)0),
+              name(NULL),
+              isOrphaned(false) {
+
+            }
+
+            /**
+             * Function to discard the events of the previous capture. Owner only.
+             */
+            void reset(std::uint32_t number) {
+
+                Block* block = &head;
+                for(; block; block = block->next.load(std::memory_order_relaxed)) {
+                    block->count.store(0, std::memory_order_relaxed);
+                }
+
+                tail = &head;
+                total = 0;
+                capture.store(number, std::memory_order_release);
+            }
+
+            Block head;
+            Block* tail;                                /**< Block currently written. */
+            std::size_t total;                          /**< Events of the current capture. */
+            std::uint32_t index;                        /**< Thread id in the trace. */
+            std::atomic<std::uint32_t> capture;         /**< Capture the events belong to. */
+            std::atomic<const char*> name;              /**< Thread name, NULL if none. */
+            std::atomic<bool> isOrphaned;               /**< Set when the thread exited. */
+        };
+
+        /**
+         * All thread buffers, including those of exited threads until the next capture.
+         */
+        struct Registry {
+
+            static Registry& instance() {
+                static Registry registry;
+                return registry;
+            }
+
+            Registry()
+              :
+              nextIndex(0) {
+
+            }
+
+            std::mutex mutex;
+            std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+            std::uint32_t nextIndex;
+        };
+
+        /**
+         * Thread local owner of the buffer, marks the buffer as orphaned when the thread exits.
+         */
+        struct ThreadHandle {
+
+            ~ThreadHandle() {
+                if(buffer) buffer->isOrphaned.store(true, std::memory_order_release);
+            }
+
+            ThreadBuffer& get() {
+
+                if(!buffer) {
+                    Registry& registry = Registry::instance();
+                    std::lock_guard<std::mutex> lock(registry.mutex);
+
+                    buffer = std::make_shared<ThreadBuffer>(registry.nextIndex++);
+                    registry.buffers.push_back(buffer);
+                }
+
+                return *buffer;
+            }
+
+            std::shared_ptr<ThreadBuffer> buffer;
+        };
+
+        thread_local ThreadHandle t_handle;
+
+        void writeEscaped(std::ostream& stream, const char* text) {
+
+            for(; *text; ++text) {
+                if(*text == '"' || *text == '\\') stream.put('\\');
+                if((unsigned char)*text >= 0x20) stream.put(*text);
+            }
+        }
+
+        void writeMicroseconds(std::ostream& stream, std::uint64_t ns) {
+
+            char number[32];
+            std::snprintf(number, sizeof(number), "%llu.%03u",
+                          (unsigned long long)(ns / 1000), (unsigned)(ns % 1000));
+            stream << number;
+        }
+
+    } /* Anonymous namespace */
+
+
+
+    /*===================================================================*
+     * PUBLIC MEMBERS                                                    *
+     *===================================================================*/
+
+    void Profiler::startCapture() {
+
+        Registry& registry = Registry::instance();
+
+        {
+            std::lock_guard<std::mutex> lock(registry.mutex);
+
+            // Buffers of exited threads only held events of the previous capture.
+            registry.buffers.erase(
+                std::remove_if(registry.buffers.begin(), registry.buffers.end(),
+                    [](const std::shared_ptr<ThreadBuffer>& buffer) {
+                        return buffer->isOrphaned.load(std::memory_order_acquire);
+                    }),
+                registry.buffers.end());
+        }
+
+        s_dropped.store(0, std::memory_order_relaxed);
+        s_captureStart.store(now(), std::memory_order_relaxed);
+        s_capture.fetch_add(1, std::memory_order_release);
+        s_isCapturing.store(true, std::memory_order_release);
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    void Profiler::stopCapture() {
+
+        s_isCapturing.store(false, std::memory_order_release);
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    bool Profiler::isCapturing() {
+
+        return s_isCapturing.load(std::memory_order_relaxed);
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    void Profiler::markFrame() {
+
+        if(!isCapturing()) return;
+
+        ProfileEvent event = { "Frame", now(), FRAME_MARKER };
+        record(event);
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    void Profiler::setThreadName(const char* name) {
+
+        t_handle.get().name.store(name, std::memory_order_release);
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    void Profiler::writeChromeTrace(std::ostream& stream) {
+
+        Registry& registry = Registry::instance();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+
+        const std::uint32_t capture = s_capture.load(std::memory_order_acquire);
+        const std::uint64_t start = s_captureStart.load(std::memory_order_relaxed);
+        bool isFirst = true;
+
+        stream << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+
+        for(const std::shared_ptr<ThreadBuffer>& buffer : registry.buffers) {
+            const char* name = buffer->name.load(std::memory_order_acquire);
+
+            if(name) {
+                stream << (isFirst ? "\n" : ",\n")
+                       << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":"
+                       << buffer->index << ",\"args\":{\"name\":\"";
+                writeEscaped(stream, name);
+                stream << "\"}}";
+                isFirst = false;
+            }
+
+            if(buffer->capture.load(std::memory_order_acquire) != capture) continue;
+
+            const Block* block = &buffer->head;
+            for(; block; block = block->next.load(std::memory_order_acquire)) {
+                const std::size_t count = block->count.load(std::memory_order_acquire);
+
+                for(std::size_t i = 0; i < count; ++i) {
+                    const ProfileEvent& event = block->events[i];
+                    const std::uint64_t ts = event.start > start ? event.start - start : 0;
+
+                    stream << (isFirst ? "\n" : ",\n") << "{\"name\":\"";
+                    writeEscaped(stream, event.name);
+
+                    if(event.duration == FRAME_MARKER) {
+                        stream << "\",\"ph\":\"i\",\"s\":\"g\"";
+                    }
+                    else {
+                        stream << "\",\"ph\":\"X\",\"dur\":";
+                        writeMicroseconds(stream, event.duration);
+                    }
+
+                    stream << ",\"pid\":1,\"tid\":" << buffer->index << ",\"ts\":";
+                    writeMicroseconds(stream, ts);
+                    stream << "}";
+                    isFirst = false;
+                }
+
+                if(count < BLOCK_EVENTS) break;
+            }
+        }
+
+        stream << "\n]}\n";
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    void Profiler::saveChromeTrace(const std::string& path) {
+
+        std::ofstream file(path.c_str(), std::ios::out | std::ios::trunc);
+        if(file) writeChromeTrace(file);
+
+        if(!file) {
+            throw std::runtime_error(ErrorMessage("Could not write trace file.").str());
+        }
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    std::size_t Profiler::getDroppedCount() {
+
+        return s_dropped.load(std::memory_order_relaxed);
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    void Profiler::record(const ProfileEvent& event) {
+
+        ThreadBuffer& buffer = t_handle.get();
+
+        const std::uint32_t capture = s_capture.load(std::memory_order_acquire);
+        if(buffer.capture.load(std::memory_order_relaxed) != capture) buffer.reset(capture);
+
+        if(buffer.total >= MAX_THREAD_EVENTS) {
+            s_dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+
+        Block* block = buffer.tail;
+        std::size_t count = block->count.load(std::memory_order_relaxed);
+
+        if(count == BLOCK_EVENTS) {
+            Block* next = block->next.load(std::memory_order_relaxed);
+
+            if(!next) {
+                next = new Block();
+                block->next.store(next, std::memory_order_release);
+            }
+
+            buffer.tail = block = next;
+            count = 0;
+        }
+
+        block->events[count] = event;
+        block->count.store(count + 1, std::memory_order_release);
+        ++buffer.total;
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    std::uint64_t Profiler::now() {
+
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            Clock::now().time_since_epoch()).count();
+    }
+
+
+} /* Namespace Piko */
\ No newline at end of file
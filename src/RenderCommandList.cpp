@@ -0,0 +1,108 @@
+/**
+ * @file        RenderCommandList.cpp
+ * @author      Robert Koch
+ * @version     1.0
+ *
+ * Implementation of the RenderCommandList class.
+ */
+#include "../include/RenderCommandList.h"
+
+#include <algorithm>
+
+
+namespace Piko {
+
+    /*===================================================================*
+     * PUBLIC MEMBERS                                                    *
+     *===================================================================*/
+
+    RenderCommandList::RenderCommandList()
+      :
+      m_block(0),
+      m_offset(0) {
+
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    RenderCommandList::~RenderCommandList() {
+
+        clear();
+
+        for(std::size_t i = 0; i < m_blocks.size(); ++i) {
+            ::operator delete(m_blocks[i].data);
+        }
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    void RenderCommandList::execute() {
+
+        for(std::size_t i = 0; i < m_commands.size(); ++i) {
+            m_commands[i].invoke(m_commands[i].object);
+        }
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    void RenderCommandList::clear() {
+
+        for(std::size_t i = 0; i < m_commands.size(); ++i) {
+            m_commands[i].destroy(m_commands[i].object);
+        }
+
+        m_commands.clear();
+        m_block = 0;
+        m_offset = 0;
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    std::size_t RenderCommandList::size() const {
+
+        return m_commands.size();
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    bool RenderCommandList::empty() const {
+
+        return m_commands.empty();
+    }
+
+
+
+    /*===================================================================*
+     * PRIVATE MEMBERS                                                   *
+     *===================================================================*/
+
+    void* RenderCommandList::allocate(std::size_t size) {
+
+        const std::size_t alignment = alignof(std::max_align_t);
+        size = (size + alignment - 1) & ~(alignment - 1);
+
+        // Advance to the next block which is large enough, allocate one if there is none.
+        while(m_block < m_blocks.size() && m_offset + size > m_blocks[m_block].size) {
+            ++m_block;
+            m_offset = 0;
+        }
+
+        if(m_block == m_blocks.size()) {
+            Block block;
+            block.size = std::max(size, (std::size_t)BLOCK_SIZE);
+            block.data = static_cast<unsigned char *>(::operator new(block.size));
+            m_blocks.push_back(block);
+            m_offset = 0;
+        }
+
+        void* memory = m_blocks[m_block].data + m_offset;
+        m_offset += size;
+        return memory;
+    }
+
+} /* Namespace Piko */
\ No newline at end of file
@@ -0,0 +1,264 @@
+/**
+ * @file        RenderThread.cpp
+ * @author      Robert Koch
+ * @version     1.0
+ *
+ * Implementation of the RenderThread class.
+ */
+#include "../include/RenderThread.h"
+#include "../include/ErrorMessage.h"
+#include "../include/Profiler.h"
+
+#include <chrono>
+#include <stdexcept>
+
+
+namespace Piko {
+
+    namespace {
+
+        typedef std::chrono::steady_clock Clock;
+
+        double millisecondsSince(Clock::time_point start) {
+            return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+        }
+
+    } /* Anonymous namespace */
+
+
+
+    /*===================================================================*
+     * PUBLIC MEMBERS                                                    *
+     *===================================================================*/
+
+    RenderThread::RenderThread()
+      :
+      RenderThread(GLContextBackend::createDefault()) {
+
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    RenderThread::RenderThread(std::unique_ptr<GLContextBackend> backend)
+      :
+      m_context(std::move(backend)),
+      m_recordIndex(0),
+      m_pending(NULL),
+      m_executing(NULL),
+      m_isRunning(false),
+      m_isStopping(false) {
+
+        resetStats();
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    RenderThread::~RenderThread() {
+
+        stop();
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    void RenderThread::start(const InitCallback& init) {
+
+        if(m_thread.joinable()) {
+            throw std::logic_error(
+                ErrorMessage("Render thread is already running.", 0).str());
+        }
+
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_isStopping = false;
+        m_error = std::exception_ptr();
+        m_thread = std::thread(&RenderThread::run, this, init);
+
+        // Wait until the context is initialized or failed.
+        m_condition.wait(lock, [this] { return m_isRunning || m_error; });
+
+        if(m_error) {
+            std::exception_ptr error = m_error;
+            m_error = std::exception_ptr();
+            lock.unlock();
+            m_thread.join();
+            std::rethrow_exception(error);
+        }
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    void RenderThread::stop() {
+
+        if(!m_thread.joinable()) return;
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_isStopping = true;
+        }
+
+        m_condition.notify_all();
+        m_thread.join();
+
+        m_lists[0].clear();
+        m_lists[1].clear();
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    RenderCommandList& RenderThread::getCommandList() {
+
+        return m_lists[m_recordIndex];
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    void RenderThread::submit() {
+
+        std::unique_lock<std::mutex> lock(m_mutex);
+
+        if(!m_isRunning) {
+            throw std::logic_error(
+                ErrorMessage("Render thread is not running.", 0).str());
+        }
+
+        Clock::time_point start = Clock::now();
+        waitIdle(lock);
+        m_stats.submitWaitMs += millisecondsSince(start);
+
+        m_pending = &m_lists[m_recordIndex];
+        m_recordIndex = 1 - m_recordIndex;
+
+        lock.unlock();
+        m_condition.notify_all();
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    void RenderThread::flush() {
+
+        std::unique_lock<std::mutex> lock(m_mutex);
+        waitIdle(lock);
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    bool RenderThread::isRunning() const {
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_isRunning;
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    GLContext& RenderThread::getContext() {
+
+        return m_context;
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    RenderThreadStats RenderThread::getStats() const {
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_stats;
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    void RenderThread::resetStats() {
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        RenderThreadStats stats = { 0, 0.0, 0.0, 0.0 };
+        m_stats = stats;
+    }
+
+
+
+    /*===================================================================*
+     * PRIVATE MEMBERS                                                   *
+     *===================================================================*/
+
+    void RenderThread::run(InitCallback init) {
+
+        PIKO_PROFILE_THREAD("Render thread");
+
+        try {
+            init(m_context);
+        }
+        catch(...) {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_error = std::current_exception();
+            m_condition.notify_all();
+            return;
+        }
+
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_isRunning = true;
+        m_condition.notify_all();
+
+        for(;;) {
+            Clock::time_point start = Clock::now();
+            m_condition.wait(lock, [this] { return m_pending || m_isStopping; });
+            m_stats.renderWaitMs += millisecondsSince(start);
+
+            // Frames submitted before stop() are still executed.
+            if(!m_pending) break;
+
+            m_executing = m_pending;
+            m_pending = NULL;
+            lock.unlock();
+
+            start = Clock::now();
+
+            try {
+                PIKO_PROFILE_ZONE("RenderThread::execute");
+                m_executing->execute();
+                m_context.swapBuffers();
+            }
+            catch(...) {
+                lock.lock();
+                if(!m_error) m_error = std::current_exception();
+                lock.unlock();
+            }
+
+            m_executing->clear();
+            double executeMs = millisecondsSince(start);
+
+            lock.lock();
+            m_executing = NULL;
+            m_stats.executeMs += executeMs;
+            ++m_stats.frameCount;
+            m_condition.notify_all();
+        }
+
+        m_isRunning = false;
+        lock.unlock();
+
+        m_context.dispose();
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    void RenderThread::waitIdle(std::unique_lock<std::mutex>& lock) {
+
+        m_condition.wait(lock, [this] { return !m_pending && !m_executing; });
+
+        if(m_error) {
+            std::exception_ptr error = m_error;
+            m_error = std::exception_ptr();
+            std::rethrow_exception(error);
+        }
+    }
+
+} /* Namespace Piko */
\ No newline at end of file
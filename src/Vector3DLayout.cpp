@@ -0,0 +1,27 @@
+/**
+ * @file        Vector3DLayout.cpp
+ * @author      Robert Koch
+ * @version     1.0
+ *
+ * Definition of the layout marker of Vector3D<float>.
+ *
+ * @see Vector3DLayout.h
+ */
+#include "../include/Vector3DLayout.h"
+
+
+namespace Piko {
+
+    namespace detail {
+
+#if defined(PIKO_VECTOR3D_LAYOUT_SIMD)
+        static_assert(sizeof(Vector3D<float>) == 16, "SIMD Vector3D<float> must be 16 bytes.");
+        extern const int vector3DLayoutSIMD = 1;
+#else
+        static_assert(sizeof(Vector3D<float>) == 12, "Vector3D<float> must be 12 bytes.");
+        extern const int vector3DLayoutScalar = 0;
+#endif
+
+    } /* Namespace detail */
+
+} /* Namespace Piko */
\ No newline at end of file
@@ -0,0 +1,499 @@
+/**
+ * @file        WGLContextBackend.cpp
+ * @author      Robert Koch
+ * @version     1.0
+ *
+ * Implementation of the WGLContextBackend class.
+ */
+#if defined(_WIN32)
+
+#include "../include/WGLContextBackend.h"
+#include "../include/ErrorMessage.h"
+
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+
+
+// Tokens of WGL_ARB_pixel_format, WGL_ARB_multisample and WGL_ARB_framebuffer_sRGB:
+#define WGL_DRAW_TO_WINDOW_ARB                      0x2001
+#define WGL_ACCELERATION_ARB                        0x2003
+#define WGL_SUPPORT_OPENGL_ARB                      0x2010
+#define WGL_DOUBLE_BUFFER_ARB                       0x2011
+#define WGL_PIXEL_TYPE_ARB                          0x2013
+#define WGL_RED_BITS_ARB                            0x2015
+#define WGL_GREEN_BITS_ARB                          0x2017
+#define WGL_BLUE_BITS_ARB                           0x2019
+#define WGL_ALPHA_BITS_ARB                          0x201B
+#define WGL_DEPTH_BITS_ARB                          0x2022
+#define WGL_STENCIL_BITS_ARB                        0x2023
+#define WGL_FULL_ACCELERATION_ARB                   0x2027
+#define WGL_TYPE_RGBA_ARB                           0x202B
+#define WGL_SAMPLE_BUFFERS_ARB                      0x2041
+#define WGL_SAMPLES_ARB                             0x2042
+#define WGL_FRAMEBUFFER_SRGB_CAPABLE_ARB            0x20A9
+
+// Tokens of WGL_ARB_create_context, its profile and no-error extensions:
+#define WGL_CONTEXT_MAJOR_VERSION_ARB               0x2091
+#define WGL_CONTEXT_MINOR_VERSION_ARB               0x2092
+#define WGL_CONTEXT_FLAGS_ARB                       0x2094
+#define WGL_CONTEXT_DEBUG_BIT_ARB                   0x0001
+#define WGL_CONTEXT_FORWARD_COMPATIBLE_BIT_ARB      0x0002
+#define WGL_CONTEXT_PROFILE_MASK_ARB                0x9126
+#define WGL_CONTEXT_CORE_PROFILE_BIT_ARB            0x0001
+#define WGL_CONTEXT_COMPATIBILITY_PROFILE_BIT_ARB   0x0002
+#define WGL_CONTEXT_OPENGL_NO_ERROR_ARB             0x31B3
+
+
+namespace Piko {
+
+    /*===============================================*
+     *  PUBLIC MEMBERS                               *
+     *===============================================*/
+
+    WGLContextBackend::WGLContextBackend()
+      :
+      m_hWnd(NULL),
+      m_hDC(NULL),
+      m_hRC(NULL),
+      m_swapInterval(0),
+      m_createContextAttribs(NULL) {
+
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    WGLContextBackend::~WGLContextBackend() {
+
+        dispose();
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    Result<> WGLContextBackend::tryInit(HWND hWnd, const ContextConfig& config) {
+
+        const FramebufferFormat& format = config.format;
+        m_hWnd = hWnd;
+
+        // Try to get device context
+        if(!(m_hDC = GetDC(m_hWnd))) {
+            return fail(ErrorMessage("Could not retrieve device context."));
+        }
+
+        // Versions, profiles, flags, multisampling and sRGB need the ARB creation functions.
+        WGLFunctions wgl;
+        if(!config.isLegacy()) {
+            loadFunctions(wgl);
+
+            if(!wgl.createContextAttribs) {
+                return fail(ErrorMessage("WGL_ARB_create_context is not supported.", 0));
+            }
+        }
+
+        // Setup of pixel format descriptor
+        PIXELFORMATDESCRIPTOR pfd;
+        ZeroMemory(&pfd, sizeof(PIXELFORMATDESCRIPTOR));
+
+        pfd.nSize = sizeof(PIXELFORMATDESCRIPTOR);
+        pfd.nVersion = 1;
+        pfd.dwFlags = PFD_DRAW_TO_WINDOW | PFD_SUPPORT_OPENGL;
+        if(format.doubleBuffer) pfd.dwFlags |= PFD_DOUBLEBUFFER;
+        pfd.iPixelType = PFD_TYPE_RGBA;
+        pfd.cColorBits = (BYTE)format.getColorBits();
+        pfd.cRedBits = (BYTE)format.redBits;
+        pfd.cGreenBits = (BYTE)format.greenBits;
+        pfd.cBlueBits = (BYTE)format.blueBits;
+        pfd.cAlphaBits = (BYTE)format.alphaBits;
+        pfd.cDepthBits = (BYTE)format.depthBits;
+        pfd.cStencilBits = (BYTE)format.stencilBits;
+        pfd.iLayerType = PFD_MAIN_PLANE;
+
+        int pixelFormat = 0;
+        if(wgl.choosePixelFormat) {
+            std::vector<int> attribs;
+            attribs.push_back(WGL_DRAW_TO_WINDOW_ARB);
+            attribs.push_back(TRUE);
+            attribs.push_back(WGL_SUPPORT_OPENGL_ARB);
+            attribs.push_back(TRUE);
+            attribs.push_back(WGL_ACCELERATION_ARB);
+            attribs.push_back(WGL_FULL_ACCELERATION_ARB);
+            attribs.push_back(WGL_PIXEL_TYPE_ARB);
+            attribs.push_back(WGL_TYPE_RGBA_ARB);
+            attribs.push_back(WGL_DOUBLE_BUFFER_ARB);
+            attribs.push_back(format.doubleBuffer);
+            attribs.push_back(WGL_RED_BITS_ARB);
+            attribs.push_back(format.redBits);
+            attribs.push_back(WGL_GREEN_BITS_ARB);
+            attribs.push_back(format.greenBits);
+            attribs.push_back(WGL_BLUE_BITS_ARB);
+            attribs.push_back(format.blueBits);
+            attribs.push_back(WGL_ALPHA_BITS_ARB);
+            attribs.push_back(format.alphaBits);
+            attribs.push_back(WGL_DEPTH_BITS_ARB);
+            attribs.push_back(format.depthBits);
+            attribs.push_back(WGL_STENCIL_BITS_ARB);
+            attribs.push_back(format.stencilBits);
+
+            if(format.samples > 0) {
+                attribs.push_back(WGL_SAMPLE_BUFFERS_ARB);
+                attribs.push_back(1);
+                attribs.push_back(WGL_SAMPLES_ARB);
+                attribs.push_back(format.samples);
+            }
+
+            if(format.sRGB) {
+                attribs.push_back(WGL_FRAMEBUFFER_SRGB_CAPABLE_ARB);
+                attribs.push_back(TRUE);
+            }
+
+            attribs.push_back(0);
+
+            UINT count = 0;
+            if(!wgl.choosePixelFormat(m_hDC, &attribs[0], NULL, 1, &pixelFormat, &count)
+                    || count == 0) {
+                return fail(ErrorMessage("Could not choose pixel format."));
+            }
+
+            DescribePixelFormat(m_hDC, pixelFormat, sizeof(PIXELFORMATDESCRIPTOR), &pfd);
+        }
+        else if(!(pixelFormat = ChoosePixelFormat(m_hDC, &pfd))) {
+            return fail(ErrorMessage("Could not choose pixel format."));
+        }
+
+        if(!SetPixelFormat(m_hDC, pixelFormat, &pfd)) {
+            return fail(ErrorMessage("Could not set pixel format."));
+        }
+
+        // Read back what the driver actually granted.
+        PIXELFORMATDESCRIPTOR granted;
+        DescribePixelFormat(m_hDC, pixelFormat, sizeof(PIXELFORMATDESCRIPTOR), &granted);
+        m_format.redBits = granted.cRedBits;
+        m_format.greenBits = granted.cGreenBits;
+        m_format.blueBits = granted.cBlueBits;
+        m_format.alphaBits = granted.cAlphaBits;
+        m_format.depthBits = granted.cDepthBits;
+        m_format.stencilBits = granted.cStencilBits;
+        m_format.samples = 0;
+        m_format.doubleBuffer = (granted.dwFlags & PFD_DOUBLEBUFFER) != 0;
+        m_format.sRGB = false;
+
+        if(wgl.getPixelFormatAttribiv) {
+            const int queries[] = { WGL_SAMPLES_ARB, WGL_FRAMEBUFFER_SRGB_CAPABLE_ARB };
+            int values[] = { 0, 0 };
+            if(wgl.getPixelFormatAttribiv(m_hDC, pixelFormat, 0, 2, queries, values)) {
+                m_format.samples = values[0];
+                m_format.sRGB = values[1] != 0;
+            }
+        }
+
+        // Setup contexts
+        m_createContextAttribs = wgl.createContextAttribs;
+        m_contextAttribs.clear();
+
+        if(m_createContextAttribs) {
+            initContextAttribs(config, wgl);
+            m_hRC = m_createContextAttribs(m_hDC, NULL, &m_contextAttribs[0]);
+        }
+        else {
+            m_hRC = wglCreateContext(m_hDC);
+        }
+
+        if(!m_hRC) {
+            return fail(ErrorMessage("Could not create rendering context."));
+        }
+
+        if(!wglMakeCurrent(m_hDC, m_hRC)) {
+            return fail(ErrorMessage("Could not activate rendering context."));
+        }
+
+        setSwapInterval(config.swapInterval);
+        return Result<>();
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    Result<> WGLContextBackend::tryInitOffscreen(int width, int height,
+                                                 const ContextConfig& config) {
+
+        return ErrorMessage("Offscreen contexts are not supported by the WGL backend.", 0);
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    std::unique_ptr<GLContextBackend> WGLContextBackend::createShared() const {
+
+        // The shared context renders into the same DC, which is released by this backend.
+        std::unique_ptr<WGLContextBackend> shared(new WGLContextBackend());
+        shared->m_hDC = m_hDC;
+        shared->m_format = m_format;
+
+        // Shared contexts have to be created with the same version, profile and flags.
+        if(m_createContextAttribs) {
+            shared->m_createContextAttribs = m_createContextAttribs;
+            shared->m_contextAttribs = m_contextAttribs;
+            shared->m_hRC = m_createContextAttribs(m_hDC, m_hRC, &m_contextAttribs[0]);
+
+            if(!shared->m_hRC) {
+                throw std::runtime_error(
+                    ErrorMessage("Could not create shared rendering context.").str());
+            }
+
+            return std::unique_ptr<GLContextBackend>(std::move(shared));
+        }
+
+        if(!(shared->m_hRC = wglCreateContext(m_hDC))) {
+            throw std::runtime_error(
+                ErrorMessage("Could not create shared rendering context.").str());
+        }
+
+        if(!wglShareLists(m_hRC, shared->m_hRC)) {
+            throw std::runtime_error(
+                ErrorMessage("Could not share objects between rendering contexts.").str());
+        }
+
+        return std::unique_ptr<GLContextBackend>(std::move(shared));
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    void WGLContextBackend::makeCurrent() {
+
+        if(!wglMakeCurrent(m_hDC, m_hRC)) {
+            throw std::runtime_error(
+                ErrorMessage("Could not activate rendering context.").str());
+        }
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    void WGLContextBackend::doneCurrent() {
+
+        wglMakeCurrent(NULL, NULL);
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    void* WGLContextBackend::getProcAddress(const char* name) const {
+
+        // wglGetProcAddress() only knows functions beyond OpenGL 1.1 and signals failure not
+        // only with NULL.
+        PROC proc = wglGetProcAddress(name);
+        std::intptr_t value = (std::intptr_t)proc;
+
+        if(value == 0 || value == 1 || value == 2 || value == 3 || value == -1) {
+            proc = GetProcAddress(GetModuleHandleA("opengl32.dll"), name);
+        }
+
+        return (void *)proc;
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    void WGLContextBackend::dispose() {
+
+        if(m_hRC) {
+            // Only release the context if it belongs to the calling thread.
+            if(wglGetCurrentContext() == m_hRC) wglMakeCurrent(NULL, NULL);
+            wglDeleteContext(m_hRC);
+        }
+
+        if(m_hWnd && m_hDC) {
+            ReleaseDC(m_hWnd, m_hDC);
+        }
+
+        m_hWnd = NULL;
+        m_hDC = NULL;
+        m_hRC = NULL;
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    void WGLContextBackend::setSwapInterval(int interval) {
+
+        // The swap control functions are only known with a current context.
+        SwapIntervalProc swapInterval = 
+            (SwapIntervalProc)wglGetProcAddress("wglSwapIntervalEXT");
+        GetSwapIntervalProc getSwapInterval = 
+            (GetSwapIntervalProc)wglGetProcAddress("wglGetSwapIntervalEXT");
+        GetExtensionsStringProc getExtensions = 
+            (GetExtensionsStringProc)wglGetProcAddress("wglGetExtensionsStringARB");
+
+        // Without the extension the driver default of one vertical blank applies.
+        if(!swapInterval || !getSwapInterval) {
+            m_swapInterval = 1;
+            return;
+        }
+
+        // Negative intervals require WGL_EXT_swap_control_tear.
+        if(interval < 0 && !(getExtensions 
+                && hasExtension(getExtensions(m_hDC), "WGL_EXT_swap_control_tear"))) {
+            interval = -interval;
+        }
+
+        swapInterval(interval);
+        m_swapInterval = getSwapInterval();
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    int WGLContextBackend::getSwapInterval() const {
+
+        return m_swapInterval;
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    void WGLContextBackend::swapBuffers() {
+
+        SwapBuffers(m_hDC);
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    const FramebufferFormat& WGLContextBackend::getFramebufferFormat() const {
+
+        return m_format;
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    HDC WGLContextBackend::getDeviceContext() const {
+
+        return m_hDC;
+    }
+
+
+
+    /*===============================================*
+     *  PRIVATE MEMBERS                              *
+     *===============================================*/
+
+    void WGLContextBackend::loadFunctions(WGLFunctions& wgl) {
+
+        // The functions can only be queried with a current context, which needs a pixel format.
+        // As the pixel format of a window cannot be changed, a temporary window is used.
+        HWND hWnd = CreateWindowExA(0, "STATIC", "", WS_POPUP, 0, 0, 1, 1, NULL, NULL,
+                                    GetModuleHandle(0), NULL);
+        if(!hWnd) return;
+
+        HDC hDC = GetDC(hWnd);
+
+        PIXELFORMATDESCRIPTOR pfd;
+        ZeroMemory(&pfd, sizeof(PIXELFORMATDESCRIPTOR));
+        pfd.nSize = sizeof(PIXELFORMATDESCRIPTOR);
+        pfd.nVersion = 1;
+        pfd.dwFlags = PFD_DRAW_TO_WINDOW | PFD_SUPPORT_OPENGL | PFD_DOUBLEBUFFER;
+        pfd.iPixelType = PFD_TYPE_RGBA;
+        pfd.cColorBits = 24;
+        pfd.iLayerType = PFD_MAIN_PLANE;
+
+        HGLRC hRC = NULL;
+        if(hDC && SetPixelFormat(hDC, ChoosePixelFormat(hDC, &pfd), &pfd)) {
+            hRC = wglCreateContext(hDC);
+        }
+
+        if(hRC && wglMakeCurrent(hDC, hRC)) {
+            GetExtensionsStringProc getExtensions = 
+                (GetExtensionsStringProc)wglGetProcAddress("wglGetExtensionsStringARB");
+            const char* extensions = getExtensions ? getExtensions(hDC) : NULL;
+
+            wgl.createContextAttribs = 
+                (CreateContextAttribsProc)wglGetProcAddress("wglCreateContextAttribsARB");
+            wgl.choosePixelFormat = 
+                (ChoosePixelFormatProc)wglGetProcAddress("wglChoosePixelFormatARB");
+            wgl.getPixelFormatAttribiv = 
+                (GetPixelFormatAttribivProc)wglGetProcAddress("wglGetPixelFormatAttribivARB");
+            wgl.hasProfiles = hasExtension(extensions, "WGL_ARB_create_context_profile");
+            wgl.hasNoError = hasExtension(extensions, "WGL_ARB_create_context_no_error");
+
+            wglMakeCurrent(NULL, NULL);
+        }
+
+        if(hRC) wglDeleteContext(hRC);
+        if(hDC) ReleaseDC(hWnd, hDC);
+        DestroyWindow(hWnd);
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    Result<> WGLContextBackend::fail(const ErrorMessage& error) {
+
+        dispose();
+        return error;
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    void WGLContextBackend::initContextAttribs(const ContextConfig& config, 
+                                               const WGLFunctions& wgl) {
+
+        m_contextAttribs.clear();
+
+        if(config.majorVersion > 1) {
+            m_contextAttribs.push_back(WGL_CONTEXT_MAJOR_VERSION_ARB);
+            m_contextAttribs.push_back(config.majorVersion);
+            m_contextAttribs.push_back(WGL_CONTEXT_MINOR_VERSION_ARB);
+            m_contextAttribs.push_back(config.minorVersion);
+        }
+
+        if(wgl.hasProfiles) {
+            m_contextAttribs.push_back(WGL_CONTEXT_PROFILE_MASK_ARB);
+            m_contextAttribs.push_back(config.profile == ContextProfile::CORE 
+                                       ? WGL_CONTEXT_CORE_PROFILE_BIT_ARB
+                                       : WGL_CONTEXT_COMPATIBILITY_PROFILE_BIT_ARB);
+        }
+
+        int flags = 0;
+        if(config.debug) flags |= WGL_CONTEXT_DEBUG_BIT_ARB;
+        if(config.forwardCompatible) flags |= WGL_CONTEXT_FORWARD_COMPATIBLE_BIT_ARB;
+
+        if(flags) {
+            m_contextAttribs.push_back(WGL_CONTEXT_FLAGS_ARB);
+            m_contextAttribs.push_back(flags);
+        }
+
+        // A context cannot be a debug and a no-error context at once, debugging wins.
+        if(config.noError && !config.debug && wgl.hasNoError) {
+            m_contextAttribs.push_back(WGL_CONTEXT_OPENGL_NO_ERROR_ARB);
+            m_contextAttribs.push_back(TRUE);
+        }
+
+        m_contextAttribs.push_back(0);
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    bool WGLContextBackend::hasExtension(const char* extensions, const char* name) {
+
+        if(!extensions) return false;
+
+        const std::size_t length = std::strlen(name);
+        for(const char* p = std::strstr(extensions, name); p; p = std::strstr(p + 1, name)) {
+            if((p == extensions || p[-1] == ' ') && (p[length] == ' ' || p[length] == '\0')) {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+
+} /* Namespace Piko */
+
+#endif // End of _WIN32
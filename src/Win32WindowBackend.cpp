@@ -0,0 +1,265 @@
+/**
+ * @file        Win32WindowBackend.cpp
+ * @author      Robert Koch
+ * @version     1.0
+ *
+ * Implementation of the Win32WindowBackend class.
+ */
+#if defined(_WIN32)
+
+#include "../include/Win32WindowBackend.h"
+#include "../include/ErrorMessage.h"
+#include "../include/Log.h"
+
+#include <sstream>
+#include <stdexcept>
+
+
+
+namespace Piko {
+
+    /*===================================================================*
+     * STATIC MEMBERS                                                    *
+     *===================================================================*/
+
+    const std::string Win32WindowBackend::CLASS_NAME_BASE = "WindowBase";
+
+
+
+    /*===================================================================*
+     * PUBLIC MEMBERS                                                    *
+     *===================================================================*/
+
+    Win32WindowBackend::Win32WindowBackend()
+      :
+      m_window(NULL),
+      m_hInstance(GetModuleHandle(0)),
+      m_hWnd(NULL) {
+
+        ZeroMemory(&m_wc, sizeof(m_wc));
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    Win32WindowBackend::~Win32WindowBackend() {
+
+        // A window still alive must not reach this instance anymore, its messages during the
+        // destruction are handled by DefWindowProc().
+        if(m_hWnd && IsWindow(m_hWnd)) {
+            SetWindowLongPtrA(m_hWnd, GWLP_USERDATA, 0);
+            DestroyWindow(m_hWnd);
+        }
+
+        if(!m_className.empty() && !UnregisterClassA(m_className.c_str(), m_hInstance)) {
+            PIKO_LOG_WARNING("[Win32WindowBackend] {}",
+                             ErrorMessage("Could not unregister window class.").str());
+        }
+
+        m_hWnd = NULL;
+        ZeroMemory(&m_wc, sizeof(m_wc));
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    void Win32WindowBackend::create(WindowBase* window, const std::string& title, int width,
+                                    int height) {
+
+        m_window = window;
+
+        initWindowClass();
+
+        // The handle is also stored by staticWndProc() at WM_NCCREATE.
+        m_hWnd = CreateWindowExA(WS_EX_APPWINDOW | WS_EX_WINDOWEDGE,
+            m_className.c_str(),
+            title.c_str(),
+            WS_CLIPSIBLINGS | WS_CLIPCHILDREN | WS_OVERLAPPEDWINDOW,
+            0, 0,
+            width,
+            height,
+            NULL,
+            NULL,
+            m_hInstance,
+            (void *)this);
+
+        if(!m_hWnd) {
+            throw std::runtime_error(
+                ErrorMessage("Could not create window.").str());
+        }
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    void Win32WindowBackend::destroy() {
+
+        DestroyWindow(m_hWnd);  // Send WM_DESTROY to message handler.
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    void Win32WindowBackend::show() {
+
+        ShowWindow(m_hWnd, SW_SHOW);
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    void Win32WindowBackend::setTitle(const std::string& title) {
+
+        SetWindowTextA(m_hWnd, title.c_str());
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    void Win32WindowBackend::setFullscreen(bool flag, int width, int height) {
+
+        DEVMODE fullscreenSettings;
+
+        // Enable fullscreen mode:
+        if(flag) {
+            EnumDisplaySettings(NULL, 0, &fullscreenSettings);
+            fullscreenSettings.dmPelsWidth = width;
+            fullscreenSettings.dmPelsHeight = height;
+            fullscreenSettings.dmBitsPerPel = 32;
+            fullscreenSettings.dmFields = DM_PELSWIDTH | DM_PELSHEIGHT | DM_BITSPERPEL;
+
+            SetWindowLongPtr(m_hWnd, GWL_EXSTYLE, WS_EX_APPWINDOW | WS_EX_TOPMOST);
+            SetWindowLongPtr(m_hWnd, GWL_STYLE, WS_POPUP | WS_VISIBLE);
+            SetWindowPos(m_hWnd, HWND_TOPMOST, 0, 0, width, height, SWP_SHOWWINDOW);
+            ChangeDisplaySettings(&fullscreenSettings, CDS_FULLSCREEN);
+            ShowWindow(m_hWnd, SW_MAXIMIZE);
+        }
+
+        // Enable window mode:
+        else {
+            SetWindowLongPtr(m_hWnd, GWL_EXSTYLE, WS_EX_LEFT);
+            SetWindowLongPtr(m_hWnd, GWL_STYLE, WS_OVERLAPPEDWINDOW | WS_VISIBLE);
+            ChangeDisplaySettings(NULL, CDS_RESET);
+            SetWindowPos(m_hWnd, HWND_TOPMOST, 0, 0, width, height, SWP_SHOWWINDOW);
+            ShowWindow(m_hWnd, SW_RESTORE);
+        }
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    int Win32WindowBackend::processMessages() {
+
+        MSG msg;
+        int count = 0;
+
+        while(PeekMessage(&msg, NULL, 0, 0, PM_REMOVE)) {
+            TranslateMessage(&msg);
+            DispatchMessage(&msg);
+            ++count;
+        }
+
+        return count;
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    int Win32WindowBackend::getDisplayWidth() const {
+
+        return GetSystemMetrics(SM_CXSCREEN);
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    int Win32WindowBackend::getDisplayHeight() const {
+
+        return GetSystemMetrics(SM_CYSCREEN);
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    HWND Win32WindowBackend::getHandle() const {
+
+        return m_hWnd;
+    }
+
+
+
+    /*===================================================================*
+     * PRIVATE MEMBERS                                                   *
+     *===================================================================*/
+
+    LRESULT CALLBACK Win32WindowBackend::staticWndProc(HWND hwnd, UINT msg, WPARAM wParam,
+                                                       LPARAM lParam) {
+
+        Win32WindowBackend* backend;
+
+        // Attach the instance passed to CreateWindowExA() to the window.
+        if(msg == WM_NCCREATE) {
+            CREATESTRUCTA* createStruct = reinterpret_cast<CREATESTRUCTA *>(lParam);
+            backend = static_cast<Win32WindowBackend *>(createStruct->lpCreateParams);
+            backend->m_hWnd = hwnd;
+            SetWindowLongPtrA(hwnd, GWLP_USERDATA, reinterpret_cast<LONG_PTR>(backend));
+        }
+        else {
+            backend = reinterpret_cast<Win32WindowBackend *>(
+                GetWindowLongPtrA(hwnd, GWLP_USERDATA));
+        }
+
+        // Messages sent before WM_NCCREATE have no instance yet.
+        if(!backend) {
+            return DefWindowProc(hwnd, msg, wParam, lParam);
+        }
+
+        bool msgConsumed = dispatch(backend->m_window, msg, wParam, lParam);
+
+        // Last message of the window, the handle becomes invalid afterwards.
+        if(msg == WM_NCDESTROY) {
+            SetWindowLongPtrA(hwnd, GWLP_USERDATA, 0);
+            backend->m_hWnd = NULL;
+        }
+
+        return msgConsumed ? NULL : DefWindowProc(hwnd, msg, wParam, lParam);
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    void Win32WindowBackend::initWindowClass() {
+
+        std::ostringstream classNameStream;
+        classNameStream << CLASS_NAME_BASE << this << std::endl;
+        m_className = classNameStream.str();
+
+        ZeroMemory(&m_wc, sizeof(WNDCLASSEXA));
+
+        // Set up window class:
+        m_wc.cbSize = sizeof(WNDCLASSEX);                   // Structure size.
+        m_wc.style = CS_HREDRAW | CS_VREDRAW | CS_OWNDC;    // Class style.
+        m_wc.lpfnWndProc = staticWndProc;                   // Callback for incoming messages.
+        m_wc.cbClsExtra = 0;                                // No extra bytes.
+        m_wc.cbWndExtra = 0;                                // No extra bytes.
+        m_wc.hInstance = m_hInstance;                       // Set the instance.
+        m_wc.hIcon = LoadIcon(NULL, IDI_APPLICATION);       // Use default icon.
+        m_wc.hCursor = LoadCursor(NULL, IDC_ARROW);         // Use default cursor.
+        m_wc.hbrBackground = NULL;                          // No background brush.
+        m_wc.lpszMenuName = NULL;                           // No menu name.
+        m_wc.lpszClassName = m_className.c_str();           // Set class name.
+        m_wc.hIconSm = LoadIcon(NULL, IDI_APPLICATION);     // Use default small icon.
+
+        PIKO_LOG_DEBUG("[Win32WindowBackend] Register window, class={}", m_className);
+
+        // Register window class:
+        if(!RegisterClassExA(&m_wc)) {
+            throw std::runtime_error(
+                ErrorMessage("Could not register window class.").str());
+        }
+    }
+
+
+} /* Namespace Piko */
+
+#endif // End of _WIN32
@@ -0,0 +1,48 @@
+/**
+ * @file        WindowBackend.cpp
+ * @author      Robert Koch
+ * @version     1.0
+ *
+ * Implementation of the WindowBackend interface.
+ */
+#include "../include/WindowBackend.h"
+#include "../include/WindowBase.h"
+#include "../include/HeadlessWindowBackend.h"
+#include "../include/Win32WindowBackend.h"
+
+
+namespace Piko {
+
+    /*===================================================================*
+     * PUBLIC MEMBERS                                                    *
+     *===================================================================*/
+
+    std::unique_ptr<WindowBackend> WindowBackend::createDefault() {
+
+#if defined(_WIN32)
+        return std::unique_ptr<WindowBackend>(new Win32WindowBackend());
+#else
+        return std::unique_ptr<WindowBackend>(new HeadlessWindowBackend());
+#endif
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    WindowBackend::~WindowBackend() {
+
+    }
+
+
+
+    /*===================================================================*
+     * PROTECTED MEMBERS                                                 *
+     *===================================================================*/
+
+    bool WindowBackend::dispatch(WindowBase* window, UINT msg, WPARAM wParam, LPARAM lParam) {
+
+        return window ? window->messageHandler(msg, wParam, lParam) : false;
+    }
+
+
+} /* Namespace Piko */
@@ -6,51 +6,48 @@
  * Implementation of the WindowBase class.
  */
 #include "../include/WindowBase.h"
-#include "../include/ErrorMessage.h"
-
-#include <sstream>
+#include "../include/Log.h"
+#include "../include/Profiler.h"
 
 
 
 namespace Piko {
 
     /*===================================================================*
-     * STATIC MEMBERS                                                    *
+     * PUBLIC MEMBERS                                                    *
      *===================================================================*/
 
-    const std::string WindowBase::CLASS_NAME_BASE = "WindowBase";
+    WindowBase::WindowBase(std::string title, int width, int height)
+      :
+      WindowBase(WindowBackend::createDefault(), title, width, height) {
+
+    }
 
     //---------------------------------------------------------------------------------------------
     //---------------------------------------------------------------------------------------------
 
-    std::map<HWND, WindowBase*> WindowBase::mWindowRegistry = std::map<HWND, WindowBase*>();
-
-
-
-    /*===================================================================*
-     * PUBLIC MEMBERS                                                    *
-     *===================================================================*/
-
-    WindowBase::WindowBase(std::string title, int width, int height)
+    WindowBase::WindowBase(std::unique_ptr<WindowBackend> backend, std::string title, int width,
+                           int height)
       : 
-      m_hInstance(GetModuleHandle(0)),
+      m_backend(std::move(backend)),
       m_title(title), 
       m_width(width), 
       m_height(height),
-      m_maxWidth(GetSystemMetrics(SM_CXSCREEN)),
-      m_maxHeight(GetSystemMetrics(SM_CYSCREEN)),      
+      m_maxWidth(m_backend->getDisplayWidth()),
+      m_maxHeight(m_backend->getDisplayHeight()),      
       m_isClosed(false),
-      m_isFullscreen(false) {
+      m_isFullscreen(false),
+      m_input(INPUT_CAPACITY),
+      m_droppedInput(0) {
+
+        PIKO_LOG_DEBUG("[WindowBase] Initialize window...");
 
-        std::cout << "[WindowBase] Initialize window..." << std::endl;
+        if(m_width == DEFAULT_SIZE) m_width = m_maxWidth / 2;
+        if(m_height == DEFAULT_SIZE) m_height = m_maxHeight / 2;
         
-        initWindowClass();
         createWindow();
 
-        // Add to registry:
-        mWindowRegistry.insert(std::pair<HWND, WindowBase *>(m_hWnd, this));    
-
-        std::cout << "[WindowBase] Finished initialization." << std::endl;
+        PIKO_LOG_DEBUG("[WindowBase] Finished initialization.");
     }
 
     //---------------------------------------------------------------------------------------------
@@ -58,15 +55,10 @@ namespace Piko {
 
     WindowBase::~WindowBase() {
 
-        std::cout << "Delete window." << std::endl;
+        PIKO_LOG_DEBUG("[WindowBase] Delete window.");
 
-        if(!UnregisterClassA(m_className.c_str(), m_hInstance)) {
-            std::cerr << ErrorMessage("Could not unregister window class.").str() << std::endl;
-        }
-
-        mWindowRegistry.erase(m_hWnd);
-        m_hWnd = NULL;
-        ZeroMemory(&m_wc, sizeof(m_wc));
+        // The backend releases the native window when it is destroyed.
+        m_backend.reset();
     }
 
     //---------------------------------------------------------------------------------------------
@@ -74,7 +66,7 @@ namespace Piko {
 
     void WindowBase::show() const {
 
-        ShowWindow(m_hWnd, SW_SHOW);
+        m_backend->show();
     }
 
     //---------------------------------------------------------------------------------------------
@@ -82,10 +74,10 @@ namespace Piko {
 
     void WindowBase::close() {
 
-        std::cout << "[WindowBase] Close window " << m_hWnd << std::endl;
+        PIKO_LOG_DEBUG("[WindowBase] Close window {}", getHandle());
 
         m_isClosed = true;
-        DestroyWindow(m_hWnd);  // Send WM_DESTROY to message handler.
+        m_backend->destroy();   // Send WM_DESTROY to message handler.
     
     }
 
@@ -102,7 +94,23 @@ namespace Piko {
 
     HWND WindowBase::getHandle() const {
         
-        return m_hWnd;
+        return m_backend->getHandle();
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    WindowBackend& WindowBase::getBackend() const {
+
+        return *m_backend;
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    bool WindowBase::isFullscreen() const {
+
+        return m_isFullscreen;
     }
 
     //---------------------------------------------------------------------------------------------
@@ -111,7 +119,7 @@ namespace Piko {
     void WindowBase::setTitle(std::string title) {
         
         m_title = title;
-        SetWindowTextA(m_hWnd, m_title.c_str());
+        m_backend->setTitle(m_title);
     }
 
     //---------------------------------------------------------------------------------------------
@@ -123,37 +131,35 @@ namespace Piko {
             return;
         }
 
-        DEVMODE fullscreenSettings;
-
         // Enable fullscreen mode:
         if(flag) {
-            EnumDisplaySettings(NULL, 0, &fullscreenSettings);
-            fullscreenSettings.dmPelsWidth = m_maxWidth;
-            fullscreenSettings.dmPelsHeight = m_maxHeight;
-            fullscreenSettings.dmBitsPerPel = 32;
-            fullscreenSettings.dmFields = DM_PELSWIDTH | DM_PELSHEIGHT | DM_BITSPERPEL;
-
-            SetWindowLongPtr(m_hWnd, GWL_EXSTYLE, WS_EX_APPWINDOW | WS_EX_TOPMOST);
-            SetWindowLongPtr(m_hWnd, GWL_STYLE, WS_POPUP | WS_VISIBLE);
-            SetWindowPos(m_hWnd, HWND_TOPMOST, 0, 0, m_maxWidth, m_maxHeight, SWP_SHOWWINDOW);
-            ChangeDisplaySettings(&fullscreenSettings, CDS_FULLSCREEN);
-            ShowWindow(m_hWnd, SW_MAXIMIZE);
-
+            m_backend->setFullscreen(true, m_maxWidth, m_maxHeight);
             m_isFullscreen = true;
         }
 
         // Enable window mode:
         else {
-            SetWindowLongPtr(m_hWnd, GWL_EXSTYLE, WS_EX_LEFT);
-            SetWindowLongPtr(m_hWnd, GWL_STYLE, WS_OVERLAPPEDWINDOW | WS_VISIBLE);
-            ChangeDisplaySettings(NULL, CDS_RESET);
-            SetWindowPos(m_hWnd, HWND_TOPMOST, 0, 0, m_width, m_height, SWP_SHOWWINDOW);
-            ShowWindow(m_hWnd, SW_RESTORE);
-
+            m_backend->setFullscreen(false, m_width, m_height);
             m_isFullscreen = false;
         }
     }
 
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    std::size_t WindowBase::pollInput(InputEvent* events, std::size_t count) {
+
+        return m_input.pop(events, count);
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //---------------------------------------------------------------------------------------------
+
+    std::size_t WindowBase::getDroppedInputCount() const {
+
+        return m_droppedInput.load(std::memory_order_relaxed);
+    }
+
 
     /*===================================================================*
      * PROTECTED MEMBERS                                                 *
@@ -161,7 +167,10 @@ namespace Piko {
 
     bool WindowBase::messageHandler(UINT msg, WPARAM wParam, LPARAM lParam) {
 
-        //std::cout << "Incoming message " << msg << " for hwnd " << m_hWnd << std::endl;
+        PIKO_PROFILE_ZONE("WindowBase::messageHandler");
+        PIKO_LOG_TRACE("[WindowBase] Incoming message {} for hwnd {}", msg, getHandle());
+
+        recordInput(msg, wParam, lParam);
 
         switch(msg) {
             case WM_DESTROY:
@@ -198,76 +207,89 @@ namespace Piko {
      * PRIVATE MEMBERS                                                   *
      *===================================================================*/
 
-    LRESULT CALLBACK WindowBase::staticWndProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam) {
-
-        //std::cout << "Dispatch message." << std::endl;
-
-        // Try to get the right message handler for the window.
-        auto seek = mWindowRegistry.find(hwnd);
-        if(seek == mWindowRegistry.end()) {
-            return DefWindowProc(hwnd, msg, wParam, lParam);        
-        }
+    void WindowBase::createWindow() {
 
-        WindowBase* window = seek->second;
-        bool msgConsumed = window->messageHandler(msg, wParam, lParam);
-   
-        return msgConsumed ? NULL : DefWindowProc(hwnd, msg, wParam, lParam);
+        m_backend->create(this, m_title, m_width, m_height);
     }
 
     //---------------------------------------------------------------------------------------------
     //---------------------------------------------------------------------------------------------
 
-    void WindowBase::initWindowClass() {
-
-        std::ostringstream classNameStream;
-        classNameStream << CLASS_NAME_BASE << this << std::endl;
-        m_className = classNameStream.str();
-
-        ZeroMemory(&m_wc, sizeof(WNDCLASSEXA));   
-
-        // Set up window class:
-        m_wc.cbSize = sizeof(WNDCLASSEX);                   // Structure size.
-        m_wc.style = CS_HREDRAW | CS_VREDRAW | CS_OWNDC;    // Class style.
-        m_wc.lpfnWndProc = staticWndProc;                   // Callback for incoming messages.
-        m_wc.cbClsExtra = 0;                                // No extra bytes.
-        m_wc.cbWndExtra = 0;                                // No extra bytes.
-        m_wc.hInstance = m_hInstance;                       // Set the instance.
-        m_wc.hIcon = LoadIcon(NULL, IDI_APPLICATION);       // Use default icon.
-        m_wc.hCursor = LoadCursor(NULL, IDC_ARROW);         // Use default cursor.
-        m_wc.hbrBackground = NULL;                          // No background brush.
-        m_wc.lpszMenuName = NULL;                           // No menu name.
-        m_wc.lpszClassName = m_className.c_str();           // Set class name.
-        m_wc.hIconSm = LoadIcon(NULL, IDI_APPLICATION);     // Use default small icon.
-
-        std::cout << "[WindowBase] Register window, class=" << m_className << std::endl;
-
-        // Register window class:
-        if(!RegisterClassExA(&m_wc)) {
-            throw std::runtime_error(
-                ErrorMessage("Could not register window class.").str());
+    void WindowBase::recordInput(UINT msg, WPARAM wParam, LPARAM lParam) {
+
+        InputEvent event;
+
+        // Coordinates and sizes are packed as signed/unsigned 16 bit words.
+        const std::int32_t low = (std::int16_t)(lParam & 0xFFFF);
+        const std::int32_t high = (std::int16_t)((lParam >> 16) & 0xFFFF);
+
+        switch(msg) {
+            case WM_KEYDOWN:
+            case WM_KEYUP:
+                event.type = msg == WM_KEYDOWN ? InputEventType::KEY_DOWN : InputEventType::KEY_UP;
+                event.key.code = (std::int32_t)wParam;
+                // Bit 30 is the previous key state, which is always set for a release.
+                event.key.repeat = msg == WM_KEYDOWN ? (lParam >> 30) & 1 : 0;
+                break;
+            case WM_MOUSEMOVE:
+                event.type = InputEventType::MOUSE_MOVE;
+                event.mouse.button = MouseButton::NONE;
+                break;
+            case WM_LBUTTONDOWN:
+                event.type = InputEventType::MOUSE_BUTTON_DOWN;
+                event.mouse.button = MouseButton::LEFT;
+                break;
+            case WM_LBUTTONUP:
+                event.type = InputEventType::MOUSE_BUTTON_UP;
+                event.mouse.button = MouseButton::LEFT;
+                break;
+            case WM_RBUTTONDOWN:
+                event.type = InputEventType::MOUSE_BUTTON_DOWN;
+                event.mouse.button = MouseButton::RIGHT;
+                break;
+            case WM_RBUTTONUP:
+                event.type = InputEventType::MOUSE_BUTTON_UP;
+                event.mouse.button = MouseButton::RIGHT;
+                break;
+            case WM_MBUTTONDOWN:
+                event.type = InputEventType::MOUSE_BUTTON_DOWN;
+                event.mouse.button = MouseButton::MIDDLE;
+                break;
+            case WM_MBUTTONUP:
+                event.type = InputEventType::MOUSE_BUTTON_UP;
+                event.mouse.button = MouseButton::MIDDLE;
+                break;
+            case WM_MOUSEWHEEL:
+                // Wheel messages carry screen coordinates.
+                event.type = InputEventType::MOUSE_WHEEL;
+                event.mouse.wheel = (std::int16_t)((wParam >> 16) & 0xFFFF);
+                event.mouse.button = MouseButton::NONE;
+                break;
+            case WM_SIZE:
+                event.type = InputEventType::RESIZE;
+                event.resize.width = (std::int32_t)(lParam & 0xFFFF);
+                event.resize.height = (std::int32_t)((lParam >> 16) & 0xFFFF);
+                break;
+            case WM_SETFOCUS:
+                event.type = InputEventType::FOCUS_GAINED;
+                break;
+            case WM_KILLFOCUS:
+                event.type = InputEventType::FOCUS_LOST;
+                break;
+            default:
+                return;
         }
-    }
 
-    //---------------------------------------------------------------------------------------------
-    //---------------------------------------------------------------------------------------------
+        if(event.type >= InputEventType::MOUSE_MOVE && event.type <= InputEventType::MOUSE_WHEEL) {
+            event.mouse.x = low;
+            event.mouse.y = high;
+            if(event.type != InputEventType::MOUSE_WHEEL) event.mouse.wheel = 0;
+        }
 
-    void WindowBase::createWindow() {
+        event.timestamp = InputEvent::now();
 
-        m_hWnd = CreateWindowExA(WS_EX_APPWINDOW | WS_EX_WINDOWEDGE,
-            m_className.c_str(),
-            m_title.c_str(),  
-            WS_CLIPSIBLINGS | WS_CLIPCHILDREN | WS_OVERLAPPEDWINDOW,
-            0, 0,
-            m_width,
-            m_height,
-            NULL,
-            NULL,
-            m_hInstance,
-            (void *)this);
-
-        if(!m_hWnd) {
-            throw std::runtime_error(
-                ErrorMessage("Could not create window.").str());
+        if(!m_input.push(event)) {
+            m_droppedInput.fetch_add(1, std::memory_order_relaxed);
         }
     }
 
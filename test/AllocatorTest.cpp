@@ -0,0 +1,267 @@
+/**
+ * @file        AllocatorTest.cpp
+ * @author      Robert Koch
+ * @version     1.0
+ *
+ * Test of the engine allocators: alignment, chaining and merging of the LinearArena blocks,
+ * markers and nested ScratchScopes, reuse of BlockPool blocks, and standard containers on top of
+ * the ArenaAllocator and the PoolAllocator.
+ */
+#include "../include/BlockPool.h"
+#include "../include/LinearArena.h"
+#include "../include/util/StlAllocator.h"
+#include "Test.h"
+
+#include <cstdint>
+#include <cstring>
+#include <list>
+#include <map>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+
+namespace {
+
+    using namespace Piko;
+
+    /**
+     * Function to check the alignment of a pointer.
+     *
+     * @param ptr Pointer to check.
+     * @param alignment Alignment in bytes.
+     * @return True if the pointer is aligned.
+     */
+    bool isAligned(const void* ptr, std::size_t alignment) {
+        return ((std::uintptr_t)ptr & (alignment - 1)) == 0;
+    }
+
+    /**
+     * Function to check if an allocation throws std::invalid_argument.
+     *
+     * @param blockSize Block size of the pool.
+     * @param alignment Alignment of the pool.
+     * @param chunkBlocks Blocks per chunk of the pool.
+     * @return True if the constructor threw.
+     */
+    bool isRejected(std::size_t blockSize, std::size_t alignment, std::size_t chunkBlocks) {
+
+        try {
+            BlockPool pool(blockSize, alignment, chunkBlocks);
+        }
+        catch(const std::invalid_argument&) {
+            return true;
+        }
+
+        return false;
+    }
+
+} /* Anonymous namespace */
+
+
+
+int main() {
+
+    // Arena allocations are aligned, disjoint and chained once the first block is full.
+    {
+        LinearArena arena(256);
+        std::vector<char*> blocks;
+        const std::size_t alignments[] = { 1, 8, 16, 64 };
+
+        bool isValid = true;
+        for(int i = 0; i < 64; ++i) {
+            const std::size_t alignment = alignments[i % 4];
+            char* p = static_cast<char*>(arena.allocate(24, alignment));
+            isValid &= isAligned(p, alignment);
+            std::memset(p, i, 24);
+            blocks.push_back(p);
+        }
+        PIKO_CHECK(isValid);
+
+        bool isDisjoint = true;
+        for(int i = 0; i < 64; ++i) {
+            for(int k = 0; k < 24; ++k) isDisjoint &= blocks[i][k] == (char)i;
+        }
+        PIKO_CHECK(isDisjoint);
+        PIKO_CHECK(arena.getUsed() >= 64 * 24);
+        PIKO_CHECK(arena.getCapacity() > 256);
+
+        // After the reset one merged block holds the whole peak, so the capacity stays.
+        const std::size_t peak = arena.getPeakUsed();
+        arena.reset();
+        PIKO_CHECK(arena.getUsed() == 0);
+        const std::size_t capacity = arena.getCapacity();
+        PIKO_CHECK(capacity >= peak);
+
+        arena.allocate(peak, 1);
+        PIKO_CHECK(arena.getCapacity() == capacity);
+    }
+
+    // Markers release everything allocated after them.
+    {
+        LinearArena arena(1024);
+        arena.allocate(100);
+        const LinearArena::Marker marker = arena.getMarker();
+        const std::size_t used = arena.getUsed();
+
+        void* first = arena.allocate(200);
+        arena.allocate(4000);
+        arena.rewind(marker);
+
+        PIKO_CHECK(arena.getUsed() == used);
+        PIKO_CHECK(arena.allocate(200) == first);
+
+        struct Pair { int a; double b; };
+        Pair* pair = arena.create<Pair>();
+        PIKO_CHECK(isAligned(pair, alignof(Pair)));
+        int* values = arena.allocateArray<int>(10);
+        PIKO_CHECK(isAligned(values, alignof(int)));
+    }
+
+    // The lost rest of a block counts as used, whether the next block is new or reused after a
+    // rewind. Blocks of 1024, 2048 and 4096 bytes are chained, 1000 + 24 + 1500 + 548 + 3000.
+    {
+        LinearArena arena(1024);
+        const LinearArena::Marker start = arena.getMarker();
+
+        arena.allocate(1000);
+        arena.allocate(1500);
+        arena.allocate(3000);
+        PIKO_CHECK(arena.getUsed() == 6072);
+        const std::size_t capacity = arena.getCapacity();
+        PIKO_CHECK(capacity == 1024 + 2048 + 4096);
+
+        // The same allocations reuse the blocks.
+        arena.rewind(start);
+        arena.allocate(1000);
+        arena.allocate(1500);
+        arena.allocate(3000);
+        PIKO_CHECK(arena.getUsed() == 6072);
+
+        // The second block is too small and skipped as a whole.
+        arena.rewind(start);
+        arena.allocate(1000);
+        arena.allocate(3000);
+        PIKO_CHECK(arena.getUsed() == 1024 + 2048 + 3000);
+        PIKO_CHECK(arena.getCapacity() == capacity);
+
+        bool isThrown = false;
+        try {
+            arena.allocateArray<double>((std::size_t)-1 / 4);
+        }
+        catch(const std::bad_alloc&) {
+            isThrown = true;
+        }
+        PIKO_CHECK(isThrown);
+
+        isThrown = false;
+        try {
+            arena.allocate((std::size_t)-1 - 8);
+        }
+        catch(const std::bad_alloc&) {
+            isThrown = true;
+        }
+        PIKO_CHECK(isThrown && arena.getCapacity() == capacity);
+    }
+
+    // Scratch scopes nest and release their memory, every thread has its own arena.
+    {
+        void* outer;
+        void* inner;
+        {
+            ScratchScope scope;
+            outer = scope.allocate(64);
+            {
+                ScratchScope nested;
+                inner = nested.allocate(64);
+                PIKO_CHECK(inner != outer);
+            }
+            PIKO_CHECK(scope.allocate(64) == inner);
+        }
+        {
+            ScratchScope scope;
+            PIKO_CHECK(scope.allocate(64) == outer);
+        }
+
+        LinearArena* main = &LinearArena::getThreadScratch();
+        LinearArena* other = NULL;
+        std::thread thread([&other]() { other = &LinearArena::getThreadScratch(); });
+        thread.join();
+        PIKO_CHECK(other != NULL && other != main);
+    }
+
+    // Pool blocks are aligned, reused newest first and counted.
+    {
+        PIKO_CHECK(isRejected(16, 3, 8));
+        PIKO_CHECK(isRejected(16, 8, 0));
+
+        BlockPool pool(20, 16, 4);
+        PIKO_CHECK(pool.getBlockSize() == 32);
+        PIKO_CHECK(pool.getAlignment() == 16);
+        PIKO_CHECK(pool.getCapacity() == 0);
+
+        std::vector<void*> blocks;
+        bool isValid = true;
+        for(int i = 0; i < 10; ++i) {
+            blocks.push_back(pool.allocate());
+            isValid &= isAligned(blocks.back(), 16);
+            std::memset(blocks.back(), i, pool.getBlockSize());
+        }
+        PIKO_CHECK(isValid);
+        PIKO_CHECK(pool.getAllocatedCount() == 10);
+        PIKO_CHECK(pool.getCapacity() == 12);
+
+        bool isDisjoint = true;
+        for(int i = 0; i < 10; ++i) isDisjoint &= *static_cast<char*>(blocks[i]) == (char)i;
+        PIKO_CHECK(isDisjoint);
+
+        pool.deallocate(blocks[3]);
+        pool.deallocate(blocks[7]);
+        pool.deallocate(NULL);
+        PIKO_CHECK(pool.getAllocatedCount() == 8);
+        PIKO_CHECK(pool.allocate() == blocks[7]);
+        PIKO_CHECK(pool.allocate() == blocks[3]);
+        PIKO_CHECK(pool.getCapacity() == 12);
+    }
+
+    // Standard containers on the adapters.
+    {
+        LinearArena arena(4096);
+        {
+            std::vector<int, ArenaAllocator<int>> values((ArenaAllocator<int>(arena)));
+            for(int i = 0; i < 1000; ++i) values.push_back(i);
+
+            bool isOrdered = true;
+            for(int i = 0; i < 1000; ++i) isOrdered &= values[i] == i;
+            PIKO_CHECK(isOrdered);
+            PIKO_CHECK(arena.getUsed() >= 1000 * sizeof(int));
+        }
+
+        BlockPool pool(64, 16);
+        {
+            std::list<int, PoolAllocator<int>> list((PoolAllocator<int>(pool)));
+            for(int i = 0; i < 100; ++i) list.push_back(i);
+            PIKO_CHECK(pool.getAllocatedCount() >= 100);
+
+            typedef std::pair<const int, int> Entry;
+            const PoolAllocator<Entry> allocator(pool);
+            std::map<int, int, std::less<int>, PoolAllocator<Entry>> map(std::less<int>(),
+                                                                        allocator);
+            for(int i = 0; i < 100; ++i) map[i * 7 % 100] = i;
+            PIKO_CHECK(map.size() == 100 && map.begin()->first == 0);
+
+            for(int i = 0; i < 50; ++i) map.erase(i);
+            list.clear();
+            PIKO_CHECK(pool.getAllocatedCount() >= 50 && pool.getAllocatedCount() < 100);
+        }
+        PIKO_CHECK(pool.getAllocatedCount() == 0);
+
+        // Arrays are served by the global heap, the pool only hands out single nodes.
+        PoolAllocator<int> allocator(pool);
+        int* array = allocator.allocate(100);
+        PIKO_CHECK(pool.getAllocatedCount() == 0);
+        allocator.deallocate(array, 100);
+    }
+
+    return test::finish("AllocatorTest");
+}
\ No newline at end of file
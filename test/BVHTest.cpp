@@ -0,0 +1,232 @@
+/**
+ * @file        BVHTest.cpp
+ * @author      Robert Koch
+ * @version     1.0
+ *
+ * Test of the BVH against a brute-force scan over all primitive boxes: box, sphere and ray
+ * queries have to report exactly the same primitives and raycast() the same closest hit, after a
+ * serial and a parallel build, after refit() and for degenerate sets with coinciding boxes.
+ */
+#include "../include/JobSystem.h"
+#include "../include/util/BVH.h"
+#include "Test.h"
+
+#include <algorithm>
+#include <limits>
+#include <random>
+#include <vector>
+
+
+namespace {
+
+    using namespace Piko;
+
+    /**
+     * Function to create random boxes of mixed sizes in a cube.
+     *
+     * @param count Number of boxes.
+     * @param rng Random generator.
+     * @return Boxes.
+     */
+    template<typename T>
+    std::vector<AABB<T>> createBoxes(std::size_t count, std::mt19937& rng) {
+
+        std::uniform_real_distribution<T> coordinate(T(-100), T(100));
+        std::uniform_real_distribution<T> size(T(0), T(4));
+
+        std::vector<AABB<T>> boxes(count);
+        for(std::size_t i = 0; i < count; ++i) {
+            const Vector3D<T> min(coordinate(rng), coordinate(rng), coordinate(rng));
+            const Vector3D<T> extent(size(rng), size(rng), size(rng));
+            boxes[i] = AABB<T>(min, min + extent);
+        }
+
+        return boxes;
+    }
+
+    /**
+     * Function to check that every primitive is referenced by exactly one leaf.
+     *
+     * @param bvh Hierarchy to check.
+     * @return True if the indices are a permutation of the primitives.
+     */
+    template<typename T>
+    bool isPermutation(const BVH<T>& bvh) {
+
+        std::vector<std::uint32_t> indices = bvh.getIndices();
+        std::sort(indices.begin(), indices.end());
+
+        bool isValid = indices.size() == bvh.size();
+        for(std::size_t i = 0; i < indices.size(); ++i) isValid &= indices[i] == i;
+        return isValid;
+    }
+
+    /**
+     * Function to compare the queries of a hierarchy with a brute-force scan.
+     *
+     * @param bvh Hierarchy built over the boxes.
+     * @param boxes Current boxes of the primitives.
+     * @param queries Number of random queries of each kind.
+     * @param rng Random generator.
+     */
+    template<typename T>
+    void checkQueries(const BVH<T>& bvh, const std::vector<AABB<T>>& boxes, std::size_t queries,
+                      std::mt19937& rng) {
+
+        std::uniform_real_distribution<T> coordinate(T(-120), T(120));
+        std::uniform_real_distribution<T> unit(T(-1), T(1));
+        std::uniform_real_distribution<T> size(T(0), T(30));
+
+        bool isBoxEqual = true;
+        bool isSphereEqual = true;
+        bool isRayEqual = true;
+        bool isClosestEqual = true;
+        std::vector<std::size_t> found, expected;
+
+        for(std::size_t q = 0; q < queries; ++q) {
+            const Vector3D<T> min(coordinate(rng), coordinate(rng), coordinate(rng));
+            const AABB<T> box(min, min + Vector3D<T>(size(rng), size(rng), size(rng)));
+
+            found.clear();
+            expected.clear();
+            bvh.queryBox(box, [&](std::size_t i) { found.push_back(i); });
+            for(std::size_t i = 0; i < boxes.size(); ++i) {
+                if(boxes[i].intersects(box)) expected.push_back(i);
+            }
+            std::sort(found.begin(), found.end());
+            isBoxEqual &= found == expected;
+
+            const Vector3D<T> center(coordinate(rng), coordinate(rng), coordinate(rng));
+            const T radius = size(rng);
+
+            found.clear();
+            expected.clear();
+            bvh.querySphere(center, radius, [&](std::size_t i) { found.push_back(i); });
+            for(std::size_t i = 0; i < boxes.size(); ++i) {
+                if(boxes[i].intersects(center, radius)) expected.push_back(i);
+            }
+            std::sort(found.begin(), found.end());
+            isSphereEqual &= found == expected;
+
+            // Every third ray runs along an axis, so the reciprocal direction is infinite.
+            const Vector3D<T> origin(coordinate(rng), coordinate(rng), coordinate(rng));
+            Vector3D<T> direction(unit(rng), unit(rng), unit(rng));
+            if(q % 3 == 0) direction = Vector3D<T>(T(0), T(0), q % 2 ? T(1) : T(-1));
+            const T tMax = q % 2 ? T(100) : std::numeric_limits<T>::max();
+            const Vector3D<T> inv(T(1) / direction.x(), T(1) / direction.y(),
+                                  T(1) / direction.z());
+
+            found.clear();
+            expected.clear();
+            bvh.queryRay(origin, direction, tMax, [&](std::size_t i, const T&) {
+                found.push_back(i);
+                return tMax;
+            });
+
+            T closest = std::numeric_limits<T>::max();
+            T t;
+            for(std::size_t i = 0; i < boxes.size(); ++i) {
+                if(boxes[i].intersectRay(origin, inv, tMax, t)) {
+                    expected.push_back(i);
+                    closest = std::min(closest, t);
+                }
+            }
+            std::sort(found.begin(), found.end());
+            isRayEqual &= found == expected;
+
+            std::size_t primitive = 0;
+            const bool isHit = bvh.raycast(origin, direction, tMax, primitive, t);
+            isClosestEqual &= isHit == !expected.empty();
+            if(isHit) {
+                T tHit;
+                isClosestEqual &= t == closest;
+                isClosestEqual &= boxes[primitive].intersectRay(origin, inv, tMax, tHit);
+                isClosestEqual &= tHit == closest;
+            }
+        }
+
+        PIKO_CHECK(isBoxEqual);
+        PIKO_CHECK(isSphereEqual);
+        PIKO_CHECK(isRayEqual);
+        PIKO_CHECK(isClosestEqual);
+    }
+
+    /**
+     * Function to run all checks with a coordinate type.
+     */
+    template<typename T>
+    void runChecks() {
+
+        std::mt19937 rng(42);
+
+        // Empty and single primitive hierarchies.
+        {
+            BVH<T> bvh;
+            bvh.build(NULL, 0);
+            PIKO_CHECK(bvh.size() == 0 && bvh.getNodes().empty());
+            PIKO_CHECK(bvh.getBounds().isEmpty());
+
+            std::size_t primitive;
+            T t;
+            PIKO_CHECK(!bvh.raycast(Vector3D<T>(), Vector3D<T>(T(1), T(0), T(0)), T(1),
+                                    primitive, t));
+
+            const std::vector<AABB<T>> boxes = createBoxes<T>(1, rng);
+            bvh.build(&boxes[0], 1);
+            PIKO_CHECK(bvh.size() == 1 && bvh.getNodes().size() == 1);
+            checkQueries(bvh, boxes, 100, rng);
+        }
+
+        // Serial build.
+        std::vector<AABB<T>> boxes = createBoxes<T>(5000, rng);
+        BVH<T> bvh;
+        bvh.build(&boxes[0], boxes.size());
+        PIKO_CHECK(isPermutation(bvh));
+        PIKO_CHECK(bvh.getCost() > T(0) && bvh.getCost() < T(boxes.size()));
+        checkQueries(bvh, boxes, 300, rng);
+
+        // Refit after every box moved, and after single boxes moved through setBox().
+        std::uniform_real_distribution<T> offset(T(-10), T(10));
+        for(std::size_t i = 0; i < boxes.size(); ++i) {
+            const Vector3D<T> move(offset(rng), offset(rng), offset(rng));
+            boxes[i] = AABB<T>(boxes[i].getMin() + move, boxes[i].getMax() + move);
+        }
+        bvh.refit(&boxes[0]);
+        checkQueries(bvh, boxes, 300, rng);
+
+        for(std::size_t i = 0; i < boxes.size(); i += 7) {
+            const Vector3D<T> move(offset(rng) * T(10), offset(rng), offset(rng));
+            boxes[i] = AABB<T>(boxes[i].getMin() + move, boxes[i].getMax() + move);
+            bvh.setBox(i, boxes[i]);
+        }
+        bvh.refit();
+        checkQueries(bvh, boxes, 300, rng);
+
+        // A parallel build large enough to spawn jobs has to produce a valid tree as well.
+        boxes = createBoxes<T>(4 * BVH<T>::PARALLEL_THRESHOLD, rng);
+        JobSystem jobs(3);
+        bvh.build(&boxes[0], boxes.size(), &jobs);
+        PIKO_CHECK(isPermutation(bvh));
+        checkQueries(bvh, boxes, 50, rng);
+
+        // Coinciding boxes cannot be split by their centroids.
+        boxes.assign(1000, AABB<T>(Vector3D<T>(T(1), T(2), T(3)), Vector3D<T>(T(2), T(3), T(4))));
+        bvh.build(&boxes[0], boxes.size());
+        PIKO_CHECK(isPermutation(bvh));
+        checkQueries(bvh, boxes, 50, rng);
+
+        bvh.clear();
+        PIKO_CHECK(bvh.size() == 0 && bvh.getNodes().empty());
+    }
+
+} /* Anonymous namespace */
+
+
+
+int main() {
+
+    runChecks<float>();
+    runChecks<double>();
+
+    return test::finish("BVHTest");
+}
\ No newline at end of file
@@ -0,0 +1,166 @@
+/**
+ * @file        FrustumCullerTest.cpp
+ * @author      Robert Koch
+ * @version     1.0
+ *
+ * Test of the FrustumCuller against the scalar Frustum::isVisible(): the SIMD passes, serial and
+ * parallel, have to return exactly the indices of the volumes the scalar test keeps, in
+ * ascending order. The volumes are placed around the frustum planes, and their counts are no
+ * multiple of the pack size, so the tails of the streams are covered as well.
+ */
+#include "../include/FrustumCuller.h"
+#include "../include/JobSystem.h"
+#include "../include/util/Matrix4x4.h"
+#include "Test.h"
+
+#include <random>
+#include <utility>
+#include <vector>
+
+
+namespace {
+
+    using namespace Piko;
+
+    /**
+     * Function to compare all culling passes with the scalar test.
+     *
+     * @param culler Culler holding the volumes.
+     * @param spheres Spheres added to the culler as center and radius.
+     * @param boxes Boxes added to the culler.
+     * @param frustum Frustum to test against.
+     * @param jobs Job system of the parallel passes.
+     */
+    void checkCulling(const FrustumCuller& culler,
+                      const std::vector<std::pair<Vector3D<float>, float>>& spheres,
+                      const std::vector<AABB<float>>& boxes, const Frustum<float>& frustum,
+                      JobSystem& jobs) {
+
+        std::vector<std::uint32_t> expected, visible;
+
+        for(std::size_t i = 0; i < spheres.size(); ++i) {
+            if(frustum.isVisible(spheres[i].first, spheres[i].second)) {
+                expected.push_back((std::uint32_t)i);
+            }
+        }
+
+        PIKO_CHECK(culler.cullSpheres(frustum, visible) == expected.size());
+        PIKO_CHECK(visible == expected);
+        PIKO_CHECK(culler.cullSpheres(jobs, frustum, visible) == expected.size());
+        PIKO_CHECK(visible == expected);
+
+        expected.clear();
+        for(std::size_t i = 0; i < boxes.size(); ++i) {
+            if(frustum.isVisible(boxes[i])) expected.push_back((std::uint32_t)i);
+        }
+
+        PIKO_CHECK(culler.cullBoxes(frustum, visible) == expected.size());
+        PIKO_CHECK(visible == expected);
+        PIKO_CHECK(culler.cullBoxes(jobs, frustum, visible) == expected.size());
+        PIKO_CHECK(visible == expected);
+    }
+
+    /**
+     * Function to create random spheres and boxes around the frustums of the test and add them
+     * to a culler.
+     *
+     * @param count Number of spheres and of boxes.
+     * @param rng Random generator.
+     * @param culler Culler receiving the volumes.
+     * @param spheres Receives the spheres as center and radius.
+     * @param boxes Receives the boxes.
+     */
+    void createVolumes(std::size_t count, std::mt19937& rng, FrustumCuller& culler,
+                       std::vector<std::pair<Vector3D<float>, float>>& spheres,
+                       std::vector<AABB<float>>& boxes) {
+
+        std::uniform_real_distribution<float> coordinate(-120.0f, 120.0f);
+        std::uniform_real_distribution<float> size(0.0f, 5.0f);
+
+        for(std::size_t i = 0; i < count; ++i) {
+            const Vector3D<float> center(coordinate(rng), coordinate(rng), coordinate(rng));
+            spheres.push_back(std::make_pair(center, size(rng)));
+            culler.addSphere(spheres.back().first, spheres.back().second);
+
+            const Vector3D<float> min(coordinate(rng), coordinate(rng), coordinate(rng));
+            boxes.push_back(AABB<float>(min, min + Vector3D<float>(size(rng), size(rng),
+                                                                   size(rng))));
+            culler.addBox(boxes.back());
+        }
+    }
+
+} /* Anonymous namespace */
+
+
+
+int main() {
+
+    // A frustum with axis-aligned planes around the unit cube: volumes touching a plane are
+    // visible, volumes just behind it are not.
+    {
+        Frustum<float> frustum;
+        frustum.setPlane(Frustum<float>::PLANE_LEFT, Vector3D<float>(1.0f, 0.0f, 0.0f), 1.0f);
+        frustum.setPlane(Frustum<float>::PLANE_RIGHT, Vector3D<float>(-1.0f, 0.0f, 0.0f), 1.0f);
+        frustum.setPlane(Frustum<float>::PLANE_BOTTOM, Vector3D<float>(0.0f, 1.0f, 0.0f), 1.0f);
+        frustum.setPlane(Frustum<float>::PLANE_TOP, Vector3D<float>(0.0f, -1.0f, 0.0f), 1.0f);
+        frustum.setPlane(Frustum<float>::PLANE_NEAR, Vector3D<float>(0.0f, 0.0f, 1.0f), 1.0f);
+        frustum.setPlane(Frustum<float>::PLANE_FAR, Vector3D<float>(0.0f, 0.0f, -1.0f), 1.0f);
+
+        FrustumCuller culler;
+        for(int i = 0; i < 11; ++i) {
+            const float x = i % 2 ? 2.0f : 2.5f;
+            const float z = i % 2 ? -1.0f : -1.5f;
+            culler.addSphere(Vector3D<float>(x, 0.0f, 0.0f), 1.0f);
+            culler.addBox(AABB<float>(Vector3D<float>(0.0f, 0.0f, z - 2.0f),
+                                      Vector3D<float>(1.0f, 1.0f, z)));
+        }
+        PIKO_CHECK(culler.getSphereCount() == 11 && culler.getBoxCount() == 11);
+
+        std::vector<std::uint32_t> visible;
+        PIKO_CHECK(culler.cullSpheres(frustum, visible) == 5);
+        PIKO_CHECK(visible.size() == 5 && visible[0] == 1 && visible[4] == 9);
+        PIKO_CHECK(culler.cullBoxes(frustum, visible) == 5);
+        PIKO_CHECK(visible.size() == 5 && visible[0] == 1 && visible[4] == 9);
+
+        culler.setSphere(0, Vector3D<float>(), 0.0f);
+        culler.setBox(10, AABB<float>(Vector3D<float>(-5.0f, -5.0f, -5.0f),
+                                       Vector3D<float>(5.0f, 5.0f, 5.0f)));
+        PIKO_CHECK(culler.cullSpheres(frustum, visible) == 6 && visible[0] == 0);
+        PIKO_CHECK(culler.cullBoxes(frustum, visible) == 6 && visible[5] == 10);
+
+        culler.clear();
+        PIKO_CHECK(culler.cullSpheres(frustum, visible) == 0 && visible.empty());
+        PIKO_CHECK(culler.cullBoxes(frustum, visible) == 0 && visible.empty());
+    }
+
+    // Random volumes against perspective frustums, with and without worker threads. The
+    // parallel passes cover several chunks.
+    const std::size_t counts[] = { 0, 1, 7, 1001, 3 * FrustumCuller::CHUNK_SIZE + 5 };
+    const std::size_t workerCounts[] = { 0, 3 };
+
+    for(std::size_t w = 0; w < 2; ++w) {
+        JobSystem jobs(workerCounts[w]);
+
+        for(std::size_t n = 0; n < sizeof(counts) / sizeof(counts[0]); ++n) {
+            FrustumCuller culler;
+            std::vector<std::pair<Vector3D<float>, float>> spheres;
+            std::vector<AABB<float>> boxes;
+            std::mt19937 rng((unsigned)(n + 1));
+            createVolumes(counts[n], rng, culler, spheres, boxes);
+
+            const Matrix4x4<float> projection =
+                Matrix4x4<float>::perspective(1.0f, 16.0f / 9.0f, 0.5f, 100.0f);
+
+            for(int v = 0; v < 4; ++v) {
+                const Vector3D<float> eye(10.0f * v, 5.0f, -20.0f * v);
+                const Vector3D<float> center(0.0f, 0.0f, 10.0f * (v % 2));
+                const Matrix4x4<float> view =
+                    Matrix4x4<float>::lookAt(eye, center, Vector3D<float>(0.0f, 1.0f, 0.0f));
+
+                checkCulling(culler, spheres, boxes, Frustum<float>(projection * view), jobs);
+            }
+        }
+    }
+
+    return test::finish("FrustumCullerTest");
+}
\ No newline at end of file
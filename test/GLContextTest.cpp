@@ -0,0 +1,178 @@
+/**
+ * @file        GLContextTest.cpp
+ * @author      Robert Koch
+ * @version     1.0
+ *
+ * Test of the offscreen GLContext: rendered frames have to be read back, and disposing one of
+ * several contexts or the parent of a shared context must not break the others, and the GPU
+ * timer has to report nested passes. Skipped if no EGL display is available.
+ */
+#include "../include/GLContext.h"
+#include "Test.h"
+
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+
+namespace {
+
+    using namespace Piko;
+
+    /**
+     * Function to clear the color buffer of the current context.
+     *
+     * @param r Red intensity.
+     * @param g Green intensity.
+     * @param b Blue intensity.
+     */
+    void clear(float r, float g, float b) {
+
+        glClearColor(r, g, b, 1.0f);
+        glClear(GL_COLOR_BUFFER_BIT);
+    }
+
+    /**
+     * Function to check if every pixel of a context has the same color.
+     *
+     * @param context Current context.
+     * @param r Red byte.
+     * @param g Green byte.
+     * @param b Blue byte.
+     * @return True if all pixels have the color.
+     */
+    bool isFilled(const GLContext& context, int r, int g, int b) {
+
+        std::vector<unsigned char> pixels;
+        context.readPixels(pixels);
+
+        bool isValid = pixels.size() == (std::size_t)context.getWidth() * context.getHeight() * 4;
+        for(std::size_t i = 0; isValid && i < pixels.size(); i += 4) {
+            isValid &= pixels[i] == r && pixels[i + 1] == g && pixels[i + 2] == b;
+        }
+        return isValid;
+    }
+
+} /* Anonymous namespace */
+
+
+
+int main() {
+
+    GLContext context;
+    const Result<> result = context.tryInitOffscreen(32, 16);
+
+    if(!result) {
+        std::cerr << "GLContextTest: skipped, " << result.error().str() << "\n";
+        return 0;
+    }
+
+    // Size, granted configuration and the frames rendered into the pbuffer.
+    {
+        PIKO_CHECK(context.isOffscreen());
+        PIKO_CHECK(context.getWidth() == 32 && context.getHeight() == 16);
+
+        const ContextConfig granted = context.getGrantedConfig();
+        PIKO_CHECK(granted.majorVersion >= 1 && granted.format.redBits >= 8);
+        PIKO_CHECK(context.getExtensions().majorVersion == granted.majorVersion);
+
+        int frames = 0;
+        context.renderFrames(3, [&frames](int frame) {
+            clear(frame == 2 ? 1.0f : 0.0f, 0.0f, 1.0f);
+            ++frames;
+        });
+        PIKO_CHECK(frames == 3);
+        PIKO_CHECK(isFilled(context, 255, 0, 255));
+    }
+
+    // Disposing a context keeps the display alive for the others.
+    {
+        GLContext other;
+        other.initOffscreen(8, 8);
+        other.dispose();
+        PIKO_CHECK(other.getWidth() == 0 && !other.isOffscreen());
+
+        context.makeCurrent();
+        clear(0.0f, 1.0f, 0.0f);
+        PIKO_CHECK(isFilled(context, 0, 255, 0));
+    }
+
+    // Objects of a shared context are visible in the parent, and the shared context outlives
+    // its parent.
+    {
+        GLContext parent;
+        parent.initOffscreen(4, 4);
+        std::unique_ptr<GLContext> shared = parent.createSharedContext();
+        const GLExtensions& gl = parent.getExtensions();
+
+        GLuint texture = 0;
+        shared->makeCurrent();
+        glGenTextures(1, &texture);
+        glBindTexture(GL_TEXTURE_2D, texture);
+        const unsigned char texel[4] = { 10, 20, 30, 40 };
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, 1, 1, 0, GL_RGBA, GL_UNSIGNED_BYTE, texel);
+        glFinish();
+        shared->doneCurrent();
+
+        parent.makeCurrent();
+        unsigned char read[4] = { 0, 0, 0, 0 };
+        glBindTexture(GL_TEXTURE_2D, texture);
+        glGetTexImage(GL_TEXTURE_2D, 0, GL_RGBA, GL_UNSIGNED_BYTE, read);
+        PIKO_CHECK(glIsTexture(texture) && read[0] == 10 && read[3] == 40);
+        PIKO_CHECK(shared->getExtensions().hasBufferObjects == gl.hasBufferObjects);
+
+        parent.dispose();
+        shared->makeCurrent();
+        PIKO_CHECK(glIsTexture(texture) && glGetError() == GL_NO_ERROR);
+        glDeleteTextures(1, &texture);
+        shared->dispose();
+
+        context.makeCurrent();
+        clear(1.0f, 1.0f, 0.0f);
+        PIKO_CHECK(isFilled(context, 255, 255, 0));
+    }
+
+    // Nested passes are reported a few frames late, in the order they were begun.
+    {
+        GPUTimer& timer = context.getGPUTimer();
+        PIKO_CHECK(timer.isSupported() == context.getExtensions().hasTimerQuery);
+
+        if(timer.isSupported()) {
+            const std::uint64_t first = timer.getFrameNumber();
+            const int frameCount = 2 * (int)GPUTimer::FRAME_LATENCY;
+
+            context.renderFrames(frameCount, [&timer](int frame) {
+                GPUPassScope scene(timer, "scene");
+                {
+                    GPUPassScope pass(timer, "clear");
+                    clear(0.0f, 0.0f, frame * 0.1f);
+                }
+                glFinish();
+            });
+
+            const std::vector<GPUPassTiming>& results = timer.getResults();
+            PIKO_CHECK(timer.getFrameNumber() == first + frameCount);
+            PIKO_CHECK(timer.getResultFrameNumber() >= first);
+            PIKO_CHECK(timer.getResultFrameNumber() < timer.getFrameNumber());
+            PIKO_CHECK(timer.getDroppedFrameCount() == 0);
+            PIKO_CHECK(results.size() == 2);
+
+            if(results.size() == 2) {
+                PIKO_CHECK(std::strcmp(results[0].name, "scene") == 0 && results[0].depth == 0);
+                PIKO_CHECK(std::strcmp(results[1].name, "clear") == 0 && results[1].depth == 1);
+                PIKO_CHECK(results[0].ms >= results[1].ms && results[1].ms >= 0.0);
+            }
+
+            // A pass left open ends with the frame.
+            timer.beginPass("open");
+            context.swapBuffers();
+            glFinish();
+            context.swapBuffers();
+            PIKO_CHECK(results.size() == 1 && std::strcmp(results[0].name, "open") == 0);
+        }
+    }
+
+    context.dispose();
+    return test::finish("GLContextTest");
+}
\ No newline at end of file
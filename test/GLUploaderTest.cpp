@@ -0,0 +1,168 @@
+/**
+ * @file        GLUploaderTest.cpp
+ * @author      Robert Koch
+ * @version     1.0
+ *
+ * Test of the GLUploader on an offscreen context: buffers and textures uploaded by the workers
+ * have to be readable in the rendering context, every callback has to run exactly once on the
+ * polling thread, failed uploads have to report 0, and the destructor has to execute the queued
+ * uploads. Skipped if no EGL display is available.
+ */
+#include "../include/GLUploader.h"
+#include "Test.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+
+namespace {
+
+    using namespace Piko;
+
+    /**
+     * Function to poll an uploader until all uploads are passed on.
+     *
+     * @param uploader Uploader to poll.
+     * @return Number of callbacks invoked.
+     */
+    std::size_t pollAll(GLUploader& uploader) {
+
+        const std::chrono::steady_clock::time_point end =
+            std::chrono::steady_clock::now() + std::chrono::seconds(30);
+
+        std::size_t ready = 0;
+        while(uploader.getPendingCount() > 0 && std::chrono::steady_clock::now() < end) {
+            ready += uploader.poll();
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        return ready;
+    }
+
+} /* Anonymous namespace */
+
+
+
+int main() {
+
+    GLContext context;
+    const Result<> result = context.tryInitOffscreen(1, 1);
+
+    if(!result) {
+        std::cerr << "GLUploaderTest: skipped, " << result.error().str() << "\n";
+        return 0;
+    }
+
+    const GLExtensions& gl = context.getExtensions();
+    const std::thread::id mainThreadId = std::this_thread::get_id();
+
+    // Buffers, textures and failed uploads arrive on the polling thread.
+    {
+        GLUploader uploader(context, 2);
+
+        std::vector<unsigned char> data(1000);
+        for(std::size_t i = 0; i < data.size(); ++i) data[i] = (unsigned char)(i * 7);
+        std::vector<unsigned char> pixels(4 * 4 * 4);
+        for(std::size_t i = 0; i < pixels.size(); ++i) pixels[i] = (unsigned char)(255 - i);
+
+        GLuint buffer = 0;
+        GLuint texture = 0;
+        GLuint failed = 1;
+        GLuint thrown = 1;
+        bool isPollingThread = true;
+
+        uploader.uploadBuffer(GL_ARRAY_BUFFER, data, GL_STATIC_DRAW, [&](GLuint name) {
+            buffer = name;
+            isPollingThread &= std::this_thread::get_id() == mainThreadId;
+        });
+        uploader.uploadTexture2D(GL_RGBA8, 4, 4, GL_RGBA, GL_UNSIGNED_BYTE, pixels,
+                                 [&](GLuint name) {
+            texture = name;
+            isPollingThread &= std::this_thread::get_id() == mainThreadId;
+        });
+        uploader.upload([](const GLExtensions&) { return (GLuint)0; },
+                        [&failed](GLuint name) { failed = name; });
+        uploader.upload([](const GLExtensions&) -> GLuint {
+                            throw std::runtime_error("Upload failed.");
+                        },
+                        [&thrown](GLuint name) { thrown = name; });
+
+        PIKO_CHECK(uploader.getPendingCount() == 4);
+        PIKO_CHECK(pollAll(uploader) == 4);
+        PIKO_CHECK(uploader.getPendingCount() == 0 && uploader.poll() == 0);
+        PIKO_CHECK(isPollingThread);
+        PIKO_CHECK(failed == 0 && thrown == 0);
+
+        PIKO_CHECK(buffer != 0);
+        if(buffer) {
+            gl.glBindBuffer(GL_ARRAY_BUFFER, buffer);
+            const void* mapped = gl.hasMapBufferRange ?
+                gl.glMapBufferRange(GL_ARRAY_BUFFER, 0, (GLsizeiptr)data.size(),
+                                    GL_MAP_READ_BIT) : NULL;
+            PIKO_CHECK(!gl.hasMapBufferRange ||
+                       (mapped && std::memcmp(mapped, &data[0], data.size()) == 0));
+            if(mapped) gl.glUnmapBuffer(GL_ARRAY_BUFFER);
+            gl.glBindBuffer(GL_ARRAY_BUFFER, 0);
+            gl.glDeleteBuffers(1, &buffer);
+        }
+
+        PIKO_CHECK(texture != 0);
+        if(texture) {
+            std::vector<unsigned char> read(pixels.size());
+            glBindTexture(GL_TEXTURE_2D, texture);
+            glGetTexImage(GL_TEXTURE_2D, 0, GL_RGBA, GL_UNSIGNED_BYTE, &read[0]);
+            PIKO_CHECK(read == pixels);
+            glBindTexture(GL_TEXTURE_2D, 0);
+            glDeleteTextures(1, &texture);
+        }
+    }
+
+    // Many uploads from several workers, every callback runs exactly once.
+    {
+        GLUploader uploader(context, 3);
+        std::vector<int> calls(64, 0);
+        std::vector<GLuint> names(calls.size(), 0);
+
+        for(std::size_t i = 0; i < calls.size(); ++i) {
+            uploader.uploadBuffer(GL_ARRAY_BUFFER, std::vector<unsigned char>(i + 1, 1),
+                                  GL_STATIC_DRAW, [&calls, &names, i](GLuint name) {
+                ++calls[i];
+                names[i] = name;
+            });
+        }
+        pollAll(uploader);
+
+        bool isValid = true;
+        for(std::size_t i = 0; i < calls.size(); ++i) {
+            isValid &= calls[i] == 1 && names[i] != 0;
+            for(std::size_t k = 0; k < i; ++k) isValid &= names[k] != names[i];
+        }
+        PIKO_CHECK(isValid);
+        gl.glDeleteBuffers((GLsizei)names.size(), &names[0]);
+    }
+
+    // Uploads still queued at the destruction are executed but never passed on.
+    {
+        std::atomic<int> executed(0);
+        int passed = 0;
+        {
+            GLUploader uploader(context, 1);
+            for(int i = 0; i < 10; ++i) {
+                uploader.upload([&executed](const GLExtensions&) {
+                                    ++executed;
+                                    return (GLuint)0;
+                                },
+                                [&passed](GLuint) { ++passed; });
+            }
+        }
+        PIKO_CHECK(executed == 10 && passed == 0);
+    }
+
+    PIKO_CHECK(glGetError() == GL_NO_ERROR);
+
+    context.dispose();
+    return test::finish("GLUploaderTest");
+}
\ No newline at end of file
@@ -0,0 +1,161 @@
+/**
+ * @file        InputRingTest.cpp
+ * @author      Robert Koch
+ * @version     1.0
+ *
+ * Test of the SPSCRing and of the input events a WindowBase records into it: ordering, full and
+ * empty rings, batched pops across the wrap-around, a producer and a consumer thread running
+ * against each other, and the decoding of key, mouse, resize and focus messages.
+ */
+#include "../include/HeadlessWindowBackend.h"
+#include "../include/WindowBase.h"
+#include "../include/util/SPSCRing.h"
+#include "Test.h"
+
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+
+
+namespace {
+
+    using namespace Piko;
+
+    /**
+     * Function to pack two 16 bit words into a message parameter.
+     *
+     * @param low Low word, e.g. the x-coordinate.
+     * @param high High word, e.g. the y-coordinate.
+     * @return Message parameter.
+     */
+    LPARAM pack(int low, int high) {
+        return (LPARAM)(((std::uint32_t)(high & 0xFFFF) << 16) | (std::uint32_t)(low & 0xFFFF));
+    }
+
+} /* Anonymous namespace */
+
+
+
+int main() {
+
+    // Ordering, full and empty rings.
+    {
+        SPSCRing<int> ring(5);
+        PIKO_CHECK(ring.capacity() == 8);
+        PIKO_CHECK(ring.empty());
+
+        int value = -1;
+        PIKO_CHECK(!ring.pop(value));
+
+        for(int i = 0; i < 8; ++i) PIKO_CHECK(ring.push(i));
+        PIKO_CHECK(!ring.push(8));
+        PIKO_CHECK(ring.size() == 8);
+
+        PIKO_CHECK(ring.pop(value) && value == 0);
+        PIKO_CHECK(ring.push(8));
+
+        // Batches wrap around the end of the buffer.
+        int values[16];
+        PIKO_CHECK(ring.pop(values, 16) == 8);
+        bool isOrdered = true;
+        for(int i = 0; i < 8; ++i) isOrdered &= values[i] == i + 1;
+        PIKO_CHECK(isOrdered);
+        PIKO_CHECK(ring.empty());
+        PIKO_CHECK(ring.pop(values, 16) == 0);
+    }
+
+    // A producer and a consumer thread, every value has to arrive once and in order.
+    {
+        const std::uint32_t count = 1000000;
+        SPSCRing<std::uint32_t> ring(1024);
+
+        std::thread producer([&ring, count]() {
+            for(std::uint32_t i = 0; i < count; ) {
+                if(ring.push(i)) ++i;
+                else std::this_thread::yield();
+            }
+        });
+
+        std::uint32_t expected = 0;
+        bool isOrdered = true;
+        std::uint32_t values[256];
+
+        while(expected < count) {
+            const std::size_t taken = ring.pop(values, 1 + expected % 256);
+            if(taken == 0) std::this_thread::yield();
+            for(std::size_t i = 0; i < taken; ++i) isOrdered &= values[i] == expected++;
+        }
+
+        producer.join();
+        PIKO_CHECK(isOrdered);
+        PIKO_CHECK(ring.empty());
+    }
+
+    // Messages are recorded as compact, timestamped events.
+    {
+        HeadlessWindowBackend* backend = new HeadlessWindowBackend(1600, 900);
+        WindowBase window(std::unique_ptr<WindowBackend>(backend), "Test", 640, 480);
+
+        const std::uint64_t before = InputEvent::now();
+
+        backend->postMessage(WM_KEYDOWN, 'W', (LPARAM)1 << 30);
+        backend->postMessage(WM_KEYUP, 'W', (LPARAM)1 << 30);
+        backend->postMessage(WM_MOUSEMOVE, 0, pack(-5, 300));
+        backend->postMessage(WM_RBUTTONDOWN, 0, pack(10, 20));
+        backend->postMessage(WM_MBUTTONUP, 0, pack(11, 21));
+        backend->postMessage(WM_MOUSEWHEEL, (WPARAM)(std::uint16_t)-120 << 16, pack(1, 2));
+        backend->postMessage(WM_SIZE, 0, pack(1280, 720));
+        backend->postMessage(WM_KILLFOCUS);
+        backend->postMessage(WM_SETFOCUS);
+        backend->postMessage(WM_CLOSE);
+        PIKO_CHECK(backend->processMessages() == 10);
+
+        InputEvent events[16];
+        PIKO_CHECK(window.pollInput(events, 16) == 9);
+
+        PIKO_CHECK(events[0].type == InputEventType::KEY_DOWN);
+        PIKO_CHECK(events[0].key.code == 'W' && events[0].key.repeat == 1);
+        PIKO_CHECK(events[1].type == InputEventType::KEY_UP && events[1].key.repeat == 0);
+        PIKO_CHECK(events[2].type == InputEventType::MOUSE_MOVE);
+        PIKO_CHECK(events[2].mouse.x == -5 && events[2].mouse.y == 300);
+        PIKO_CHECK(events[3].type == InputEventType::MOUSE_BUTTON_DOWN);
+        PIKO_CHECK(events[3].mouse.button == MouseButton::RIGHT && events[3].mouse.x == 10);
+        PIKO_CHECK(events[4].type == InputEventType::MOUSE_BUTTON_UP);
+        PIKO_CHECK(events[4].mouse.button == MouseButton::MIDDLE && events[4].mouse.y == 21);
+        PIKO_CHECK(events[5].type == InputEventType::MOUSE_WHEEL);
+        PIKO_CHECK(events[5].mouse.wheel == -120);
+        PIKO_CHECK(events[6].type == InputEventType::RESIZE);
+        PIKO_CHECK(events[6].resize.width == 1280 && events[6].resize.height == 720);
+        PIKO_CHECK(events[7].type == InputEventType::FOCUS_LOST);
+        PIKO_CHECK(events[8].type == InputEventType::FOCUS_GAINED);
+
+        bool isTimed = true;
+        for(int i = 0; i < 9; ++i) {
+            isTimed &= events[i].timestamp >= before;
+            if(i > 0) isTimed &= events[i].timestamp >= events[i - 1].timestamp;
+        }
+        PIKO_CHECK(isTimed);
+        PIKO_CHECK(window.getDroppedInputCount() == 0);
+    }
+
+    // A full ring drops the newest events and counts them.
+    {
+        HeadlessWindowBackend* backend = new HeadlessWindowBackend(1600, 900);
+        WindowBase window(std::unique_ptr<WindowBackend>(backend), "Test", 640, 480);
+
+        const std::size_t extra = 10;
+        for(std::size_t i = 0; i < WindowBase::INPUT_CAPACITY + extra; ++i) {
+            backend->postMessage(WM_KEYDOWN, 'A' + i % 26);
+        }
+        backend->processMessages();
+
+        PIKO_CHECK(window.getDroppedInputCount() == extra);
+
+        std::vector<InputEvent> events(WindowBase::INPUT_CAPACITY + extra);
+        PIKO_CHECK(window.pollInput(&events[0], events.size()) == WindowBase::INPUT_CAPACITY);
+        PIKO_CHECK(events[0].key.code == 'A' && events[26].key.code == 'A');
+    }
+
+    return test::finish("InputRingTest");
+}
\ No newline at end of file
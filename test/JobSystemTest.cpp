@@ -0,0 +1,150 @@
+/**
+ * @file        JobSystemTest.cpp
+ * @author      Robert Koch
+ * @version     1.0
+ *
+ * Test of the JobSystem: parallelFor() has to visit every index exactly once, and an exception
+ * of a job has to be rethrown by wait() on the counter of that job only, never by a wait() on
+ * another counter. Runs with and without worker threads.
+ */
+#include "../include/JobSystem.h"
+#include "Test.h"
+
+#include <atomic>
+#include <stdexcept>
+#include <vector>
+
+
+namespace {
+
+    using namespace Piko;
+
+    /**
+     * Function to wait for a counter.
+     *
+     * @param jobs System running the jobs.
+     * @param counter Counter to wait for.
+     * @return True if wait() threw, otherwise false.
+     */
+    bool waitThrows(JobSystem& jobs, const JobCounter& counter) {
+
+        try {
+            jobs.wait(counter);
+        }
+        catch(const std::runtime_error&) {
+            return true;
+        }
+
+        return false;
+    }
+
+    /**
+     * Function to run all checks with a number of workers.
+     *
+     * @param workerCount Number of worker threads.
+     */
+    void runChecks(std::size_t workerCount) {
+
+        JobSystem jobs(workerCount);
+
+        const auto nothing = []() { };
+        const auto fail = []() { throw std::runtime_error("Job failed."); };
+
+        // Every index is visited exactly once.
+        std::vector<std::atomic<int>> visits(100000);
+        for(std::size_t i = 0; i < visits.size(); ++i) visits[i] = 0;
+        jobs.parallelFor(0, visits.size(), 64, [&](std::size_t begin, std::size_t end) {
+            for(std::size_t i = begin; i < end; ++i) visits[i].fetch_add(1);
+        });
+
+        bool isVisitedOnce = true;
+        for(std::size_t i = 0; i < visits.size(); ++i) isVisitedOnce &= visits[i] == 1;
+        PIKO_CHECK(isVisitedOnce);
+
+        // The error of b belongs to b, waiting for a is not affected.
+        {
+            JobCounter a, b;
+            jobs.run(nothing, a);
+            jobs.run(fail, b);
+            PIKO_CHECK(!waitThrows(jobs, a));
+            PIKO_CHECK(waitThrows(jobs, b));
+            PIKO_CHECK(!waitThrows(jobs, b));
+        }
+
+        // The same the other way round, b is waited for first.
+        {
+            JobCounter a, b;
+            jobs.run(fail, a);
+            jobs.run(nothing, b);
+            PIKO_CHECK(!waitThrows(jobs, b));
+            PIKO_CHECK(waitThrows(jobs, a));
+        }
+
+        // Several failing jobs of one counter are reported once.
+        {
+            JobCounter a;
+            for(int i = 0; i < 16; ++i) jobs.run(fail, a);
+            PIKO_CHECK(waitThrows(jobs, a));
+            PIKO_CHECK(!waitThrows(jobs, a));
+        }
+
+        // A job failing on an inner counter fails its own job when that one waits for it.
+        {
+            JobCounter outer, other;
+            const auto nested = [&]() {
+                JobCounter inner;
+                jobs.run(fail, inner);
+                jobs.wait(inner);
+            };
+            jobs.run(nested, outer);
+            jobs.run(nothing, other);
+            PIKO_CHECK(!waitThrows(jobs, other));
+            PIKO_CHECK(waitThrows(jobs, outer));
+        }
+
+        // fork() runs both callables and rethrows the failure of either one.
+        int forked = 0;
+        jobs.fork([&forked]() { forked |= 1; }, [&forked]() { forked |= 2; });
+        PIKO_CHECK(forked == 3);
+
+        for(int failing = 0; failing < 2; ++failing) {
+            bool hasForkThrown = false;
+            try {
+                jobs.fork([failing]() { if(failing == 0) throw std::runtime_error("First."); },
+                          [failing]() { if(failing == 1) throw std::runtime_error("Second."); });
+            }
+            catch(const std::runtime_error&) {
+                hasForkThrown = true;
+            }
+            PIKO_CHECK(hasForkThrown);
+        }
+
+        // A failing loop throws from parallelFor() and leaves the system usable.
+        bool hasThrown = false;
+        try {
+            jobs.parallelFor(0, 1000, 10, [](std::size_t begin, std::size_t) {
+                if(begin == 500) throw std::runtime_error("Body failed.");
+            });
+        }
+        catch(const std::runtime_error&) {
+            hasThrown = true;
+        }
+        PIKO_CHECK(hasThrown);
+
+        JobCounter after;
+        jobs.run(nothing, after);
+        PIKO_CHECK(!waitThrows(jobs, after));
+    }
+
+} /* Anonymous namespace */
+
+
+
+int main() {
+
+    runChecks(0);
+    runChecks(1);
+    runChecks(3);
+
+    return test::finish("JobSystemTest");
+}
\ No newline at end of file
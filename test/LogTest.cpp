@@ -0,0 +1,254 @@
+/**
+ * @file        LogTest.cpp
+ * @author      Robert Koch
+ * @version     1.0
+ *
+ * Test of the asynchronous Log: every argument type has to replace its {} placeholder, string
+ * arguments have to be truncated to the text capacity of a record, flush() has to write every
+ * message captured before in the order of its thread, and each message which does not fit into
+ * a full buffer has to be counted and reported instead of written.
+ */
+#include "../include/Log.h"
+#include "Test.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+
+namespace {
+
+    using namespace Piko;
+
+    enum class Color {
+        RED,
+        GREEN,
+        BLUE
+    };
+
+    /**
+     * Function to take the lines written to a stream so far.
+     *
+     * @param stream Stream the log writes to, is cleared.
+     * @param messages Receives the text of each message, without time, level and thread.
+     * @param dropped Receives the sum of the reported drop counts, if not NULL.
+     * @return Lines including the prefix.
+     */
+    std::vector<std::string> takeLines(std::ostringstream& stream,
+                                       std::vector<std::string>& messages,
+                                       std::size_t* dropped = NULL) {
+
+        std::vector<std::string> lines;
+        std::istringstream input(stream.str());
+        stream.str("");
+        messages.clear();
+        if(dropped) *dropped = 0;
+
+        std::string line;
+        while(std::getline(input, line)) {
+            lines.push_back(line);
+
+            if(line.compare(0, 6, "[Log] ") == 0) {
+                if(dropped) *dropped += std::strtoul(line.c_str() + 6, NULL, 10);
+                continue;
+            }
+
+            // The prefix holds no ": ", the first one ends it.
+            const std::size_t end = line.find(": ");
+            messages.push_back(end == std::string::npos ? line : line.substr(end + 2));
+        }
+
+        return lines;
+    }
+
+    /**
+     * Function to write a message and take the text written for it.
+     *
+     * @param stream Stream the log writes to.
+     * @param format Format string.
+     * @param args Arguments.
+     * @return Text of the single written message, empty if there is none.
+     */
+    template<typename... Args>
+    std::string format(std::ostringstream& stream, const char* format, const Args&... args) {
+
+        Log::write(LogLevel::SEVERE, format, args...);
+        Log::flush();
+
+        std::vector<std::string> messages;
+        takeLines(stream, messages);
+        return messages.size() == 1 ? messages[0] : std::string();
+    }
+
+} /* Anonymous namespace */
+
+
+
+int main() {
+
+    std::ostringstream output;
+    Log::setOutput(output);
+
+    std::vector<std::string> messages;
+
+    // Each argument type replaces one placeholder.
+    {
+        char pointer[32];
+        const int value = 0;
+        std::snprintf(pointer, sizeof(pointer), "%p", (const void*)&value);
+
+        PIKO_CHECK(format(output, "no arguments") == "no arguments");
+        PIKO_CHECK(format(output, "{} {} {} {}", -5, 7u, (short)-3, (std::uint64_t)1 << 40) ==
+                   "-5 7 -3 1099511627776");
+        PIKO_CHECK(format(output, "{} {} {}", 2.5, 0.125f, -1e20) == "2.5 0.125 -1e+20");
+        PIKO_CHECK(format(output, "{} {} {}", true, false, 'x') == "true false x");
+        PIKO_CHECK(format(output, "[{}] [{}]", "text", std::string("string")) ==
+                   "[text] [string]");
+        PIKO_CHECK(format(output, "{}", (const char*)NULL) == "(null)");
+        PIKO_CHECK(format(output, "{}", Color::BLUE) == "2");
+        PIKO_CHECK(format(output, "{}", &value) == pointer);
+        PIKO_CHECK(format(output, "{}{}{}{}{}{}{}{}", 1, 2, 3, 4, 5, 6, 7, 8) == "12345678");
+    }
+
+    // Placeholders without an argument stay, arguments without a placeholder are ignored.
+    {
+        PIKO_CHECK(format(output, "{} and {}", 1) == "1 and {}");
+        PIKO_CHECK(format(output, "none", 1, 2) == "none");
+        PIKO_CHECK(format(output, "{ } {x} {{}}", 9) == "{ } {x} {9}");
+    }
+
+    // String arguments share the text of a record and are cut at its capacity.
+    {
+        const std::size_t capacity = LogRecord::TEXT_CAPACITY;
+        const std::string a(capacity + 50, 'a');
+        const std::string b(60, 'b');
+        const std::string c(60, 'c');
+
+        PIKO_CHECK(format(output, "{}", a) == std::string(capacity, 'a'));
+        PIKO_CHECK(format(output, "{}", a.c_str()) == std::string(capacity, 'a'));
+        PIKO_CHECK(format(output, "{}|{}|{}|{}", b, c, "d", 4) ==
+                   b + "|" + std::string(capacity - b.size(), 'c') + "||4");
+        PIKO_CHECK(format(output, "{}|{}", "", std::string()) == "|");
+    }
+
+    // The run time threshold filters messages, the level is written in front of them.
+    {
+        const LogLevel level = Log::getLevel();
+        PIKO_CHECK(level == (LogLevel)PIKO_LOG_LEVEL);
+        PIKO_CHECK(!Log::isEnabled(LogLevel::OFF));
+
+        Log::setLevel(LogLevel::WARNING);
+        PIKO_CHECK(Log::getLevel() == LogLevel::WARNING);
+        PIKO_CHECK(!Log::isEnabled(LogLevel::INFO) && Log::isEnabled(LogLevel::WARNING));
+
+        PIKO_LOG_TRACE("trace {}", 1);
+        PIKO_LOG_DEBUG("debug {}", 2);
+        PIKO_LOG_INFO("info {}", 3);
+        PIKO_LOG_WARNING("warning {}", 4);
+        PIKO_LOG_SEVERE("severe {}", 5);
+        Log::flush();
+
+        std::vector<std::string> lines = takeLines(output, messages);
+        PIKO_CHECK(messages.size() == 2);
+        PIKO_CHECK(lines.size() == 2 && lines[0].find("] WARNING T") != std::string::npos &&
+                   lines[1].find("] SEVERE  T") != std::string::npos);
+        PIKO_CHECK(messages.size() == 2 && messages[0] == "warning 4" &&
+                   messages[1] == "severe 5");
+
+        Log::setLevel(LogLevel::INFO);
+        PIKO_LOG_INFO("info {}", 3);
+        Log::setLevel(LogLevel::OFF);
+        PIKO_LOG_SEVERE("severe {}", 5);
+        Log::flush();
+
+        takeLines(output, messages);
+        PIKO_CHECK(messages.size() == 1 && messages[0] == "info 3");
+
+        Log::setLevel(level);
+    }
+
+    // flush() writes the messages of all threads, each thread in the order it logged them.
+    {
+        const int threadCount = 4;
+        const std::size_t messageCount = 500;
+        std::vector<std::thread> threads;
+
+        for(int t = 0; t < threadCount; ++t) {
+            threads.push_back(std::thread([t, messageCount]() {
+                for(std::size_t i = 0; i < messageCount; ++i) {
+                    Log::write(LogLevel::INFO, "{} {}", t, i);
+                }
+            }));
+        }
+        for(std::size_t t = 0; t < threads.size(); ++t) threads[t].join();
+
+        // Captured after the threads exited, their buffers are drained anyway.
+        Log::write(LogLevel::INFO, "{} {}", threadCount, 0);
+        Log::flush();
+
+        std::size_t dropped = 0;
+        takeLines(output, messages, &dropped);
+        PIKO_CHECK(dropped == 0 && messages.size() == threadCount * messageCount + 1);
+
+        std::vector<int> next(threadCount + 1, 0);
+        bool isOrdered = true;
+        for(std::size_t i = 0; i < messages.size(); ++i) {
+            int t = -1;
+            int k = -1;
+            isOrdered &= std::sscanf(messages[i].c_str(), "%d %d", &t, &k) == 2 &&
+                         t >= 0 && t <= threadCount && k == next[t]++;
+        }
+        PIKO_CHECK(isOrdered);
+        PIKO_CHECK(next[threadCount] == 1);
+    }
+
+    // Pending messages go to the previous stream when the output is replaced.
+    {
+        std::ostringstream other;
+
+        Log::write(LogLevel::INFO, "first");
+        Log::setOutput(other);
+        Log::write(LogLevel::INFO, "second");
+        Log::flush();
+        Log::setOutput(output);
+
+        takeLines(output, messages);
+        PIKO_CHECK(messages.size() == 1 && messages[0] == "first");
+        takeLines(other, messages);
+        PIKO_CHECK(messages.size() == 1 && messages[0] == "second");
+    }
+
+    // Messages not fitting into a full buffer are counted and reported, never written.
+    {
+        const std::size_t before = Log::getDroppedCount();
+        const std::size_t burst = 4 * Log::BUFFER_CAPACITY;
+        std::size_t written = 0;
+
+        // The writer drains the buffer every few milliseconds, a burst fills it much faster.
+        for(int round = 0; round < 100 && Log::getDroppedCount() == before; ++round) {
+            for(std::size_t i = 0; i < burst; ++i) Log::write(LogLevel::INFO, "{}", written++);
+        }
+        Log::flush();
+
+        const std::size_t dropped = Log::getDroppedCount() - before;
+        std::size_t reported = 0;
+        takeLines(output, messages, &reported);
+
+        PIKO_CHECK(dropped > 0);
+        PIKO_CHECK(reported == dropped);
+        PIKO_CHECK(messages.size() + dropped == written);
+
+        bool isIncreasing = true;
+        for(std::size_t i = 1; i < messages.size(); ++i) {
+            isIncreasing &= std::strtoul(messages[i - 1].c_str(), NULL, 10) <
+                            std::strtoul(messages[i].c_str(), NULL, 10);
+        }
+        PIKO_CHECK(isIncreasing);
+    }
+
+    Log::setOutput(std::cerr);
+    return test::finish("LogTest");
+}
\ No newline at end of file
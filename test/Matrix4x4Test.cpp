@@ -0,0 +1,411 @@
+/**
+ * @file        Matrix4x4Test.cpp
+ * @author      Robert Koch
+ * @version     1.0
+ *
+ * Test of Matrix4x4 and Quaternion against scalar references computed in double precision: the
+ * batch transforms in both layouts for sizes which are no multiple of the pack size, in place and
+ * out of place, the cofactor inverse, the product, rotations and the slerp with its shorter-arc
+ * flip and its linear fallback. Runs for float, which takes the SIMD paths, and double.
+ */
+#include "../include/util/Matrix4x4.h"
+#include "../include/util/Quaternion.h"
+#include "Test.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+
+namespace {
+
+    using namespace Piko;
+
+    /** Batch sizes, mostly no multiple of 4 or 8, so the scalar tails are covered. */
+    const std::size_t SIZES[] = { 0, 1, 2, 3, 4, 5, 7, 8, 9, 11, 13, 17, 31, 33, 1001 };
+
+    /**
+     * Function to check if a transformed vector matches the reference. The tolerance grows with
+     * the magnitude of the summed terms.
+     *
+     * @param m Transformation matrix.
+     * @param w Weight of the translation, 1 for points and 0 for directions.
+     * @param in Input vector.
+     * @param out Transformed vector.
+     * @return True if all coordinates match.
+     */
+    template<typename T>
+    bool isTransformed(const Matrix4x4<T>& m, double w, const Vector3D<T>& in,
+                       const Vector3D<T>& out) {
+
+        const double v[3] = { (double)in.x(), (double)in.y(), (double)in.z() };
+        const double r[3] = { (double)out.x(), (double)out.y(), (double)out.z() };
+
+        bool isValid = true;
+        for(int row = 0; row < 3; ++row) {
+            double expected = (double)m(row, 3) * w;
+            double magnitude = std::fabs(expected);
+            for(int col = 0; col < 3; ++col) {
+                expected += (double)m(row, col) * v[col];
+                magnitude += std::fabs((double)m(row, col) * v[col]);
+            }
+            const double tolerance = 8.0 * std::numeric_limits<T>::epsilon() * (1.0 + magnitude);
+            isValid &= std::fabs(r[row] - expected) <= tolerance;
+        }
+        return isValid;
+    }
+
+    /**
+     * Function to check if two matrices are equal within a tolerance.
+     *
+     * @param a First matrix.
+     * @param b Second matrix.
+     * @param tolerance Maximum absolute difference of an element.
+     * @return True if the matrices are equal.
+     */
+    template<typename T>
+    bool isClose(const Matrix4x4<T>& a, const Matrix4x4<T>& b, double tolerance) {
+
+        bool isValid = true;
+        for(int i = 0; i < 16; ++i) {
+            isValid &= std::fabs((double)a.data()[i] - (double)b.data()[i]) <= tolerance;
+        }
+        return isValid;
+    }
+
+    /**
+     * Function to check if two vectors are equal within a tolerance.
+     *
+     * @param a First vector.
+     * @param b Second vector.
+     * @param tolerance Maximum absolute difference of a coordinate.
+     * @return True if the vectors are equal.
+     */
+    template<typename T>
+    bool isClose(const Vector3D<T>& a, const Vector3D<T>& b, double tolerance) {
+
+        return std::fabs((double)a.x() - (double)b.x()) <= tolerance &&
+               std::fabs((double)a.y() - (double)b.y()) <= tolerance &&
+               std::fabs((double)a.z() - (double)b.z()) <= tolerance;
+    }
+
+    /**
+     * Function to check if two quaternions are equal within a tolerance.
+     *
+     * @param a First quaternion.
+     * @param b Second quaternion.
+     * @param tolerance Maximum absolute difference of a component.
+     * @return True if the quaternions are equal.
+     */
+    template<typename T>
+    bool isClose(const Quaternion<T>& a, const Quaternion<T>& b, double tolerance) {
+
+        return std::fabs((double)a.w() - (double)b.w()) <= tolerance &&
+               std::fabs((double)a.x() - (double)b.x()) <= tolerance &&
+               std::fabs((double)a.y() - (double)b.y()) <= tolerance &&
+               std::fabs((double)a.z() - (double)b.z()) <= tolerance;
+    }
+
+    /**
+     * Function to create a random affine matrix.
+     *
+     * @param rng Random generator.
+     * @return Matrix with random upper 3x4 part and the last row (0, 0, 0, 1).
+     */
+    template<typename T>
+    Matrix4x4<T> randomAffine(std::mt19937& rng) {
+
+        std::uniform_real_distribution<double> element(-3.0, 3.0);
+
+        Matrix4x4<T> m;
+        for(int row = 0; row < 3; ++row) {
+            for(int col = 0; col < 4; ++col) m(row, col) = (T)element(rng);
+        }
+        return m;
+    }
+
+    /**
+     * Function to create a random rotation.
+     *
+     * @param rng Random generator.
+     * @return Unit quaternion.
+     */
+    template<typename T>
+    Quaternion<T> randomRotation(std::mt19937& rng) {
+
+        std::uniform_real_distribution<double> coordinate(-1.0, 1.0);
+        Quaternion<T> q((T)coordinate(rng), (T)coordinate(rng), (T)coordinate(rng),
+                        (T)coordinate(rng));
+        q.normalize();
+        return q;
+    }
+
+    /**
+     * Function to interpolate spherically in double precision with explicit branches.
+     *
+     * @param a Rotation at t = 0.
+     * @param b Rotation at t = 1.
+     * @param t Interpolation parameter.
+     * @return Interpolated unit quaternion.
+     */
+    template<typename T>
+    Quaternion<T> slerpReference(const Quaternion<T>& a, const Quaternion<T>& b, double t) {
+
+        double qa[4] = { (double)a.w(), (double)a.x(), (double)a.y(), (double)a.z() };
+        double qb[4] = { (double)b.w(), (double)b.x(), (double)b.y(), (double)b.z() };
+
+        double cosTheta = qa[0] * qb[0] + qa[1] * qb[1] + qa[2] * qb[2] + qa[3] * qb[3];
+        if(cosTheta < 0.0) {
+            cosTheta = -cosTheta;
+            for(int i = 0; i < 4; ++i) qb[i] = -qb[i];
+        }
+
+        double wa = 1.0 - t;
+        double wb = t;
+        if(cosTheta < 1.0) {
+            const double theta = std::acos(cosTheta);
+            wa = std::sin((1.0 - t) * theta) / std::sin(theta);
+            wb = std::sin(t * theta) / std::sin(theta);
+        }
+
+        double q[4];
+        double length = 0.0;
+        for(int i = 0; i < 4; ++i) {
+            q[i] = wa * qa[i] + wb * qb[i];
+            length += q[i] * q[i];
+        }
+        length = std::sqrt(length);
+
+        return Quaternion<T>((T)(q[0] / length), (T)(q[1] / length), (T)(q[2] / length),
+                             (T)(q[3] / length));
+    }
+
+    /**
+     * Function to run the batch transform checks.
+     *
+     * @param rng Random generator.
+     */
+    template<typename T>
+    void checkBatches(std::mt19937& rng) {
+
+        std::uniform_real_distribution<double> coordinate(-10.0, 10.0);
+
+        for(std::size_t s = 0; s < sizeof(SIZES) / sizeof(SIZES[0]); ++s) {
+            const std::size_t n = SIZES[s];
+            const Matrix4x4<T> m = randomAffine<T>(rng);
+
+            std::vector<Vector3D<T>> vectors(n);
+            for(std::size_t i = 0; i < n; ++i) {
+                vectors[i] = Vector3D<T>((T)coordinate(rng), (T)coordinate(rng),
+                                         (T)coordinate(rng));
+            }
+
+            // Structure of arrays, out of place and in place.
+            const Vector3DArray<T> in(vectors);
+            Vector3DArray<T> points;
+            Vector3DArray<T> directions;
+            transformPoints(m, in, points);
+            transformDirections(m, in, directions);
+
+            bool isValid = points.size() == n && directions.size() == n;
+            for(std::size_t i = 0; isValid && i < n; ++i) {
+                isValid &= isTransformed(m, 1.0, vectors[i], points.get(i));
+                isValid &= isTransformed(m, 0.0, vectors[i], directions.get(i));
+            }
+            PIKO_CHECK(isValid);
+
+            Vector3DArray<T> aliased(in);
+            transformPoints(m, aliased, aliased);
+            isValid = aliased.size() == n;
+            for(std::size_t i = 0; isValid && i < n; ++i) {
+                isValid &= isClose(aliased.get(i), points.get(i), 0.0);
+            }
+            PIKO_CHECK(isValid);
+
+            // Array of structures, out of place and in place.
+            std::vector<Vector3D<T>> out(n);
+            transformPoints(m, vectors.data(), out.data(), n);
+            isValid = true;
+            for(std::size_t i = 0; i < n; ++i) {
+                isValid &= isTransformed(m, 1.0, vectors[i], out[i]);
+            }
+            PIKO_CHECK(isValid);
+
+            std::vector<Vector3D<T>> inPlace(vectors);
+            transformDirections(m, inPlace.data(), inPlace.data(), n);
+            isValid = true;
+            for(std::size_t i = 0; i < n; ++i) {
+                isValid &= isTransformed(m, 0.0, vectors[i], inPlace[i]);
+                isValid &= isTransformed(m, 0.0, vectors[i], m.transformDirection(vectors[i]));
+                isValid &= isTransformed(m, 1.0, vectors[i], m.transformPoint(vectors[i]));
+            }
+            PIKO_CHECK(isValid);
+        }
+    }
+
+    /**
+     * Function to run the matrix checks.
+     *
+     * @param rng Random generator.
+     * @param tolerance Tolerance of results close to 1.
+     */
+    template<typename T>
+    void checkMatrices(std::mt19937& rng, double tolerance) {
+
+        const Matrix4x4<T> identity;
+
+        // Column-major storage, the translation is in the last column.
+        const Matrix4x4<T> t = Matrix4x4<T>::translation(Vector3D<T>(1, 2, 3));
+        PIKO_CHECK(t.data()[12] == 1 && t.data()[13] == 2 && t.data()[14] == 3);
+        PIKO_CHECK(t(0, 3) == 1 && t.getTranspose()(3, 0) == 1);
+        PIKO_CHECK(isClose(t.getInverse(), Matrix4x4<T>::translation(Vector3D<T>(-1, -2, -3)),
+                           tolerance));
+
+        for(int iteration = 0; iteration < 100; ++iteration) {
+            const Matrix4x4<T> a = randomAffine<T>(rng);
+            const Matrix4x4<T> b = randomAffine<T>(rng);
+
+            // The product against the textbook triple loop.
+            const Matrix4x4<T> ab = a * b;
+            bool isValid = true;
+            for(int row = 0; row < 4; ++row) {
+                for(int col = 0; col < 4; ++col) {
+                    double expected = 0.0;
+                    for(int k = 0; k < 4; ++k) expected += (double)a(row, k) * (double)b(k, col);
+                    isValid &= std::fabs((double)ab(row, col) - expected) <= 100.0 * tolerance;
+                }
+            }
+            PIKO_CHECK(isValid);
+
+            Matrix4x4<T> product = a;
+            product *= b;
+            PIKO_CHECK(isClose(product, ab, 0.0));
+
+            // Random matrices are badly conditioned now and then, so the residual is relative
+            // to the magnitude of the inverse.
+            const Matrix4x4<T> inverse = a.getInverse();
+            double magnitude = 1.0;
+            for(int i = 0; i < 16; ++i) {
+                magnitude = std::max(magnitude, std::fabs((double)inverse.data()[i]));
+            }
+            PIKO_CHECK(isClose(a * inverse, identity, 100.0 * tolerance * magnitude));
+            PIKO_CHECK(isClose(inverse * a, identity, 100.0 * tolerance * magnitude));
+        }
+
+        // Projections are inverted as well.
+        const Matrix4x4<T> view = Matrix4x4<T>::lookAt(Vector3D<T>(1, 2, 5), Vector3D<T>(0, 0, 0),
+                                                       Vector3D<T>(0, 1, 0));
+        const Matrix4x4<T> projection = Matrix4x4<T>::perspective((T)1.0, (T)1.5, (T)0.1,
+                                                                  (T)100.0);
+        const Matrix4x4<T> viewProjection = projection * view;
+        PIKO_CHECK(isClose(viewProjection * viewProjection.getInverse(), identity,
+                           1000.0 * tolerance));
+
+        bool isThrown = false;
+        try {
+            Matrix4x4<T>::scaling(Vector3D<T>(1, 0, 1)).getInverse();
+        }
+        catch(const std::domain_error&) {
+            isThrown = true;
+        }
+        PIKO_CHECK(isThrown);
+    }
+
+    /**
+     * Function to run the rotation and quaternion checks.
+     *
+     * @param rng Random generator.
+     * @param tolerance Tolerance of results close to 1.
+     */
+    template<typename T>
+    void checkRotations(std::mt19937& rng, double tolerance) {
+
+        std::uniform_real_distribution<double> coordinate(-1.0, 1.0);
+        std::uniform_real_distribution<double> angle(-3.0, 3.0);
+
+        for(int iteration = 0; iteration < 100; ++iteration) {
+            const Vector3D<T> axis((T)coordinate(rng), (T)coordinate(rng), (T)coordinate(rng));
+            const Vector3D<T> v((T)coordinate(rng), (T)coordinate(rng), (T)coordinate(rng));
+            const T radians = (T)angle(rng);
+
+            // The quaternion, its matrix and the Hamilton product q * v * q^-1 agree.
+            const Quaternion<T> q = Quaternion<T>::fromAxisAngle(axis, radians);
+            const Matrix4x4<T> r = Matrix4x4<T>::rotation(axis, radians);
+            const Quaternion<T> sandwich = q * Quaternion<T>(0, v.x(), v.y(), v.z()) *
+                                           q.getConjugate();
+            const Vector3D<T> rotated = q.rotate(v);
+
+            PIKO_CHECK_CLOSE(q.getMagnitude(), 1.0, tolerance);
+            PIKO_CHECK(isClose(rotated, r.transformDirection(v), 10.0 * tolerance));
+            PIKO_CHECK(isClose(rotated, Vector3D<T>(sandwich.x(), sandwich.y(), sandwich.z()),
+                               10.0 * tolerance));
+            PIKO_CHECK(isClose(q.toMatrix(), r, 10.0 * tolerance));
+            PIKO_CHECK_CLOSE(rotated.getMagnitude(), v.getMagnitude(), 10.0 * tolerance);
+
+            const Quaternion<T> p = randomRotation<T>(rng);
+            PIKO_CHECK(isClose((p * q).rotate(v), p.rotate(q.rotate(v)), 10.0 * tolerance));
+        }
+
+        const double ts[] = { 0.0, 0.1, 0.25, 0.5, 0.75, 0.9, 1.0 };
+
+        for(int iteration = 0; iteration < 100; ++iteration) {
+            const Quaternion<T> a = randomRotation<T>(rng);
+            const Quaternion<T> b = randomRotation<T>(rng);
+            const Quaternion<T> negated(-b.w(), -b.x(), -b.y(), -b.z());
+
+            // Both signs of b are the same rotation, so the shorter arc gives the same result.
+            bool isValid = true;
+            for(std::size_t k = 0; k < sizeof(ts) / sizeof(ts[0]); ++k) {
+                const T t = (T)ts[k];
+                const Quaternion<T> expected = slerpReference(a, b, ts[k]);
+                isValid &= isClose(Quaternion<T>::slerp(a, b, t), expected, 100.0 * tolerance);
+                isValid &= isClose(Quaternion<T>::slerp(a, negated, t), expected,
+                                   100.0 * tolerance);
+            }
+            PIKO_CHECK(isValid);
+        }
+
+        // Nearly parallel rotations take the linear fallback, which equals nlerp() and stays
+        // close to the exact slerp.
+        for(int iteration = 0; iteration < 100; ++iteration) {
+            const Quaternion<T> a = randomRotation<T>(rng);
+            const Vector3D<T> axis((T)coordinate(rng), (T)coordinate(rng), (T)coordinate(rng));
+            const Quaternion<T> b = a * Quaternion<T>::fromAxisAngle(axis, (T)0.02);
+            PIKO_CHECK(std::fabs((double)a.dot(b)) > 0.9995);
+
+            bool isValid = true;
+            for(std::size_t k = 0; k < sizeof(ts) / sizeof(ts[0]); ++k) {
+                const T t = (T)ts[k];
+                const Quaternion<T> q = Quaternion<T>::slerp(a, b, t);
+                isValid &= isClose(q, Quaternion<T>::nlerp(a, b, t), 0.0);
+                isValid &= isClose(q, slerpReference(a, b, ts[k]), 1e-5);
+            }
+            PIKO_CHECK(isValid);
+
+            const Quaternion<T> same = Quaternion<T>::slerp(a, a, (T)0.3);
+            PIKO_CHECK(isClose(same, a, 10.0 * tolerance));
+        }
+    }
+
+} /* Anonymous namespace */
+
+
+
+int main() {
+
+    std::mt19937 rng(11);
+
+    checkBatches<float>(rng);
+    checkBatches<double>(rng);
+
+    checkMatrices<float>(rng, 1e-6);
+    checkMatrices<double>(rng, 1e-14);
+
+    checkRotations<float>(rng, 1e-6);
+    checkRotations<double>(rng, 1e-14);
+
+    return test::finish("Matrix4x4Test");
+}
\ No newline at end of file
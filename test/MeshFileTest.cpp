@@ -0,0 +1,363 @@
+/**
+ * @file        MeshFileTest.cpp
+ * @author      Robert Koch
+ * @version     1.0
+ *
+ * Test of the binary mesh format without a context: meshes written by MeshFile::write() and
+ * parsed from OBJ text have to come back from the mapping byte for byte, with 16-bit indices up
+ * to 0x10000 vertices. Files with a corrupted header or truncated streams have to be rejected.
+ */
+#include "../include/MeshFile.h"
+#include "../tools/ObjParser.h"
+#include "Test.h"
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+
+namespace {
+
+    using namespace Piko;
+
+    /** Files written by the test, in the working directory of ctest. */
+    const char* const MESH_PATH = "MeshFileTest.pkm";
+    const char* const CORRUPT_PATH = "MeshFileTest_corrupt.pkm";
+
+    /**
+     * Function to create a grid of quads in the xz-plane.
+     *
+     * @param side Number of vertices along each axis, at least 2.
+     * @param hasNormals True to add normals.
+     * @param hasTexcoords True to add texture coordinates.
+     * @return Mesh.
+     */
+    MeshData createGrid(std::size_t side, bool hasNormals, bool hasTexcoords) {
+
+        MeshData mesh;
+        for(std::size_t z = 0; z < side; ++z) {
+            for(std::size_t x = 0; x < side; ++x) {
+                const float u = (float)x / (side - 1);
+                const float v = (float)z / (side - 1);
+                mesh.positions.push_back(Vector3D<float>(u * 10.0f - 5.0f, u * v, v * 4.0f));
+                if(hasNormals) mesh.normals.push_back(Vector3D<float>(0.0f, 1.0f, u));
+                if(hasTexcoords) {
+                    mesh.texcoords.push_back(u);
+                    mesh.texcoords.push_back(v);
+                }
+            }
+        }
+
+        for(std::size_t z = 0; z + 1 < side; ++z) {
+            for(std::size_t x = 0; x + 1 < side; ++x) {
+                const std::uint32_t i = (std::uint32_t)(z * side + x);
+                const std::uint32_t quad[6] = { i, i + (std::uint32_t)side, i + 1,
+                                                i + 1, i + (std::uint32_t)side,
+                                                i + (std::uint32_t)side + 1 };
+                mesh.indices.insert(mesh.indices.end(), quad, quad + 6);
+            }
+        }
+
+        return mesh;
+    }
+
+    /**
+     * Function to check if an open file holds exactly a mesh.
+     *
+     * @param file Open mesh file.
+     * @param mesh Mesh which was written.
+     * @return True if the header, the interleaved vertices and the indices match.
+     */
+    bool isMatching(const MeshFile& file, const MeshData& mesh) {
+
+        const std::size_t count = mesh.positions.size();
+        bool isValid = file.isOpen() && file.getVertexCount() == count &&
+                       file.getIndexCount() == mesh.indices.size() &&
+                       file.hasAttribute(MESH_NORMAL) == !mesh.normals.empty() &&
+                       file.hasAttribute(MESH_TEXCOORD) == !mesh.texcoords.empty();
+        if(!isValid) return false;
+
+        const std::size_t stride = file.getVertexStride();
+        const char* vertices = static_cast<const char*>(file.getVertexData());
+
+        for(std::size_t i = 0; i < count; ++i) {
+            const float* p = reinterpret_cast<const float*>(vertices + i * stride);
+            const Vector3D<float>& position = mesh.positions[i];
+            isValid &= p[0] == position.x() && p[1] == position.y() && p[2] == position.z();
+
+            if(!mesh.normals.empty()) {
+                const float* n = reinterpret_cast<const float*>(
+                    vertices + i * stride + file.getAttributeOffset(MESH_NORMAL));
+                const Vector3D<float>& normal = mesh.normals[i];
+                isValid &= n[0] == normal.x() && n[1] == normal.y() && n[2] == normal.z();
+            }
+
+            if(!mesh.texcoords.empty()) {
+                const float* t = reinterpret_cast<const float*>(
+                    vertices + i * stride + file.getAttributeOffset(MESH_TEXCOORD));
+                isValid &= t[0] == mesh.texcoords[2 * i] && t[1] == mesh.texcoords[2 * i + 1];
+            }
+        }
+
+        for(std::size_t i = 0; i < mesh.indices.size(); ++i) {
+            const std::uint32_t index = file.getIndexSize() == 2 ?
+                static_cast<const std::uint16_t*>(file.getIndexData())[i] :
+                static_cast<const std::uint32_t*>(file.getIndexData())[i];
+            isValid &= index == mesh.indices[i];
+        }
+
+        return isValid;
+    }
+
+    /**
+     * Function to read a whole file.
+     *
+     * @param path Path of the file.
+     * @return Contents of the file.
+     */
+    std::string readFile(const char* path) {
+
+        std::ifstream file(path, std::ios::in | std::ios::binary);
+        return std::string((std::istreambuf_iterator<char>(file)),
+                           std::istreambuf_iterator<char>());
+    }
+
+    /**
+     * Function to write a copy of a mesh file with a modified header and check that opening it
+     * fails.
+     *
+     * @param bytes Contents of a valid mesh file.
+     * @param header Header to write over the original one.
+     * @param size Number of bytes of the copy, at most the size of bytes.
+     * @return True if MeshFile::open() threw a std::runtime_error and left the file closed.
+     */
+    bool isRejected(const std::string& bytes, const MeshFileHeader& header, std::size_t size) {
+
+        std::string corrupt = bytes.substr(0, size);
+        if(size >= sizeof(MeshFileHeader)) {
+            std::memcpy(&corrupt[0], &header, sizeof(MeshFileHeader));
+        }
+
+        {
+            std::ofstream file(CORRUPT_PATH, std::ios::out | std::ios::binary | std::ios::trunc);
+            file.write(corrupt.data(), (std::streamsize)corrupt.size());
+        }
+
+        MeshFile file;
+        try {
+            file.open(CORRUPT_PATH);
+        }
+        catch(const std::runtime_error&) {
+            return !file.isOpen();
+        }
+        return false;
+    }
+
+    /**
+     * Function to check that writing a mesh fails.
+     *
+     * @param mesh Invalid mesh.
+     * @return True if MeshFile::write() threw a std::invalid_argument.
+     */
+    bool isInvalid(const MeshData& mesh) {
+
+        try {
+            MeshFile::write(MESH_PATH, mesh);
+        }
+        catch(const std::invalid_argument&) {
+            return true;
+        }
+        return false;
+    }
+
+} /* Anonymous namespace */
+
+
+
+int main() {
+
+    // All attributes, interleaved in the order of their flags, with 16-bit indices.
+    {
+        const MeshData mesh = createGrid(10, true, true);
+        MeshFile::write(MESH_PATH, mesh);
+
+        MeshFile file(MESH_PATH);
+        const MeshFileHeader& header = file.getHeader();
+        PIKO_CHECK(std::memcmp(header.magic, MESH_FILE_MAGIC, 4) == 0);
+        PIKO_CHECK(header.version == MESH_FILE_VERSION);
+        PIKO_CHECK(file.getVertexStride() == 8 * sizeof(float));
+        PIKO_CHECK(file.getAttributeOffset(MESH_POSITION) == 0);
+        PIKO_CHECK(file.getAttributeOffset(MESH_NORMAL) == 3 * sizeof(float));
+        PIKO_CHECK(file.getAttributeOffset(MESH_TEXCOORD) == 6 * sizeof(float));
+        PIKO_CHECK(file.getIndexSize() == 2 && file.getIndexType() == GL_UNSIGNED_SHORT);
+        PIKO_CHECK(header.vertexOffset % MESH_FILE_ALIGNMENT == 0);
+        PIKO_CHECK(header.indexOffset % MESH_FILE_ALIGNMENT == 0);
+        PIKO_CHECK(isMatching(file, mesh));
+
+        const AABB<float> bounds = file.getBounds();
+        PIKO_CHECK(bounds.getMin().x() == -5.0f && bounds.getMin().y() == 0.0f);
+        PIKO_CHECK(bounds.getMin().z() == 0.0f && bounds.getMax().x() == 5.0f);
+        PIKO_CHECK(bounds.getMax().y() == 1.0f && bounds.getMax().z() == 4.0f);
+
+        file.close();
+        PIKO_CHECK(!file.isOpen() && file.getVertexData() == NULL);
+        PIKO_CHECK(file.getIndexData() == NULL && file.getVertexCount() == 0);
+    }
+
+    // Positions only, 16-bit indices up to 0x10000 vertices and 32-bit indices above.
+    {
+        MeshFile file;
+        const MeshData largest = createGrid(256, false, false);
+        MeshFile::write(MESH_PATH, largest);
+        file.open(MESH_PATH);
+        PIKO_CHECK(file.getVertexCount() == 0x10000 && file.getIndexSize() == 2);
+        PIKO_CHECK(file.getVertexStride() == 3 * sizeof(float));
+        PIKO_CHECK(!file.hasAttribute(MESH_NORMAL) && !file.hasAttribute(MESH_TEXCOORD));
+        PIKO_CHECK(isMatching(file, largest));
+
+        // Opening closes the previous mapping.
+        const MeshData large = createGrid(257, false, true);
+        MeshFile::write(MESH_PATH, large);
+        file.open(MESH_PATH);
+        PIKO_CHECK(file.getIndexSize() == 4 && file.getIndexType() == GL_UNSIGNED_INT);
+        PIKO_CHECK(file.getAttributeOffset(MESH_TEXCOORD) == 3 * sizeof(float));
+        PIKO_CHECK(isMatching(file, large));
+    }
+
+    // An empty mesh has empty streams and bounds.
+    {
+        MeshFile::write(MESH_PATH, MeshData());
+        MeshFile file(MESH_PATH);
+        PIKO_CHECK(file.getVertexCount() == 0 && file.getIndexCount() == 0);
+        PIKO_CHECK(file.getBounds().isEmpty());
+    }
+
+    // OBJ text through the converter's parser: a quad split into a fan, negative indices and
+    // corners sharing all attributes merged into one vertex.
+    {
+        const char* text =
+            "# quad\n"
+            "v 0 0 0\nv 1 0 0\nv 1 1 0\nv 0 1 0\n"
+            "vt 0 0\nvt 1 0\nvt 1 1\nvt 0 1\n"
+            "vn 0 0 1\n"
+            "g quad\n"
+            "f 1/1/1 2/2/1 3/3/1 -1/-1/-1\n"
+            "f 1/1/1 3/3/1 4/4/1\n";
+
+        MeshData mesh;
+        parseObj(text, mesh);
+        PIKO_CHECK(mesh.positions.size() == 4 && mesh.indices.size() == 9);
+        PIKO_CHECK(mesh.normals.size() == 4 && mesh.texcoords.size() == 8);
+        PIKO_CHECK(mesh.indices[3] == 0 && mesh.indices[4] == 2 && mesh.indices[5] == 3);
+        PIKO_CHECK(mesh.indices[6] == 0 && mesh.indices[8] == 3);
+        PIKO_CHECK(mesh.positions[3].y() == 1.0f && mesh.texcoords[7] == 1.0f);
+
+        MeshFile::write(MESH_PATH, mesh);
+        MeshFile file(MESH_PATH);
+        PIKO_CHECK(isMatching(file, mesh));
+
+        // A corner without a normal drops the normals of the whole mesh.
+        MeshData partial;
+        parseObj("v 0 0 0\nv 1 0 0\nv 0 1 0\nvn 0 0 1\nf 1//1 2//1 3\n", partial);
+        PIKO_CHECK(partial.positions.size() == 3 && partial.normals.empty());
+        PIKO_CHECK(partial.texcoords.empty());
+
+        bool isThrown = false;
+        try {
+            MeshData undefined;
+            parseObj("v 0 0 0\nf 1 2 3\n", undefined);
+        }
+        catch(const std::runtime_error&) {
+            isThrown = true;
+        }
+        PIKO_CHECK(isThrown);
+    }
+
+    // Streams which do not match the positions are not written.
+    {
+        MeshData mesh = createGrid(3, true, true);
+        mesh.normals.pop_back();
+        PIKO_CHECK(isInvalid(mesh));
+
+        mesh = createGrid(3, true, true);
+        mesh.texcoords.pop_back();
+        PIKO_CHECK(isInvalid(mesh));
+
+        mesh = createGrid(3, false, false);
+        mesh.indices.back() = 9;
+        PIKO_CHECK(isInvalid(mesh));
+    }
+
+    // Corrupted headers and truncated streams are rejected.
+    {
+        MeshFile::write(MESH_PATH, createGrid(10, true, false));
+        const std::string bytes = readFile(MESH_PATH);
+        MeshFileHeader valid;
+        std::memcpy(&valid, bytes.data(), sizeof(valid));
+
+        MeshFile file;
+        bool isThrown = false;
+        try {
+            file.open("MeshFileTest_missing.pkm");
+        }
+        catch(const std::runtime_error&) {
+            isThrown = true;
+        }
+        PIKO_CHECK(isThrown && !file.isOpen());
+
+        PIKO_CHECK(!isRejected(bytes, valid, bytes.size()));
+        PIKO_CHECK(isRejected(bytes, valid, sizeof(MeshFileHeader) - 1));
+
+        MeshFileHeader h = valid;
+        h.magic[3] = 'X';
+        PIKO_CHECK(isRejected(bytes, h, bytes.size()));
+
+        h = valid;
+        h.version = MESH_FILE_VERSION + 1;
+        PIKO_CHECK(isRejected(bytes, h, bytes.size()));
+
+        h = valid;
+        h.byteOrder = 0x04030201;
+        PIKO_CHECK(isRejected(bytes, h, bytes.size()));
+
+        h = valid;
+        h.attributes = MESH_NORMAL;
+        PIKO_CHECK(isRejected(bytes, h, bytes.size()));
+
+        h = valid;
+        h.attributes |= 8;
+        PIKO_CHECK(isRejected(bytes, h, bytes.size()));
+
+        h = valid;
+        h.vertexStride += 4;
+        PIKO_CHECK(isRejected(bytes, h, bytes.size()));
+
+        h = valid;
+        h.indexSize = 3;
+        PIKO_CHECK(isRejected(bytes, h, bytes.size()));
+
+        h = valid;
+        h.vertexOffset += 4;
+        PIKO_CHECK(isRejected(bytes, h, bytes.size()));
+
+        h = valid;
+        h.indexOffset = (bytes.size() / MESH_FILE_ALIGNMENT + 1) * MESH_FILE_ALIGNMENT;
+        PIKO_CHECK(isRejected(bytes, h, bytes.size()));
+
+        h = valid;
+        h.vertexCount = 0xFFFFFFFFu;
+        PIKO_CHECK(isRejected(bytes, h, bytes.size()));
+
+        // The last index is missing.
+        PIKO_CHECK(isRejected(bytes, valid, bytes.size() - 1));
+    }
+
+    std::remove(MESH_PATH);
+    std::remove(CORRUPT_PATH);
+
+    return test::finish("MeshFileTest");
+}
\ No newline at end of file
@@ -0,0 +1,326 @@
+/**
+ * @file        ParticleSystemTest.cpp
+ * @author      Robert Koch
+ * @version     1.0
+ *
+ * Test of the ParticleSystem: the SIMD integration has to match a plain array of structures
+ * stepped with the same formulas, dead particles have to be removed, and the parallel update has
+ * to produce exactly the particles of the serial one for any grain. If an EGL display is
+ * available, the vertices streamed into the buffer have to match writeVertices().
+ */
+#include "../include/GLContext.h"
+#include "../include/JobSystem.h"
+#include "../include/ParticleSystem.h"
+#include "Test.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+
+namespace {
+
+    using namespace Piko;
+
+    /**
+     * Particle of the reference model, stored as array of structures.
+     */
+    struct Particle {
+        float px, py, pz;           /**< Position. */
+        float vx, vy, vz;           /**< Velocity. */
+        float life;                 /**< Remaining lifetime. */
+
+        /**
+         * Operator to order particles by all members, which gives both models the same order.
+         */
+        bool operator<(const Particle& p) const {
+            if(life != p.life) return life < p.life;
+            if(px != p.px) return px < p.px;
+            if(py != p.py) return py < p.py;
+            return pz < p.pz;
+        }
+    };
+
+    /**
+     * Function to step the reference model.
+     *
+     * @param particles Particles to step, dead ones are erased.
+     * @param dt Time step.
+     * @param gravity Acceleration.
+     * @param drag Drag coefficient.
+     */
+    void step(std::vector<Particle>& particles, float dt, const Vector3D<float>& gravity,
+              float drag) {
+
+        const float damping = std::exp(-drag * dt);
+        const float gx = gravity.x() * dt;
+        const float gy = gravity.y() * dt;
+        const float gz = gravity.z() * dt;
+
+        std::vector<Particle> alive;
+        for(std::size_t i = 0; i < particles.size(); ++i) {
+            Particle p = particles[i];
+            p.vx = (p.vx + gx) * damping;
+            p.vy = (p.vy + gy) * damping;
+            p.vz = (p.vz + gz) * damping;
+            p.px += p.vx * dt;
+            p.py += p.vy * dt;
+            p.pz += p.vz * dt;
+            p.life -= dt;
+            if(p.life > 0.0f) alive.push_back(p);
+        }
+
+        particles.swap(alive);
+    }
+
+    /**
+     * Function to read the particles of a system, sorted.
+     *
+     * @param system System to read.
+     * @return Particles.
+     */
+    std::vector<Particle> getParticles(const ParticleSystem& system) {
+
+        const Vector3DArray<float>& p = system.getPositions();
+        const Vector3DArray<float>& v = system.getVelocities();
+        const float* life = system.getLifetimes();
+
+        std::vector<Particle> particles(system.getCount());
+        for(std::size_t i = 0; i < particles.size(); ++i) {
+            const Particle particle = { p.x()[i], p.y()[i], p.z()[i],
+                                        v.x()[i], v.y()[i], v.z()[i], life[i] };
+            particles[i] = particle;
+        }
+
+        std::sort(particles.begin(), particles.end());
+        return particles;
+    }
+
+    /**
+     * Function to check if two particle lists are equal in every member.
+     *
+     * @param a First list, sorted.
+     * @param b Second list, sorted.
+     * @return True if the lists are equal.
+     */
+    bool isEqual(const std::vector<Particle>& a, const std::vector<Particle>& b) {
+
+        bool isValid = a.size() == b.size();
+        for(std::size_t i = 0; isValid && i < a.size(); ++i) {
+            isValid &= a[i].px == b[i].px && a[i].py == b[i].py && a[i].pz == b[i].pz;
+            isValid &= a[i].vx == b[i].vx && a[i].vy == b[i].vy && a[i].vz == b[i].vz;
+            isValid &= a[i].life == b[i].life;
+        }
+        return isValid;
+    }
+
+    /**
+     * Function to emit random particles into a system and a reference model.
+     *
+     * @param count Number of particles.
+     * @param rng Random generator.
+     * @param system System receiving the particles.
+     * @param particles Receives the particles of the reference model.
+     */
+    void emitRandom(std::size_t count, std::mt19937& rng, ParticleSystem& system,
+                    std::vector<Particle>& particles) {
+
+        std::uniform_real_distribution<float> coordinate(-10.0f, 10.0f);
+        std::uniform_real_distribution<float> lifetime(0.05f, 2.0f);
+
+        for(std::size_t i = 0; i < count; ++i) {
+            const Particle p = { coordinate(rng), coordinate(rng), coordinate(rng),
+                                 coordinate(rng), coordinate(rng), coordinate(rng),
+                                 lifetime(rng) };
+            system.emit(Vector3D<float>(p.px, p.py, p.pz), Vector3D<float>(p.vx, p.vy, p.vz),
+                        p.life);
+            particles.push_back(p);
+        }
+    }
+
+    /**
+     * Function to check if the vertex buffer of a system holds the vertices of its particles.
+     *
+     * @param system System with a buffer, streamed.
+     * @param gl Functions of the current context.
+     * @return True if the buffer content equals writeVertices().
+     */
+    bool isStreamed(const ParticleSystem& system, const GLExtensions& gl) {
+
+        std::vector<ParticleVertex> expected(system.getCount() + 1);
+        system.writeVertices(&expected[0]);
+
+        const GLsizeiptr bytes = (GLsizeiptr)(system.getCount() * sizeof(ParticleVertex));
+        gl.glBindBuffer(GL_ARRAY_BUFFER, system.getBuffer());
+        const void* mapped = gl.glMapBufferRange(GL_ARRAY_BUFFER, 0, bytes, GL_MAP_READ_BIT);
+
+        const bool isValid = mapped && std::memcmp(mapped, &expected[0], bytes) == 0;
+        if(mapped) gl.glUnmapBuffer(GL_ARRAY_BUFFER);
+        gl.glBindBuffer(GL_ARRAY_BUFFER, 0);
+        return isValid;
+    }
+
+} /* Anonymous namespace */
+
+
+
+int main() {
+
+    // Capacity and the analytic result of a single step.
+    {
+        ParticleSystem system(3);
+        PIKO_CHECK(system.getCapacity() == 3 && system.getCount() == 0);
+
+        const Vector3D<float> v(1.0f, 2.0f, 0.0f);
+        PIKO_CHECK(system.emit(Vector3D<float>(0.0f, 0.0f, 0.0f), v, 1.0f));
+        PIKO_CHECK(system.emit(Vector3D<float>(1.0f, 0.0f, 0.0f), v, 0.05f));
+        PIKO_CHECK(system.emit(Vector3D<float>(2.0f, 0.0f, 0.0f), v, 1.0f));
+        PIKO_CHECK(!system.emit(Vector3D<float>(), v, 1.0f));
+        PIKO_CHECK(system.getCount() == 3);
+
+        system.setGravity(Vector3D<float>(0.0f, -10.0f, 0.0f));
+        system.setDrag(0.5f);
+        PIKO_CHECK(system.getGravity().y() == -10.0f && system.getDrag() == 0.5f);
+
+        // The second particle dies, the last one takes its slot.
+        system.update(0.1f);
+        PIKO_CHECK(system.getCount() == 2);
+
+        const float damping = std::exp(-0.5f * 0.1f);
+        const Vector3DArray<float>& p = system.getPositions();
+        const Vector3DArray<float>& u = system.getVelocities();
+        PIKO_CHECK(p.x()[1] == 2.0f + damping * 0.1f);
+        PIKO_CHECK_CLOSE(u.y()[0], (2.0f - 1.0f) * damping, 1e-6);
+        PIKO_CHECK_CLOSE(p.y()[0], (2.0f - 1.0f) * damping * 0.1f, 1e-6);
+        PIKO_CHECK_CLOSE(system.getLifetimes()[0], 0.9f, 1e-6);
+
+        ParticleVertex vertices[2];
+        system.writeVertices(vertices);
+        PIKO_CHECK(vertices[1].x == p.x()[1] && vertices[1].lifetime == system.getLifetimes()[1]);
+
+        // Without a buffer nothing is streamed.
+        PIKO_CHECK(system.stream() == 0 && system.getBuffer() == 0);
+
+        system.clear();
+        PIKO_CHECK(system.getCount() == 0);
+        system.update(0.1f);
+        PIKO_CHECK(system.getCount() == 0);
+    }
+
+    // Random particles against the reference model, until all of them died. The count is no
+    // multiple of the pack size, so the scalar tail is integrated as well.
+    {
+        const std::size_t count = 10007;
+        const Vector3D<float> gravity(0.5f, -9.81f, 0.0f);
+
+        std::mt19937 rng(42);
+        ParticleSystem system(count);
+        std::vector<Particle> particles;
+        emitRandom(count, rng, system, particles);
+
+        system.setGravity(gravity);
+        system.setDrag(0.3f);
+
+        bool isValid = true;
+        for(int frame = 0; frame < 200 && !particles.empty(); ++frame) {
+            system.update(1.0f / 60.0f);
+            step(particles, 1.0f / 60.0f, gravity, 0.3f);
+
+            std::sort(particles.begin(), particles.end());
+            isValid &= isEqual(getParticles(system), particles);
+        }
+        PIKO_CHECK(isValid);
+        PIKO_CHECK(particles.empty() && system.getCount() == 0);
+    }
+
+    // The parallel update equals the serial one, with and without workers and for grains
+    // which are no multiple of the pack size.
+    {
+        const std::size_t count = 100003;
+        const std::size_t workerCounts[] = { 0, 3 };
+        const std::size_t grains[] = { 1, 1000, PARALLEL_BATCH_GRAIN };
+
+        for(std::size_t w = 0; w < 2; ++w) {
+            JobSystem jobs(workerCounts[w]);
+
+            for(std::size_t g = 0; g < sizeof(grains) / sizeof(grains[0]); ++g) {
+                std::mt19937 rng(7);
+                std::vector<Particle> particles;
+                ParticleSystem serial(count);
+                emitRandom(count, rng, serial, particles);
+
+                rng.seed(7);
+                particles.clear();
+                ParticleSystem parallel(count);
+                emitRandom(count, rng, parallel, particles);
+
+                serial.setGravity(Vector3D<float>(0.0f, -9.81f, 1.0f));
+                parallel.setGravity(serial.getGravity());
+                serial.setDrag(0.1f);
+                parallel.setDrag(0.1f);
+
+                bool isValid = true;
+                for(int frame = 0; frame < 30; ++frame) {
+                    serial.update(1.0f / 30.0f);
+                    parallel.update(jobs, 1.0f / 30.0f, grains[g]);
+                    isValid &= serial.getCount() == parallel.getCount();
+                }
+                PIKO_CHECK(isValid);
+                PIKO_CHECK(serial.getCount() > 0 && serial.getCount() < count);
+                PIKO_CHECK(isEqual(getParticles(serial), getParticles(parallel)));
+            }
+        }
+    }
+
+    // With a buffer the vertices are streamed through a mapping, or with glBufferSubData() if
+    // the context cannot map buffers.
+    {
+        bool isThrown = false;
+        try {
+            const GLExtensions none;
+            ParticleSystem system(1);
+            system.initBuffer(none);
+        }
+        catch(const std::runtime_error&) {
+            isThrown = true;
+        }
+        PIKO_CHECK(isThrown);
+
+        GLContext context;
+        if(context.tryInitOffscreen(1, 1) && context.getExtensions().hasMapBufferRange) {
+            GLExtensions unmapped = context.getExtensions();
+            unmapped.hasMapBufferRange = false;
+            const GLExtensions* tables[] = { &context.getExtensions(), &unmapped };
+
+            for(int t = 0; t < 2; ++t) {
+                std::mt19937 rng(3);
+                std::vector<Particle> particles;
+                ParticleSystem system(100);
+                emitRandom(37, rng, system, particles);
+
+                system.initBuffer(*tables[t]);
+                PIKO_CHECK(system.getBuffer() != 0);
+                PIKO_CHECK(system.stream() == 37);
+                PIKO_CHECK(isStreamed(system, context.getExtensions()));
+
+                // Fewer particles after an update, the stale tail is not read.
+                system.update(0.5f);
+                PIKO_CHECK(system.getCount() < 37);
+                PIKO_CHECK(system.stream() == system.getCount());
+                PIKO_CHECK(isStreamed(system, context.getExtensions()));
+
+                system.clear();
+                PIKO_CHECK(system.stream() == 0);
+
+                system.releaseBuffer();
+                PIKO_CHECK(system.getBuffer() == 0 && system.stream() == 0);
+            }
+            PIKO_CHECK(glGetError() == GL_NO_ERROR);
+        }
+    }
+
+    return test::finish("ParticleSystemTest");
+}
\ No newline at end of file
@@ -0,0 +1,515 @@
+/**
+ * @file        ProfilerTest.cpp
+ * @author      Robert Koch
+ * @version     1.0
+ *
+ * Test of the Profiler: the exported trace has to be valid JSON in the Chrome trace format with
+ * escaped names, nested zones have to lie within each other, only zones started during a capture
+ * are recorded, a new capture discards the events of the previous one, and events beyond the
+ * limit of a thread are counted instead of recorded. Built with PIKO_ENABLE_PROFILER set, so
+ * the macros are tested as well.
+ */
+#include "../include/Profiler.h"
+#include "Test.h"
+
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+
+namespace {
+
+    using namespace Piko;
+
+    const char* const TRACE_PATH = "ProfilerTest.json";
+
+    /**
+     * Parsed JSON value.
+     */
+    struct JsonValue {
+
+        enum Type {
+            NUL,
+            BOOLEAN,
+            NUMBER,
+            STRING,
+            ARRAY,
+            OBJECT
+        };
+
+        JsonValue()
+          :
+          type(NUL),
+          number(0.0) {
+
+        }
+
+        /**
+         * Function to get a member of an object.
+         *
+         * @param key Name of the member.
+         * @return Member, NULL if there is none or the value is no object.
+         */
+        const JsonValue* get(const char* key) const {
+
+            for(std::size_t i = 0; i < members.size(); ++i) {
+                if(members[i].first == key) return &members[i].second;
+            }
+            return NULL;
+        }
+
+        /**
+         * Function to get the text of a string member.
+         *
+         * @param key Name of the member.
+         * @return Text, empty if the member is missing or no string.
+         */
+        std::string getText(const char* key) const {
+
+            const JsonValue* value = get(key);
+            return value && value->type == STRING ? value->text : std::string();
+        }
+
+        /**
+         * Function to get the value of a number member.
+         *
+         * @param key Name of the member.
+         * @return Number, -1 if the member is missing or no number.
+         */
+        double getNumber(const char* key) const {
+
+            const JsonValue* value = get(key);
+            return value && value->type == NUMBER ? value->number : -1.0;
+        }
+
+        Type type;
+        double number;                                          /**< Number or boolean. */
+        std::string text;                                       /**< Unescaped string. */
+        std::vector<JsonValue> items;                           /**< Elements of an array. */
+        std::vector<std::pair<std::string, JsonValue>> members; /**< Members of an object. */
+    };
+
+    /**
+     * Strict recursive descent parser of RFC 8259 JSON.
+     */
+    class JsonParser final {
+
+        public:
+
+            explicit JsonParser(const std::string& text)
+              :
+              m_c(text.c_str()),
+              m_end(text.c_str() + text.size()) {
+
+            }
+
+            /**
+             * Function to parse the whole text as one value.
+             *
+             * @param value Receives the parsed value.
+             * @return True if the text is valid JSON, otherwise false.
+             */
+            bool parse(JsonValue& value) {
+
+                return parseValue(value, 0) && (skipSpace(), m_c == m_end);
+            }
+
+        private:
+
+            const char* m_c;
+            const char* m_end;
+
+            void skipSpace() {
+                while(m_c < m_end && (*m_c == ' ' || *m_c == '\t' || *m_c == '\n' ||
+                                      *m_c == '\r')) {
+                    ++m_c;
+                }
+            }
+
+            bool accept(char c) {
+                skipSpace();
+                if(m_c == m_end || *m_c != c) return false;
+                ++m_c;
+                return true;
+            }
+
+            bool acceptWord(const char* word) {
+                const std::size_t length = std::strlen(word);
+                if((std::size_t)(m_end - m_c) < length || std::strncmp(m_c, word, length)) {
+                    return false;
+                }
+                m_c += length;
+                return true;
+            }
+
+            bool isDigit() const {
+                return m_c < m_end && *m_c >= '0' && *m_c <= '9';
+            }
+
+            bool parseValue(JsonValue& value, int depth) {
+
+                skipSpace();
+                if(m_c == m_end || depth > 64) return false;
+
+                switch(*m_c) {
+                    case '{': return parseObject(value, depth);
+                    case '[': return parseArray(value, depth);
+                    case '"': value.type = JsonValue::STRING; return parseString(value.text);
+                    case 't': value.type = JsonValue::BOOLEAN; value.number = 1.0;
+                              return acceptWord("true");
+                    case 'f': value.type = JsonValue::BOOLEAN; return acceptWord("false");
+                    case 'n': value.type = JsonValue::NUL; return acceptWord("null");
+                    default:  return parseNumber(value);
+                }
+            }
+
+            bool parseObject(JsonValue& value, int depth) {
+
+                value.type = JsonValue::OBJECT;
+                ++m_c;
+                if(accept('}')) return true;
+
+                do {
+                    std::pair<std::string, JsonValue> member;
+                    skipSpace();
+                    if(m_c == m_end || *m_c != '"' || !parseString(member.first)) return false;
+                    if(!accept(':') || !parseValue(member.second, depth + 1)) return false;
+                    value.members.push_back(member);
+                } while(accept(','));
+
+                return accept('}');
+            }
+
+            bool parseArray(JsonValue& value, int depth) {
+
+                value.type = JsonValue::ARRAY;
+                ++m_c;
+                if(accept(']')) return true;
+
+                do {
+                    value.items.push_back(JsonValue());
+                    if(!parseValue(value.items.back(), depth + 1)) return false;
+                } while(accept(','));
+
+                return accept(']');
+            }
+
+            bool parseString(std::string& text) {
+
+                ++m_c;
+                for(; m_c < m_end; ++m_c) {
+                    const char c = *m_c;
+                    if(c == '"') {
+                        ++m_c;
+                        return true;
+                    }
+                    if((unsigned char)c < 0x20) return false;
+                    if(c != '\\') {
+                        text.push_back(c);
+                        continue;
+                    }
+
+                    if(++m_c == m_end) return false;
+                    switch(*m_c) {
+                        case '"':  text.push_back('"'); break;
+                        case '\\': text.push_back('\\'); break;
+                        case '/':  text.push_back('/'); break;
+                        case 'b':  text.push_back('\b'); break;
+                        case 'f':  text.push_back('\f'); break;
+                        case 'n':  text.push_back('\n'); break;
+                        case 'r':  text.push_back('\r'); break;
+                        case 't':  text.push_back('\t'); break;
+                        case 'u':
+                            for(int i = 0; i < 4; ++i) {
+                                if(++m_c == m_end || !std::isxdigit((unsigned char)*m_c)) {
+                                    return false;
+                                }
+                            }
+                            text.push_back('?');
+                            break;
+                        default:
+                            return false;
+                    }
+                }
+                return false;
+            }
+
+            bool parseNumber(JsonValue& value) {
+
+                const char* start = m_c;
+
+                if(m_c < m_end && *m_c == '-') ++m_c;
+                if(!isDigit()) return false;
+                if(*m_c++ != '0') while(isDigit()) ++m_c;
+
+                if(m_c < m_end && *m_c == '.') {
+                    ++m_c;
+                    if(!isDigit()) return false;
+                    while(isDigit()) ++m_c;
+                }
+
+                if(m_c < m_end && (*m_c == 'e' || *m_c == 'E')) {
+                    ++m_c;
+                    if(m_c < m_end && (*m_c == '+' || *m_c == '-')) ++m_c;
+                    if(!isDigit()) return false;
+                    while(isDigit()) ++m_c;
+                }
+
+                value.type = JsonValue::NUMBER;
+                value.number = std::strtod(std::string(start, m_c).c_str(), NULL);
+                return true;
+            }
+    };
+
+    /**
+     * Function to export the last capture and parse it.
+     *
+     * @param trace Receives the root object.
+     * @return Events of the trace, empty if the trace is no valid Chrome trace.
+     */
+    std::vector<JsonValue> getEvents(JsonValue& trace) {
+
+        std::ostringstream stream;
+        Profiler::writeChromeTrace(stream);
+
+        trace = JsonValue();
+        if(!JsonParser(stream.str()).parse(trace) || trace.type != JsonValue::OBJECT) {
+            return std::vector<JsonValue>();
+        }
+
+        const JsonValue* events = trace.get("traceEvents");
+        return events && events->type == JsonValue::ARRAY ? events->items :
+                                                            std::vector<JsonValue>();
+    }
+
+    /**
+     * Function to find the complete events of a zone.
+     *
+     * @param events Events of a trace.
+     * @param name Zone name.
+     * @return Complete events with the name.
+     */
+    std::vector<JsonValue> getZones(const std::vector<JsonValue>& events, const char* name) {
+
+        std::vector<JsonValue> zones;
+        for(std::size_t i = 0; i < events.size(); ++i) {
+            if(events[i].getText("name") == name && events[i].getText("ph") == "X") {
+                zones.push_back(events[i]);
+            }
+        }
+        return zones;
+    }
+
+    /**
+     * Function to check if a zone lies within another one. Times are exact to the ns.
+     *
+     * @param inner Complete event of the inner zone.
+     * @param outer Complete event of the outer zone.
+     * @return True if the inner zone starts and ends within the outer one.
+     */
+    bool isWithin(const JsonValue& inner, const JsonValue& outer) {
+
+        const double start = inner.getNumber("ts");
+        const double end = start + inner.getNumber("dur");
+        return inner.getNumber("tid") == outer.getNumber("tid") &&
+               start >= outer.getNumber("ts") - 1e-3 &&
+               end <= outer.getNumber("ts") + outer.getNumber("dur") + 1e-3;
+    }
+
+    /**
+     * Function recording a zone named after itself.
+     */
+    void work() {
+
+        PIKO_PROFILE_FUNCTION();
+    }
+
+} /* Anonymous namespace */
+
+
+
+int main() {
+
+    // The parser accepts JSON and nothing else.
+    {
+        JsonValue value;
+        PIKO_CHECK(JsonParser("{\"a\":[1,-2.5e3,true,null,\"x\\\"\\u0041\"],\"b\":{}}")
+                   .parse(value));
+        PIKO_CHECK(value.get("a") && value.get("a")->items.size() == 5 &&
+                   value.get("a")->items[4].text == "x\"?");
+
+        const char* invalid[] = { "", "{", "[1,]", "{\"a\" 1}", "01", "1.", "\"\t\"", "\"\\x\"",
+                                  "{\"a\":1}}", "[1] 2", "nul" };
+        for(std::size_t i = 0; i < sizeof(invalid) / sizeof(invalid[0]); ++i) {
+            JsonValue ignored;
+            PIKO_CHECK(!JsonParser(invalid[i]).parse(ignored));
+        }
+    }
+
+    // Without a capture nothing is recorded and the trace is empty.
+    {
+        PIKO_CHECK(!Profiler::isCapturing());
+        work();
+        PIKO_PROFILE_FRAME();
+
+        JsonValue trace;
+        const std::vector<JsonValue> events = getEvents(trace);
+        PIKO_CHECK(trace.getText("displayTimeUnit") == "ns");
+        PIKO_CHECK(trace.get("traceEvents") && events.empty());
+    }
+
+    // Zones, frames and thread names of all threads form a valid trace.
+    {
+        PIKO_PROFILE_THREAD("main \"thread\" \\ 1");
+        Profiler::startCapture();
+        PIKO_CHECK(Profiler::isCapturing());
+
+        PIKO_PROFILE_FRAME();
+        {
+            PIKO_PROFILE_ZONE("outer");
+            work();
+            {
+                PIKO_PROFILE_ZONE("inner");
+                work();
+            }
+        }
+        {
+            PIKO_PROFILE_ZONE("tab\tand \"quote\"");
+        }
+
+        std::thread worker([]() {
+            PIKO_PROFILE_THREAD("worker");
+            PIKO_PROFILE_ZONE("outer");
+            work();
+        });
+        worker.join();
+
+        // A zone open while the capture stops is still recorded, later ones are not.
+        {
+            PIKO_PROFILE_ZONE("open");
+            Profiler::stopCapture();
+        }
+        PIKO_CHECK(!Profiler::isCapturing());
+        work();
+        PIKO_PROFILE_FRAME();
+
+        JsonValue trace;
+        const std::vector<JsonValue> events = getEvents(trace);
+        PIKO_CHECK(events.size() == 11);
+
+        bool isComplete = true;
+        std::size_t frames = 0;
+        std::vector<std::string> threads;
+        for(std::size_t i = 0; i < events.size(); ++i) {
+            const JsonValue& event = events[i];
+            const std::string ph = event.getText("ph");
+
+            isComplete &= event.getNumber("pid") == 1 && event.getNumber("tid") >= 0;
+            if(ph == "X") {
+                isComplete &= event.getNumber("ts") >= 0 && event.getNumber("dur") >= 0;
+            }
+            else if(ph == "i") {
+                isComplete &= event.getText("name") == "Frame" && event.getText("s") == "g";
+                ++frames;
+            }
+            else if(ph == "M") {
+                const JsonValue* args = event.get("args");
+                isComplete &= event.getText("name") == "thread_name" && args;
+                if(args) threads.push_back(args->getText("name"));
+            }
+            else {
+                isComplete = false;
+            }
+        }
+        PIKO_CHECK(isComplete);
+        PIKO_CHECK(frames == 1);
+        PIKO_CHECK(threads.size() == 2 && threads[0] == "main \"thread\" \\ 1" &&
+                   threads[1] == "worker");
+
+        // Control characters are left out of names, quotes are escaped.
+        PIKO_CHECK(getZones(events, "taband \"quote\"").size() == 1);
+        PIKO_CHECK(getZones(events, "open").size() == 1);
+
+        const std::vector<JsonValue> outer = getZones(events, "outer");
+        const std::vector<JsonValue> inner = getZones(events, "inner");
+        const std::vector<JsonValue> works = getZones(events, "work");
+        PIKO_CHECK(outer.size() == 2 && inner.size() == 1 && works.size() == 3);
+
+        if(outer.size() == 2 && inner.size() == 1 && works.size() == 3) {
+            PIKO_CHECK(outer[0].getNumber("tid") != outer[1].getNumber("tid"));
+            PIKO_CHECK(isWithin(inner[0], outer[0]));
+            PIKO_CHECK(isWithin(works[0], outer[0]) && !isWithin(works[0], inner[0]));
+            PIKO_CHECK(isWithin(works[1], inner[0]));
+            PIKO_CHECK(isWithin(works[2], outer[1]));
+        }
+    }
+
+    // A new capture discards the events of the previous one, the saved trace is the same.
+    {
+        Profiler::startCapture();
+        work();
+        Profiler::stopCapture();
+
+        JsonValue trace;
+        const std::vector<JsonValue> events = getEvents(trace);
+        PIKO_CHECK(getZones(events, "work").size() == 1 && getZones(events, "outer").empty());
+
+        std::ostringstream expected;
+        Profiler::writeChromeTrace(expected);
+        Profiler::saveChromeTrace(TRACE_PATH);
+
+        std::ifstream file(TRACE_PATH, std::ios::in | std::ios::binary);
+        const std::string saved((std::istreambuf_iterator<char>(file)),
+                                std::istreambuf_iterator<char>());
+        PIKO_CHECK(saved == expected.str());
+
+        bool hasThrown = false;
+        try {
+            Profiler::saveChromeTrace("missing/directory/ProfilerTest.json");
+        }
+        catch(const std::runtime_error&) {
+            hasThrown = true;
+        }
+        PIKO_CHECK(hasThrown);
+    }
+
+    // Events beyond the limit of a thread are counted, the next capture starts from zero.
+    {
+        const std::size_t extra = 10;
+
+        Profiler::startCapture();
+        for(std::size_t i = 0; i < Profiler::MAX_THREAD_EVENTS + extra; ++i) work();
+        Profiler::stopCapture();
+
+        PIKO_CHECK(Profiler::getDroppedCount() == extra);
+
+        // The trace is too large to parse into values, the complete events are counted.
+        std::ostringstream stream;
+        Profiler::writeChromeTrace(stream);
+        const std::string trace = stream.str();
+
+        std::size_t count = 0;
+        for(std::size_t p = trace.find("\"ph\":\"X\""); p != std::string::npos;
+            p = trace.find("\"ph\":\"X\"", p + 1)) {
+            ++count;
+        }
+        PIKO_CHECK(count == Profiler::MAX_THREAD_EVENTS);
+
+        Profiler::startCapture();
+        work();
+        Profiler::stopCapture();
+        PIKO_CHECK(Profiler::getDroppedCount() == 0);
+    }
+
+    std::remove(TRACE_PATH);
+    return test::finish("ProfilerTest");
+}
\ No newline at end of file
@@ -0,0 +1,164 @@
+/**
+ * @file        RenderThreadTest.cpp
+ * @author      Robert Koch
+ * @version     1.0
+ *
+ * Test of the RenderThread on an offscreen context: submitted frames have to be executed in
+ * order on the render thread, flush() has to wait for them and rethrow the exception of a
+ * command, and stop() has to execute the frames submitted before. Skipped if no EGL display is
+ * available.
+ */
+#include "../include/RenderThread.h"
+#include "Test.h"
+
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+
+namespace {
+
+    using namespace Piko;
+
+    /**
+     * Function to record a frame clearing the context and reading back its first pixel.
+     *
+     * @param thread Running render thread.
+     * @param red Red byte of the clear color.
+     * @param pixel Receives the first pixel.
+     */
+    void recordFrame(RenderThread& thread, int red, std::vector<unsigned char>& pixel) {
+
+        GLContext& context = thread.getContext();
+
+        thread.getCommandList().record([red]() {
+            glClearColor(red / 255.0f, 0.0f, 0.0f, 1.0f);
+            glClear(GL_COLOR_BUFFER_BIT);
+        });
+        thread.getCommandList().record([&context, &pixel]() {
+            std::vector<unsigned char> pixels;
+            context.readPixels(pixels);
+            pixel.assign(pixels.begin(), pixels.begin() + 4);
+        });
+    }
+
+} /* Anonymous namespace */
+
+
+
+int main() {
+
+    // Commands run in the order they were recorded, also beyond one memory block.
+    {
+        RenderCommandList list;
+        std::vector<int> order;
+
+        for(int i = 0; i < 5000; ++i) {
+            const std::vector<int> padding(8, i);
+            list.record([&order, padding]() { order.push_back(padding[7]); });
+        }
+        PIKO_CHECK(list.size() == 5000 && !list.empty());
+
+        list.execute();
+        bool isOrdered = order.size() == 5000;
+        for(int i = 0; isOrdered && i < 5000; ++i) isOrdered &= order[i] == i;
+        PIKO_CHECK(isOrdered);
+
+        list.clear();
+        PIKO_CHECK(list.empty());
+    }
+
+    RenderThread thread;
+
+    try {
+        thread.start([](GLContext& context) { context.initOffscreen(8, 8); });
+    }
+    catch(const std::runtime_error& e) {
+        std::cerr << "RenderThreadTest: skipped, " << e.what() << "\n";
+        return test::finish("RenderThreadTest");
+    }
+
+    PIKO_CHECK(thread.isRunning());
+
+    // Frames are executed in order on the render thread, while the next one is recorded.
+    {
+        std::vector<unsigned char> pixels[3];
+        std::thread::id renderThreadId;
+        thread.getCommandList().record([&renderThreadId]() {
+            renderThreadId = std::this_thread::get_id();
+        });
+
+        for(int frame = 0; frame < 3; ++frame) {
+            recordFrame(thread, 100 + frame, pixels[frame]);
+            thread.submit();
+        }
+        thread.flush();
+
+        PIKO_CHECK(renderThreadId != std::thread::id());
+        PIKO_CHECK(renderThreadId != std::this_thread::get_id());
+        for(int frame = 0; frame < 3; ++frame) {
+            PIKO_CHECK(pixels[frame].size() == 4 && pixels[frame][0] == 100 + frame);
+        }
+
+        const RenderThreadStats stats = thread.getStats();
+        PIKO_CHECK(stats.frameCount == 3 && stats.executeMs >= 0.0);
+
+        thread.resetStats();
+        PIKO_CHECK(thread.getStats().frameCount == 0);
+    }
+
+    // The exception of a command is rethrown once, the thread keeps running.
+    {
+        thread.getCommandList().record([]() { throw std::runtime_error("Command failed."); });
+        thread.submit();
+
+        bool hasThrown = false;
+        try {
+            thread.flush();
+        }
+        catch(const std::runtime_error&) {
+            hasThrown = true;
+        }
+        PIKO_CHECK(hasThrown);
+
+        std::vector<unsigned char> pixel;
+        recordFrame(thread, 42, pixel);
+        thread.submit();
+        thread.flush();
+        PIKO_CHECK(pixel.size() == 4 && pixel[0] == 42);
+    }
+
+    // A frame submitted before stop() is still executed, submitting afterwards fails.
+    {
+        std::vector<unsigned char> pixel;
+        recordFrame(thread, 7, pixel);
+        thread.submit();
+        thread.stop();
+        PIKO_CHECK(!thread.isRunning());
+        PIKO_CHECK(pixel.size() == 4 && pixel[0] == 7);
+
+        bool hasThrown = false;
+        try {
+            thread.submit();
+        }
+        catch(const std::logic_error&) {
+            hasThrown = true;
+        }
+        PIKO_CHECK(hasThrown);
+    }
+
+    // A failing initialization is rethrown by start().
+    {
+        RenderThread failing;
+        bool hasThrown = false;
+        try {
+            failing.start([](GLContext& context) { context.initOffscreen(0, 0); });
+        }
+        catch(const std::invalid_argument&) {
+            hasThrown = true;
+        }
+        PIKO_CHECK(hasThrown && !failing.isRunning());
+    }
+
+    return test::finish("RenderThreadTest");
+}
\ No newline at end of file
@@ -0,0 +1,181 @@
+/**
+ * @file        ResultTest.cpp
+ * @author      Robert Koch
+ * @version     1.0
+ *
+ * Test of ErrorMessage and Result: the text of an error has to name the origin of its code, a
+ * failed result has to throw its error when the value is accessed, and a failed context probe
+ * has to report its error without throwing and leave the context ready for the next attempt.
+ */
+#include "../include/ErrorMessage.h"
+#include "../include/GLContext.h"
+#include "../include/util/Result.h"
+#include "Test.h"
+
+#include <cerrno>
+#include <cstdio>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+
+namespace {
+
+    using namespace Piko;
+
+    /**
+     * Function to parse a non-negative number, as a caller probing alternatives would.
+     *
+     * @param text Decimal digits.
+     * @return Parsed number or the reason it could not be parsed.
+     */
+    Result<int> parse(const char* text) {
+
+        if(!*text) return ErrorMessage("Empty number.", 1);
+
+        int value = 0;
+        for(; *text; ++text) {
+            if(*text < '0' || *text > '9') return ErrorMessage("Invalid digit.", *text);
+            value = value * 10 + (*text - '0');
+        }
+        return value;
+    }
+
+    /**
+     * Function to get the message of the exception thrown by a function.
+     *
+     * @param function Function object expected to throw std::runtime_error.
+     * @return Message of the exception, empty if none was thrown.
+     */
+    template<typename F>
+    std::string getThrown(F function) {
+
+        try {
+            function();
+        }
+        catch(const std::runtime_error& e) {
+            return e.what();
+        }
+        return std::string();
+    }
+
+} /* Anonymous namespace */
+
+
+
+int main() {
+
+    // The text of an error names the origin of its code.
+    {
+        const char* message = "Something failed.";
+
+        const ErrorMessage none;
+        PIKO_CHECK(none.getCode() == 0 && none.getCategory() == ErrorCategory::USER);
+        PIKO_CHECK(none.str() == "No error. User error code: 0");
+
+        const ErrorMessage user(message, -42);
+        PIKO_CHECK(user.getMessage() == message);
+        PIKO_CHECK(user.getCode() == -42 && user.getCategory() == ErrorCategory::USER);
+        PIKO_CHECK(user.str() == "Something failed. User error code: -42");
+
+        const ErrorMessage graphics("EGL failed.", 0x3008, ErrorCategory::GRAPHICS);
+        PIKO_CHECK(graphics.getCategory() == ErrorCategory::GRAPHICS);
+        PIKO_CHECK(graphics.str() == "EGL failed. Graphics error code: 0x3008");
+
+        std::ostringstream stream;
+        stream << graphics;
+        PIKO_CHECK(stream.str() == graphics.str());
+    }
+
+    // The one argument constructor captures the code of the last system error.
+    {
+        errno = ENOENT;
+        const ErrorMessage system("Could not open file.");
+        errno = 0;
+
+        char expected[96];
+        std::snprintf(expected, sizeof(expected), "Could not open file. System error code: %d",
+                      ENOENT);
+
+        PIKO_CHECK(system.getCode() == ENOENT);
+        PIKO_CHECK(system.getCategory() == ErrorCategory::SYSTEM);
+        PIKO_CHECK(system.str() == expected);
+    }
+
+    // A successful result hands out its value and holds no error.
+    {
+        const Result<int> result = parse("1234");
+        PIKO_CHECK(result.isOk() && (bool)result);
+        PIKO_CHECK(result.value() == 1234);
+        PIKO_CHECK(result.error().getCode() == 0);
+        PIKO_CHECK(getThrown([&result]() { result.check(); }).empty());
+
+        Result<std::vector<int>> moved(std::vector<int>(3, 7));
+        moved.value().push_back(8);
+        PIKO_CHECK(moved.value().size() == 4 && moved.value()[3] == 8);
+
+        const Result<> done;
+        PIKO_CHECK(done.isOk() && (bool)done);
+        PIKO_CHECK(getThrown([&done]() { done.check(); }).empty());
+    }
+
+    // A failed result throws its error when the value is accessed or checked.
+    {
+        Result<int> result = parse("12x4");
+        const Result<int>& constant = result;
+
+        PIKO_CHECK(!result.isOk() && !result);
+        PIKO_CHECK(result.error().getCode() == 'x');
+        PIKO_CHECK(std::string(result.error().getMessage()) == "Invalid digit.");
+
+        const std::string text = result.error().str();
+        PIKO_CHECK(getThrown([&result]() { result.value(); }) == text);
+        PIKO_CHECK(getThrown([&constant]() { constant.value(); }) == text);
+        PIKO_CHECK(getThrown([&result]() { result.check(); }) == text);
+
+        const Result<int> copy = result;
+        PIKO_CHECK(!copy && copy.error().getCode() == 'x');
+
+        PIKO_CHECK(!parse("") && parse("").error().getCode() == 1);
+
+        const Result<> failed = ErrorMessage("Not done.", 3);
+        PIKO_CHECK(!failed.isOk() && failed.error().getCode() == 3);
+        PIKO_CHECK(getThrown([&failed]() { failed.check(); }) == "Not done. User error code: 3");
+    }
+
+    // A failed context probe returns its error, the context can be initialized afterwards.
+    {
+        GLContext context;
+
+        const Result<> invalid = context.tryInitOffscreen(0, 4);
+        PIKO_CHECK(!invalid && !context.isOffscreen());
+        PIKO_CHECK(std::string(invalid.error().getMessage()) ==
+                   "Invalid offscreen drawable size.");
+
+        ContextConfig unsupported;
+        unsupported.format.samples = 1024;
+        const Result<> probe = context.tryInitOffscreen(4, 4, unsupported);
+        PIKO_CHECK(!probe && !context.isOffscreen() && context.getWidth() == 0);
+
+        const Result<> result = context.tryInitOffscreen(4, 4);
+        if(result) {
+            PIKO_CHECK(context.isOffscreen() && context.getWidth() == 4);
+            context.dispose();
+        }
+        else {
+            std::cerr << "ResultTest: context init skipped, " << result.error().str() << "\n";
+        }
+
+        bool hasThrown = false;
+        try {
+            context.initOffscreen(0, 4);
+        }
+        catch(const std::invalid_argument&) {
+            hasThrown = true;
+        }
+        PIKO_CHECK(hasThrown);
+    }
+
+    return test::finish("ResultTest");
+}
\ No newline at end of file
@@ -0,0 +1,207 @@
+/**
+ * @file        SweepAndPruneTest.cpp
+ * @author      Robert Koch
+ * @version     1.0
+ *
+ * Test of the SweepAndPrune broadphase against a brute-force test of all pairs of boxes, over
+ * frames of small movements, teleported bodies, added and removed bodies, touching boxes and a
+ * scene stretched along another axis than the sort axis.
+ */
+#include "../include/util/SweepAndPrune.h"
+#include "Test.h"
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+
+namespace {
+
+    using namespace Piko;
+
+    typedef SweepAndPrune<float>::Pair Pair;
+
+    /**
+     * Function to find all overlapping pairs by testing every pair of boxes.
+     *
+     * @param boxes Box of each body.
+     * @param isAlive Flag per body if it was not removed.
+     * @return Pairs, the smaller id first, sorted.
+     */
+    std::vector<Pair> findAllPairs(const std::vector<AABB<float>>& boxes,
+                                   const std::vector<bool>& isAlive) {
+
+        std::vector<Pair> pairs;
+        for(std::size_t i = 0; i < boxes.size(); ++i) {
+            for(std::size_t j = i + 1; j < boxes.size(); ++j) {
+                if(isAlive[i] && isAlive[j] && boxes[i].intersects(boxes[j])) {
+                    pairs.push_back(Pair((std::uint32_t)i, (std::uint32_t)j));
+                }
+            }
+        }
+        return pairs;
+    }
+
+    /**
+     * Function to compare the pairs of the broadphase with the brute-force pairs.
+     *
+     * @param sap Broadphase.
+     * @param boxes Box of each body.
+     * @param isAlive Flag per body if it was not removed.
+     * @return True if both found the same pairs.
+     */
+    bool isMatching(SweepAndPrune<float>& sap, const std::vector<AABB<float>>& boxes,
+                    const std::vector<bool>& isAlive) {
+
+        std::vector<Pair> pairs;
+        sap.findPairs(pairs);
+
+        bool isOrdered = true;
+        for(std::size_t i = 0; i < pairs.size(); ++i) {
+            isOrdered &= pairs[i].first < pairs[i].second;
+        }
+
+        std::sort(pairs.begin(), pairs.end());
+        return isOrdered && pairs == findAllPairs(boxes, isAlive);
+    }
+
+    /**
+     * Function to create a random box.
+     *
+     * @param rng Random generator.
+     * @param extent Extent of the scene along each axis.
+     * @return Box.
+     */
+    AABB<float> createBox(std::mt19937& rng, const Vector3D<float>& extent) {
+
+        std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+        std::uniform_real_distribution<float> size(0.5f, 3.0f);
+
+        const Vector3D<float> min(unit(rng) * extent.x(), unit(rng) * extent.y(),
+                                  unit(rng) * extent.z());
+        return AABB<float>(min, min + Vector3D<float>(size(rng), size(rng), size(rng)));
+    }
+
+} /* Anonymous namespace */
+
+
+
+int main() {
+
+    // Touching boxes overlap, boxes separated on any axis do not.
+    {
+        SweepAndPrune<float> sap;
+        const AABB<float> unit(Vector3D<float>(0.0f, 0.0f, 0.0f),
+                               Vector3D<float>(1.0f, 1.0f, 1.0f));
+        const Vector3D<float> offsets[] = {
+            Vector3D<float>(1.0f, 0.0f, 0.0f), Vector3D<float>(0.0f, 1.0f, 1.0f),
+            Vector3D<float>(0.5f, 1.5f, 0.0f), Vector3D<float>(0.0f, 0.0f, -1.25f)
+        };
+
+        PIKO_CHECK(sap.add(unit) == 0);
+        for(std::uint32_t i = 0; i < 4; ++i) {
+            const Vector3D<float>& o = offsets[i];
+            PIKO_CHECK(sap.add(AABB<float>(unit.getMin() + o, unit.getMax() + o)) == i + 1);
+        }
+        PIKO_CHECK(sap.size() == 5);
+
+        std::vector<Pair> pairs;
+        sap.findPairs(pairs);
+        std::sort(pairs.begin(), pairs.end());
+        PIKO_CHECK(pairs.size() == 4);
+        PIKO_CHECK(pairs[0] == Pair(0, 1) && pairs[1] == Pair(0, 2));
+        PIKO_CHECK(pairs[2] == Pair(1, 2) && pairs[3] == Pair(2, 3));
+
+        sap.clear();
+        PIKO_CHECK(sap.size() == 0);
+        sap.findPairs(pairs);
+        PIKO_CHECK(pairs.empty());
+    }
+
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<float> step(-0.3f, 0.3f);
+
+    const std::size_t count = 2000;
+    const Vector3D<float> cube(60.0f, 60.0f, 60.0f);
+
+    SweepAndPrune<float> sap;
+    std::vector<AABB<float>> boxes;
+    std::vector<bool> isAlive;
+
+    for(std::size_t i = 0; i < count; ++i) {
+        boxes.push_back(createBox(rng, cube));
+        isAlive.push_back(true);
+        sap.add(boxes.back());
+    }
+    PIKO_CHECK(isMatching(sap, boxes, isAlive));
+    PIKO_CHECK(sap.getMoveCount() == count);
+
+    // Small movements are restored by the insertion sort, a fallback to the full sort would
+    // report exactly count moves.
+    const std::size_t budget = SweepAndPrune<float>::MAX_MOVES_PER_BODY * count;
+    bool isValid = true;
+    bool isCoherent = true;
+    for(int frame = 0; frame < 20; ++frame) {
+        for(std::size_t i = 0; i < count; ++i) {
+            const Vector3D<float> move(step(rng), step(rng), step(rng));
+            boxes[i] = AABB<float>(boxes[i].getMin() + move, boxes[i].getMax() + move);
+            sap.update((std::uint32_t)i, boxes[i]);
+        }
+        isValid &= isMatching(sap, boxes, isAlive);
+        isCoherent &= sap.getMoveCount() != count && sap.getMoveCount() <= budget;
+    }
+    PIKO_CHECK(isValid);
+    PIKO_CHECK(isCoherent);
+
+    // Teleporting all bodies exhausts the move budget and falls back to a full sort.
+    for(std::size_t i = 0; i < count; ++i) {
+        boxes[i] = createBox(rng, cube);
+        sap.update((std::uint32_t)i, boxes[i]);
+    }
+    PIKO_CHECK(isMatching(sap, boxes, isAlive));
+    PIKO_CHECK(sap.getMoveCount() == count);
+
+    // Removed bodies are never reported, their ids are reused once the pairs were found.
+    for(std::size_t i = 0; i < count; i += 3) {
+        sap.remove((std::uint32_t)i);
+        isAlive[i] = false;
+    }
+    PIKO_CHECK(sap.size() == count - (count + 2) / 3);
+    PIKO_CHECK(isMatching(sap, boxes, isAlive));
+
+    isValid = true;
+    for(std::size_t i = 0; i < 100; ++i) {
+        const AABB<float> box = createBox(rng, cube);
+        const std::uint32_t body = sap.add(box);
+        isValid &= body < count && !isAlive[body];
+        boxes[body] = box;
+        isAlive[body] = true;
+    }
+    PIKO_CHECK(isValid);
+    PIKO_CHECK(isMatching(sap, boxes, isAlive));
+
+    // A scene stretched along z makes the broadphase switch its sort axis.
+    PIKO_CHECK(sap.getSortAxis() == 0);
+    const Vector3D<float> corridor(20.0f, 20.0f, 2000.0f);
+    for(std::size_t i = 0; i < count; ++i) {
+        boxes[i] = createBox(rng, corridor);
+        if(isAlive[i]) sap.update((std::uint32_t)i, boxes[i]);
+    }
+    PIKO_CHECK(isMatching(sap, boxes, isAlive));
+    PIKO_CHECK(sap.getSortAxis() == 2);
+
+    isValid = true;
+    for(int frame = 0; frame < 5; ++frame) {
+        for(std::size_t i = 0; i < count; ++i) {
+            if(!isAlive[i]) continue;
+            const Vector3D<float> move(step(rng), step(rng), step(rng) * 10.0f);
+            boxes[i] = AABB<float>(boxes[i].getMin() + move, boxes[i].getMax() + move);
+            sap.update((std::uint32_t)i, boxes[i]);
+        }
+        isValid &= isMatching(sap, boxes, isAlive);
+    }
+    PIKO_CHECK(isValid);
+    PIKO_CHECK(sap.getSortAxis() == 2);
+
+    return test::finish("SweepAndPruneTest");
+}
\ No newline at end of file
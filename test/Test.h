@@ -0,0 +1,93 @@
+/**
+ * @file        Test.h
+ * @author      Robert Koch
+ * @version     1.0
+ *
+ * Minimal checking macros for the test programs. Every test is a program of its own which checks
+ * its conditions with PIKO_CHECK and returns Piko::test::finish() from main, so ctest sees a
+ * failure as a non-zero exit code.
+ */
+#ifndef TEST_H
+#define TEST_H
+
+#include <cmath>
+#include <iostream>
+
+
+/**
+ * Macro to check a condition. A failed check is reported with its location, the test goes on.
+ *
+ * @param condition Condition which has to hold.
+ */
+#define PIKO_CHECK(condition) \
+    Piko::test::check((condition) ? true : false, #condition, __FILE__, __LINE__)
+
+/**
+ * Macro to check that two values differ at most by a tolerance.
+ *
+ * @param a First value.
+ * @param b Second value.
+ * @param tolerance Maximum absolute difference.
+ */
+#define PIKO_CHECK_CLOSE(a, b, tolerance) \
+    Piko::test::check(std::fabs((double)(a) - (double)(b)) <= (double)(tolerance), \
+                      #a " == " #b, __FILE__, __LINE__)
+
+
+namespace Piko {
+
+    namespace test {
+
+        /**
+         * Function to get the counters of the running test.
+         *
+         * @param failed True to get the number of failed checks, false for all checks.
+         * @return Reference to the counter.
+         */
+        inline int& counter(bool failed) {
+            static int checks = 0;
+            static int failures = 0;
+            return failed ? failures : checks;
+        }
+
+        /**
+         * Function to record the result of a check. Use PIKO_CHECK instead.
+         *
+         * @param passed Result of the check.
+         * @param expression Checked expression.
+         * @param file Source file of the check.
+         * @param line Line of the check.
+         * @return Result of the check.
+         */
+        inline bool check(bool passed, const char* expression, const char* file, int line) {
+
+            ++counter(false);
+
+            // Only the first failures are printed, a broken kernel fails thousands of checks.
+            if(!passed && ++counter(true) <= 20) {
+                std::cerr << file << ":" << line << ": check failed: " << expression << "\n";
+            }
+
+            return passed;
+        }
+
+        /**
+         * Function to print the summary of a test.
+         *
+         * @param name Name of the test.
+         * @return Exit code for main(), zero if all checks passed.
+         */
+        inline int finish(const char* name) {
+
+            std::cerr << name << ": " << counter(false) - counter(true) << " of "
+                      << counter(false) << " checks passed\n";
+
+            return counter(true) == 0 ? 0 : 1;
+        }
+
+    } /* Namespace test */
+
+} /* Namespace Piko */
+
+
+#endif // End of TEST_H
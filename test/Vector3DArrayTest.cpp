@@ -0,0 +1,346 @@
+/**
+ * @file        Vector3DArrayTest.cpp
+ * @author      Robert Koch
+ * @version     1.0
+ *
+ * Test of the Vector3DArray container and its batch kernels for every size from 0 to 9 and a
+ * few larger ones, so each SIMD path runs with and without a scalar tail: the transposing
+ * load() and store(), the aligned and padded streams, resize(), push_back(), set(), copies and
+ * moves, the kernels against the operators of Vector3D, and the rejection of arrays of
+ * different sizes. Runs for float, which takes the SIMD paths, and double.
+ */
+#include "../include/util/Vector3DArray.h"
+#include "Test.h"
+
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+
+namespace {
+
+    using namespace Piko;
+
+    /** Sizes of the arrays, each one up to a full AVX register plus one. */
+    const std::size_t SIZES[] = { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 15, 16, 17, 100 };
+
+    /**
+     * Function to check if two vectors are identical.
+     *
+     * @param a First vector.
+     * @param b Second vector.
+     * @return True if all coordinates are equal.
+     */
+    template<typename T>
+    bool isEqual(const Vector3D<T>& a, const Vector3D<T>& b) {
+
+        return a.x() == b.x() && a.y() == b.y() && a.z() == b.z();
+    }
+
+    /**
+     * Function to check if a value matches the reference within a few rounding errors.
+     *
+     * @param a Value.
+     * @param b Reference.
+     * @param magnitude Magnitude of the terms the value was computed from.
+     * @return True if the values are close.
+     */
+    template<typename T>
+    bool isClose(T a, T b, T magnitude) {
+
+        return std::fabs(a - b) <= 4 * std::numeric_limits<T>::epsilon() * (1 + magnitude);
+    }
+
+    /**
+     * Function to check if two vectors match within a few rounding errors.
+     *
+     * @param a Vector.
+     * @param b Reference.
+     * @param magnitude Magnitude of the terms the vector was computed from.
+     * @return True if all coordinates are close.
+     */
+    template<typename T>
+    bool isClose(const Vector3D<T>& a, const Vector3D<T>& b, T magnitude) {
+
+        return isClose(a.x(), b.x(), magnitude) && isClose(a.y(), b.y(), magnitude) &&
+               isClose(a.z(), b.z(), magnitude);
+    }
+
+    /**
+     * Function to check if the streams of an array are aligned and padded.
+     *
+     * @param a Array to check.
+     * @return True if the streams are aligned and the capacity is padded.
+     */
+    template<typename T>
+    bool isAligned(const Vector3DArray<T>& a) {
+
+        if(a.capacity() == 0) return true;
+
+        return a.capacity() >= a.size() && a.capacity() % 8 == 0 &&
+               (std::uintptr_t)a.x() % SIMD_ALIGNMENT == 0 &&
+               (std::uintptr_t)a.y() % SIMD_ALIGNMENT == 0 &&
+               (std::uintptr_t)a.z() % SIMD_ALIGNMENT == 0;
+    }
+
+    /**
+     * Function to check if an array holds the specified vectors.
+     *
+     * @param a Array to check.
+     * @param vectors Expected vectors.
+     * @return True if size and content match.
+     */
+    template<typename T>
+    bool isHolding(const Vector3DArray<T>& a, const std::vector<Vector3D<T>>& vectors) {
+
+        bool isValid = a.size() == vectors.size() && a.empty() == vectors.empty();
+        for(std::size_t i = 0; isValid && i < vectors.size(); ++i) {
+            isValid &= isEqual(a.get(i), vectors[i]);
+            isValid &= a.x()[i] == vectors[i].x() && a.y()[i] == vectors[i].y() &&
+                       a.z()[i] == vectors[i].z();
+        }
+        return isValid && isAligned(a);
+    }
+
+    /**
+     * Function to check if a call throws std::invalid_argument.
+     *
+     * @param call Function to call.
+     * @return True if the call threw.
+     */
+    template<typename F>
+    bool isRejected(const F& call) {
+
+        try {
+            call();
+        }
+        catch(const std::invalid_argument&) {
+            return true;
+        }
+
+        return false;
+    }
+
+    /**
+     * Function to create random vectors.
+     *
+     * @param rng Random generator.
+     * @param count Number of vectors.
+     * @return Vectors with coordinates from -10 to 10.
+     */
+    template<typename T>
+    std::vector<Vector3D<T>> randomVectors(std::mt19937& rng, std::size_t count) {
+
+        std::uniform_real_distribution<double> coordinate(-10.0, 10.0);
+
+        std::vector<Vector3D<T>> vectors(count);
+        for(std::size_t i = 0; i < count; ++i) {
+            const T x = (T)coordinate(rng);
+            const T y = (T)coordinate(rng);
+            const T z = (T)coordinate(rng);
+            vectors[i] = Vector3D<T>(x, y, z);
+        }
+        return vectors;
+    }
+
+    /**
+     * Function to run the container checks for one size.
+     *
+     * @param vectors Vectors to store.
+     */
+    template<typename T>
+    void checkContainer(const std::vector<Vector3D<T>>& vectors) {
+
+        const std::size_t n = vectors.size();
+
+        // Conversions in both directions, store() writes exactly size() vectors.
+        Vector3DArray<T> a(vectors);
+        PIKO_CHECK(isHolding(a, vectors));
+        PIKO_CHECK(isHolding(Vector3DArray<T>(vectors.data(), n), vectors));
+
+        const Vector3D<T> sentinel(-1, -2, -3);
+        std::vector<Vector3D<T>> stored(n + 1, sentinel);
+        a.store(stored.data());
+        bool isValid = isEqual(stored[n], sentinel);
+        for(std::size_t i = 0; i < n; ++i) isValid &= isEqual(stored[i], vectors[i]);
+        PIKO_CHECK(isValid);
+
+        const std::vector<Vector3D<T>> converted = a.toVector();
+        isValid = converted.size() == n;
+        for(std::size_t i = 0; isValid && i < n; ++i) isValid &= isEqual(converted[i], vectors[i]);
+        PIKO_CHECK(isValid);
+
+        // Loading into a used array replaces its content.
+        Vector3DArray<T> loaded(3);
+        loaded.load(vectors.data(), n);
+        PIKO_CHECK(isHolding(loaded, vectors));
+
+        // Appending one by one, starting empty.
+        Vector3DArray<T> appended;
+        PIKO_CHECK(appended.empty() && appended.capacity() == 0);
+        for(std::size_t i = 0; i < n; ++i) appended.push_back(vectors[i]);
+        PIKO_CHECK(isHolding(appended, vectors));
+
+        // Setting every vector of a zero-initialized array.
+        Vector3DArray<T> assigned(n);
+        isValid = assigned.size() == n;
+        for(std::size_t i = 0; isValid && i < n; ++i) {
+            isValid &= isEqual(assigned.get(i), Vector3D<T>(0, 0, 0));
+        }
+        PIKO_CHECK(isValid);
+        for(std::size_t i = 0; i < n; ++i) assigned.set(i, vectors[i]);
+        PIKO_CHECK(isHolding(assigned, vectors));
+
+        // Copies are deep, moves leave the source empty.
+        Vector3DArray<T> copy(a);
+        PIKO_CHECK(isHolding(copy, vectors) && (n == 0 || copy.x() != a.x()));
+        if(n > 0) copy.set(0, sentinel);
+        PIKO_CHECK(isHolding(a, vectors));
+
+        Vector3DArray<T> assignedCopy;
+        assignedCopy = a;
+        PIKO_CHECK(isHolding(assignedCopy, vectors));
+
+        Vector3DArray<T> moved(std::move(assignedCopy));
+        PIKO_CHECK(isHolding(moved, vectors) && assignedCopy.size() == 0);
+
+        Vector3DArray<T> swapped;
+        swapped.swap(moved);
+        PIKO_CHECK(isHolding(swapped, vectors) && moved.empty());
+
+        // Growing keeps the content and zeroes the new vectors, also in the former padding.
+        Vector3DArray<T> grown(a);
+        grown.resize(n + 9);
+        isValid = grown.size() == n + 9 && isAligned(grown);
+        for(std::size_t i = 0; isValid && i < n; ++i) isValid &= isEqual(grown.get(i), vectors[i]);
+        for(std::size_t i = n; isValid && i < n + 9; ++i) {
+            isValid &= isEqual(grown.get(i), Vector3D<T>(0, 0, 0));
+        }
+        PIKO_CHECK(isValid);
+
+        // Shrinking and growing again does not bring back the old values.
+        grown.resize(n / 2);
+        grown.resize(n);
+        isValid = grown.size() == n;
+        for(std::size_t i = 0; isValid && i < n / 2; ++i) {
+            isValid &= isEqual(grown.get(i), vectors[i]);
+        }
+        for(std::size_t i = n / 2; isValid && i < n; ++i) {
+            isValid &= isEqual(grown.get(i), Vector3D<T>(0, 0, 0));
+        }
+        PIKO_CHECK(isValid);
+
+        const std::size_t capacity = grown.capacity();
+        grown.clear();
+        PIKO_CHECK(grown.empty() && grown.capacity() == capacity);
+        grown.reserve(capacity + 1);
+        PIKO_CHECK(grown.capacity() > capacity && isAligned(grown));
+    }
+
+    /**
+     * Function to run the kernel checks for one size.
+     *
+     * @param a First operands.
+     * @param b Second operands.
+     */
+    template<typename T>
+    void checkKernels(const std::vector<Vector3D<T>>& a, const std::vector<Vector3D<T>>& b) {
+
+        const std::size_t n = a.size();
+        const T s = (T)-1.75;
+        const Vector3DArray<T> va(a);
+        const Vector3DArray<T> vb(b);
+
+        // The outputs start with stale content of another size.
+        Vector3DArray<T> sum(n + 5), difference(3), scaled(n + 1), cross(1), normalized(n + 2);
+        std::vector<T> dots(n + 1, (T)99), magnitudes(n + 1, (T)99);
+
+        batchAdd(va, vb, sum);
+        batchSub(va, vb, difference);
+        batchScale(va, s, scaled);
+        batchDot(va, vb, dots.data());
+        batchCross(va, vb, cross);
+        batchMagnitude(va, magnitudes.data());
+        batchNormalize(va, normalized);
+
+        bool isValid = sum.size() == n && difference.size() == n && scaled.size() == n &&
+                       cross.size() == n && normalized.size() == n;
+        isValid &= dots[n] == (T)99 && magnitudes[n] == (T)99;
+
+        for(std::size_t i = 0; isValid && i < n; ++i) {
+            const T magnitude = a[i].getMagnitude();
+            const T product = magnitude * b[i].getMagnitude();
+
+            isValid &= isEqual(sum.get(i), a[i] + b[i]);
+            isValid &= isEqual(difference.get(i), a[i] - b[i]);
+            isValid &= isEqual(scaled.get(i), a[i] * s);
+            isValid &= isClose(dots[i], a[i] * b[i], product);
+            isValid &= isClose(cross.get(i), a[i] ^ b[i], product);
+            isValid &= isClose(magnitudes[i], magnitude, magnitude);
+            isValid &= isClose(normalized.get(i), a[i].getNormalization(), (T)1);
+        }
+        PIKO_CHECK(isValid);
+
+        // In place, the output aliases an input.
+        Vector3DArray<T> inPlace(va);
+        batchAdd(inPlace, vb, inPlace);
+        batchScale(inPlace, s, inPlace);
+        batchNormalize(inPlace, inPlace);
+        isValid = inPlace.size() == n;
+        for(std::size_t i = 0; isValid && i < n; ++i) {
+            isValid &= isClose(inPlace.get(i), ((a[i] + b[i]) * s).getNormalization(), (T)1);
+        }
+        PIKO_CHECK(isValid);
+
+        // Zero-length vectors are normalized to (0,0,0).
+        Vector3DArray<T> zeros(n);
+        batchNormalize(zeros, zeros);
+        isValid = zeros.size() == n;
+        for(std::size_t i = 0; isValid && i < n; ++i) {
+            isValid &= isEqual(zeros.get(i), Vector3D<T>(0, 0, 0));
+        }
+        PIKO_CHECK(isValid);
+
+        // Operands of different sizes are rejected.
+        const Vector3DArray<T> other(n + 1);
+        Vector3DArray<T> out;
+        std::vector<T> scalars(n + 1);
+        PIKO_CHECK(isRejected([&]() { batchAdd(va, other, out); }));
+        PIKO_CHECK(isRejected([&]() { batchSub(other, va, out); }));
+        PIKO_CHECK(isRejected([&]() { batchDot(va, other, scalars.data()); }));
+        PIKO_CHECK(isRejected([&]() { batchCross(other, va, out); }));
+    }
+
+    /**
+     * Function to run all checks for a coordinate type.
+     *
+     * @param rng Random generator.
+     */
+    template<typename T>
+    void checkAll(std::mt19937& rng) {
+
+        for(std::size_t s = 0; s < sizeof(SIZES) / sizeof(SIZES[0]); ++s) {
+            const std::vector<Vector3D<T>> a = randomVectors<T>(rng, SIZES[s]);
+            const std::vector<Vector3D<T>> b = randomVectors<T>(rng, SIZES[s]);
+            checkContainer(a);
+            checkKernels(a, b);
+        }
+    }
+
+} /* Anonymous namespace */
+
+
+
+int main() {
+
+    std::mt19937 rng(5);
+
+    checkAll<float>(rng);
+    checkAll<double>(rng);
+
+    return test::finish("Vector3DArrayTest");
+}
\ No newline at end of file
@@ -0,0 +1,160 @@
+/**
+ * @file        Vector3DExprTest.cpp
+ * @author      Robert Koch
+ * @version     1.0
+ *
+ * Test of the expression template layer, built with PIKO_VECTOR3D_EXPRESSION_TEMPLATES. The
+ * static assertions pin down the node types the operators build and check that vectors enter
+ * the tree by reference, so building an expression never creates an intermediate Vector3D. The
+ * runtime part evaluates expressions over a scalar type counting its copies: the generic
+ * operators copy three coordinates per intermediate vector, the expressions none.
+ */
+#include "../include/util/Vector3D.h"
+#include "Test.h"
+
+#include <type_traits>
+
+#if !defined(PIKO_VECTOR3D_EXPRESSION_TEMPLATES)
+    #error "Vector3DExprTest has to be built with PIKO_VECTOR3D_EXPRESSION_TEMPLATES."
+#endif
+
+
+/**
+ * Operand of the static assertions, only used in unevaluated context and never defined.
+ */
+const Piko::Vector3D<double>& a();
+
+
+namespace {
+
+    using namespace Piko;
+
+    typedef Vector3D<double> V;
+
+    /*==========================================
+     * NODE TYPES
+     *=========================================*/
+
+    static_assert(std::is_same<decltype(a() + a()), Vector3DSum<V, V>>::value,
+                  "operator+ has to build a sum node.");
+    static_assert(std::is_same<decltype(a() - a()), Vector3DDifference<V, V>>::value,
+                  "operator- has to build a difference node.");
+    static_assert(std::is_same<decltype(a() * 2.0), Vector3DScaled<V>>::value,
+                  "operator* with a scalar has to build a scaled node.");
+    static_assert(std::is_same<decltype(a() / 2.0), Vector3DQuotient<V>>::value,
+                  "operator/ has to build a quotient node.");
+    static_assert(std::is_same<decltype(a() ^ a()), Vector3DCross<V, V>>::value,
+                  "operator^ has to build a cross node.");
+    static_assert(std::is_same<decltype(a() * a()), double>::value,
+                  "The scalar product has to be evaluated immediately.");
+
+    typedef Vector3DDifference<Vector3DSum<V, Vector3DScaled<V>>, Vector3DCross<V, V>> Chain;
+
+    static_assert(std::is_same<decltype(a() + a() * 2.0 - (a() ^ a())), Chain>::value,
+                  "a + b * s - (c ^ d) has to build a single tree without vectors.");
+    typedef Vector3DScaled<Vector3DSum<V, V>> ScaledSum;
+
+    static_assert(std::is_same<decltype((a() + a()) * 2.0), ScaledSum>::value,
+                  "Nested expressions have to be scaled lazily.");
+    static_assert(std::is_same<decltype((a() + a()) * (a() - a())), double>::value,
+                  "The scalar product of expressions has to be evaluated immediately.");
+
+    /*==========================================
+     * OPERAND STORAGE
+     *=========================================*/
+
+    static_assert(std::is_same<Vector3DOperand<V>::type, const V&>::value,
+                  "Vectors have to be referenced by the nodes.");
+    static_assert(!std::is_reference<Vector3DOperand<Vector3DSum<V, V>>::type>::value,
+                  "Nested nodes have to be stored by value.");
+    static_assert(sizeof(Vector3DSum<V, V>) == 2 * sizeof(const V*),
+                  "A node of two vectors must hold nothing but two references.");
+    static_assert(sizeof(Vector3DCross<V, V>) < sizeof(V),
+                  "A node must be smaller than the vector it stands for.");
+    static_assert(std::is_assignable<V&, Chain>::value && std::is_constructible<V, Chain>::value,
+                  "Vectors have to be constructible and assignable from expressions.");
+
+
+
+    /**
+     * Scalar counting how often it is copied.
+     */
+    struct Counted {
+
+        double value;           /**< Wrapped value. */
+        static int copies;      /**< Number of copy constructions. */
+
+        Counted(double v = 0.0) : value(v) {}
+        Counted(const Counted& c) : value(c.value) { ++copies; }
+        Counted& operator=(const Counted& c) { value = c.value; return *this; }
+
+        Counted& operator+=(const Counted& c) { value += c.value; return *this; }
+        Counted& operator-=(const Counted& c) { value -= c.value; return *this; }
+    };
+
+    int Counted::copies = 0;
+
+    Counted operator+(const Counted& a, const Counted& b) { return Counted(a.value + b.value); }
+    Counted operator-(const Counted& a, const Counted& b) { return Counted(a.value - b.value); }
+    Counted operator*(const Counted& a, const Counted& b) { return Counted(a.value * b.value); }
+
+    /**
+     * Function to check the coordinates of a vector.
+     */
+    template<typename T>
+    bool isEqual(const Vector3D<T>& v, double x, double y, double z) {
+        return (double)v.x() == x && (double)v.y() == y && (double)v.z() == z;
+    }
+
+    template<>
+    bool isEqual<Counted>(const Vector3D<Counted>& v, double x, double y, double z) {
+        return v.x().value == x && v.y().value == y && v.z().value == z;
+    }
+
+} /* Anonymous namespace */
+
+
+
+int main() {
+
+    typedef Vector3D<Counted> C;
+
+    const C a(1.0, 2.0, 3.0);
+    const C b(4.0, 5.0, 6.0);
+    const C c(-1.0, 0.5, 2.0);
+    const C d(3.0, -2.0, 1.0);
+
+    // A whole chain without scalar nodes evaluates without a single copy.
+    Counted::copies = 0;
+    C r = a + b - (c ^ d);
+    r = r - a + (b ^ c) - d;
+    r += a - b;
+    r -= (c ^ d) + a;
+    PIKO_CHECK(Counted::copies == 0);
+
+    // Scaled nodes hold their scalar by value, copies of it are the only ones.
+    Counted::copies = 0;
+    C s = a + b * Counted(2.0) - (c ^ d);
+    PIKO_CHECK(Counted::copies <= 3);
+
+    // c ^ d = (4.5, 7, 0.5)
+    PIKO_CHECK(isEqual(s, 1.0 + 8.0 - 4.5, 2.0 + 10.0 - 7.0, 3.0 + 12.0 - 0.5));
+
+    // Expressions may refer to the vector they are assigned to.
+    Vector3D<double> v(1.0, 2.0, 3.0);
+    const Vector3D<double> w(0.0, 0.0, 1.0);
+    v = v + (v ^ w) * 2.0;
+    PIKO_CHECK(isEqual(v, 1.0 + 4.0, 2.0 - 2.0, 3.0));
+    v = w - v;
+    PIKO_CHECK(isEqual(v, -5.0, 0.0, -2.0));
+
+    // Results agree with the component formulas.
+    const Vector3D<double> p(1.5, -2.0, 0.25);
+    const Vector3D<double> q(-0.5, 4.0, 2.0);
+    const Vector3D<double> e = (p + q) / 2.0 - p * 0.5;
+    PIKO_CHECK(isEqual(e, (1.5 - 0.5) / 2.0 - 0.75, (-2.0 + 4.0) / 2.0 + 1.0,
+                       (0.25 + 2.0) / 2.0 - 0.125));
+    PIKO_CHECK((p + q) * (p - q) == 1.0 * 2.0 + 2.0 * -6.0 + 2.25 * -1.75);
+
+    return test::finish("Vector3DExprTest");
+}
\ No newline at end of file
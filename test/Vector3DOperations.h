@@ -0,0 +1,136 @@
+/**
+ * @file        Vector3DOperations.h
+ * @author      Robert Koch
+ * @version     1.0
+ *
+ * Operations of Vector3D<float> shared by the SIMD equivalence tests. The header is compiled
+ * twice: once against the SSE specialization and once, by Vector3DReference.cpp, against the
+ * generic template moved into a namespace of its own. Comparing both evaluations checks that the
+ * specialization computes exactly what the generic template computes.
+ */
+#ifndef VECTOR3DOPERATIONS_H
+#define VECTOR3DOPERATIONS_H
+
+
+/**
+ * Function to evaluate an operation with the generic Vector3D<float>, see Vector3DReference.cpp.
+ *
+ * @param operation Operation to evaluate, see Operation.
+ * @param a Coordinates of the first operand.
+ * @param b Coordinates of the second operand.
+ * @param s Scalar operand.
+ * @param out Receives the coordinates of the result and the padding lane, or the scalar
+ *            result followed by zeros.
+ */
+void evaluateGeneric(int operation, const float* a, const float* b, float s, float* out);
+
+
+namespace Piko {
+
+    namespace test {
+
+        /**
+         * Operations under test.
+         */
+        enum Operation {
+            OP_ADD,
+            OP_SUB,
+            OP_DOT,
+            OP_SCALE,
+            OP_DIVIDE,
+            OP_CROSS,
+            OP_ADD_ASSIGN,
+            OP_SUB_ASSIGN,
+            OP_SCALE_ASSIGN,
+            OP_DIVIDE_ASSIGN,
+            OP_CROSS_ASSIGN,
+            OP_SET_POSITION,
+            OP_NORMALIZE_EXACT,
+            OP_NORMALIZE_FAST,
+            OP_NORMALIZE_ESTIMATE,
+            OP_NORMALIZATION_EXACT,
+            OP_NORMALIZATION_FAST,
+            OP_NORMALIZATION_ESTIMATE,
+            OP_MAGNITUDE,
+            OP_COMBINED,
+            OP_COUNT
+        };
+
+        namespace {
+
+            /**
+             * Function to get the padding lane of a vector.
+             *
+             * @param v Vector.
+             * @return Padding lane of the SSE specialization, zero for the generic template.
+             */
+            inline float getPadding(const Vector3D<float>& v) {
+#if defined(PIKO_SIMD_VECTOR3D) && defined(PIKO_SIMD_SSE)
+                return (&v.x())[3];
+#else
+                (void)v;
+                return 0.0f;
+#endif
+            }
+
+            /**
+             * Function to evaluate an operation, see evaluateGeneric().
+             */
+            inline void evaluate(int operation, const float* a, const float* b, float s,
+                                 float* out) {
+
+                const Vector3D<float> u(a[0], a[1], a[2]);
+                const Vector3D<float> v(b[0], b[1], b[2]);
+                Vector3D<float> r;
+                float scalar = 0.0f;
+                bool isScalar = false;
+
+                switch(operation) {
+                    case OP_ADD:                    r = u + v; break;
+                    case OP_SUB:                    r = u - v; break;
+                    case OP_DOT:                    scalar = u * v; isScalar = true; break;
+                    case OP_SCALE:                  r = u * s; break;
+                    case OP_DIVIDE:                 r = u / s; break;
+                    case OP_CROSS:                  r = u ^ v; break;
+                    case OP_ADD_ASSIGN:             r = u; r += v; break;
+                    case OP_SUB_ASSIGN:             r = u; r -= v; break;
+                    case OP_SCALE_ASSIGN:           r = u; r *= s; break;
+                    case OP_DIVIDE_ASSIGN:          r = u; r /= s; break;
+                    case OP_CROSS_ASSIGN:           r = u; r ^= v; break;
+                    case OP_SET_POSITION:           r.setPosition(a[2], a[0], a[1]); break;
+                    case OP_NORMALIZE_EXACT:        r = u; r.normalize<ExactPrecision>(); break;
+                    case OP_NORMALIZE_FAST:         r = u; r.normalize<FastPrecision>(); break;
+                    case OP_NORMALIZE_ESTIMATE:     r = u; r.normalize<EstimatePrecision>(); break;
+                    case OP_NORMALIZATION_EXACT:    r = u.getNormalization(); break;
+                    case OP_NORMALIZATION_FAST:     r = u.getNormalization<FastPrecision>(); break;
+                    case OP_NORMALIZATION_ESTIMATE:
+                        r = u.getNormalization<EstimatePrecision>();
+                        break;
+                    case OP_MAGNITUDE:
+                        scalar = u.getMagnitude();
+                        isScalar = true;
+                        break;
+                    case OP_COMBINED:               r = u + v * s - (u ^ v); break;
+                    default:                        break;
+                }
+
+                if(isScalar) {
+                    out[0] = scalar;
+                    out[1] = out[2] = out[3] = 0.0f;
+                }
+                else {
+                    out[0] = r.x();
+                    out[1] = r.y();
+                    out[2] = r.z();
+                    out[3] = getPadding(r);
+                }
+            }
+
+        } /* Anonymous namespace */
+
+    } /* Namespace test */
+
+} /* Namespace Piko */
+
+
+#endif // End of VECTOR3DOPERATIONS_H
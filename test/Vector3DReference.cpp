@@ -0,0 +1,22 @@
+/**
+ * @file        Vector3DReference.cpp
+ * @author      Robert Koch
+ * @version     1.0
+ *
+ * Reference evaluation of the Vector3D<float> operations with the generic template. The engine
+ * namespace is renamed for this file, so the generic Vector3D<float> can be linked into the same
+ * program as the SSE specialization without violating the one definition rule.
+ */
+#undef PIKO_SIMD_VECTOR3D
+#undef PIKO_VECTOR3D_EXPRESSION_TEMPLATES
+
+#define Piko PikoGeneric
+#include "../include/util/Vector3D.h"
+#include "Vector3DOperations.h"
+#undef Piko
+
+
+void evaluateGeneric(int operation, const float* a, const float* b, float s, float* out) {
+
+    PikoGeneric::test::evaluate(operation, a, b, s, out);
+}
\ No newline at end of file
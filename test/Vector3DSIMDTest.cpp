@@ -0,0 +1,99 @@
+/**
+ * @file        Vector3DSIMDTest.cpp
+ * @author      Robert Koch
+ * @version     1.0
+ *
+ * Test of the SSE specialization of Vector3D<float> against the generic template. Every operation
+ * has to give bit for bit the same result for random, tiny, huge and non-finite operands, and
+ * the padding lane has to stay zero. Built once with PIKO_SIMD_VECTOR3D and once with
+ * PIKO_VECTOR3D_EXPRESSION_TEMPLATES in addition.
+ */
+#include "../include/util/Vector3D.h"
+#include "Test.h"
+#include "Vector3DOperations.h"
+
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <random>
+#include <vector>
+
+
+namespace {
+
+    using namespace Piko;
+
+    /**
+     * Function to compare two results bit for bit. NaNs compare equal to each other, their
+     * payload is not specified.
+     *
+     * @param a First result.
+     * @param b Second result.
+     * @return True if the results are identical.
+     */
+    bool isIdentical(float a, float b) {
+
+        if(std::isnan(a) || std::isnan(b)) return std::isnan(a) && std::isnan(b);
+        return std::memcmp(&a, &b, sizeof(float)) == 0;
+    }
+
+} /* Anonymous namespace */
+
+
+
+int main() {
+
+    const float inf = std::numeric_limits<float>::infinity();
+    const float nan = std::numeric_limits<float>::quiet_NaN();
+
+    // Hand-picked operands: zero-length, denormal and overflowing squares, non-finite values.
+    std::vector<Vector3D<float>> vectors;
+    vectors.push_back(Vector3D<float>(0.0f, 0.0f, 0.0f));
+    vectors.push_back(Vector3D<float>(-0.0f, 0.0f, -0.0f));
+    vectors.push_back(Vector3D<float>(1.0f, 0.0f, 0.0f));
+    vectors.push_back(Vector3D<float>(1e-20f, -1e-20f, 1e-20f));
+    vectors.push_back(Vector3D<float>(1e-40f, 0.0f, 0.0f));
+    vectors.push_back(Vector3D<float>(1e20f, 1e20f, -1e20f));
+    vectors.push_back(Vector3D<float>(inf, 1.0f, 2.0f));
+    vectors.push_back(Vector3D<float>(1.0f, nan, 2.0f));
+
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<float> coordinate(-10.0f, 10.0f);
+    for(int i = 0; i < 200; ++i) {
+        const float x = coordinate(rng);
+        const float y = coordinate(rng);
+        const float z = coordinate(rng);
+        vectors.push_back(Vector3D<float>(x, y, z));
+    }
+
+    const float scalars[] = { 1.5f, -0.25f, 3.0f, 0.0f, 1e-30f, inf, -inf, nan };
+    const std::size_t scalarCount = sizeof(scalars) / sizeof(scalars[0]);
+
+    for(int op = 0; op < test::OP_COUNT; ++op) {
+        for(std::size_t i = 0; i < vectors.size(); ++i) {
+            const float a[3] = { vectors[i].x(), vectors[i].y(), vectors[i].z() };
+            const Vector3D<float>& w = vectors[(i * 7 + 3) % vectors.size()];
+            const float b[3] = { w.x(), w.y(), w.z() };
+
+            for(std::size_t k = 0; k < scalarCount; ++k) {
+                float expected[4];
+                float actual[4];
+                evaluateGeneric(op, a, b, scalars[k], expected);
+                test::evaluate(op, a, b, scalars[k], actual);
+
+                PIKO_CHECK(isIdentical(actual[0], expected[0]) &&
+                           isIdentical(actual[1], expected[1]) &&
+                           isIdentical(actual[2], expected[2]));
+                PIKO_CHECK(actual[3] == 0.0f);
+            }
+        }
+    }
+
+    // The specialization has to keep the layout promised to SIMD code.
+#if defined(PIKO_SIMD_SSE)
+    PIKO_CHECK(sizeof(Vector3D<float>) == 16);
+    PIKO_CHECK(alignof(Vector3D<float>) == 16);
+#endif
+
+    return test::finish("Vector3DSIMDTest");
+}
\ No newline at end of file
@@ -0,0 +1,153 @@
+/**
+ * @file        WindowBaseTest.cpp
+ * @author      Robert Koch
+ * @version     1.0
+ *
+ * Test of a WindowBase on the HeadlessWindowBackend: default sizes taken from the virtual
+ * display, message dispatch from the queue and from a scripted event source, the key handling
+ * and the fullscreen state machine.
+ */
+#include "../include/HeadlessWindowBackend.h"
+#include "../include/WindowBase.h"
+#include "Test.h"
+
+#include <memory>
+#include <vector>
+
+
+namespace {
+
+    using namespace Piko;
+
+    /**
+     * Window counting the keys passed to onKeyDown().
+     */
+    class CountingWindow final : public WindowBase {
+
+        public:
+
+            int keyCount;       /**< Number of onKeyDown() calls. */
+
+            CountingWindow(HeadlessWindowBackend* backend, int width, int height)
+              :
+              WindowBase(std::unique_ptr<WindowBackend>(backend), "Test", width, height),
+              keyCount(0) {
+
+            }
+
+        protected:
+
+            bool onKeyDown(int keycode) {
+
+                ++keyCount;
+                return WindowBase::onKeyDown(keycode);
+            }
+    };
+
+} /* Anonymous namespace */
+
+
+
+int main() {
+
+    // Default sizes are half of the virtual display.
+    {
+        HeadlessWindowBackend* backend = new HeadlessWindowBackend(1600, 900);
+        CountingWindow window(backend, WindowBase::DEFAULT_SIZE, WindowBase::DEFAULT_SIZE);
+
+        PIKO_CHECK(backend->getWindowWidth() == 800 && backend->getWindowHeight() == 450);
+        PIKO_CHECK(backend->getTitle() == "Test");
+        PIKO_CHECK(!backend->isVisible());
+        PIKO_CHECK(window.getHandle() != NULL);
+
+        window.show();
+        window.setTitle("Renamed");
+        PIKO_CHECK(backend->isVisible());
+        PIKO_CHECK(backend->getTitle() == "Renamed");
+    }
+
+    // Fullscreen state machine: the display size in fullscreen, the window size otherwise.
+    {
+        HeadlessWindowBackend* backend = new HeadlessWindowBackend(1600, 900);
+        CountingWindow window(backend, 640, 480);
+
+        window.setFullscreen(true);
+        PIKO_CHECK(window.isFullscreen() && backend->isFullscreen());
+        PIKO_CHECK(backend->getWindowWidth() == 1600 && backend->getWindowHeight() == 900);
+
+        window.setFullscreen(true);
+        PIKO_CHECK(window.isFullscreen() && backend->getWindowWidth() == 1600);
+
+        window.setFullscreen(false);
+        PIKO_CHECK(!window.isFullscreen() && !backend->isFullscreen());
+        PIKO_CHECK(backend->getWindowWidth() == 640 && backend->getWindowHeight() == 480);
+
+        window.setFullscreen(false);
+        PIKO_CHECK(!window.isFullscreen() && backend->getWindowWidth() == 640);
+    }
+
+    // Key handling: F1 toggles fullscreen, other keys are not consumed, escape closes.
+    {
+        HeadlessWindowBackend* backend = new HeadlessWindowBackend(1600, 900);
+        CountingWindow window(backend, 640, 480);
+
+        backend->postMessage(WM_KEYDOWN, VK_F1);
+        PIKO_CHECK(backend->getPendingCount() == 1);
+        PIKO_CHECK(backend->processMessages() == 1);
+        PIKO_CHECK(window.isFullscreen() && backend->getWindowWidth() == 1600);
+
+        backend->postMessage(WM_KEYDOWN, VK_F1);
+        backend->postMessage(WM_KEYDOWN, 'A');
+        backend->postMessage(WM_KEYUP, VK_F1);
+        PIKO_CHECK(backend->processMessages() == 3);
+        PIKO_CHECK(!window.isFullscreen() && backend->getWindowWidth() == 640);
+        PIKO_CHECK(window.keyCount == 3);
+
+        std::vector<HeadlessMessage> messages;
+        HeadlessMessage escape = { WM_KEYDOWN, VK_ESCAPE, 0 };
+        HeadlessMessage late = { WM_KEYDOWN, 'B', 0 };
+        messages.push_back(escape);
+        messages.push_back(late);
+        backend->postMessages(messages);
+
+        // Closing destroys the window, messages queued behind the escape key are dropped.
+        PIKO_CHECK(backend->processMessages() == 1);
+        PIKO_CHECK(window.isClosed() && backend->isDestroyed());
+        PIKO_CHECK(window.getHandle() == NULL);
+        PIKO_CHECK(backend->getPendingCount() == 0);
+        PIKO_CHECK(window.keyCount == 4);
+
+        backend->postMessage(WM_KEYDOWN, VK_F1);
+        PIKO_CHECK(backend->processMessages() == 0);
+        PIKO_CHECK(!window.isFullscreen());
+    }
+
+    // Scripted event source, polled after the queue until it runs dry.
+    {
+        HeadlessWindowBackend* backend = new HeadlessWindowBackend(1600, 900);
+        CountingWindow window(backend, 640, 480);
+
+        int remaining = 1000;
+        backend->setEventSource([&remaining](HeadlessMessage& msg) {
+            if(remaining == 0) return false;
+            msg.msg = remaining % 2 ? WM_KEYDOWN : WM_MOUSEMOVE;
+            msg.wParam = 'K';
+            msg.lParam = 0;
+            --remaining;
+            return true;
+        });
+
+        backend->postMessage(WM_KEYDOWN, VK_F1);
+        PIKO_CHECK(backend->processMessages() == 1001);
+        PIKO_CHECK(window.keyCount == 501);
+        PIKO_CHECK(window.isFullscreen());
+        PIKO_CHECK(backend->processMessages() == 0);
+
+        backend->setEventSource(HeadlessWindowBackend::EventSource());
+        backend->postMessage(WM_KEYDOWN, VK_F1);
+        PIKO_CHECK(backend->processMessages() == 1);
+        PIKO_CHECK(!window.isFullscreen());
+    }
+
+    return test::finish("WindowBaseTest");
+}
\ No newline at end of file
@@ -0,0 +1,50 @@
+/**
+ * @file        MeshConverter.cpp
+ * @author      Robert Koch
+ * @version     1.0
+ *
+ * Offline tool converting Wavefront OBJ meshes into the binary mesh format loaded by MeshFile.
+ *
+ * Usage: MeshConverter input.obj output.pkm
+ */
+#include "../include/MeshFile.h"
+#include "ObjParser.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <exception>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+
+
+int main(int argc, char** argv) {
+
+    if(argc != 3) {
+        std::fprintf(stderr, "Usage: %s input.obj output.pkm\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    try {
+        std::ifstream file(argv[1], std::ios::in | std::ios::binary);
+        if(!file) throw std::runtime_error("Could not open input file.");
+
+        std::string text((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+        Piko::MeshData mesh;
+        Piko::parseObj(text.c_str(), mesh);
+        Piko::MeshFile::write(argv[2], mesh);
+
+        std::printf("%s: %u vertices, %u triangles%s%s\n", argv[2],
+                    (unsigned int)mesh.positions.size(), (unsigned int)(mesh.indices.size() / 3),
+                    mesh.normals.empty() ? "" : ", normals",
+                    mesh.texcoords.empty() ? "" : ", texture coordinates");
+    }
+    catch(const std::exception& e) {
+        std::fprintf(stderr, "%s: %s\n", argv[1], e.what());
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
\ No newline at end of file
@@ -0,0 +1,193 @@
+/**
+ * @file        ObjParser.h
+ * @author      Robert Koch
+ * @version     1.0
+ *
+ * Parser of Wavefront OBJ meshes, shared by the MeshConverter tool and the benchmark comparing
+ * text parsing against loading mapped mesh files.
+ *
+ * Positions, normals and texture coordinates are read from v, vn and vt lines, faces with more
+ * than three corners are split into fans. Corners referencing the same combination of
+ * attributes share one vertex. Groups, materials and all other statements are ignored.
+ */
+#ifndef OBJPARSER_H
+#define OBJPARSER_H
+
+#include <cstdlib>
+#include <stdexcept>
+#include <unordered_map>
+#include <vector>
+
+#include "../include/MeshFile.h"
+
+
+namespace Piko {
+
+    namespace detail {
+
+        /**
+         * Corner of a face, indices into the attribute lists, -1 if absent.
+         */
+        struct ObjCorner {
+            long position;
+            long texcoord;
+            long normal;
+
+            bool operator==(const ObjCorner& c) const {
+                return position == c.position && texcoord == c.texcoord && normal == c.normal;
+            }
+        };
+
+        /**
+         * Hash of a corner for the vertex deduplication.
+         */
+        struct ObjCornerHash {
+            std::size_t operator()(const ObjCorner& c) const {
+                std::size_t h = (std::size_t)c.position * 2654435761u;
+                h ^= (std::size_t)(c.texcoord + 1) * 40503u + (h << 6) + (h >> 2);
+                h ^= (std::size_t)(c.normal + 1) * 97u + (h << 6) + (h >> 2);
+                return h;
+            }
+        };
+
+        /**
+         * Function to resolve a one-based or negative OBJ index.
+         *
+         * @param index Index as written in the file.
+         * @param count Number of elements read so far.
+         * @return Zero-based index.
+         */
+        inline long resolveObjIndex(long index, std::size_t count) {
+
+            const long resolved = index < 0 ? (long)count + index : index - 1;
+            if(resolved < 0 || resolved >= (long)count) {
+                throw std::runtime_error("Face references an undefined element.");
+            }
+            return resolved;
+        }
+
+    } /* Namespace detail */
+
+    /**
+     * Function to parse an OBJ file.
+     *
+     * @param text Contents of the file, zero terminated.
+     * @param mesh Receives the mesh.
+     *
+     * @throws std::runtime_error If a face references an undefined element or has less than
+     *                            three corners.
+     */
+    inline void parseObj(const char* text, MeshData& mesh) {
+
+        using detail::ObjCorner;
+        using detail::resolveObjIndex;
+
+        std::vector<Vector3D<float> > positions;
+        std::vector<Vector3D<float> > normals;
+        std::vector<float> texcoords;
+        std::unordered_map<ObjCorner, std::uint32_t, detail::ObjCornerHash> vertices;
+        std::vector<ObjCorner> corners;
+
+        bool hasNormals = true;
+        bool hasTexcoords = true;
+
+        const char* p = text;
+        while(*p) {
+            while(*p == ' ' || *p == '\t') ++p;
+            char* end = NULL;
+
+            if(p[0] == 'v' && (p[1] == ' ' || p[1] == '\t')) {
+                const float x = std::strtof(p + 2, &end);
+                const float y = std::strtof(end, &end);
+                const float z = std::strtof(end, &end);
+                positions.push_back(Vector3D<float>(x, y, z));
+                p = end;
+            }
+            else if(p[0] == 'v' && p[1] == 'n') {
+                const float x = std::strtof(p + 2, &end);
+                const float y = std::strtof(end, &end);
+                const float z = std::strtof(end, &end);
+                normals.push_back(Vector3D<float>(x, y, z));
+                p = end;
+            }
+            else if(p[0] == 'v' && p[1] == 't') {
+                const float u = std::strtof(p + 2, &end);
+                const float v = std::strtof(end, &end);
+                texcoords.push_back(u);
+                texcoords.push_back(v);
+                p = end;
+            }
+            else if(p[0] == 'f' && (p[1] == ' ' || p[1] == '\t')) {
+                corners.clear();
+                p += 2;
+
+                for(;;) {
+                    while(*p == ' ' || *p == '\t') ++p;
+                    if(*p == '\0' || *p == '\n' || *p == '\r') break;
+
+                    ObjCorner c = { -1, -1, -1 };
+                    c.position = resolveObjIndex(std::strtol(p, &end, 10), positions.size());
+                    p = end;
+
+                    if(*p == '/') {
+                        ++p;
+                        if(*p != '/') {
+                            c.texcoord = resolveObjIndex(std::strtol(p, &end, 10),
+                                                         texcoords.size() / 2);
+                            p = end;
+                        }
+                        if(*p == '/') {
+                            c.normal = resolveObjIndex(std::strtol(p + 1, &end, 10),
+                                                       normals.size());
+                            p = end;
+                        }
+                    }
+
+                    hasTexcoords = hasTexcoords && c.texcoord >= 0;
+                    hasNormals = hasNormals && c.normal >= 0;
+                    corners.push_back(c);
+                }
+
+                if(corners.size() < 3) throw std::runtime_error("Face with less than 3 corners.");
+
+                for(std::size_t i = 1; i + 1 < corners.size(); ++i) {
+                    const ObjCorner triangle[3] = { corners[0], corners[i], corners[i + 1] };
+
+                    for(int k = 0; k < 3; ++k) {
+                        const std::uint32_t next = (std::uint32_t)vertices.size();
+                        const std::uint32_t index =
+                            vertices.insert(std::make_pair(triangle[k], next)).first->second;
+                        mesh.indices.push_back(index);
+                    }
+                }
+            }
+
+            // Skip the rest of the line.
+            while(*p && *p != '\n') ++p;
+            if(*p) ++p;
+        }
+
+        // Attributes missing at any corner are dropped for the whole mesh.
+        const std::size_t count = vertices.size();
+        mesh.positions.resize(count);
+        if(hasNormals && !normals.empty()) mesh.normals.resize(count);
+        if(hasTexcoords && !texcoords.empty()) mesh.texcoords.resize(2 * count);
+
+        std::unordered_map<ObjCorner, std::uint32_t, detail::ObjCornerHash>::const_iterator it;
+        for(it = vertices.begin(); it != vertices.end(); ++it) {
+            const ObjCorner& c = it->first;
+            const std::uint32_t i = it->second;
+
+            mesh.positions[i] = positions[c.position];
+            if(!mesh.normals.empty()) mesh.normals[i] = normals[c.normal];
+            if(!mesh.texcoords.empty()) {
+                mesh.texcoords[2 * i] = texcoords[2 * c.texcoord];
+                mesh.texcoords[2 * i + 1] = texcoords[2 * c.texcoord + 1];
+            }
+        }
+    }
+
+} /* Namespace Piko */
+
+
+#endif // End of OBJPARSER_H